@@ -0,0 +1,102 @@
+/**
+ * @file adc_sensing.h
+ * @brief ADC-based current and voltage sensing
+ *
+ * Hardware connections (ADC1 scan ranks; pins and channels per board in
+ * board_config.h, BOARD_ADC_CH_*):
+ * - Rank 1: Output current sensing
+ * - Rank 2: Output voltage sensing
+ * - Rank 3: DC bus 1 voltage
+ * - Rank 4: DC bus 2 voltage
+ *
+ * Sensing strategy:
+ * - ADC scans the 4 channels continuously into a circular DMA buffer
+ * - The buffer holds two halves of ADC_OVERSAMPLE scans each; the DMA
+ *   half-transfer and transfer-complete callbacks sum the half that was
+ *   just filled (integer only) while the DMA fills the other one
+ * - One float conversion per channel per half: output rate is the scan
+ *   rate / ADC_OVERSAMPLE, noise drops by sqrt(ADC_OVERSAMPLE)
+ * - Scaling and calibration applied
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-11-15
+ */
+
+#ifndef ADC_SENSING_H
+#define ADC_SENSING_H
+
+#include "board_config.h"
+#include "app_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Configuration */
+#define ADC_CHANNELS            4        // Number of ADC channels
+// ADC_RESOLUTION, ADC_VREF and the *_SCALE factors: board_config.h
+
+/* Oversampling (circular DMA) */
+#ifndef ADC_OVERSAMPLE
+#if TEST_MODE == 6
+#define ADC_OVERSAMPLE          16       // FCS-MPC needs the current every 20 kHz period (~24 kHz)
+#else
+#define ADC_OVERSAMPLE          64       // Scans summed per output (~6 kHz at 389 kHz scan rate)
+#endif
+#endif
+#define ADC_DMA_HALF_LEN        (ADC_OVERSAMPLE * ADC_CHANNELS)
+#define ADC_DMA_BUFFER_LEN      (2 * ADC_DMA_HALF_LEN)
+
+#if ADC_OVERSAMPLE > 1048576
+#error "ADC_OVERSAMPLE too large for 32-bit accumulation of 12-bit samples"
+#endif
+
+/* 389 kHz / 16 is just above the 20 kHz MPC rate; more scans per output
+ * would hand fcs_mpc_update() the same current twice */
+#if TEST_MODE == 6 && ADC_OVERSAMPLE > 16
+#error "TEST_MODE 6 (FCS-MPC) needs ADC_OVERSAMPLE <= 16"
+#endif
+
+/* Calibration offsets */
+#define CURRENT_OFFSET          0.0f     // Offset in Amps
+#define VOLTAGE_OFFSET          0.0f     // Offset in Volts
+
+/* Structures */
+typedef struct {
+    float output_current;       // Output current (A)
+    float output_voltage;       // Output voltage (V RMS or peak)
+    float dc_bus1_voltage;      // DC bus 1 voltage (V)
+    float dc_bus2_voltage;      // DC bus 2 voltage (V)
+    uint32_t sample_count;      // Outputs produced (one per DMA half)
+    bool valid;                 // Data validity flag
+} sensor_data_t;
+
+typedef struct {
+    ADC_HandleTypeDef *hadc;
+    DMA_HandleTypeDef *hdma;
+    uint16_t adc_buffer[ADC_DMA_BUFFER_LEN];    // Circular DMA, two halves
+    uint32_t block_sum[ADC_CHANNELS];           // Sums of the last half
+    float lsb_volts;            // Volts per LSB of a block sum
+    uint8_t next_half;          // Half expected from the next callback
+    uint32_t sequence_errors;   // Callbacks out of half/full order
+    sensor_data_t data;
+    float current_cal;          // Current calibration factor
+    float voltage_cal;          // Voltage calibration factor
+    bool initialized;
+} adc_sensor_t;
+
+/* Functions */
+int adc_sensor_init(adc_sensor_t *sensor, ADC_HandleTypeDef *hadc, DMA_HandleTypeDef *hdma);
+int adc_sensor_start(adc_sensor_t *sensor);
+int adc_sensor_stop(adc_sensor_t *sensor);
+void adc_sensor_update(adc_sensor_t *sensor);
+void adc_sensor_dma_half_complete(adc_sensor_t *sensor);
+void adc_sensor_dma_complete(adc_sensor_t *sensor);
+uint32_t adc_sensor_get_sequence_errors(const adc_sensor_t *sensor);
+const sensor_data_t* adc_sensor_get_data(const adc_sensor_t *sensor);
+void adc_sensor_calibrate(adc_sensor_t *sensor, float current_cal, float voltage_cal);
+
+/* Helper functions */
+float adc_to_voltage(uint16_t adc_value);
+float voltage_to_current(float voltage);
+float voltage_to_bus_voltage(float voltage);
+
+#endif // ADC_SENSING_H
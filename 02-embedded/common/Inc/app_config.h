@@ -0,0 +1,52 @@
+/**
+ * @file app_config.h
+ * @brief Application selections shared by every board
+ *
+ * What the inverter does (test mode, carrier arrangement, reference
+ * shape, compensations) is chosen here once for both boards; the board
+ * trees only bring up the clocks and peripherals.
+ *
+ * Test modes (select with TEST_MODE):
+ * 0 = PWM test (50% duty)
+ * 1 = Low frequency sine (5 Hz)
+ * 2 = Normal operation (50 Hz, 80% MI)
+ * 3 = Full power (50 Hz, 100% MI)
+ * 4 = Closed-loop current control (PR controller test)
+ * 5 = Grid-synchronized current control (SOGI-PLL on output voltage + PR)
+ * 6 = FCS-MPC current control (20 kHz, direct gate selection)
+ * 7 = Output voltage control (RMS PI per cycle over the PR current loop)
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+#ifndef APP_CONFIG_H
+#define APP_CONFIG_H
+
+/* Test mode selection */
+#ifndef TEST_MODE
+#define TEST_MODE 1  // Change this to select test mode
+#endif
+
+/* Carrier arrangement: MODULATION_MODE_LS (level-shifted, bands rotate
+ * between bridges every cycle) or MODULATION_MODE_PS (phase-shifted) */
+#define MODULATION_MODE MODULATION_MODE_LS
+
+/* Whether the modulator duties are corrected for the TIM1/TIM8 dead time
+ * (DEAD_TIME_COUNTS, inverter_config.h) from the current polarity */
+#define DEADTIME_COMPENSATION   1
+
+/* Normalize each bridge's duty to its measured DC bus (per sample), so
+ * the output stays on reference with unequal or sagging sources. A bus
+ * reading below half of nominal counts as nominal (gain 1) */
+#define DC_BUS_FEEDFORWARD      1
+
+/* Reference shape: MODULATION_SHAPE_SINE, _THI or _MINMAX (MI up to
+ * 2/sqrt(3), ~15% more voltage from the same DC bus), or the fundamental-
+ * frequency staircases _NLC and _SHE (5th/7th eliminated, she_angles.h) */
+#define REFERENCE_SHAPE MODULATION_SHAPE_SINE
+
+#define GRID_NOMINAL_PEAK_V     141.4f   // 100 V RMS, PLL per-unit base
+#define DC_BUS_NOMINAL_V        MODULATION_VDC_NOMINAL  // Per H-bridge, voltage loop base
+
+#endif // APP_CONFIG_H
@@ -6,6 +6,7 @@
  * - Current and voltage samples
  * - PWM duty cycles
  * - Modulation parameters
+ * - Per-cycle power metrics (RMS, P, PF, THD)
  *
  * Output format: CSV for easy plotting in Python/MATLAB
  *
@@ -16,9 +17,10 @@
 #ifndef DATA_LOGGER_H
 #define DATA_LOGGER_H
 
-#include "stm32f3xx_hal.h"
+#include "board_config.h"
 #include "adc_sensing.h"
 #include "multilevel_modulation.h"
+#include "power_metrics.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -51,6 +53,7 @@ void logger_enable(data_logger_t *logger, bool enable);
 
 // Logging functions
 void logger_log_status(data_logger_t *logger, const sensor_data_t *sensor, const modulation_t *mod);
+void logger_log_metrics(data_logger_t *logger, const power_metrics_data_t *metrics);
 void logger_log_waveform(data_logger_t *logger, float current, float voltage, uint16_t duty1, uint16_t duty2);
 void logger_log_header(data_logger_t *logger);
 void logger_log_message(data_logger_t *logger, const char *msg);
@@ -0,0 +1,70 @@
+/**
+ * @file deadtime_comp.h
+ * @brief Dead-time compensation by current-polarity feed-forward
+ *
+ * Sits between modulation_calculate_duties() and pwm_set_hbridge*_duty().
+ *
+ * During the dead time both switches of a leg are off and the freewheeling
+ * diode decides the leg voltage: current leaving the leg pulls it low,
+ * current entering it pulls it high. With the timer inserting Td on every
+ * rising gate edge, a switching leg is effectively high for
+ *
+ *   ccr - Td * sign(i_leg)      (i_leg > 0: current out of the leg)
+ *
+ * The output current i flows out of leg A and into leg B of both series
+ * bridges, so each switching bridge loses 2*Td/T*Vdc of volt-seconds
+ * against the current: a square wave in phase with i, i.e. low-order odd
+ * harmonics and a flattened zero crossing.
+ *
+ * Compensation adds it back:
+ *   ch1 += Td * s(i),  ch2 -= Td * s(i)
+ * with s(i) = clamp(i / band, -1, +1) so the correction fades through the
+ * zero crossing instead of chattering on measurement noise.
+ *
+ * The current is measured a period before the ISR and the duties only
+ * take effect at the next update (preload), so the polarity is taken from
+ * the measurement extrapolated `lead` periods ahead with a low-pass
+ * filtered slope. Without it the correction is wrong for ~2 periods at
+ * every zero crossing, which at light load undoes most of the gain.
+ *
+ * Legs that do not switch in the period (compare 0 or above ARR) see no
+ * dead time and are left alone, so idle and clamped bridges stay quiet.
+ *
+ * Current sign convention: positive = out of leg A (TIM1_CH1 / TIM8_CH1),
+ * the same direction as positive output voltage.
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-24
+ */
+
+#ifndef DEADTIME_COMP_H
+#define DEADTIME_COMP_H
+
+#include "multilevel_modulation.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defaults */
+#define DEADTIME_COMP_BAND_DEFAULT  0.03f   // A, about 1.5x the current noise
+#define DEADTIME_COMP_LEAD_DEFAULT  2.0f    // Periods, sample to applied duty
+#define DEADTIME_COMP_SLOPE_ALPHA   0.25f   // Slope low-pass per period
+
+/* Dead-time compensator */
+typedef struct {
+    uint16_t dt_counts[2];  // Dead time per bridge in timer counts (TIM1, TIM8)
+    float band;             // Current for full correction (A), 0 = hard sign
+    float lead;             // Polarity prediction horizon (periods)
+    float i_last;           // Previous measurement (A)
+    float slope;            // Filtered current slope (A per period)
+    float gain;             // Last applied polarity weight s(i), -1..+1
+    bool enabled;
+} deadtime_comp_t;
+
+/* Functions */
+int deadtime_comp_init(deadtime_comp_t *dtc, uint16_t dt1_counts, uint16_t dt2_counts, float band);
+void deadtime_comp_reset(deadtime_comp_t *dtc);
+void deadtime_comp_enable(deadtime_comp_t *dtc, bool enable);
+void deadtime_comp_set_lead(deadtime_comp_t *dtc, float periods);
+void deadtime_comp_apply(deadtime_comp_t *dtc, inverter_duty_t *duties, float i_out);
+
+#endif // DEADTIME_COMP_H
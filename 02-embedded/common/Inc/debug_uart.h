@@ -6,7 +6,7 @@
 #ifndef DEBUG_UART_H
 #define DEBUG_UART_H
 
-#include "stm32f3xx_hal.h"
+#include "board_config.h"
 #include <stdint.h>
 #include <stdbool.h>
 
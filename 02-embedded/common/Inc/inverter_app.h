@@ -0,0 +1,56 @@
+/**
+ * @file inverter_app.h
+ * @brief Inverter application, shared by every board
+ *
+ * Module setup, the test modes (app_config.h), the control interrupt
+ * (HAL_TIM_PeriodElapsedCallback on TIM1 update), the ADC DMA callbacks
+ * and the status loop. A board's main.c configures the clocks and
+ * peripherals and hands the HAL handles over:
+ *
+ *   inverter_app_init(&board);
+ *   inverter_app_start();
+ *   while (1) inverter_app_loop();
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+#ifndef INVERTER_APP_H
+#define INVERTER_APP_H
+
+#include "board_config.h"
+
+/**
+ * @brief Peripherals initialized by the board (MX_*_Init)
+ */
+typedef struct {
+    TIM_HandleTypeDef *htim1;       ///< H-bridge 1, master, control interrupt
+    TIM_HandleTypeDef *htim8;       ///< H-bridge 2, slave on TIM1 TRGO
+    UART_HandleTypeDef *huart;      ///< Debug output and logger
+    ADC_HandleTypeDef *hadc;        ///< 4-channel scan, BOARD_ADC_CH_* ranks
+    DMA_HandleTypeDef *hdma_adc;    ///< Circular DMA of the ADC scan
+} inverter_board_t;
+
+/**
+ * @brief Initialize the control modules and apply the test mode
+ *
+ * Calls Error_Handler() if a module fails to initialize.
+ *
+ * @param board Peripheral handles, kept for the lifetime of the application
+ */
+void inverter_app_init(const inverter_board_t *board);
+
+/**
+ * @brief Start ADC sampling, the carriers, the control interrupt and the
+ *        soft-start ramp
+ */
+void inverter_app_start(void);
+
+/**
+ * @brief One pass of the background loop (soft-start, safety, status)
+ *
+ * Call continuously from main(); paces itself with HAL_Delay.
+ */
+void inverter_app_loop(void);
+
+#endif // INVERTER_APP_H
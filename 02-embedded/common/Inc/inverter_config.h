@@ -0,0 +1,47 @@
+/**
+ * @file inverter_config.h
+ * @brief Inverter timing shared by every board, derived at compile time
+ *
+ * The only place the switching frequency, dead time and output frequency
+ * are set. Everything in timer counts follows from the board clocks in
+ * board_config.h, so the boards cannot drift apart:
+ *
+ *   PWM_PERIOD       = PWM_TIMER_CLOCK_HZ / PWM_FREQUENCY_HZ - 1  (ARR)
+ *   PWM_COUNTS       = PWM_PERIOD + 1                             (one period)
+ *   DEAD_TIME_COUNTS = PWM_DEAD_TIME_NS at PWM_TIMER_CLOCK_HZ     (DTG)
+ *
+ * The control loops run once per PWM period (TIM1 update), so the
+ * controller sample rate is PWM_FREQUENCY_HZ as well. The static asserts
+ * reject a board/frequency pair the timers cannot produce exactly.
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+#ifndef INVERTER_CONFIG_H
+#define INVERTER_CONFIG_H
+
+#include "board_config.h"
+
+/* Switching */
+#define PWM_FREQUENCY_HZ        5000      // Carrier frequency, also the control rate
+#define PWM_DEAD_TIME_NS        1000      // Inserted by TIM1/TIM8 (DTG)
+#define OUTPUT_FREQUENCY_HZ     50        // Output sine wave frequency
+
+/* Derived, in timer counts */
+#define PWM_PERIOD              (PWM_TIMER_CLOCK_HZ / PWM_FREQUENCY_HZ - 1)
+#define PWM_COUNTS              (PWM_PERIOD + 1)
+#define PWM_MAX_DUTY            PWM_COUNTS          // Compare above ARR: leg fully on
+#define PWM_DUTY_SCALE          (0.5f * PWM_COUNTS) // Counts per unit of (1 + m)
+#define DEAD_TIME_COUNTS        ((PWM_TIMER_CLOCK_HZ / 1000000 * PWM_DEAD_TIME_NS + 500) / 1000)
+
+/* Controller sample rate */
+#define CONTROL_SAMPLE_FREQ_HZ  ((float)PWM_FREQUENCY_HZ)
+
+_Static_assert(PWM_TIMER_CLOCK_HZ % PWM_FREQUENCY_HZ == 0,
+               "PWM frequency is not a whole number of timer counts");
+_Static_assert(PWM_PERIOD <= 65534, "PWM period exceeds the 16-bit timer");
+_Static_assert(PWM_TIMER_CLOCK_HZ % 1000000 == 0, "timer clock not a whole MHz");
+_Static_assert(DEAD_TIME_COUNTS <= 127, "dead time beyond the linear DTG range");
+
+#endif // INVERTER_CONFIG_H
@@ -0,0 +1,141 @@
+/**
+ * @file multilevel_modulation.h
+ * @brief Level-shifted / phase-shifted PWM modulation for 5-level cascaded H-bridge
+ *
+ * LEVEL-SHIFTED CARRIER STRATEGY (MODULATION_MODE_LS):
+ * - Carrier 1: Triangle wave from -1 to 0 (for H-bridge 1)
+ * - Carrier 2: Triangle wave from 0 to +1 (for H-bridge 2)
+ * - Reference: Sine wave from -1 to +1
+ * - Each carrier at same frequency but vertically offset
+ * - The inner-band bridge carries most of the power; with rotation
+ *   enabled the bands swap bridges every output cycle
+ *
+ * PHASE-SHIFTED CARRIER STRATEGY (MODULATION_MODE_PS):
+ * - Both bridges get the full reference (unipolar, -1 to +1)
+ * - TIM8 runs half a period behind TIM1 (see modulation_carrier_shift),
+ *   the 180 deg shift for one edge-aligned pulse per period
+ * - Output ripple at 2 x PWM_FREQUENCY_HZ, equal power and switching
+ *   in both bridges by construction
+ *
+ * REFERENCE SHAPING (applied to the table before the carrier comparison):
+ * - SINE:   plain sine, linear up to MI = 1
+ * - THI:    sin(x) + k*sin(3x); k = 1/6 flattens the peak to sqrt(3)/2,
+ *           so MI up to 2/sqrt(3) (+15.5%) stays in the linear range
+ * - MINMAX: sin(x) - (max + min)/2 of the balanced three-phase set, the
+ *           carrier equivalent of SVPWM, same 2/sqrt(3) limit
+ * - NLC:    nearest-level control, the output is the level nearest to
+ *           2 * MI * sin(x), no carrier switching. MI above 1 widens the
+ *           steps towards quasi-square (fundamental 1.16 at MI 1.4)
+ * - SHE:    fundamental-frequency staircase with precomputed switching
+ *           angles (she_angles.h, generated by 06-tools/she/she_solver)
+ *           that eliminate the 5th and 7th harmonics; MI from the table
+ *           range, no output below SHE_MI_MIN
+ * THI and MINMAX add triplen harmonics to the output of a single phase;
+ * they cancel line-to-line only in a three-phase connection. Use them
+ * for DC-bus headroom (sag ride-through), not on a THD-critical load.
+ * NLC and SHE switch each bridge a few times per output cycle instead of
+ * every PWM period, for low switching loss at high power.
+ *
+ * THREE-PHASE:
+ * modulation_calculate_duties_3ph() computes the duties of all three
+ * phases (six bridges) from one modulator in one call: phase b lags a by
+ * 120 deg, c leads it. THI and MINMAX inject the same zero sequence into
+ * every phase, MINMAX from the actual -(max + min)/2 of the three
+ * references (SVPWM equivalent), so it cancels line-to-line exactly. Each
+ * phase rotates its LS bands at its own zero crossing. The bus ratios of
+ * modulation_set_dc_bus() apply to bridge 1 and 2 of every phase.
+ *
+ * DC-LINK FEED-FORWARD:
+ * The reference is per unit of the nominal output, 2 * MODULATION_VDC_NOMINAL.
+ * modulation_set_dc_bus() takes the measured bus of each bridge once per
+ * sample and scales that bridge's duty by Vnom / Vdc, so the output volts
+ * follow the reference while one source sags or ripples. In LS the inner
+ * band ends at the inner bridge's actual bus voltage and the outer bridge
+ * supplies the rest. NLC and SHE keep full on/off steps (staircase
+ * levels, not normalized). Until it is called both buses are nominal.
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-11-15
+ */
+
+#ifndef MULTILEVEL_MODULATION_H
+#define MULTILEVEL_MODULATION_H
+
+#include "inverter_config.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Configuration (switching frequency and PWM_PERIOD: inverter_config.h) */
+#define SINE_TABLE_SIZE         200       // Full cycle samples
+
+#define MODULATION_THI_K_DEFAULT    (1.0f / 6.0f)  // Third-harmonic ratio, min peak
+#define MODULATION_MI_MAX_NLC       1.4f           // NLC overmodulation limit
+
+#define MODULATION_PHASES           3       // modulation_calculate_duties_3ph()
+
+#define MODULATION_VDC_NOMINAL      50.0f   // Per-bridge bus the reference is scaled to (V)
+#define MODULATION_VDC_MIN_RATIO    0.5f    // Readings below: nominal, duty gain <= 2
+
+/* Carrier arrangement */
+typedef enum {
+    MODULATION_MODE_LS = 0,   // Level-shifted (phase disposition)
+    MODULATION_MODE_PS        // Phase-shifted, full-range carriers
+} modulation_mode_t;
+
+/* Reference shaping */
+typedef enum {
+    MODULATION_SHAPE_SINE = 0,  // Plain sine
+    MODULATION_SHAPE_THI,       // Third-harmonic injection
+    MODULATION_SHAPE_MINMAX,    // Min-max zero sequence
+    MODULATION_SHAPE_NLC,       // Nearest-level staircase
+    MODULATION_SHAPE_SHE        // Selective harmonic elimination staircase
+} modulation_shape_t;
+
+/* Structures */
+typedef struct {
+    uint16_t ch1;  // Channel 1 duty
+    uint16_t ch2;  // Channel 2 duty
+} hbridge_duty_t;
+
+typedef struct {
+    hbridge_duty_t hbridge1;  // TIM1 - Level 1 (carrier -1 to 0)
+    hbridge_duty_t hbridge2;  // TIM8 - Level 2 (carrier 0 to +1)
+} inverter_duty_t;
+
+typedef struct {
+    inverter_duty_t phase[MODULATION_PHASES];  // a, b (-120 deg), c (+120 deg)
+} inverter_duty_3ph_t;
+
+typedef struct {
+    float modulation_index;   // 0.0 to mi_max
+    float mi_max;             // Linear limit of the selected shape
+    float frequency_hz;
+    uint32_t phase;           // DDS phase accumulator (2^32 = one cycle)
+    uint32_t phase_step;      // Phase advance per PWM period
+    modulation_mode_t mode;
+    modulation_shape_t shape;
+    float thi_k;              // THI: third-harmonic amplitude / fundamental
+    bool rotation;            // LS: swap bands every output cycle
+    bool swapped;             // LS: H-bridge 2 has the inner band
+    float bus[2];             // Measured bus / nominal, per bridge
+    float gain[2];            // Nominal / measured bus (duty normalization)
+    bool enabled;
+} modulation_t;
+
+/* Functions */
+int modulation_init(modulation_t *mod);
+int modulation_calculate_duties(modulation_t *mod, inverter_duty_t *duties);
+int modulation_calculate_duties_ref(modulation_t *mod, float ref, inverter_duty_t *duties);
+int modulation_calculate_duties_3ph(modulation_t *mod, inverter_duty_3ph_t *duties);
+void modulation_update(modulation_t *mod);
+void modulation_set_index(modulation_t *mod, float mi);
+void modulation_set_frequency(modulation_t *mod, float freq);
+void modulation_sync(modulation_t *mod, uint32_t phase, float freq);
+void modulation_set_mode(modulation_t *mod, modulation_mode_t mode);
+void modulation_set_rotation(modulation_t *mod, bool enable);
+uint16_t modulation_carrier_shift(const modulation_t *mod);
+int modulation_set_shape(modulation_t *mod, modulation_shape_t shape, float thi_k);
+float modulation_get_max_index(const modulation_t *mod);
+void modulation_set_dc_bus(modulation_t *mod, float vdc1, float vdc2);
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file power_metrics.h
+ * @brief Live RMS, power, DC-bus ripple and THD over one fundamental cycle
+ *
+ * Fed once per control update (TIM1 ISR) with the measured output voltage,
+ * output current and both DC bus voltages. Every call is O(1):
+ * - Sliding sums of v^2, i^2 and v*i over exactly one fundamental cycle
+ *   give RMS V/I, real power P, apparent power S = Vrms*Irms and PF = P/S
+ *   after every sample
+ * - Goertzel filters for harmonics 1-13 of V and I run over the same
+ *   window and are read out at the end of each cycle (THD without FFT)
+ * - DC bus mean and peak-to-peak ripple are taken per cycle
+ *
+ * The window is round(fs / f1) samples. If that exceeds PM_MAX_WINDOW
+ * (low test frequencies), only every stride-th sample is used.
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-21
+ */
+
+#ifndef POWER_METRICS_H
+#define POWER_METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Configuration */
+#define PM_MAX_WINDOW           400      // Samples per cycle (100 at 5 kHz / 50 Hz)
+#define PM_HARMONICS            13       // Harmonics 1..13
+
+/* Results */
+typedef struct {
+    float v_rms;                // Output voltage RMS (V)
+    float i_rms;                // Output current RMS (A)
+    float p_real;               // Real power, mean(v*i) (W)
+    float s_apparent;           // Apparent power, Vrms*Irms (VA)
+    float power_factor;         // P / S
+    float dc1_mean;             // DC bus 1 mean over the last cycle (V)
+    float dc2_mean;             // DC bus 2 mean over the last cycle (V)
+    float dc1_ripple;           // DC bus 1 peak-to-peak over the last cycle (V)
+    float dc2_ripple;           // DC bus 2 peak-to-peak over the last cycle (V)
+    float v_harmonic[PM_HARMONICS];  // RMS of harmonic h+1 (index 0 = fundamental)
+    float i_harmonic[PM_HARMONICS];
+    float v_thd;                // THD up to the 13th (ratio, 0.05 = 5%)
+    float i_thd;
+    uint32_t cycles;            // Completed cycles
+    bool valid;                 // At least one full cycle seen
+} power_metrics_data_t;
+
+typedef struct {
+    // Window
+    uint16_t window;            // Samples per fundamental cycle
+    uint16_t stride;            // Use every stride-th input sample
+    uint16_t stride_count;
+    uint16_t index;             // Position in the cycle / ring buffers
+    float v_buf[PM_MAX_WINDOW];
+    float i_buf[PM_MAX_WINDOW];
+
+    // Sliding sums (last window) and block sums (current cycle)
+    float sum_v2, sum_i2, sum_vi;
+    float blk_v2, blk_i2, blk_vi;
+
+    // DC bus, current cycle
+    float dc1_sum, dc1_min, dc1_max;
+    float dc2_sum, dc2_min, dc2_max;
+
+    // Goertzel state per harmonic
+    float g_coeff[PM_HARMONICS];    // 2*cos(2*pi*h/N)
+    float g_cos[PM_HARMONICS];
+    float g_sin[PM_HARMONICS];
+    float gv_s1[PM_HARMONICS], gv_s2[PM_HARMONICS];
+    float gi_s1[PM_HARMONICS], gi_s2[PM_HARMONICS];
+
+    power_metrics_data_t data;
+    bool initialized;
+} power_metrics_t;
+
+/* Functions */
+int power_metrics_init(power_metrics_t *pm, float sample_freq_hz, float fundamental_hz);
+void power_metrics_reset(power_metrics_t *pm);
+bool power_metrics_update(power_metrics_t *pm, float v, float i, float vdc1, float vdc2);
+const power_metrics_data_t* power_metrics_get(const power_metrics_t *pm);
+
+#endif // POWER_METRICS_H
@@ -16,6 +16,16 @@
  * - ω₀: Resonant frequency (2π*50)
  * - ωc: Cutoff frequency (bandwidth)
  *
+ * Anti-windup (back-calculation): while the output is clamped, the
+ * resonant part is fed e + Kt*(u_clamped - u) instead of e, so its
+ * oscillation settles at the amplitude the limit allows instead of
+ * growing without bound. Kt = 0 (default) keeps the plain clamp.
+ *
+ * Gain changes keep the resonant states: the states hold the resonant
+ * output itself, so a new Kr only scales the input from the next sample
+ * and the output stays continuous. pr_controller_preset() loads the
+ * states with a running sinusoid for bumpless hand-over from open loop.
+ *
  * @author 5-Level Inverter Project
  * @date 2025-11-15
  */
@@ -23,18 +33,32 @@
 #ifndef PR_CONTROLLER_H
 #define PR_CONTROLLER_H
 
+#include "inverter_config.h"
 #include <stdint.h>
 #include <stdbool.h>
 
 /* Configuration */
-#define PR_FUNDAMENTAL_FREQ     50.0f    // 50 Hz
-#define PR_SAMPLE_FREQ          5000.0f  // 5 kHz (PWM frequency)
+#define PR_FUNDAMENTAL_FREQ     ((float)OUTPUT_FREQUENCY_HZ)
+#define PR_SAMPLE_FREQ          CONTROL_SAMPLE_FREQ_HZ  // Once per PWM period
 
 /* Default gains (tune these for your system) */
 #define PR_KP_DEFAULT           1.0f     // Proportional gain
 #define PR_KR_DEFAULT           50.0f    // Resonant gain
 #define PR_WC_DEFAULT           10.0f    // Cutoff frequency (rad/s)
 
+/*
+ * Tustin discretization of H(s) = 2*Kr*wc*s / (s² + 2*wc*s + w0²):
+ *   H(z) = Kr*B*(1 - z^-2) / (1 + a1*z^-1 + a2*z^-2)
+ * Constant expressions, so for a fixed wc the compiler folds them.
+ */
+#define PR_TS                   (1.0f / PR_SAMPLE_FREQ)
+#define PR_W0                   (2.0f * 3.14159265359f * PR_FUNDAMENTAL_FREQ)
+#define PR_WT                   (PR_W0 * PR_TS)   // Phase advance per sample
+#define PR_DEN(wc)              (4.0f + 2.0f*(wc)*PR_TS + PR_WT*PR_WT)
+#define PR_A1(wc)               ((2.0f*PR_WT*PR_WT - 8.0f) / PR_DEN(wc))
+#define PR_A2(wc)               ((4.0f - 2.0f*(wc)*PR_TS + PR_WT*PR_WT) / PR_DEN(wc))
+#define PR_B_PER_KR(wc)         (4.0f*(wc)*PR_TS / PR_DEN(wc))
+
 /* PR controller structure */
 typedef struct {
     // Gains
@@ -45,11 +69,16 @@ typedef struct {
     // Discrete coefficients (calculated from continuous)
     float b0, b1, b2;       // Numerator coefficients
     float a1, a2;           // Denominator coefficients
+    float b_kr;             // b0 per unit Kr (depends on wc only)
 
     // State variables
     float x1, x2;           // State memory
     float y1, y2;           // Output memory
 
+    // Anti-windup
+    float kt;               // Back-calculation gain (error units per output unit)
+    float excess;           // Clamped minus unclamped output, last sample
+
     // Limits
     float output_min;
     float output_max;
@@ -65,5 +94,7 @@ void pr_controller_reset(pr_controller_t *pr);
 float pr_controller_update(pr_controller_t *pr, float reference, float measured);
 void pr_controller_set_limits(pr_controller_t *pr, float min, float max);
 void pr_controller_set_gains(pr_controller_t *pr, float kp, float kr);
+void pr_controller_set_antiwindup(pr_controller_t *pr, float kt);
+void pr_controller_preset(pr_controller_t *pr, float amplitude, float phase);
 
 #endif // PR_CONTROLLER_H
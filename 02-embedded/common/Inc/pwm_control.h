@@ -26,7 +26,7 @@
 #ifndef PWM_CONTROL_H
 #define PWM_CONTROL_H
 
-#include "stm32f3xx_hal.h"
+#include "inverter_config.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -34,13 +34,8 @@
 /*                             CONSTANTS                                      */
 /* ========================================================================= */
 
-#define PWM_FREQUENCY_HZ        10000    // 10 kHz switching frequency
-#define PWM_DEAD_TIME_NS        1000     // 1 μs dead-time
-#define SYSTEM_CLOCK_HZ         84000000 // 84 MHz system clock
-
-// PWM period calculation: (84MHz / 10kHz) - 1 = 8399
-#define PWM_PERIOD              8399
-#define PWM_MAX_DUTY            8399
+// PWM_FREQUENCY_HZ, PWM_PERIOD, PWM_MAX_DUTY and the dead time are derived
+// from the board clock in inverter_config.h
 
 /* ========================================================================= */
 /*                             ENUMERATIONS                                   */
@@ -77,8 +72,8 @@ typedef struct {
     TIM_HandleTypeDef *htim;    ///< Timer handle
     uint32_t channel_high1;     ///< Channel for high-side switch 1
     uint32_t channel_high2;     ///< Channel for high-side switch 2
-    uint16_t duty_cycle1;       ///< Duty cycle for channel 1 (0-8399)
-    uint16_t duty_cycle2;       ///< Duty cycle for channel 2 (0-8399)
+    uint16_t duty_cycle1;       ///< Duty cycle for channel 1 (0-PWM_MAX_DUTY)
+    uint16_t duty_cycle2;       ///< Duty cycle for channel 2 (0-PWM_MAX_DUTY)
 } hbridge_t;
 
 /**
@@ -87,6 +82,7 @@ typedef struct {
 typedef struct {
     hbridge_t hbridge1;         ///< H-bridge 1 (TIM1)
     hbridge_t hbridge2;         ///< H-bridge 2 (TIM8)
+    uint16_t carrier_shift;     ///< TIM8 start count against TIM1 (PS carriers)
     pwm_state_t state;          ///< Current state
     uint32_t fault_count;       ///< Fault counter
     bool emergency_stop;        ///< Emergency stop flag
@@ -112,7 +108,10 @@ int pwm_init(pwm_controller_t *ctrl, TIM_HandleTypeDef *htim1, TIM_HandleTypeDef
 /**
  * @brief Start PWM generation
  *
- * Enables PWM outputs on both H-bridges with initial 0% duty cycle.
+ * Enables PWM outputs on both H-bridges with initial 0% duty cycle,
+ * then starts TIM1 (and its update interrupt, the control loop) from 0
+ * with TIM8 preset to the carrier shift, so TIM8 follows on TIM1's first
+ * update with that fixed offset.
  *
  * @param ctrl Pointer to PWM controller structure
  * @return 0 on success, negative error code on failure
@@ -142,8 +141,8 @@ void pwm_emergency_stop(pwm_controller_t *ctrl);
  * @brief Set duty cycle for H-bridge 1
  *
  * @param ctrl Pointer to PWM controller structure
- * @param ch1_duty Duty cycle for channel 1 (0-8399)
- * @param ch2_duty Duty cycle for channel 2 (0-8399)
+ * @param ch1_duty Duty cycle for channel 1 (0-PWM_MAX_DUTY)
+ * @param ch2_duty Duty cycle for channel 2 (0-PWM_MAX_DUTY)
  * @return 0 on success, negative error code on failure
  */
 int pwm_set_hbridge1_duty(pwm_controller_t *ctrl, uint16_t ch1_duty, uint16_t ch2_duty);
@@ -152,12 +151,38 @@ int pwm_set_hbridge1_duty(pwm_controller_t *ctrl, uint16_t ch1_duty, uint16_t ch
  * @brief Set duty cycle for H-bridge 2
  *
  * @param ctrl Pointer to PWM controller structure
- * @param ch1_duty Duty cycle for channel 1 (0-8399)
- * @param ch2_duty Duty cycle for channel 2 (0-8399)
+ * @param ch1_duty Duty cycle for channel 1 (0-PWM_MAX_DUTY)
+ * @param ch2_duty Duty cycle for channel 2 (0-PWM_MAX_DUTY)
  * @return 0 on success, negative error code on failure
  */
 int pwm_set_hbridge2_duty(pwm_controller_t *ctrl, uint16_t ch1_duty, uint16_t ch2_duty);
 
+/**
+ * @brief Drive the legs fully on/off (direct gate control, no PWM)
+ *
+ * Each leg's high-side switch is held on (compare above the period) or off
+ * (compare 0) for the whole next period; the complementary low side and
+ * dead-time follow from the timer. Used by FCS-MPC.
+ *
+ * @param ctrl Pointer to PWM controller structure
+ * @param gates bit0/bit1: H-bridge 1 leg A/B, bit2/bit3: H-bridge 2 leg A/B
+ * @return 0 on success, negative error code on failure
+ */
+int pwm_set_gates(pwm_controller_t *ctrl, uint8_t gates);
+
+/**
+ * @brief Offset TIM8 (H-bridge 2) against TIM1 for phase-shifted carriers
+ *
+ * TIM8 is started by TIM1's trigger output; pwm_start() presets it to
+ * this count with TIM1 at 0, so the offset stays fixed. Call before
+ * pwm_start().
+ *
+ * @param ctrl Pointer to PWM controller structure
+ * @param counts TIM8 start count (0 = in phase, ARR/2 = 180 deg)
+ * @return 0 on success, negative error code on failure
+ */
+int pwm_set_carrier_shift(pwm_controller_t *ctrl, uint16_t counts);
+
 /**
  * @brief Get current PWM state
  *
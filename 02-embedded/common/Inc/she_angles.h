@@ -0,0 +1,74 @@
+/**
+ * @file she_angles.h
+ * @brief SHE staircase switching angles, MI -> (pattern, a1..a3)
+ *
+ * GENERATED by 06-tools/she/she_solver.cpp - do not edit.
+ *
+ * Quarter-wave angles (rad) of the 5-level staircase eliminating the
+ * 5th and 7th harmonics, on an MI grid of 1/128 from SHE_MI_MIN.
+ * sign[k] is the level step at a[k] (+1 up, -1 down).
+ *
+ * @author 5-Level Inverter Project
+ */
+
+#ifndef SHE_ANGLES_H
+#define SHE_ANGLES_H
+
+#include <stdint.h>
+
+#define SHE_ANGLES          3
+#define SHE_TABLE_SIZE      38
+#define SHE_MI_STEP         (1.0f / 128.0f)
+#define SHE_MI_MIN          (83.0f / 128.0f)
+#define SHE_MI_MAX          (120.0f / 128.0f)
+#define SHE_HARMONIC_A      5
+#define SHE_HARMONIC_B      7
+#define SHE_THD_MAX         40.0f      // % of fundamental, odd 3..49
+
+typedef struct {
+    int8_t sign[SHE_ANGLES];    // Level step at each angle
+    float alpha[SHE_ANGLES];    // Quarter-wave angles (rad), ascending
+} she_entry_t;
+
+static const she_entry_t she_table[SHE_TABLE_SIZE] = {
+    {{+1, +1, -1}, {0.2869151f, 1.1371341f, 1.2017190f}},   // MI 0.6484 notch, THD 32.2%
+    {{+1, +1, -1}, {0.2929366f, 1.1624318f, 1.2411866f}},   // MI 0.6562 notch, THD 32.4%
+    {{+1, +1, -1}, {0.2977711f, 1.1744517f, 1.2672201f}},   // MI 0.6641 notch, THD 32.8%
+    {{+1, +1, -1}, {0.3021196f, 1.1804072f, 1.2871298f}},   // MI 0.6719 notch, THD 32.9%
+    {{+1, +1, -1}, {0.3061975f, 1.1829059f, 1.3035542f}},   // MI 0.6797 notch, THD 32.9%
+    {{+1, +1, -1}, {0.3100951f, 1.1832012f, 1.3177596f}},   // MI 0.6875 notch, THD 32.8%
+    {{+1, +1, -1}, {0.3138559f, 1.1819893f, 1.3304483f}},   // MI 0.6953 notch, THD 32.7%
+    {{+1, +1, -1}, {0.3175019f, 1.1796938f, 1.3420465f}},   // MI 0.7031 notch, THD 32.7%
+    {{+1, +1, -1}, {0.3210442f, 1.1765891f, 1.3528297f}},   // MI 0.7109 notch, THD 32.6%
+    {{+1, +1, -1}, {0.3244877f, 1.1728619f, 1.3629845f}},   // MI 0.7188 notch, THD 32.6%
+    {{+1, +1, -1}, {0.3278335f, 1.1686442f, 1.3726420f}},   // MI 0.7266 notch, THD 32.7%
+    {{+1, +1, -1}, {0.3310801f, 1.1640320f, 1.3818969f}},   // MI 0.7344 notch, THD 32.6%
+    {{+1, +1, -1}, {0.3342243f, 1.1590969f, 1.3908192f}},   // MI 0.7422 notch, THD 32.5%
+    {{+1, +1, -1}, {0.3372617f, 1.1538935f, 1.3994617f}},   // MI 0.7500 notch, THD 32.3%
+    {{+1, +1, -1}, {0.3401872f, 1.1484643f, 1.4078645f}},   // MI 0.7578 notch, THD 32.1%
+    {{+1, +1, -1}, {0.3429947f, 1.1428427f, 1.4160589f}},   // MI 0.7656 notch, THD 31.8%
+    {{+1, +1, -1}, {0.3456777f, 1.1370556f, 1.4240691f}},   // MI 0.7734 notch, THD 31.5%
+    {{+1, +1, -1}, {0.3482293f, 1.1311245f, 1.4319140f}},   // MI 0.7812 notch, THD 31.2%
+    {{+1, +1, -1}, {0.3506425f, 1.1250672f, 1.4396087f}},   // MI 0.7891 notch, THD 31.0%
+    {{+1, +1, -1}, {0.3529097f, 1.1188981f, 1.4471650f}},   // MI 0.7969 notch, THD 30.8%
+    {{+1, +1, -1}, {0.3550234f, 1.1126294f, 1.4545920f}},   // MI 0.8047 notch, THD 30.5%
+    {{+1, +1, -1}, {0.3569762f, 1.1062711f, 1.4618971f}},   // MI 0.8125 notch, THD 30.1%
+    {{+1, +1, -1}, {0.3587604f, 1.0998315f, 1.4690858f}},   // MI 0.8203 notch, THD 29.7%
+    {{+1, +1, -1}, {0.3603686f, 1.0933177f, 1.4761626f}},   // MI 0.8281 notch, THD 29.3%
+    {{+1, +1, -1}, {0.3617935f, 1.0867353f, 1.4831307f}},   // MI 0.8359 notch, THD 28.8%
+    {{+1, +1, -1}, {0.3630282f, 1.0800893f, 1.4899924f}},   // MI 0.8438 notch, THD 28.4%
+    {{+1, +1, -1}, {0.3640660f, 1.0733834f, 1.4967497f}},   // MI 0.8516 notch, THD 28.0%
+    {{+1, +1, -1}, {0.3649006f, 1.0666208f, 1.5034035f}},   // MI 0.8594 notch, THD 27.6%
+    {{+1, +1, -1}, {0.3655262f, 1.0598038f, 1.5099547f}},   // MI 0.8672 notch, THD 27.2%
+    {{+1, +1, -1}, {0.3659373f, 1.0529341f, 1.5164037f}},   // MI 0.8750 notch, THD 26.7%
+    {{+1, +1, -1}, {0.3661293f, 1.0460126f, 1.5227506f}},   // MI 0.8828 notch, THD 26.3%
+    {{+1, +1, -1}, {0.3660978f, 1.0390399f, 1.5289953f}},   // MI 0.8906 notch, THD 25.7%
+    {{+1, +1, -1}, {0.3658391f, 1.0320158f, 1.5351375f}},   // MI 0.8984 notch, THD 25.1%
+    {{+1, +1, -1}, {0.3653500f, 1.0249395f, 1.5411768f}},   // MI 0.9062 notch, THD 24.4%
+    {{+1, +1, -1}, {0.3646279f, 1.0178097f, 1.5471125f}},   // MI 0.9141 notch, THD 23.7%
+    {{+1, +1, -1}, {0.3636704f, 1.0106245f, 1.5529439f}},   // MI 0.9219 notch, THD 23.1%
+    {{+1, +1, -1}, {0.3624760f, 1.0033815f, 1.5586702f}},   // MI 0.9297 notch, THD 22.5%
+    {{+1, +1, -1}, {0.3610430f, 0.9960776f, 1.5642902f}},   // MI 0.9375 notch, THD 22.1%
+};
+
+#endif // SHE_ANGLES_H
@@ -0,0 +1,50 @@
+/**
+ * @file sine_lut.h
+ * @brief Sine lookup tables as compile-time initializers
+ *
+ * SINE_LUT_k(i, n) expands to the 2^k initializers sin(2*pi*j/n),
+ * j = i .. i+2^k-1, evaluated by the compiler so the table lives in flash
+ * and nothing is computed at init. A table of n entries concatenates the
+ * blocks of the binary digits of n (see SINE_LUT_200). Each angle is
+ * folded to |x| <= pi/2 and fed to a degree-13 Taylor polynomial
+ * (error < 1e-9, far below float resolution).
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+#ifndef SINE_LUT_H
+#define SINE_LUT_H
+
+#define SINE_LUT_PI             3.14159265358979323846
+
+/* sin(x) for |x| <= pi/2, Horner form of the Taylor series */
+#define SINE_LUT_X2(x)          ((x) * (x))
+#define SINE_LUT_POLY(x)                                                    \
+    ((x) * (1.0 - SINE_LUT_X2(x) / 6.0 * (1.0 - SINE_LUT_X2(x) / 20.0 *     \
+     (1.0 - SINE_LUT_X2(x) / 42.0 * (1.0 - SINE_LUT_X2(x) / 72.0 *          \
+     (1.0 - SINE_LUT_X2(x) / 110.0 * (1.0 - SINE_LUT_X2(x) / 156.0)))))))
+
+/* Angle of entry i folded into [-pi/2, pi/2] */
+#define SINE_LUT_FOLD(i, n)                                                 \
+    ((4 * (i) < (n))     ? (2.0 * SINE_LUT_PI * (i) / (n)) :                \
+     (4 * (i) < 3 * (n)) ? (SINE_LUT_PI - 2.0 * SINE_LUT_PI * (i) / (n)) :  \
+                           (2.0 * SINE_LUT_PI * (i) / (n) - 2.0 * SINE_LUT_PI))
+
+#define SINE_LUT_ENTRY(i, n)    (float)SINE_LUT_POLY(SINE_LUT_FOLD(i, n)),
+
+/* Entries i .. i+2^k-1 */
+#define SINE_LUT_1(i, n)        SINE_LUT_ENTRY(i, n)
+#define SINE_LUT_2(i, n)        SINE_LUT_1(i, n) SINE_LUT_1((i) + 1, n)
+#define SINE_LUT_4(i, n)        SINE_LUT_2(i, n) SINE_LUT_2((i) + 2, n)
+#define SINE_LUT_8(i, n)        SINE_LUT_4(i, n) SINE_LUT_4((i) + 4, n)
+#define SINE_LUT_16(i, n)       SINE_LUT_8(i, n) SINE_LUT_8((i) + 8, n)
+#define SINE_LUT_32(i, n)       SINE_LUT_16(i, n) SINE_LUT_16((i) + 16, n)
+#define SINE_LUT_64(i, n)       SINE_LUT_32(i, n) SINE_LUT_32((i) + 32, n)
+#define SINE_LUT_128(i, n)      SINE_LUT_64(i, n) SINE_LUT_64((i) + 64, n)
+
+/* Full cycle of 200 entries: 128 + 64 + 8 */
+#define SINE_LUT_200            { SINE_LUT_128(0, 200) SINE_LUT_64(128, 200) \
+                                  SINE_LUT_8(192, 200) }
+
+#endif // SINE_LUT_H
@@ -18,6 +18,7 @@
 /* Configuration */
 #define SOFT_START_RAMP_TIME_MS     2000     // 2 second ramp
 #define SOFT_START_STEP_TIME_MS     10       // Update every 10ms
+#define SOFT_START_MAX_MI           1.4f     // Highest MI of any reference shape (NLC)
 
 /* Soft-start states */
 typedef enum {
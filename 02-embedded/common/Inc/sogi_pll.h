@@ -0,0 +1,124 @@
+/**
+ * @file sogi_pll.h
+ * @brief SOGI-based PLL for grid synchronization
+ *
+ * Second-Order Generalized Integrator (SOGI) quadrature generator
+ * followed by a PI phase-locked loop:
+ *
+ *   v --> SOGI --> v_alpha (in phase, filtered)
+ *              --> v_beta  (90 deg behind)
+ *
+ *   e = v_alpha*cos(theta) + v_beta*sin(theta) = V*sin(theta_grid - theta)
+ *   w = w_nom + Kp*e + Ki*integral(e),  theta += w*Ts
+ *
+ * theta is locked so that sin(theta) follows the input, i.e. it can drive
+ * the modulator sine reference directly (see modulation_sync()). The SOGI
+ * tracks the PLL frequency, so harmonics are rejected at any grid frequency.
+ *
+ * Two variants with the same structure:
+ * - sogi_pll_t:   float, input in volts, error normalized by amplitude
+ * - sogi_pll_q_t: fixed point, input per-unit Q14 (16384 = nominal peak,
+ *                 +-2 pu headroom for distorted grids),
+ *                 phase as a 32-bit accumulator (2^32 = one cycle)
+ *
+ * The SOGI is discretized with the bilinear transform and its coefficients
+ * are recomputed from the PLL frequency every sample, so v_alpha has no
+ * phase lag and v_beta stays 90 deg behind at the tracked frequency.
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-22
+ */
+
+#ifndef SOGI_PLL_H
+#define SOGI_PLL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Default tuning (PI from wn = 2*pi*15 Hz, zeta = 0.707) */
+#define SOGI_K_DEFAULT          1.41f    // SOGI damping gain
+#define PLL_KP_DEFAULT          133.0f   // rad/s per rad
+#define PLL_KI_DEFAULT          8880.0f  // rad/s^2 per rad
+#define PLL_FREQ_RANGE          0.5f     // Frequency clamp, +-50% of nominal
+#define PLL_LOCK_THRESHOLD      0.03f    // Filtered phase error for lock (rad)
+#define PLL_LOCK_TIME_S         0.1f     // Error must stay below threshold this long
+
+/* Select the variant used by inverter_app.c */
+#ifndef SOGI_PLL_FIXED_POINT
+#define SOGI_PLL_FIXED_POINT    0
+#endif
+
+/* Float variant */
+typedef struct {
+    // Configuration
+    float ts;               // Sample period (s)
+    float w_nom;            // Nominal frequency (rad/s)
+    float w_min, w_max;     // Frequency clamp (rad/s)
+    float k;                // SOGI gain
+    float kp, ki;           // PI gains
+    float v_min;            // Amplitude floor for error normalization
+
+    // SOGI state
+    float v_alpha, v_beta;
+    float v1, v2;           // Input history
+    float va2, vb2;         // Output history (n-2)
+
+    // PLL state
+    float theta;            // Phase (rad, 0..2*pi)
+    float w;                // Estimated frequency (rad/s)
+    float integrator;       // PI integral term (rad/s)
+
+    // Outputs
+    float amplitude;        // Input peak estimate (V)
+    float error_filt;       // Low-pass filtered phase error (rad)
+    uint32_t lock_count;
+    uint32_t lock_samples;
+    bool locked;
+} sogi_pll_t;
+
+/* Fixed-point variant */
+typedef struct {
+    // Configuration
+    uint32_t step_nom;      // Nominal phase step per sample
+    uint32_t step_min, step_max;
+    int32_t k_q12;          // SOGI gain, Q12
+    int32_t kp_q16;         // PI gains scaled to phase step units
+    int32_t ki_q32;
+    int32_t lock_threshold; // Q24
+    int32_t v_min;          // Amplitude floor for lock, Q24
+
+    // SOGI state, Q24 per-unit
+    int32_t v_alpha, v_beta;
+    int32_t v1, v2;
+    int32_t va2, vb2;
+
+    // PLL state
+    uint32_t phase;         // Phase accumulator, 2^32 = 2*pi
+    uint32_t step;          // Phase step per sample (frequency)
+    int64_t integrator;     // PI integral term, Q32 phase step units
+    int32_t error_filt;     // Q24
+
+    uint32_t lock_count;
+    uint32_t lock_samples;
+    float sample_freq;
+    bool locked;
+} sogi_pll_q_t;
+
+/* Functions (float) */
+int sogi_pll_init(sogi_pll_t *pll, float sample_freq_hz, float nominal_freq_hz, float nominal_peak);
+void sogi_pll_reset(sogi_pll_t *pll);
+void sogi_pll_set_gains(sogi_pll_t *pll, float k, float kp, float ki);
+float sogi_pll_update(sogi_pll_t *pll, float v);
+float sogi_pll_get_frequency(const sogi_pll_t *pll);
+uint32_t sogi_pll_get_phase_u32(const sogi_pll_t *pll);
+bool sogi_pll_is_locked(const sogi_pll_t *pll);
+
+/* Functions (fixed point) */
+int sogi_pll_q_init(sogi_pll_q_t *pll, float sample_freq_hz, float nominal_freq_hz);
+void sogi_pll_q_reset(sogi_pll_q_t *pll);
+uint32_t sogi_pll_q_update(sogi_pll_q_t *pll, int16_t v_pu);
+int16_t sogi_pll_q_sin(uint32_t phase);
+float sogi_pll_q_get_frequency(const sogi_pll_q_t *pll);
+bool sogi_pll_q_is_locked(const sogi_pll_q_t *pll);
+
+#endif // SOGI_PLL_H
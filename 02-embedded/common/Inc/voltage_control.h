@@ -0,0 +1,114 @@
+/**
+ * @file voltage_control.h
+ * @brief Cascaded output voltage control: RMS PI over the PR current loop
+ *
+ * Two loops at two rates:
+ *
+ *   outer (once per output cycle):
+ *     Vrms, Irms measured over the last cycle
+ *     Y     = sqrt(2) * Irms / Vrms           (load admittance, A peak per V RMS)
+ *     I_amp = PI(Y * (Vrms_ref - Vrms)),      0 .. i_amp_max
+ *
+ *   inner (every PWM period):
+ *     i_ref = I_amp * sin(theta)
+ *     v_ref = PR(i_ref - i_meas) / v_base,    -1 .. +1
+ *
+ * theta is the modulator phase, so the current reference follows
+ * modulation_set_frequency() / modulation_sync(). The output voltage
+ * reference goes to modulation_calculate_duties_ref(). The cycle ends at
+ * the positive zero crossing of theta, where the new amplitude steps in
+ * at zero current reference.
+ *
+ * With the inner loop closed the load sees a current source, so a load
+ * step moves Vrms by the full impedance ratio in the first cycle and the
+ * outer loop gain is proportional to the load impedance. Scaling the
+ * error by the measured admittance makes the PI gains per unit:
+ * kp + ki*Ts = 1 would correct a load step in one cycle at any load, from
+ * no load (the filter capacitor, VC_ADMITTANCE_MIN) to full load.
+ *
+ * Anti-windup is back-calculation in both loops: the PI integrator is
+ * fed ki*e + kt*(u_clamped - u), the PR resonant input e + Kt*(excess)
+ * (pr_controller_set_antiwindup). While the PR is clamped the outer
+ * limit drops to the current amplitude actually reached, so a DC bus too
+ * low for the requested voltage does not wind up the PI through the
+ * inner loop either. The loops recover without overshoot when it clears.
+ *
+ * Bumpless transfer:
+ * - PI integrator in output units (A), so ki changes do not step the
+ *   output, and kp changes move kp*e into the integrator
+ * - PR resonant states hold the output (see pr_controller.h)
+ * - voltage_control_engage() takes over from an open-loop reference:
+ *   the PR is preset to the running voltage and the PI to the measured
+ *   current amplitude
+ *
+ * The defaults are for the power stage output filter (500 uH + 10 uF)
+ * with 2 x 50 V buses and a resistive load of 25-100 ohm.
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-26
+ */
+
+#ifndef VOLTAGE_CONTROL_H
+#define VOLTAGE_CONTROL_H
+
+#include "pr_controller.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Default tuning */
+#define VC_V_RMS_DEFAULT        50.0f    // Output voltage reference (V RMS)
+#define VC_KP_V_DEFAULT         0.4f     // Per unit
+#define VC_KI_V_DEFAULT         25.0f    // Per unit per second (0.5 per cycle)
+#define VC_KP_I_DEFAULT         2.0f     // V per A
+#define VC_KR_I_DEFAULT         1000.0f  // V per A (resonant)
+#define VC_I_AMP_MAX_DEFAULT    8.0f     // Current reference limit (A peak)
+#define VC_ADMITTANCE_MIN       0.003f   // A/V, 10 uF at 50 Hz (no load)
+
+/* PI with back-calculation anti-windup */
+typedef struct {
+    float kp, ki;           // Gains (output per error, per error-second)
+    float kt;               // Back-calculation gain (1/s)
+    float ts;               // Update period (s)
+    float integral;         // Integrator, output units
+    float error;            // Last error
+    float output;           // Last clamped output
+    float out_min, out_max;
+} vc_pi_t;
+
+/* Cascaded controller */
+typedef struct {
+    vc_pi_t pi;             // Outer: scaled Vrms error (A) -> current amplitude (A)
+    pr_controller_t pr;     // Inner: current error -> voltage (per unit of v_base)
+    float v_base;           // Output voltage at reference 1.0 (2 * Vdc)
+    float kp_i, kr_i;       // Inner gains in V/A
+
+    float v_rms_ref;        // Voltage reference (V RMS)
+    float v_rms;            // Measured over the last cycle (V RMS)
+    float i_rms;            // Measured over the last cycle (A RMS)
+    float admittance;       // Load admittance (A peak per V RMS)
+    float i_amp;            // Current amplitude reference (A)
+    float i_ref;            // Last current reference (A)
+    float v_ref;            // Last voltage reference (per unit)
+
+    // Cycle accumulation
+    float sum_v2, sum_i2;
+    uint16_t samples;
+    uint32_t last_phase;
+    uint32_t cycles;
+    bool inner_saturated;   // PR output clamped during this cycle
+
+    bool active;            // Loops drive the output (false: measure only)
+    bool initialized;
+} voltage_control_t;
+
+/* Functions */
+int voltage_control_init(voltage_control_t *vc, float v_base, float v_rms_ref);
+void voltage_control_reset(voltage_control_t *vc);
+void voltage_control_set_reference(voltage_control_t *vc, float v_rms);
+void voltage_control_set_gains(voltage_control_t *vc, float kp_v, float ki_v, float kp_i, float kr_i);
+void voltage_control_set_current_limit(voltage_control_t *vc, float i_amp_max);
+void voltage_control_set_antiwindup(voltage_control_t *vc, bool enable);
+void voltage_control_engage(voltage_control_t *vc, float v_amplitude, uint32_t phase);
+float voltage_control_update(voltage_control_t *vc, float v_meas, float i_meas, uint32_t phase);
+
+#endif // VOLTAGE_CONTROL_H
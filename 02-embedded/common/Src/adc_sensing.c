@@ -1,6 +1,9 @@
 /**
  * @file adc_sensing.c
  * @brief ADC sensing implementation
+ *
+ * The DMA callbacks only add up 12-bit samples (ADC_OVERSAMPLE scans per
+ * half buffer, 32-bit sums); the float scaling runs once per output.
  */
 
 #include "adc_sensing.h"
@@ -42,6 +45,7 @@ int adc_sensor_init(adc_sensor_t *sensor, ADC_HandleTypeDef *hadc, DMA_HandleTyp
     sensor->hdma = hdma;
     sensor->current_cal = 1.0f;
     sensor->voltage_cal = 1.0f;
+    sensor->lsb_volts = ADC_VREF / ((float)ADC_RESOLUTION * (float)ADC_OVERSAMPLE);
     sensor->initialized = true;
     sensor->data.valid = false;
 
@@ -54,8 +58,10 @@ int adc_sensor_start(adc_sensor_t *sensor)
         return -1;
     }
 
-    // Start ADC with DMA
-    if (HAL_ADC_Start_DMA(sensor->hadc, (uint32_t*)sensor->adc_buffer, ADC_CHANNELS) != HAL_OK) {
+    sensor->next_half = 0;
+
+    // Start ADC with circular DMA over both halves
+    if (HAL_ADC_Start_DMA(sensor->hadc, (uint32_t*)sensor->adc_buffer, ADC_DMA_BUFFER_LEN) != HAL_OK) {
         return -2;
     }
 
@@ -74,16 +80,22 @@ int adc_sensor_stop(adc_sensor_t *sensor)
     return 0;
 }
 
+/**
+ * @brief Convert the last block sums to engineering units
+ *
+ * Called from the DMA callbacks after every half buffer; can also be
+ * called to re-apply a new calibration to the last block.
+ */
 void adc_sensor_update(adc_sensor_t *sensor)
 {
     if (sensor == NULL || !sensor->initialized) {
         return;
     }
 
-    // Convert ADC buffer to voltages
+    // Convert block sums to average voltages (one float op per channel)
     float adc_voltages[ADC_CHANNELS];
     for (int i = 0; i < ADC_CHANNELS; i++) {
-        adc_voltages[i] = adc_to_voltage(sensor->adc_buffer[i]);
+        adc_voltages[i] = (float)sensor->block_sum[i] * sensor->lsb_volts;
     }
 
     // Channel 0: Output current
@@ -97,11 +109,70 @@ void adc_sensor_update(adc_sensor_t *sensor)
 
     // Channel 3: DC bus 2
     sensor->data.dc_bus2_voltage = voltage_to_bus_voltage(adc_voltages[3]);
+}
+
+/**
+ * @brief Sum one half of the DMA buffer and publish a new output
+ *
+ * @param half 0 = first half (half-transfer), 1 = second half (complete)
+ */
+static void adc_sensor_process_half(adc_sensor_t *sensor, uint8_t half)
+{
+    if (sensor == NULL || !sensor->initialized) {
+        return;
+    }
+
+    // Half/full callbacks must alternate; anything else lost a block
+    if (half != sensor->next_half) {
+        sensor->sequence_errors++;
+    }
+    sensor->next_half = half ^ 1U;
+
+    const uint16_t *scan = &sensor->adc_buffer[half * ADC_DMA_HALF_LEN];
+    uint32_t sum[ADC_CHANNELS] = {0};
+
+    for (int n = 0; n < ADC_OVERSAMPLE; n++) {
+        for (int i = 0; i < ADC_CHANNELS; i++) {
+            sum[i] += scan[i];
+        }
+        scan += ADC_CHANNELS;
+    }
+
+    for (int i = 0; i < ADC_CHANNELS; i++) {
+        sensor->block_sum[i] = sum[i];
+    }
+
+    adc_sensor_update(sensor);
 
     sensor->data.sample_count++;
     sensor->data.valid = true;
 }
 
+/**
+ * @brief Call from HAL_ADC_ConvHalfCpltCallback (first half filled)
+ */
+void adc_sensor_dma_half_complete(adc_sensor_t *sensor)
+{
+    adc_sensor_process_half(sensor, 0);
+}
+
+/**
+ * @brief Call from HAL_ADC_ConvCpltCallback (second half filled)
+ */
+void adc_sensor_dma_complete(adc_sensor_t *sensor)
+{
+    adc_sensor_process_half(sensor, 1);
+}
+
+uint32_t adc_sensor_get_sequence_errors(const adc_sensor_t *sensor)
+{
+    if (sensor == NULL) {
+        return 0;
+    }
+
+    return sensor->sequence_errors;
+}
+
 const sensor_data_t* adc_sensor_get_data(const adc_sensor_t *sensor)
 {
     if (sensor == NULL || !sensor->initialized) {
@@ -56,6 +56,27 @@ void logger_log_status(data_logger_t *logger, const sensor_data_t *sensor, const
     HAL_UART_Transmit(logger->huart, (uint8_t*)logger->buffer, strlen(logger->buffer), 100);
 }
 
+void logger_log_metrics(data_logger_t *logger, const power_metrics_data_t *metrics)
+{
+    if (logger == NULL || !logger->enabled) return;
+    if (logger->mode != LOG_MODE_STATUS || metrics == NULL || !metrics->valid) return;
+
+    snprintf(logger->buffer, LOG_BUFFER_SIZE,
+             "Vrms=%.1fV, Irms=%.2fA, P=%.1fW, S=%.1fVA, PF=%.3f, "
+             "THDv=%.2f%%, THDi=%.2f%%, DC1pp=%.2fV, DC2pp=%.2fV\r\n",
+             metrics->v_rms,
+             metrics->i_rms,
+             metrics->p_real,
+             metrics->s_apparent,
+             metrics->power_factor,
+             metrics->v_thd * 100.0f,
+             metrics->i_thd * 100.0f,
+             metrics->dc1_ripple,
+             metrics->dc2_ripple);
+
+    HAL_UART_Transmit(logger->huart, (uint8_t*)logger->buffer, strlen(logger->buffer), 100);
+}
+
 void logger_log_waveform(data_logger_t *logger, float current, float voltage, uint16_t duty1, uint16_t duty2)
 {
     if (logger == NULL || !logger->enabled) return;
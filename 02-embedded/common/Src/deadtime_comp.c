@@ -0,0 +1,108 @@
+/**
+ * @file deadtime_comp.c
+ * @brief Dead-time compensation implementation
+ */
+
+#include "deadtime_comp.h"
+#include <string.h>
+
+int deadtime_comp_init(deadtime_comp_t *dtc, uint16_t dt1_counts, uint16_t dt2_counts, float band)
+{
+    if (dtc == NULL || band < 0.0f ||
+        dt1_counts > PWM_PERIOD / 2 || dt2_counts > PWM_PERIOD / 2) {
+        return -1;
+    }
+
+    memset(dtc, 0, sizeof(deadtime_comp_t));
+
+    dtc->dt_counts[0] = dt1_counts;
+    dtc->dt_counts[1] = dt2_counts;
+    dtc->band = band;
+    dtc->lead = DEADTIME_COMP_LEAD_DEFAULT;
+    dtc->enabled = true;
+
+    return 0;
+}
+
+void deadtime_comp_reset(deadtime_comp_t *dtc)
+{
+    if (dtc == NULL) return;
+
+    dtc->i_last = 0.0f;
+    dtc->slope = 0.0f;
+    dtc->gain = 0.0f;
+}
+
+void deadtime_comp_enable(deadtime_comp_t *dtc, bool enable)
+{
+    if (dtc == NULL) return;
+
+    dtc->enabled = enable;
+}
+
+void deadtime_comp_set_lead(deadtime_comp_t *dtc, float periods)
+{
+    if (dtc == NULL || periods < 0.0f) return;
+
+    dtc->lead = periods;
+}
+
+/**
+ * @brief Shift one leg's compare by delta if the leg switches this period
+ */
+static uint16_t leg_compensate(uint16_t ccr, int32_t delta)
+{
+    // Held low (0) or high (> ARR): no edges, no dead time
+    if (ccr == 0 || ccr > PWM_PERIOD) {
+        return ccr;
+    }
+
+    int32_t c = (int32_t)ccr + delta;
+    if (c < 0) c = 0;
+    if (c > PWM_PERIOD + 1) c = PWM_PERIOD + 1;
+
+    return (uint16_t)c;
+}
+
+/**
+ * @brief Correct the modulator duties for the dead time
+ *
+ * Call once per PWM period, also while disabled, so the slope estimate
+ * stays current.
+ *
+ * @param duties Duties from modulation_calculate_duties(), modified in place
+ * @param i_out  Measured output current (A), positive out of leg A
+ */
+void deadtime_comp_apply(deadtime_comp_t *dtc, inverter_duty_t *duties, float i_out)
+{
+    if (dtc == NULL || duties == NULL) return;
+
+    // Current when these duties are applied
+    dtc->slope += DEADTIME_COMP_SLOPE_ALPHA * ((i_out - dtc->i_last) - dtc->slope);
+    dtc->i_last = i_out;
+    float i_pred = i_out + dtc->lead * dtc->slope;
+
+    if (!dtc->enabled) return;
+
+    // Polarity weight, linear through the zero-crossing band
+    float s;
+    if (dtc->band > 0.0f) {
+        s = i_pred / dtc->band;
+        if (s > 1.0f) s = 1.0f;
+        if (s < -1.0f) s = -1.0f;
+    } else {
+        s = (i_pred > 0.0f) ? 1.0f : ((i_pred < 0.0f) ? -1.0f : 0.0f);
+    }
+    dtc->gain = s;
+
+    hbridge_duty_t *bridge[2] = { &duties->hbridge1, &duties->hbridge2 };
+
+    for (int b = 0; b < 2; b++) {
+        float d = (float)dtc->dt_counts[b] * s;
+        int32_t delta = (int32_t)(d + ((d >= 0.0f) ? 0.5f : -0.5f));
+
+        // Leg A sources the current, leg B sinks it
+        bridge[b]->ch1 = leg_compensate(bridge[b]->ch1, delta);
+        bridge[b]->ch2 = leg_compensate(bridge[b]->ch2, -delta);
+    }
+}
@@ -0,0 +1,114 @@
+/**
+ * @file fcs_mpc.c
+ * @brief FCS-MPC implementation
+ */
+
+#include "fcs_mpc.h"
+#include <math.h>
+#include <string.h>
+
+/* Bridge levels (A - B) for every gate word */
+static const int8_t bridge1_level[FCS_MPC_STATES] = {
+    0, 1, -1, 0,  0, 1, -1, 0,  0, 1, -1, 0,  0, 1, -1, 0
+};
+static const int8_t bridge2_level[FCS_MPC_STATES] = {
+    0, 0, 0, 0,  1, 1, 1, 1,  -1, -1, -1, -1,  0, 0, 0, 0
+};
+
+/* Number of set bits: leg transitions between two gate words */
+static const uint8_t popcount4[FCS_MPC_STATES] = {
+    0, 1, 1, 2,  1, 2, 2, 3,  1, 2, 2, 3,  2, 3, 3, 4
+};
+
+int fcs_mpc_init(fcs_mpc_t *mpc, float r, float l, float sample_freq_hz)
+{
+    if (mpc == NULL || r <= 0.0f || l <= 0.0f || sample_freq_hz <= 0.0f) {
+        return -1;
+    }
+
+    memset(mpc, 0, sizeof(fcs_mpc_t));
+
+    float ts = 1.0f / sample_freq_hz;
+    mpc->a = expf(-r * ts / l);
+    mpc->b = (1.0f - mpc->a) / r;
+    mpc->lambda = FCS_MPC_LAMBDA_DEFAULT;
+
+    fcs_mpc_reset(mpc);
+    mpc->initialized = true;
+
+    return 0;
+}
+
+void fcs_mpc_reset(fcs_mpc_t *mpc)
+{
+    if (mpc == NULL) return;
+
+    mpc->gates = 0;         // All low-side on: zero output
+    mpc->i_pred = 0.0f;
+    mpc->cost = 0.0f;
+    mpc->transitions = 0;
+    mpc->sample_count = 0;
+}
+
+void fcs_mpc_set_lambda(fcs_mpc_t *mpc, float lambda)
+{
+    if (mpc == NULL || lambda < 0.0f) return;
+
+    mpc->lambda = lambda;
+}
+
+/**
+ * @brief Choose the gate word for the next period
+ *
+ * @param i_ref  Current reference at the end of the next period (k+2)
+ * @param i_meas Current sampled at k
+ * @param vdc1   DC link of H-bridge 1 (V)
+ * @param vdc2   DC link of H-bridge 2 (V)
+ * @return Gate word to latch for the next period
+ */
+uint8_t fcs_mpc_update(fcs_mpc_t *mpc, float i_ref, float i_meas, float vdc1, float vdc2)
+{
+    if (mpc == NULL || !mpc->initialized) return 0;
+
+    uint8_t prev = mpc->gates;
+
+    // Delay compensation: state latched last time is active until k+1
+    float v_now = bridge1_level[prev] * vdc1 + bridge2_level[prev] * vdc2;
+    float i1 = mpc->a * i_meas + mpc->b * v_now;
+    mpc->i_pred = i1;
+
+    // J_j = (d - b*v_j)^2 + lambda * n_j, with d = i_ref - a*i[k+1]
+    float d = i_ref - mpc->a * i1;
+    float bv1 = mpc->b * vdc1;
+    float bv2 = mpc->b * vdc2;
+
+    float best_cost = INFINITY;
+    uint32_t best = prev;
+    for (uint32_t j = 0; j < FCS_MPC_STATES; j++) {
+        float e = d - (bridge1_level[j] * bv1 + bridge2_level[j] * bv2);
+        float cost = e * e + mpc->lambda * popcount4[prev ^ j];
+        bool better = cost < best_cost;
+        best_cost = better ? cost : best_cost;
+        best = better ? j : best;
+    }
+
+    mpc->gates = (uint8_t)best;
+    mpc->cost = best_cost;
+    mpc->transitions += popcount4[prev ^ best];
+    mpc->sample_count++;
+
+    return mpc->gates;
+}
+
+/**
+ * @brief Output level of a gate word
+ *
+ * @return Level in units of Vdc (-2..+2); per-bridge levels if pointers given
+ */
+int8_t fcs_mpc_level(uint8_t gates, int8_t *bridge1, int8_t *bridge2)
+{
+    gates &= FCS_MPC_STATES - 1;
+    if (bridge1 != NULL) *bridge1 = bridge1_level[gates];
+    if (bridge2 != NULL) *bridge2 = bridge2_level[gates];
+    return (int8_t)(bridge1_level[gates] + bridge2_level[gates]);
+}
@@ -0,0 +1,491 @@
+/**
+ * @file inverter_app.c
+ * @brief Inverter application: test modes, control interrupt, status loop
+ *
+ * Board independent; the selections are in app_config.h, the peripherals
+ * come from the board's main.c through inverter_app_init().
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+#include "inverter_app.h"
+#include "main.h"
+#include "app_config.h"
+#include "inverter_config.h"
+#include "pwm_control.h"
+#include "multilevel_modulation.h"
+#include "safety.h"
+#include "debug_uart.h"
+#include "adc_sensing.h"
+#include "data_logger.h"
+#include "soft_start.h"
+#include "pr_controller.h"
+#include "power_metrics.h"
+#include "sogi_pll.h"
+#include "fcs_mpc.h"
+#include "deadtime_comp.h"
+#include "voltage_control.h"
+#include <math.h>
+#include <stdio.h>
+
+/* Board peripherals */
+static inverter_board_t board;
+
+/* Application objects */
+pwm_controller_t pwm_ctrl;
+modulation_t modulator;
+safety_monitor_t safety;
+adc_sensor_t adc_sensor;
+data_logger_t logger;
+soft_start_t soft_start;
+pr_controller_t pr_ctrl;
+power_metrics_t metrics;
+sogi_pll_t pll;
+sogi_pll_q_t pll_q;
+fcs_mpc_t mpc;
+deadtime_comp_t dt_comp;
+voltage_control_t v_ctrl;
+
+/* Statistics */
+volatile uint32_t update_count = 0;
+volatile uint32_t fault_count = 0;
+
+/* Status loop timing */
+static uint32_t last_print = 0;
+static uint32_t last_log = 0;
+
+static void apply_test_mode(void);
+
+void inverter_app_init(const inverter_board_t *b)
+{
+    board = *b;
+
+    /* Initialize application modules */
+    if (pwm_init(&pwm_ctrl, board.htim1, board.htim8) != 0) {
+        debug_print("ERROR: PWM init failed\r\n");
+        Error_Handler();
+    }
+
+    if (modulation_init(&modulator) != 0 ||
+        modulation_set_shape(&modulator, REFERENCE_SHAPE, MODULATION_THI_K_DEFAULT) != 0) {
+        debug_print("ERROR: Modulation init failed\r\n");
+        Error_Handler();
+    }
+
+    if (safety_init(&safety, board.hadc) != 0) {
+        debug_print("ERROR: Safety init failed\r\n");
+        Error_Handler();
+    }
+
+    if (debug_uart_init(board.huart) != 0) {
+        debug_print("ERROR: UART init failed\r\n");
+        Error_Handler();
+    }
+
+    /* Initialize new modules */
+    if (adc_sensor_init(&adc_sensor, board.hadc, board.hdma_adc) != 0) {
+        debug_print("ERROR: ADC sensor init failed\r\n");
+        Error_Handler();
+    }
+
+    if (logger_init(&logger, board.huart) != 0) {
+        debug_print("ERROR: Logger init failed\r\n");
+        Error_Handler();
+    }
+
+    soft_start_init(&soft_start, SOFT_START_RAMP_TIME_MS);
+
+    pr_controller_init(&pr_ctrl, PR_KP_DEFAULT, PR_KR_DEFAULT, PR_WC_DEFAULT);
+    pr_controller_set_limits(&pr_ctrl, 0.0f, modulation_get_max_index(&modulator));  // MI limits
+
+    sogi_pll_init(&pll, PR_SAMPLE_FREQ, PR_FUNDAMENTAL_FREQ, GRID_NOMINAL_PEAK_V);
+    sogi_pll_q_init(&pll_q, PR_SAMPLE_FREQ, PR_FUNDAMENTAL_FREQ);
+
+    fcs_mpc_init(&mpc, FCS_MPC_R_DEFAULT, FCS_MPC_L_DEFAULT, FCS_MPC_SAMPLE_FREQ_HZ);
+
+    deadtime_comp_init(&dt_comp, DEAD_TIME_COUNTS, DEAD_TIME_COUNTS, DEADTIME_COMP_BAND_DEFAULT);
+    deadtime_comp_enable(&dt_comp, DEADTIME_COMPENSATION);
+
+    voltage_control_init(&v_ctrl, 2.0f * DC_BUS_NOMINAL_V, VC_V_RMS_DEFAULT);
+
+    /* Startup message */
+    debug_print("\r\n");
+    debug_print("=====================================\r\n");
+    debug_print("  5-Level Cascaded H-Bridge Inverter\r\n");
+    debug_print("  " BOARD_NAME " Implementation\r\n");
+    debug_print("  With ADC, Logging, Soft-Start, PR\r\n");
+    debug_print("=====================================\r\n");
+    debug_printf("Test Mode: %d\r\n", TEST_MODE);
+    debug_print("System initialized. Starting PWM...\r\n\r\n");
+
+    /* Apply test mode configuration */
+    apply_test_mode();
+
+    /* Power metrics over one output cycle, fed from the PWM interrupt */
+    float control_freq = (TEST_MODE == 6) ? (float)FCS_MPC_SAMPLE_FREQ_HZ : PR_SAMPLE_FREQ;
+    if (power_metrics_init(&metrics, control_freq, modulator.frequency_hz) != 0) {
+        debug_print("WARNING: Power metrics disabled\r\n");
+    }
+}
+
+void inverter_app_start(void)
+{
+    /* Start ADC with DMA */
+    if (adc_sensor_start(&adc_sensor) != 0) {
+        debug_print("ERROR: ADC start failed\r\n");
+        Error_Handler();
+    }
+
+    /* Carrier arrangement; pwm_start() presets TIM8 to the shift */
+    modulation_set_mode(&modulator, MODULATION_MODE);
+    if (pwm_set_carrier_shift(&pwm_ctrl, modulation_carrier_shift(&modulator)) != 0) {
+        debug_print("ERROR: Carrier shift failed\r\n");
+        Error_Handler();
+    }
+
+    /* Start PWM generation */
+    if (pwm_start(&pwm_ctrl) != 0) {
+        debug_print("ERROR: PWM start failed\r\n");
+        Error_Handler();
+    }
+
+    /* Start soft-start sequence if modulation is enabled */
+    if (modulator.enabled && TEST_MODE != 0) {
+        soft_start_begin(&soft_start, modulator.modulation_index);
+        debug_printf("Soft-start: Ramping to MI=%.2f over %lu ms\r\n\r\n",
+                    modulator.modulation_index, SOFT_START_RAMP_TIME_MS);
+    }
+
+    /* Enable data logging (default: STATUS mode) */
+    logger_set_mode(&logger, LOG_MODE_STATUS);
+    logger_enable(&logger, true);
+
+    debug_print("All systems started. Running...\r\n\r\n");
+}
+
+void inverter_app_loop(void)
+{
+    /* Update soft-start (must be called regularly) */
+    soft_start_update(&soft_start);
+
+    /* ADC sensor data (refreshed by the DMA callbacks) */
+    const sensor_data_t *sensor = adc_sensor_get_data(&adc_sensor);
+
+    /* Safety monitoring with real sensor values */
+    safety_update(&safety, sensor->output_current, sensor->dc_bus1_voltage);
+
+    /* Log status every 1 second */
+    if ((HAL_GetTick() - last_log) >= 1000) {
+        last_log = HAL_GetTick();
+        logger_log_status(&logger, sensor, &modulator);
+        logger_log_metrics(&logger, power_metrics_get(&metrics));
+    }
+
+    /* Print debug status every 1 second */
+    if ((HAL_GetTick() - last_print) >= 1000) {
+        last_print = HAL_GetTick();
+
+        debug_printf("Updates: %lu, Faults: %lu, MI: %.2f, Freq: %.1f Hz\r\n",
+                    update_count, fault_count,
+                    modulator.modulation_index, modulator.frequency_hz);
+
+        debug_printf("I=%.2fA, V=%.1fV, DC1=%.1fV, DC2=%.1fV\r\n",
+                    sensor->output_current,
+                    sensor->output_voltage,
+                    sensor->dc_bus1_voltage,
+                    sensor->dc_bus2_voltage);
+
+        /* Cycle metrics (valid after the first full output cycle) */
+        const power_metrics_data_t *pm = power_metrics_get(&metrics);
+        if (pm != NULL && pm->valid) {
+            debug_printf("Vrms=%.1fV, Irms=%.2fA, P=%.1fW, PF=%.3f, THDv=%.2f%%, THDi=%.2f%%\r\n",
+                        pm->v_rms, pm->i_rms, pm->p_real, pm->power_factor,
+                        pm->v_thd * 100.0f, pm->i_thd * 100.0f);
+        }
+
+        /* Grid synchronization */
+        if (TEST_MODE == 5) {
+#if SOGI_PLL_FIXED_POINT
+            debug_printf("PLL: %.2f Hz, %s\r\n", sogi_pll_q_get_frequency(&pll_q),
+                        sogi_pll_q_is_locked(&pll_q) ? "locked" : "searching");
+#else
+            debug_printf("PLL: %.2f Hz, %.1f Vpk, %s\r\n", sogi_pll_get_frequency(&pll),
+                        pll.amplitude, sogi_pll_is_locked(&pll) ? "locked" : "searching");
+#endif
+        }
+
+        /* Voltage loop */
+        if (TEST_MODE == 7) {
+            debug_printf("Vloop: %.1f/%.1f Vrms, Iamp=%.2fA, %s\r\n",
+                        v_ctrl.v_rms, v_ctrl.v_rms_ref, v_ctrl.i_amp,
+                        v_ctrl.active ? "closed" : "open");
+        }
+
+        /* Check for faults */
+        if (safety_is_fault(&safety)) {
+            debug_printf("FAULT: 0x%02lX\r\n", safety_get_faults(&safety));
+        }
+
+        /* Soft-start status */
+        if (!soft_start_is_complete(&soft_start)) {
+            debug_printf("Soft-start: %.1f%%\r\n",
+                        (soft_start_get_mi(&soft_start) / modulator.modulation_index) * 100.0f);
+        }
+    }
+
+    /* Small delay */
+    HAL_Delay(10);
+}
+
+static void apply_test_mode(void)
+{
+    switch (TEST_MODE) {
+        case 0:  // PWM Test - 50% duty
+            debug_print("Mode 0: PWM Test (50% duty cycle)\r\n");
+            modulator.enabled = false;
+            pwm_test_50_percent(&pwm_ctrl);
+            break;
+
+        case 1:  // Low frequency test - 5 Hz
+            debug_print("Mode 1: Low Frequency Test (5 Hz, 50% MI)\r\n");
+            modulator.enabled = true;
+            modulation_set_index(&modulator, 0.5f);
+            modulation_set_frequency(&modulator, 5.0f);
+            break;
+
+        case 2:  // Normal operation - 50 Hz, 80% MI
+            debug_print("Mode 2: Normal Operation (50 Hz, 80% MI)\r\n");
+            modulator.enabled = true;
+            modulation_set_index(&modulator, 0.8f);
+            modulation_set_frequency(&modulator, 50.0f);
+            break;
+
+        case 3:  // Full power - 50 Hz, 100% MI
+            debug_print("Mode 3: Full Power (50 Hz, 100% MI)\r\n");
+            modulator.enabled = true;
+            modulation_set_index(&modulator, 1.0f);
+            modulation_set_frequency(&modulator, 50.0f);
+            break;
+
+        case 4:  // Closed-loop current control with PR controller
+            debug_print("Mode 4: Closed-Loop Current Control (PR Controller)\r\n");
+            debug_print("        Target: 5A sine @ 50Hz\r\n");
+            modulator.enabled = true;
+            modulation_set_frequency(&modulator, 50.0f);
+            modulation_set_index(&modulator, 0.5f);  // Initial MI
+            // PR controller will adjust MI to track current reference
+            pr_controller_reset(&pr_ctrl);
+            break;
+
+        case 5:  // Grid-synchronized current control
+            debug_print("Mode 5: Grid-Synchronized Current Control (SOGI-PLL + PR)\r\n");
+            debug_print("        Target: 5A in phase with the output voltage\r\n");
+            modulator.enabled = true;
+            modulation_set_frequency(&modulator, PR_FUNDAMENTAL_FREQ);
+            modulation_set_index(&modulator, 0.5f);  // Initial MI
+            // PR acts once the PLL reports lock
+            pr_controller_reset(&pr_ctrl);
+            sogi_pll_reset(&pll);
+            sogi_pll_q_reset(&pll_q);
+            break;
+
+        case 6:  // FCS-MPC current control
+            debug_print("Mode 6: FCS-MPC Current Control (20 kHz)\r\n");
+            debug_print("        Target: 5A sine @ 50Hz, gates chosen directly\r\n");
+            // Soft-start ramps the current amplitude through the modulation index
+            modulator.enabled = true;
+            modulation_set_frequency(&modulator, 50.0f);
+            modulation_set_index(&modulator, 1.0f);
+            fcs_mpc_reset(&mpc);
+            // Update interrupt at the MPC rate; PWM compare is only 0 or 100%
+            __HAL_TIM_SET_AUTORELOAD(board.htim1, (PWM_TIMER_CLOCK_HZ / FCS_MPC_SAMPLE_FREQ_HZ) - 1);
+            __HAL_TIM_SET_AUTORELOAD(board.htim8, (PWM_TIMER_CLOCK_HZ / FCS_MPC_SAMPLE_FREQ_HZ) - 1);
+            break;
+
+        case 7:  // Cascaded output voltage control
+            debug_print("Mode 7: Output Voltage Control (RMS PI + PR current)\r\n");
+            debug_printf("        Target: %.0f V RMS @ 50Hz\r\n", VC_V_RMS_DEFAULT);
+            modulator.enabled = true;
+            modulation_set_frequency(&modulator, 50.0f);
+            modulation_set_index(&modulator, 0.7f);  // Open loop during soft-start
+            // Loops take over when the soft-start ramp completes
+            voltage_control_reset(&v_ctrl);
+            break;
+
+        default:
+            debug_print("Invalid test mode, using Mode 1\r\n");
+            modulator.enabled = true;
+            modulation_set_index(&modulator, 0.5f);
+            modulation_set_frequency(&modulator, 5.0f);
+            break;
+    }
+}
+
+/**
+ * @brief Timer update interrupt callback
+ * Called at PWM frequency (5 kHz)
+ */
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM1) {
+        inverter_duty_t duties;
+
+        /* Check safety */
+        if (!safety_check(&safety)) {
+            pwm_emergency_stop(&pwm_ctrl);
+            fault_count++;
+            return;
+        }
+
+        /* Apply soft-start modulation index */
+        if (!soft_start_is_complete(&soft_start)) {
+            float soft_mi = soft_start_get_mi(&soft_start);
+            modulation_set_index(&modulator, soft_mi);
+        }
+
+        /* Mode 6: FCS-MPC picks the gate state, no modulator */
+        if (TEST_MODE == 6) {
+            const sensor_data_t *sensor = adc_sensor_get_data(&adc_sensor);
+
+            // Reference two periods ahead (decision latches at the next update)
+            uint32_t n = (update_count + 2) % (FCS_MPC_SAMPLE_FREQ_HZ / 50);
+            float theta = 2.0f * 3.14159265359f * 50.0f * (float)n / FCS_MPC_SAMPLE_FREQ_HZ;
+            float current_ref = 5.0f * modulator.modulation_index * sinf(theta);
+
+            uint8_t gates = fcs_mpc_update(&mpc, current_ref, sensor->output_current,
+                                           sensor->dc_bus1_voltage, sensor->dc_bus2_voltage);
+            pwm_set_gates(&pwm_ctrl, gates);
+
+            power_metrics_update(&metrics,
+                                 sensor->output_voltage,
+                                 sensor->output_current,
+                                 sensor->dc_bus1_voltage,
+                                 sensor->dc_bus2_voltage);
+
+            update_count++;
+            return;
+        }
+
+#if DC_BUS_FEEDFORWARD
+        /* DC-link feed-forward: bus reciprocals once per sample */
+        const sensor_data_t *dc = adc_sensor_get_data(&adc_sensor);
+        modulation_set_dc_bus(&modulator, dc->dc_bus1_voltage, dc->dc_bus2_voltage);
+#endif
+
+        /* Mode 4: Closed-loop current control with PR controller */
+        if (TEST_MODE == 4 && soft_start_is_complete(&soft_start)) {
+            // Generate sine reference current (5A amplitude @ 50Hz)
+            float time = (float)update_count / PR_SAMPLE_FREQ;
+            float current_ref = 5.0f * sinf(2.0f * 3.14159265359f * 50.0f * time);
+
+            // Get measured current from ADC
+            const sensor_data_t *sensor = adc_sensor_get_data(&adc_sensor);
+            float current_meas = sensor->output_current;
+
+            // Update PR controller to get new MI
+            float new_mi = pr_controller_update(&pr_ctrl, current_ref, current_meas);
+            modulation_set_index(&modulator, new_mi);
+        }
+
+        /* Mode 5: Grid-synchronized current control (PLL phase drives the sine reference) */
+        if (TEST_MODE == 5) {
+            const sensor_data_t *sensor = adc_sensor_get_data(&adc_sensor);
+#if SOGI_PLL_FIXED_POINT
+            float v_pu = sensor->output_voltage * (16384.0f / GRID_NOMINAL_PEAK_V);
+            if (v_pu > 32767.0f) v_pu = 32767.0f;
+            if (v_pu < -32768.0f) v_pu = -32768.0f;
+            uint32_t grid_phase = sogi_pll_q_update(&pll_q, (int16_t)v_pu);
+            float grid_freq = sogi_pll_q_get_frequency(&pll_q);
+            bool grid_locked = sogi_pll_q_is_locked(&pll_q);
+#else
+            sogi_pll_update(&pll, sensor->output_voltage);
+            uint32_t grid_phase = sogi_pll_get_phase_u32(&pll);
+            float grid_freq = sogi_pll_get_frequency(&pll);
+            bool grid_locked = sogi_pll_is_locked(&pll);
+#endif
+            modulation_sync(&modulator, grid_phase, grid_freq);
+
+            if (grid_locked && soft_start_is_complete(&soft_start)) {
+                // Unity power factor: current reference in phase with the grid
+                float theta = (float)grid_phase * (2.0f * 3.14159265359f / 4294967296.0f);
+                float current_ref = 5.0f * sinf(theta);
+                float new_mi = pr_controller_update(&pr_ctrl, current_ref, sensor->output_current);
+                modulation_set_index(&modulator, new_mi);
+            }
+        }
+
+        /* Calculate duty cycles */
+        if (TEST_MODE == 7) {
+            /* Mode 7: RMS voltage PI (per cycle) sets the PR current amplitude,
+             * the PR output is the modulator reference */
+            const sensor_data_t *sensor = adc_sensor_get_data(&adc_sensor);
+            if (!v_ctrl.active && soft_start_is_complete(&soft_start)) {
+                // Bumpless hand-over from the open-loop ramp
+                voltage_control_engage(&v_ctrl, modulator.modulation_index, modulator.phase);
+            }
+            float v_ref = voltage_control_update(&v_ctrl, sensor->output_voltage,
+                                                 sensor->output_current, modulator.phase);
+            if (v_ctrl.active) {
+                modulation_calculate_duties_ref(&modulator, v_ref, &duties);
+            } else {
+                modulation_calculate_duties(&modulator, &duties);
+            }
+        } else {
+            modulation_calculate_duties(&modulator, &duties);
+        }
+
+        /* Dead-time compensation from the output current polarity */
+        deadtime_comp_apply(&dt_comp, &duties, adc_sensor_get_data(&adc_sensor)->output_current);
+
+        /* Update PWM outputs */
+        pwm_set_hbridge1_duty(&pwm_ctrl, duties.hbridge1.ch1, duties.hbridge1.ch2);
+        pwm_set_hbridge2_duty(&pwm_ctrl, duties.hbridge2.ch1, duties.hbridge2.ch2);
+
+        /* Log waveform data if in waveform mode */
+        if (logger.mode == LOG_MODE_WAVEFORM) {
+            const sensor_data_t *sensor = adc_sensor_get_data(&adc_sensor);
+            logger_log_waveform(&logger,
+                               sensor->output_current,
+                               sensor->output_voltage,
+                               duties.hbridge1.ch1,
+                               duties.hbridge1.ch2);
+        }
+
+        /* Running RMS/power/THD, O(1) per sample */
+        const sensor_data_t *meas = adc_sensor_get_data(&adc_sensor);
+        power_metrics_update(&metrics,
+                             meas->output_voltage,
+                             meas->output_current,
+                             meas->dc_bus1_voltage,
+                             meas->dc_bus2_voltage);
+
+        /* Advance to next sample */
+        modulation_update(&modulator);
+
+        update_count++;
+    }
+}
+
+/**
+ * @brief ADC DMA half-transfer callback
+ * First half of the circular buffer is full: sum it while the DMA
+ * fills the second half
+ */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc->Instance == ADC1) {
+        adc_sensor_dma_half_complete(&adc_sensor);
+    }
+}
+
+/**
+ * @brief ADC DMA transfer-complete callback
+ * Second half is full; the DMA has wrapped to the first half
+ */
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc->Instance == ADC1) {
+        adc_sensor_dma_complete(&adc_sensor);
+    }
+}
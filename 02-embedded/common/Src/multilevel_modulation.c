@@ -0,0 +1,732 @@
+/**
+ * @file multilevel_modulation.c
+ * @brief Level-shifted / phase-shifted carrier PWM implementation
+ *
+ * LEVEL-SHIFTED CARRIERS:
+ * Carrier 1: -1.0 to 0.0 (lower level)
+ * Carrier 2:  0.0 to +1.0 (upper level)
+ * Reference: -1.0 to +1.0 (sine wave)
+ *
+ * This creates natural 5-level output:
+ * +2V: ref > 0, both carriers triggered
+ * +1V: ref between 0 and carrier2
+ * 0V:  ref crosses zero
+ * -1V: ref between carrier1 and 0
+ * -2V: ref < carrier1
+ *
+ * Each bridge is driven unipolar: leg A high for (1 + m)/2 of the period,
+ * leg B for (1 - m)/2, giving an average of m * Vdc with one pulse
+ * centred in the period. The modes only differ in how the reference is
+ * split between the bridges and where their periods start.
+ *
+ * The reference table holds the shaped waveform (sine, THI or min-max)
+ * normalized so that MI = 1 is a unit sine fundamental; mi_max is the MI
+ * at which its peak reaches the carrier limit.
+ *
+ * SHE STAIRCASE:
+ * The level steps at the tabulated angles fall anywhere inside a PWM
+ * period. A bridge's output within one period is a single pulse [b, c)
+ * as long as it does not switch back and forth inside that period:
+ * leg A high for [0, c) and leg B for [0, b) give +Vdc over [b, c) (legs
+ * swapped for -Vdc), so each step lands on its exact timer count.
+ * Periods with several steps of the same bridge (close angles) fall back
+ * to a centred pulse of the same volt-seconds.
+ *
+ * DC-LINK FEED-FORWARD:
+ * With bus ratios k1, k2 (measured / nominal) an average of m * Vdc_i
+ * from bridge i is m * k_i in nominal units, so a bridge asked for a
+ * level l (nominal units) gets m = l / k_i. The reciprocals are formed
+ * once per sample in modulation_set_dc_bus(); the duty path only
+ * multiplies. PS asks each bridge for half the output (the part one bus
+ * cannot supply moves to the other); LS limits the inner band to
+ * +-k_inner and leaves the remainder to the outer bridge.
+ */
+
+#include "multilevel_modulation.h"
+#include "she_angles.h"
+#include "sine_lut.h"
+#include <math.h>
+#include <string.h>
+
+/* DDS phase units per cycle */
+#define PHASE_PER_CYCLE     4294967296.0f
+#define PHASE_TO_RAD        (2.0f * (float)M_PI / PHASE_PER_CYCLE)
+
+/* SHE playback */
+#define SHE_INTERP_MAX_RAD  0.05f     // Interpolate only along one solution branch
+#define SHE_MAX_STEPS       6         // Level steps handled within one period
+
+// Unit sine, built by the compiler into flash
+static const float sine_lut[SINE_TABLE_SIZE] = SINE_LUT_200;
+_Static_assert(sizeof(sine_lut) / sizeof(sine_lut[0]) == SINE_TABLE_SIZE,
+               "sine_lut initializer does not match SINE_TABLE_SIZE");
+
+// THI / min-max reference, filled only when such a shape is selected
+static float shaped_table[SINE_TABLE_SIZE];
+
+// Active reference table (one modulator per firmware)
+static const float *sine_table = sine_lut;
+
+// Bus ratios / duty gains of an ideal bus, for the staircase modes
+static const float unity[2] = { 1.0f, 1.0f };
+
+// Phase of phases a, b, c relative to phase a: 0, -120 deg, +120 deg
+static const uint32_t phase_offset[MODULATION_PHASES] = { 0u, 0xAAAAAAABu, 0x55555555u };
+
+/**
+ * @brief Select the reference table, filling it for the shaped references
+ * @return Peak of the shaped waveform (1.0 for a sine)
+ */
+static float build_table(modulation_shape_t shape, float thi_k)
+{
+    float peak = 0.0f;
+
+    if (shape != MODULATION_SHAPE_THI && shape != MODULATION_SHAPE_MINMAX) {
+        sine_table = sine_lut;
+        return 1.0f;
+    }
+
+    for (int i = 0; i < SINE_TABLE_SIZE; i++) {
+        float x = 2.0f * M_PI * i / SINE_TABLE_SIZE;
+        float v = sinf(x);
+
+        if (shape == MODULATION_SHAPE_THI) {
+            v += thi_k * sinf(3.0f * x);
+        } else if (shape == MODULATION_SHAPE_MINMAX) {
+            // Zero sequence of the balanced three-phase set
+            float b = sinf(x - 2.0f * M_PI / 3.0f);
+            float c = sinf(x + 2.0f * M_PI / 3.0f);
+            float vmax = fmaxf(v, fmaxf(b, c));
+            float vmin = fminf(v, fminf(b, c));
+            v -= 0.5f * (vmax + vmin);
+        }
+
+        shaped_table[i] = v;
+        if (fabsf(v) > peak) peak = fabsf(v);
+    }
+
+    sine_table = shaped_table;
+    return peak;
+}
+
+int modulation_init(modulation_t *mod)
+{
+    if (mod == NULL) return -1;
+
+    // Clear structure
+    memset(mod, 0, sizeof(modulation_t));
+
+    // Default values
+    mod->modulation_index = 0.8f;
+    mod->mi_max = 1.0f;
+    mod->phase = 0;
+    modulation_set_frequency(mod, OUTPUT_FREQUENCY_HZ);
+    mod->mode = MODULATION_MODE_LS;
+    mod->shape = MODULATION_SHAPE_SINE;
+    mod->thi_k = MODULATION_THI_K_DEFAULT;
+    mod->rotation = true;
+    mod->bus[0] = mod->bus[1] = 1.0f;
+    mod->gain[0] = mod->gain[1] = 1.0f;
+    mod->enabled = false;
+
+    // Plain sine reference (flash table)
+    sine_table = sine_lut;
+
+    return 0;
+}
+
+/**
+ * @brief Timer compares for one bridge producing an average of m * Vdc
+ *
+ * Leg A is high for (1 + m)/2 of the period and leg B for (1 - m)/2, so
+ * the output is one +-Vdc pulse of width |m| centred in the period. A
+ * bridge at exactly m = 0 (idle LS band) is held in the low zero state
+ * instead of switching both legs at 50%.
+ */
+static void bridge_duty(float m, hbridge_duty_t *duty)
+{
+    if (m < -1.0f) m = -1.0f;
+    if (m > 1.0f) m = 1.0f;
+
+    if (m == 0.0f) {
+        duty->ch1 = 0;
+        duty->ch2 = 0;
+        return;
+    }
+
+    // Counts out of ARR + 1, so |m| = 1 holds a leg fully on (compare
+    // above ARR) instead of leaving a one-count notch every period
+    uint16_t a = (uint16_t)((m + 1.0f) * PWM_DUTY_SCALE + 0.5f);
+    duty->ch1 = a;                          // Leg A high for (1 + m)/2
+    duty->ch2 = PWM_COUNTS - a;             // Leg B high for (1 - m)/2
+}
+
+/**
+ * @brief SHE angles for the MI, interpolated between grid points
+ * @return false below the table range (no output)
+ */
+static bool she_lookup(float mi, she_entry_t *e)
+{
+    if (mi < SHE_MI_MIN) return false;
+
+    float pos = (mi - SHE_MI_MIN) / SHE_MI_STEP;
+    int i = (int)pos;
+    if (i >= SHE_TABLE_SIZE - 1) {
+        *e = she_table[SHE_TABLE_SIZE - 1];
+        return true;
+    }
+
+    const she_entry_t *a = &she_table[i];
+    const she_entry_t *b = &she_table[i + 1];
+    float f = pos - (float)i;
+
+    // Neighbours on different branches: take the nearest as is
+    for (int k = 0; k < SHE_ANGLES; k++) {
+        if (a->sign[k] != b->sign[k] || fabsf(b->alpha[k] - a->alpha[k]) > SHE_INTERP_MAX_RAD) {
+            *e = (f < 0.5f) ? *a : *b;
+            return true;
+        }
+    }
+
+    for (int k = 0; k < SHE_ANGLES; k++) {
+        e->sign[k] = a->sign[k];
+        e->alpha[k] = a->alpha[k] + f * (b->alpha[k] - a->alpha[k]);
+    }
+    return true;
+}
+
+/**
+ * @brief Staircase level (-2..+2) at angle x (0..2pi) from the quarter wave
+ */
+static int she_level(const she_entry_t *e, float x)
+{
+    int sign = 1;
+    if (x >= (float)M_PI) {
+        x -= (float)M_PI;
+        sign = -1;
+    }
+    if (x > 0.5f * (float)M_PI) x = (float)M_PI - x;
+
+    int level = 0;
+    for (int k = 0; k < SHE_ANGLES; k++) {
+        if (x >= e->alpha[k]) level += e->sign[k];
+    }
+    return sign * level;
+}
+
+/**
+ * @brief Compares for one bridge from its levels over the period segments
+ *
+ * @param lvl  Bridge level (-1, 0, +1) per segment
+ * @param t    Segment boundaries in timer counts, t[0] = 0, t[n] = ARR + 1
+ * @param n    Number of segments
+ */
+static void she_bridge(const int *lvl, const float *t, int n, hbridge_duty_t *duty)
+{
+    int first = -1, last = -1;
+    bool single = true;
+    float area = 0.0f;
+
+    for (int j = 0; j < n; j++) {
+        area += (float)lvl[j] * (t[j + 1] - t[j]);
+        if (lvl[j] == 0) continue;
+        if (first < 0) {
+            first = j;
+        } else if (lvl[j] != lvl[first] || last != j - 1) {
+            single = false;
+        }
+        last = j;
+    }
+
+    if (first < 0) {
+        duty->ch1 = 0;
+        duty->ch2 = 0;
+    } else if (!single) {
+        bridge_duty(area / PWM_COUNTS, duty);
+    } else {
+        // One pulse [b, c): the leg that ends it high until c, the other until b
+        uint16_t b = (uint16_t)(t[first] + 0.5f);
+        uint16_t c = (uint16_t)(t[last + 1] + 0.5f);
+        duty->ch1 = (lvl[first] > 0) ? c : b;
+        duty->ch2 = (lvl[first] > 0) ? b : c;
+    }
+}
+
+/**
+ * @brief SHE staircase compares for the period centred on phase
+ *
+ * @param swapped H-bridge 2 has the inner band
+ */
+static void she_duties(const modulation_t *mod, uint32_t phase, bool swapped,
+                       inverter_duty_t *duties)
+{
+    she_entry_t e;
+
+    if (!she_lookup(mod->modulation_index, &e)) {
+        memset(duties, 0, sizeof(inverter_duty_t));
+        return;
+    }
+
+    const float two_pi = 2.0f * (float)M_PI;
+    float width = (float)mod->phase_step * PHASE_TO_RAD;
+    float start = (float)(uint32_t)(phase - mod->phase_step / 2) * PHASE_TO_RAD;
+    float counts = (float)PWM_COUNTS;
+
+    // Level steps inside the period, as timer counts in ascending order
+    float t[SHE_MAX_STEPS + 2];
+    int n = 1;
+    t[0] = 0.0f;
+    for (int k = 0; k < SHE_ANGLES; k++) {
+        float a = e.alpha[k];
+        float steps[4] = { a, (float)M_PI - a, (float)M_PI + a, two_pi - a };
+        for (int q = 0; q < 4 && n <= SHE_MAX_STEPS; q++) {
+            float off = steps[q] - start;
+            if (off < 0.0f) off += two_pi;
+            if (off >= width) continue;
+
+            float c = off / width * counts;
+            int j = n++;
+            while (j > 1 && t[j - 1] > c) {
+                t[j] = t[j - 1];
+                j--;
+            }
+            t[j] = c;
+        }
+    }
+    t[n] = counts;
+
+    // Split each segment's level between the inner and outer bridge
+    int inner[SHE_MAX_STEPS + 1], outer[SHE_MAX_STEPS + 1];
+    for (int j = 0; j < n; j++) {
+        float x = start + 0.5f * (t[j] + t[j + 1]) / counts * width;
+        if (x >= two_pi) x -= two_pi;
+        int level = she_level(&e, x);
+        inner[j] = (level > 1) ? 1 : ((level < -1) ? -1 : level);
+        outer[j] = level - inner[j];
+    }
+
+    she_bridge(swapped ? outer : inner, t, n, &duties->hbridge1);
+    she_bridge(swapped ? inner : outer, t, n, &duties->hbridge2);
+}
+
+static uint32_t table_index(uint32_t phase)
+{
+    return (uint32_t)(((uint64_t)phase * SINE_TABLE_SIZE) >> 32);
+}
+
+static float reference_at(const modulation_t *mod, uint32_t phase)
+{
+    return sine_table[table_index(phase)] * mod->modulation_index;
+}
+
+static void disabled_duties(inverter_duty_t *duties)
+{
+    // Output zero when disabled (50% duty = zero output for bipolar)
+    duties->hbridge1.ch1 = PWM_PERIOD / 2;
+    duties->hbridge1.ch2 = PWM_PERIOD / 2;
+    duties->hbridge2.ch1 = PWM_PERIOD / 2;
+    duties->hbridge2.ch2 = PWM_PERIOD / 2;
+}
+
+/**
+ * @brief Level-shifted split of an output level (-2..+2 nominal Vdc)
+ *
+ * @param swapped H-bridge 2 has the inner band
+ * @param bus     Bus ratio per bridge, the inner band limit
+ * @param gain    Reciprocal of bus, level to duty per bridge
+ */
+static void level_shifted_duties(bool swapped, float level,
+                                 const float *bus, const float *gain,
+                                 inverter_duty_t *duties)
+{
+    int in = swapped ? 1 : 0;
+    int out = 1 - in;
+
+    float inner = level;
+    if (inner < -bus[in]) inner = -bus[in];
+    if (inner > bus[in]) inner = bus[in];
+    float outer = level - inner;
+
+    hbridge_duty_t *h_in = swapped ? &duties->hbridge2 : &duties->hbridge1;
+    hbridge_duty_t *h_out = swapped ? &duties->hbridge1 : &duties->hbridge2;
+    bridge_duty(inner * gain[in], h_in);
+    bridge_duty(outer * gain[out], h_out);
+}
+
+/**
+ * @brief Phase-shifted share of the output, half per bridge (nominal Vdc)
+ *
+ * Whatever one bridge's bus cannot supply of its half moves to the other.
+ */
+static void phase_shifted_duties(const modulation_t *mod, float ref1, float ref2,
+                                 inverter_duty_t *duties)
+{
+    float l1 = ref1, l2 = ref2;
+    float x1 = 0.0f, x2 = 0.0f;
+    if (l1 > mod->bus[0]) x1 = l1 - mod->bus[0];
+    if (l1 < -mod->bus[0]) x1 = l1 + mod->bus[0];
+    if (l2 > mod->bus[1]) x2 = l2 - mod->bus[1];
+    if (l2 < -mod->bus[1]) x2 = l2 + mod->bus[1];
+
+    bridge_duty((l1 - x1 + x2) * mod->gain[0], &duties->hbridge1);
+    bridge_duty((l2 - x2 + x1) * mod->gain[1], &duties->hbridge2);
+}
+
+/**
+ * @brief Carrier modes sample the reference of TIM8 half a step later (PS)
+ */
+static bool samples_twice(const modulation_t *mod)
+{
+    return mod->mode == MODULATION_MODE_PS && mod->shape != MODULATION_SHAPE_NLC;
+}
+
+/**
+ * @brief Duties of one phase from its reference samples (-1..+1)
+ *
+ * @param ref     Reference at the TIM1 period centre
+ * @param ref2    Reference half a step later (PS only, see samples_twice)
+ * @param swapped H-bridge 2 has the inner band (LS)
+ */
+static void carrier_duties(const modulation_t *mod, float ref, float ref2, bool swapped,
+                           inverter_duty_t *duties)
+{
+    if (samples_twice(mod)) {
+        /*
+         * PHASE-SHIFTED CARRIERS:
+         * Both bridges follow the full reference. TIM8 starts its period
+         * half a period after TIM1, so its pulse is centred on TIM1's
+         * update: its reference is sampled half a step later to match.
+         */
+        phase_shifted_duties(mod, ref, ref2, duties);
+        return;
+    }
+
+    /*
+     * LEVEL-SHIFTED CARRIER COMPARISON:
+     *
+     * Output in units of Vdc is 2 * ref (-2..+2). The inner band (|v| < 1,
+     * carriers nearest zero) is produced by one bridge; the other bridge
+     * only switches once the first is saturated (outer band):
+     *
+     *   inner = clamp(2 * ref, -1, +1)
+     *   outer = 2 * ref - inner
+     *
+     * The inner bridge conducts for the whole cycle and switches most, so
+     * with rotation enabled the roles swap at every positive zero
+     * crossing of the reference.
+     *
+     * NLC rounds the level first, so both bridges are simply on or off
+     * (the same split, in either carrier mode, without bus feed-forward).
+     */
+    float level = 2.0f * ref;
+    if (mod->shape == MODULATION_SHAPE_NLC) {
+        level = roundf(level);
+        if (level < -2.0f) level = -2.0f;
+        if (level > 2.0f) level = 2.0f;
+        level_shifted_duties(swapped, level, unity, unity, duties);
+    } else {
+        level_shifted_duties(swapped, level, mod->bus, mod->gain, duties);
+    }
+}
+
+int modulation_calculate_duties(modulation_t *mod, inverter_duty_t *duties)
+{
+    if (mod == NULL || duties == NULL) return -1;
+
+    if (!mod->enabled) {
+        disabled_duties(duties);
+        return 0;
+    }
+
+    if (mod->shape == MODULATION_SHAPE_SHE) {
+        // Precomputed staircase, same band split in either carrier mode
+        she_duties(mod, mod->phase, mod->swapped, duties);
+        return 0;
+    }
+
+    // Get modulation reference (sine wave) from -1 to +1
+    float ref = reference_at(mod, mod->phase);
+    float ref2 = samples_twice(mod) ? reference_at(mod, mod->phase + mod->phase_step / 2) : ref;
+
+    carrier_duties(mod, ref, ref2, mod->swapped, duties);
+    return 0;
+}
+
+/**
+ * @brief References of the three phases at the phase of phase a
+ *
+ * Fundamentals from the plain sine table, plus the zero sequence of the
+ * shape, common to all three: k * sin(3x) for THI (the same in every
+ * phase), -(max + min) / 2 of the three sines for MINMAX.
+ */
+static void three_phase_references(const modulation_t *mod, uint32_t phase,
+                                   float ref[MODULATION_PHASES])
+{
+    float zs = 0.0f;
+
+    for (int k = 0; k < MODULATION_PHASES; k++) {
+        ref[k] = sine_lut[table_index(phase + phase_offset[k])];
+    }
+
+    if (mod->shape == MODULATION_SHAPE_THI) {
+        // sin(3x) at the table point of phase a, as build_table() has it
+        zs = mod->thi_k * sine_lut[(3u * table_index(phase)) % SINE_TABLE_SIZE];
+    } else if (mod->shape == MODULATION_SHAPE_MINMAX) {
+        float vmax = fmaxf(ref[0], fmaxf(ref[1], ref[2]));
+        float vmin = fminf(ref[0], fminf(ref[1], ref[2]));
+        zs = -0.5f * (vmax + vmin);
+    }
+
+    for (int k = 0; k < MODULATION_PHASES; k++) {
+        ref[k] = (ref[k] + zs) * mod->modulation_index;
+    }
+}
+
+/**
+ * @brief Duties of all three phases (six H-bridges) for one PWM period
+ *
+ * Same carriers, shape and MI as modulation_calculate_duties(), which
+ * phase a reproduces for the plain sine, NLC and SHE; phases b and c
+ * run 120 deg behind and ahead. The zero sequence of THI and MINMAX is
+ * computed once and added to all three references (see
+ * three_phase_references), so it cancels line-to-line. The LS bands of
+ * each phase swap at that phase's positive zero crossing.
+ */
+int modulation_calculate_duties_3ph(modulation_t *mod, inverter_duty_3ph_t *duties)
+{
+    if (mod == NULL || duties == NULL) return -1;
+
+    if (!mod->enabled) {
+        for (int k = 0; k < MODULATION_PHASES; k++) {
+            disabled_duties(&duties->phase[k]);
+        }
+        return 0;
+    }
+
+    float ref[MODULATION_PHASES], ref2[MODULATION_PHASES];
+    bool twice = samples_twice(mod);
+
+    if (mod->shape != MODULATION_SHAPE_SHE) {
+        three_phase_references(mod, mod->phase, ref);
+        if (twice) {
+            three_phase_references(mod, mod->phase + mod->phase_step / 2, ref2);
+        }
+    }
+
+    for (int k = 0; k < MODULATION_PHASES; k++) {
+        uint32_t phase = mod->phase + phase_offset[k];
+
+        // Phase a's swap state, toggled again once this phase has wrapped
+        // and phase a has not
+        bool swapped = mod->swapped ^ (mod->rotation && phase < phase_offset[k]);
+
+        if (mod->shape == MODULATION_SHAPE_SHE) {
+            she_duties(mod, phase, swapped, &duties->phase[k]);
+        } else {
+            carrier_duties(mod, ref[k], twice ? ref2[k] : ref[k], swapped, &duties->phase[k]);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Duties for an instantaneous reference from a closed-loop controller
+ *
+ * Same carriers as modulation_calculate_duties() (LS split with band
+ * rotation, or PS), but the reference comes from the caller instead of
+ * the table, so the shape and modulation index are not used. The phase
+ * still has to be advanced with modulation_update() for the LS rotation.
+ *
+ * @param ref Output voltage in units of 2 * MODULATION_VDC_NOMINAL
+ *            (-1..+1, clamped)
+ */
+int modulation_calculate_duties_ref(modulation_t *mod, float ref, inverter_duty_t *duties)
+{
+    if (mod == NULL || duties == NULL) return -1;
+
+    if (!mod->enabled) {
+        disabled_duties(duties);
+        return 0;
+    }
+
+    if (ref < -1.0f) ref = -1.0f;
+    if (ref > 1.0f) ref = 1.0f;
+
+    if (mod->mode == MODULATION_MODE_PS) {
+        phase_shifted_duties(mod, ref, ref, duties);
+    } else {
+        level_shifted_duties(mod->swapped, 2.0f * ref, mod->bus, mod->gain, duties);
+    }
+
+    return 0;
+}
+
+void modulation_update(modulation_t *mod)
+{
+    if (mod == NULL) return;
+
+    // Phase accumulator wraps at 2^32 = one output cycle
+    uint32_t prev = mod->phase;
+    mod->phase += mod->phase_step;
+
+    // New cycle: hand the inner band to the other bridge
+    if (mod->rotation && mod->phase < prev) {
+        mod->swapped = !mod->swapped;
+    }
+}
+
+void modulation_set_index(modulation_t *mod, float mi)
+{
+    if (mod == NULL) return;
+
+    // Clamp to the linear range of the reference shape
+    if (mi < 0.0f) mi = 0.0f;
+    if (mi > mod->mi_max) mi = mod->mi_max;
+
+    mod->modulation_index = mi;
+}
+
+void modulation_set_frequency(modulation_t *mod, float freq)
+{
+    if (mod == NULL) return;
+    if (freq < 1.0f || freq > 400.0f) return;
+
+    mod->frequency_hz = freq;
+    mod->phase_step = (uint32_t)(freq / PWM_FREQUENCY_HZ * PHASE_PER_CYCLE);
+}
+
+/**
+ * @brief Lock the sine reference to an external phase (e.g. SOGI-PLL)
+ *
+ * @param phase Phase of the next sample (2^32 = one cycle, 0 = sine zero crossing)
+ * @param freq  Tracked frequency, keeps the step correct between syncs
+ */
+void modulation_sync(modulation_t *mod, uint32_t phase, float freq)
+{
+    if (mod == NULL) return;
+
+    // Forward step across zero also starts a new cycle
+    if (mod->rotation && phase < mod->phase && (int32_t)(phase - mod->phase) > 0) {
+        mod->swapped = !mod->swapped;
+    }
+
+    mod->phase = phase;
+    modulation_set_frequency(mod, freq);
+}
+
+/**
+ * @brief Select level-shifted or phase-shifted carriers
+ *
+ * The TIM8 offset for PS mode is applied by the PWM driver: pass
+ * modulation_carrier_shift() to pwm_set_carrier_shift() before pwm_start().
+ */
+void modulation_set_mode(modulation_t *mod, modulation_mode_t mode)
+{
+    if (mod == NULL) return;
+    if (mode != MODULATION_MODE_LS && mode != MODULATION_MODE_PS) return;
+
+    mod->mode = mode;
+    mod->swapped = false;
+}
+
+/**
+ * @brief Enable swapping of the LS bands between bridges every output cycle
+ *
+ * Balances conduction/switching loss and the power drawn from the two DC
+ * links over a pair of cycles. Has no effect in PS mode, which is balanced
+ * by construction.
+ */
+void modulation_set_rotation(modulation_t *mod, bool enable)
+{
+    if (mod == NULL) return;
+
+    mod->rotation = enable;
+    if (!enable) {
+        mod->swapped = false;
+    }
+}
+
+/**
+ * @brief TIM8 counter offset (timer counts) required by the current mode
+ */
+uint16_t modulation_carrier_shift(const modulation_t *mod)
+{
+    if (mod == NULL || mod->mode != MODULATION_MODE_PS) return 0;
+
+    return PWM_COUNTS / 2;
+}
+
+/**
+ * @brief Select the reference shape and rebuild the table
+ *
+ * Raises (or lowers) the MI limit to what the shape allows and clamps the
+ * present MI to it.
+ *
+ * @param shape Reference shape
+ * @param thi_k Third-harmonic ratio for MODULATION_SHAPE_THI (0 to 0.5),
+ *              ignored otherwise
+ * @return 0 on success, -1 on invalid arguments
+ */
+int modulation_set_shape(modulation_t *mod, modulation_shape_t shape, float thi_k)
+{
+    if (mod == NULL) return -1;
+    if (shape > MODULATION_SHAPE_SHE) return -1;
+    if (shape == MODULATION_SHAPE_THI && (thi_k < 0.0f || thi_k > 0.5f)) return -1;
+
+    float peak = build_table(shape, thi_k);
+
+    mod->shape = shape;
+    if (shape == MODULATION_SHAPE_THI) {
+        mod->thi_k = thi_k;
+    }
+    if (shape == MODULATION_SHAPE_NLC) {
+        mod->mi_max = MODULATION_MI_MAX_NLC;
+    } else if (shape == MODULATION_SHAPE_SHE) {
+        mod->mi_max = SHE_MI_MAX;
+    } else {
+        mod->mi_max = 1.0f / peak;
+    }
+
+    if (mod->modulation_index > mod->mi_max) {
+        mod->modulation_index = mod->mi_max;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Largest modulation index accepted by modulation_set_index()
+ */
+float modulation_get_max_index(const modulation_t *mod)
+{
+    if (mod == NULL) return 1.0f;
+
+    return mod->mi_max;
+}
+
+/**
+ * @brief Measured DC bus voltages for the duty normalization
+ *
+ * Call once per sample, before the duties are calculated. A reading
+ * below MODULATION_VDC_MIN_RATIO of nominal (sensor disconnected or not
+ * calibrated, precharge) is not trusted: that bridge runs on nominal
+ * (gain 1) instead of having its duty doubled. Undervoltage itself is
+ * the safety module's job.
+ *
+ * @param vdc1 H-bridge 1 bus (V)
+ * @param vdc2 H-bridge 2 bus (V)
+ */
+void modulation_set_dc_bus(modulation_t *mod, float vdc1, float vdc2)
+{
+    if (mod == NULL) return;
+
+    const float v_min = MODULATION_VDC_MIN_RATIO * MODULATION_VDC_NOMINAL;
+    float vdc[2] = { vdc1, vdc2 };
+
+    for (int i = 0; i < 2; i++) {
+        if (!(vdc[i] >= v_min)) vdc[i] = MODULATION_VDC_NOMINAL;   // Also catches NaN
+        mod->bus[i] = vdc[i] * (1.0f / MODULATION_VDC_NOMINAL);
+        mod->gain[i] = MODULATION_VDC_NOMINAL / vdc[i];
+    }
+}
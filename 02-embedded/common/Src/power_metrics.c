@@ -0,0 +1,220 @@
+/**
+ * @file power_metrics.c
+ * @brief Sliding-window power metrics implementation
+ *
+ * The sliding sums add the new sample and subtract the one leaving the
+ * window. Float round-off would build up in them, so each cycle also
+ * collects fresh block sums, which replace the sliding sums whenever the
+ * window wraps.
+ */
+
+#include "power_metrics.h"
+#include <math.h>
+#include <string.h>
+
+#define PI 3.14159265359f
+
+/* Private functions */
+static void reset_cycle(power_metrics_t *pm)
+{
+    pm->blk_v2 = 0.0f;
+    pm->blk_i2 = 0.0f;
+    pm->blk_vi = 0.0f;
+
+    pm->dc1_sum = 0.0f;
+    pm->dc1_min = INFINITY;
+    pm->dc1_max = -INFINITY;
+    pm->dc2_sum = 0.0f;
+    pm->dc2_min = INFINITY;
+    pm->dc2_max = -INFINITY;
+
+    for (int h = 0; h < PM_HARMONICS; h++) {
+        pm->gv_s1[h] = pm->gv_s2[h] = 0.0f;
+        pm->gi_s1[h] = pm->gi_s2[h] = 0.0f;
+    }
+}
+
+static float safe_sqrt(float x)
+{
+    return (x > 0.0f) ? sqrtf(x) : 0.0f;
+}
+
+/* Goertzel readout: RMS of the bin, |X| * sqrt(2) / N */
+static float goertzel_rms(const power_metrics_t *pm, int h, float s1, float s2)
+{
+    float re = s1 - s2 * pm->g_cos[h];
+    float im = s2 * pm->g_sin[h];
+    return sqrtf(re * re + im * im) * 1.41421356f / (float)pm->window;
+}
+
+static float thd(const float *harm)
+{
+    if (harm[0] <= 1e-9f) {
+        return 0.0f;
+    }
+
+    float sum = 0.0f;
+    for (int h = 1; h < PM_HARMONICS; h++) {
+        sum += harm[h] * harm[h];
+    }
+    return sqrtf(sum) / harm[0];
+}
+
+static void end_of_cycle(power_metrics_t *pm)
+{
+    power_metrics_data_t *d = &pm->data;
+    float n = (float)pm->window;
+
+    // Resync sliding sums to the exact sums of the cycle just finished
+    pm->sum_v2 = pm->blk_v2;
+    pm->sum_i2 = pm->blk_i2;
+    pm->sum_vi = pm->blk_vi;
+
+    for (int h = 0; h < PM_HARMONICS; h++) {
+        d->v_harmonic[h] = goertzel_rms(pm, h, pm->gv_s1[h], pm->gv_s2[h]);
+        d->i_harmonic[h] = goertzel_rms(pm, h, pm->gi_s1[h], pm->gi_s2[h]);
+    }
+    d->v_thd = thd(d->v_harmonic);
+    d->i_thd = thd(d->i_harmonic);
+
+    d->dc1_mean = pm->dc1_sum / n;
+    d->dc2_mean = pm->dc2_sum / n;
+    d->dc1_ripple = pm->dc1_max - pm->dc1_min;
+    d->dc2_ripple = pm->dc2_max - pm->dc2_min;
+
+    d->cycles++;
+    d->valid = true;
+
+    reset_cycle(pm);
+}
+
+/* Public functions */
+int power_metrics_init(power_metrics_t *pm, float sample_freq_hz, float fundamental_hz)
+{
+    if (pm == NULL || sample_freq_hz <= 0.0f || fundamental_hz <= 0.0f) {
+        return -1;
+    }
+
+    memset(pm, 0, sizeof(power_metrics_t));
+
+    // Samples per cycle, thinned out if the cycle is too long
+    float per_cycle = sample_freq_hz / fundamental_hz;
+    uint32_t stride = (uint32_t)ceilf(per_cycle / PM_MAX_WINDOW);
+    if (stride < 1) {
+        stride = 1;
+    }
+    uint32_t window = (uint32_t)lrintf(per_cycle / (float)stride);
+    if (window < 2 * PM_HARMONICS + 2 || window > PM_MAX_WINDOW) {
+        return -2;
+    }
+
+    pm->window = (uint16_t)window;
+    pm->stride = (uint16_t)stride;
+
+    for (int h = 0; h < PM_HARMONICS; h++) {
+        float w = 2.0f * PI * (float)(h + 1) / (float)window;
+        pm->g_cos[h] = cosf(w);
+        pm->g_sin[h] = sinf(w);
+        pm->g_coeff[h] = 2.0f * pm->g_cos[h];
+    }
+
+    power_metrics_reset(pm);
+    pm->initialized = true;
+
+    return 0;
+}
+
+void power_metrics_reset(power_metrics_t *pm)
+{
+    if (pm == NULL) {
+        return;
+    }
+
+    memset(pm->v_buf, 0, sizeof(pm->v_buf));
+    memset(pm->i_buf, 0, sizeof(pm->i_buf));
+    pm->sum_v2 = pm->sum_i2 = pm->sum_vi = 0.0f;
+    pm->index = 0;
+    pm->stride_count = 0;
+    memset(&pm->data, 0, sizeof(pm->data));
+    reset_cycle(pm);
+}
+
+/**
+ * @brief Add one sample (call at the control rate)
+ *
+ * @return true when a cycle completed and harmonics/THD/ripple were updated
+ */
+bool power_metrics_update(power_metrics_t *pm, float v, float i, float vdc1, float vdc2)
+{
+    if (pm == NULL || !pm->initialized) {
+        return false;
+    }
+
+    if (++pm->stride_count < pm->stride) {
+        return false;
+    }
+    pm->stride_count = 0;
+
+    // Sliding window: replace the sample one cycle old
+    float v_old = pm->v_buf[pm->index];
+    float i_old = pm->i_buf[pm->index];
+    pm->v_buf[pm->index] = v;
+    pm->i_buf[pm->index] = i;
+
+    float v2 = v * v, i2 = i * i, vi = v * i;
+    pm->sum_v2 += v2 - v_old * v_old;
+    pm->sum_i2 += i2 - i_old * i_old;
+    pm->sum_vi += vi - v_old * i_old;
+    pm->blk_v2 += v2;
+    pm->blk_i2 += i2;
+    pm->blk_vi += vi;
+
+    // Goertzel: s[n] = x[n] + 2cos(w) s[n-1] - s[n-2]
+    for (int h = 0; h < PM_HARMONICS; h++) {
+        float sv = v + pm->g_coeff[h] * pm->gv_s1[h] - pm->gv_s2[h];
+        pm->gv_s2[h] = pm->gv_s1[h];
+        pm->gv_s1[h] = sv;
+
+        float si = i + pm->g_coeff[h] * pm->gi_s1[h] - pm->gi_s2[h];
+        pm->gi_s2[h] = pm->gi_s1[h];
+        pm->gi_s1[h] = si;
+    }
+
+    // DC bus statistics for this cycle
+    pm->dc1_sum += vdc1;
+    pm->dc2_sum += vdc2;
+    if (vdc1 < pm->dc1_min) pm->dc1_min = vdc1;
+    if (vdc1 > pm->dc1_max) pm->dc1_max = vdc1;
+    if (vdc2 < pm->dc2_min) pm->dc2_min = vdc2;
+    if (vdc2 > pm->dc2_max) pm->dc2_max = vdc2;
+
+    bool cycle_done = false;
+    if (++pm->index >= pm->window) {
+        pm->index = 0;
+        end_of_cycle(pm);
+        cycle_done = true;
+    }
+
+    // Per-sample RMS and power over the last window
+    if (pm->data.valid) {
+        power_metrics_data_t *d = &pm->data;
+        float n = (float)pm->window;
+
+        d->v_rms = safe_sqrt(pm->sum_v2 / n);
+        d->i_rms = safe_sqrt(pm->sum_i2 / n);
+        d->p_real = pm->sum_vi / n;
+        d->s_apparent = d->v_rms * d->i_rms;
+        d->power_factor = (d->s_apparent > 1e-6f) ? d->p_real / d->s_apparent : 0.0f;
+    }
+
+    return cycle_done;
+}
+
+const power_metrics_data_t* power_metrics_get(const power_metrics_t *pm)
+{
+    if (pm == NULL || !pm->initialized) {
+        return NULL;
+    }
+
+    return &pm->data;
+}
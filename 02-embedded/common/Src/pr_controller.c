@@ -7,34 +7,35 @@
 #include <math.h>
 #include <string.h>
 
-#define PI 3.14159265359f
+/* Coefficients for the default cutoff, folded at compile time */
+static const float default_a1   = PR_A1(PR_WC_DEFAULT);
+static const float default_a2   = PR_A2(PR_WC_DEFAULT);
+static const float default_b_kr = PR_B_PER_KR(PR_WC_DEFAULT);
 
 /* Private functions */
+static void scale_numerator(pr_controller_t *pr)
+{
+    pr->b0 = pr->kr * pr->b_kr;
+    pr->b1 = 0.0f;
+    pr->b2 = -pr->b0;
+}
+
 static void calculate_coefficients(pr_controller_t *pr)
 {
-    // Discretize PR controller using tustin/bilinear transform
-    float Ts = 1.0f / PR_SAMPLE_FREQ;
-    float w0 = 2.0f * PI * PR_FUNDAMENTAL_FREQ;
+    // Tustin discretization, see PR_A1/PR_A2/PR_B_PER_KR
     float wc = pr->wc;
 
-    // Resonant part coefficients (bilinear transform)
-    // H(s) = (2*Kr*wc*s) / (s² + 2*wc*s + w0²)
-    // After bilinear: H(z) = (b0 + b1*z^-1 + b2*z^-2) / (1 + a1*z^-1 + a2*z^-2)
-
-    float T = Ts;
-    float w0_sq = w0 * w0;
-    float wc2 = 2.0f * wc;
-
-    // Denominator
-    float denom = 4.0f + wc2*T + w0_sq*T*T;
-    pr->a1 = (2.0f*w0_sq*T*T - 8.0f) / denom;
-    pr->a2 = (4.0f - wc2*T + w0_sq*T*T) / denom;
-
-    // Numerator
-    float num_scale = 2.0f * pr->kr * wc * T;
-    pr->b0 = num_scale * 2.0f / denom;
-    pr->b1 = 0.0f;
-    pr->b2 = -num_scale * 2.0f / denom;
+    if (wc == PR_WC_DEFAULT) {
+        pr->a1 = default_a1;
+        pr->a2 = default_a2;
+        pr->b_kr = default_b_kr;
+    } else {
+        pr->a1 = PR_A1(wc);
+        pr->a2 = PR_A2(wc);
+        pr->b_kr = PR_B_PER_KR(wc);
+    }
+
+    scale_numerator(pr);
 }
 
 /* Public functions */
@@ -66,6 +67,7 @@ void pr_controller_reset(pr_controller_t *pr)
     pr->x2 = 0.0f;
     pr->y1 = 0.0f;
     pr->y2 = 0.0f;
+    pr->excess = 0.0f;
     pr->sample_count = 0;
 }
 
@@ -79,14 +81,17 @@ float pr_controller_update(pr_controller_t *pr, float reference, float measured)
     // Proportional term
     float p_term = pr->kp * error;
 
+    // Resonant input, corrected by the last clamp (back-calculation)
+    float r_in = error + pr->kt * pr->excess;
+
     // Resonant term (using direct form II transposed)
     // y[n] = b0*x[n] + b1*x[n-1] + b2*x[n-2] - a1*y[n-1] - a2*y[n-2]
-    float r_term = pr->b0 * error + pr->b1 * pr->x1 + pr->b2 * pr->x2
+    float r_term = pr->b0 * r_in + pr->b1 * pr->x1 + pr->b2 * pr->x2
                    - pr->a1 * pr->y1 - pr->a2 * pr->y2;
 
     // Update state
     pr->x2 = pr->x1;
-    pr->x1 = error;
+    pr->x1 = r_in;
     pr->y2 = pr->y1;
     pr->y1 = r_term;
 
@@ -94,8 +99,10 @@ float pr_controller_update(pr_controller_t *pr, float reference, float measured)
     float output = p_term + r_term;
 
     // Apply limits
+    float unclamped = output;
     if (output > pr->output_max) output = pr->output_max;
     if (output < pr->output_min) output = pr->output_min;
+    pr->excess = output - unclamped;
 
     pr->sample_count++;
 
@@ -117,6 +124,36 @@ void pr_controller_set_gains(pr_controller_t *pr, float kp, float kr)
     pr->kp = kp;
     pr->kr = kr;
 
-    // Recalculate coefficients
-    calculate_coefficients(pr);
+    // The denominator depends on wc only
+    scale_numerator(pr);
+}
+
+void pr_controller_set_antiwindup(pr_controller_t *pr, float kt)
+{
+    if (pr == NULL || kt < 0.0f) return;
+
+    pr->kt = kt;
+}
+
+/**
+ * @brief Load the resonant states with a running sinusoid
+ *
+ * With zero error the next outputs continue amplitude * sin(phase + n*w0*Ts),
+ * decaying only with the cutoff wc. Used to take over from an open-loop
+ * reference without a step.
+ *
+ * @param amplitude Output amplitude (output units)
+ * @param phase     Phase of the next output sample (rad)
+ */
+void pr_controller_preset(pr_controller_t *pr, float amplitude, float phase)
+{
+    if (pr == NULL) return;
+
+    const float wt = PR_WT;
+
+    pr->x1 = 0.0f;
+    pr->x2 = 0.0f;
+    pr->y1 = amplitude * sinf(phase - wt);
+    pr->y2 = amplitude * sinf(phase - 2.0f * wt);
+    pr->excess = 0.0f;
 }
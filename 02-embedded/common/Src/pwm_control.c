@@ -43,6 +43,47 @@ static void disable_all_outputs(pwm_controller_t *ctrl)
     HAL_TIM_PWM_Stop(ctrl->hbridge2.htim, TIM_CHANNEL_1);
     HAL_TIMEx_PWMN_Stop(ctrl->hbridge2.htim, TIM_CHANNEL_2);
     HAL_TIM_PWM_Stop(ctrl->hbridge2.htim, TIM_CHANNEL_2);
+
+    // Stop the TIM1 update interrupt (control loop); pwm_start() restarts it
+    HAL_TIM_Base_Stop_IT(ctrl->hbridge1.htim);
+}
+
+/**
+ * @brief Start both counters with TIM8 offset by exactly carrier_shift
+ *
+ * TIM8 is in trigger mode on TIM1 TRGO (update), so it starts counting at
+ * TIM1's first overflow, from whatever value its counter holds. Both
+ * counters are held, the preload registers (ARR, CCR) loaded with an
+ * update event, then TIM1 is set to 0 and TIM8 to the shift before TIM1
+ * and its update interrupt are started. Anything that set a counter
+ * running earlier (channel start, the TRGO of the update event) is undone
+ * here, so the offset does not depend on when this is called.
+ *
+ * @param ctrl Pointer to PWM controller structure
+ * @return 0 on success, negative error code on failure
+ */
+static int start_counters(pwm_controller_t *ctrl)
+{
+    TIM_HandleTypeDef *htim1 = ctrl->hbridge1.htim;
+    TIM_HandleTypeDef *htim8 = ctrl->hbridge2.htim;
+
+    htim1->Instance->CR1 &= ~TIM_CR1_CEN;
+    htim8->Instance->CR1 &= ~TIM_CR1_CEN;
+
+    // Load new ARR/CCR now; TIM1's update also triggers TIM8, so hold it again
+    HAL_TIM_GenerateEvent(htim8, TIM_EVENTSOURCE_UPDATE);
+    HAL_TIM_GenerateEvent(htim1, TIM_EVENTSOURCE_UPDATE);
+    htim8->Instance->CR1 &= ~TIM_CR1_CEN;
+
+    __HAL_TIM_SET_COUNTER(htim1, 0);
+    __HAL_TIM_SET_COUNTER(htim8, ctrl->carrier_shift);
+    __HAL_TIM_CLEAR_FLAG(htim1, TIM_FLAG_UPDATE);
+
+    if (HAL_TIM_Base_Start_IT(htim1) != HAL_OK) {
+        return -1;
+    }
+
+    return 0;
 }
 
 /* ========================================================================= */
@@ -81,7 +122,8 @@ int pwm_init(pwm_controller_t *ctrl, TIM_HandleTypeDef *htim1, TIM_HandleTypeDef
     // Configure timer synchronization
     // TIM1 is master (generates TRGO on update event)
     // TIM8 is slave (triggered by TIM1 TRGO)
-    // This is already configured in the .ioc file
+    // This is already configured in the .ioc file; neither counter may
+    // run before pwm_start() (MX_TIM1_Init does not start TIM1)
 
     return 0;
 }
@@ -143,6 +185,11 @@ int pwm_start(pwm_controller_t *ctrl)
         return -11;
     }
 
+    // Counters last: TIM1 and the control interrupt, TIM8 on its trigger
+    if (start_counters(ctrl) != 0) {
+        return -12;
+    }
+
     // Update state
     ctrl->state = PWM_STATE_RUNNING;
 
@@ -242,6 +289,51 @@ int pwm_set_hbridge2_duty(pwm_controller_t *ctrl, uint16_t ch1_duty, uint16_t ch
     return 0;
 }
 
+int pwm_set_gates(pwm_controller_t *ctrl, uint8_t gates)
+{
+    // Input validation
+    if (ctrl == NULL) {
+        return -1;
+    }
+
+    // Check state
+    if (ctrl->state != PWM_STATE_RUNNING) {
+        return -3;
+    }
+
+    // Compare above ARR = 100% high, 0 = 0%
+    uint32_t on1 = __HAL_TIM_GET_AUTORELOAD(ctrl->hbridge1.htim) + 1;
+    uint32_t on2 = __HAL_TIM_GET_AUTORELOAD(ctrl->hbridge2.htim) + 1;
+
+    __HAL_TIM_SET_COMPARE(ctrl->hbridge1.htim, TIM_CHANNEL_1, (gates & 0x1) ? on1 : 0);
+    __HAL_TIM_SET_COMPARE(ctrl->hbridge1.htim, TIM_CHANNEL_2, (gates & 0x2) ? on1 : 0);
+    __HAL_TIM_SET_COMPARE(ctrl->hbridge2.htim, TIM_CHANNEL_1, (gates & 0x4) ? on2 : 0);
+    __HAL_TIM_SET_COMPARE(ctrl->hbridge2.htim, TIM_CHANNEL_2, (gates & 0x8) ? on2 : 0);
+
+    return 0;
+}
+
+int pwm_set_carrier_shift(pwm_controller_t *ctrl, uint16_t counts)
+{
+    // Input validation
+    if (ctrl == NULL) {
+        return -1;
+    }
+
+    // Only applied when pwm_start() presets the counters
+    if (ctrl->state == PWM_STATE_RUNNING) {
+        return -3;
+    }
+
+    if (counts > __HAL_TIM_GET_AUTORELOAD(ctrl->hbridge2.htim)) {
+        return -2;
+    }
+
+    ctrl->carrier_shift = counts;
+
+    return 0;
+}
+
 pwm_state_t pwm_get_state(const pwm_controller_t *ctrl)
 {
     if (ctrl == NULL) {
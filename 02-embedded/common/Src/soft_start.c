@@ -4,7 +4,7 @@
  */
 
 #include "soft_start.h"
-#include "stm32f4xx_hal.h"
+#include "board_config.h"
 #include <string.h>
 
 void soft_start_init(soft_start_t *ss, uint32_t ramp_time_ms)
@@ -22,7 +22,7 @@ void soft_start_begin(soft_start_t *ss, float target_mi)
 
     // Clamp target MI
     if (target_mi < 0.0f) target_mi = 0.0f;
-    if (target_mi > 1.0f) target_mi = 1.0f;
+    if (target_mi > SOFT_START_MAX_MI) target_mi = SOFT_START_MAX_MI;
 
     ss->target_mi = target_mi;
     ss->current_mi = 0.0f;
@@ -0,0 +1,312 @@
+/**
+ * @file sogi_pll.c
+ * @brief SOGI-PLL implementation (float and fixed point)
+ */
+
+#include "sogi_pll.h"
+#include <math.h>
+#include <string.h>
+
+#define TWO_PI  6.28318530718f
+
+/* Phase step units: 2^32 per cycle */
+#define PHASE_PER_CYCLE     4294967296.0f
+
+/* Fixed point sine table (Q15, one extra entry for interpolation) */
+#define SIN_TABLE_BITS      10
+#define SIN_TABLE_SIZE      (1 << SIN_TABLE_BITS)
+
+static int16_t sin_table_q15[SIN_TABLE_SIZE + 1];
+static bool sin_table_ready = false;
+
+/*---------------------------------------------------------------------------
+ * Float variant
+ *-------------------------------------------------------------------------*/
+
+int sogi_pll_init(sogi_pll_t *pll, float sample_freq_hz, float nominal_freq_hz, float nominal_peak)
+{
+    if (pll == NULL || sample_freq_hz <= 0.0f || nominal_freq_hz <= 0.0f ||
+        nominal_peak <= 0.0f || nominal_freq_hz * 4.0f > sample_freq_hz) {
+        return -1;
+    }
+
+    memset(pll, 0, sizeof(sogi_pll_t));
+
+    pll->ts = 1.0f / sample_freq_hz;
+    pll->w_nom = TWO_PI * nominal_freq_hz;
+    pll->w_min = pll->w_nom * (1.0f - PLL_FREQ_RANGE);
+    pll->w_max = pll->w_nom * (1.0f + PLL_FREQ_RANGE);
+    pll->v_min = 0.05f * nominal_peak;
+    pll->lock_samples = (uint32_t)(PLL_LOCK_TIME_S * sample_freq_hz);
+
+    sogi_pll_set_gains(pll, SOGI_K_DEFAULT, PLL_KP_DEFAULT, PLL_KI_DEFAULT);
+    sogi_pll_reset(pll);
+
+    return 0;
+}
+
+void sogi_pll_reset(sogi_pll_t *pll)
+{
+    if (pll == NULL) return;
+
+    pll->v_alpha = 0.0f;
+    pll->v_beta = 0.0f;
+    pll->v1 = pll->v2 = 0.0f;
+    pll->va2 = pll->vb2 = 0.0f;
+    pll->theta = 0.0f;
+    pll->w = pll->w_nom;
+    pll->integrator = 0.0f;
+    pll->amplitude = 0.0f;
+    pll->error_filt = 0.0f;
+    pll->lock_count = 0;
+    pll->locked = false;
+}
+
+void sogi_pll_set_gains(sogi_pll_t *pll, float k, float kp, float ki)
+{
+    if (pll == NULL) return;
+
+    pll->k = k;
+    pll->kp = kp;
+    pll->ki = ki;
+}
+
+/**
+ * @brief Run one sample (call at the control rate)
+ *
+ * @return Phase for the next sample (rad, 0..2*pi)
+ */
+float sogi_pll_update(sogi_pll_t *pll, float v)
+{
+    // SOGI at the PLL frequency (bilinear, coefficients follow w)
+    float wts = pll->w * pll->ts;
+    float x = 2.0f * pll->k * wts;
+    float y = wts * wts;
+    float inv = 1.0f / (x + y + 4.0f);
+    float b0 = x * inv;
+    float qb0 = pll->k * y * inv;
+    float a1 = 2.0f * (4.0f - y) * inv;
+    float a2 = (x - y - 4.0f) * inv;
+
+    float va = b0 * (v - pll->v2) + a1 * pll->v_alpha + a2 * pll->va2;
+    float vb = qb0 * (v + 2.0f * pll->v1 + pll->v2) + a1 * pll->v_beta + a2 * pll->vb2;
+    pll->v2 = pll->v1;
+    pll->v1 = v;
+    pll->va2 = pll->v_alpha;
+    pll->vb2 = pll->v_beta;
+    pll->v_alpha = va;
+    pll->v_beta = vb;
+
+    // Phase detector, normalized to the input amplitude
+    pll->amplitude = sqrtf(pll->v_alpha * pll->v_alpha + pll->v_beta * pll->v_beta);
+    float amp = (pll->amplitude > pll->v_min) ? pll->amplitude : pll->v_min;
+    float e = (pll->v_alpha * cosf(pll->theta) + pll->v_beta * sinf(pll->theta)) / amp;
+
+    // PI loop filter
+    pll->integrator += pll->ki * e * pll->ts;
+    float w = pll->w_nom + pll->integrator + pll->kp * e;
+    if (w < pll->w_min) {
+        w = pll->w_min;
+        pll->integrator = w - pll->w_nom - pll->kp * e;
+    } else if (w > pll->w_max) {
+        w = pll->w_max;
+        pll->integrator = w - pll->w_nom - pll->kp * e;
+    }
+    pll->w = w;
+
+    // Integrate phase
+    pll->theta += w * pll->ts;
+    if (pll->theta >= TWO_PI) {
+        pll->theta -= TWO_PI;
+    }
+
+    // Lock detection
+    pll->error_filt += (e - pll->error_filt) * (1.0f / 64.0f);
+    if (fabsf(pll->error_filt) < PLL_LOCK_THRESHOLD && pll->amplitude > pll->v_min) {
+        if (pll->lock_count < pll->lock_samples) {
+            pll->lock_count++;
+        } else {
+            pll->locked = true;
+        }
+    } else if (fabsf(pll->error_filt) > 2.0f * PLL_LOCK_THRESHOLD || pll->amplitude <= pll->v_min) {
+        pll->lock_count = 0;
+        pll->locked = false;
+    }
+
+    return pll->theta;
+}
+
+float sogi_pll_get_frequency(const sogi_pll_t *pll)
+{
+    return pll->w / TWO_PI;
+}
+
+uint32_t sogi_pll_get_phase_u32(const sogi_pll_t *pll)
+{
+    return (uint32_t)(pll->theta * (PHASE_PER_CYCLE / TWO_PI));
+}
+
+bool sogi_pll_is_locked(const sogi_pll_t *pll)
+{
+    return pll->locked;
+}
+
+/*---------------------------------------------------------------------------
+ * Fixed-point variant
+ *-------------------------------------------------------------------------*/
+
+/* 1/d in Q30 for d in Q28 around 4 (Newton-Raphson, no divide) */
+static int64_t recip_q30(int64_t d_q28)
+{
+    int64_t r = 1LL << 28;                                    // 0.25
+    for (int i = 0; i < 3; i++) {
+        int64_t dr = (d_q28 * r) >> 28;                       // Q30
+        r = (r * ((2LL << 30) - dr)) >> 30;
+    }
+    return r;
+}
+
+/* Q15 sine of a 32-bit phase, linear interpolation between table entries */
+int16_t sogi_pll_q_sin(uint32_t phase)
+{
+    uint32_t idx = phase >> (32 - SIN_TABLE_BITS);
+    int32_t frac = (int32_t)((phase >> (16 - SIN_TABLE_BITS)) & 0xFFFF);
+    int32_t a = sin_table_q15[idx];
+    int32_t b = sin_table_q15[idx + 1];
+    return (int16_t)(a + (((b - a) * frac) >> 16));
+}
+
+int sogi_pll_q_init(sogi_pll_q_t *pll, float sample_freq_hz, float nominal_freq_hz)
+{
+    if (pll == NULL || sample_freq_hz <= 0.0f || nominal_freq_hz <= 0.0f ||
+        nominal_freq_hz * 4.0f > sample_freq_hz) {
+        return -1;
+    }
+
+    if (!sin_table_ready) {
+        for (int i = 0; i <= SIN_TABLE_SIZE; i++) {
+            sin_table_q15[i] = (int16_t)lrintf(32767.0f * sinf(TWO_PI * i / SIN_TABLE_SIZE));
+        }
+        sin_table_ready = true;
+    }
+
+    memset(pll, 0, sizeof(sogi_pll_q_t));
+
+    float ts = 1.0f / sample_freq_hz;
+    float step = nominal_freq_hz / sample_freq_hz * PHASE_PER_CYCLE;
+
+    pll->sample_freq = sample_freq_hz;
+    pll->step_nom = (uint32_t)step;
+    pll->step_min = (uint32_t)(step * (1.0f - PLL_FREQ_RANGE));
+    pll->step_max = (uint32_t)(step * (1.0f + PLL_FREQ_RANGE));
+    pll->k_q12 = (int32_t)lrintf(SOGI_K_DEFAULT * 4096.0f);
+
+    // Error is Q24 rad: step change = e * K * Ts * 2^32/(2*pi) / 2^24
+    pll->kp_q16 = (int32_t)lrintf(PLL_KP_DEFAULT * ts * 16777216.0f / TWO_PI);
+    pll->ki_q32 = (int32_t)lrintf(PLL_KI_DEFAULT * ts * ts * 1099511627776.0f / TWO_PI);
+    pll->lock_threshold = (int32_t)(PLL_LOCK_THRESHOLD * 16777216.0f);
+    pll->v_min = (int32_t)(0.05f * 16777216.0f);
+    pll->lock_samples = (uint32_t)(PLL_LOCK_TIME_S * sample_freq_hz);
+
+    sogi_pll_q_reset(pll);
+
+    return 0;
+}
+
+void sogi_pll_q_reset(sogi_pll_q_t *pll)
+{
+    if (pll == NULL) return;
+
+    pll->v_alpha = 0;
+    pll->v_beta = 0;
+    pll->v1 = pll->v2 = 0;
+    pll->va2 = pll->vb2 = 0;
+    pll->phase = 0;
+    pll->step = pll->step_nom;
+    pll->integrator = 0;
+    pll->error_filt = 0;
+    pll->lock_count = 0;
+    pll->locked = false;
+}
+
+/**
+ * @brief Run one sample (call at the control rate)
+ *
+ * @param v_pu Input in per-unit Q14 (16384 = nominal peak)
+ * @return Phase for the next sample (2^32 = 2*pi)
+ */
+uint32_t sogi_pll_q_update(sogi_pll_q_t *pll, int16_t v_pu)
+{
+    // w*Ts in Q24 from the phase step: step * 2*pi / 2^32 * 2^24
+    int64_t wts = (int64_t)(((uint64_t)pll->step * 411775u) >> 24);
+
+    // Bilinear SOGI coefficients (Q30)
+    int64_t x = ((int64_t)pll->k_q12 * wts) >> 5;            // 2*k*wTs
+    int64_t y = (wts * wts) >> 18;                            // (wTs)^2
+    int64_t inv = recip_q30((x + y + (4LL << 30)) >> 2);      // 1/(x+y+4)
+    int64_t b0 = (x * inv) >> 30;
+    int64_t qb0 = ((((int64_t)pll->k_q12 * y) >> 12) * inv) >> 30;
+    int64_t a1 = ((((4LL << 30) - y) * inv) >> 29);
+    int64_t a2 = ((x - y - (4LL << 30)) * inv) >> 30;
+
+    // SOGI (Q24)
+    int32_t v = (int32_t)v_pu << 10;
+    int32_t va = (int32_t)((b0 * (v - pll->v2) + a1 * pll->v_alpha + a2 * pll->va2) >> 30);
+    int32_t vb = (int32_t)((qb0 * ((int64_t)v + 2 * (int64_t)pll->v1 + pll->v2) +
+                            a1 * pll->v_beta + a2 * pll->vb2) >> 30);
+    pll->v2 = pll->v1;
+    pll->v1 = v;
+    pll->va2 = pll->v_alpha;
+    pll->vb2 = pll->v_beta;
+    pll->v_alpha = va;
+    pll->v_beta = vb;
+
+    // Phase detector (Q24, not normalized: input is per-unit)
+    int32_t s = sogi_pll_q_sin(pll->phase);
+    int32_t c = sogi_pll_q_sin(pll->phase + 0x40000000u);
+    int32_t e = (int32_t)(((int64_t)pll->v_alpha * c + (int64_t)pll->v_beta * s) >> 15);
+
+    // PI loop filter in phase step units
+    pll->integrator += (int64_t)e * pll->ki_q32;
+    int64_t step = (int64_t)pll->step_nom + (pll->integrator >> 32) +
+                   (((int64_t)e * pll->kp_q16) >> 16);
+    if (step < (int64_t)pll->step_min) {
+        step = pll->step_min;
+        pll->integrator = (step - (int64_t)pll->step_nom - (((int64_t)e * pll->kp_q16) >> 16)) << 32;
+    } else if (step > (int64_t)pll->step_max) {
+        step = pll->step_max;
+        pll->integrator = (step - (int64_t)pll->step_nom - (((int64_t)e * pll->kp_q16) >> 16)) << 32;
+    }
+    pll->step = (uint32_t)step;
+
+    // Phase accumulator wraps naturally
+    pll->phase += pll->step;
+
+    // Lock detection
+    pll->error_filt += (e - pll->error_filt) >> 6;
+    int32_t ae = pll->error_filt < 0 ? -pll->error_filt : pll->error_filt;
+    bool present = (pll->v_alpha > pll->v_min || pll->v_alpha < -pll->v_min ||
+                    pll->v_beta > pll->v_min || pll->v_beta < -pll->v_min);
+    if (ae < pll->lock_threshold && present) {
+        if (pll->lock_count < pll->lock_samples) {
+            pll->lock_count++;
+        } else {
+            pll->locked = true;
+        }
+    } else if (ae > 2 * pll->lock_threshold || !present) {
+        pll->lock_count = 0;
+        pll->locked = false;
+    }
+
+    return pll->phase;
+}
+
+float sogi_pll_q_get_frequency(const sogi_pll_q_t *pll)
+{
+    return (float)pll->step * pll->sample_freq / PHASE_PER_CYCLE;
+}
+
+bool sogi_pll_q_is_locked(const sogi_pll_q_t *pll)
+{
+    return pll->locked;
+}
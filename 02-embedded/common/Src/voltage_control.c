@@ -0,0 +1,238 @@
+/**
+ * @file voltage_control.c
+ * @brief Cascaded RMS voltage / PR current control implementation
+ */
+
+#include "voltage_control.h"
+#include <math.h>
+#include <string.h>
+
+#define PHASE_TO_RAD    (2.0f * 3.14159265359f / 4294967296.0f)
+
+/*---------------------------------------------------------------------------
+ * PI
+ *-------------------------------------------------------------------------*/
+
+/**
+ * @param max Upper limit for this update (out_max or lower)
+ */
+static float pi_update(vc_pi_t *pi, float error, float max)
+{
+    float u = pi->kp * error + pi->integral;
+    float out = u;
+    if (out > max) out = max;
+    if (out < pi->out_min) out = pi->out_min;
+
+    // Back-calculation: the clamp bleeds the integrator towards the limit
+    pi->integral += pi->ts * (pi->ki * error + pi->kt * (out - u));
+    pi->error = error;
+    pi->output = out;
+
+    return out;
+}
+
+/**
+ * @brief New gains without a step in the output
+ *
+ * The integrator is in output units, so ki takes effect on new errors
+ * only; the proportional difference on the last error moves into it.
+ */
+static void pi_set_gains(vc_pi_t *pi, float kp, float ki)
+{
+    pi->integral += (pi->kp - kp) * pi->error;
+    pi->kp = kp;
+    pi->ki = ki;
+}
+
+/*---------------------------------------------------------------------------
+ * Cascade
+ *-------------------------------------------------------------------------*/
+
+int voltage_control_init(voltage_control_t *vc, float v_base, float v_rms_ref)
+{
+    if (vc == NULL || v_base <= 0.0f || v_rms_ref < 0.0f) return -1;
+
+    memset(vc, 0, sizeof(voltage_control_t));
+
+    vc->v_base = v_base;
+    vc->v_rms_ref = v_rms_ref;
+    vc->admittance = VC_ADMITTANCE_MIN;
+
+    // Outer loop, one update per output cycle
+    vc->pi.ts = 1.0f / PR_FUNDAMENTAL_FREQ;
+    vc->pi.out_min = 0.0f;
+    vc->pi.out_max = VC_I_AMP_MAX_DEFAULT;
+
+    // Inner loop, output per unit of v_base
+    pr_controller_init(&vc->pr, 0.0f, 0.0f, PR_WC_DEFAULT);
+    pr_controller_set_limits(&vc->pr, -1.0f, 1.0f);
+
+    voltage_control_set_gains(vc, VC_KP_V_DEFAULT, VC_KI_V_DEFAULT,
+                              VC_KP_I_DEFAULT, VC_KR_I_DEFAULT);
+    voltage_control_set_antiwindup(vc, true);
+
+    vc->initialized = true;
+
+    return 0;
+}
+
+void voltage_control_reset(voltage_control_t *vc)
+{
+    if (vc == NULL) return;
+
+    pr_controller_reset(&vc->pr);
+    vc->pi.integral = 0.0f;
+    vc->pi.error = 0.0f;
+    vc->pi.output = 0.0f;
+
+    vc->v_rms = 0.0f;
+    vc->i_rms = 0.0f;
+    vc->i_amp = 0.0f;
+    vc->i_ref = 0.0f;
+    vc->v_ref = 0.0f;
+    vc->sum_v2 = 0.0f;
+    vc->sum_i2 = 0.0f;
+    vc->samples = 0;
+    vc->last_phase = 0;
+    vc->cycles = 0;
+    vc->admittance = VC_ADMITTANCE_MIN;
+    vc->inner_saturated = false;
+    vc->active = false;
+}
+
+void voltage_control_set_reference(voltage_control_t *vc, float v_rms)
+{
+    if (vc == NULL || v_rms < 0.0f) return;
+
+    vc->v_rms_ref = v_rms;
+}
+
+/**
+ * @brief Set both loops' gains, bumpless
+ *
+ * @param kp_v Outer proportional gain (per unit of the load admittance)
+ * @param ki_v Outer integral gain (per unit of the load admittance, 1/s)
+ * @param kp_i Inner proportional gain (V per A)
+ * @param kr_i Inner resonant gain (V per A)
+ */
+void voltage_control_set_gains(voltage_control_t *vc, float kp_v, float ki_v, float kp_i, float kr_i)
+{
+    if (vc == NULL || kp_v < 0.0f || ki_v < 0.0f || kp_i < 0.0f || kr_i < 0.0f) return;
+
+    pi_set_gains(&vc->pi, kp_v, ki_v);
+
+    vc->kp_i = kp_i;
+    vc->kr_i = kr_i;
+    pr_controller_set_gains(&vc->pr, kp_i / vc->v_base, kr_i / vc->v_base);
+
+    // Keep the back-calculation gains matched to the new gains
+    if (vc->pi.kt > 0.0f || vc->pr.kt > 0.0f) {
+        voltage_control_set_antiwindup(vc, true);
+    }
+}
+
+void voltage_control_set_current_limit(voltage_control_t *vc, float i_amp_max)
+{
+    if (vc == NULL || i_amp_max <= 0.0f) return;
+
+    vc->pi.out_max = i_amp_max;
+}
+
+/**
+ * @brief Enable or disable back-calculation in both loops
+ *
+ * PI: kt = ki/kp (tracking time constant Ti), capped at one update per
+ * period. PR: Kt = 1/Kp, the error that would produce the excess.
+ */
+void voltage_control_set_antiwindup(voltage_control_t *vc, bool enable)
+{
+    if (vc == NULL) return;
+
+    float kt = 0.0f;
+    if (enable) {
+        kt = (vc->pi.kp > 0.0f) ? vc->pi.ki / vc->pi.kp : 1.0f / vc->pi.ts;
+        if (kt > 1.0f / vc->pi.ts) kt = 1.0f / vc->pi.ts;
+    }
+    vc->pi.kt = kt;
+
+    pr_controller_set_antiwindup(&vc->pr, (enable && vc->pr.kp > 0.0f) ? 1.0f / vc->pr.kp : 0.0f);
+}
+
+/**
+ * @brief Take over from an open-loop reference without a step
+ *
+ * Call in the period the loops take over, before voltage_control_update().
+ * The PR continues v_amplitude * sin(theta) from its states and the PI
+ * starts at the current amplitude measured over the last cycle.
+ *
+ * @param v_amplitude Open-loop reference amplitude (per unit, e.g. the MI)
+ * @param phase       Modulator phase of this period (2^32 = one cycle)
+ */
+void voltage_control_engage(voltage_control_t *vc, float v_amplitude, uint32_t phase)
+{
+    if (vc == NULL || !vc->initialized) return;
+
+    pr_controller_preset(&vc->pr, v_amplitude, (float)phase * PHASE_TO_RAD);
+
+    float i_amp = 1.41421356f * vc->i_rms;
+    if (i_amp > vc->pi.out_max) i_amp = vc->pi.out_max;
+    vc->pi.integral = i_amp;
+    vc->pi.error = 0.0f;
+    vc->pi.output = i_amp;
+    vc->i_amp = i_amp;
+
+    vc->active = true;
+}
+
+/**
+ * @brief One PWM period: measure, outer loop at the cycle boundary, inner loop
+ *
+ * @param v_meas Output voltage (V)
+ * @param i_meas Output (filter inductor) current (A)
+ * @param phase  Modulator phase of the period the result applies to
+ * @return Output voltage reference per unit of v_base (-1..+1),
+ *         0 while not engaged
+ */
+float voltage_control_update(voltage_control_t *vc, float v_meas, float i_meas, uint32_t phase)
+{
+    if (vc == NULL || !vc->initialized) return 0.0f;
+
+    // Cycle boundary: phase wrapped through the positive zero crossing
+    if (phase < vc->last_phase && vc->samples > 0) {
+        vc->v_rms = sqrtf(vc->sum_v2 / (float)vc->samples);
+        vc->i_rms = sqrtf(vc->sum_i2 / (float)vc->samples);
+        vc->sum_v2 = 0.0f;
+        vc->sum_i2 = 0.0f;
+        vc->samples = 0;
+        vc->cycles++;
+
+        // Load admittance, held while the output is too low to measure it
+        if (vc->v_rms > 0.2f * vc->v_rms_ref) {
+            vc->admittance = 1.41421356f * vc->i_rms / vc->v_rms;
+            if (vc->admittance < VC_ADMITTANCE_MIN) vc->admittance = VC_ADMITTANCE_MIN;
+        }
+
+        if (vc->active) {
+            // Inner loop at its voltage limit: the current it reached is
+            // the outer limit, so the PI does not wind up through it
+            float max = vc->pi.out_max;
+            float i_reached = 1.41421356f * vc->i_rms;
+            if (vc->inner_saturated && i_reached < max) max = i_reached;
+
+            vc->i_amp = pi_update(&vc->pi, (vc->v_rms_ref - vc->v_rms) * vc->admittance, max);
+        }
+        vc->inner_saturated = false;
+    }
+    vc->last_phase = phase;
+    vc->sum_v2 += v_meas * v_meas;
+    vc->sum_i2 += i_meas * i_meas;
+    vc->samples++;
+
+    if (!vc->active) return 0.0f;
+
+    vc->i_ref = vc->i_amp * sinf((float)phase * PHASE_TO_RAD);
+    vc->v_ref = pr_controller_update(&vc->pr, vc->i_ref, i_meas);
+    if (vc->pr.excess != 0.0f) vc->inner_saturated = true;
+
+    return vc->v_ref;
+}
@@ -3,7 +3,13 @@
  * @brief Sine wave reference generator using lookup table (LUT)
  *
  * Generates sinusoidal modulation reference for 5-level inverter.
- * Uses 256-entry LUT for one complete sine wave period.
+ * The sine comes from a quarter-wave table with linear interpolation
+ * (sine_quarter_lut below) instead of a full-wave table addressed by the
+ * truncated phase: 103 dB SFDR instead of 48 dB from the same 256 x 16
+ * memory. QUARTER_ADDR_WIDTH = 10 selects a 1024-entry block RAM table.
+ * The table read, interpolation and MI product are registered stages
+ * (no multiplier feeds sine_out directly): sine_out follows the phase
+ * accumulator by five clocks.
  *
  * Features:
  * - Programmable frequency (via phase accumulator)
@@ -35,7 +41,9 @@
 module sine_generator #(
     parameter DATA_WIDTH = 16,
     parameter PHASE_WIDTH = 32,
-    parameter LUT_ADDR_WIDTH = 8            // 256-entry LUT
+    parameter LUT_ADDR_WIDTH = 8,           // phase output width
+    parameter QUARTER_ADDR_WIDTH = 8,       // 256-entry quarter-wave sine table
+    parameter INTERP_BITS = 8               // Phase bits interpolated between entries
 )(
     input  wire                         clk,
     input  wire                         rst_n,
@@ -49,30 +57,31 @@ module sine_generator #(
     // Phase accumulator
     reg [PHASE_WIDTH-1:0] phase_acc;
 
-    // Use upper bits of phase accumulator as LUT address
+    // Upper bits of the phase accumulator
     assign phase = phase_acc[PHASE_WIDTH-1:PHASE_WIDTH-LUT_ADDR_WIDTH];
 
-    // Sine LUT (256 entries, 16-bit signed values)
-    // Values represent sine from 0 to 2π
-    reg signed [DATA_WIDTH-1:0] sine_lut [0:(1<<LUT_ADDR_WIDTH)-1];
+    // Interpolated sine of the phase (three clocks)
+    localparam TABLE_PHASE_WIDTH = QUARTER_ADDR_WIDTH + INTERP_BITS + 2;
 
-    // Scaled sine value
-    wire signed [2*DATA_WIDTH-1:0] sine_scaled;
+    wire signed [DATA_WIDTH-1:0] sine_value;
 
-    // Initialize LUT with sine values
-    integer i;
-    real pi = 3.14159265359;
-    real angle;
-    initial begin
-        for (i = 0; i < (1<<LUT_ADDR_WIDTH); i = i + 1) begin
-            angle = (2.0 * pi * i) / (1 << LUT_ADDR_WIDTH);
-            sine_lut[i] = $rtoi(32767.0 * $sin(angle));
-        end
-    end
+    sine_quarter_lut #(
+        .DATA_WIDTH     (DATA_WIDTH),
+        .ADDR_WIDTH     (QUARTER_ADDR_WIDTH),
+        .FRAC_WIDTH     (INTERP_BITS)
+    ) lut (
+        .clk            (clk),
+        .phase          (phase_acc[PHASE_WIDTH-1 -: TABLE_PHASE_WIDTH]),
+        .sine_out       (sine_value)
+    );
+
+    // Scale sine by modulation index, registered (DSP output register)
+    // sine_scaled = sine_value * modulation_index + 1/2 LSB of the result
+    localparam signed [2*DATA_WIDTH-1:0] ROUND = 1 << (DATA_WIDTH - 2);
+    reg signed [2*DATA_WIDTH-1:0] sine_scaled;
 
-    // Scale sine by modulation index
-    // sine_scaled = (sine_lut[phase] * modulation_index) / 32768
-    assign sine_scaled = sine_lut[phase] * $signed(modulation_index);
+    always @(posedge clk)
+        sine_scaled <= sine_value * $signed(modulation_index) + ROUND;
 
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
@@ -94,3 +103,102 @@ module sine_generator #(
     end
 
 endmodule
+
+
+/**
+ * Quarter-wave sine table with linear interpolation
+ *
+ * Stores sin(x) for the first quarter cycle only, 2^ADDR_WIDTH entries
+ * T[i] = round(32767 * sin(pi/2 * i / 2^ADDR_WIDTH)). The phase input is
+ * split as
+ *
+ *   [quadrant (2) | address (ADDR_WIDTH) | fraction (FRAC_WIDTH)]
+ *
+ * Odd quadrants run the table backwards (u -> 2^(ADDR+FRAC) - u, exact, so
+ * the peak lands on x = pi/2), quadrants 2 and 3 negate. Between two
+ * entries the output is T[a] + ((T[a+1] - T[a]) * frac + 1/2) / 2^FRAC,
+ * and the missing entry T[2^ADDR_WIDTH] (the peak) is the constant 32767.
+ *
+ * Three clocks from phase to sine_out: the two table reads, registered
+ * without reset so they map onto a dual-port block RAM (or registered
+ * distributed ROM for small tables), the slope x frac product with the
+ * rounding constant (one DSP, pre-adder for the slope), then the sum.
+ * Same module as 03-fpga/rtl/sine_generator.v; 06-tools/sine/sine_model.cpp
+ * is the bit-exact model.
+ *
+ * @param clk       Clock
+ * @param phase     Top ADDR_WIDTH + FRAC_WIDTH + 2 bits of the phase
+ * @param sine_out  Interpolated sine (-32767 to +32767)
+ */
+
+module sine_quarter_lut #(
+    parameter DATA_WIDTH = 16,
+    parameter ADDR_WIDTH = 8,               // 2^ADDR_WIDTH entries per quarter
+    parameter FRAC_WIDTH = 8                // Interpolated phase bits
+)(
+    input  wire                                 clk,
+    input  wire [ADDR_WIDTH+FRAC_WIDTH+1:0]     phase,
+    output reg  signed [DATA_WIDTH-1:0]         sine_out
+);
+
+    localparam ENTRIES = 1 << ADDR_WIDTH;
+    localparam U_WIDTH = ADDR_WIDTH + FRAC_WIDTH;     // Phase within a quadrant
+    localparam signed [DATA_WIDTH-1:0] PEAK = (1 << (DATA_WIDTH - 1)) - 1;
+
+    reg signed [DATA_WIDTH-1:0] lut [0:ENTRIES-1];
+
+    localparam real PI = 3.14159265359;
+
+    integer i;
+    initial begin
+        for (i = 0; i < ENTRIES; i = i + 1)
+            lut[i] = $rtoi(32767.0 * $sin(PI / 2.0 * i / ENTRIES) + 0.5);
+    end
+
+    // Fold the phase into the first quadrant: 0 <= u <= 2^U_WIDTH
+    wire [1:0]          quadrant = phase[U_WIDTH+1:U_WIDTH];
+    wire [U_WIDTH-1:0]  u_in = phase[U_WIDTH-1:0];
+    wire [U_WIDTH:0]    u = quadrant[0] ? ((1 << U_WIDTH) - u_in) : u_in;
+    wire [ADDR_WIDTH:0] index = u[U_WIDTH:FRAC_WIDTH];
+
+    // Index ENTRIES (and ENTRIES-1 + 1) is the peak, not in the table
+    wire [ADDR_WIDTH-1:0] addr0 = index[ADDR_WIDTH-1:0];
+    wire [ADDR_WIDTH-1:0] addr1 = addr0 + 1'b1;
+
+    // Stage 1: table reads
+    reg signed [DATA_WIDTH-1:0] y0, y1;
+    reg                         peak0, peak1;
+    reg [FRAC_WIDTH-1:0]        frac;
+    reg                         negate;
+
+    always @(posedge clk) begin
+        y0     <= lut[addr0];
+        y1     <= lut[addr1];
+        peak0  <= index[ADDR_WIDTH];
+        peak1  <= (index >= ENTRIES - 1);
+        frac   <= u[FRAC_WIDTH-1:0];
+        negate <= quadrant[1];
+    end
+
+    // Stage 2: (T[a+1] - T[a]) * frac + 1/2
+    localparam signed [DATA_WIDTH+FRAC_WIDTH+1:0] HALF = 1 << (FRAC_WIDTH - 1);
+
+    wire signed [DATA_WIDTH-1:0]            v0 = peak0 ? PEAK : y0;
+    wire signed [DATA_WIDTH-1:0]            v1 = peak1 ? PEAK : y1;
+    reg  signed [DATA_WIDTH+FRAC_WIDTH+1:0] step;
+    reg  signed [DATA_WIDTH-1:0]            base;
+    reg                                     negate_d;
+
+    always @(posedge clk) begin
+        step     <= (v1 - v0) * $signed({1'b0, frac}) + HALF;
+        base     <= v0;
+        negate_d <= negate;
+    end
+
+    // Stage 3: sum, then restore the sign
+    wire signed [DATA_WIDTH:0] interp = base + (step >>> FRAC_WIDTH);
+
+    always @(posedge clk)
+        sine_out <= negate_d ? -interp : interp;
+
+endmodule
@@ -24,6 +24,9 @@
 #define RAM_BASE        0x00010000  // 64 KB data RAM
 #define RAM_SIZE        0x00010000  // 64 KB
 
+#define TCM_BASE        0x00030000  // 4 KB tightly-coupled memory (core-local)
+#define TCM_SIZE        0x00001000  // 4 KB
+
 #define PERIPH_BASE     0x00020000  // Peripheral base address
 
 //=============================================================================
@@ -54,6 +57,10 @@
 #define UART_BASE       (PERIPH_BASE + 0x0500)
 #define UART_SIZE       0x00000100
 
+// IIR/PR Accelerator (Base: 0x00020600)
+#define IIR_BASE        (PERIPH_BASE + 0x0600)
+#define IIR_SIZE        0x00000100
+
 //=============================================================================
 // PWM Accelerator Registers
 //=============================================================================
@@ -88,24 +95,27 @@ typedef volatile struct {
     uint32_t DATA_CH1;      // 0x0C: Channel 1 data (DC Bus 2)
     uint32_t DATA_CH2;      // 0x10: Channel 2 data (AC Voltage)
     uint32_t DATA_CH3;      // 0x14: Channel 3 data (AC Current)
-    uint32_t FIFO_LEVEL;    // 0x18: FIFO fill level
-    uint32_t IRQ_EN;        // 0x1C: Interrupt enable
+    uint32_t SAMPLE_CNT;    // 0x18: Results of the IRQ channel
+    uint32_t CFG[4];        // 0x1C-0x28: Per-channel decimation config
 } adc_regs_t;
 
 #define ADC ((adc_regs_t*)ADC_BASE)
 
 // ADC Control register bits
 #define ADC_CTRL_ENABLE     (1 << 0)    // Enable ADC
-#define ADC_CTRL_FIFO_EN    (1 << 1)    // Enable FIFO
-#define ADC_CTRL_CONT       (1 << 2)    // Continuous conversion mode
+#define ADC_CTRL_IRQ_CH(ch) (((ch) & 0x3) << 4) // Channel that raises the IRQ
+
+// ADC CFG[ch] fields (writing restarts that channel's filters)
+#define ADC_CFG_DECIM_LOG2(k) ((k) & 0xF)        // CIC R = 2^k, k = 2..8
+#define ADC_CFG_ORDER(n)    (((n) & 0x7) << 4)   // CIC order 1..5
+#define ADC_CFG_COMP_EN     (1 << 8)    // CIC droop compensator
+#define ADC_CFG_HB_EN       (1 << 9)    // Half-band FIR, decimate by 2
 
 // ADC Status register bits
 #define ADC_STATUS_VALID_CH0  (1 << 0)  // Channel 0 data valid
 #define ADC_STATUS_VALID_CH1  (1 << 1)  // Channel 1 data valid
 #define ADC_STATUS_VALID_CH2  (1 << 2)  // Channel 2 data valid
 #define ADC_STATUS_VALID_CH3  (1 << 3)  // Channel 3 data valid
-#define ADC_STATUS_FIFO_FULL  (1 << 8)  // FIFO full
-#define ADC_STATUS_FIFO_EMPTY (1 << 9)  // FIFO empty
 
 //=============================================================================
 // Protection/Fault Registers
@@ -191,4 +201,109 @@ typedef volatile struct {
 #define UART_CTRL_TX_EN       (1 << 0)  // Enable transmitter
 #define UART_CTRL_RX_EN       (1 << 1)  // Enable receiver
 
+//=============================================================================
+// IIR/PR Accelerator Registers
+//=============================================================================
+
+#define IIR_MAX_STAGES      4
+
+typedef volatile struct {
+    int32_t B0;             // +0x00: Q4.28
+    int32_t B1;             // +0x04
+    int32_t B2;             // +0x08
+    int32_t A1;             // +0x0C (denominator 1 + a1 z^-1 + a2 z^-2)
+    int32_t A2;             // +0x10
+    uint32_t RESERVED[3];
+} iir_biquad_regs_t;
+
+typedef volatile struct {
+    uint32_t CTRL;          // 0x00: Control register
+    uint32_t STATUS;        // 0x04: Status register
+    uint32_t NSTAGES;       // 0x08: Active stages (0 = pass-through)
+    uint32_t OFFSET;        // 0x0C: ADC zero offset
+    int32_t  SETPOINT;      // 0x10: Constant reference (signed 16-bit)
+    int32_t  OUT_MIN;       // 0x14: Output lower clamp
+    int32_t  OUT_MAX;       // 0x18: Output upper clamp
+    int32_t  OUTPUT;        // 0x1C: Last output (read-only)
+    int32_t  INPUT;         // 0x20: Last stage-0 input (read-only)
+    uint32_t SAMPLE_CNT;    // 0x24: Completed updates (read-only)
+    uint32_t RESERVED[6];
+    iir_biquad_regs_t STAGE[IIR_MAX_STAGES];  // 0x40: Coefficients
+} iir_regs_t;
+
+#define IIR ((iir_regs_t*)IIR_BASE)
+
+// IIR Control register bits
+#define IIR_CTRL_ENABLE     (1 << 0)    // Run on every trigger
+#define IIR_CTRL_PWM_DRIVE  (1 << 1)    // Drive the PWM reference
+#define IIR_CTRL_TRIG_SYNC  (1 << 2)    // Trigger on carrier sync (else ADC)
+#define IIR_CTRL_REF_SINE   (1 << 3)    // Reference = PWM sine (else SETPOINT)
+#define IIR_CTRL_CHANNEL(n) (((n) & 3) << 4)
+#define IIR_CTRL_CLEAR      (1 << 6)    // Zero filter state
+
+// IIR Status register bits
+#define IIR_STATUS_BUSY     (1 << 0)
+#define IIR_STATUS_SAT      (1 << 1)    // Output clamped (W1C)
+#define IIR_STATUS_OVERRUN  (1 << 2)    // Trigger while busy (W1C)
+
+#define IIR_Q28(x)          ((int32_t)((x) * 268435456.0))
+
+//=============================================================================
+// Interrupts (custom core)
+//=============================================================================
+
+// Platform interrupt lines, mcause = 0x80000000 | IRQ_x.
+// With mtvec MODE=1 (vectored) line n jumps to mtvec_base + 4*n.
+#define IRQ_ADC             16          // ADC data ready (control loop)
+#define IRQ_PROT            17          // Protection fault
+#define IRQ_TIMER           18          // Timer compare
+#define IRQ_UART            19          // UART RX/TX
+
+#define CSR_MSTATUS         0x300
+#define CSR_MIE             0x304
+#define MSTATUS_MIE         (1 << 3)
+
+#define MTVEC_MODE_DIRECT   0x0
+#define MTVEC_MODE_VECTORED 0x1
+
+// Custom CSRs: 4-bit priority per line (higher wins, ties use the fixed
+// external > software > timer > line 31..16 order) and the fast-path mask.
+// A fast-path line that wins arbitration aborts an in-flight MUL/DIV.
+#define CSR_MIPRIO0         0x7C0       // Lines 0-7
+#define CSR_MIPRIO1         0x7C1       // Lines 8-15
+#define CSR_MIPRIO2         0x7C2       // Lines 16-23
+#define CSR_MIPRIO3         0x7C3       // Lines 24-31
+#define CSR_MIFAST          0x7C4
+
+#define IRQ_PRIO_SHIFT(n)   (((n) & 7) * 4)
+
+#define csr_write(csr, val) \
+    __asm__ volatile ("csrw %0, %1" :: "i"(csr), "r"(val))
+#define csr_set(csr, val) \
+    __asm__ volatile ("csrs %0, %1" :: "i"(csr), "r"(val))
+
+//=============================================================================
+// Tightly-Coupled Memory and Performance Counters
+//=============================================================================
+
+// Place hot ISR state/code in the zero-wait-state TCM. startup.S copies
+// both sections from their load image before main() runs.
+#define TCM_DATA            __attribute__((section(".tcm_data")))
+#define TCM_TEXT            __attribute__((section(".tcm_text"), noinline))
+
+#define CSR_MCYCLE          0xB00
+#define CSR_MINSTRET        0xB02
+
+static inline uint32_t read_mcycle(void) {
+    uint32_t v;
+    __asm__ volatile ("csrr %0, mcycle" : "=r"(v));
+    return v;
+}
+
+static inline uint32_t read_minstret(void) {
+    uint32_t v;
+    __asm__ volatile ("csrr %0, minstret" : "=r"(v));
+    return v;
+}
+
 #endif // MEMORY_MAP_H
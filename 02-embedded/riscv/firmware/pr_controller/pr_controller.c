@@ -13,13 +13,28 @@
         : "r"(angle) \
     )
 
+// PR loop cost in core cycles (mcycle), kept in the TCM so the
+// bookkeeping itself does not add bus wait states. Inspect from the
+// debugger/testbench: last = most recent call, max = worst case seen,
+// image/tcm = one call of the same loop from .text and from .tcm_text,
+// measured once at boot.
+typedef struct {
+    uint32_t last;
+    uint32_t max;
+    uint32_t count;
+    uint32_t image;
+    uint32_t tcm;
+} pr_perf_t;
+
+TCM_DATA pr_perf_t pr_perf;
+
 void init_pwm() {
     // Configure PWM accelerator for CPU-provided reference mode
     // Bit 0: enable, Bit 1: mode (0=auto, 1=cpu)
     PWM->CTRL = (1 << 1) | (1 << 0);
 }
 
-void pr_controller_run() {
+static inline __attribute__((always_inline)) void pr_controller_step(void) {
     // 1. Read ADC value (AC Current)
     int32_t current_meas = ADC->DATA_CH3;
 
@@ -39,14 +54,51 @@ void pr_controller_run() {
     PWM->CPU_REFERENCE = error;
 }
 
+TCM_TEXT void pr_controller_run() {
+    pr_controller_step();
+}
+
+// Same loop left in .text, for the boot-time comparison only
+static __attribute__((noinline)) void pr_controller_run_image(void) {
+    pr_controller_step();
+}
+
+static uint32_t pr_measure(void (*run)(void)) {
+    uint32_t start = read_mcycle();
+    run();
+    return read_mcycle() - start;
+}
+
+// ADC data-ready is the control-loop interrupt: vector 16, highest
+// priority and on the fast-path so it never waits behind a DIV.
+void __attribute__((interrupt("machine"))) adc_isr(void) {
+    uint32_t start = read_mcycle();
+    pr_controller_run();
+    uint32_t cycles = read_mcycle() - start;
+
+    pr_perf.last = cycles;
+    if (cycles > pr_perf.max) {
+        pr_perf.max = cycles;
+    }
+    pr_perf.count++;
+}
+
 int main() {
+    // Before the PWM is enabled: the CPU_REFERENCE writes go nowhere
+    pr_perf.image = pr_measure(pr_controller_run_image);
+    pr_perf.tcm = pr_measure(pr_controller_run);
+
     init_pwm();
-    // TODO: Initialize other peripherals (ADC, Timer for interrupt)
-    
+
+    // Enable ADC and route its data-ready line at top priority
+    ADC->CTRL = ADC_CTRL_ENABLE;
+    csr_write(CSR_MIPRIO2, 0xFu << IRQ_PRIO_SHIFT(IRQ_ADC));
+    csr_write(CSR_MIFAST, 1u << IRQ_ADC);
+    csr_set(CSR_MIE, 1u << IRQ_ADC);
+    csr_set(CSR_MSTATUS, MSTATUS_MIE);
+
     while (1) {
-        // Run the control loop continuously
-        pr_controller_run();
-        // In a real system, this would be triggered by a timer interrupt
+        // Control loop runs in adc_isr() at the ADC output rate
     }
 
     return 0;
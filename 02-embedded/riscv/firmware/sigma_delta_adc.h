@@ -3,13 +3,15 @@
  * @brief Sigma-Delta ADC Driver for RISC-V SoC
  *
  * Driver for 4-channel integrated Sigma-Delta ADC peripheral.
- * Provides high-resolution (12-14 bit ENOB) analog-to-digital conversion
- * at 10 kHz sampling rate per channel.
+ * Each channel trades latency for resolution through its own decimation
+ * setting: 15.625 kHz after reset, from 250 kHz (fast current loop) down
+ * to 1.95 kHz (high-resolution DC bus measurement).
  *
  * Hardware Configuration:
  * - 4 independent ADC channels
- * - 1 MHz oversampling (100× OSR)
- * - 3rd-order CIC decimation filters
+ * - 1 MHz oversampling
+ * - Per channel: CIC (order 1-5, R = 4..256), droop compensator,
+ *   half-band FIR (/2)
  * - External LM339 quad comparator interface
  * - RC filters for 1-bit DAC feedback
  *
@@ -27,6 +29,16 @@
  * 0x10: DATA_CH2    - Channel 2 ADC data [15:0]
  * 0x14: DATA_CH3    - Channel 3 ADC data [15:0]
  * 0x18: SAMPLE_CNT  - Sample counter (debug)
+ * 0x1C: CFG_CH0     - Channel 0 decimation configuration
+ * 0x20: CFG_CH1     - Channel 1 decimation configuration
+ * 0x24: CFG_CH2     - Channel 2 decimation configuration
+ * 0x28: CFG_CH3     - Channel 3 decimation configuration
+ *
+ * Typical settings (1st-order loop, sine at 80% of full scale; see
+ * sim/run_sigma_delta_test.sh):
+ *   k=2 N=3 comp hb   D=8     125 kHz     ~4 bit ENOB  (current loop)
+ *   k=5 N=3 comp hb   D=64    15.6 kHz    ~9 bit ENOB  (reset default)
+ *   k=8 N=5 comp hb   D=512   1.95 kHz   ~11 bit ENOB  (DC bus)
  *
  * @author Auto-generated for VexRISCV SoC
  * @date 2025-12-03
@@ -55,6 +67,7 @@
 #define ADC_DATA_CH2_OFFSET     0x10    // Channel 2 data
 #define ADC_DATA_CH3_OFFSET     0x14    // Channel 3 data
 #define ADC_SAMPLE_CNT_OFFSET   0x18    // Sample counter
+#define ADC_CFG_CH0_OFFSET      0x1C    // Channel 0 decimation config
 
 //==========================================================================
 // Register Addresses
@@ -67,12 +80,25 @@
 #define ADC_DATA_CH2    ((volatile uint32_t*)(SIGMA_DELTA_ADC_BASE + ADC_DATA_CH2_OFFSET))
 #define ADC_DATA_CH3    ((volatile uint32_t*)(SIGMA_DELTA_ADC_BASE + ADC_DATA_CH3_OFFSET))
 #define ADC_SAMPLE_CNT  ((volatile uint32_t*)(SIGMA_DELTA_ADC_BASE + ADC_SAMPLE_CNT_OFFSET))
+#define ADC_CFG_CH(ch)  ((volatile uint32_t*)(SIGMA_DELTA_ADC_BASE + ADC_CFG_CH0_OFFSET + 4 * (ch)))
 
 //==========================================================================
 // Control Register Bits
 //==========================================================================
 
 #define ADC_CTRL_ENABLE     (1 << 0)    // Enable ADC conversion
+#define ADC_CTRL_IRQ_CH(ch) (((ch) & 0x3) << 4) // Channel that raises the IRQ
+
+//==========================================================================
+// Decimation Configuration Bits (CFG_CHx)
+//==========================================================================
+
+#define ADC_CFG_DECIM_LOG2(k) ((k) & 0xF)        // CIC R = 2^k, k = 2..8
+#define ADC_CFG_ORDER(n)    (((n) & 0x7) << 4)   // CIC order 1..5
+#define ADC_CFG_COMP_EN     (1 << 8)    // CIC droop compensator
+#define ADC_CFG_HB_EN       (1 << 9)    // Half-band FIR, decimate by 2
+
+#define ADC_MOD_FREQ_HZ     1000000     // Modulator rate
 
 //==========================================================================
 // Status Register Bits
@@ -124,10 +150,40 @@ typedef enum {
  * @brief Initialize the Sigma-Delta ADC
  *
  * Enables the ADC peripheral and starts continuous conversion.
- * All 4 channels sample simultaneously at 10 kHz.
+ * All 4 channels run the reset configuration (15.625 kHz); the IRQ
+ * follows channel 3 (AC current).
  */
 static inline void adc_init(void) {
-    *ADC_CTRL = ADC_CTRL_ENABLE;
+    *ADC_CTRL = ADC_CTRL_ENABLE | ADC_CTRL_IRQ_CH(ADC_CHANNEL_AC_CURR);
+}
+
+/**
+ * @brief Set a channel's decimation chain
+ *
+ * Restarts the channel's filters; the first results after the change
+ * carry the filter transient.
+ *
+ * @param channel    ADC channel (0-3)
+ * @param decim_log2 CIC decimation R = 2^decim_log2 (2-8)
+ * @param order      CIC order (1-5)
+ * @param cfg_flags  ADC_CFG_COMP_EN and/or ADC_CFG_HB_EN
+ */
+static inline void adc_configure(adc_channel_t channel, uint32_t decim_log2,
+                                 uint32_t order, uint32_t cfg_flags) {
+    *ADC_CFG_CH(channel) = ADC_CFG_DECIM_LOG2(decim_log2) |
+                           ADC_CFG_ORDER(order) | cfg_flags;
+}
+
+/**
+ * @brief Output rate of a channel
+ *
+ * @param channel ADC channel (0-3)
+ * @return Samples per second
+ */
+static inline uint32_t adc_sample_rate_hz(adc_channel_t channel) {
+    uint32_t cfg = *ADC_CFG_CH(channel);
+    uint32_t shift = (cfg & 0xF) + ((cfg & ADC_CFG_HB_EN) ? 1 : 0);
+    return ADC_MOD_FREQ_HZ >> shift;
 }
 
 /**
@@ -252,8 +308,8 @@ void main(void) {
             // Calculate power, etc...
         }
 
-        // Small delay (ADC samples at 10 kHz = 100 µs period)
-        delay_us(100);
+        // Small delay (ADC samples at 15.625 kHz = 64 µs period)
+        delay_us(64);
     }
 }
 
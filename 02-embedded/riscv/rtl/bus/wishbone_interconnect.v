@@ -14,6 +14,7 @@
  * 0x0002_0300 - 0x0002_03FF : Timer
  * 0x0002_0400 - 0x0002_04FF : GPIO
  * 0x0002_0500 - 0x0002_05FF : UART
+ * 0x0002_0600 - 0x0002_06FF : IIR/PR Accelerator
  *
  * Features:
  * - Simple priority-based arbitration (single master)
@@ -106,7 +107,16 @@ module wishbone_interconnect #(
     output wire [3:0]              uart_sel,
     output wire                    uart_stb,
     input  wire [DATA_WIDTH-1:0]   uart_dat_o,
-    input  wire                    uart_ack
+    input  wire                    uart_ack,
+
+    // Slave interface: IIR/PR Accelerator
+    output wire [7:0]              iir_addr,
+    output wire [DATA_WIDTH-1:0]   iir_dat_i,
+    output wire                    iir_we,
+    output wire [3:0]              iir_sel,
+    output wire                    iir_stb,
+    input  wire [DATA_WIDTH-1:0]   iir_dat_o,
+    input  wire                    iir_ack
 );
 
     //==========================================================================
@@ -132,6 +142,8 @@ module wishbone_interconnect #(
     localparam ADDR_GPIO_END  = 32'h0002_04FF;
     localparam ADDR_UART_BASE = 32'h0002_0500;
     localparam ADDR_UART_END  = 32'h0002_05FF;
+    localparam ADDR_IIR_BASE  = 32'h0002_0600;
+    localparam ADDR_IIR_END   = 32'h0002_06FF;
 
     // Chip select signals
     wire sel_rom   = (m_wb_addr >= ADDR_ROM_BASE)   && (m_wb_addr <= ADDR_ROM_END);
@@ -142,9 +154,10 @@ module wishbone_interconnect #(
     wire sel_timer = (m_wb_addr >= ADDR_TIMER_BASE) && (m_wb_addr <= ADDR_TIMER_END);
     wire sel_gpio  = (m_wb_addr >= ADDR_GPIO_BASE)  && (m_wb_addr <= ADDR_GPIO_END);
     wire sel_uart  = (m_wb_addr >= ADDR_UART_BASE)  && (m_wb_addr <= ADDR_UART_END);
+    wire sel_iir   = (m_wb_addr >= ADDR_IIR_BASE)   && (m_wb_addr <= ADDR_IIR_END);
 
     // Error detection (unmapped address)
-    wire sel_error = !(sel_rom | sel_ram | sel_pwm | sel_adc | sel_prot | sel_timer | sel_gpio | sel_uart);
+    wire sel_error = !(sel_rom | sel_ram | sel_pwm | sel_adc | sel_prot | sel_timer | sel_gpio | sel_uart | sel_iir);
 
     //==========================================================================
     // ROM Interface
@@ -223,6 +236,16 @@ module wishbone_interconnect #(
     assign uart_sel   = m_wb_sel;
     assign uart_stb   = m_wb_stb && m_wb_cyc && sel_uart;
 
+    //==========================================================================
+    // IIR/PR Accelerator Interface
+    //==========================================================================
+
+    assign iir_addr   = m_wb_addr[7:0];
+    assign iir_dat_i  = m_wb_dat_i;
+    assign iir_we     = m_wb_we;
+    assign iir_sel    = m_wb_sel;
+    assign iir_stb    = m_wb_stb && m_wb_cyc && sel_iir;
+
     //==========================================================================
     // Response Multiplexing
     //==========================================================================
@@ -258,6 +281,9 @@ module wishbone_interconnect #(
         end else if (sel_uart) begin
             m_wb_dat_o = uart_dat_o;
             m_wb_ack   = uart_ack;
+        end else if (sel_iir) begin
+            m_wb_dat_o = iir_dat_o;
+            m_wb_ack   = iir_ack;
         end else if (sel_error && m_wb_stb && m_wb_cyc) begin
             m_wb_err   = 1'b1;  // Bus error for unmapped address
         end
@@ -34,7 +34,8 @@ module csr_unit (
     input  wire [31:0] interrupts_i,  // Interrupt lines from peripherals
     output wire        interrupt_pending, // Any interrupt pending
     output wire        interrupt_enabled, // Global interrupt enable
-    output reg  [31:0] interrupt_cause,   // Which interrupt to service
+    output wire [31:0] interrupt_cause,   // Which interrupt to service
+    output wire        interrupt_fast,    // Pending interrupt may preempt MDU
 
     //==========================================================================
     // Performance Counters
@@ -59,6 +60,10 @@ module csr_unit (
     reg [31:0] mtval;      // Machine trap value
     reg [31:0] mip;        // Machine interrupt pending (read-only, reflects interrupts_i)
 
+    // Custom: interrupt priority and fast-path selection
+    reg [31:0] miprio [0:3]; // 4-bit priority per line, 8 lines per CSR
+    reg [31:0] mifast;       // Lines allowed to abort a multi-cycle MDU op
+
     // Machine Counters
     reg [63:0] mcycle;     // Cycle counter (64-bit)
     reg [63:0] minstret;   // Instructions retired counter (64-bit)
@@ -89,32 +94,47 @@ module csr_unit (
     // Interrupt Logic
     //==========================================================================
 
-    // Update mip based on external interrupt lines
+    // Update mip based on external interrupt lines.
+    // Platform lines (16-31) are often one-cycle strobes (ADC data ready),
+    // so they stay latched until their own trap is taken; a strobe landing
+    // mid-instruction is not lost. Level sources simply re-assert.
+    wire [31:0] mip_claim = (trap_entry && trap_cause[31]) ?
+                            (32'h1 << trap_cause[4:0]) : 32'h0;
+
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
             mip <= 32'h0;
         end else begin
-            mip <= interrupts_i;
+            mip[15:0]  <= interrupts_i[15:0];
+            mip[31:16] <= (mip[31:16] & ~mip_claim[31:16]) | interrupts_i[31:16];
         end
     end
 
-    // Determine if any interrupt is pending and enabled
-    wire [31:0] pending_and_enabled = mip & mie;
-    assign interrupt_pending = (|pending_and_enabled) && mie_bit;
+    // Priority resolution lives in interrupt_controller: per-line levels from
+    // miprio0..3, fixed external > software > timer > platform tie-break.
+    // Only the standard M-mode lines (3/7/11) and platform lines 16-31 route.
+    wire interrupt_req_w;
+
+    interrupt_controller intc (
+        .clk(clk),
+        .rst_n(rst_n),
+        .timer_int(mip[7]),
+        .external_int(mip[11]),
+        .software_int(mip[3]),
+        .peripheral_ints(mip[31:16]),
+        .global_int_en(mie_bit),
+        .mie(mie),
+        .int_priority({miprio[3], miprio[2], miprio[1], miprio[0]}),
+        .fast_mask(mifast),
+        .interrupt_lines(),
+        .interrupt_req(interrupt_req_w),
+        .interrupt_cause(interrupt_cause),
+        .interrupt_fast(interrupt_fast)
+    );
+
+    assign interrupt_pending = interrupt_req_w;
     assign interrupt_enabled = mie_bit;
 
-    // Priority encoder for interrupts (higher bit = higher priority)
-    // Standard RISC-V interrupt priority: external > software > timer
-    integer i;
-    always @(*) begin
-        interrupt_cause = 32'h0;
-        for (i = 31; i >= 0; i = i - 1) begin
-            if (pending_and_enabled[i]) begin
-                interrupt_cause = 32'h80000000 | i;  // Set bit 31 for interrupt
-            end
-        end
-    end
-
     //==========================================================================
     // Trap Vector Calculation
     //==========================================================================
@@ -185,6 +205,13 @@ module csr_unit (
             `CSR_INSTRET:    csr_rdata = minstret[31:0];
             `CSR_INSTRETH:   csr_rdata = minstret[63:32];
 
+            // Custom interrupt priority / fast-path
+            `CSR_MIPRIO0:    csr_rdata = miprio[0];
+            `CSR_MIPRIO1:    csr_rdata = miprio[1];
+            `CSR_MIPRIO2:    csr_rdata = miprio[2];
+            `CSR_MIPRIO3:    csr_rdata = miprio[3];
+            `CSR_MIFAST:     csr_rdata = mifast;
+
             // Invalid CSR
             default: begin
                 csr_rdata = 32'h0;
@@ -233,6 +260,11 @@ module csr_unit (
             mtval     <= 32'h0;
             mcycle    <= 64'h0;
             minstret  <= 64'h0;
+            miprio[0] <= 32'h0;
+            miprio[1] <= 32'h0;
+            miprio[2] <= 32'h0;
+            miprio[3] <= 32'h0;
+            mifast    <= 32'h0;
 
         end else begin
             // Update performance counters
@@ -286,6 +318,13 @@ module csr_unit (
                     `CSR_MINSTRET:  minstret[31:0] <= csr_wdata_final;
                     `CSR_MINSTRETH: minstret[63:32]<= csr_wdata_final;
 
+                    // Interrupt priority / fast-path
+                    `CSR_MIPRIO0:   miprio[0] <= csr_wdata_final;
+                    `CSR_MIPRIO1:   miprio[1] <= csr_wdata_final;
+                    `CSR_MIPRIO2:   miprio[2] <= csr_wdata_final;
+                    `CSR_MIPRIO3:   miprio[3] <= csr_wdata_final;
+                    `CSR_MIFAST:    mifast    <= csr_wdata_final;
+
                     // Read-only registers - ignore writes
                     default: ;
                 endcase
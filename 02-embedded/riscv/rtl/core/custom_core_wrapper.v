@@ -12,12 +12,23 @@
  * - No protocol conversion needed
  * - Clean and simple!
  *
+ * TIGHTLY-COUPLED MEMORY (TCM):
+ * - A 4 KB scratchpad (tcm_4kb.v) at TCM_BASE is decoded here, in front of
+ *   the SoC arbiter/interconnect, on both the data and instruction buses
+ * - Accesses that hit the TCM complete with zero wait states and never
+ *   appear on the external buses; everything else passes straight through
+ * - Firmware places hot ISR state/code there via .tcm_data / .tcm_text
+ *
  * @author Custom RISC-V Core Team
  * @date 2025-12-03
  * @version 0.2 - Approach 2: Passthrough Wrapper
  */
 
-module custom_core_wrapper (
+module custom_core_wrapper #(
+    parameter TCM_ENABLE = 1,                 // Instantiate the TCM
+    parameter TCM_BASE   = 32'h0003_0000,     // TCM base address (4 KB aligned)
+    parameter TCM_AW     = 12                 // TCM size = 2^TCM_AW bytes
+)(
     input  wire        clk,
     input  wire        rst_n,
 
@@ -67,6 +78,26 @@ module custom_core_wrapper (
      * This is the beauty of using standard Wishbone natively.
      */
 
+    //==========================================================================
+    // Core-Side Bus Signals
+    //==========================================================================
+
+    wire [31:0] cpu_ibus_addr;
+    wire [31:0] cpu_ibus_dat_i;
+    wire        cpu_ibus_cyc;
+    wire        cpu_ibus_stb;
+    wire        cpu_ibus_ack;
+
+    wire [31:0] cpu_dbus_addr;
+    wire [31:0] cpu_dbus_dat_o;
+    wire [31:0] cpu_dbus_dat_i;
+    wire        cpu_dbus_we;
+    wire [3:0]  cpu_dbus_sel;
+    wire        cpu_dbus_cyc;
+    wire        cpu_dbus_stb;
+    wire        cpu_dbus_ack;
+    wire        cpu_dbus_err;
+
     //==========================================================================
     // Custom Core Instantiation
     //==========================================================================
@@ -77,28 +108,94 @@ module custom_core_wrapper (
         .clk(clk),
         .rst_n(rst_n),
 
-        // Instruction Wishbone Bus - Direct connection!
-        .iwb_adr_o(ibus_addr),
-        .iwb_dat_i(ibus_dat_i),
-        .iwb_cyc_o(ibus_cyc),
-        .iwb_stb_o(ibus_stb),
-        .iwb_ack_i(ibus_ack),
-
-        // Data Wishbone Bus - Direct connection!
-        .dwb_adr_o(dbus_addr),
-        .dwb_dat_o(dbus_dat_o),
-        .dwb_dat_i(dbus_dat_i),
-        .dwb_we_o(dbus_we),
-        .dwb_sel_o(dbus_sel),
-        .dwb_cyc_o(dbus_cyc),
-        .dwb_stb_o(dbus_stb),
-        .dwb_ack_i(dbus_ack),
-        .dwb_err_i(dbus_err),
+        // Instruction Wishbone Bus - Via TCM decode
+        .iwb_adr_o(cpu_ibus_addr),
+        .iwb_dat_i(cpu_ibus_dat_i),
+        .iwb_cyc_o(cpu_ibus_cyc),
+        .iwb_stb_o(cpu_ibus_stb),
+        .iwb_ack_i(cpu_ibus_ack),
+
+        // Data Wishbone Bus - Via TCM decode
+        .dwb_adr_o(cpu_dbus_addr),
+        .dwb_dat_o(cpu_dbus_dat_o),
+        .dwb_dat_i(cpu_dbus_dat_i),
+        .dwb_we_o(cpu_dbus_we),
+        .dwb_sel_o(cpu_dbus_sel),
+        .dwb_cyc_o(cpu_dbus_cyc),
+        .dwb_stb_o(cpu_dbus_stb),
+        .dwb_ack_i(cpu_dbus_ack),
+        .dwb_err_i(cpu_dbus_err),
 
         // Interrupts
         .interrupts(external_interrupt)
     );
 
+    //==========================================================================
+    // Tightly-Coupled Memory Decode
+    //==========================================================================
+
+    /**
+     * The core registers its bus address at the start of an access, so the
+     * hit decode below is stable for the whole cycle. A TCM hit acks in the
+     * same cycle (see tcm_4kb.v); a miss is passed to the SoC untouched.
+     */
+
+    wire [31:0] tcm_mask = ~((32'h1 << TCM_AW) - 32'h1);
+
+    wire ibus_tcm_hit = (TCM_ENABLE != 0) &&
+                        ((cpu_ibus_addr & tcm_mask) == TCM_BASE);
+    wire dbus_tcm_hit = (TCM_ENABLE != 0) &&
+                        ((cpu_dbus_addr & tcm_mask) == TCM_BASE);
+
+    wire [31:0] tcm_i_dat;
+    wire [31:0] tcm_d_dat;
+    wire        tcm_i_ack;
+    wire        tcm_d_ack;
+
+    generate
+        if (TCM_ENABLE != 0) begin : g_tcm
+            tcm_4kb #(
+                .ADDR_WIDTH(TCM_AW)
+            ) tcm (
+                .clk(clk),
+                .d_addr(cpu_dbus_addr[TCM_AW-1:0]),
+                .d_data_in(cpu_dbus_dat_o),
+                .d_we(cpu_dbus_we),
+                .d_be(cpu_dbus_sel),
+                .d_stb(cpu_dbus_cyc && cpu_dbus_stb && dbus_tcm_hit),
+                .d_data_out(tcm_d_dat),
+                .d_ack(tcm_d_ack),
+                .i_addr(cpu_ibus_addr[TCM_AW-1:0]),
+                .i_stb(cpu_ibus_cyc && cpu_ibus_stb && ibus_tcm_hit),
+                .i_data_out(tcm_i_dat),
+                .i_ack(tcm_i_ack)
+            );
+        end else begin : g_no_tcm
+            assign tcm_i_dat = 32'h0;
+            assign tcm_d_dat = 32'h0;
+            assign tcm_i_ack = 1'b0;
+            assign tcm_d_ack = 1'b0;
+        end
+    endgenerate
+
+    // Instruction bus: TCM hits stay local
+    assign ibus_addr      = cpu_ibus_addr;
+    assign ibus_cyc       = cpu_ibus_cyc && !ibus_tcm_hit;
+    assign ibus_stb       = cpu_ibus_stb && !ibus_tcm_hit;
+    assign cpu_ibus_dat_i = ibus_tcm_hit ? tcm_i_dat : ibus_dat_i;
+    assign cpu_ibus_ack   = ibus_tcm_hit ? tcm_i_ack : ibus_ack;
+
+    // Data bus: TCM hits stay local
+    assign dbus_addr      = cpu_dbus_addr;
+    assign dbus_dat_o     = cpu_dbus_dat_o;
+    assign dbus_we        = cpu_dbus_we;
+    assign dbus_sel       = cpu_dbus_sel;
+    assign dbus_cyc       = cpu_dbus_cyc && !dbus_tcm_hit;
+    assign dbus_stb       = cpu_dbus_stb && !dbus_tcm_hit;
+    assign cpu_dbus_dat_i = dbus_tcm_hit ? tcm_d_dat : dbus_dat_i;
+    assign cpu_dbus_ack   = dbus_tcm_hit ? tcm_d_ack : dbus_ack;
+    assign cpu_dbus_err   = dbus_tcm_hit ? 1'b0      : dbus_err;
+
     //==========================================================================
     // That's it! No conversion logic needed for Approach 2.
     //==========================================================================
@@ -125,6 +222,8 @@ module custom_core_wrapper (
         $display("  - Just ~5 lines of wire connections");
         $display("  - Clean and easy to understand");
         $display("  - Zero latency overhead");
+        if (TCM_ENABLE != 0)
+            $display("  - %0d-byte TCM at 0x%08h (zero wait states)", (1 << TCM_AW), TCM_BASE);
         $display("");
         $display("The core (custom_riscv_core.v) uses native Wishbone,");
         $display("so this wrapper is just a passthrough module.");
@@ -176,6 +176,7 @@ module custom_riscv_core #(
     localparam STATE_ZPEC      = 3'd7;
 `endif
     reg         mdu_start;
+    reg         mdu_abort;
     wire        mdu_busy;
     wire        mdu_done;
     wire [63:0] mdu_product;
@@ -213,6 +214,7 @@ module custom_riscv_core #(
     wire        interrupt_pending;
     wire        interrupt_enabled;
     wire [31:0] interrupt_cause;
+    wire        interrupt_fast;     // Winner is in mifast: may abort MULDIV
 
     // interrupt_req is just interrupt_pending (CSR unit handles enable checking)
     wire        interrupt_req = interrupt_pending;
@@ -327,6 +329,7 @@ module custom_riscv_core #(
             dwb_cyc_reg <= 1'b0;
             dwb_stb_reg <= 1'b0;
             mdu_start <= 1'b0;
+            mdu_abort <= 1'b0;
             mdu_result_reg <= 32'd0;
             mdu_pending <= 2'd0;
             mem_data_reg <= 32'd0;
@@ -341,7 +344,9 @@ module custom_riscv_core #(
                 // Clear trap_return flag if it was set
                 trap_return <= 1'b0;
 
-                if (interrupt_req && !stall) begin
+                // Only take the interrupt before a fetch is issued, never
+                // while iwb_cyc is already asserted for this PC
+                if (interrupt_req && !stall && !iwb_cyc_reg) begin
                     trap_entry <= 1'b1;
                     trap_pc <= pc;
                     trap_cause <= interrupt_cause;
@@ -442,6 +447,7 @@ module custom_riscv_core #(
                 // Jump to trap handler
                 pc <= trap_vector;
                 trap_entry <= 1'b0;
+                mdu_abort <= 1'b0;
                 state <= STATE_FETCH;
             end
 
@@ -461,8 +467,19 @@ module custom_riscv_core #(
                     // Clear one-cycle start pulse
                     mdu_start <= 1'b0;
 
-                    // Wait for MDU completion
-                    if (mdu_done) begin
+                    // Interrupt fast-path: a divide can hold the core for
+                    // ~35 cycles. Nothing has been written back yet, so drop
+                    // the MDU op and trap with mepc = this instruction; it is
+                    // simply re-executed after MRET.
+                    if (interrupt_req && interrupt_fast) begin
+                        mdu_abort <= 1'b1;
+                        mdu_pending <= 2'd0;
+                        trap_entry <= 1'b1;
+                        trap_pc <= pc;
+                        trap_cause <= interrupt_cause;
+                        trap_val <= 32'h0;
+                        state <= STATE_TRAP;
+                    end else if (mdu_done) begin
                         // Pulse seen: wait one cycle for MDU outputs to be stable (avoid non-blocking update race)
                         mdu_pending <= 2'd1;
                         state <= STATE_MULDIV;
@@ -680,6 +697,7 @@ module custom_riscv_core #(
         .interrupt_pending(interrupt_pending),
         .interrupt_enabled(interrupt_enabled),
         .interrupt_cause(interrupt_cause),
+        .interrupt_fast(interrupt_fast),
 
         // Performance Counters
         .instr_retired(instr_retired)
@@ -712,6 +730,7 @@ module custom_riscv_core #(
         .clk(clk),
         .rst_n(rst_n),
         .start(mdu_start),
+        .abort(mdu_abort),
         .funct3(funct3),
         .a(rs1_data),
         .b(rs2_data),
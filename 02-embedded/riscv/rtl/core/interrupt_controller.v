@@ -19,6 +19,8 @@ module interrupt_controller (
 
     input  wire        global_int_en,   // mstatus.MIE
     input  wire [31:0] mie,             // Which interrupts are enabled
+    input  wire [127:0] int_priority,   // 4-bit priority per line (miprio0..3)
+    input  wire [31:0] fast_mask,       // Lines allowed to preempt (mifast)
 
     //==========================================================================
     // To CSR Unit
@@ -31,7 +33,8 @@ module interrupt_controller (
     //==========================================================================
 
     output reg         interrupt_req,   // Interrupt request to core
-    output reg  [31:0] interrupt_cause  // Which interrupt (for mcause)
+    output reg  [31:0] interrupt_cause, // Which interrupt (for mcause)
+    output reg         interrupt_fast   // Winner may abort a multi-cycle op
 );
 
     // Standard RISC-V interrupt bit positions:
@@ -52,37 +55,54 @@ module interrupt_controller (
     // Determine which interrupts are both pending and enabled
     wire [31:0] pending_and_enabled = interrupt_lines & mie;
 
-    // Priority encoder: select highest priority interrupt
+    // Tie-break order used when two lines share the same priority level:
+    // rank 0 = external (11), 1 = software (3), 2 = timer (7),
+    // rank 3..18 = platform lines 31 down to 16.
+    function [4:0] line_at_rank;
+        input [4:0] rank;
+        begin
+            case (rank)
+                5'd0:    line_at_rank = 5'd11;
+                5'd1:    line_at_rank = 5'd3;
+                5'd2:    line_at_rank = 5'd7;
+                default: line_at_rank = 5'd31 - (rank - 5'd3);
+            endcase
+        end
+    endfunction
+
+    // Priority encoder: highest programmed level wins, equal levels fall
+    // back to the fixed order above. With all levels at 0 (reset) this is
+    // exactly the original external > software > timer > platform order.
+    integer    r;
+    reg [4:0]  line;
+    reg [4:0]  best_line;
+    reg [3:0]  best_level;
+    reg        found;
+
     always @(*) begin
         interrupt_req = 1'b0;
         interrupt_cause = 32'h0;
+        interrupt_fast = 1'b0;
+
+        found = 1'b0;
+        best_line = 5'd0;
+        best_level = 4'd0;
+
+        for (r = 0; r < 19; r = r + 1) begin
+            line = line_at_rank(r[4:0]);
+            if (pending_and_enabled[line] &&
+                (!found || (int_priority[line*4 +: 4] > best_level))) begin
+                found = 1'b1;
+                best_line = line;
+                best_level = int_priority[line*4 +: 4];
+            end
+        end
 
-        if (global_int_en && (|pending_and_enabled)) begin
+        if (global_int_en && found) begin
             interrupt_req = 1'b1;
-
-            // Priority order (high to low):
-            // 1. Machine external interrupt (bit 11)
-            // 2. Machine software interrupt (bit 3)
-            // 3. Machine timer interrupt (bit 7)
-            // 4. Platform-specific (bits 16-31)
-
-            if (pending_and_enabled[11]) begin
-                interrupt_cause = `MCAUSE_EXTERNAL_INT;  // 0x8000000B
-            end else if (pending_and_enabled[3]) begin
-                interrupt_cause = `MCAUSE_SOFTWARE_INT;  // 0x80000003
-            end else if (pending_and_enabled[7]) begin
-                interrupt_cause = `MCAUSE_TIMER_INT;     // 0x80000007
-            end else begin
-                // Find first set bit in platform-specific range
-                integer i;
-                for (i = 31; i >= 16; i = i - 1) begin
-                    if (pending_and_enabled[i]) begin
-                        interrupt_cause = 32'h80000000 | i;
-                        i=-1; // Break the loop
-                    end
-                end
-            end
+            interrupt_cause = 32'h80000000 | {27'd0, best_line};
+            interrupt_fast = fast_mask[best_line];
         end
     end
 
-endmodule
\ No newline at end of file
+endmodule
@@ -4,6 +4,7 @@ module mdu (
     input  wire        clk,
     input  wire        rst_n,
     input  wire        start,
+    input  wire        abort,      // drop the in-flight op (interrupt fast-path)
     input  wire [2:0]  funct3,     // operation select (MUL/DIV/REM variants)
     input  wire [31:0] a,
     input  wire [31:0] b,
@@ -219,6 +220,14 @@ module mdu (
             if (done) begin
                 done <= 1'b0;
             end
+
+            // abort overrides everything: the core re-executes the
+            // instruction after the trap returns, so no result is needed
+            if (abort) begin
+                state <= IDLE;
+                busy <= 1'b0;
+                done <= 1'b0;
+            end
         end
     end
 
@@ -194,6 +194,13 @@
 `define CSR_TIMEH         12'hC81  // Timer (upper 32 bits)
 `define CSR_INSTRETH      12'hC82  // Instructions retired (upper 32 bits)
 
+// Custom Machine CSRs (0x7C0-0x7FF custom read/write space)
+`define CSR_MIPRIO0       12'h7C0  // Interrupt priority, lines 0-7 (4 bits each)
+`define CSR_MIPRIO1       12'h7C1  // Interrupt priority, lines 8-15
+`define CSR_MIPRIO2       12'h7C2  // Interrupt priority, lines 16-23
+`define CSR_MIPRIO3       12'h7C3  // Interrupt priority, lines 24-31
+`define CSR_MIFAST        12'h7C4  // Fast-path lines (may abort MDU ops)
+
 //==========================================================================
 // mstatus Register Bit Positions
 //==========================================================================
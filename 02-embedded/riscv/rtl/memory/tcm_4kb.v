@@ -0,0 +1,83 @@
+/**
+ * @file tcm_4kb.v
+ * @brief 4 KB Tightly-Coupled Memory for the control loop
+ *
+ * Zero-wait-state scratchpad attached directly to the core's buses inside
+ * custom_core_wrapper.v, in front of the arbiter and interconnect. Used for
+ * the ISR's hot state (.tcm_data) and optionally its code (.tcm_text).
+ *
+ * Address space: 0x00030000 - 0x00030FFF (4 KB, decoded by the wrapper)
+ * Organization: 1K words x 32 bits
+ *
+ * Ports:
+ * - Data port (read/write, byte enables) - wired to the core's dbus
+ * - Instruction port (read-only)         - wired to the core's ibus
+ *
+ * Both ports read combinationally and ack in the same cycle as the strobe,
+ * so a load or store finishes in the cycle after the core asserts cyc,
+ * instead of waiting for the arbiter grant plus a registered RAM ack.
+ * Writes land on the clock edge that ends the access.
+ *
+ * Technology notes:
+ * - FPGA: Small enough for distributed (LUT) RAM with async read
+ * - ASIC: Flop/latch array or a register-file macro with async read
+ */
+
+module tcm_4kb #(
+    parameter ADDR_WIDTH = 12,     // 4KB = 2^12 bytes
+    parameter DATA_WIDTH = 32
+)(
+    input  wire                    clk,
+
+    // Data port (from core dbus)
+    input  wire [ADDR_WIDTH-1:0]   d_addr,      // Byte address
+    input  wire [DATA_WIDTH-1:0]   d_data_in,
+    input  wire                    d_we,        // Write enable
+    input  wire [3:0]              d_be,        // Byte enable
+    input  wire                    d_stb,       // Wishbone strobe (cyc & stb & hit)
+    output wire [DATA_WIDTH-1:0]   d_data_out,
+    output wire                    d_ack,
+
+    // Instruction port (from core ibus)
+    input  wire [ADDR_WIDTH-1:0]   i_addr,      // Byte address
+    input  wire                    i_stb,       // Wishbone strobe (cyc & stb & hit)
+    output wire [DATA_WIDTH-1:0]   i_data_out,
+    output wire                    i_ack
+);
+
+    // Memory array: 1K words x 32 bits = 4 KB
+    localparam MEM_DEPTH = (1 << (ADDR_WIDTH - 2));
+
+    reg [DATA_WIDTH-1:0] tcm_memory [0:MEM_DEPTH-1];
+
+    // Word addresses
+    wire [ADDR_WIDTH-3:0] d_word_addr = d_addr[ADDR_WIDTH-1:2];
+    wire [ADDR_WIDTH-3:0] i_word_addr = i_addr[ADDR_WIDTH-1:2];
+
+    // Write with byte enables
+    always @(posedge clk) begin
+        if (d_stb && d_we) begin
+            if (d_be[0]) tcm_memory[d_word_addr][7:0]   <= d_data_in[7:0];
+            if (d_be[1]) tcm_memory[d_word_addr][15:8]  <= d_data_in[15:8];
+            if (d_be[2]) tcm_memory[d_word_addr][23:16] <= d_data_in[23:16];
+            if (d_be[3]) tcm_memory[d_word_addr][31:24] <= d_data_in[31:24];
+        end
+    end
+
+    // Asynchronous read, same-cycle ack
+    assign d_data_out = tcm_memory[d_word_addr];
+    assign d_ack      = d_stb;
+
+    assign i_data_out = tcm_memory[i_word_addr];
+    assign i_ack      = i_stb;
+
+    // Initialize to zero for simulation
+    integer i;
+    initial begin
+        for (i = 0; i < MEM_DEPTH; i = i + 1) begin
+            tcm_memory[i] = 32'h0;
+        end
+        $display("[TCM] Initialized 4KB TCM");
+    end
+
+endmodule
@@ -0,0 +1,370 @@
+/**
+ * @file iir_accelerator.v
+ * @brief Cascaded Biquad (PR/IIR) Control-Loop Accelerator
+ *
+ * Runs the inverter current controller in hardware: on every trigger it
+ * forms the error from an ADC channel, pushes it through up to K cascaded
+ * Direct Form I biquads and writes the clamped result straight to the PWM
+ * accelerator's reference. The CPU only loads coefficients and limits.
+ *
+ * A PR controller is a single biquad (Kp folded into the resonant section:
+ * H(z) = Kp + R(z) = (Kp*A(z) + B(z)) / A(z), so Kp*|a1| must stay below
+ * 8); extra stages are available for harmonic compensators, notches or an
+ * output low-pass.
+ *
+ * Features:
+ * - K cascaded biquads (parameter, up to 6), NSTAGES selectable at runtime
+ * - Q4.28 coefficients (|c| < 8), 32-bit signals, 66-bit accumulator
+ * - One shared 32x32 multiplier, 6 cycles per stage (~26 cycles for K=4)
+ * - Trigger from ADC sample-ready or PWM carrier sync
+ * - Output clamp with saturation flag
+ * - Bit-exact with sim/models/iir_model.c
+ *
+ * Per-stage arithmetic (all signed, >>> is arithmetic shift):
+ *   acc = b0*x[n] + b1*x[n-1] + b2*x[n-2] - a1*y[n-1] - a2*y[n-2]
+ *   y[n] = sat32((acc + 2^27) >>> 28)
+ * Stage 0 input: x = SETPOINT (or sine_ref_in) - (ADC sample - OFFSET)
+ * Output:        clamp(y of last active stage, OUT_MIN, OUT_MAX)
+ *
+ * Register Map (Base: 0x00020600):
+ * 0x00: CTRL        - Control register
+ * 0x04: STATUS      - Status register
+ * 0x08: NSTAGES     - Active stages (0 = pass error through)
+ * 0x0C: OFFSET      - ADC zero offset [15:0] (unsigned)
+ * 0x10: SETPOINT    - Reference when CTRL.REF_SINE = 0 [15:0] (signed)
+ * 0x14: OUT_MIN     - Output lower clamp [15:0] (signed)
+ * 0x18: OUT_MAX     - Output upper clamp [15:0] (signed)
+ * 0x1C: OUTPUT      - Last output (read-only, signed)
+ * 0x20: INPUT       - Last stage-0 input (read-only, signed)
+ * 0x24: SAMPLE_CNT  - Completed updates (read-only)
+ * 0x40 + 0x20*k: B0, B1, B2, A1, A2 of stage k (Q4.28)
+ *
+ * CTRL Register:
+ * [0]:   ENABLE      - Run on every trigger
+ * [1]:   PWM_DRIVE   - Drive the PWM accelerator reference
+ * [2]:   TRIG_SYNC   - 0 = ADC sample ready, 1 = PWM carrier sync
+ * [3]:   REF_SINE    - 0 = SETPOINT, 1 = PWM sine reference
+ * [5:4]: CHANNEL     - ADC channel (3 = AC current)
+ * [6]:   CLEAR       - Zero all filter state (write 1, self-clearing)
+ *
+ * STATUS Register:
+ * [0]: BUSY          - Update in progress
+ * [1]: SATURATED     - Output clamped (write 1 to clear)
+ * [2]: OVERRUN       - Trigger arrived while busy (write 1 to clear)
+ */
+
+module iir_accelerator #(
+    parameter ADDR_WIDTH = 8,
+    parameter K = 4                     // Biquad stages (1-6)
+)(
+    // Wishbone bus interface
+    input  wire                    clk,
+    input  wire                    rst_n,
+    input  wire [ADDR_WIDTH-1:0]   wb_addr,
+    input  wire [31:0]             wb_dat_i,
+    output reg  [31:0]             wb_dat_o,
+    input  wire                    wb_we,
+    input  wire [3:0]              wb_sel,
+    input  wire                    wb_stb,
+    output reg                     wb_ack,
+
+    // From sigma_delta_adc
+    input  wire [63:0]             adc_samples,   // {CH3, CH2, CH1, CH0}
+    input  wire                    adc_valid,     // New samples strobe
+
+    // From pwm_accelerator
+    input  wire                    carrier_sync,
+    input  wire signed [15:0]      sine_ref_in,
+
+    // To pwm_accelerator
+    output reg  signed [15:0]      ref_out,
+    output reg                     ref_valid,     // One-cycle strobe
+    output wire                    ref_drive      // Override CPU reference
+);
+
+    //==========================================================================
+    // Registers
+    //==========================================================================
+
+    reg        enable;
+    reg        pwm_drive;
+    reg        trig_sync;
+    reg        ref_sine;
+    reg [1:0]  channel;
+    reg        clear_req;
+
+    reg        saturated;
+    reg        overrun;
+
+    reg [2:0]  nstages;
+    reg [15:0] offset;
+    reg signed [15:0] setpoint;
+    reg signed [15:0] out_min;
+    reg signed [15:0] out_max;
+    reg signed [31:0] last_input;
+    reg [31:0] sample_count;
+
+    reg signed [31:0] coeff [0:5*K-1];  // b0 b1 b2 a1 a2 per stage
+
+    assign ref_drive = enable && pwm_drive;
+
+    //==========================================================================
+    // Filter State (Direct Form I)
+    //==========================================================================
+
+    reg signed [31:0] x1 [0:K-1];
+    reg signed [31:0] x2 [0:K-1];
+    reg signed [31:0] y1 [0:K-1];
+    reg signed [31:0] y2 [0:K-1];
+
+    //==========================================================================
+    // Trigger and Stage-0 Input
+    //==========================================================================
+
+    // Rising edge of the selected source, so a strobe wider than one
+    // cycle still starts exactly one update
+    wire trig_src = trig_sync ? carrier_sync : adc_valid;
+    reg  trig_prev;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n)
+            trig_prev <= 1'b0;
+        else
+            trig_prev <= trig_src;
+    end
+
+    wire trigger = enable && trig_src && !trig_prev;
+
+    reg [15:0] sample_sel;
+    always @(*) begin
+        case (channel)
+            2'd0: sample_sel = adc_samples[15:0];
+            2'd1: sample_sel = adc_samples[31:16];
+            2'd2: sample_sel = adc_samples[47:32];
+            default: sample_sel = adc_samples[63:48];
+        endcase
+    end
+
+    wire signed [31:0] reference = ref_sine ? {{16{sine_ref_in[15]}}, sine_ref_in}
+                                            : {{16{setpoint[15]}}, setpoint};
+    wire signed [31:0] measured  = $signed({16'd0, sample_sel}) - $signed({16'd0, offset});
+    wire signed [31:0] error_in  = reference - measured;
+
+    //==========================================================================
+    // Sequencer: one multiply-accumulate per cycle
+    //==========================================================================
+
+    localparam S_IDLE  = 2'd0;
+    localparam S_MAC   = 2'd1;
+    localparam S_STAGE = 2'd2;
+    localparam S_OUT   = 2'd3;
+
+    reg [1:0]  seq_state;
+    reg [2:0]  stage;
+    reg [2:0]  term;
+    reg signed [31:0] xin;              // Current stage input
+    reg signed [65:0] acc;
+
+    // MAC operands
+    reg signed [31:0] mac_coeff;
+    reg signed [31:0] mac_operand;
+
+    always @(*) begin
+        mac_coeff = coeff[stage*5 + term];
+        case (term)
+            3'd0:    mac_operand = xin;
+            3'd1:    mac_operand = x1[stage];
+            3'd2:    mac_operand = x2[stage];
+            3'd3:    mac_operand = y1[stage];
+            default: mac_operand = y2[stage];
+        endcase
+    end
+
+    wire signed [63:0] product = mac_coeff * mac_operand;
+    wire signed [65:0] product_ext = {{2{product[63]}}, product};
+
+    // Round to nearest, back to Q0, saturate to 32 bits
+    wire signed [65:0] acc_rnd = acc + 66'sd134217728;      // + 2^27
+    wire signed [37:0] y_wide  = acc_rnd[65:28];
+    wire               y_ovf   = (y_wide[37:31] != {7{y_wide[31]}});
+    wire signed [31:0] y_sat   = !y_ovf ? y_wide[31:0] :
+                                 (y_wide[37] ? 32'sh80000000 : 32'sh7FFFFFFF);
+
+    integer i;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            seq_state <= S_IDLE;
+            stage <= 3'd0;
+            term <= 3'd0;
+            xin <= 32'sd0;
+            acc <= 66'sd0;
+            ref_out <= 16'sd0;
+            ref_valid <= 1'b0;
+            last_input <= 32'sd0;
+            sample_count <= 32'd0;
+            for (i = 0; i < K; i = i + 1) begin
+                x1[i] <= 32'sd0;
+                x2[i] <= 32'sd0;
+                y1[i] <= 32'sd0;
+                y2[i] <= 32'sd0;
+            end
+        end else begin
+            ref_valid <= 1'b0;
+
+            if (clear_req) begin
+                seq_state <= S_IDLE;
+                for (i = 0; i < K; i = i + 1) begin
+                    x1[i] <= 32'sd0;
+                    x2[i] <= 32'sd0;
+                    y1[i] <= 32'sd0;
+                    y2[i] <= 32'sd0;
+                end
+            end else begin
+                case (seq_state)
+                    S_IDLE: begin
+                        if (trigger) begin
+                            xin <= error_in;
+                            last_input <= error_in;
+                            stage <= 3'd0;
+                            term <= 3'd0;
+                            acc <= 66'sd0;
+                            seq_state <= (nstages == 3'd0) ? S_OUT : S_MAC;
+                        end
+                    end
+
+                    S_MAC: begin
+                        if (term < 3'd3)
+                            acc <= acc + product_ext;
+                        else
+                            acc <= acc - product_ext;
+
+                        if (term == 3'd4)
+                            seq_state <= S_STAGE;
+                        else
+                            term <= term + 3'd1;
+                    end
+
+                    S_STAGE: begin
+                        x2[stage] <= x1[stage];
+                        x1[stage] <= xin;
+                        y2[stage] <= y1[stage];
+                        y1[stage] <= y_sat;
+                        xin <= y_sat;
+
+                        if (stage + 3'd1 == nstages || stage == K - 1) begin
+                            seq_state <= S_OUT;
+                        end else begin
+                            stage <= stage + 3'd1;
+                            term <= 3'd0;
+                            acc <= 66'sd0;
+                            seq_state <= S_MAC;
+                        end
+                    end
+
+                    S_OUT: begin
+                        if (xin > out_max)
+                            ref_out <= out_max;
+                        else if (xin < out_min)
+                            ref_out <= out_min;
+                        else
+                            ref_out <= xin[15:0];
+                        ref_valid <= 1'b1;
+                        sample_count <= sample_count + 32'd1;
+                        seq_state <= S_IDLE;
+                    end
+                endcase
+            end
+        end
+    end
+
+    wire busy = (seq_state != S_IDLE);
+    wire clamp_hit = (seq_state == S_OUT) && ((xin > out_max) || (xin < out_min));
+
+    //==========================================================================
+    // Wishbone Bus Interface
+    //==========================================================================
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            enable <= 1'b0;
+            pwm_drive <= 1'b0;
+            trig_sync <= 1'b0;
+            ref_sine <= 1'b0;
+            channel <= 2'd3;
+            clear_req <= 1'b0;
+            saturated <= 1'b0;
+            overrun <= 1'b0;
+            nstages <= 3'd1;
+            offset <= 16'h8000;
+            setpoint <= 16'sd0;
+            out_min <= -16'sd32767;
+            out_max <= 16'sd32767;
+            for (i = 0; i < 5*K; i = i + 1)
+                coeff[i] <= 32'sd0;
+            wb_ack <= 1'b0;
+            wb_dat_o <= 32'd0;
+        end else begin
+            wb_ack <= wb_stb && !wb_ack;
+            clear_req <= 1'b0;
+
+            // Sticky status flags
+            if (clamp_hit)
+                saturated <= 1'b1;
+            if (trigger && busy)
+                overrun <= 1'b1;
+
+            if (wb_stb && wb_we && !wb_ack) begin
+                // Write
+                if (wb_addr[7:6] != 2'b00) begin
+                    // Coefficients: 0x40 + 0x20*k + 4*j
+                    if (((wb_addr - 8'h40) >> 5) < K && wb_addr[4:2] < 3'd5)
+                        coeff[((wb_addr - 8'h40) >> 5) * 5 + wb_addr[4:2]] <= wb_dat_i;
+                end else begin
+                    case (wb_addr[5:2])
+                        4'h0: begin
+                            enable <= wb_dat_i[0];
+                            pwm_drive <= wb_dat_i[1];
+                            trig_sync <= wb_dat_i[2];
+                            ref_sine <= wb_dat_i[3];
+                            channel <= wb_dat_i[5:4];
+                            clear_req <= wb_dat_i[6];
+                        end
+                        4'h1: begin
+                            if (wb_dat_i[1]) saturated <= 1'b0;
+                            if (wb_dat_i[2]) overrun <= 1'b0;
+                        end
+                        4'h2: nstages <= (wb_dat_i[2:0] > K) ? K : wb_dat_i[2:0];
+                        4'h3: offset <= wb_dat_i[15:0];
+                        4'h4: setpoint <= wb_dat_i[15:0];
+                        4'h5: out_min <= wb_dat_i[15:0];
+                        4'h6: out_max <= wb_dat_i[15:0];
+                    endcase
+                end
+            end else if (wb_stb && !wb_we && !wb_ack) begin
+                // Read
+                if (wb_addr[7:6] != 2'b00) begin
+                    if (((wb_addr - 8'h40) >> 5) < K && wb_addr[4:2] < 3'd5)
+                        wb_dat_o <= coeff[((wb_addr - 8'h40) >> 5) * 5 + wb_addr[4:2]];
+                    else
+                        wb_dat_o <= 32'h0;
+                end else begin
+                    case (wb_addr[5:2])
+                        4'h0: wb_dat_o <= {26'd0, channel, ref_sine, trig_sync, pwm_drive, enable};
+                        4'h1: wb_dat_o <= {29'd0, overrun, saturated, busy};
+                        4'h2: wb_dat_o <= {29'd0, nstages};
+                        4'h3: wb_dat_o <= {16'd0, offset};
+                        4'h4: wb_dat_o <= {{16{setpoint[15]}}, setpoint};
+                        4'h5: wb_dat_o <= {{16{out_min[15]}}, out_min};
+                        4'h6: wb_dat_o <= {{16{out_max[15]}}, out_max};
+                        4'h7: wb_dat_o <= {{16{ref_out[15]}}, ref_out};
+                        4'h8: wb_dat_o <= last_input;
+                        4'h9: wb_dat_o <= sample_count;
+                        default: wb_dat_o <= 32'h0;
+                    endcase
+                end
+            end
+        end
+    end
+
+endmodule
@@ -18,6 +18,11 @@
  * 0x14: DEADTIME   - Dead-time in clock cycles
  * 0x18: STATUS     - Status register (read-only)
  * 0x1C: PWM_OUT    - Current PWM output state (read-only)
+ * 0x20: CPU_REFERENCE - CPU-provided reference for manual mode
+ *
+ * Hardware reference path: in manual mode (CTRL[1] = 1) an asserted
+ * ext_ref_en replaces CPU_REFERENCE with ext_reference, so a hardware
+ * controller (iir_accelerator.v) can close the loop without the CPU.
  */
 
 module pwm_accelerator #(
@@ -40,7 +45,15 @@ module pwm_accelerator #(
     output wire [7:0]              pwm_out,     // 8 PWM signals
 
     // Fault input (disables PWM immediately)
-    input  wire                    fault
+    input  wire                    fault,
+
+    // Hardware reference (from iir_accelerator)
+    input  wire signed [15:0]      ext_reference,
+    input  wire                    ext_ref_en,
+
+    // Timing/reference taps (to iir_accelerator)
+    output wire                    sync_out,        // Carrier peak pulse
+    output wire signed [15:0]      sine_ref_out     // Internal sine reference
 );
 
     //==========================================================================
@@ -116,8 +129,12 @@ module pwm_accelerator #(
         .phase()  // Not used
     );
 
-    // Reference selection (auto sine or CPU-provided)
-    wire signed [15:0] reference = mode ? $signed(cpu_reference) : sine_ref;
+    // Reference selection (auto sine, CPU-provided or hardware controller)
+    wire signed [15:0] manual_ref = ext_ref_en ? ext_reference : $signed(cpu_reference);
+    wire signed [15:0] reference  = mode ? manual_ref : sine_ref;
+
+    assign sync_out     = carrier_sync;
+    assign sine_ref_out = sine_ref;
 
     //==========================================================================
     // PWM Comparators (4 instances for 8 outputs)
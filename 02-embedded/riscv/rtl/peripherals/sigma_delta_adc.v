@@ -2,37 +2,62 @@
  * @file sigma_delta_adc.v
  * @brief 4-Channel Sigma-Delta ADC Peripheral for RISC-V SoC
  *
- * Integrated FPGA Sigma-Delta ADC with CIC decimation filters.
+ * Integrated FPGA Sigma-Delta ADC with configurable decimation filters.
  * Replaces external SPI ADC interface with on-chip ADC implementation.
  *
  * Features:
  * - 4 independent Sigma-Delta ADC channels
- * - 12-14 bit ENOB (Effective Number of Bits)
- * - 10 kHz output rate per channel
- * - 1 MHz oversampling rate (100× OSR)
- * - 3rd-order CIC decimation filter
+ * - 1 MHz modulator rate (LM339 comparator + RC-filtered 1-bit DAC)
+ * - Per-channel decimation chain, configurable at runtime:
+ *     CIC, order N = 1..5, R = 2^k (k = 2..8)
+ *     3-tap CIC droop compensator [-a, 1+2a, -a], a = N/24
+ *     23-tap polyphase half-band FIR, decimate by 2
+ * - Total decimation 4..512 (250 kHz .. 1.95 kHz output rate), so a fast
+ *   current channel and a slow high-resolution DC bus channel can run
+ *   side by side
  * - Memory-mapped register interface
  * - Continuous automatic sampling
+ * - Bit-exact with sim/models/sigma_delta_model.cpp
  *
  * Register Map (Base: 0x00020100):
- * 0x00: CTRL        - Control register (enable, reset)
+ * 0x00: CTRL        - Control register (enable, IRQ channel)
  * 0x04: STATUS      - Status register (data valid flags)
  * 0x08: DATA_CH0    - Channel 0 ADC data (DC Bus 1) [15:0]
  * 0x0C: DATA_CH1    - Channel 1 ADC data (DC Bus 2) [15:0]
  * 0x10: DATA_CH2    - Channel 2 ADC data (AC Voltage) [15:0]
  * 0x14: DATA_CH3    - Channel 3 ADC data (AC Current) [15:0]
- * 0x18: SAMPLE_CNT  - Sample counter (debug)
+ * 0x18: SAMPLE_CNT  - Results of the IRQ channel (debug)
+ * 0x1C: CFG_CH0     - Channel 0 decimation configuration
+ * 0x20: CFG_CH1     - Channel 1 decimation configuration
+ * 0x24: CFG_CH2     - Channel 2 decimation configuration
+ * 0x28: CFG_CH3     - Channel 3 decimation configuration
+ *
+ * CTRL Register:
+ * [0]:   ENABLE      - Run the modulators
+ * [5:4]: IRQ_CH      - Channel whose result raises irq (reset: 3)
+ *
+ * CFG_CHx Register (writing restarts the channel's filter chain):
+ * [3:0]: DECIM_LOG2  - CIC decimation R = 2^k, k = 2..8 (clamped)
+ * [6:4]: ORDER       - CIC order N = 1..5 (clamped)
+ * [8]:   COMP_EN     - Enable the droop compensator
+ * [9]:   HB_EN       - Enable the half-band decimator (/2)
+ * Reset value: k = DECIM_LOG2, N = CIC_ORDER, COMP_EN = HB_EN = 1
+ *
+ * Data format: 16-bit offset binary, 0x0000 = 0 V, 0x8000 = Vref/2.
+ * Output rate per channel = 1 MHz / (2^k * (HB_EN ? 2 : 1)).
  *
  * External Interface:
  * - comp_in[3:0]    - Comparator inputs from LM339
  * - dac_out[3:0]    - 1-bit DAC outputs to RC filters
+ * - samples[63:0]   - Latest results, valid when irq pulses (hardware tap)
  */
 
 module sigma_delta_adc #(
     parameter ADDR_WIDTH = 8,
     parameter CLK_FREQ = 50_000_000,
-    parameter OSR = 100,                // Oversampling ratio
-    parameter CIC_ORDER = 3             // CIC filter order
+    parameter MOD_FREQ = 1_000_000,     // Modulator (oversampling) rate
+    parameter DECIM_LOG2 = 5,           // Reset CIC decimation (R = 32)
+    parameter CIC_ORDER = 3             // Reset CIC filter order
 )(
     // Wishbone bus interface
     input  wire                    clk,
@@ -50,22 +75,38 @@ module sigma_delta_adc #(
     output wire [3:0]              dac_out,       // To RC filters
 
     // Interrupt
-    output reg                     irq            // New data available
+    output reg                     irq,           // New data available
+
+    // Direct sample tap (to iir_accelerator), updated with irq
+    output wire [63:0]             samples        // {CH3, CH2, CH1, CH0}
 );
 
+    localparam MOD_DIV = CLK_FREQ / MOD_FREQ;    // System clocks per tick
+
     //==========================================================================
     // Control Registers
     //==========================================================================
 
     reg         enable;
+    reg  [1:0]  irq_ch;
     reg  [15:0] adc_data [0:3];         // ADC results for 4 channels
     reg  [3:0]  data_valid;             // Valid flags
     wire [3:0]  adc_data_valid;         // From ADC channels
     wire [15:0] adc_ch0, adc_ch1, adc_ch2, adc_ch3;
     reg  [31:0] sample_counter;
 
+    // Per-channel decimation configuration
+    reg  [3:0]  cfg_decim_log2 [0:3];
+    reg  [2:0]  cfg_order [0:3];
+    reg  [3:0]  cfg_comp_en;
+    reg  [3:0]  cfg_hb_en;
+    reg  [3:0]  cfg_load;               // Restart strobe, one per channel
+
+    integer i;
+
     initial begin
         enable = 1'b0;
+        irq_ch = 2'd3;
         adc_data[0] = 16'd0;
         adc_data[1] = 16'd0;
         adc_data[2] = 16'd0;
@@ -81,12 +122,16 @@ module sigma_delta_adc #(
 
     // Channel 0
     sigma_delta_channel #(
-        .OSR(OSR),
-        .CIC_ORDER(CIC_ORDER)
+        .CLK_DIV(MOD_DIV)
     ) adc_ch0_inst (
         .clk(clk),
         .rst_n(rst_n),
         .enable(enable),
+        .cfg_load(cfg_load[0]),
+        .cfg_decim_log2(cfg_decim_log2[0]),
+        .cfg_order(cfg_order[0]),
+        .cfg_comp_en(cfg_comp_en[0]),
+        .cfg_hb_en(cfg_hb_en[0]),
         .comp_in(comp_in[0]),
         .dac_out(dac_out[0]),
         .adc_data(adc_ch0),
@@ -95,12 +140,16 @@ module sigma_delta_adc #(
 
     // Channel 1
     sigma_delta_channel #(
-        .OSR(OSR),
-        .CIC_ORDER(CIC_ORDER)
+        .CLK_DIV(MOD_DIV)
     ) adc_ch1_inst (
         .clk(clk),
         .rst_n(rst_n),
         .enable(enable),
+        .cfg_load(cfg_load[1]),
+        .cfg_decim_log2(cfg_decim_log2[1]),
+        .cfg_order(cfg_order[1]),
+        .cfg_comp_en(cfg_comp_en[1]),
+        .cfg_hb_en(cfg_hb_en[1]),
         .comp_in(comp_in[1]),
         .dac_out(dac_out[1]),
         .adc_data(adc_ch1),
@@ -109,12 +158,16 @@ module sigma_delta_adc #(
 
     // Channel 2
     sigma_delta_channel #(
-        .OSR(OSR),
-        .CIC_ORDER(CIC_ORDER)
+        .CLK_DIV(MOD_DIV)
     ) adc_ch2_inst (
         .clk(clk),
         .rst_n(rst_n),
         .enable(enable),
+        .cfg_load(cfg_load[2]),
+        .cfg_decim_log2(cfg_decim_log2[2]),
+        .cfg_order(cfg_order[2]),
+        .cfg_comp_en(cfg_comp_en[2]),
+        .cfg_hb_en(cfg_hb_en[2]),
         .comp_in(comp_in[2]),
         .dac_out(dac_out[2]),
         .adc_data(adc_ch2),
@@ -123,12 +176,16 @@ module sigma_delta_adc #(
 
     // Channel 3
     sigma_delta_channel #(
-        .OSR(OSR),
-        .CIC_ORDER(CIC_ORDER)
+        .CLK_DIV(MOD_DIV)
     ) adc_ch3_inst (
         .clk(clk),
         .rst_n(rst_n),
         .enable(enable),
+        .cfg_load(cfg_load[3]),
+        .cfg_decim_log2(cfg_decim_log2[3]),
+        .cfg_order(cfg_order[3]),
+        .cfg_comp_en(cfg_comp_en[3]),
+        .cfg_hb_en(cfg_hb_en[3]),
         .comp_in(comp_in[3]),
         .dac_out(dac_out[3]),
         .adc_data(adc_ch3),
@@ -139,6 +196,15 @@ module sigma_delta_adc #(
     // Data Capture and Interrupt Generation
     //==========================================================================
 
+    // DATA_CHx reads clear the channel's valid flag
+    wire       wb_rd = wb_stb && !wb_we && !wb_ack;
+    wire [3:0] rd_clear;
+
+    assign rd_clear[0] = wb_rd && (wb_addr[7:2] == 6'h02);
+    assign rd_clear[1] = wb_rd && (wb_addr[7:2] == 6'h03);
+    assign rd_clear[2] = wb_rd && (wb_addr[7:2] == 6'h04);
+    assign rd_clear[3] = wb_rd && (wb_addr[7:2] == 6'h05);
+
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
             adc_data[0] <= 16'd0;
@@ -150,71 +216,83 @@ module sigma_delta_adc #(
             irq <= 1'b0;
         end else begin
             // Capture data when valid
-            if (adc_data_valid[0]) begin
-                adc_data[0] <= adc_ch0;
-                data_valid[0] <= 1'b1;
-            end
-            if (adc_data_valid[1]) begin
-                adc_data[1] <= adc_ch1;
-                data_valid[1] <= 1'b1;
-            end
-            if (adc_data_valid[2]) begin
-                adc_data[2] <= adc_ch2;
-                data_valid[2] <= 1'b1;
-            end
-            if (adc_data_valid[3]) begin
-                adc_data[3] <= adc_ch3;
-                data_valid[3] <= 1'b1;
-            end
+            if (adc_data_valid[0]) adc_data[0] <= adc_ch0;
+            if (adc_data_valid[1]) adc_data[1] <= adc_ch1;
+            if (adc_data_valid[2]) adc_data[2] <= adc_ch2;
+            if (adc_data_valid[3]) adc_data[3] <= adc_ch3;
+
+            data_valid <= adc_data_valid | (data_valid & ~rd_clear);
 
-            // Generate interrupt when all channels have new data
-            irq <= (adc_data_valid == 4'hF);
+            // Channels may run at different rates: interrupt on the
+            // selected channel (the others hold their latest result)
+            irq <= adc_data_valid[irq_ch];
 
             // Sample counter (for debug/verification)
-            if (adc_data_valid[0])
+            if (adc_data_valid[irq_ch])
                 sample_counter <= sample_counter + 1;
         end
     end
 
+    assign samples = {adc_data[3], adc_data[2], adc_data[1], adc_data[0]};
+
     //==========================================================================
     // Wishbone Bus Interface
     //==========================================================================
 
+    // Clamp configuration fields to the supported range
+    wire [3:0] wr_decim_log2 = (wb_dat_i[3:0] < 4'd2) ? 4'd2 :
+                               (wb_dat_i[3:0] > 4'd8) ? 4'd8 : wb_dat_i[3:0];
+    wire [2:0] wr_order      = (wb_dat_i[6:4] == 3'd0) ? 3'd1 :
+                               (wb_dat_i[6:4] > 3'd5)  ? 3'd5 : wb_dat_i[6:4];
+
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
             enable <= 1'b0;
+            irq_ch <= 2'd3;
+            for (i = 0; i < 4; i = i + 1) begin
+                cfg_decim_log2[i] <= DECIM_LOG2;
+                cfg_order[i] <= CIC_ORDER;
+            end
+            cfg_comp_en <= 4'hF;
+            cfg_hb_en <= 4'hF;
+            cfg_load <= 4'h0;
             wb_ack <= 1'b0;
             wb_dat_o <= 32'd0;
         end else begin
             wb_ack <= wb_stb && !wb_ack;
+            cfg_load <= 4'h0;
 
             if (wb_stb && wb_we && !wb_ack) begin
                 // Write
                 case (wb_addr[7:2])
-                    6'h00: enable <= wb_dat_i[0];  // CTRL
+                    6'h00: begin                                        // CTRL
+                        enable <= wb_dat_i[0];
+                        irq_ch <= wb_dat_i[5:4];
+                    end
+                    6'h07, 6'h08, 6'h09, 6'h0A: begin                   // CFG_CHx
+                        cfg_decim_log2[wb_addr[3:2] + 2'd1] <= wr_decim_log2;
+                        cfg_order[wb_addr[3:2] + 2'd1] <= wr_order;
+                        cfg_comp_en[wb_addr[3:2] + 2'd1] <= wb_dat_i[8];
+                        cfg_hb_en[wb_addr[3:2] + 2'd1] <= wb_dat_i[9];
+                        cfg_load[wb_addr[3:2] + 2'd1] <= 1'b1;
+                    end
                 endcase
-            end else if (wb_stb && !wb_we && !wb_ack) begin
+            end else if (wb_rd) begin
                 // Read
                 case (wb_addr[7:2])
-                    6'h00: wb_dat_o <= {31'd0, enable};                 // CTRL
+                    6'h00: wb_dat_o <= {26'd0, irq_ch, 3'd0, enable};    // CTRL
                     6'h01: wb_dat_o <= {28'd0, data_valid};             // STATUS
-                    6'h02: begin
-                        wb_dat_o <= {16'd0, adc_data[0]};                // DATA_CH0
-                        data_valid[0] <= 1'b0;  // Clear valid flag on read
-                    end
-                    6'h03: begin
-                        wb_dat_o <= {16'd0, adc_data[1]};                // DATA_CH1
-                        data_valid[1] <= 1'b0;
-                    end
-                    6'h04: begin
-                        wb_dat_o <= {16'd0, adc_data[2]};                // DATA_CH2
-                        data_valid[2] <= 1'b0;
-                    end
-                    6'h05: begin
-                        wb_dat_o <= {16'd0, adc_data[3]};                // DATA_CH3
-                        data_valid[3] <= 1'b0;
-                    end
+                    6'h02: wb_dat_o <= {16'd0, adc_data[0]};            // DATA_CH0
+                    6'h03: wb_dat_o <= {16'd0, adc_data[1]};            // DATA_CH1
+                    6'h04: wb_dat_o <= {16'd0, adc_data[2]};            // DATA_CH2
+                    6'h05: wb_dat_o <= {16'd0, adc_data[3]};            // DATA_CH3
                     6'h06: wb_dat_o <= sample_counter;                   // SAMPLE_CNT
+                    6'h07, 6'h08, 6'h09, 6'h0A:                          // CFG_CHx
+                        wb_dat_o <= {22'd0,
+                                     cfg_hb_en[wb_addr[3:2] + 2'd1],
+                                     cfg_comp_en[wb_addr[3:2] + 2'd1],
+                                     1'b0, cfg_order[wb_addr[3:2] + 2'd1],
+                                     cfg_decim_log2[wb_addr[3:2] + 2'd1]};
                     default: wb_dat_o <= 32'h0;
                 endcase
             end
@@ -227,147 +305,342 @@ endmodule
 // Sigma-Delta ADC Channel (Single Channel)
 //==========================================================================
 
+/*
+ * Datapath (all signed, >>> is arithmetic shift, DW = 26):
+ *
+ *   modulator   dac_out <= comp_in (the RC filter is the loop integrator)
+ *   CIC         N pipelined integrators of +/-1 at 1 MHz, combs at 1 MHz/R,
+ *               s = (comb << 22) >>> (N*k)                 -> Q1.22
+ *   compensator c = x[n-1] + (a*(2x[n-1] - x[n] - x[n-2]) + 2^16) >>> 17
+ *   half-band   every second input: y = (2^16*z[11]
+ *               + sum h[j]*(z[11-j] + z[11+j]) + 2^16) >>> 17, j odd
+ *   output      sat16((y + 64) >>> 7) ^ 0x8000
+ *
+ * Only the odd (non-zero) half-band taps are multiplied, and only on the
+ * phase that produces an output: the polyphase form of a /2 decimator.
+ * One multiplier per channel is shared by the compensator and the
+ * half-band sequencer (7 cycles per output).
+ */
+
 module sigma_delta_channel #(
-    parameter OSR = 100,
-    parameter CIC_ORDER = 3,
-    parameter W = 32                    // Internal width
+    parameter CLK_DIV = 50,             // System clocks per modulator tick
+    parameter MAX_ORDER = 5,            // Highest selectable CIC order
+    parameter W = 42,                   // CIC width: MAX_ORDER * 8 + 2
+    parameter DW = 26                   // Post-CIC sample width (Q1.22 + guard)
 )(
     input  wire        clk,             // 50 MHz system clock
     input  wire        rst_n,
     input  wire        enable,
+    input  wire        cfg_load,        // Restart the chain with a new config
+    input  wire [3:0]  cfg_decim_log2,  // CIC R = 2^k
+    input  wire [2:0]  cfg_order,       // CIC order N
+    input  wire        cfg_comp_en,     // Droop compensator enable
+    input  wire        cfg_hb_en,       // Half-band decimator enable
     input  wire        comp_in,         // Comparator input (1-bit)
     output reg         dac_out,         // 1-bit DAC output
-    output wire [15:0] adc_data,        // 16-bit ADC result
-    output wire        data_valid       // Data valid strobe
+    output reg  [15:0] adc_data,        // 16-bit ADC result
+    output reg         data_valid       // Data valid strobe (one cycle)
 );
 
+    integer i;
+
     //==========================================================================
-    // Clock Divider: 50 MHz → 1 MHz (for 1 MHz sampling)
+    // Clock Divider: 50 MHz → 1 MHz modulator tick
     //==========================================================================
 
-    localparam CLK_DIV = 50;            // 50 MHz / 50 = 1 MHz
+    reg [7:0] clk_div_counter;
 
-    reg [6:0] clk_div_counter;
-    reg       clk_1mhz;
+    wire mod_tick = enable && (clk_div_counter == CLK_DIV - 1);
 
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
-            clk_div_counter <= 7'd0;
-            clk_1mhz <= 1'b0;
+            clk_div_counter <= 8'd0;
+        end else if (cfg_load) begin
+            clk_div_counter <= 8'd0;
         end else if (enable) begin
-            if (clk_div_counter == CLK_DIV - 1) begin
-                clk_div_counter <= 7'd0;
-                clk_1mhz <= ~clk_1mhz;  // Toggle at 1 MHz
-            end else begin
-                clk_div_counter <= clk_div_counter + 1;
-            end
+            clk_div_counter <= mod_tick ? 8'd0 : clk_div_counter + 1;
         end
     end
 
-    wire clk_1mhz_posedge = (clk_div_counter == 0) && clk_1mhz && enable;
-
     //==========================================================================
     // Sigma-Delta Modulator (1st order)
     //==========================================================================
 
-    reg signed [31:0] integrator;
-    reg               bitstream;
+    // The LM339 compares the input against the RC-filtered DAC output, so
+    // registering the comparator closes a first-order loop.
+    reg [1:0] comp_sync;
+    reg       bitstream;
 
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
-            integrator <= 32'sd0;
+            comp_sync <= 2'b00;
             dac_out <= 1'b0;
             bitstream <= 1'b0;
-        end else if (clk_1mhz_posedge) begin
-            // Error signal = input - feedback
-            integrator <= integrator +
-                          (comp_in ? 32'sd32768 : -32'sd32768) -
-                          (dac_out ? 32'sd32768 : -32'sd32768);
-
-            // 1-bit quantizer
-            dac_out <= (integrator >= 0);
-            bitstream <= dac_out;
+        end else begin
+            comp_sync <= {comp_sync[0], comp_in};
+            if (cfg_load) begin
+                dac_out <= 1'b0;
+                bitstream <= 1'b0;
+            end else if (mod_tick) begin
+                dac_out <= comp_sync[1];
+                bitstream <= dac_out;
+            end
         end
     end
 
     //==========================================================================
-    // CIC Decimation Filter (3rd order)
+    // CIC Decimation Filter (order 1..MAX_ORDER, R = 2^k)
     //==========================================================================
 
-    // Integrator stages (run at 1 MHz)
-    reg [W-1:0] integrator_stage [0:CIC_ORDER-1];
-    integer i;
+    // Integrator stages (run at 1 MHz, modulo 2^W). All MAX_ORDER stages
+    // run; ORDER selects which one is decimated.
+    reg [W-1:0] integrator_stage [0:MAX_ORDER-1];
 
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
-            for (i = 0; i < CIC_ORDER; i = i + 1)
-                integrator_stage[i] <= 0;
-        end else if (clk_1mhz_posedge) begin
-            // First integrator
-            integrator_stage[0] <= integrator_stage[0] + (bitstream ? 1 : 0);
+            for (i = 0; i < MAX_ORDER; i = i + 1)
+                integrator_stage[i] <= {W{1'b0}};
+        end else if (cfg_load) begin
+            for (i = 0; i < MAX_ORDER; i = i + 1)
+                integrator_stage[i] <= {W{1'b0}};
+        end else if (mod_tick) begin
+            // First integrator: bitstream mapped to +1 / -1
+            integrator_stage[0] <= integrator_stage[0] +
+                                   (bitstream ? {{(W-1){1'b0}}, 1'b1} : {W{1'b1}});
 
             // Cascaded integrators
-            for (i = 1; i < CIC_ORDER; i = i + 1)
+            for (i = 1; i < MAX_ORDER; i = i + 1)
                 integrator_stage[i] <= integrator_stage[i] + integrator_stage[i-1];
         end
     end
 
     // Decimation counter
-    reg [7:0] decim_count;
-    reg [W-1:0] snapshot;
-    reg snapshot_valid;
+    wire [8:0]  decim_last = (9'd1 << cfg_decim_log2) - 9'd1;
+    reg  [7:0]  decim_count;
+    reg  [W-1:0] snapshot;
+    reg         snapshot_valid;
 
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
             decim_count <= 8'd0;
-            snapshot <= 0;
+            snapshot <= {W{1'b0}};
             snapshot_valid <= 1'b0;
-        end else if (clk_1mhz_posedge) begin
-            decim_count <= decim_count + 1;
+        end else begin
             snapshot_valid <= 1'b0;
 
-            if (decim_count == OSR - 1) begin
+            if (cfg_load) begin
                 decim_count <= 8'd0;
-                snapshot <= integrator_stage[CIC_ORDER-1];
-                snapshot_valid <= 1'b1;
+                snapshot <= {W{1'b0}};
+            end else if (mod_tick) begin
+                if ({1'b0, decim_count} == decim_last) begin
+                    decim_count <= 8'd0;
+                    snapshot <= integrator_stage[cfg_order - 3'd1];
+                    snapshot_valid <= 1'b1;
+                end else begin
+                    decim_count <= decim_count + 1;
+                end
             end
         end
     end
 
-    // Comb stages (run at 10 kHz)
-    reg [W-1:0] comb [0:CIC_ORDER-1];
-    reg [W-1:0] comb_delay [0:CIC_ORDER-1];
-    reg [15:0]  adc_result;
-    reg         result_valid;
+    // Comb stages (one subtract chain per decimated sample)
+    reg  [W-1:0] comb_delay [0:MAX_ORDER-1];
+    wire [W-1:0] comb [0:MAX_ORDER-1];
+
+    genvar g;
+    generate
+        for (g = 0; g < MAX_ORDER; g = g + 1) begin : g_comb
+            if (g == 0) begin : g_first
+                assign comb[g] = snapshot - comb_delay[g];
+            end else begin : g_next
+                assign comb[g] = comb[g-1] - comb_delay[g];
+            end
+        end
+    endgenerate
+
+    // Normalize the CIC gain R^N = 2^(N*k) to Q1.22
+    wire [5:0]          cic_shift = cfg_order * cfg_decim_log2;
+    wire [W-1:0]        cic_out = comb[cfg_order - 3'd1];
+    wire signed [W+21:0] cic_wide = {cic_out, 22'd0};
+    wire signed [W+21:0] cic_norm = cic_wide >>> cic_shift;
+
+    reg signed [DW-1:0] cic_sample;
+    reg                 cic_valid;
 
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
-            for (i = 0; i < CIC_ORDER; i = i + 1) begin
-                comb[i] <= 0;
-                comb_delay[i] <= 0;
+            for (i = 0; i < MAX_ORDER; i = i + 1)
+                comb_delay[i] <= {W{1'b0}};
+            cic_sample <= {DW{1'b0}};
+            cic_valid <= 1'b0;
+        end else begin
+            cic_valid <= 1'b0;
+
+            if (cfg_load) begin
+                for (i = 0; i < MAX_ORDER; i = i + 1)
+                    comb_delay[i] <= {W{1'b0}};
+            end else if (snapshot_valid) begin
+                comb_delay[0] <= snapshot;
+                for (i = 1; i < MAX_ORDER; i = i + 1)
+                    comb_delay[i] <= comb[i-1];
+                cic_sample <= cic_norm[DW-1:0];
+                cic_valid <= 1'b1;
             end
-            adc_result <= 16'd0;
-            result_valid <= 1'b0;
-        end else if (snapshot_valid) begin
-            // First comb
-            comb[0] <= snapshot - comb_delay[0];
-            comb_delay[0] <= snapshot;
-
-            // Cascaded combs
-            for (i = 1; i < CIC_ORDER; i = i + 1) begin
-                comb[i] <= comb[i-1] - comb_delay[i];
-                comb_delay[i] <= comb[i-1];
+        end
+    end
+
+    //==========================================================================
+    // CIC Droop Compensator: [-a, 1 + 2a, -a], a = N/24 (Q1.17)
+    //==========================================================================
+
+    reg [16:0] comp_a;
+
+    always @(*) begin
+        case (cfg_order)
+            3'd1:    comp_a = 17'd5461;
+            3'd2:    comp_a = 17'd10923;
+            3'd3:    comp_a = 17'd16384;
+            3'd4:    comp_a = 17'd21845;
+            default: comp_a = 17'd27307;
+        endcase
+    end
+
+    reg  signed [DW-1:0]  comp_x0, comp_x1;      // x[n-1], x[n-2]
+    wire signed [DW+1:0]  comp_d = (comp_x0 <<< 1) - cic_sample - comp_x1;
+    wire signed [DW+19:0] comp_p = comp_d * $signed({1'b0, comp_a});
+    wire signed [DW+19:0] comp_r = (comp_p + 46'sd65536) >>> 17;
+    wire signed [DW-1:0]  comp_y = comp_x0 + comp_r[DW-1:0];
+
+    reg signed [DW-1:0] comp_sample;
+    reg                 comp_valid;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            comp_x0 <= {DW{1'b0}};
+            comp_x1 <= {DW{1'b0}};
+            comp_sample <= {DW{1'b0}};
+            comp_valid <= 1'b0;
+        end else begin
+            comp_valid <= 1'b0;
+
+            if (cfg_load) begin
+                comp_x0 <= {DW{1'b0}};
+                comp_x1 <= {DW{1'b0}};
+            end else if (cic_valid) begin
+                comp_x1 <= comp_x0;
+                comp_x0 <= cic_sample;
+                comp_sample <= cfg_comp_en ? comp_y : cic_sample;
+                comp_valid <= 1'b1;
             end
+        end
+    end
+
+    //==========================================================================
+    // Polyphase Half-Band Decimator (23 taps, /2)
+    //==========================================================================
 
-            // Output (take top 16 bits, scaled appropriately)
-            adc_result <= comb[CIC_ORDER-1][W-1:W-16];
-            result_valid <= 1'b1;
+    // Odd taps h[1], h[3] ... h[11] in Q1.17; h[0] = 0.5, even taps are zero
+    function signed [17:0] hb_coeff;
+        input [2:0] m;
+        begin
+            case (m)
+                3'd0:    hb_coeff = 18'sd40553;
+                3'd1:    hb_coeff = -18'sd10756;
+                3'd2:    hb_coeff = 18'sd4006;
+                3'd3:    hb_coeff = -18'sd1319;
+                3'd4:    hb_coeff = 18'sd308;
+                default: hb_coeff = -18'sd24;
+            endcase
+        end
+    endfunction
+
+    reg signed [DW-1:0] hb_z [0:22];    // Delay line, hb_z[0] newest
+    reg                 hb_phase;       // Set after the first of a pair
+    reg                 hb_busy;
+    reg  [2:0]          hb_tap;
+    reg  signed [47:0]  hb_acc;
+
+    wire signed [DW:0]    hb_pair = hb_z[10 - 2*hb_tap] + hb_z[12 + 2*hb_tap];
+    wire signed [DW+18:0] hb_prod = hb_pair * hb_coeff(hb_tap);
+    wire signed [47:0]    hb_sum  = hb_acc + hb_prod;
+    wire signed [47:0]    hb_res  = (hb_sum + 48'sd65536) >>> 17;
+
+    reg signed [DW-1:0] out_sample;
+    reg                 out_valid;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            for (i = 0; i < 23; i = i + 1)
+                hb_z[i] <= {DW{1'b0}};
+            hb_phase <= 1'b0;
+            hb_busy <= 1'b0;
+            hb_tap <= 3'd0;
+            hb_acc <= 48'sd0;
+            out_sample <= {DW{1'b0}};
+            out_valid <= 1'b0;
         end else begin
-            result_valid <= 1'b0;
+            out_valid <= 1'b0;
+
+            if (cfg_load) begin
+                for (i = 0; i < 23; i = i + 1)
+                    hb_z[i] <= {DW{1'b0}};
+                hb_phase <= 1'b0;
+                hb_busy <= 1'b0;
+            end else if (comp_valid) begin
+                if (cfg_hb_en) begin
+                    hb_z[0] <= comp_sample;
+                    for (i = 1; i < 23; i = i + 1)
+                        hb_z[i] <= hb_z[i-1];
+                    hb_phase <= ~hb_phase;
+
+                    // Second sample of the pair: start the MAC sequence
+                    // once the delay line has shifted
+                    if (hb_phase) begin
+                        hb_busy <= 1'b1;
+                        hb_tap <= 3'd0;
+                    end
+                end else begin
+                    out_sample <= comp_sample;
+                    out_valid <= 1'b1;
+                end
+            end else if (hb_busy) begin
+                if (hb_tap == 3'd0) begin
+                    // Centre tap 0.5, then the first odd pair
+                    hb_acc <= $signed({{(32-DW){hb_z[11][DW-1]}}, hb_z[11], 16'd0}) + hb_prod;
+                    hb_tap <= 3'd1;
+                end else if (hb_tap == 3'd5) begin
+                    out_sample <= hb_res[DW-1:0];
+                    out_valid <= 1'b1;
+                    hb_busy <= 1'b0;
+                end else begin
+                    hb_acc <= hb_sum;
+                    hb_tap <= hb_tap + 1;
+                end
+            end
         end
     end
 
-    assign adc_data = adc_result;
-    assign data_valid = result_valid;
+    //==========================================================================
+    // Output: Q1.22 -> 16-bit offset binary
+    //==========================================================================
+
+    wire signed [DW-1:0] out_round = (out_sample + 64) >>> 7;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            adc_data <= 16'd0;
+            data_valid <= 1'b0;
+        end else begin
+            data_valid <= out_valid;
+            if (out_valid) begin
+                if (out_round > 32767)
+                    adc_data <= 16'hFFFF;
+                else if (out_round < -32768)
+                    adc_data <= 16'h0000;
+                else
+                    adc_data <= out_round[15:0] ^ 16'h8000;
+            end
+        end
+    end
 
 endmodule
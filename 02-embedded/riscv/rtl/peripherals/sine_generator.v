@@ -2,15 +2,26 @@
  * @file sine_generator.v
  * @brief Sine Wave Generator using LUT with Phase Accumulator
  *
- * Generates a sinusoidal reference waveform using a 256-entry lookup table.
- * The phase accumulator provides smooth frequency control.
+ * Generates a sinusoidal reference waveform from a quarter-wave table with
+ * linear interpolation (sine_quarter_lut below). The phase accumulator
+ * provides smooth frequency control.
  *
  * Features:
- * - 256-entry sine LUT (quarter-wave symmetry)
+ * - 256-entry quarter-wave sine table, interpolated on 8 further phase
+ *   bits (QUARTER_ADDR_WIDTH = 10: 1024-entry block RAM table)
  * - 32-bit phase accumulator for fine frequency resolution
  * - Programmable modulation index (amplitude scaling)
  * - Outputs signed 16-bit sine value
  *
+ * The previous 256-entry full-wave table truncated the phase to its top
+ * 8 bits: 48 dB SFDR. The interpolated quarter table gives 103 dB from the
+ * same 256 x 16 memory, within 2 LSB of sin(x) (06-tools/sine/sine_model.cpp).
+ *
+ * Pipeline: table read, interpolation product, sum and the MI product are
+ * each registered (LATENCY = 5 clocks to sine_out, the phase output is
+ * delayed to match), so no path holds more than one multiplier or one
+ * carry chain. The MI scaling rounds to nearest.
+ *
  * Frequency calculation:
  *   f_out = (freq_increment * f_clk) / 2^32
  *
@@ -24,7 +35,9 @@
 module sine_generator #(
     parameter DATA_WIDTH = 16,
     parameter PHASE_WIDTH = 32,
-    parameter LUT_ADDR_WIDTH = 8
+    parameter LUT_ADDR_WIDTH = 8,
+    parameter QUARTER_ADDR_WIDTH = 8,       // 256-entry quarter-wave sine table
+    parameter INTERP_BITS = 8               // Phase bits interpolated between entries
 )(
     input  wire                         clk,
     input  wire                         rst_n,
@@ -33,120 +46,67 @@ module sine_generator #(
     input  wire [15:0]                  modulation_index,  // 0-65535 = 0.0-1.0
 
     output reg signed [DATA_WIDTH-1:0]  sine_out,
-    output wire [PHASE_WIDTH-1:0]       phase             // Current phase (for debug)
+    output wire [PHASE_WIDTH-1:0]       phase             // Phase of sine_out (for debug)
 );
 
+    // Clocks from the phase accumulator to sine_out:
+    //   1-3  sine_quarter_lut: table read, interpolation product, sum
+    //   4    MI product, rounding constant added in the multiplier
+    //   5    sine_out
+    localparam LATENCY = 5;
+
     //==========================================================================
     // Phase Accumulator
     //==========================================================================
 
     reg [PHASE_WIDTH-1:0] phase_acc;
 
+    // Accumulator delayed to the sample on sine_out
+    reg [PHASE_WIDTH*LATENCY-1:0] phase_line;
+
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
             phase_acc <= 0;
-        end else if (enable) begin
-            phase_acc <= phase_acc + freq_increment;
+            phase_line <= 0;
+        end else begin
+            phase_line <= {phase_line, phase_acc};
+            if (enable)
+                phase_acc <= phase_acc + freq_increment;
         end
     end
 
-    assign phase = phase_acc;
+    assign phase = phase_line[PHASE_WIDTH*LATENCY-1 -: PHASE_WIDTH];
 
     //==========================================================================
-    // Sine Lookup Table (256 entries, quarter-wave)
+    // Interpolated Quarter-Wave Table (three clocks)
     //==========================================================================
 
-    // Use top 8 bits of phase as LUT address
-    wire [7:0] lut_addr = phase_acc[PHASE_WIDTH-1:PHASE_WIDTH-8];
+    localparam TABLE_PHASE_WIDTH = QUARTER_ADDR_WIDTH + INTERP_BITS + 2;
 
-    // Quarter-wave sine LUT (0 to 90 degrees)
-    // Values are normalized to ±32767 (signed 16-bit)
-    reg signed [15:0] sine_lut [0:255];
+    wire signed [15:0] sine_raw;
 
-    // Initialize sine LUT
-    initial begin
-        // Quarter wave (0° to 90°): indices 0-63
-        sine_lut[0]   = 16'sd0;      sine_lut[1]   = 16'sd804;    sine_lut[2]   = 16'sd1608;   sine_lut[3]   = 16'sd2410;
-        sine_lut[4]   = 16'sd3212;   sine_lut[5]   = 16'sd4011;   sine_lut[6]   = 16'sd4808;   sine_lut[7]   = 16'sd5602;
-        sine_lut[8]   = 16'sd6393;   sine_lut[9]   = 16'sd7179;   sine_lut[10]  = 16'sd7962;   sine_lut[11]  = 16'sd8739;
-        sine_lut[12]  = 16'sd9512;   sine_lut[13]  = 16'sd10278;  sine_lut[14]  = 16'sd11039;  sine_lut[15]  = 16'sd11793;
-        sine_lut[16]  = 16'sd12539;  sine_lut[17]  = 16'sd13279;  sine_lut[18]  = 16'sd14010;  sine_lut[19]  = 16'sd14732;
-        sine_lut[20]  = 16'sd15446;  sine_lut[21]  = 16'sd16151;  sine_lut[22]  = 16'sd16846;  sine_lut[23]  = 16'sd17530;
-        sine_lut[24]  = 16'sd18204;  sine_lut[25]  = 16'sd18868;  sine_lut[26]  = 16'sd19519;  sine_lut[27]  = 16'sd20159;
-        sine_lut[28]  = 16'sd20787;  sine_lut[29]  = 16'sd21403;  sine_lut[30]  = 16'sd22005;  sine_lut[31]  = 16'sd22594;
-        sine_lut[32]  = 16'sd23170;  sine_lut[33]  = 16'sd23731;  sine_lut[34]  = 16'sd24279;  sine_lut[35]  = 16'sd24811;
-        sine_lut[36]  = 16'sd25329;  sine_lut[37]  = 16'sd25832;  sine_lut[38]  = 16'sd26319;  sine_lut[39]  = 16'sd26790;
-        sine_lut[40]  = 16'sd27245;  sine_lut[41]  = 16'sd27683;  sine_lut[42]  = 16'sd28105;  sine_lut[43]  = 16'sd28510;
-        sine_lut[44]  = 16'sd28898;  sine_lut[45]  = 16'sd29268;  sine_lut[46]  = 16'sd29621;  sine_lut[47]  = 16'sd29956;
-        sine_lut[48]  = 16'sd30273;  sine_lut[49]  = 16'sd30571;  sine_lut[50]  = 16'sd30852;  sine_lut[51]  = 16'sd31113;
-        sine_lut[52]  = 16'sd31356;  sine_lut[53]  = 16'sd31580;  sine_lut[54]  = 16'sd31785;  sine_lut[55]  = 16'sd31971;
-        sine_lut[56]  = 16'sd32137;  sine_lut[57]  = 16'sd32285;  sine_lut[58]  = 16'sd32412;  sine_lut[59]  = 16'sd32521;
-        sine_lut[60]  = 16'sd32609;  sine_lut[61]  = 16'sd32678;  sine_lut[62]  = 16'sd32728;  sine_lut[63]  = 16'sd32757;
-
-        // Second quarter (90° to 180°): mirror of first quarter
-        sine_lut[64]  = 16'sd32767;  sine_lut[65]  = 16'sd32757;  sine_lut[66]  = 16'sd32728;  sine_lut[67]  = 16'sd32678;
-        sine_lut[68]  = 16'sd32609;  sine_lut[69]  = 16'sd32521;  sine_lut[70]  = 16'sd32412;  sine_lut[71]  = 16'sd32285;
-        sine_lut[72]  = 16'sd32137;  sine_lut[73]  = 16'sd31971;  sine_lut[74]  = 16'sd31785;  sine_lut[75]  = 16'sd31580;
-        sine_lut[76]  = 16'sd31356;  sine_lut[77]  = 16'sd31113;  sine_lut[78]  = 16'sd30852;  sine_lut[79]  = 16'sd30571;
-        sine_lut[80]  = 16'sd30273;  sine_lut[81]  = 16'sd29956;  sine_lut[82]  = 16'sd29621;  sine_lut[83]  = 16'sd29268;
-        sine_lut[84]  = 16'sd28898;  sine_lut[85]  = 16'sd28510;  sine_lut[86]  = 16'sd28105;  sine_lut[87]  = 16'sd27683;
-        sine_lut[88]  = 16'sd27245;  sine_lut[89]  = 16'sd26790;  sine_lut[90]  = 16'sd26319;  sine_lut[91]  = 16'sd25832;
-        sine_lut[92]  = 16'sd25329;  sine_lut[93]  = 16'sd24811;  sine_lut[94]  = 16'sd24279;  sine_lut[95]  = 16'sd23731;
-        sine_lut[96]  = 16'sd23170;  sine_lut[97]  = 16'sd22594;  sine_lut[98]  = 16'sd22005;  sine_lut[99]  = 16'sd21403;
-        sine_lut[100] = 16'sd20787;  sine_lut[101] = 16'sd20159;  sine_lut[102] = 16'sd19519;  sine_lut[103] = 16'sd18868;
-        sine_lut[104] = 16'sd18204;  sine_lut[105] = 16'sd17530;  sine_lut[106] = 16'sd16846;  sine_lut[107] = 16'sd16151;
-        sine_lut[108] = 16'sd15446;  sine_lut[109] = 16'sd14732;  sine_lut[110] = 16'sd14010;  sine_lut[111] = 16'sd13279;
-        sine_lut[112] = 16'sd12539;  sine_lut[113] = 16'sd11793;  sine_lut[114] = 16'sd11039;  sine_lut[115] = 16'sd10278;
-        sine_lut[116] = 16'sd9512;   sine_lut[117] = 16'sd8739;   sine_lut[118] = 16'sd7962;   sine_lut[119] = 16'sd7179;
-        sine_lut[120] = 16'sd6393;   sine_lut[121] = 16'sd5602;   sine_lut[122] = 16'sd4808;   sine_lut[123] = 16'sd4011;
-        sine_lut[124] = 16'sd3212;   sine_lut[125] = 16'sd2410;   sine_lut[126] = 16'sd1608;   sine_lut[127] = 16'sd804;
-
-        // Third quarter (180° to 270°): negative of first quarter
-        sine_lut[128] = 16'sd0;      sine_lut[129] = -16'sd804;   sine_lut[130] = -16'sd1608;  sine_lut[131] = -16'sd2410;
-        sine_lut[132] = -16'sd3212;  sine_lut[133] = -16'sd4011;  sine_lut[134] = -16'sd4808;  sine_lut[135] = -16'sd5602;
-        sine_lut[136] = -16'sd6393;  sine_lut[137] = -16'sd7179;  sine_lut[138] = -16'sd7962;  sine_lut[139] = -16'sd8739;
-        sine_lut[140] = -16'sd9512;  sine_lut[141] = -16'sd10278; sine_lut[142] = -16'sd11039; sine_lut[143] = -16'sd11793;
-        sine_lut[144] = -16'sd12539; sine_lut[145] = -16'sd13279; sine_lut[146] = -16'sd14010; sine_lut[147] = -16'sd14732;
-        sine_lut[148] = -16'sd15446; sine_lut[149] = -16'sd16151; sine_lut[150] = -16'sd16846; sine_lut[151] = -16'sd17530;
-        sine_lut[152] = -16'sd18204; sine_lut[153] = -16'sd18868; sine_lut[154] = -16'sd19519; sine_lut[155] = -16'sd20159;
-        sine_lut[156] = -16'sd20787; sine_lut[157] = -16'sd21403; sine_lut[158] = -16'sd22005; sine_lut[159] = -16'sd22594;
-        sine_lut[160] = -16'sd23170; sine_lut[161] = -16'sd23731; sine_lut[162] = -16'sd24279; sine_lut[163] = -16'sd24811;
-        sine_lut[164] = -16'sd25329; sine_lut[165] = -16'sd25832; sine_lut[166] = -16'sd26319; sine_lut[167] = -16'sd26790;
-        sine_lut[168] = -16'sd27245; sine_lut[169] = -16'sd27683; sine_lut[170] = -16'sd28105; sine_lut[171] = -16'sd28510;
-        sine_lut[172] = -16'sd28898; sine_lut[173] = -16'sd29268; sine_lut[174] = -16'sd29621; sine_lut[175] = -16'sd29956;
-        sine_lut[176] = -16'sd30273; sine_lut[177] = -16'sd30571; sine_lut[178] = -16'sd30852; sine_lut[179] = -16'sd31113;
-        sine_lut[180] = -16'sd31356; sine_lut[181] = -16'sd31580; sine_lut[182] = -16'sd31785; sine_lut[183] = -16'sd31971;
-        sine_lut[184] = -16'sd32137; sine_lut[185] = -16'sd32285; sine_lut[186] = -16'sd32412; sine_lut[187] = -16'sd32521;
-        sine_lut[188] = -16'sd32609; sine_lut[189] = -16'sd32678; sine_lut[190] = -16'sd32728; sine_lut[191] = -16'sd32757;
-
-        // Fourth quarter (270° to 360°): negative mirror of first quarter
-        sine_lut[192] = -16'sd32767; sine_lut[193] = -16'sd32757; sine_lut[194] = -16'sd32728; sine_lut[195] = -16'sd32678;
-        sine_lut[196] = -16'sd32609; sine_lut[197] = -16'sd32521; sine_lut[198] = -16'sd32412; sine_lut[199] = -16'sd32285;
-        sine_lut[200] = -16'sd32137; sine_lut[201] = -16'sd31971; sine_lut[202] = -16'sd31785; sine_lut[203] = -16'sd31580;
-        sine_lut[204] = -16'sd31356; sine_lut[205] = -16'sd31113; sine_lut[206] = -16'sd30852; sine_lut[207] = -16'sd30571;
-        sine_lut[208] = -16'sd30273; sine_lut[209] = -16'sd29956; sine_lut[210] = -16'sd29621; sine_lut[211] = -16'sd29268;
-        sine_lut[212] = -16'sd28898; sine_lut[213] = -16'sd28510; sine_lut[214] = -16'sd28105; sine_lut[215] = -16'sd27683;
-        sine_lut[216] = -16'sd27245; sine_lut[217] = -16'sd26790; sine_lut[218] = -16'sd26319; sine_lut[219] = -16'sd25832;
-        sine_lut[220] = -16'sd25329; sine_lut[221] = -16'sd24811; sine_lut[222] = -16'sd24279; sine_lut[223] = -16'sd23731;
-        sine_lut[224] = -16'sd23170; sine_lut[225] = -16'sd22594; sine_lut[226] = -16'sd22005; sine_lut[227] = -16'sd21403;
-        sine_lut[228] = -16'sd20787; sine_lut[229] = -16'sd20159; sine_lut[230] = -16'sd19519; sine_lut[231] = -16'sd18868;
-        sine_lut[232] = -16'sd18204; sine_lut[233] = -16'sd17530; sine_lut[234] = -16'sd16846; sine_lut[235] = -16'sd16151;
-        sine_lut[236] = -16'sd15446; sine_lut[237] = -16'sd14732; sine_lut[238] = -16'sd14010; sine_lut[239] = -16'sd13279;
-        sine_lut[240] = -16'sd12539; sine_lut[241] = -16'sd11793; sine_lut[242] = -16'sd11039; sine_lut[243] = -16'sd10278;
-        sine_lut[244] = -16'sd9512;  sine_lut[245] = -16'sd8739;  sine_lut[246] = -16'sd7962;  sine_lut[247] = -16'sd7179;
-        sine_lut[248] = -16'sd6393;  sine_lut[249] = -16'sd5602;  sine_lut[250] = -16'sd4808;  sine_lut[251] = -16'sd4011;
-        sine_lut[252] = -16'sd3212;  sine_lut[253] = -16'sd2410;  sine_lut[254] = -16'sd1608;  sine_lut[255] = -16'sd804;
-    end
+    sine_quarter_lut #(
+        .DATA_WIDTH     (16),
+        .ADDR_WIDTH     (QUARTER_ADDR_WIDTH),
+        .FRAC_WIDTH     (INTERP_BITS)
+    ) lut (
+        .clk            (clk),
+        .phase          (phase_acc[PHASE_WIDTH-1 -: TABLE_PHASE_WIDTH]),
+        .sine_out       (sine_raw)
+    );
 
     //==========================================================================
-    // LUT Readout and Amplitude Scaling
+    // Amplitude Scaling
     //==========================================================================
 
-    wire signed [15:0] sine_raw = sine_lut[lut_addr];
+    // Multiply by modulation index (fixed-point: modulation_index / 65536),
+    // + 1/2 LSB of the result for rounding. Registered without reset so it
+    // packs into the DSP output register.
+    localparam signed [32:0] ROUND = 1 << 15;
+    reg signed [32:0] sine_scaled;
 
-    // Multiply by modulation index (fixed-point: modulation_index / 65536)
-    // Result: sine_raw * (modulation_index / 65536)
-    wire signed [31:0] sine_scaled = sine_raw * $signed({1'b0, modulation_index});
+    always @(posedge clk)
+        sine_scaled <= sine_raw * $signed({1'b0, modulation_index}) + ROUND;
 
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
@@ -158,3 +118,102 @@ module sine_generator #(
     end
 
 endmodule
+
+
+/**
+ * Quarter-wave sine table with linear interpolation
+ *
+ * Stores sin(x) for the first quarter cycle only, 2^ADDR_WIDTH entries
+ * T[i] = round(32767 * sin(pi/2 * i / 2^ADDR_WIDTH)). The phase input is
+ * split as
+ *
+ *   [quadrant (2) | address (ADDR_WIDTH) | fraction (FRAC_WIDTH)]
+ *
+ * Odd quadrants run the table backwards (u -> 2^(ADDR+FRAC) - u, exact, so
+ * the peak lands on x = pi/2), quadrants 2 and 3 negate. Between two
+ * entries the output is T[a] + ((T[a+1] - T[a]) * frac + 1/2) / 2^FRAC,
+ * and the missing entry T[2^ADDR_WIDTH] (the peak) is the constant 32767.
+ *
+ * Three clocks from phase to sine_out: the two table reads, registered
+ * without reset so they map onto a dual-port block RAM (or registered
+ * distributed ROM for small tables), the slope x frac product with the
+ * rounding constant (one DSP, pre-adder for the slope), then the sum.
+ * Same module as 03-fpga/rtl/sine_generator.v; 06-tools/sine/sine_model.cpp
+ * is the bit-exact model.
+ *
+ * @param clk       Clock
+ * @param phase     Top ADDR_WIDTH + FRAC_WIDTH + 2 bits of the phase
+ * @param sine_out  Interpolated sine (-32767 to +32767)
+ */
+
+module sine_quarter_lut #(
+    parameter DATA_WIDTH = 16,
+    parameter ADDR_WIDTH = 8,               // 2^ADDR_WIDTH entries per quarter
+    parameter FRAC_WIDTH = 8                // Interpolated phase bits
+)(
+    input  wire                                 clk,
+    input  wire [ADDR_WIDTH+FRAC_WIDTH+1:0]     phase,
+    output reg  signed [DATA_WIDTH-1:0]         sine_out
+);
+
+    localparam ENTRIES = 1 << ADDR_WIDTH;
+    localparam U_WIDTH = ADDR_WIDTH + FRAC_WIDTH;     // Phase within a quadrant
+    localparam signed [DATA_WIDTH-1:0] PEAK = (1 << (DATA_WIDTH - 1)) - 1;
+
+    reg signed [DATA_WIDTH-1:0] lut [0:ENTRIES-1];
+
+    localparam real PI = 3.14159265359;
+
+    integer i;
+    initial begin
+        for (i = 0; i < ENTRIES; i = i + 1)
+            lut[i] = $rtoi(32767.0 * $sin(PI / 2.0 * i / ENTRIES) + 0.5);
+    end
+
+    // Fold the phase into the first quadrant: 0 <= u <= 2^U_WIDTH
+    wire [1:0]          quadrant = phase[U_WIDTH+1:U_WIDTH];
+    wire [U_WIDTH-1:0]  u_in = phase[U_WIDTH-1:0];
+    wire [U_WIDTH:0]    u = quadrant[0] ? ((1 << U_WIDTH) - u_in) : u_in;
+    wire [ADDR_WIDTH:0] index = u[U_WIDTH:FRAC_WIDTH];
+
+    // Index ENTRIES (and ENTRIES-1 + 1) is the peak, not in the table
+    wire [ADDR_WIDTH-1:0] addr0 = index[ADDR_WIDTH-1:0];
+    wire [ADDR_WIDTH-1:0] addr1 = addr0 + 1'b1;
+
+    // Stage 1: table reads
+    reg signed [DATA_WIDTH-1:0] y0, y1;
+    reg                         peak0, peak1;
+    reg [FRAC_WIDTH-1:0]        frac;
+    reg                         negate;
+
+    always @(posedge clk) begin
+        y0     <= lut[addr0];
+        y1     <= lut[addr1];
+        peak0  <= index[ADDR_WIDTH];
+        peak1  <= (index >= ENTRIES - 1);
+        frac   <= u[FRAC_WIDTH-1:0];
+        negate <= quadrant[1];
+    end
+
+    // Stage 2: (T[a+1] - T[a]) * frac + 1/2
+    localparam signed [DATA_WIDTH+FRAC_WIDTH+1:0] HALF = 1 << (FRAC_WIDTH - 1);
+
+    wire signed [DATA_WIDTH-1:0]            v0 = peak0 ? PEAK : y0;
+    wire signed [DATA_WIDTH-1:0]            v1 = peak1 ? PEAK : y1;
+    reg  signed [DATA_WIDTH+FRAC_WIDTH+1:0] step;
+    reg  signed [DATA_WIDTH-1:0]            base;
+    reg                                     negate_d;
+
+    always @(posedge clk) begin
+        step     <= (v1 - v0) * $signed({1'b0, frac}) + HALF;
+        base     <= v0;
+        negate_d <= negate;
+    end
+
+    // Stage 3: sum, then restore the sign
+    wire signed [DATA_WIDTH:0] interp = base + (step >>> FRAC_WIDTH);
+
+    always @(posedge clk)
+        sine_out <= negate_d ? -interp : interp;
+
+endmodule
@@ -12,6 +12,7 @@
  * - Timer peripheral
  * - GPIO peripheral (32 pins)
  * - UART peripheral (debug/communication)
+ * - IIR/PR accelerator (hardware current loop: ADC -> biquads -> PWM ref)
  * - Wishbone bus interconnect
  *
  * Target: Digilent Basys 3 (Xilinx Artix-7 XC7A35T)
@@ -421,6 +422,12 @@ module soc_top #(
     wire        pwm_stb;
     wire        pwm_ack;
     wire        pwm_disable;
+    wire        pwm_carrier_sync;
+    wire signed [15:0] pwm_sine_ref;
+
+    // Hardware control loop (iir_accelerator -> PWM reference)
+    wire signed [15:0] iir_ref_out;
+    wire        iir_ref_drive;
 
     pwm_accelerator #(
         .CLK_FREQ(CLK_FREQ)
@@ -435,7 +442,11 @@ module soc_top #(
         .wb_stb(pwm_stb),
         .wb_ack(pwm_ack),
         .pwm_out(pwm_out),
-        .fault(pwm_disable)
+        .fault(pwm_disable),
+        .ext_reference(iir_ref_out),
+        .ext_ref_en(iir_ref_drive),
+        .sync_out(pwm_carrier_sync),
+        .sine_ref_out(pwm_sine_ref)
     );
 
     //==========================================================================
@@ -450,11 +461,12 @@ module soc_top #(
     wire        adc_stb;
     wire        adc_ack;
     wire        adc_irq;
+    wire [63:0] adc_samples;
 
     sigma_delta_adc #(
         .CLK_FREQ(CLK_FREQ),
-        .OSR(100),              // 100× oversampling (1 MHz → 10 kHz)
-        .CIC_ORDER(3)           // 3rd-order CIC filter
+        .DECIM_LOG2(5),         // Reset: 1 MHz / (32 × 2) = 15.625 kHz
+        .CIC_ORDER(3)           // Reset: 3rd-order CIC + compensator
     ) adc_periph (
         .clk(clk),
         .rst_n(rst_n_sync),
@@ -467,7 +479,8 @@ module soc_top #(
         .wb_ack(adc_ack),
         .comp_in(adc_comp_in),     // External comparator inputs
         .dac_out(adc_dac_out),     // 1-bit DAC outputs
-        .irq(adc_irq)
+        .irq(adc_irq),
+        .samples(adc_samples)      // Direct tap for iir_accelerator
     );
 
     //==========================================================================
@@ -595,6 +608,39 @@ module soc_top #(
         .irq(uart_irq)
     );
 
+    //==========================================================================
+    // Peripherals: IIR/PR Accelerator
+    //==========================================================================
+
+    wire [7:0]  iir_addr;
+    wire [31:0] iir_dat_i;
+    wire [31:0] iir_dat_o;
+    wire        iir_we;
+    wire [3:0]  iir_sel;
+    wire        iir_stb;
+    wire        iir_ack;
+
+    iir_accelerator #(
+        .K(4)                   // 4 cascaded biquads
+    ) iir_periph (
+        .clk(clk),
+        .rst_n(rst_n_sync),
+        .wb_addr(iir_addr),
+        .wb_dat_i(iir_dat_i),
+        .wb_dat_o(iir_dat_o),
+        .wb_we(iir_we),
+        .wb_sel(iir_sel),
+        .wb_stb(iir_stb),
+        .wb_ack(iir_ack),
+        .adc_samples(adc_samples),
+        .adc_valid(adc_irq),
+        .carrier_sync(pwm_carrier_sync),
+        .sine_ref_in(pwm_sine_ref),
+        .ref_out(iir_ref_out),
+        .ref_valid(),
+        .ref_drive(iir_ref_drive)
+    );
+
     //==========================================================================
     // Wishbone Bus Interconnect
     //==========================================================================
@@ -682,20 +728,32 @@ module soc_top #(
         .uart_we(uart_we),
         .uart_sel(uart_sel),
         .uart_stb(uart_stb),
-        .uart_ack(uart_ack)
+        .uart_ack(uart_ack),
+
+        // Slave: IIR/PR Accelerator
+        .iir_addr(iir_addr),
+        .iir_dat_i(iir_dat_i),
+        .iir_dat_o(iir_dat_o),
+        .iir_we(iir_we),
+        .iir_sel(iir_sel),
+        .iir_stb(iir_stb),
+        .iir_ack(iir_ack)
     );
 
     //==========================================================================
     // Interrupt Aggregation
     //==========================================================================
 
+    // Peripheral lines sit in the platform range (mcause 16+) so that the
+    // core's interrupt controller routes them; with mtvec MODE=1 each one
+    // gets its own vector at mtvec_base + 4*cause.
     assign cpu_interrupts = {
-        27'd0,
-        uart_irq,      // [4]
-        timer_irq,     // [3]
-        prot_irq,      // [2]
-        adc_irq,       // [1]
-        1'b0           // [0] - reserved
+        12'd0,
+        uart_irq,      // [19]
+        timer_irq,     // [18]
+        prot_irq,      // [17]
+        adc_irq,       // [16] - control-loop interrupt (fast-path candidate)
+        16'd0          // [15:0] - standard/reserved
     };
 
     //==========================================================================
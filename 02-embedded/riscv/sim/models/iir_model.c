@@ -0,0 +1,238 @@
+/**
+ * @file iir_model.c
+ * @brief Fixed-point golden model of rtl/peripherals/iir_accelerator.v
+ *
+ * Implements the accelerator's arithmetic exactly (Q4.28 coefficients,
+ * 32-bit signals, wide accumulator, round-half-up, 32-bit saturation,
+ * output clamp) and writes test vectors for tb_iir_accelerator.v.
+ *
+ * Vector file (one 32-bit hex word per line, $readmemh format):
+ *   NCASES
+ *   per case:
+ *     NSTAGES, OFFSET, SETPOINT, OUT_MIN, OUT_MAX,
+ *     IIR_MAX_STAGES * 5 coefficients (b0 b1 b2 a1 a2 per stage),
+ *     NSAMPLES, then NSAMPLES x (adc_sample, expected_output)
+ *
+ * Build/run: gcc -O2 -o iir_model iir_model.c -lm && ./iir_model out.hex
+ *
+ * @author Custom RISC-V Core Team
+ * @date 2025-12-18
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define IIR_MAX_STAGES  4
+#define FS_HZ           10000.0     /* ADC output rate */
+
+typedef struct {
+    int nstages;
+    uint16_t offset;
+    int16_t setpoint;
+    int16_t out_min;
+    int16_t out_max;
+    int32_t coeff[IIR_MAX_STAGES][5];   /* b0 b1 b2 a1 a2, Q4.28 */
+    int32_t x1[IIR_MAX_STAGES], x2[IIR_MAX_STAGES];
+    int32_t y1[IIR_MAX_STAGES], y2[IIR_MAX_STAGES];
+} iir_t;
+
+/*---------------------------------------------------------------------------
+ * Bit-exact reference
+ *-------------------------------------------------------------------------*/
+
+static int32_t sat32(__int128 v)
+{
+    if (v > INT32_MAX) return INT32_MAX;
+    if (v < INT32_MIN) return INT32_MIN;
+    return (int32_t)v;
+}
+
+static int16_t iir_step(iir_t *f, uint16_t sample)
+{
+    int32_t x = (int32_t)f->setpoint - ((int32_t)sample - (int32_t)f->offset);
+
+    for (int k = 0; k < f->nstages; k++) {
+        const int32_t *c = f->coeff[k];
+        __int128 acc = 0;
+
+        acc += (__int128)((int64_t)c[0] * x);
+        acc += (__int128)((int64_t)c[1] * f->x1[k]);
+        acc += (__int128)((int64_t)c[2] * f->x2[k]);
+        acc -= (__int128)((int64_t)c[3] * f->y1[k]);
+        acc -= (__int128)((int64_t)c[4] * f->y2[k]);
+
+        /* Arithmetic shift (gcc) == Verilog >>> on the rounded value */
+        int32_t y = sat32((acc + ((__int128)1 << 27)) >> 28);
+
+        f->x2[k] = f->x1[k];
+        f->x1[k] = x;
+        f->y2[k] = f->y1[k];
+        f->y1[k] = y;
+        x = y;
+    }
+
+    if (x > f->out_max) return f->out_max;
+    if (x < f->out_min) return f->out_min;
+    return (int16_t)x;
+}
+
+/*---------------------------------------------------------------------------
+ * Coefficient design (double -> Q4.28)
+ *-------------------------------------------------------------------------*/
+
+static int32_t q28(double v)
+{
+    double s = v * 268435456.0;
+    if (s > 2147483647.0) s = 2147483647.0;
+    if (s < -2147483648.0) s = -2147483648.0;
+    return (int32_t)lrint(s);
+}
+
+static void set_biquad(iir_t *f, int k, double b0, double b1, double b2,
+                       double a0, double a1, double a2)
+{
+    f->coeff[k][0] = q28(b0 / a0);
+    f->coeff[k][1] = q28(b1 / a0);
+    f->coeff[k][2] = q28(b2 / a0);
+    f->coeff[k][3] = q28(a1 / a0);
+    f->coeff[k][4] = q28(a2 / a0);
+}
+
+/* RBJ cookbook low-pass */
+static void design_lowpass(iir_t *f, int k, double fc, double q)
+{
+    double w = 2.0 * M_PI * fc / FS_HZ, al = sin(w) / (2.0 * q), cw = cos(w);
+    set_biquad(f, k, (1 - cw) / 2, 1 - cw, (1 - cw) / 2, 1 + al, -2 * cw, 1 - al);
+}
+
+/* RBJ cookbook notch */
+static void design_notch(iir_t *f, int k, double f0, double q)
+{
+    double w = 2.0 * M_PI * f0 / FS_HZ, al = sin(w) / (2.0 * q), cw = cos(w);
+    set_biquad(f, k, 1, -2 * cw, 1, 1 + al, -2 * cw, 1 - al);
+}
+
+/*
+ * PR controller Kp + Kr * 2wc s / (s^2 + 2wc s + w0^2), Tustin with
+ * pre-warping at w0, Kp folded into the same biquad.
+ */
+static void design_pr(iir_t *f, int k, double kp, double kr, double wc, double f0)
+{
+    double w0 = 2.0 * M_PI * f0;
+    double K = w0 / tan(w0 / (2.0 * FS_HZ));
+    double a0 = K * K + 2 * wc * K + w0 * w0;
+    double a1 = 2 * (w0 * w0 - K * K);
+    double a2 = K * K - 2 * wc * K + w0 * w0;
+    double r0 = kr * 2 * wc * K, r2 = -r0;
+    set_biquad(f, k, kp * a0 + r0, kp * a1, kp * a2 + r2, a0, a1, a2);
+}
+
+/*---------------------------------------------------------------------------
+ * Vector generation
+ *-------------------------------------------------------------------------*/
+
+static uint32_t lcg_state = 12345u;
+
+static int noise(int amp)
+{
+    lcg_state = lcg_state * 1664525u + 1013904223u;
+    return (int)((lcg_state >> 16) % (2u * amp + 1u)) - amp;
+}
+
+static uint16_t clamp_u16(int v)
+{
+    return (uint16_t)(v < 0 ? 0 : (v > 65535 ? 65535 : v));
+}
+
+static void emit_case(FILE *out, iir_t *f, const uint16_t *samples, int n)
+{
+    fprintf(out, "%08x\n", (uint32_t)f->nstages);
+    fprintf(out, "%08x\n", (uint32_t)f->offset);
+    fprintf(out, "%08x\n", (uint32_t)(uint16_t)f->setpoint);
+    fprintf(out, "%08x\n", (uint32_t)(uint16_t)f->out_min);
+    fprintf(out, "%08x\n", (uint32_t)(uint16_t)f->out_max);
+    for (int k = 0; k < IIR_MAX_STAGES; k++)
+        for (int j = 0; j < 5; j++)
+            fprintf(out, "%08x\n", (uint32_t)f->coeff[k][j]);
+    fprintf(out, "%08x\n", (uint32_t)n);
+    for (int i = 0; i < n; i++) {
+        int16_t y = iir_step(f, samples[i]);
+        fprintf(out, "%08x\n", (uint32_t)samples[i]);
+        fprintf(out, "%08x\n", (uint32_t)(uint16_t)y);
+    }
+}
+
+static void reset_filter(iir_t *f)
+{
+    for (int k = 0; k < IIR_MAX_STAGES; k++)
+        f->x1[k] = f->x2[k] = f->y1[k] = f->y2[k] = 0;
+}
+
+int main(int argc, char **argv)
+{
+    enum { N = 400 };
+    static uint16_t s[N];
+    iir_t f = {0};
+    FILE *out;
+
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s vectors.hex\n", argv[0]);
+        return 1;
+    }
+    out = fopen(argv[1], "w");
+    if (!out) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    fprintf(out, "%08x\n", 4u);
+
+    /* Case 1: single low-pass (500 Hz), step plus noise */
+    f.nstages = 1;
+    f.offset = 32768;
+    f.setpoint = 0;
+    f.out_min = -32767;
+    f.out_max = 32767;
+    design_lowpass(&f, 0, 500.0, 0.707);
+    for (int i = 0; i < N; i++)
+        s[i] = clamp_u16(32768 - (i >= 20 ? 8000 : 0) + noise(500));
+    emit_case(out, &f, s, N);
+
+    /* Case 2: PR controller at 50 Hz, output clamp engages */
+    reset_filter(&f);
+    f.nstages = 1;
+    f.setpoint = 100;
+    f.out_min = -20000;
+    f.out_max = 20000;
+    design_pr(&f, 0, 0.5, 50.0, 5.0, 50.0);
+    for (int i = 0; i < N; i++)
+        s[i] = clamp_u16(32768 + (int)lrint(3000.0 * sin(2 * M_PI * 50.0 * i / FS_HZ)) + noise(50));
+    emit_case(out, &f, s, N);
+
+    /* Case 3: 4-stage cascade (PR, 150/250 Hz notches, 2 kHz low-pass) */
+    reset_filter(&f);
+    f.nstages = 4;
+    f.setpoint = -250;
+    f.out_min = -32767;
+    f.out_max = 32767;
+    design_pr(&f, 0, 1.5, 5.0, 10.0, 50.0);
+    design_notch(&f, 1, 150.0, 5.0);
+    design_notch(&f, 2, 250.0, 5.0);
+    design_lowpass(&f, 3, 2000.0, 0.707);
+    for (int i = 0; i < N; i++)
+        s[i] = clamp_u16(32768 + noise(4000));
+    emit_case(out, &f, s, N);
+
+    /* Case 4: same coefficients, NSTAGES = 2 (stages 3-4 bypassed) */
+    reset_filter(&f);
+    f.nstages = 2;
+    for (int i = 0; i < N; i++)
+        s[i] = clamp_u16(32768 + noise(6000));
+    emit_case(out, &f, s, N);
+
+    fclose(out);
+    printf("Wrote 4 cases x %d samples to %s\n", N, argv[1]);
+    return 0;
+}
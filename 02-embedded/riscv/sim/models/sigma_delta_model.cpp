@@ -0,0 +1,344 @@
+/**
+ * @file sigma_delta_model.cpp
+ * @brief Golden model of the sigma_delta_adc decimation chain
+ *
+ * Bit-exact C++ model of rtl/peripherals/sigma_delta_adc.v:
+ *
+ *   comparator/RC loop -> CIC (order N, R = 2^k) -> 3-tap droop compensator
+ *   -> polyphase half-band decimator (/2) -> 16-bit offset-binary result
+ *
+ * The RC filter and LM339 comparator are modelled behaviourally (double
+ * precision); everything from the 1-bit DAC register onwards follows the
+ * RTL word widths, wrap-around, rounding and saturation exactly.
+ *
+ * For each channel configuration the model records the comparator decision
+ * at every modulator tick (the testbench replays it on comp_in) and the
+ * expected DATA_CHx words, then fits a sine to the settled output and
+ * reports SNR/ENOB, output rate and group delay.
+ *
+ * Vector file (one 32-bit hex word per line, $readmemh format):
+ *   NPASSES
+ *   per pass:
+ *     CFG_CH0..CFG_CH3, NSAMPLES, NSKIP, NCYCLES, NTICKS,
+ *     4 x NSAMPLES expected words (channel 0 first),
+ *     NTICKS comparator words (bit i = comp_in[i])
+ *
+ * Build/run: g++ -O2 -o sigma_delta_model sigma_delta_model.cpp
+ *            ./sigma_delta_model out.hex
+ *
+ * @author Custom RISC-V Core Team
+ * @date 2025-12-19
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr int kMaxOrder = 5;
+constexpr int kCicWidth = 42;               // W in the RTL
+constexpr int kDataWidth = 26;              // DW in the RTL
+constexpr double kModRateHz = 1.0e6;        // Modulator tick rate
+
+constexpr int kSamples = 152;               // Words checked per channel
+constexpr int kSkip = 24;                   // Settling samples
+constexpr int kCycles = 3;                  // Sine periods in the fit window
+
+// Droop compensator coefficient per CIC order, Q1.17 (round(N/24 * 2^17))
+constexpr int32_t kCompA[kMaxOrder + 1] = {0, 5461, 10923, 16384, 21845, 27307};
+
+// Half-band taps h[1], h[3] ... h[11], Q1.17; h[0] = 0.5, even taps zero
+constexpr int32_t kHalfBand[6] = {40553, -10756, 4006, -1319, 308, -24};
+
+int64_t wrap(int64_t v, int bits)
+{
+    uint64_t m = (bits == 64) ? ~0ull : ((1ull << bits) - 1);
+    uint64_t u = static_cast<uint64_t>(v) & m;
+    if (u >> (bits - 1)) u |= ~m;           // sign-extend
+    return static_cast<int64_t>(u);
+}
+
+struct ChannelConfig {
+    int decim_log2;                         // CIC R = 2^k, k = 2..8
+    int order;                              // CIC N = 1..5
+    bool comp_en;
+    bool hb_en;
+    const char *label;
+
+    uint32_t reg() const
+    {
+        return static_cast<uint32_t>(decim_log2) |
+               (static_cast<uint32_t>(order) << 4) |
+               (comp_en ? 1u << 8 : 0u) | (hb_en ? 1u << 9 : 0u);
+    }
+    int decimation() const { return (1 << decim_log2) * (hb_en ? 2 : 1); }
+
+    // Group delay in modulator ticks: CIC + compensator + half-band
+    double group_delay_ticks() const
+    {
+        double r = 1 << decim_log2;
+        return order * (r - 1) / 2.0 + (comp_en ? r : 0.0) + (hb_en ? 11.0 * r : 0.0);
+    }
+};
+
+/*---------------------------------------------------------------------------
+ * RTL mirror: one sigma_delta_channel
+ *-------------------------------------------------------------------------*/
+
+class DecimationChain {
+public:
+    explicit DecimationChain(const ChannelConfig &cfg) : cfg_(cfg) {}
+
+    // One modulator tick with the synchronized comparator bit.
+    // Returns true and sets *out when DATA_CHx updates.
+    bool tick(bool comp, uint16_t *out)
+    {
+        const int r_last = (1 << cfg_.decim_log2) - 1;
+        bool snap = false;
+
+        // Decimator samples the last integrator before this tick's update
+        if (decim_cnt_ == r_last) {
+            snapshot_ = integ_[cfg_.order - 1];
+            decim_cnt_ = 0;
+            snap = true;
+        } else {
+            decim_cnt_++;
+        }
+
+        // Pipelined integrators, all updated from the old values
+        int64_t next[kMaxOrder];
+        next[0] = wrap(integ_[0] + (bitstream_ ? 1 : -1), kCicWidth);
+        for (int i = 1; i < kMaxOrder; i++)
+            next[i] = wrap(integ_[i] + integ_[i - 1], kCicWidth);
+        for (int i = 0; i < kMaxOrder; i++)
+            integ_[i] = next[i];
+
+        bitstream_ = dac_;
+        dac_ = comp;
+
+        return snap ? cic_sample(out) : false;
+    }
+
+    bool dac() const { return dac_; }
+
+private:
+    bool cic_sample(uint16_t *out)
+    {
+        int64_t w[kMaxOrder];
+        w[0] = wrap(snapshot_ - comb_dly_[0], kCicWidth);
+        for (int i = 1; i < kMaxOrder; i++)
+            w[i] = wrap(w[i - 1] - comb_dly_[i], kCicWidth);
+        comb_dly_[0] = snapshot_;
+        for (int i = 1; i < kMaxOrder; i++)
+            comb_dly_[i] = w[i - 1];
+
+        // Normalize R^N to Q1.22: (x << 22) >>> (N * k)
+        int64_t scaled = static_cast<int64_t>(static_cast<uint64_t>(w[cfg_.order - 1]) << 22);
+        scaled >>= cfg_.order * cfg_.decim_log2;
+        int64_t s = wrap(scaled, kDataWidth);
+
+        // Droop compensator [-a, 1 + 2a, -a], one CIC sample of delay
+        int64_t c = s;
+        if (cfg_.comp_en) {
+            int64_t d = 2 * x0_ - s - x1_;
+            int64_t p = static_cast<int64_t>(kCompA[cfg_.order]) * d;
+            c = wrap(x0_ + ((p + (1 << 16)) >> 17), kDataWidth);
+        }
+        x1_ = x0_;
+        x0_ = s;
+
+        if (!cfg_.hb_en)
+            return finish(c, out);
+
+        for (int i = 22; i > 0; i--)
+            z_[i] = z_[i - 1];
+        z_[0] = c;
+        hb_phase_ = !hb_phase_;
+        if (hb_phase_)
+            return false;
+
+        // Polyphase: only every second output is computed
+        int64_t acc = z_[11] * 65536;
+        for (int m = 0; m < 6; m++)
+            acc += static_cast<int64_t>(kHalfBand[m]) * (z_[10 - 2 * m] + z_[12 + 2 * m]);
+        return finish(wrap((acc + (1 << 16)) >> 17, kDataWidth), out);
+    }
+
+    bool finish(int64_t y, uint16_t *out)
+    {
+        int64_t q = (y + 64) >> 7;          // Q1.22 -> Q1.15
+        if (q > 32767) q = 32767;
+        if (q < -32768) q = -32768;
+        *out = static_cast<uint16_t>(q) ^ 0x8000u;
+        return true;
+    }
+
+    ChannelConfig cfg_;
+    bool dac_ = false;
+    bool bitstream_ = false;
+    int decim_cnt_ = 0;
+    int64_t integ_[kMaxOrder] = {};
+    int64_t snapshot_ = 0;
+    int64_t comb_dly_[kMaxOrder] = {};
+    int64_t x0_ = 0, x1_ = 0;
+    int64_t z_[23] = {};
+    bool hb_phase_ = false;
+};
+
+/*---------------------------------------------------------------------------
+ * Analog front end: RC-filtered DAC feedback into an LM339
+ *-------------------------------------------------------------------------*/
+
+class FrontEnd {
+public:
+    FrontEnd(double freq_hz, uint32_t seed) : freq_hz_(freq_hz), lcg_(seed) {}
+
+    bool compare(long n)
+    {
+        double t = n / kModRateHz;
+        double vin = 0.5 + kAmplitude * std::sin(2.0 * M_PI * freq_hz_ * t + 0.3);
+        return vin + noise() > v_rc_;
+    }
+
+    void settle(bool dac) { v_rc_ += kAlpha * ((dac ? 1.0 : 0.0) - v_rc_); }
+
+    static constexpr double kAmplitude = 0.4;   // Fraction of Vref
+
+private:
+    static constexpr double kAlpha = 0.02;      // Tick period / RC
+    static constexpr double kNoise = 2e-4;      // Comparator input noise
+
+    double noise()
+    {
+        lcg_ = lcg_ * 1664525u + 1013904223u;
+        return kNoise * ((lcg_ >> 8) / 16777216.0 - 0.5);
+    }
+
+    double freq_hz_;
+    double v_rc_ = 0.0;
+    uint32_t lcg_;
+};
+
+/*---------------------------------------------------------------------------
+ * SINAD from a 3-parameter sine fit (same arithmetic as the testbench)
+ *-------------------------------------------------------------------------*/
+
+double sinad_db(const std::vector<uint16_t> &y)
+{
+    const int n = kSamples - kSkip;
+    const double w = 2.0 * M_PI * kCycles / n;
+    double a = 0, b = 0, c = 0;
+
+    for (int i = 0; i < n; i++) {
+        double x = static_cast<double>(y[kSkip + i]) - 32768.0;
+        a += x * std::sin(w * i);
+        b += x * std::cos(w * i);
+        c += x;
+    }
+    a *= 2.0 / n;
+    b *= 2.0 / n;
+    c /= n;
+
+    double err = 0;
+    for (int i = 0; i < n; i++) {
+        double x = static_cast<double>(y[kSkip + i]) - 32768.0;
+        double r = x - (a * std::sin(w * i) + b * std::cos(w * i) + c);
+        err += r * r;
+    }
+    return 10.0 * std::log10(((a * a + b * b) / 2.0) / (err / n));
+}
+
+void run_pass(FILE *out, const ChannelConfig (&cfg)[4], uint32_t seed)
+{
+    std::vector<DecimationChain> chains;
+    std::vector<FrontEnd> inputs;
+    std::vector<std::vector<uint16_t>> results(4);
+    std::vector<uint32_t> comp_words;
+
+    for (int ch = 0; ch < 4; ch++) {
+        double fs_out = kModRateHz / cfg[ch].decimation();
+        chains.emplace_back(cfg[ch]);
+        inputs.emplace_back(fs_out * kCycles / (kSamples - kSkip), seed + ch);
+    }
+
+    auto done = [&] {
+        for (const auto &r : results)
+            if (static_cast<int>(r.size()) < kSamples) return false;
+        return true;
+    };
+
+    for (long n = 0; !done(); n++) {
+        uint32_t word = 0;
+        for (int ch = 0; ch < 4; ch++) {
+            bool comp = inputs[ch].compare(n);
+            uint16_t y;
+            word |= (comp ? 1u : 0u) << ch;
+            if (chains[ch].tick(comp, &y) && results[ch].size() < kSamples)
+                results[ch].push_back(y);
+            inputs[ch].settle(chains[ch].dac());
+        }
+        comp_words.push_back(word);
+    }
+
+    for (int ch = 0; ch < 4; ch++)
+        fprintf(out, "%08x\n", cfg[ch].reg());
+    fprintf(out, "%08x\n%08x\n%08x\n%08x\n", kSamples, kSkip, kCycles,
+            static_cast<unsigned>(comp_words.size()));
+    for (const auto &r : results)
+        for (uint16_t y : r)
+            fprintf(out, "%08x\n", y);
+    for (uint32_t w : comp_words)
+        fprintf(out, "%08x\n", w);
+
+    for (int ch = 0; ch < 4; ch++) {
+        const ChannelConfig &c = cfg[ch];
+        double snr = sinad_db(results[ch]);
+        printf("  CH%d k=%d N=%d comp=%d hb=%d  D=%3d  %9.1f Hz  delay %7.1f us"
+               "  SNR %5.1f dB  ENOB %5.2f  (%s)\n",
+               ch, c.decim_log2, c.order, c.comp_en, c.hb_en, c.decimation(),
+               kModRateHz / c.decimation(), c.group_delay_ticks(),
+               snr, (snr - 1.76) / 6.02, c.label);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s vectors.hex\n", argv[0]);
+        return 1;
+    }
+    FILE *out = fopen(argv[1], "w");
+    if (!out) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    // Pass 1: the latency/resolution ladder with the full chain
+    const ChannelConfig pass1[4] = {
+        {8, 5, true, true, "slow DC bus, high resolution"},
+        {6, 4, true, true, "DC bus"},
+        {5, 3, true, true, "reset default"},
+        {2, 3, true, true, "fast current loop"},
+    };
+    // Pass 2: partial chains (stage bypasses, low CIC orders)
+    const ChannelConfig pass2[4] = {
+        {7, 3, true, false, "CIC + compensator"},
+        {4, 2, false, true, "CIC + half-band"},
+        {3, 1, false, false, "boxcar only"},
+        {5, 5, true, true, "5th-order CIC"},
+    };
+
+    fprintf(out, "%08x\n", 2u);
+    printf("Pass 1:\n");
+    run_pass(out, pass1, 1u);
+    printf("Pass 2:\n");
+    run_pass(out, pass2, 101u);
+
+    fclose(out);
+    printf("Wrote 2 passes x 4 channels x %d samples to %s\n", kSamples, argv[1]);
+    return 0;
+}
@@ -0,0 +1,41 @@
+#!/bin/bash
+# Run IIR/PR accelerator testbench (bit-exact against the C fixed-point model)
+
+set -e
+
+echo "========================================"
+echo "IIR/PR Accelerator Testbench"
+echo "========================================"
+
+# Generate golden vectors
+echo "Building C fixed-point model..."
+gcc -O2 -Wall -o iir_model models/iir_model.c -lm
+./iir_model iir_vectors.hex
+
+# Compile
+echo "Compiling RTL and testbench..."
+iverilog -g2012 -o tb_iir_accelerator \
+    testbench/tb_iir_accelerator.v \
+    ../rtl/peripherals/iir_accelerator.v
+
+echo "Compilation successful!"
+echo ""
+
+# Run simulation
+echo "Running simulation..."
+echo "========================================"
+vvp tb_iir_accelerator | tee tb_iir_accelerator.log
+
+# Check result
+if grep -q "ALL TESTS PASSED" tb_iir_accelerator.log; then
+    echo ""
+    echo "========================================"
+    echo "✓ Accelerator matches the C model!"
+    echo "========================================"
+else
+    echo ""
+    echo "========================================"
+    echo "✗ IIR accelerator test failed!"
+    echo "========================================"
+    exit 1
+fi
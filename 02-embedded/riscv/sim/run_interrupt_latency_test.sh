@@ -0,0 +1,44 @@
+#!/bin/bash
+# Run interrupt latency testbench (vectored mode, priority, MDU fast-path)
+
+set -e
+
+echo "========================================"
+echo "Interrupt Latency Testbench"
+echo "========================================"
+
+# Compile
+echo "Compiling RTL and testbench..."
+iverilog -g2012 -o tb_interrupt_latency \
+    -I../rtl/core \
+    testbench/tb_interrupt_latency.v \
+    ../rtl/core/alu.v \
+    ../rtl/core/regfile.v \
+    ../rtl/core/decoder.v \
+    ../rtl/core/mdu.v \
+    ../rtl/core/csr_unit.v \
+    ../rtl/core/interrupt_controller.v \
+    ../rtl/core/exception_unit.v \
+    ../rtl/core/custom_riscv_core.v
+
+echo "Compilation successful!"
+echo ""
+
+# Run simulation
+echo "Running simulation..."
+echo "========================================"
+vvp tb_interrupt_latency | tee tb_interrupt_latency.log
+
+# Check result
+if grep -q "ALL TESTS PASSED" tb_interrupt_latency.log; then
+    echo ""
+    echo "========================================"
+    echo "✓ Interrupt latency within bound!"
+    echo "========================================"
+else
+    echo ""
+    echo "========================================"
+    echo "✗ Interrupt latency test failed!"
+    echo "========================================"
+    exit 1
+fi
@@ -0,0 +1,41 @@
+#!/bin/bash
+# Run sigma-delta ADC decimation testbench (bit-exact against the C++ model, SNR/ENOB report)
+
+set -e
+
+echo "========================================"
+echo "Sigma-Delta ADC Decimation Testbench"
+echo "========================================"
+
+# Generate golden vectors
+echo "Building C++ decimation chain model..."
+g++ -std=c++17 -O2 -Wall -o sigma_delta_model models/sigma_delta_model.cpp
+./sigma_delta_model sd_vectors.hex
+
+# Compile
+echo "Compiling RTL and testbench..."
+iverilog -g2012 -o tb_sigma_delta_adc \
+    testbench/tb_sigma_delta_adc.v \
+    ../rtl/peripherals/sigma_delta_adc.v
+
+echo "Compilation successful!"
+echo ""
+
+# Run simulation
+echo "Running simulation..."
+echo "========================================"
+vvp tb_sigma_delta_adc | tee tb_sigma_delta_adc.log
+
+# Check result
+if grep -q "ALL TESTS PASSED" tb_sigma_delta_adc.log; then
+    echo ""
+    echo "========================================"
+    echo "✓ ADC decimation chain matches the C++ model!"
+    echo "========================================"
+else
+    echo ""
+    echo "========================================"
+    echo "✗ Sigma-delta ADC test failed!"
+    echo "========================================"
+    exit 1
+fi
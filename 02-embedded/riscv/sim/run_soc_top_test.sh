@@ -94,6 +94,7 @@ RTL_FILES=(
     "$RTL_DIR/core/exception_unit.v"
     "$RTL_DIR/core/custom_riscv_core.v"
     "$RTL_DIR/core/custom_core_wrapper.v"
+    "$RTL_DIR/memory/tcm_4kb.v"
 
     # Wishbone/Bus components
     "$RTL_DIR/bus/wishbone_arbiter_2x1.v"
@@ -105,6 +106,7 @@ RTL_FILES=(
     "$RTL_DIR/peripherals/pwm_comparator.v"
     "$RTL_DIR/peripherals/pwm_accelerator.v"
     "$RTL_DIR/peripherals/sigma_delta_adc.v"
+    "$RTL_DIR/peripherals/iir_accelerator.v"
     "$RTL_DIR/peripherals/protection.v"
     "$RTL_DIR/peripherals/timer.v"
     "$RTL_DIR/peripherals/gpio.v"
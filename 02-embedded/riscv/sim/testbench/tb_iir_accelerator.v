@@ -0,0 +1,297 @@
+/**
+ * @file tb_iir_accelerator.v
+ * @brief Bit-exact check of iir_accelerator against the C fixed-point model
+ *
+ * Test vectors come from sim/models/iir_model.c (run by
+ * sim/run_iir_accelerator_test.sh), which implements the same Q4.28
+ * biquad arithmetic, rounding, saturation and output clamp in C.
+ *
+ * For every case the testbench programs the peripheral over Wishbone,
+ * feeds the ADC samples through the direct sample port (channel 3, as in
+ * soc_top) and compares every output word with the model. Case 2 uses a
+ * 50-cycle wide data-valid strobe to check that each strobe starts
+ * exactly one update.
+ *
+ * Cases (see iir_model.c):
+ *   1. Single 500 Hz low-pass, step + noise
+ *   2. PR controller at 50 Hz with the output clamp engaging
+ *   3. 4-stage cascade (PR, two notches, low-pass)
+ *   4. Same coefficients with NSTAGES = 2 (bypass of the last stages)
+ *
+ * Run with: sim/run_iir_accelerator_test.sh
+ *
+ * @author Custom RISC-V Core Team
+ * @date 2025-12-18
+ */
+
+`timescale 1ns / 1ps
+
+module tb_iir_accelerator;
+
+    //==========================================================================
+    // Parameters
+    //==========================================================================
+
+    parameter VEC_FILE  = "iir_vectors.hex";
+    parameter VEC_DEPTH = 8192;
+    parameter K         = 4;
+
+    //==========================================================================
+    // Clock and Reset
+    //==========================================================================
+
+    reg clk;
+    reg rst_n;
+
+    initial begin
+        clk = 0;
+        forever #10 clk = ~clk;  // 50 MHz
+    end
+
+    //==========================================================================
+    // DUT
+    //==========================================================================
+
+    reg  [7:0]  wb_addr;
+    reg  [31:0] wb_dat_i;
+    wire [31:0] wb_dat_o;
+    reg         wb_we;
+    reg         wb_stb;
+    wire        wb_ack;
+
+    reg  [63:0] adc_samples;
+    reg         adc_valid;
+
+    wire signed [15:0] ref_out;
+    wire        ref_valid;
+    wire        ref_drive;
+
+    iir_accelerator #(
+        .K(K)
+    ) dut (
+        .clk(clk),
+        .rst_n(rst_n),
+        .wb_addr(wb_addr),
+        .wb_dat_i(wb_dat_i),
+        .wb_dat_o(wb_dat_o),
+        .wb_we(wb_we),
+        .wb_sel(4'hF),
+        .wb_stb(wb_stb),
+        .wb_ack(wb_ack),
+        .adc_samples(adc_samples),
+        .adc_valid(adc_valid),
+        .carrier_sync(1'b0),
+        .sine_ref_in(16'sd0),
+        .ref_out(ref_out),
+        .ref_valid(ref_valid),
+        .ref_drive(ref_drive)
+    );
+
+    //==========================================================================
+    // Wishbone Tasks
+    //==========================================================================
+
+    task wb_write;
+        input [7:0]  addr;
+        input [31:0] data;
+        begin
+            @(posedge clk);
+            wb_addr <= addr;
+            wb_dat_i <= data;
+            wb_we <= 1'b1;
+            wb_stb <= 1'b1;
+            @(posedge clk);
+            while (!wb_ack) @(posedge clk);
+            wb_stb <= 1'b0;
+            wb_we <= 1'b0;
+        end
+    endtask
+
+    task wb_read;
+        input  [7:0]  addr;
+        output [31:0] data;
+        begin
+            @(posedge clk);
+            wb_addr <= addr;
+            wb_we <= 1'b0;
+            wb_stb <= 1'b1;
+            @(posedge clk);
+            while (!wb_ack) @(posedge clk);
+            data = wb_dat_o;
+            wb_stb <= 1'b0;
+        end
+    endtask
+
+    //==========================================================================
+    // Test Sequence
+    //==========================================================================
+
+    reg [31:0] vec [0:VEC_DEPTH-1];
+    integer    ptr;
+    integer    ncases, c, n, s, k, j;
+    integer    errors, case_errors, checked;
+    integer    latency, max_latency, extra;
+    integer    strobe_width;
+    reg [31:0] rd;
+    reg [31:0] nstages_c;
+    reg signed [15:0] expected;
+
+    initial begin
+        $dumpfile("tb_iir_accelerator.vcd");
+        $dumpvars(0, tb_iir_accelerator);
+
+        $display("");
+        $display("========================================");
+        $display("IIR/PR Accelerator Testbench");
+        $display("========================================");
+
+        $readmemh(VEC_FILE, vec);
+
+        rst_n = 0;
+        wb_addr = 0;
+        wb_dat_i = 0;
+        wb_we = 0;
+        wb_stb = 0;
+        adc_samples = 64'd0;
+        adc_valid = 0;
+        errors = 0;
+        checked = 0;
+        max_latency = 0;
+
+        repeat (5) @(posedge clk);
+        rst_n = 1;
+        repeat (2) @(posedge clk);
+
+        // A missing or empty vector file leaves vec[] at X: fail, do not
+        // report a pass over zero cases
+        if (^vec[0] === 1'bx || vec[0] == 0) begin
+            $display("[FAIL] No test vectors in %0s (run sim/run_iir_accelerator_test.sh)",
+                     VEC_FILE);
+            errors = errors + 1;
+            ncases = 0;
+        end else begin
+            ncases = vec[0];
+        end
+        ptr = 1;
+
+        for (c = 0; c < ncases; c = c + 1) begin
+            case_errors = 0;
+            strobe_width = (c == 1) ? 50 : 1;
+
+            // Stop, clear state and flags, load configuration
+            wb_write(8'h00, 32'h0000_0040);
+            wb_write(8'h04, 32'h0000_0006);
+            nstages_c = vec[ptr];
+            wb_write(8'h08, vec[ptr]);
+            wb_write(8'h0C, vec[ptr + 1]);
+            wb_write(8'h10, vec[ptr + 2]);
+            wb_write(8'h14, vec[ptr + 3]);
+            wb_write(8'h18, vec[ptr + 4]);
+            ptr = ptr + 5;
+            for (k = 0; k < K; k = k + 1)
+                for (j = 0; j < 5; j = j + 1)
+                    wb_write(8'h40 + 8'h20 * k + 4 * j, vec[ptr + k*5 + j]);
+            ptr = ptr + 5*K;
+            n = vec[ptr];
+            ptr = ptr + 1;
+
+            // ENABLE | PWM_DRIVE | CHANNEL(3)
+            wb_write(8'h00, 32'h0000_0033);
+
+            for (s = 0; s < n; s = s + 1) begin
+                expected = vec[ptr + 2*s + 1][15:0];
+
+                @(posedge clk);
+                adc_samples[63:48] <= vec[ptr + 2*s][15:0];
+                adc_valid <= 1'b1;
+
+                // Wait for the result while holding the strobe
+                latency = 0;
+                extra = 0;
+                @(posedge clk);
+                while (!ref_valid && latency < 200) begin
+                    latency = latency + 1;
+                    if (latency >= strobe_width) adc_valid <= 1'b0;
+                    @(posedge clk);
+                end
+                if (latency > max_latency) max_latency = latency;
+
+                if (!ref_valid) begin
+                    $display("[FAIL] Case %0d sample %0d: no output", c + 1, s);
+                    case_errors = case_errors + 1;
+                end else if (ref_out !== expected) begin
+                    if (case_errors < 5)
+                        $display("[FAIL] Case %0d sample %0d: got %0d, expected %0d",
+                                 c + 1, s, ref_out, expected);
+                    case_errors = case_errors + 1;
+                end
+                checked = checked + 1;
+
+                // Finish a wide strobe and make sure it did not retrigger
+                while (latency < strobe_width) begin
+                    latency = latency + 1;
+                    if (latency >= strobe_width) adc_valid <= 1'b0;
+                    @(posedge clk);
+                    if (ref_valid) extra = extra + 1;
+                end
+                adc_valid <= 1'b0;
+                repeat (40) begin
+                    @(posedge clk);
+                    if (ref_valid) extra = extra + 1;
+                end
+                if (extra != 0) begin
+                    $display("[FAIL] Case %0d sample %0d: %0d extra updates", c + 1, s, extra);
+                    case_errors = case_errors + 1;
+                end
+            end
+            ptr = ptr + 2*n;
+
+            // Status: saturation only expected in case 2
+            wb_read(8'h04, rd);
+            if (rd[1] !== (c == 1)) begin
+                $display("[FAIL] Case %0d: STATUS.SATURATED = %0d", c + 1, rd[1]);
+                case_errors = case_errors + 1;
+            end
+            if (rd[2] !== 1'b0) begin
+                $display("[FAIL] Case %0d: STATUS.OVERRUN set", c + 1);
+                case_errors = case_errors + 1;
+            end
+
+            if (!ref_drive) begin
+                $display("[FAIL] Case %0d: ref_drive not asserted", c + 1);
+                case_errors = case_errors + 1;
+            end
+
+            if (case_errors == 0)
+                $display("[PASS] Case %0d: %0d samples bit-exact (NSTAGES=%0d)",
+                         c + 1, n, nstages_c);
+            errors = errors + case_errors;
+        end
+
+        if (checked == 0) begin
+            $display("[FAIL] No samples checked");
+            errors = errors + 1;
+        end
+
+        // Register readback
+        wb_read(8'h24, rd);
+        if (rd == checked) begin
+            $display("[PASS] SAMPLE_CNT = %0d", rd);
+        end else begin
+            $display("[FAIL] SAMPLE_CNT = %0d, expected %0d", rd, checked);
+            errors = errors + 1;
+        end
+
+        $display("");
+        $display("Worst-case update latency: %0d cycles (K=%0d)", max_latency + 1, K);
+        $display("");
+        $display("========================================");
+        if (errors == 0)
+            $display("*** ALL TESTS PASSED! ***");
+        else
+            $display("*** %0d TEST(S) FAILED ***", errors);
+        $display("========================================");
+        $finish;
+    end
+
+endmodule
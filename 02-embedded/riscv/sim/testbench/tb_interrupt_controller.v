@@ -11,9 +11,12 @@ module tb_interrupt_controller;
     reg [15:0] peripheral_ints;
     reg        global_int_en;
     reg [31:0] mie;
+    reg [127:0] int_priority;
+    reg [31:0] fast_mask;
     wire [31:0] interrupt_lines;
     wire        interrupt_req;
     wire [31:0] interrupt_cause;
+    wire        interrupt_fast;
 
     // Instantiate interrupt controller
     interrupt_controller dut (
@@ -25,9 +28,12 @@ module tb_interrupt_controller;
         .peripheral_ints(peripheral_ints),
         .global_int_en(global_int_en),
         .mie(mie),
+        .int_priority(int_priority),
+        .fast_mask(fast_mask),
         .interrupt_lines(interrupt_lines),
         .interrupt_req(interrupt_req),
-        .interrupt_cause(interrupt_cause)
+        .interrupt_cause(interrupt_cause),
+        .interrupt_fast(interrupt_fast)
     );
 
     // Clock generation
@@ -80,6 +86,8 @@ module tb_interrupt_controller;
         peripheral_ints = 16'h0;
         global_int_en = 0;
         mie = 32'h0;
+        int_priority = 128'h0;  // All equal: fixed-order tie-break
+        fast_mask = 32'h0;
 
         #20 rst_n = 1;
         #10;
@@ -306,6 +314,58 @@ module tb_interrupt_controller;
         $display("Stress test: No X values");
         #10;
 
+        $display("\n=== Test 20: Programmed Priority Overrides Fixed Order ===");
+        int_priority = 128'h0;
+        fast_mask = 32'h0;
+        global_int_en = 1;
+        timer_int = 0;
+        external_int = 1;
+        software_int = 0;
+        peripheral_ints = 16'h0001;  // Line 16 (ADC)
+        mie = 32'h00010800;
+        #1;
+        check_32bit("Equal levels: External wins", `MCAUSE_EXTERNAL_INT, interrupt_cause);
+        int_priority[16*4 +: 4] = 4'd7;
+        #1;
+        check_32bit("Line 16 at level 7 beats External", 32'h80000010, interrupt_cause);
+        int_priority[11*4 +: 4] = 4'd9;
+        #1;
+        check_32bit("External raised to level 9 wins again", `MCAUSE_EXTERNAL_INT, interrupt_cause);
+        #10;
+
+        $display("\n=== Test 21: Equal Levels Fall Back to Fixed Order ===");
+        int_priority = 128'h0;
+        int_priority[16*4 +: 4] = 4'd5;
+        int_priority[20*4 +: 4] = 4'd5;
+        external_int = 0;
+        peripheral_ints = 16'h0011;  // Lines 16 and 20
+        mie = 32'h00110000;
+        #1;
+        check_32bit("Tie at level 5: higher line (20) wins", 32'h80000014, interrupt_cause);
+        #10;
+
+        $display("\n=== Test 22: Fast-Path Flag Follows the Winner ===");
+        int_priority = 128'h0;
+        int_priority[16*4 +: 4] = 4'd15;
+        fast_mask = 32'h00010000;    // Only line 16 may preempt
+        timer_int = 1;
+        peripheral_ints = 16'h0001;
+        mie = 32'h00010080;
+        #1;
+        check("Line 16 wins and is fast", 1'b1, interrupt_fast);
+        peripheral_ints = 16'h0000;
+        #1;
+        check("Timer wins and is not fast", 1'b0, interrupt_fast);
+        peripheral_ints = 16'h0001;
+        global_int_en = 0;
+        #1;
+        check("No fast flag when globally disabled", 1'b0, interrupt_fast);
+        timer_int = 0;
+        peripheral_ints = 16'h0;
+        fast_mask = 32'h0;
+        int_priority = 128'h0;
+        #10;
+
         $display("\n=====================================");
         $display("Test Summary: %0d/%0d tests passed", passed_tests, total_tests);
         if (passed_tests == total_tests) begin
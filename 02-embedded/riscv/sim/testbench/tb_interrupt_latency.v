@@ -0,0 +1,390 @@
+/**
+ * @file tb_interrupt_latency.v
+ * @brief Worst-case interrupt entry latency of the custom core
+ *
+ * Measures the number of cycles from a one-cycle strobe on platform line 16
+ * (the ADC/PWM control interrupt in soc_top) to the fetch of the first ISR
+ * instruction at mtvec_base + 4*16, with mtvec in vectored mode (MODE=1).
+ *
+ * The main loop keeps the core busy with a DIV (MDU busy ~35 cycles) and a
+ * load/store pair to a slave with BUS_WAIT wait states (outstanding bus
+ * access). The strobe is swept across every cycle of the loop, and every
+ * trial is bucketed by what the core was doing when the strobe arrived.
+ *
+ * Two runs:
+ *   1. Baseline - mifast = 0, the interrupt waits for the DIV to finish
+ *   2. Fast     - mifast[16] = 1, the DIV is aborted and re-executed
+ *
+ * The fast run must stay within LATENCY_BOUND cycles; the DIV result
+ * stored after every iteration is checked so an aborted-and-replayed
+ * divide is proven to give the same answer.
+ *
+ * Run with: sim/run_interrupt_latency_test.sh
+ *
+ * @author Custom RISC-V Core Team
+ * @date 2025-12-16
+ */
+
+`timescale 1ns / 1ps
+
+module tb_interrupt_latency;
+
+    //==========================================================================
+    // Parameters
+    //==========================================================================
+
+    parameter BUS_WAIT      = 6;                // Data slave wait states
+    parameter LATENCY_BOUND = 14 + BUS_WAIT;    // Fast-path worst case (cycles)
+    parameter SWEEP         = 80;               // Strobe offsets per run (> loop length)
+
+    localparam [31:0] LOOP_ADDR = 32'h0000002C;
+    localparam [31:0] VEC_BASE  = 32'h00001000;
+    localparam [31:0] VEC_ADDR  = VEC_BASE + 4*16; // Line 16
+    localparam [31:0] DIV_RESULT = 32'hFFFFFFFE;   // -7 / 3
+
+    localparam STATE_MEM    = 3'd3;
+    localparam STATE_MULDIV = 3'd5;
+
+    //==========================================================================
+    // Clock and Reset
+    //==========================================================================
+
+    reg clk;
+    reg rst_n;
+
+    initial begin
+        clk = 0;
+        forever #10 clk = ~clk;
+    end
+
+    integer cycle;
+    always @(posedge clk) begin
+        if (!rst_n) cycle <= 0;
+        else        cycle <= cycle + 1;
+    end
+
+    //==========================================================================
+    // Core Signals
+    //==========================================================================
+
+    wire [31:0] iwb_adr_o;
+    wire [31:0] iwb_dat_i;
+    wire        iwb_cyc_o;
+    wire        iwb_stb_o;
+    wire        iwb_ack_i;
+
+    wire [31:0] dwb_adr_o;
+    wire [31:0] dwb_dat_o;
+    wire [31:0] dwb_dat_i;
+    wire        dwb_we_o;
+    wire [3:0]  dwb_sel_o;
+    wire        dwb_cyc_o;
+    wire        dwb_stb_o;
+    wire        dwb_ack_i;
+    wire        dwb_err_i;
+
+    reg         irq_line;
+    wire [31:0] interrupts = {15'd0, irq_line, 16'd0};
+
+    custom_riscv_core #(
+        .RESET_VECTOR(32'h00000000)
+    ) dut (
+        .clk(clk),
+        .rst_n(rst_n),
+        .iwb_adr_o(iwb_adr_o),
+        .iwb_dat_i(iwb_dat_i),
+        .iwb_cyc_o(iwb_cyc_o),
+        .iwb_stb_o(iwb_stb_o),
+        .iwb_ack_i(iwb_ack_i),
+        .dwb_adr_o(dwb_adr_o),
+        .dwb_dat_o(dwb_dat_o),
+        .dwb_dat_i(dwb_dat_i),
+        .dwb_we_o(dwb_we_o),
+        .dwb_sel_o(dwb_sel_o),
+        .dwb_cyc_o(dwb_cyc_o),
+        .dwb_stb_o(dwb_stb_o),
+        .dwb_ack_i(dwb_ack_i),
+        .dwb_err_i(dwb_err_i),
+        .interrupts(interrupts)
+    );
+
+    //==========================================================================
+    // Instruction Memory (8 KB, registered ack like tb_core)
+    //==========================================================================
+
+    reg [31:0] imem [0:2047];
+    reg        imem_ack;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n)
+            imem_ack <= 1'b0;
+        else
+            imem_ack <= iwb_cyc_o && iwb_stb_o && !imem_ack;
+    end
+
+    assign iwb_dat_i = imem[iwb_adr_o[12:2]];
+    assign iwb_ack_i = imem_ack;
+
+    //==========================================================================
+    // Slow Data Slave (BUS_WAIT wait states)
+    //==========================================================================
+
+    reg        dmem_ack;
+    reg [7:0]  wait_cnt;
+    integer    store_count;
+    integer    store_errors;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            dmem_ack <= 1'b0;
+            wait_cnt <= 8'd0;
+        end else if (dwb_cyc_o && dwb_stb_o && !dmem_ack) begin
+            if (wait_cnt == BUS_WAIT) begin
+                dmem_ack <= 1'b1;
+                wait_cnt <= 8'd0;
+                if (dwb_we_o) begin
+                    store_count = store_count + 1;
+                    if (dwb_dat_o !== DIV_RESULT) begin
+                        store_errors = store_errors + 1;
+                        $display("[FAIL] DIV result 0x%08h after replay (expected 0x%08h)",
+                                 dwb_dat_o, DIV_RESULT);
+                    end
+                end
+            end else begin
+                wait_cnt <= wait_cnt + 8'd1;
+            end
+        end else begin
+            dmem_ack <= 1'b0;
+        end
+    end
+
+    assign dwb_dat_i = 32'h12345678;
+    assign dwb_ack_i = dmem_ack;
+    assign dwb_err_i = 1'b0;
+
+    //==========================================================================
+    // Test Program
+    //==========================================================================
+
+    /*
+     * 0x00: lui   x1, 0x1          # x1 = 0x1000 (vector table)
+     * 0x04: addi  x1, x1, 1        # MODE = 1 (vectored)
+     * 0x08: csrrw x0, mtvec, x1
+     * 0x0C: lui   x2, 0x10         # x2 = 1 << 16 (line 16)
+     * 0x10: csrrw x0, mie, x2
+     * 0x14: csrrw x0, mifast, x2   # (baseline: csrrw x0, mifast, x0)
+     * 0x18: lui   x9, 0x20         # x9 = 0x20000 (slow slave)
+     * 0x1C: addi  x5, x0, -7
+     * 0x20: addi  x6, x0, 3
+     * 0x24: addi  x3, x0, 8
+     * 0x28: csrrs x0, mstatus, x3  # MIE = 1
+     * 0x2C: loop: div x7, x5, x6
+     * 0x30: lw    x8, 0(x9)
+     * 0x34: sw    x7, 4(x9)
+     * 0x38: jal   x0, loop
+     *
+     * 0x1040: mret                 # Vector 16: ISR is a bare return
+     */
+
+    task load_program;
+        input fast;
+        integer k;
+        begin
+            for (k = 0; k < 2048; k = k + 1)
+                imem[k] = 32'h0000006F;             // jal x0, 0 (trap catcher)
+
+            imem[0]  = 32'h000010B7;
+            imem[1]  = 32'h00108093;
+            imem[2]  = 32'h30509073;
+            imem[3]  = 32'h00010137;
+            imem[4]  = 32'h30411073;
+            imem[5]  = fast ? 32'h7C411073 : 32'h7C401073;
+            imem[6]  = 32'h000204B7;
+            imem[7]  = 32'hFF900293;
+            imem[8]  = 32'h00300313;
+            imem[9]  = 32'h00800193;
+            imem[10] = 32'h3001A073;
+            imem[11] = 32'h0262C3B3;
+            imem[12] = 32'h0004A403;
+            imem[13] = 32'h0074A223;
+            imem[14] = 32'hFF5FF06F;
+
+            imem[VEC_ADDR[12:2]] = 32'h30200073;    // mret
+        end
+    endtask
+
+    //==========================================================================
+    // Latency Measurement
+    //==========================================================================
+
+    integer t_irq;
+    integer latency;
+    reg     vec_seen;
+    reg     wrong_vector;
+
+    always @(posedge clk) begin
+        if (rst_n && iwb_cyc_o && iwb_stb_o && !vec_seen) begin
+            if (iwb_adr_o == VEC_ADDR) begin
+                latency = cycle - t_irq;
+                vec_seen = 1'b1;
+            end else if (iwb_adr_o >= VEC_BASE) begin
+                wrong_vector = 1'b1;
+            end
+        end
+    end
+
+    task wait_fetch;
+        input [31:0] addr;
+        begin
+            @(posedge clk);
+            while (!(iwb_cyc_o && iwb_stb_o && iwb_ack_i && iwb_adr_o == addr))
+                @(posedge clk);
+        end
+    endtask
+
+    // Per-run maxima: [0] any, [1] MDU busy, [2] data bus outstanding
+    integer max_lat [0:2];
+    integer n_trials [0:2];
+    integer timeouts;
+    integer fast_max [0:2];
+    integer base_max [0:2];
+    integer errors;
+
+    task run_sweep;
+        input fast;
+        integer d;
+        integer bucket;
+        integer guard;
+        begin
+            load_program(fast);
+            max_lat[0] = 0;  max_lat[1] = 0;  max_lat[2] = 0;
+            n_trials[0] = 0; n_trials[1] = 0; n_trials[2] = 0;
+            timeouts = 0;
+            irq_line = 1'b0;
+            vec_seen = 1'b1;
+
+            rst_n = 0;
+            repeat (5) @(posedge clk);
+            rst_n = 1;
+            wait_fetch(LOOP_ADDR);
+
+            for (d = 0; d < SWEEP; d = d + 1) begin
+                wait_fetch(LOOP_ADDR);
+                repeat (d) @(posedge clk);
+
+                // One-cycle strobe, like sigma_delta_adc's irq
+                #1;
+                bucket = (dut.state == STATE_MULDIV) ? 1 :
+                         (dut.state == STATE_MEM)    ? 2 : 0;
+                t_irq = cycle;
+                vec_seen = 1'b0;
+                irq_line = 1'b1;
+                @(posedge clk);
+                #1 irq_line = 1'b0;
+
+                guard = 0;
+                while (!vec_seen && guard < 500) begin
+                    @(posedge clk);
+                    guard = guard + 1;
+                end
+
+                if (!vec_seen) begin
+                    timeouts = timeouts + 1;
+                    vec_seen = 1'b1;
+                end else begin
+                    n_trials[0] = n_trials[0] + 1;
+                    if (latency > max_lat[0]) max_lat[0] = latency;
+                    if (bucket != 0) begin
+                        n_trials[bucket] = n_trials[bucket] + 1;
+                        if (latency > max_lat[bucket]) max_lat[bucket] = latency;
+                    end
+                end
+            end
+
+            $display("  trials: %0d (MDU busy: %0d, bus outstanding: %0d), missed: %0d",
+                     n_trials[0], n_trials[1], n_trials[2], timeouts);
+            $display("  worst-case latency: any = %0d, MDU busy = %0d, bus outstanding = %0d cycles",
+                     max_lat[0], max_lat[1], max_lat[2]);
+        end
+    endtask
+
+    initial begin
+        $dumpfile("tb_interrupt_latency.vcd");
+        $dumpvars(0, tb_interrupt_latency);
+
+        errors = 0;
+        store_count = 0;
+        store_errors = 0;
+        wrong_vector = 1'b0;
+        t_irq = 0;
+        rst_n = 0;
+
+        $display("");
+        $display("=========================================");
+        $display("Interrupt Latency Testbench (BUS_WAIT=%0d)", BUS_WAIT);
+        $display("=========================================");
+
+        $display("\nRun 1: baseline (mifast = 0)");
+        run_sweep(1'b0);
+        base_max[0] = max_lat[0]; base_max[1] = max_lat[1]; base_max[2] = max_lat[2];
+        if (timeouts != 0) errors = errors + 1;
+
+        $display("\nRun 2: fast-path (mifast[16] = 1)");
+        run_sweep(1'b1);
+        fast_max[0] = max_lat[0]; fast_max[1] = max_lat[1]; fast_max[2] = max_lat[2];
+        if (timeouts != 0) errors = errors + 1;
+
+        $display("\n=========================================");
+        $display("Results");
+        $display("=========================================");
+
+        if (timeouts == 0 && fast_max[0] <= LATENCY_BOUND) begin
+            $display("[PASS] Fast-path worst case %0d <= bound %0d cycles", fast_max[0], LATENCY_BOUND);
+        end else begin
+            $display("[FAIL] Fast-path worst case %0d > bound %0d cycles", fast_max[0], LATENCY_BOUND);
+            errors = errors + 1;
+        end
+
+        if (n_trials[1] > 0 && fast_max[1] < base_max[1]) begin
+            $display("[PASS] MDU busy: %0d -> %0d cycles (DIV aborted and replayed)",
+                     base_max[1], fast_max[1]);
+        end else begin
+            $display("[FAIL] MDU busy: fast-path %0d not below baseline %0d", fast_max[1], base_max[1]);
+            errors = errors + 1;
+        end
+
+        $display("[INFO] Bus outstanding: %0d -> %0d cycles (access always completes)",
+                 base_max[2], fast_max[2]);
+
+        if (store_errors == 0 && store_count > 0) begin
+            $display("[PASS] %0d DIV results correct across aborts", store_count);
+        end else begin
+            $display("[FAIL] %0d of %0d DIV results wrong", store_errors, store_count);
+            errors = errors + 1;
+        end
+
+        if (!wrong_vector) begin
+            $display("[PASS] Only vector 16 was ever fetched");
+        end else begin
+            $display("[FAIL] Fetch from a vector other than 16");
+            errors = errors + 1;
+        end
+
+        $display("");
+        if (errors == 0)
+            $display("*** ALL TESTS PASSED! ***");
+        else
+            $display("*** %0d TESTS FAILED ***", errors);
+        $display("=========================================");
+
+        $finish;
+    end
+
+    // Global timeout
+    initial begin
+        #50_000_000;
+        $display("[FAIL] Global timeout");
+        $finish;
+    end
+
+endmodule
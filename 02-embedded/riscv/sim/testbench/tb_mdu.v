@@ -15,6 +15,7 @@ module tb_mdu;
         .clk(clk),
         .rst_n(rst_n),
         .start(start),
+        .abort(1'b0),
         .funct3(funct3),
         .a(a),
         .b(b),
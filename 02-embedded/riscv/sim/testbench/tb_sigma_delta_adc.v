@@ -0,0 +1,394 @@
+/**
+ * @file tb_sigma_delta_adc.v
+ * @brief Decimation chain check and SNR/ENOB report for sigma_delta_adc
+ *
+ * Test vectors come from sim/models/sigma_delta_model.cpp (run by
+ * sim/run_sigma_delta_test.sh). The model simulates the RC/LM339 loop for
+ * a sine input on every channel and records the comparator decision at
+ * each modulator tick; the testbench replays those decisions on comp_in,
+ * so the DUT's DAC sequence and every DATA_CHx word must match the model
+ * exactly.
+ *
+ * Each pass programs a different CFG_CHx on all four channels (so fast
+ * and slow settings run side by side), checks the results bit-exact,
+ * then fits a sine to the settled samples and prints SNR/ENOB and output
+ * rate per setting.
+ *
+ * Passes (see sigma_delta_model.cpp):
+ *   1. Full chain, total decimation 512 / 128 / 64 / 8
+ *      (ENOB must fall monotonically with the decimation)
+ *   2. Stage bypasses: no half-band, no compensator, boxcar, 5th order
+ *
+ * The modulator runs at CLK_FREQ / 4 to keep the run short; the filter
+ * chain only sees ticks, so rates are reported for the real 1 MHz.
+ *
+ * Run with: sim/run_sigma_delta_test.sh
+ *
+ * @author Custom RISC-V Core Team
+ * @date 2025-12-19
+ */
+
+`timescale 1ns / 1ps
+
+module tb_sigma_delta_adc;
+
+    //==========================================================================
+    // Parameters
+    //==========================================================================
+
+    parameter VEC_FILE  = "sd_vectors.hex";
+    parameter VEC_DEPTH = 131072;
+    parameter MAX_NS    = 256;          // Result buffer per channel
+
+    //==========================================================================
+    // Clock and Reset
+    //==========================================================================
+
+    reg clk;
+    reg rst_n;
+
+    initial begin
+        clk = 0;
+        forever #10 clk = ~clk;  // 50 MHz
+    end
+
+    //==========================================================================
+    // DUT
+    //==========================================================================
+
+    reg  [7:0]  wb_addr;
+    reg  [31:0] wb_dat_i;
+    wire [31:0] wb_dat_o;
+    reg         wb_we;
+    reg         wb_stb;
+    wire        wb_ack;
+
+    reg  [3:0]  comp_in;
+    wire [3:0]  dac_out;
+    wire        irq;
+    wire [63:0] samples;
+
+    sigma_delta_adc #(
+        .CLK_FREQ(4_000_000),           // 4 clocks per modulator tick
+        .MOD_FREQ(1_000_000)
+    ) dut (
+        .clk(clk),
+        .rst_n(rst_n),
+        .wb_addr(wb_addr),
+        .wb_dat_i(wb_dat_i),
+        .wb_dat_o(wb_dat_o),
+        .wb_we(wb_we),
+        .wb_sel(4'hF),
+        .wb_stb(wb_stb),
+        .wb_ack(wb_ack),
+        .comp_in(comp_in),
+        .dac_out(dac_out),
+        .irq(irq),
+        .samples(samples)
+    );
+
+    //==========================================================================
+    // Wishbone Tasks
+    //==========================================================================
+
+    task wb_write;
+        input [7:0]  addr;
+        input [31:0] data;
+        begin
+            @(posedge clk);
+            wb_addr <= addr;
+            wb_dat_i <= data;
+            wb_we <= 1'b1;
+            wb_stb <= 1'b1;
+            @(posedge clk);
+            while (!wb_ack) @(posedge clk);
+            wb_stb <= 1'b0;
+            wb_we <= 1'b0;
+        end
+    endtask
+
+    task wb_read;
+        input  [7:0]  addr;
+        output [31:0] data;
+        begin
+            @(posedge clk);
+            wb_addr <= addr;
+            wb_we <= 1'b0;
+            wb_stb <= 1'b1;
+            @(posedge clk);
+            while (!wb_ack) @(posedge clk);
+            data = wb_dat_o;
+            wb_stb <= 1'b0;
+        end
+    endtask
+
+    //==========================================================================
+    // Comparator Replay and Result Capture
+    //==========================================================================
+
+    reg [31:0] vec [0:VEC_DEPTH-1];
+    reg [15:0] got [0:4*MAX_NS-1];
+    integer    count [0:3];
+    integer    comp_base, nticks, tick_idx;
+    integer    ns;
+    integer    irq_pulses, irq_errors;
+    reg        running;
+
+    wire [3:0]  out_valid = dut.adc_data_valid;
+    wire [15:0] out_data [0:3];
+
+    assign out_data[0] = dut.adc_ch0;
+    assign out_data[1] = dut.adc_ch1;
+    assign out_data[2] = dut.adc_ch2;
+    assign out_data[3] = dut.adc_ch3;
+
+    integer    cap;
+    reg [15:0] last_ch3;
+    reg        irq_d;
+
+    always @(posedge clk) begin
+        if (running) begin
+            // Next comparator decision after each modulator tick
+            if (dut.adc_ch0_inst.mod_tick) begin
+                tick_idx <= tick_idx + 1;
+                comp_in <= (tick_idx + 1 < nticks) ? vec[comp_base + tick_idx + 1][3:0] : 4'h0;
+            end
+
+            for (cap = 0; cap < 4; cap = cap + 1) begin
+                if (out_valid[cap] && count[cap] < ns) begin
+                    got[cap*MAX_NS + count[cap]] <= out_data[cap];
+                    count[cap] <= count[cap] + 1;
+                end
+            end
+        end
+
+        // irq follows channel 3: one cycle, with the new word on the tap
+        if (out_valid[3]) last_ch3 <= out_data[3];
+        irq_d <= irq;
+        if (irq) begin
+            irq_pulses <= irq_pulses + 1;
+            if (irq_d || samples[63:48] !== last_ch3)
+                irq_errors <= irq_errors + 1;
+        end
+    end
+
+    //==========================================================================
+    // Test Sequence
+    //==========================================================================
+
+    integer    ptr, npasses, p, s, ch, nskip, ncycles;
+    integer    errors, pass_errors, timeout, checked;
+    reg [31:0] rd;
+    reg [31:0] cfg [0:3];
+    reg [15:0] expected;
+
+    real       w, x, a, b, c, err, snr, enob, rate;
+    real       enob_prev;
+    integer    n, decim;
+
+    initial begin
+        $dumpfile("tb_sigma_delta_adc.vcd");
+        $dumpvars(1, tb_sigma_delta_adc);
+
+        $display("");
+        $display("========================================");
+        $display("Sigma-Delta ADC Decimation Testbench");
+        $display("========================================");
+
+        $readmemh(VEC_FILE, vec);
+
+        rst_n = 0;
+        wb_addr = 0;
+        wb_dat_i = 0;
+        wb_we = 0;
+        wb_stb = 0;
+        comp_in = 4'h0;
+        running = 0;
+        irq_d = 0;
+        last_ch3 = 16'd0;
+        tick_idx = 0;
+        nticks = 0;
+        comp_base = 0;
+        ns = 0;
+        irq_pulses = 0;
+        irq_errors = 0;
+        errors = 0;
+        checked = 0;
+        for (ch = 0; ch < 4; ch = ch + 1) count[ch] = 0;
+
+        repeat (5) @(posedge clk);
+        rst_n = 1;
+        repeat (2) @(posedge clk);
+
+        // Reset configuration: k = 5, N = 3, compensator and half-band on
+        wb_read(8'h1C, rd);
+        if (rd == 32'h0000_0335) begin
+            $display("[PASS] CFG_CH0 reset value 0x%03h", rd);
+        end else begin
+            $display("[FAIL] CFG_CH0 reset value 0x%08h, expected 0x335", rd);
+            errors = errors + 1;
+        end
+
+        // Out-of-range fields are clamped
+        wb_write(8'h28, 32'h0000_007F);
+        wb_read(8'h28, rd);
+        if (rd == 32'h0000_0058) begin
+            $display("[PASS] CFG_CH3 clamps k=15, N=7 to k=8, N=5");
+        end else begin
+            $display("[FAIL] CFG_CH3 clamp readback 0x%08h, expected 0x58", rd);
+            errors = errors + 1;
+        end
+
+        // A missing or empty vector file leaves vec[] at X: fail, do not
+        // report a pass over zero passes
+        if (^vec[0] === 1'bx || vec[0] == 0) begin
+            $display("[FAIL] No test vectors in %0s (run sim/run_sigma_delta_test.sh)",
+                     VEC_FILE);
+            errors = errors + 1;
+            npasses = 0;
+        end else begin
+            npasses = vec[0];
+        end
+        ptr = 1;
+
+        for (p = 0; p < npasses; p = p + 1) begin
+            pass_errors = 0;
+
+            // Stop (IRQ on channel 3), load and restart every channel
+            wb_write(8'h00, 32'h0000_0030);
+            for (ch = 0; ch < 4; ch = ch + 1) begin
+                cfg[ch] = vec[ptr + ch];
+                wb_write(8'h1C + 4*ch, cfg[ch]);
+            end
+            ns      = vec[ptr + 4];
+            nskip   = vec[ptr + 5];
+            ncycles = vec[ptr + 6];
+            nticks  = vec[ptr + 7];
+            ptr = ptr + 8;
+            comp_base = ptr + 4*ns;
+
+            for (ch = 0; ch < 4; ch = ch + 1) count[ch] = 0;
+            tick_idx = 0;
+            comp_in = vec[comp_base][3:0];
+            running = 1;
+
+            wb_write(8'h00, 32'h0000_0031);
+
+            timeout = 0;
+            while ((count[0] < ns || count[1] < ns || count[2] < ns || count[3] < ns) &&
+                   timeout < 4 * (nticks + 64)) begin
+                @(posedge clk);
+                timeout = timeout + 1;
+            end
+            wb_write(8'h00, 32'h0000_0030);
+            running = 0;
+
+            // Bit-exact comparison
+            for (ch = 0; ch < 4; ch = ch + 1) begin
+                if (count[ch] < ns) begin
+                    $display("[FAIL] Pass %0d CH%0d: only %0d of %0d results",
+                             p + 1, ch, count[ch], ns);
+                    pass_errors = pass_errors + 1;
+                end
+                for (s = 0; s < count[ch]; s = s + 1) begin
+                    expected = vec[ptr + ch*ns + s][15:0];
+                    if (got[ch*MAX_NS + s] !== expected) begin
+                        if (pass_errors < 5)
+                            $display("[FAIL] Pass %0d CH%0d sample %0d: got 0x%04h, expected 0x%04h",
+                                     p + 1, ch, s, got[ch*MAX_NS + s], expected);
+                        pass_errors = pass_errors + 1;
+                    end
+                    checked = checked + 1;
+                end
+            end
+            ptr = comp_base + nticks;
+
+            if (pass_errors == 0)
+                $display("[PASS] Pass %0d: 4 x %0d results bit-exact", p + 1, ns);
+
+            // SNR/ENOB from a 3-parameter sine fit over the settled samples
+            n = ns - nskip;
+            w = 2.0 * 3.14159265358979 * ncycles / n;
+            enob_prev = 100.0;
+            for (ch = 0; ch < 4; ch = ch + 1) begin
+                a = 0.0;
+                b = 0.0;
+                c = 0.0;
+                for (s = 0; s < n; s = s + 1) begin
+                    x = got[ch*MAX_NS + nskip + s];
+                    x = x - 32768.0;
+                    a = a + x * $sin(w * s);
+                    b = b + x * $cos(w * s);
+                    c = c + x;
+                end
+                a = a * 2.0 / n;
+                b = b * 2.0 / n;
+                c = c / n;
+                err = 0.0;
+                for (s = 0; s < n; s = s + 1) begin
+                    x = got[ch*MAX_NS + nskip + s];
+                    x = x - 32768.0 - (a * $sin(w * s) + b * $cos(w * s) + c);
+                    err = err + x * x;
+                end
+                snr = 10.0 * $log10(((a * a + b * b) / 2.0) / (err / n));
+                enob = (snr - 1.76) / 6.02;
+
+                decim = (1 << cfg[ch][3:0]) * (cfg[ch][9] ? 2 : 1);
+                rate = 1.0e6 / decim;
+                $display("       CH%0d k=%0d N=%0d comp=%0d hb=%0d  D=%3d  %8.1f Hz  SNR %5.1f dB  ENOB %5.2f",
+                         ch, cfg[ch][3:0], cfg[ch][6:4], cfg[ch][8], cfg[ch][9],
+                         decim, rate, snr, enob);
+
+                // Pass 1 is ordered from slowest to fastest
+                if (p == 0) begin
+                    if (enob >= enob_prev) begin
+                        $display("[FAIL] Pass 1 CH%0d: ENOB does not drop with decimation", ch);
+                        pass_errors = pass_errors + 1;
+                    end
+                    enob_prev = enob;
+                end
+            end
+
+            errors = errors + pass_errors;
+        end
+
+        if (checked == 0) begin
+            $display("[FAIL] No results checked");
+            errors = errors + 1;
+        end
+
+        // Interrupt, counters and flags
+        wb_read(8'h18, rd);
+        if (irq_errors == 0 && rd == irq_pulses && irq_pulses > 0) begin
+            $display("[PASS] irq: %0d one-cycle pulses on CH3, SAMPLE_CNT matches", irq_pulses);
+        end else begin
+            $display("[FAIL] irq pulses %0d, SAMPLE_CNT %0d, tap mismatches %0d",
+                     irq_pulses, rd, irq_errors);
+            errors = errors + 1;
+        end
+
+        wb_read(8'h04, rd);
+        if (rd[3:0] !== 4'hF) begin
+            $display("[FAIL] STATUS = 0x%01h, expected all channels valid", rd[3:0]);
+            errors = errors + 1;
+        end
+        wb_read(8'h08, rd);
+        wb_read(8'h04, rd);
+        if (rd[3:0] == 4'hE) begin
+            $display("[PASS] Reading DATA_CH0 clears only its valid flag");
+        end else begin
+            $display("[FAIL] STATUS after DATA_CH0 read = 0x%01h", rd[3:0]);
+            errors = errors + 1;
+        end
+
+        $display("");
+        $display("========================================");
+        if (errors == 0)
+            $display("*** ALL TESTS PASSED! ***");
+        else
+            $display("*** %0d TEST(S) FAILED ***", errors);
+        $display("========================================");
+        $finish;
+    end
+
+endmodule
@@ -0,0 +1,463 @@
+/**
+ * @file tb_tcm.v
+ * @brief Tightly-coupled memory (TCM) bypass and cycle-count measurement
+ *
+ * Instantiates custom_core_wrapper (core + 4 KB TCM) behind the same
+ * wishbone_arbiter_2x1 used in soc_top, with a registered-ack ROM model at
+ * 0x0 and ram_64kb at 0x10000, so RAM accesses see the real SoC wait
+ * states (arbiter grant + registered ack). A registered-ack register model
+ * at 0x20000 stands in for the PWM and ADC peripherals.
+ *
+ * The program runs the same 8 x {lw, add, sw} block twice, once against
+ * RAM and once against the TCM, bracketing each with csrr mcycle. It then
+ * copies a two-instruction routine into the TCM and calls it to exercise
+ * the instruction port (.tcm_text).
+ *
+ * Finally it calls pr_controller_run() (firmware/pr_controller, as compiled
+ * at -O2: ADC read, ZPEC.SINCOS, PWM reference write) once from the main
+ * image and once from a copy in the TCM, as .tcm_text places it, and
+ * reports both mcycle figures. Its peripheral accesses cross the SoC bus
+ * either way; only the fetches move.
+ *
+ * Checks:
+ *   1. Both blocks compute the same result (8 * 5 = 40)
+ *   2. The TCM block saves at least one cycle per load/store
+ *   3. No TCM access ever appears on the external (SoC) buses
+ *   4. Code fetched from the TCM executes correctly
+ *   5. pr_controller_run writes the same PWM reference from both copies
+ *   6. pr_controller_run from the TCM is no slower than from the image
+ *
+ * Run with: sim/run_tcm_test.sh (core built with ZPEC_ENABLED, as soc_top)
+ *
+ * @author Custom RISC-V Core Team
+ * @date 2025-12-17
+ */
+
+`timescale 1ns / 1ps
+
+module tb_tcm;
+
+    //==========================================================================
+    // Parameters
+    //==========================================================================
+
+    parameter TIMEOUT = 20000;                  // Cycles
+
+    localparam [31:0] TCM_BASE  = 32'h00030000;
+    localparam [31:0] DONE_ADDR = 32'h00000134;
+    localparam        ACCESSES  = 16;           // Loads + stores per block
+    localparam [31:0] EXPECTED  = 32'd40;       // 8 * 5
+    localparam        PR_WORDS  = 7;            // pr_controller_run length
+
+    localparam [31:0] PWM_CPU_REFERENCE = 32'h00020020;
+    localparam [31:0] ADC_SAMPLE        = 32'h00000123;   // ADC->DATA_CH3
+
+    //==========================================================================
+    // Clock and Reset
+    //==========================================================================
+
+    reg clk;
+    reg rst_n;
+
+    initial begin
+        clk = 0;
+        forever #10 clk = ~clk;
+    end
+
+    //==========================================================================
+    // Core Wrapper (core + TCM)
+    //==========================================================================
+
+    wire [31:0] ibus_addr;
+    wire        ibus_cyc;
+    wire        ibus_stb;
+    wire        ibus_ack;
+    wire [31:0] ibus_dat_i;
+
+    wire [31:0] dbus_addr;
+    wire [31:0] dbus_dat_o;
+    wire [31:0] dbus_dat_i;
+    wire        dbus_we;
+    wire [3:0]  dbus_sel;
+    wire        dbus_cyc;
+    wire        dbus_stb;
+    wire        dbus_ack;
+    wire        dbus_err;
+
+    custom_core_wrapper dut (
+        .clk(clk),
+        .rst_n(rst_n),
+        .ibus_addr(ibus_addr),
+        .ibus_cyc(ibus_cyc),
+        .ibus_stb(ibus_stb),
+        .ibus_ack(ibus_ack),
+        .ibus_dat_i(ibus_dat_i),
+        .dbus_addr(dbus_addr),
+        .dbus_dat_o(dbus_dat_o),
+        .dbus_dat_i(dbus_dat_i),
+        .dbus_we(dbus_we),
+        .dbus_sel(dbus_sel),
+        .dbus_cyc(dbus_cyc),
+        .dbus_stb(dbus_stb),
+        .dbus_ack(dbus_ack),
+        .dbus_err(dbus_err),
+        .external_interrupt(32'h0)
+    );
+
+    //==========================================================================
+    // Arbiter (as in soc_top)
+    //==========================================================================
+
+    wire [31:0] m_addr;
+    wire [31:0] m_dat_o;
+    wire [31:0] m_dat_i;
+    wire        m_we;
+    wire [3:0]  m_sel;
+    wire        m_stb;
+    wire        m_cyc;
+    wire        m_ack;
+
+    wishbone_arbiter_2x1 arbiter (
+        .clk(clk),
+        .rst_n(rst_n),
+        .s0_wb_addr(ibus_addr),
+        .s0_wb_dat_i(32'h0),
+        .s0_wb_dat_o(ibus_dat_i),
+        .s0_wb_we(1'b0),
+        .s0_wb_sel(4'b1111),
+        .s0_wb_stb(ibus_stb),
+        .s0_wb_cyc(ibus_cyc),
+        .s0_wb_ack(ibus_ack),
+        .s0_wb_err(),
+        .s1_wb_addr(dbus_addr),
+        .s1_wb_dat_i(dbus_dat_o),
+        .s1_wb_dat_o(dbus_dat_i),
+        .s1_wb_we(dbus_we),
+        .s1_wb_sel(dbus_sel),
+        .s1_wb_stb(dbus_stb),
+        .s1_wb_cyc(dbus_cyc),
+        .s1_wb_ack(dbus_ack),
+        .s1_wb_err(dbus_err),
+        .m_wb_addr(m_addr),
+        .m_wb_dat_o(m_dat_o),
+        .m_wb_dat_i(m_dat_i),
+        .m_wb_we(m_we),
+        .m_wb_sel(m_sel),
+        .m_wb_stb(m_stb),
+        .m_wb_cyc(m_cyc),
+        .m_wb_ack(m_ack),
+        .m_wb_err(1'b0)
+    );
+
+    //==========================================================================
+    // Slaves: ROM model (0x0, registered ack like rom_32kb), ram_64kb and a
+    // peripheral model (0x20000, registered ack like pwm_accelerator)
+    //==========================================================================
+
+    wire sel_rom    = (m_addr < 32'h00008000);
+    wire sel_ram    = (m_addr >= 32'h00010000) && (m_addr < 32'h00020000);
+    wire sel_periph = (m_addr >= 32'h00020000) && (m_addr < 32'h00030000);
+
+    reg  [31:0] rom [0:2047];
+    reg  [31:0] rom_dat;
+    reg         rom_ack;
+
+    always @(posedge clk) begin
+        if (m_cyc && m_stb && sel_rom) begin
+            rom_dat <= rom[m_addr[12:2]];
+            rom_ack <= 1'b1;
+        end else begin
+            rom_ack <= 1'b0;
+        end
+    end
+
+    wire [31:0] ram_dat;
+    wire        ram_ack;
+
+    ram_64kb ram (
+        .clk(clk),
+        .addr(m_addr[15:0]),
+        .data_in(m_dat_o),
+        .we(m_we),
+        .be(m_sel),
+        .stb(m_cyc && m_stb && sel_ram),
+        .data_out(ram_dat),
+        .ack(ram_ack)
+    );
+
+    // Reads return the ADC sample; PWM reference writes are recorded
+    reg         periph_ack;
+    integer     pwm_writes;
+    reg  [31:0] pwm_ref [0:1];
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            periph_ack <= 1'b0;
+        end else begin
+            periph_ack <= m_cyc && m_stb && sel_periph && !periph_ack;
+            if (m_cyc && m_stb && sel_periph && m_we && !periph_ack &&
+                m_addr == PWM_CPU_REFERENCE) begin
+                if (pwm_writes < 2)
+                    pwm_ref[pwm_writes] <= m_dat_o;
+                pwm_writes <= pwm_writes + 1;
+            end
+        end
+    end
+
+    assign m_dat_i = sel_rom ? rom_dat : (sel_periph ? ADC_SAMPLE : ram_dat);
+    assign m_ack   = sel_rom ? rom_ack : (sel_ram ? ram_ack :
+                     (sel_periph ? periph_ack : 1'b0));
+
+    //==========================================================================
+    // Bus Monitors
+    //==========================================================================
+
+    integer ext_tcm_accesses;
+    integer tcm_fetches;
+
+    always @(posedge clk) begin
+        if (rst_n) begin
+            if ((dbus_cyc && (dbus_addr & 32'hFFFFF000) == TCM_BASE) ||
+                (ibus_cyc && (ibus_addr & 32'hFFFFF000) == TCM_BASE))
+                ext_tcm_accesses = ext_tcm_accesses + 1;
+            if (dut.cpu_ibus_cyc && dut.cpu_ibus_ack && dut.ibus_tcm_hit)
+                tcm_fetches = tcm_fetches + 1;
+        end
+    end
+
+    //==========================================================================
+    // Test Program
+    //==========================================================================
+
+    /*
+     * 0x00: lui   x20, 0x10         # x20 = 0x10000 (RAM)
+     * 0x04: lui   x21, 0x30         # x21 = 0x30000 (TCM)
+     * 0x08: addi  x1, x0, 5
+     * 0x0C: csrr  x10, mcycle
+     * 0x10: 8 x { lw x2, 0(x20); add x2, x2, x1; sw x2, 0(x20) }
+     * 0x70: csrr  x11, mcycle
+     * 0x74: csrr  x12, mcycle
+     * 0x78: 8 x { lw x2, 0(x21); add x2, x2, x1; sw x2, 0(x21) }
+     * 0xD8: csrr  x13, mcycle
+     * 0xDC: lw    x3, 0x200(x0)     # copy routine ROM -> TCM + 0x100
+     * 0xE0: sw    x3, 0x100(x21)
+     * 0xE4: lw    x3, 0x204(x0)
+     * 0xE8: sw    x3, 0x104(x21)
+     * 0xEC: jalr  x1, 0x100(x21)    # call it
+     * 0xF0: lw    x14, 0(x20)
+     * 0xF4: lw    x15, 0(x21)
+     * 0xF8: addi  x5, x0, 0x300     # copy pr_controller_run ROM -> TCM + 0x200
+     * 0xFC: addi  x7, x21, 0x200
+     * 0x100: addi x8, x0, 7
+     * 0x104: lw   x3, 0(x5)
+     * 0x108: sw   x3, 0(x7)
+     * 0x10C: addi x5, x5, 4
+     * 0x110: addi x7, x7, 4
+     * 0x114: addi x8, x8, -1
+     * 0x118: bne  x8, x0, 0x104
+     * 0x11C: csrr x16, mcycle
+     * 0x120: jal  x1, 0x300         # pr_controller_run from the image
+     * 0x124: csrr x17, mcycle
+     * 0x128: csrr x18, mcycle
+     * 0x12C: jalr x1, 0x200(x21)    # pr_controller_run from the TCM
+     * 0x130: csrr x19, mcycle
+     * 0x134: jal  x0, 0             # done
+     *
+     * 0x200: addi x6, x0, 0x55      # routine (runs from TCM)
+     * 0x204: jalr x0, 0(x1)
+     *
+     * 0x300: lui  x28, 0x20         # pr_controller_run
+     * 0x304: lw   x29, 0x114(x28)   # ADC->DATA_CH3
+     * 0x308: lui  x30, 0x4          # angle = 16384
+     * 0x30C: zpec.sincos x31, x27, x30
+     * 0x310: sub  x31, x31, x29     # error = sin_ref - current_meas
+     * 0x314: sw   x31, 0x20(x28)    # PWM->CPU_REFERENCE
+     * 0x318: jalr x0, 0(x1)
+     */
+
+    task load_program;
+        integer k;
+        begin
+            for (k = 0; k < 2048; k = k + 1)
+                rom[k] = 32'h0000006F;              // jal x0, 0 (trap catcher)
+
+            rom[0] = 32'h00010A37;
+            rom[1] = 32'h00030AB7;
+            rom[2] = 32'h00500093;
+            rom[3] = 32'hB0002573;
+            for (k = 0; k < 8; k = k + 1) begin
+                rom[4 + 3*k]  = 32'h000A2103;       // lw  x2, 0(x20)
+                rom[5 + 3*k]  = 32'h00110133;       // add x2, x2, x1
+                rom[6 + 3*k]  = 32'h002A2023;       // sw  x2, 0(x20)
+            end
+            rom[28] = 32'hB00025F3;
+            rom[29] = 32'hB0002673;
+            for (k = 0; k < 8; k = k + 1) begin
+                rom[30 + 3*k] = 32'h000AA103;       // lw  x2, 0(x21)
+                rom[31 + 3*k] = 32'h00110133;       // add x2, x2, x1
+                rom[32 + 3*k] = 32'h002AA023;       // sw  x2, 0(x21)
+            end
+            rom[54] = 32'hB00026F3;
+            rom[55] = 32'h20002183;
+            rom[56] = 32'h103AA023;
+            rom[57] = 32'h20402183;
+            rom[58] = 32'h103AA223;
+            rom[59] = 32'h100A80E7;
+            rom[60] = 32'h000A2703;
+            rom[61] = 32'h000AA783;
+            rom[62] = 32'h30000293;
+            rom[63] = 32'h200A8393;
+            rom[64] = 32'h00700413;
+            rom[65] = 32'h0002A183;
+            rom[66] = 32'h0033A023;
+            rom[67] = 32'h00428293;
+            rom[68] = 32'h00438393;
+            rom[69] = 32'hFFF40413;
+            rom[70] = 32'hFE0416E3;
+            rom[71] = 32'hB0002873;
+            rom[72] = 32'h1E0000EF;
+            rom[73] = 32'hB00028F3;
+            rom[74] = 32'hB0002973;
+            rom[75] = 32'h200A80E7;
+            rom[76] = 32'hB00029F3;
+            rom[77] = 32'h0000006F;
+
+            rom[128] = 32'h05500313;
+            rom[129] = 32'h00008067;
+
+            rom[192] = 32'h00020E37;
+            rom[193] = 32'h114E2E83;
+            rom[194] = 32'h00004F37;
+            rom[195] = 32'h09ED8FDB;
+            rom[196] = 32'h41DF8FB3;
+            rom[197] = 32'h03FE2023;
+            rom[198] = 32'h00008067;
+        end
+    endtask
+
+    //==========================================================================
+    // Test Sequence
+    //==========================================================================
+
+    integer errors;
+    integer cycles;
+    integer ram_cycles;
+    integer tcm_cycles;
+    integer pr_ram_cycles;
+    integer pr_tcm_cycles;
+
+    initial begin
+        $dumpfile("tb_tcm.vcd");
+        $dumpvars(0, tb_tcm);
+
+        errors = 0;
+        ext_tcm_accesses = 0;
+        tcm_fetches = 0;
+        pwm_writes = 0;
+
+        $display("");
+        $display("========================================");
+        $display("TCM Testbench");
+        $display("========================================");
+
+        load_program;
+
+        rst_n = 0;
+        repeat (5) @(posedge clk);
+        rst_n = 1;
+
+        cycles = 0;
+        while (dut.cpu.pc !== DONE_ADDR && cycles < TIMEOUT) begin
+            @(posedge clk);
+            cycles = cycles + 1;
+        end
+        repeat (10) @(posedge clk);
+
+        if (cycles >= TIMEOUT) begin
+            $display("[FAIL] Timeout: program did not reach 0x%08h", DONE_ADDR);
+            errors = errors + 1;
+        end
+
+        ram_cycles = dut.cpu.regfile_inst.registers[11] - dut.cpu.regfile_inst.registers[10];
+        tcm_cycles = dut.cpu.regfile_inst.registers[13] - dut.cpu.regfile_inst.registers[12];
+
+        $display("");
+        $display("RAM block: %0d cycles", ram_cycles);
+        $display("TCM block: %0d cycles", tcm_cycles);
+        $display("Saved:     %0d cycles over %0d accesses", ram_cycles - tcm_cycles, ACCESSES);
+        $display("");
+
+        pr_ram_cycles = dut.cpu.regfile_inst.registers[17] - dut.cpu.regfile_inst.registers[16];
+        pr_tcm_cycles = dut.cpu.regfile_inst.registers[19] - dut.cpu.regfile_inst.registers[18];
+
+        $display("pr_controller_run from the image: %0d cycles", pr_ram_cycles);
+        $display("pr_controller_run from .tcm_text: %0d cycles", pr_tcm_cycles);
+        $display("Saved:     %0d cycles over %0d fetches", pr_ram_cycles - pr_tcm_cycles, PR_WORDS);
+        $display("");
+
+        // Test 1: Results
+        if (dut.cpu.regfile_inst.registers[14] === EXPECTED &&
+            dut.cpu.regfile_inst.registers[15] === EXPECTED) begin
+            $display("[PASS] Test 1: RAM and TCM results = %0d", EXPECTED);
+        end else begin
+            $display("[FAIL] Test 1: RAM=%0d TCM=%0d (expected %0d)",
+                     dut.cpu.regfile_inst.registers[14],
+                     dut.cpu.regfile_inst.registers[15], EXPECTED);
+            errors = errors + 1;
+        end
+
+        // Test 2: Cycle savings
+        if (ram_cycles - tcm_cycles >= ACCESSES) begin
+            $display("[PASS] Test 2: TCM saves >= 1 cycle per access");
+        end else begin
+            $display("[FAIL] Test 2: TCM saved only %0d cycles", ram_cycles - tcm_cycles);
+            errors = errors + 1;
+        end
+
+        // Test 3: TCM traffic stays local
+        if (ext_tcm_accesses == 0) begin
+            $display("[PASS] Test 3: No TCM access on the SoC buses");
+        end else begin
+            $display("[FAIL] Test 3: %0d TCM accesses leaked to the SoC buses", ext_tcm_accesses);
+            errors = errors + 1;
+        end
+
+        // Test 4: Execute from TCM
+        if (dut.cpu.regfile_inst.registers[6] === 32'h55 && tcm_fetches == 2 + PR_WORDS) begin
+            $display("[PASS] Test 4: Routine executed from TCM (%0d fetches)", tcm_fetches);
+        end else begin
+            $display("[FAIL] Test 4: x6=0x%08h, TCM fetches=%0d",
+                     dut.cpu.regfile_inst.registers[6], tcm_fetches);
+            errors = errors + 1;
+        end
+
+        // Test 5: pr_controller_run, same output from both copies
+        if (pwm_writes == 2 && pwm_ref[0] === pwm_ref[1] && ^pwm_ref[0] !== 1'bx) begin
+            $display("[PASS] Test 5: pr_controller_run wrote 0x%08h from both copies", pwm_ref[0]);
+        end else begin
+            $display("[FAIL] Test 5: %0d PWM reference writes (0x%08h, 0x%08h)",
+                     pwm_writes, pwm_ref[0], pwm_ref[1]);
+            errors = errors + 1;
+        end
+
+        // Test 6: pr_controller_run from the TCM
+        if (pr_tcm_cycles > 0 && pr_tcm_cycles <= pr_ram_cycles) begin
+            $display("[PASS] Test 6: pr_controller_run %0d -> %0d cycles from the TCM",
+                     pr_ram_cycles, pr_tcm_cycles);
+        end else begin
+            $display("[FAIL] Test 6: pr_controller_run %0d cycles from the TCM, %0d from the image",
+                     pr_tcm_cycles, pr_ram_cycles);
+            errors = errors + 1;
+        end
+
+        $display("");
+        $display("========================================");
+        if (errors == 0)
+            $display("*** ALL TESTS PASSED! ***");
+        else
+            $display("*** %0d TEST(S) FAILED ***", errors);
+        $display("========================================");
+        $finish;
+    end
+
+endmodule
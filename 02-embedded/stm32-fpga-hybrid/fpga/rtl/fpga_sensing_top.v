@@ -6,6 +6,10 @@
  * - 4-channel Sigma-Delta ADC with CIC decimation
  * - SPI slave interface for STM32 communication
  * - External comparator interface (LM339)
+ * - PWM generation for both H-bridges (carrier_generator and
+ *   pwm_comparator from 03-fpga/rtl), commanded by the STM32
+ * - Fast trip: per-channel over/under limits on a short-OSR filter of
+ *   each bitstream, gates killed in hardware, fault latched for the STM32
  *
  * System Architecture:
  * ```
@@ -25,15 +29,45 @@
  * │             │                    │
  * │  ┌──────────▼───────────────┐   │
  * │  │  SPI Slave Interface     │   │
- * │  │  (Register-based)        │   │
- * │  └──────────┬───────────────┘   │
+ * │  │  (Snapshot, burst read)  │   │
+ * │  └──────────┬─────────▲─────┘   │
+ * │             │         │ M1, M2  │
+ * │             │  ┌──────┴──────┐  │
+ * │             │  │ PWM (4 legs)│──┼──→ gate_out[7:0]
+ * │             │  │ dead time   │  │
+ * │             │  └─────────────┘  │
  * │             │ SPI              │
  * └─────────────┼──────────────────┘
- *               ↓
+ *               ↕
  *         STM32F401RE
  *         (Control Algorithm)
  * ```
  *
+ * PWM: the STM32 sends one modulation index per H-bridge (Q14) with
+ * every frame read. A new command is staged and applied at the next
+ * carrier peak, so a period never mixes two commands. The bridges run
+ * phase-shifted: bridge 1 compares +M1/-M1 (legs A/B) against carrier 1,
+ * bridge 2 +M2/-M2 against carrier 2, 90 deg later. Dead time is counted
+ * in clk cycles (DEADTIME_NS, 20 ns steps at 50 MHz).
+ *
+ * Gates are off after reset, on a command with the enable flag clear
+ * (immediately), and when no valid command has arrived for
+ * CMD_TIMEOUT carrier periods (STM32 stalled or link lost). A command
+ * with a bad CRC is dropped; the previous one stays in force until the
+ * timeout.
+ *
+ * Fast trip: each channel also runs a sinc2 filter over its last
+ * FAST_OSR modulator bits (same 16-bit code scale as the ADC data,
+ * updated every 1 us), and fast_trip forces the gates low one clock after
+ * one of those outside its window (TRIP_*_DEFAULT at reset, LIMIT
+ * commands over SPI). A step across a limit is detected within
+ * 2 * FAST_OSR modulator clocks (32 us), against several 100 us samples
+ * through the decimating CIC; the kill after detection is a single clk
+ * cycle. The trip filter resolves about 8 bits, so limits need a margin
+ * of ~1% of full scale over the operating range. The trip also drops the
+ * PWM enable, so the gates stay off until a PWM command clears the fault
+ * (flag) and enables them again.
+ *
  * Target FPGA: Digilent Basys 3 (Xilinx Artix-7 XC7A35T)
  * or similar low-cost FPGA boards
  *
@@ -44,7 +78,16 @@
 module fpga_sensing_top #(
     parameter CLK_FREQ = 50_000_000,   // 50 MHz system clock
     parameter OSR = 100,                // Oversampling ratio
-    parameter CIC_ORDER = 3             // CIC filter order
+    parameter CIC_ORDER = 3,            // CIC filter order
+    parameter FAST_OSR = 16,            // Trip filter length (modulator clocks)
+    parameter PWM_FREQ_HZ = 10_000,     // Carrier (switching) frequency
+    parameter DEADTIME_NS = 1000,       // Gate dead time
+    parameter CMD_TIMEOUT = 4,          // Carrier periods without a command
+
+    // Trip limits at reset, raw codes, ch0 in [15:0]: DC buses 60 V,
+    // AC channels open until the STM32 sets them
+    parameter [63:0] TRIP_HI_DEFAULT = {16'hFFFF, 16'hFFFF, 16'hC2BA, 16'hC2BA},
+    parameter [63:0] TRIP_LO_DEFAULT = 64'd0
 )(
     // Clock and Reset
     input  wire        clk_50mhz,      // 50 MHz system clock
@@ -60,6 +103,9 @@ module fpga_sensing_top #(
     output wire        spi_miso,       // Master In Slave Out
     input  wire        spi_cs_n,       // Chip select (active low)
 
+    // Gate drives (S1-S4: H-bridge 1, S5-S8: H-bridge 2)
+    output wire [7:0]  gate_out,       // gate_out[0] = S1 .. gate_out[7] = S8
+
     // Status outputs (optional - for debugging)
     output wire [3:0]  led,            // Status LEDs
     output wire        adc_data_ready  // Pulse when new ADC data available
@@ -89,6 +135,8 @@ module fpga_sensing_top #(
 
     wire [15:0] adc_ch0, adc_ch1, adc_ch2, adc_ch3;
     wire [3:0]  adc_data_valid;
+    wire [63:0] fast_sample;            // Trip filter outputs, ch0 in [15:0]
+    wire [3:0]  fast_valid;
     wire [31:0] adc_sample_cnt;
     reg         adc_enable;
 
@@ -106,7 +154,8 @@ module fpga_sensing_top #(
         for (i = 0; i < 4; i = i + 1) begin : adc_channels
             sigma_delta_channel #(
                 .OSR(OSR),
-                .CIC_ORDER(CIC_ORDER)
+                .CIC_ORDER(CIC_ORDER),
+                .FAST_OSR(FAST_OSR)
             ) adc_ch (
                 .clk(clk),
                 .rst_n(rst_n_sync),
@@ -116,19 +165,52 @@ module fpga_sensing_top #(
                 .adc_data(i == 0 ? adc_ch0 :
                           i == 1 ? adc_ch1 :
                           i == 2 ? adc_ch2 : adc_ch3),
-                .data_valid(adc_data_valid[i])
+                .data_valid(adc_data_valid[i]),
+                .fast_data(fast_sample[16*i +: 16]),
+                .fast_valid(fast_valid[i])
             );
         end
     endgenerate
 
-    // Sample counter for debug
+    //==========================================================================
+    // Sample Frame
+    //==========================================================================
+    // The channels run in lockstep; their results, the sample counter and
+    // the clk cycle of the sample are registered together on one edge, so
+    // the SPI snapshot never sees new data with a stale count. The status
+    // flags mark channels that have produced a sample since reset; the
+    // STM32 detects a new frame by its sample counter.
+
+    reg [31:0] cycle_counter;
+    reg [15:0] frame_ch0, frame_ch1, frame_ch2, frame_ch3;
     reg [31:0] sample_counter;
+    reg [31:0] sample_time;
+    reg [3:0]  frame_valid;
 
     always @(posedge clk or negedge rst_n_sync) begin
-        if (!rst_n_sync)
+        if (!rst_n_sync) begin
+            cycle_counter <= 32'd0;
+            frame_ch0 <= 16'd0;
+            frame_ch1 <= 16'd0;
+            frame_ch2 <= 16'd0;
+            frame_ch3 <= 16'd0;
             sample_counter <= 32'd0;
-        else if (adc_data_valid[0])
-            sample_counter <= sample_counter + 1;
+            sample_time <= 32'd0;
+            frame_valid <= 4'd0;
+        end else begin
+            cycle_counter <= cycle_counter + 1;
+
+            if (adc_data_valid[0]) begin
+                frame_ch0 <= adc_ch0;
+                frame_ch1 <= adc_ch1;
+                frame_ch2 <= adc_ch2;
+                frame_ch3 <= adc_ch3;
+                sample_counter <= sample_counter + 1;
+                sample_time <= cycle_counter;
+            end
+
+            frame_valid <= frame_valid | adc_data_valid;
+        end
     end
 
     assign adc_sample_cnt = sample_counter;
@@ -138,7 +220,14 @@ module fpga_sensing_top #(
     // SPI Interface to STM32
     //==========================================================================
 
-    wire data_read_strobe;
+    wire        data_read_strobe;
+    wire        cmd_valid, cmd_error;
+    wire [7:0]  cmd_flags;
+    wire [15:0] cmd_m1, cmd_m2;
+    wire [7:0]  cmd_type;
+    wire [3:0]  pwm_status;
+    wire [3:0]  fault_hi, fault_lo;
+    reg  [63:0] limit_hi, limit_lo;
 
     stm32_spi_interface spi_if (
         .clk(clk),
@@ -150,17 +239,219 @@ module fpga_sensing_top #(
         .spi_miso(spi_miso),
         .spi_cs_n(spi_cs_n),
 
-        // ADC data
-        .adc_ch0(adc_ch0),
-        .adc_ch1(adc_ch1),
-        .adc_ch2(adc_ch2),
-        .adc_ch3(adc_ch3),
-        .adc_data_valid(adc_data_valid),
+        // ADC sample frame
+        .adc_ch0(frame_ch0),
+        .adc_ch1(frame_ch1),
+        .adc_ch2(frame_ch2),
+        .adc_ch3(frame_ch3),
+        .adc_data_valid(frame_valid),
         .adc_sample_cnt(adc_sample_cnt),
+        .adc_timestamp(sample_time),
+        .pwm_status(pwm_status),
+        .fault_hi(fault_hi),
+        .fault_lo(fault_lo),
+        .limit_hi(limit_hi),
+        .limit_lo(limit_lo),
+
+        // Commands
+        .cmd_valid(cmd_valid),
+        .cmd_error(cmd_error),
+        .cmd_type(cmd_type),
+        .cmd_flags(cmd_flags),
+        .cmd_m1(cmd_m1),
+        .cmd_m2(cmd_m2),
 
         .data_read_strobe(data_read_strobe)
     );
 
+    //==========================================================================
+    // PWM Generation
+    //==========================================================================
+    // Same chain as 03-fpga/rtl/inverter_5level_top.v, in phase-shifted
+    // mode, with the references coming from the STM32 instead of the
+    // sine generator. Full scale (Q14 1.0) is freq_div carrier counts.
+
+    localparam CMD_PWM   = 8'h5A;
+    localparam CMD_LIMIT = 8'hC3;
+
+    wire pwm_cmd   = cmd_valid && (cmd_type == CMD_PWM);
+    wire limit_cmd = cmd_valid && (cmd_type == CMD_LIMIT);
+    wire trip;                          // Fast trip latched
+
+    localparam CMP_WIDTH = 19;          // Carrier counts up to 2^16, signed, headroom
+    localparam [15:0] PWM_FREQ_DIV = CLK_FREQ / (2 * PWM_FREQ_HZ);
+    localparam [7:0]  DEADTIME_CYCLES = (CLK_FREQ / 1_000_000 * DEADTIME_NS + 500) / 1000;
+
+    wire signed [CMP_WIDTH-1:0] carrier1, carrier2;
+    wire                        carrier_sync;   // Carrier peak: period boundary
+
+    carrier_generator #(
+        .CARRIER_WIDTH(CMP_WIDTH),
+        .COUNTER_WIDTH(16)
+    ) carrier_gen (
+        .clk(clk),
+        .rst_n(rst_n_sync),
+        .enable(adc_enable),
+        .mode(1'b1),                    // Phase-shifted
+        .freq_div(PWM_FREQ_DIV),
+        .carrier1(carrier1),
+        .carrier2(carrier2),
+        .sync_pulse(carrier_sync)
+    );
+
+    // Q14 modulation index to carrier counts. +-1.0 maps one count beyond
+    // the carrier peaks, so a saturated leg stays on (off) for the whole
+    // period instead of glitching through dead time at the peak.
+    function signed [CMP_WIDTH-1:0] duty_ref;
+        input signed [15:0] m;
+        reg signed [31:0] prod;
+        begin
+            if (m >= 16'sd16384)
+                duty_ref = PWM_FREQ_DIV + 1;
+            else if (m <= -16'sd16384)
+                duty_ref = -(PWM_FREQ_DIV + 1);
+            else begin
+                prod = m * $signed({1'b0, PWM_FREQ_DIV});
+                duty_ref = prod >>> 14;
+            end
+        end
+    endfunction
+
+    // Staged command (from SPI) and the one in force this period
+    reg signed [15:0]          m1_pending, m2_pending;
+    reg                        en_pending;
+    reg signed [CMP_WIDTH-1:0] ref1, ref2;
+    reg                        pwm_enable;
+    reg [3:0]                  cmd_age;         // Carrier periods since the last command
+    reg                        cmd_timeout;     // Gates stopped by the timeout
+    reg                        cmd_rejected;    // Last command failed its CRC
+
+    // A command arriving on the boundary clock still makes that period
+    wire signed [15:0] m1_next = pwm_cmd ? cmd_m1 : m1_pending;
+    wire signed [15:0] m2_next = pwm_cmd ? cmd_m2 : m2_pending;
+    wire               en_next = pwm_cmd ? cmd_flags[0] : en_pending;
+
+    always @(posedge clk or negedge rst_n_sync) begin
+        if (!rst_n_sync) begin
+            m1_pending <= 16'sd0;
+            m2_pending <= 16'sd0;
+            en_pending <= 1'b0;
+            ref1 <= 0;
+            ref2 <= 0;
+            pwm_enable <= 1'b0;
+            cmd_age <= 4'd0;
+            cmd_timeout <= 1'b0;
+            cmd_rejected <= 1'b0;
+        end else begin
+            if (pwm_cmd) begin
+                m1_pending <= cmd_m1;
+                m2_pending <= cmd_m2;
+                en_pending <= cmd_flags[0];
+                cmd_age <= 4'd0;
+                cmd_timeout <= 1'b0;
+                cmd_rejected <= 1'b0;
+
+                // Stopping does not wait for the period boundary
+                if (!cmd_flags[0])
+                    pwm_enable <= 1'b0;
+            end else if (cmd_error) begin
+                cmd_rejected <= 1'b1;
+            end
+
+            if (carrier_sync) begin
+                if (!pwm_cmd && cmd_age == CMD_TIMEOUT - 1) begin
+                    // Command stream lost: all gates off until the next
+                    // valid command
+                    en_pending <= 1'b0;
+                    pwm_enable <= 1'b0;
+                    cmd_timeout <= 1'b1;
+                end else begin
+                    ref1 <= duty_ref(m1_next);
+                    ref2 <= duty_ref(m2_next);
+                    pwm_enable <= en_next;
+                    if (!pwm_cmd)
+                        cmd_age <= cmd_age + 1;
+                end
+            end
+
+            // Tripped: no restart without a fresh enable with or after
+            // the clear
+            if (trip && !(pwm_cmd && cmd_flags[1])) begin
+                en_pending <= 1'b0;
+                pwm_enable <= 1'b0;
+            end
+        end
+    end
+
+    assign pwm_status = {trip, cmd_rejected, cmd_timeout, pwm_enable};
+
+    // Four legs: +ref and -ref per bridge against the bridge's carrier
+    wire signed [CMP_WIDTH-1:0] leg_ref [0:3];
+    wire signed [CMP_WIDTH-1:0] leg_car [0:3];
+
+    assign leg_ref[0] = ref1;
+    assign leg_ref[1] = -ref1;
+    assign leg_ref[2] = ref2;
+    assign leg_ref[3] = -ref2;
+    assign leg_car[0] = carrier1;
+    assign leg_car[1] = carrier1;
+    assign leg_car[2] = carrier2;
+    assign leg_car[3] = carrier2;
+
+    wire [7:0] gate_pwm;
+
+    generate
+        for (i = 0; i < 4; i = i + 1) begin : pwm_legs
+            pwm_comparator #(
+                .DATA_WIDTH(CMP_WIDTH),
+                .DEADTIME_WIDTH(8)
+            ) leg (
+                .clk(clk),
+                .rst_n(rst_n_sync),
+                .enable(pwm_enable),
+                .reference(leg_ref[i]),
+                .carrier(leg_car[i]),
+                .deadtime(DEADTIME_CYCLES),
+                .pwm_high(gate_pwm[2*i]),
+                .pwm_low(gate_pwm[2*i + 1])
+            );
+        end
+    endgenerate
+
+    //==========================================================================
+    // Fast Trip
+    //==========================================================================
+    // Fed from the channels' trip filters, not the decimated ADC data:
+    // a new comparison every modulator clock.
+
+    always @(posedge clk or negedge rst_n_sync) begin
+        if (!rst_n_sync) begin
+            limit_hi <= TRIP_HI_DEFAULT;
+            limit_lo <= TRIP_LO_DEFAULT;
+        end else if (limit_cmd) begin
+            limit_hi[16*cmd_flags[1:0] +: 16] <= cmd_m1;
+            limit_lo[16*cmd_flags[1:0] +: 16] <= cmd_m2;
+        end
+    end
+
+    fast_trip #(
+        .N_CH(4),
+        .N_GATES(8)
+    ) trip_unit (
+        .clk(clk),
+        .rst_n(rst_n_sync),
+        .sample(fast_sample),
+        .sample_valid(fast_valid[0]),
+        .limit_hi(limit_hi),
+        .limit_lo(limit_lo),
+        .clear(pwm_cmd && cmd_flags[1]),
+        .gate_in(gate_pwm),
+        .gate_out(gate_out),
+        .fault_hi(fault_hi),
+        .fault_lo(fault_lo),
+        .tripped(trip)
+    );
+
     //==========================================================================
     // Status LEDs (for debugging)
     //==========================================================================
@@ -175,10 +466,23 @@ endmodule
 //==========================================================================
 // Sigma-Delta ADC Channel Module (copied from sigma_delta_adc.v)
 //==========================================================================
+//
+// Two filters on the same bitstream:
+// - adc_data: CIC of order CIC_ORDER, decimated by OSR. Its gain is
+//   OSR^CIC_ORDER (all-ones bitstream), a bit growth of
+//   CIC_ORDER * log2(OSR) = 20 bits at 3 / 100; the output is scaled by
+//   65535 / OSR^CIC_ORDER so a full-scale bitstream reads 65535, the
+//   scale the STM32 converts with (fpga_physical_to_code).
+// - fast_data: sinc2 over the last FAST_OSR bits, recomputed on every
+//   modulator clock, same 16-bit scale. About 8 bits at FAST_OSR = 16,
+//   but a step is through in 2 * FAST_OSR modulator clocks (32 us)
+//   instead of the CIC's CIC_ORDER decimated samples plus its comb
+//   pipeline. It feeds the fast trip comparators only.
 
 module sigma_delta_channel #(
     parameter OSR = 100,
     parameter CIC_ORDER = 3,
+    parameter FAST_OSR = 16,            // Trip filter length (modulator clocks)
     parameter W = 32                    // Internal width
 )(
     input  wire        clk,             // 50 MHz system clock
@@ -187,33 +491,31 @@ module sigma_delta_channel #(
     input  wire        comp_in,         // Comparator input (1-bit)
     output reg         dac_out,         // 1-bit DAC output
     output wire [15:0] adc_data,        // 16-bit ADC result
-    output wire        data_valid       // Data valid strobe
+    output wire        data_valid,      // Data valid strobe
+    output reg  [15:0] fast_data,       // Trip filter output, 16-bit scale
+    output reg         fast_valid       // Pulse: fast_data updated
 );
 
     //==========================================================================
-    // Clock Divider: 50 MHz → 1 MHz (for 1 MHz sampling)
+    // Modulator Clock: 50 MHz / 50 = 1 MHz
     //==========================================================================
 
-    localparam CLK_DIV = 50;            // 50 MHz / 50 = 1 MHz
+    localparam CLK_DIV = 50;
 
     reg [6:0] clk_div_counter;
-    reg       clk_1mhz;
 
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
             clk_div_counter <= 7'd0;
-            clk_1mhz <= 1'b0;
         end else if (enable) begin
-            if (clk_div_counter == CLK_DIV - 1) begin
+            if (clk_div_counter == CLK_DIV - 1)
                 clk_div_counter <= 7'd0;
-                clk_1mhz <= ~clk_1mhz;  // Toggle at 1 MHz
-            end else begin
+            else
                 clk_div_counter <= clk_div_counter + 1;
-            end
         end
     end
 
-    wire clk_1mhz_posedge = (clk_div_counter == 0) && clk_1mhz && enable;
+    wire mod_tick = (clk_div_counter == CLK_DIV - 1) && enable;
 
     //==========================================================================
     // Sigma-Delta Modulator (1st order)
@@ -227,7 +529,7 @@ module sigma_delta_channel #(
             integrator <= 32'sd0;
             dac_out <= 1'b0;
             bitstream <= 1'b0;
-        end else if (clk_1mhz_posedge) begin
+        end else if (mod_tick) begin
             // Error signal = input - feedback
             integrator <= integrator +
                           (comp_in ? 32'sd32768 : -32'sd32768) -
@@ -251,7 +553,7 @@ module sigma_delta_channel #(
         if (!rst_n) begin
             for (i = 0; i < CIC_ORDER; i = i + 1)
                 integrator_stage[i] <= 0;
-        end else if (clk_1mhz_posedge) begin
+        end else if (mod_tick) begin
             // First integrator
             integrator_stage[0] <= integrator_stage[0] + (bitstream ? 1 : 0);
 
@@ -271,7 +573,7 @@ module sigma_delta_channel #(
             decim_count <= 8'd0;
             snapshot <= 0;
             snapshot_valid <= 1'b0;
-        end else if (clk_1mhz_posedge) begin
+        end else if (mod_tick) begin
             decim_count <= decim_count + 1;
             snapshot_valid <= 1'b0;
 
@@ -283,12 +585,19 @@ module sigma_delta_channel #(
         end
     end
 
+    // Output scale: CIC gain OSR^CIC_ORDER -> 16-bit full scale
+    localparam integer CIC_GAIN   = OSR ** CIC_ORDER;
+    localparam integer CIC_GROWTH = $clog2(CIC_GAIN);
+    localparam [63:0]  CIC_SCALE  = ((64'd1 << (CIC_GROWTH + 16)) - 1) / CIC_GAIN;
+
     // Comb stages (run at 10 kHz)
     reg [W-1:0] comb [0:CIC_ORDER-1];
     reg [W-1:0] comb_delay [0:CIC_ORDER-1];
     reg [15:0]  adc_result;
     reg         result_valid;
 
+    wire [63:0] cic_scaled = comb[CIC_ORDER-1] * CIC_SCALE;
+
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
             for (i = 0; i < CIC_ORDER; i = i + 1) begin
@@ -308,8 +617,8 @@ module sigma_delta_channel #(
                 comb_delay[i] <= comb[i-1];
             end
 
-            // Output (take top 16 bits, scaled appropriately)
-            adc_result <= comb[CIC_ORDER-1][W-1:W-16];
+            // Output: 0 .. OSR^CIC_ORDER scaled to 0 .. 65535
+            adc_result <= cic_scaled[CIC_GROWTH +: 16];
             result_valid <= 1'b1;
         end else begin
             result_valid <= 1'b0;
@@ -319,4 +628,52 @@ module sigma_delta_channel #(
     assign adc_data = adc_result;
     assign data_valid = result_valid;
 
+    //==========================================================================
+    // Trip Filter (sinc2, every modulator clock)
+    //==========================================================================
+    // Two moving sums of FAST_OSR: the bits, then the first sums.
+
+    localparam integer FAST_GAIN   = FAST_OSR * FAST_OSR;
+    localparam integer FAST_GROWTH = $clog2(FAST_GAIN);
+    localparam [63:0]  FAST_SCALE  = ((64'd1 << (FAST_GROWTH + 16)) - 1) / FAST_GAIN;
+    localparam integer FAST_W1     = $clog2(FAST_OSR + 1);
+    localparam integer FAST_W2     = $clog2(FAST_GAIN + 1);
+
+    reg [FAST_OSR-1:0] fast_bits;                   // Last FAST_OSR bits
+    reg [FAST_W1-1:0]  fast_sum1;
+    reg [FAST_W1-1:0]  fast_hist [0:FAST_OSR-1];    // Last FAST_OSR first sums
+    reg [FAST_W2-1:0]  fast_sum2;
+    reg                fast_tick;
+
+    wire [FAST_W1-1:0] fast_sum1_next = fast_sum1 + bitstream - fast_bits[FAST_OSR-1];
+    wire [63:0]        fast_scaled = fast_sum2 * FAST_SCALE;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            fast_bits <= 0;
+            fast_sum1 <= 0;
+            for (i = 0; i < FAST_OSR; i = i + 1)
+                fast_hist[i] <= 0;
+            fast_sum2 <= 0;
+            fast_tick <= 1'b0;
+            fast_data <= 16'd0;
+            fast_valid <= 1'b0;
+        end else begin
+            fast_tick <= mod_tick;
+            if (mod_tick) begin
+                fast_bits <= {fast_bits[FAST_OSR-2:0], bitstream};
+                fast_sum1 <= fast_sum1_next;
+                fast_hist[0] <= fast_sum1_next;
+                for (i = 1; i < FAST_OSR; i = i + 1)
+                    fast_hist[i] <= fast_hist[i-1];
+                fast_sum2 <= fast_sum2 + fast_sum1_next - fast_hist[FAST_OSR-1];
+            end
+
+            // Scale on the clock after the sums settle
+            fast_valid <= fast_tick;
+            if (fast_tick)
+                fast_data <= fast_scaled[FAST_GROWTH +: 16];
+        end
+    end
+
 endmodule
@@ -2,17 +2,19 @@
  * @file stm32_spi_interface.v
  * @brief SPI Slave Interface for STM32-FPGA Communication
  *
- * Provides SPI slave interface for STM32 to read ADC data from FPGA.
+ * Provides SPI slave interface for STM32 to read ADC data from FPGA and
+ * to command the FPGA PWM, full-duplex in the same transaction.
  * The STM32 acts as SPI master, FPGA as SPI slave.
  *
  * Features:
  * - SPI Mode 0 (CPOL=0, CPHA=0)
  * - 16-bit data transfers
  * - Register-based addressing
- * - Up to 10 MHz SPI clock (STM32F401RE max: 21 MHz)
+ * - PWM command received on MOSI during the frame burst
+ * - SPI clock up to clk/8 (6.25 MHz at 50 MHz; the STM32 runs 5.25 MHz)
  *
  * Register Map (8-bit address):
- * 0x00: STATUS      - Status register [3:0]: Data valid flags
+ * 0x00: STATUS      - [3:0]: Data valid flags, [7:4]: pwm_status
  * 0x01: ADC_CH0_H   - Channel 0 high byte [15:8]
  * 0x02: ADC_CH0_L   - Channel 0 low byte [7:0]
  * 0x03: ADC_CH1_H   - Channel 1 high byte
@@ -21,11 +23,51 @@
  * 0x06: ADC_CH2_L   - Channel 2 low byte
  * 0x07: ADC_CH3_H   - Channel 3 high byte
  * 0x08: ADC_CH3_L   - Channel 3 low byte
- * 0x09: SAMPLE_CNT  - Sample counter (debug)
+ * 0x09-0x0C: SAMPLE_CNT - Sample counter [7:0] .. [31:24]
+ * 0x0D-0x10: TIMESTAMP  - clk cycle of the sample [7:0] .. [31:24]
+ * 0x11: FAULT_HI    - [3:0]: channel tripped above its upper limit (latched)
+ * 0x12: FAULT_LO    - [3:0]: channel tripped below its lower limit (latched)
+ * 0x13-0x22: LIMITS - per channel HI_H, HI_L, LO_H, LO_L (ch0 first)
+ * 0x40-0x54: FRAME      - CRC-protected frame (below)
  *
- * SPI Transaction Format:
- * Byte 0: Address (write from STM32)
- * Byte 1: Data (read from FPGA)
+ * SPI Transaction Format (burst):
+ * Byte 0:   Address (write from STM32)
+ * Byte 1..: Data from Address, Address+1, ... while CS stays low
+ *
+ * SNAPSHOT:
+ * All registers are read from a snapshot bank, latched in one clock
+ * when the address byte completes. A burst from 0x00 therefore returns
+ * status, the four channels, the sample counter and the timestamp of
+ * one and the same sample, however long the transfer takes; a new
+ * sample arriving mid-burst waits for the next transaction.
+ *
+ * FRAME (burst of 21 bytes from 0x40):
+ *   0      SYNC  0xA5
+ *   1      LEN   17 (payload bytes)
+ *   2-5    SEQ   sample counter [31:0], LSB first (+1 per sample)
+ *   6      STATUS
+ *   7-14   ADC_CH0..3, high byte first
+ *   15-18  TIMESTAMP, LSB first
+ *   19-20  CRC-16/CCITT-FALSE (0x1021, init 0xFFFF) over bytes 0-18,
+ *          high byte first
+ * The CRC is computed bit-serially from the MISO stream as it is
+ * shifted out, so it covers exactly the bits on the wire.
+ *
+ * COMMAND (MOSI, first 8 data bytes of a burst from 0x40):
+ *   0      SYNC  0x5A: PWM, 0xC3: trip limits (anything else: read-only
+ *                frame, MOSI ignored)
+ *   1      PWM:   FLAGS [0]: PWM enable, [1]: clear fault
+ *          LIMIT: channel (0-3)
+ *   2-3    PWM:   M1, H-bridge 1 modulation index, Q14 signed
+ *          LIMIT: upper limit (raw code)
+ *   4-5    PWM:   M2, H-bridge 2 modulation index
+ *          LIMIT: lower limit (raw code)
+ *   6-7    CRC-16/CCITT-FALSE over bytes 0-5, high byte first
+ * Words are high byte first. A command with a matching CRC pulses
+ * cmd_valid (cmd_type = its SYNC) when its last bit is in, one with a
+ * bad CRC pulses cmd_error instead. The SPI clock only
+ * runs for the frame the STM32 reads anyway, so the command costs no
+ * extra transaction.
  */
 
 module stm32_spi_interface (
@@ -45,6 +87,20 @@ module stm32_spi_interface (
     input  wire [15:0] adc_ch3,
     input  wire [3:0]  adc_data_valid,
     input  wire [31:0] adc_sample_cnt,
+    input  wire [31:0] adc_timestamp,
+    input  wire [3:0]  pwm_status,     // Reported in STATUS[7:4]
+    input  wire [3:0]  fault_hi,       // Fast-trip fault register
+    input  wire [3:0]  fault_lo,
+    input  wire [63:0] limit_hi,       // Trip limits, ch0 in [15:0]
+    input  wire [63:0] limit_lo,
+
+    // Command (received on MOSI)
+    output reg         cmd_valid,      // Pulse: command accepted
+    output reg         cmd_error,      // Pulse: command CRC mismatch
+    output reg  [7:0]  cmd_type,       // SYNC byte of the accepted command
+    output reg  [7:0]  cmd_flags,
+    output reg  [15:0] cmd_m1,
+    output reg  [15:0] cmd_m2,
 
     // Status output
     output reg         data_read_strobe  // Pulse when STM32 reads data
@@ -75,6 +131,106 @@ module stm32_spi_interface (
     wire spi_cs_active = (spi_cs_sync[2] == 1'b0);
     wire spi_mosi_bit = spi_mosi_sync[1];
 
+    //==========================================================================
+    // Snapshot Bank
+    //==========================================================================
+
+    reg [15:0] snap_ch0, snap_ch1, snap_ch2, snap_ch3;
+    reg [3:0]  snap_valid;
+    reg [3:0]  snap_pwm;
+    reg [3:0]  snap_fault_hi, snap_fault_lo;
+    reg [31:0] snap_cnt;
+    reg [31:0] snap_time;
+
+    localparam FRAME_BASE  = 8'h40;
+    localparam FRAME_CRC_H = 8'h53;
+    localparam FRAME_CRC_L = 8'h54;
+    localparam FRAME_SYNC  = 8'hA5;
+    localparam FRAME_LEN   = 8'd17;
+    localparam CMD_PWM     = 8'h5A;
+    localparam CMD_LIMIT   = 8'hC3;
+    localparam CMD_CRC_H   = 4'd6;  // Command byte index of the CRC
+    localparam CMD_LAST    = 4'd7;
+
+    reg [15:0] crc;                 // Running CRC of the frame bytes sent
+
+    function [15:0] crc16_bit;
+        input [15:0] c;
+        input        b;
+        begin
+            crc16_bit = {c[14:0], 1'b0} ^ ((c[15] ^ b) ? 16'h1021 : 16'h0000);
+        end
+    endfunction
+
+    function [7:0] read_reg;
+        input [7:0] addr;
+        begin
+            case (addr)
+                8'h00: read_reg = {snap_pwm, snap_valid};
+                8'h01: read_reg = snap_ch0[15:8];
+                8'h02: read_reg = snap_ch0[7:0];
+                8'h03: read_reg = snap_ch1[15:8];
+                8'h04: read_reg = snap_ch1[7:0];
+                8'h05: read_reg = snap_ch2[15:8];
+                8'h06: read_reg = snap_ch2[7:0];
+                8'h07: read_reg = snap_ch3[15:8];
+                8'h08: read_reg = snap_ch3[7:0];
+                8'h09: read_reg = snap_cnt[7:0];
+                8'h0A: read_reg = snap_cnt[15:8];
+                8'h0B: read_reg = snap_cnt[23:16];
+                8'h0C: read_reg = snap_cnt[31:24];
+                8'h0D: read_reg = snap_time[7:0];
+                8'h0E: read_reg = snap_time[15:8];
+                8'h0F: read_reg = snap_time[23:16];
+                8'h10: read_reg = snap_time[31:24];
+                8'h11: read_reg = {4'd0, snap_fault_hi};
+                8'h12: read_reg = {4'd0, snap_fault_lo};
+
+                // Limits are static configuration, read live
+                8'h13: read_reg = limit_hi[15:8];
+                8'h14: read_reg = limit_hi[7:0];
+                8'h15: read_reg = limit_lo[15:8];
+                8'h16: read_reg = limit_lo[7:0];
+                8'h17: read_reg = limit_hi[31:24];
+                8'h18: read_reg = limit_hi[23:16];
+                8'h19: read_reg = limit_lo[31:24];
+                8'h1A: read_reg = limit_lo[23:16];
+                8'h1B: read_reg = limit_hi[47:40];
+                8'h1C: read_reg = limit_hi[39:32];
+                8'h1D: read_reg = limit_lo[47:40];
+                8'h1E: read_reg = limit_lo[39:32];
+                8'h1F: read_reg = limit_hi[63:56];
+                8'h20: read_reg = limit_hi[55:48];
+                8'h21: read_reg = limit_lo[63:56];
+                8'h22: read_reg = limit_lo[55:48];
+
+                FRAME_BASE + 8'd0:  read_reg = FRAME_SYNC;
+                FRAME_BASE + 8'd1:  read_reg = FRAME_LEN;
+                FRAME_BASE + 8'd2:  read_reg = snap_cnt[7:0];
+                FRAME_BASE + 8'd3:  read_reg = snap_cnt[15:8];
+                FRAME_BASE + 8'd4:  read_reg = snap_cnt[23:16];
+                FRAME_BASE + 8'd5:  read_reg = snap_cnt[31:24];
+                FRAME_BASE + 8'd6:  read_reg = {snap_pwm, snap_valid};
+                FRAME_BASE + 8'd7:  read_reg = snap_ch0[15:8];
+                FRAME_BASE + 8'd8:  read_reg = snap_ch0[7:0];
+                FRAME_BASE + 8'd9:  read_reg = snap_ch1[15:8];
+                FRAME_BASE + 8'd10: read_reg = snap_ch1[7:0];
+                FRAME_BASE + 8'd11: read_reg = snap_ch2[15:8];
+                FRAME_BASE + 8'd12: read_reg = snap_ch2[7:0];
+                FRAME_BASE + 8'd13: read_reg = snap_ch3[15:8];
+                FRAME_BASE + 8'd14: read_reg = snap_ch3[7:0];
+                FRAME_BASE + 8'd15: read_reg = snap_time[7:0];
+                FRAME_BASE + 8'd16: read_reg = snap_time[15:8];
+                FRAME_BASE + 8'd17: read_reg = snap_time[23:16];
+                FRAME_BASE + 8'd18: read_reg = snap_time[31:24];
+                FRAME_CRC_H:        read_reg = crc[15:8];
+                FRAME_CRC_L:        read_reg = crc[7:0];
+
+                default: read_reg = 8'hFF;
+            endcase
+        end
+    endfunction
+
     //==========================================================================
     // SPI State Machine
     //==========================================================================
@@ -86,20 +242,66 @@ module stm32_spi_interface (
     reg [1:0]  spi_state;
     reg [3:0]  bit_count;
     reg [7:0]  addr_reg;
-    reg [7:0]  data_out;
     reg [7:0]  shift_reg;
+    reg        crc_en;              // Byte being sent is covered by the CRC
+
+    // Register presented next: the addressed one, then one up per byte
+    wire [7:0] next_addr = (bit_count == 4'd8) ? addr_reg + 8'd1 : addr_reg;
+    wire [7:0] next_byte = read_reg(next_addr);
+    wire       next_crc_en = (next_addr >= FRAME_BASE) && (next_addr < FRAME_CRC_H);
+
+    // MOSI side of the data bytes (command receiver)
+    reg        cmd_armed;           // Burst started at FRAME_BASE
+    reg [2:0]  rx_bits;
+    reg [3:0]  rx_index;            // Data byte being received
+    reg [7:0]  rx_shift;
+    reg [7:0]  cmd_sync;
+    reg [7:0]  cmd_crc_h;
+    reg [15:0] cmd_crc;             // Running CRC of command bytes 0-5
+    reg [7:0]  rx_flags;
+    reg [15:0] rx_m1, rx_m2;
+    wire [7:0] rx_byte = {rx_shift[6:0], spi_mosi_bit};
 
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
             spi_state <= IDLE;
             bit_count <= 4'd0;
             addr_reg <= 8'd0;
-            data_out <= 8'd0;
             shift_reg <= 8'd0;
+            crc_en <= 1'b0;
+            crc <= 16'hFFFF;
             spi_miso <= 1'b0;
             data_read_strobe <= 1'b0;
+            cmd_armed <= 1'b0;
+            rx_bits <= 3'd0;
+            rx_index <= 4'd0;
+            rx_shift <= 8'd0;
+            cmd_sync <= 8'd0;
+            cmd_crc_h <= 8'd0;
+            cmd_crc <= 16'hFFFF;
+            rx_flags <= 8'd0;
+            rx_m1 <= 16'd0;
+            rx_m2 <= 16'd0;
+            cmd_valid <= 1'b0;
+            cmd_error <= 1'b0;
+            cmd_type <= 8'd0;
+            cmd_flags <= 8'd0;
+            cmd_m1 <= 16'd0;
+            cmd_m2 <= 16'd0;
+            snap_ch0 <= 16'd0;
+            snap_ch1 <= 16'd0;
+            snap_ch2 <= 16'd0;
+            snap_ch3 <= 16'd0;
+            snap_valid <= 4'd0;
+            snap_pwm <= 4'd0;
+            snap_fault_hi <= 4'd0;
+            snap_fault_lo <= 4'd0;
+            snap_cnt <= 32'd0;
+            snap_time <= 32'd0;
         end else begin
             data_read_strobe <= 1'b0;
+            cmd_valid <= 1'b0;
+            cmd_error <= 1'b0;
 
             if (!spi_cs_active) begin
                 // CS inactive - reset state
@@ -124,45 +326,90 @@ module stm32_spi_interface (
                             bit_count <= bit_count + 1;
 
                             if (bit_count == 4'd7) begin
-                                // Address received, look up data
+                                // Address received: freeze the whole bank
                                 addr_reg <= {shift_reg[6:0], spi_mosi_bit};
                                 spi_state <= DATA;
                                 bit_count <= 4'd0;
+
+                                snap_ch0 <= adc_ch0;
+                                snap_ch1 <= adc_ch1;
+                                snap_ch2 <= adc_ch2;
+                                snap_ch3 <= adc_ch3;
+                                snap_valid <= adc_data_valid;
+                                snap_pwm <= pwm_status;
+                                snap_fault_hi <= fault_hi;
+                                snap_fault_lo <= fault_lo;
+                                snap_cnt <= adc_sample_cnt;
+                                snap_time <= adc_timestamp;
+                                crc <= 16'hFFFF;
+
+                                cmd_armed <= ({shift_reg[6:0], spi_mosi_bit} == FRAME_BASE);
+                                rx_bits <= 3'd0;
+                                rx_index <= 4'd0;
+                                cmd_crc <= 16'hFFFF;
                             end
                         end
                     end
 
                     DATA: begin
-                        // Send data byte
-                        if (bit_count == 4'd0 && spi_sck_falling) begin
-                            // Load data on first falling edge
-                            case (addr_reg)
-                                8'h00: data_out <= {4'd0, adc_data_valid};
-                                8'h01: data_out <= adc_ch0[15:8];
-                                8'h02: data_out <= adc_ch0[7:0];
-                                8'h03: data_out <= adc_ch1[15:8];
-                                8'h04: data_out <= adc_ch1[7:0];
-                                8'h05: data_out <= adc_ch2[15:8];
-                                8'h06: data_out <= adc_ch2[7:0];
-                                8'h07: data_out <= adc_ch3[15:8];
-                                8'h08: data_out <= adc_ch3[7:0];
-                                8'h09: data_out <= adc_sample_cnt[7:0];
-                                default: data_out <= 8'hFF;
-                            endcase
-                            shift_reg <= data_out;
-                            spi_miso <= data_out[7];
-                            bit_count <= bit_count + 1;
-                        end else if (spi_sck_falling && bit_count > 0) begin
-                            // Shift out data
-                            shift_reg <= {shift_reg[6:0], 1'b0};
-                            spi_miso <= shift_reg[7];
-                            bit_count <= bit_count + 1;
+                        // Mode 0: MISO changes on the falling edge, so each
+                        // byte's MSB goes out on the last falling edge of
+                        // the previous byte (bit_count 0: address byte,
+                        // 8: previous data byte)
+                        if (spi_sck_falling) begin
+                            if (bit_count == 4'd0 || bit_count == 4'd8) begin
+                                addr_reg <= next_addr;
+                                spi_miso <= next_byte[7];
+                                shift_reg <= {next_byte[6:0], 1'b0};
+                                bit_count <= 4'd1;
+                                data_read_strobe <= (bit_count == 4'd8);
+                                crc_en <= next_crc_en;
+                                if (next_crc_en)
+                                    crc <= crc16_bit(crc, next_byte[7]);
+                            end else begin
+                                // Shift out data
+                                spi_miso <= shift_reg[7];
+                                shift_reg <= {shift_reg[6:0], 1'b0};
+                                bit_count <= bit_count + 1;
+                                if (crc_en)
+                                    crc <= crc16_bit(crc, shift_reg[7]);
+                            end
+                        end
 
-                            if (bit_count == 4'd8) begin
-                                // Data sent, ready for next address
-                                spi_state <= ADDR;
-                                bit_count <= 4'd0;
-                                data_read_strobe <= 1'b1;
+                        // MOSI is sampled on the rising edge; only the
+                        // first 8 bytes of a frame burst are looked at
+                        if (spi_sck_rising && cmd_armed && rx_index <= CMD_LAST) begin
+                            rx_shift <= rx_byte;
+                            rx_bits <= rx_bits + 1;
+                            if (rx_index < CMD_CRC_H)
+                                cmd_crc <= crc16_bit(cmd_crc, spi_mosi_bit);
+
+                            if (rx_bits == 3'd7) begin
+                                rx_index <= rx_index + 1;
+                                case (rx_index)
+                                    4'd0: cmd_sync <= rx_byte;
+                                    4'd1: rx_flags <= rx_byte;
+                                    4'd2: rx_m1[15:8] <= rx_byte;
+                                    4'd3: rx_m1[7:0] <= rx_byte;
+                                    4'd4: rx_m2[15:8] <= rx_byte;
+                                    4'd5: rx_m2[7:0] <= rx_byte;
+                                    4'd6: cmd_crc_h <= rx_byte;
+                                    default: begin
+                                        // Last byte: release the command
+                                        // only if it is one and intact
+                                        if (cmd_sync == CMD_PWM || cmd_sync == CMD_LIMIT) begin
+                                            if ({cmd_crc_h, rx_byte} == cmd_crc) begin
+                                                cmd_valid <= 1'b1;
+                                                cmd_type <= cmd_sync;
+                                                cmd_flags <= rx_flags;
+                                                cmd_m1 <= rx_m1;
+                                                cmd_m2 <= rx_m2;
+                                            end else begin
+                                                cmd_error <= 1'b1;
+                                            end
+                                        end
+                                    end
+                                endcase
                             end
                         end
                     end
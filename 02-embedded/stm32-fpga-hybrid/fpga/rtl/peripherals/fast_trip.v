@@ -0,0 +1,85 @@
+/**
+ * @file fast_trip.v
+ * @brief Over-current / over-voltage fast trip with latched fault register
+ *
+ * Compares every ADC sample against a programmable window per channel and
+ * kills the gate drives in hardware, without waiting for the STM32:
+ *
+ *   sample > limit_hi  ->  fault_hi[ch]
+ *   sample < limit_lo  ->  fault_lo[ch]
+ *
+ * The comparison is registered on the clock the sample arrives, and the
+ * gates are ANDed with the latched result, so they go low one clock
+ * after sample_valid (20 ns at 50 MHz). The fault bits are sticky: only
+ * clear resets them, and a channel still out of range trips again on its
+ * next sample. A limit of limit_hi = 16'hFFFF / limit_lo = 16'h0000
+ * disables that side.
+ *
+ * Channels are packed ch0 in [15:0] .. ch3 in [63:48].
+ *
+ * @param clk           System clock
+ * @param rst_n         Active-low reset
+ * @param sample        ADC samples, all channels
+ * @param sample_valid  Pulse: new sample on every channel
+ * @param limit_hi      Upper limit per channel (trip above)
+ * @param limit_lo      Lower limit per channel (trip below)
+ * @param clear         Pulse: clear the fault register
+ * @param gate_in       Gate drives from the PWM
+ * @param gate_out      Gate drives, forced low while tripped
+ * @param fault_hi      Latched: channel exceeded limit_hi
+ * @param fault_lo      Latched: channel fell below limit_lo
+ * @param tripped       Any fault latched
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+module fast_trip #(
+    parameter N_CH = 4,
+    parameter N_GATES = 8
+)(
+    input  wire                 clk,
+    input  wire                 rst_n,
+    input  wire [16*N_CH-1:0]   sample,
+    input  wire                 sample_valid,
+    input  wire [16*N_CH-1:0]   limit_hi,
+    input  wire [16*N_CH-1:0]   limit_lo,
+    input  wire                 clear,
+    input  wire [N_GATES-1:0]   gate_in,
+    output wire [N_GATES-1:0]   gate_out,
+    output reg  [N_CH-1:0]      fault_hi,
+    output reg  [N_CH-1:0]      fault_lo,
+    output wire                 tripped
+);
+
+    // Window comparators, one pair per channel
+    wire [N_CH-1:0] over, under;
+
+    genvar c;
+    generate
+        for (c = 0; c < N_CH; c = c + 1) begin : window
+            assign over[c]  = sample[16*c +: 16] > limit_hi[16*c +: 16];
+            assign under[c] = sample[16*c +: 16] < limit_lo[16*c +: 16];
+        end
+    endgenerate
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            fault_hi <= {N_CH{1'b0}};
+            fault_lo <= {N_CH{1'b0}};
+        end else if (clear) begin
+            // A sample arriving with the clear is still checked
+            fault_hi <= sample_valid ? over  : {N_CH{1'b0}};
+            fault_lo <= sample_valid ? under : {N_CH{1'b0}};
+        end else if (sample_valid) begin
+            fault_hi <= fault_hi | over;
+            fault_lo <= fault_lo | under;
+        end
+    end
+
+    assign tripped = |{fault_hi, fault_lo};
+
+    // Kill path: registered fault, one AND gate to the pins
+    assign gate_out = gate_in & {N_GATES{~tripped}};
+
+endmodule
@@ -0,0 +1,260 @@
+/**
+ * @file fast_trip_tb.v
+ * @brief Fast trip testbench: window limits, fault latch and trip latency
+ *
+ * Drives fast_trip with samples as the channels' trip filters deliver
+ * them (one sample_valid pulse per sample) and switching gates.
+ *
+ * Checks:
+ * - Samples inside the window, and exactly at a limit, do not trip
+ * - Every channel trips on its upper and on its lower limit, and the
+ *   fault register names the channel and the side
+ * - Trip latency, from the out-of-range sample to all gates low, is
+ *   measured for every case and must stay below 1 us (one clk expected)
+ * - The fault is latched: gates stay off with the next in-range sample
+ * - Clear releases the gates only if the channel is back in range
+ * - Disabled limits (0xFFFF / 0x0000) never trip
+ *
+ * Run (from fpga/):
+ *   iverilog -o fast_trip_tb.vvp rtl/peripherals/fast_trip.v tb/fast_trip_tb.v \
+ *            && vvp fast_trip_tb.vvp
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+`timescale 1ns / 1ps
+
+module fast_trip_tb;
+
+    // Parameters
+    parameter CLK_PERIOD = 20;              // 50 MHz FPGA clock
+    parameter MAX_LATENCY_NS = 1000;
+
+    // Testbench signals
+    reg         clk;
+    reg         rst_n;
+    reg  [63:0] sample;
+    reg         sample_valid;
+    reg  [63:0] limit_hi;
+    reg  [63:0] limit_lo;
+    reg         clear;
+    reg  [7:0]  gate_in;
+    wire [7:0]  gate_out;
+    wire [3:0]  fault_hi;
+    wire [3:0]  fault_lo;
+    wire        tripped;
+
+    // DUT instantiation
+    fast_trip #(
+        .N_CH(4),
+        .N_GATES(8)
+    ) dut (
+        .clk            (clk),
+        .rst_n          (rst_n),
+        .sample         (sample),
+        .sample_valid   (sample_valid),
+        .limit_hi       (limit_hi),
+        .limit_lo       (limit_lo),
+        .clear          (clear),
+        .gate_in        (gate_in),
+        .gate_out       (gate_out),
+        .fault_hi       (fault_hi),
+        .fault_lo       (fault_lo),
+        .tripped        (tripped)
+    );
+
+    // Clock generation
+    initial begin
+        clk = 0;
+        forever #(CLK_PERIOD/2) clk = ~clk;
+    end
+
+    // Gates switching as under PWM: complementary pairs, toggling
+    always @(posedge clk)
+        gate_in <= ~gate_in;
+
+    // Test counters
+    integer pass_count = 0;
+    integer fail_count = 0;
+
+    task check;
+        input cond;
+        input [8*64:1] msg;
+        begin
+            if (cond) begin
+                $display("[PASS] %0s", msg);
+                pass_count = pass_count + 1;
+            end else begin
+                $display("[FAIL] %0s", msg);
+                fail_count = fail_count + 1;
+            end
+        end
+    endtask
+
+    //=========================================================================
+    // Stimulus helpers
+    //=========================================================================
+
+    // In-range value for every channel
+    localparam [63:0] NOMINAL = {16'h8000, 16'h8000, 16'h8000, 16'h8000};
+
+    // Present one sample (one clk of sample_valid), as the CIC does
+    task put_sample;
+        input [63:0] value;
+        begin
+            @(negedge clk);
+            sample = value;
+            sample_valid = 1'b1;
+            @(negedge clk);
+            sample_valid = 1'b0;
+        end
+    endtask
+
+    // Worst gate-off latency seen, ns
+    real t_cross, latency, worst_latency;
+    integer k;
+
+    // Present an out-of-range sample and time it until every gate is low
+    task trip_and_measure;
+        input [63:0] value;
+        begin
+            @(negedge clk);
+            sample = value;
+            sample_valid = 1'b1;
+            t_cross = $realtime;
+            // 1 ns steps, give up at twice the limit
+            k = 0;
+            while (!(gate_out == 8'h00 && tripped) && k < MAX_LATENCY_NS * 2) begin
+                #1;
+                k = k + 1;
+            end
+            latency = $realtime - t_cross;
+            @(negedge clk);
+            sample_valid = 1'b0;
+            if (latency > worst_latency) worst_latency = latency;
+        end
+    endtask
+
+    task do_clear;
+        begin
+            @(negedge clk);
+            clear = 1'b1;
+            @(negedge clk);
+            clear = 1'b0;
+        end
+    endtask
+
+    //=========================================================================
+    // Test stimulus
+    //=========================================================================
+
+    integer ch, side, ok;
+    reg [63:0] value;
+
+    initial begin
+        $dumpfile("fast_trip_tb.vcd");
+        $dumpvars(0, fast_trip_tb);
+
+        $display("\n========================================");
+        $display("Fast Trip Latency Testbench");
+        $display("========================================");
+
+        // Initialize
+        rst_n = 0;
+        sample = NOMINAL;
+        sample_valid = 0;
+        clear = 0;
+        gate_in = 8'h55;
+        worst_latency = 0;
+
+        // Window 0x4000 .. 0xC000 on every channel
+        limit_hi = {4{16'hC000}};
+        limit_lo = {4{16'h4000}};
+
+        #(CLK_PERIOD * 10);
+        rst_n = 1;
+        #(CLK_PERIOD * 10);
+
+        // In range, and exactly at the limits
+        put_sample(NOMINAL);
+        put_sample({4{16'hC000}});
+        put_sample({4{16'h4000}});
+        #(CLK_PERIOD * 4);
+        check(!tripped && gate_out == gate_in, "no trip inside the window or at a limit");
+
+        // Every channel, both sides
+        ok = 1;
+        for (ch = 0; ch < 4; ch = ch + 1) begin
+            for (side = 0; side < 2; side = side + 1) begin
+                value = NOMINAL;
+                value[16*ch +: 16] = side ? 16'h3FFF : 16'hC001;
+                trip_and_measure(value);
+                $display("  ch%0d %0s: gates off after %0.0f ns", ch,
+                         side ? "under" : "over ", latency);
+                if (latency >= MAX_LATENCY_NS) ok = 0;
+                if (side == 0 && (fault_hi != (4'b1 << ch) || fault_lo != 4'b0)) ok = 0;
+                if (side == 1 && (fault_lo != (4'b1 << ch) || fault_hi != 4'b0)) ok = 0;
+
+                // Latched through an in-range sample
+                put_sample(NOMINAL);
+                #(CLK_PERIOD * 4);
+                if (!tripped || gate_out != 8'h00) ok = 0;
+
+                do_clear;
+                #(CLK_PERIOD * 2);
+                if (tripped || gate_out != gate_in) ok = 0;
+            end
+        end
+        check(ok, "each channel trips on both limits, fault register exact");
+        $display("  worst trip latency: %0.0f ns (%0.1f clk)",
+                 worst_latency, worst_latency / CLK_PERIOD);
+        check(worst_latency < MAX_LATENCY_NS, "trip latency below 1 us");
+        check(worst_latency <= 1.5 * CLK_PERIOD, "gates off within one clock of the sample");
+
+        // Clear while still out of range: trips again on the next sample
+        value = NOMINAL;
+        value[15:0] = 16'hF000;
+        trip_and_measure(value);
+        do_clear;
+        put_sample(value);
+        #(CLK_PERIOD * 2);
+        check(tripped && gate_out == 8'h00 && fault_hi == 4'b0001,
+              "clear with the channel still over: trips again");
+
+        // Clear together with an out-of-range sample: never released
+        put_sample(NOMINAL);
+        do_clear;
+        trip_and_measure({16'h8000, 16'h8000, 16'hF000, 16'h8000});  // ch1 over
+        value[15:0] = 16'h0100;                                      // ch0 under
+        @(negedge clk);
+        clear = 1'b1;
+        sample = value;
+        sample_valid = 1'b1;
+        @(negedge clk);
+        clear = 1'b0;
+        sample_valid = 1'b0;
+        check(tripped && gate_out == 8'h00 && fault_lo == 4'b0001 && fault_hi == 4'b0000,
+              "sample arriving with the clear still trips");
+        put_sample(NOMINAL);
+        do_clear;
+
+        // Disabled limits
+        limit_hi = {4{16'hFFFF}};
+        limit_lo = {4{16'h0000}};
+        put_sample({4{16'hFFFF}});
+        put_sample({4{16'h0000}});
+        #(CLK_PERIOD * 4);
+        check(!tripped && gate_out == gate_in, "disabled limits never trip");
+
+        $display("\n========================================");
+        $display("Tests passed: %0d, failed: %0d", pass_count, fail_count);
+        if (fail_count == 0)
+            $display("*** ALL TESTS PASSED! ***");
+        else
+            $display("*** %0d TEST(S) FAILED ***", fail_count);
+        $display("========================================");
+        $finish;
+    end
+
+endmodule
@@ -0,0 +1,320 @@
+/**
+ * @file fpga_sensing_top_tb.v
+ * @brief Hybrid FPGA top: ADC scale and fast trip from the input to the gates
+ *
+ * Drives fpga_sensing_top as the board does: each comp_in carries a
+ * first-order sigma-delta bitstream of an input level (ideal modulator,
+ * one bit per modulator clock of the DUT), and the STM32 side is a
+ * mode-0 SPI master sending the CRC-framed PWM command.
+ *
+ * Checks:
+ * - ADC codes use the 16-bit scale the STM32 converts with: a 0.70 input
+ *   reads 0.70 * 65535 on the frame and on the trip filter
+ * - PWM enabled by command, gates switching, no trip inside the window
+ * - Ch0 stepped from 0.70 to 0.85 of full scale, across the 60 V reset
+ *   limit (0xC2BA = 0.761): time from the step to the gates off must stay
+ *   within 2 * FAST_OSR modulator clocks plus margin (34 us); the
+ *   decimated ADC data is timed for comparison
+ * - Gates stay off, FAULT_HI names ch0, STATUS[7] reports the trip
+ *
+ * Run (from fpga/):
+ *   iverilog -o fpga_sensing_top_tb.vvp rtl/fpga_sensing_top.v \
+ *            rtl/interfaces/stm32_spi_interface.v rtl/peripherals/fast_trip.v \
+ *            ../../../03-fpga/rtl/carrier_generator.v ../../../03-fpga/rtl/pwm_comparator.v \
+ *            tb/fpga_sensing_top_tb.v && vvp fpga_sensing_top_tb.vvp
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-28
+ */
+
+`timescale 1ns / 1ps
+
+module fpga_sensing_top_tb;
+
+    // Parameters
+    parameter CLK_PERIOD = 20;              // 50 MHz FPGA clock
+    parameter SCK_HALF   = 95;              // 5.26 MHz SPI clock, at or above the shipped
+                                            // 5.25 MHz (ns per half; walks against clk)
+    parameter FRAME_SIZE = 21;
+    parameter FAST_OSR   = 16;
+    parameter MAX_TRIP_NS = (2 * FAST_OSR + 2) * 1000;
+
+    localparam [15:0] TRIP_HI = 16'hC2BA;   // Ch0 reset limit
+
+    // Testbench signals
+    reg         clk;
+    reg         rst_n;
+    reg  [3:0]  comp_in;
+    wire [3:0]  dac_out;
+    reg         spi_sck;
+    reg         spi_mosi;
+    reg         spi_cs_n;
+    wire        spi_miso;
+    wire [7:0]  gate_out;
+    wire [3:0]  led;
+    wire        adc_data_ready;
+
+    // DUT instantiation (command timeout at its maximum: the test sends
+    // one command)
+    fpga_sensing_top #(
+        .FAST_OSR(FAST_OSR),
+        .CMD_TIMEOUT(15)
+    ) dut (
+        .clk_50mhz      (clk),
+        .rst_n          (rst_n),
+        .comp_in        (comp_in),
+        .dac_out        (dac_out),
+        .spi_sck        (spi_sck),
+        .spi_mosi       (spi_mosi),
+        .spi_miso       (spi_miso),
+        .spi_cs_n       (spi_cs_n),
+        .gate_out       (gate_out),
+        .led            (led),
+        .adc_data_ready (adc_data_ready)
+    );
+
+    // Clock generation
+    initial begin
+        clk = 0;
+        forever #(CLK_PERIOD/2) clk = ~clk;
+    end
+
+    // Test counters
+    integer pass_count = 0;
+    integer fail_count = 0;
+
+    task check;
+        input cond;
+        input [8*64:1] msg;
+        begin
+            if (cond) begin
+                $display("[PASS] %0s", msg);
+                pass_count = pass_count + 1;
+            end else begin
+                $display("[FAIL] %0s", msg);
+                fail_count = fail_count + 1;
+            end
+        end
+    endtask
+
+    //=========================================================================
+    // Analog inputs: first-order sigma-delta per channel, Q16 level
+    //=========================================================================
+
+    integer vin [0:3];                      // Input level, 65536 = full scale
+    integer acc [0:3];
+    integer k;
+
+    always @(posedge clk) begin
+        if (dut.adc_channels[0].adc_ch.mod_tick) begin
+            for (k = 0; k < 4; k = k + 1) begin
+                acc[k] = acc[k] + vin[k];
+                if (acc[k] >= 65536) begin
+                    acc[k] = acc[k] - 65536;
+                    comp_in[k] <= 1'b1;
+                end else begin
+                    comp_in[k] <= 1'b0;
+                end
+            end
+        end
+    end
+
+    //=========================================================================
+    // SPI master (mode 0) and command framing, as stm32_spi_interface_tb
+    //=========================================================================
+
+    reg [7:0] rx [0:FRAME_SIZE-1];
+    reg [7:0] tx_buf [0:FRAME_SIZE-1];
+
+    task spi_burst;
+        input [7:0] addr;
+        input integer len;
+        integer n, b;
+        reg [7:0] tx, rx_byte;
+        begin
+            spi_cs_n = 1'b0;
+            #(SCK_HALF * 2);
+
+            for (n = 0; n <= len; n = n + 1) begin
+                tx = (n == 0) ? addr : tx_buf[n - 1];
+                for (b = 7; b >= 0; b = b - 1) begin
+                    spi_mosi = tx[b];
+                    #SCK_HALF;
+                    spi_sck = 1'b1;         // Master samples MISO
+                    rx_byte[b] = spi_miso;
+                    #SCK_HALF;
+                    spi_sck = 1'b0;
+                end
+                if (n > 0)
+                    rx[n - 1] = rx_byte;
+            end
+
+            #(SCK_HALF * 2);
+            spi_cs_n = 1'b1;
+            #(SCK_HALF * 4);
+        end
+    endtask
+
+    function [15:0] crc16_byte;
+        input [15:0] c;
+        input [7:0]  d;
+        integer j;
+        begin
+            crc16_byte = c;
+            for (j = 7; j >= 0; j = j - 1)
+                crc16_byte = {crc16_byte[14:0], 1'b0} ^
+                             ((crc16_byte[15] ^ d[j]) ? 16'h1021 : 16'h0000);
+        end
+    endfunction
+
+    task set_command;
+        input [7:0]  sync;
+        input [7:0]  flags;
+        input [15:0] m1, m2;
+        integer j;
+        reg [15:0] c;
+        begin
+            for (j = 0; j < FRAME_SIZE; j = j + 1)
+                tx_buf[j] = 8'h00;
+            tx_buf[0] = sync;
+            tx_buf[1] = flags;
+            tx_buf[2] = m1[15:8];
+            tx_buf[3] = m1[7:0];
+            tx_buf[4] = m2[15:8];
+            tx_buf[5] = m2[7:0];
+            c = 16'hFFFF;
+            for (j = 0; j < 6; j = j + 1)
+                c = crc16_byte(c, tx_buf[j]);
+            tx_buf[6] = c[15:8];
+            tx_buf[7] = c[7:0];
+        end
+    endtask
+
+    function frame_ok;
+        input dummy;
+        integer j;
+        reg [15:0] c;
+        begin
+            c = 16'hFFFF;
+            for (j = 0; j < FRAME_SIZE - 2; j = j + 1)
+                c = crc16_byte(c, rx[j]);
+            frame_ok = (rx[0] == 8'hA5) && (rx[1] == 8'd17) &&
+                       (c == {rx[19], rx[20]});
+        end
+    endfunction
+
+    //=========================================================================
+    // Gate activity
+    //=========================================================================
+
+    reg  [7:0] gate_prev;
+    integer    gate_edges;
+
+    always @(posedge clk) begin
+        if (gate_out != gate_prev)
+            gate_edges = gate_edges + 1;
+        gate_prev <= gate_out;
+    end
+
+    //=========================================================================
+    // Test stimulus
+    //=========================================================================
+
+    integer expect_code, err;
+    realtime t_step, t_trip, t_adc;
+    reg gates_stayed_off;
+
+    initial begin
+        $dumpfile("fpga_sensing_top_tb.vcd");
+        $dumpvars(1, fpga_sensing_top_tb);
+
+        $display("\n========================================");
+        $display("Hybrid FPGA Top: ADC Scale and Fast Trip Testbench");
+        $display("========================================");
+
+        // Initialize
+        rst_n = 0;
+        comp_in = 4'd0;
+        spi_sck = 0;
+        spi_mosi = 0;
+        spi_cs_n = 1;
+        gate_prev = 8'd0;
+        gate_edges = 0;
+        for (k = 0; k < 4; k = k + 1) begin
+            vin[k] = 32768;
+            acc[k] = 0;
+        end
+        vin[0] = 45875;                     // 0.70: DC bus 1 below its limit
+
+        #(CLK_PERIOD * 10);
+        rst_n = 1;
+
+        // Let the CIC (three 100 us samples plus its comb pipeline) and
+        // the trip filter settle
+        #1_000_000;
+
+        expect_code = 45875 * 65535 / 65536;
+        err = dut.frame_ch0 - expect_code;
+        $display("  ch0 0.70 FS: ADC %0d, trip filter %0d, expected %0d",
+                 dut.frame_ch0, dut.fast_sample[15:0], expect_code);
+        check(err < 656 && err > -656, "ADC data on the 16-bit scale (0.70 FS within 1%)");
+        err = dut.fast_sample[15:0] - expect_code;
+        check(err < 1311 && err > -1311, "trip filter on the same scale (within 2%)");
+        err = dut.frame_ch1 - 32767;
+        check(err < 656 && err > -656, "ch1 0.50 FS within 1%");
+
+        // Enable the PWM: 0.5 on both bridges, clear any fault
+        set_command(8'h5A, 8'h03, 16'sd8192, 16'sd8192);
+        spi_burst(8'h40, FRAME_SIZE);
+        gate_edges = 0;
+        #150_000;
+        check(dut.pwm_enable && gate_edges > 8, "PWM enabled by command, gates switching");
+        check(!dut.trip, "no trip inside the window");
+
+        // Step ch0 across the limit
+        vin[0] = 55705;                     // 0.85
+        t_step = $realtime;
+        t_trip = 0;
+        t_adc = 0;
+        while ((t_trip == 0 || t_adc == 0) && $realtime - t_step < 2_000_000) begin
+            @(posedge clk);
+            if (t_trip == 0 && dut.trip)
+                t_trip = $realtime;
+            if (t_adc == 0 && dut.frame_ch0 > TRIP_HI)
+                t_adc = $realtime;
+        end
+
+        $display("  step to 0.85 FS: gates off after %0.1f us, ADC data over the limit after %0.1f us",
+                 (t_trip - t_step) / 1000.0, (t_adc - t_step) / 1000.0);
+        check(t_trip > 0 && t_trip - t_step <= MAX_TRIP_NS,
+              "gates off within 2 * FAST_OSR modulator clocks of the step");
+        check(t_adc > 0 && t_trip < t_adc, "trip ahead of the decimated ADC data");
+
+        // Gates stay off
+        gates_stayed_off = 1;
+        repeat (10_000) begin
+            @(posedge clk);
+            if (gate_out != 8'd0)
+                gates_stayed_off = 0;
+        end
+        check(gates_stayed_off && !dut.pwm_enable, "gates stay off, PWM enable dropped");
+
+        // Fault register and frame status
+        for (k = 0; k < FRAME_SIZE; k = k + 1)
+            tx_buf[k] = 8'h00;
+        spi_burst(8'h11, 2);
+        check(rx[0] == 8'h01 && rx[1] == 8'h00, "FAULT_HI names ch0, FAULT_LO clear");
+        spi_burst(8'h40, FRAME_SIZE);
+        check(frame_ok(0) && rx[6][7], "frame intact, STATUS[7] reports the trip");
+
+        $display("\n========================================");
+        $display("Tests passed: %0d, failed: %0d", pass_count, fail_count);
+        if (fail_count == 0)
+            $display("*** ALL TESTS PASSED! ***");
+        else
+            $display("*** %0d TEST(S) FAILED ***", fail_count);
+        $display("========================================");
+        $finish;
+    end
+
+endmodule
@@ -0,0 +1,469 @@
+/**
+ * @file stm32_spi_interface_tb.v
+ * @brief CRC-protected SPI frame testbench with bit-error injection
+ *
+ * Drives stm32_spi_interface with a mode-0 SPI master model (as the
+ * STM32 does) and reads the 21-byte frame from 0x40.
+ *
+ * Checks:
+ * - Clean frame: sync, length, payload and CRC-16 match the inputs
+ * - Snapshot: inputs changed mid-burst do not leak into the frame
+ * - Plain register burst (0x00 ..) still returns the snapshot bank
+ * - SEQ follows the sample counter
+ * - Bit errors injected on MISO (as sampled by the master): every
+ *   single, double and triple bit error, every burst up to 16 bits and
+ *   random multi-bit patterns are rejected by the receiver's check
+ *   (sync/length + CRC, as fpga_read_all_adc() does)
+ * - PWM command on MOSI: an intact command is released with its fields,
+ *   a corrupted one only raises cmd_error, a read-only frame (no command
+ *   sync) and a burst not starting at 0x40 raise neither; pwm_status
+ *   appears in STATUS[7:4]
+ * - Trip limit command released with its type; fault register and limits
+ *   read back at 0x11-0x22
+ *
+ * Run (from fpga/):
+ *   iverilog -o stm32_spi_interface_tb.vvp rtl/interfaces/stm32_spi_interface.v \
+ *            tb/stm32_spi_interface_tb.v && vvp stm32_spi_interface_tb.vvp
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+`timescale 1ns / 1ps
+
+module stm32_spi_interface_tb;
+
+    // Parameters
+    parameter CLK_PERIOD = 20;              // 50 MHz FPGA clock
+    parameter SCK_HALF   = 95;              // 5.26 MHz SPI clock, at or above the shipped
+                                            // 5.25 MHz (ns per half; walks against clk)
+    parameter FRAME_SIZE = 21;
+    parameter FRAME_BITS = FRAME_SIZE * 8;
+
+    // Testbench signals
+    reg         clk;
+    reg         rst_n;
+    reg         spi_sck;
+    reg         spi_mosi;
+    reg         spi_cs_n;
+    wire        spi_miso;
+    reg  [15:0] adc_ch0, adc_ch1, adc_ch2, adc_ch3;
+    reg  [3:0]  adc_data_valid;
+    reg  [31:0] adc_sample_cnt;
+    reg  [31:0] adc_timestamp;
+    reg  [3:0]  pwm_status;
+    reg  [3:0]  fault_hi, fault_lo;
+    reg  [63:0] limit_hi, limit_lo;
+    wire        cmd_valid, cmd_error;
+    wire [7:0]  cmd_type;
+    wire [7:0]  cmd_flags;
+    wire [15:0] cmd_m1, cmd_m2;
+    wire        data_read_strobe;
+
+    // DUT instantiation
+    stm32_spi_interface dut (
+        .clk                (clk),
+        .rst_n              (rst_n),
+        .spi_sck            (spi_sck),
+        .spi_mosi           (spi_mosi),
+        .spi_miso           (spi_miso),
+        .spi_cs_n           (spi_cs_n),
+        .adc_ch0            (adc_ch0),
+        .adc_ch1            (adc_ch1),
+        .adc_ch2            (adc_ch2),
+        .adc_ch3            (adc_ch3),
+        .adc_data_valid     (adc_data_valid),
+        .adc_sample_cnt     (adc_sample_cnt),
+        .adc_timestamp      (adc_timestamp),
+        .pwm_status         (pwm_status),
+        .fault_hi           (fault_hi),
+        .fault_lo           (fault_lo),
+        .limit_hi           (limit_hi),
+        .limit_lo           (limit_lo),
+        .cmd_valid          (cmd_valid),
+        .cmd_error          (cmd_error),
+        .cmd_type           (cmd_type),
+        .cmd_flags          (cmd_flags),
+        .cmd_m1             (cmd_m1),
+        .cmd_m2             (cmd_m2),
+        .data_read_strobe   (data_read_strobe)
+    );
+
+    // Clock generation
+    initial begin
+        clk = 0;
+        forever #(CLK_PERIOD/2) clk = ~clk;
+    end
+
+    // Test counters
+    integer pass_count = 0;
+    integer fail_count = 0;
+
+    task check;
+        input cond;
+        input [8*64:1] msg;
+        begin
+            if (cond) begin
+                $display("[PASS] %0s", msg);
+                pass_count = pass_count + 1;
+            end else begin
+                $display("[FAIL] %0s", msg);
+                fail_count = fail_count + 1;
+            end
+        end
+    endtask
+
+    //=========================================================================
+    // SPI master (mode 0) with error injection
+    //=========================================================================
+
+    reg [7:0]            rx [0:FRAME_SIZE-1];
+    reg [7:0]            tx_buf [0:FRAME_SIZE-1];  // MOSI data bytes
+    reg [FRAME_BITS-1:0] err_mask;          // Bit i flips received bit i
+
+    // Changed on the first data byte, to test the snapshot
+    reg                  change_mid_burst;
+
+    task spi_burst;
+        input [7:0] addr;
+        input integer len;
+        integer n, b, k;
+        reg [7:0] tx, rx_byte;
+        begin
+            spi_cs_n = 1'b0;
+            #(SCK_HALF * 2);
+
+            for (n = 0; n <= len; n = n + 1) begin
+                tx = (n == 0) ? addr : tx_buf[n - 1];
+                for (b = 7; b >= 0; b = b - 1) begin
+                    spi_mosi = tx[b];
+                    #SCK_HALF;
+                    spi_sck = 1'b1;         // Master samples MISO
+                    if (n > 0) begin
+                        k = (n - 1) * 8 + (7 - b);
+                        rx_byte[b] = spi_miso ^ ((k < FRAME_BITS) ? err_mask[k] : 1'b0);
+                    end
+                    #SCK_HALF;
+                    spi_sck = 1'b0;
+                end
+                if (n > 0)
+                    rx[n - 1] = rx_byte;
+                if (n == 1 && change_mid_burst) begin
+                    adc_ch0 = ~adc_ch0;
+                    adc_ch3 = ~adc_ch3;
+                    adc_sample_cnt = adc_sample_cnt + 1;
+                    adc_timestamp = adc_timestamp + 2000;
+                end
+            end
+
+            #(SCK_HALF * 2);
+            spi_cs_n = 1'b1;
+            #(SCK_HALF * 4);
+        end
+    endtask
+
+    //=========================================================================
+    // Receiver check (reference of fpga_read_all_adc)
+    //=========================================================================
+
+    function [15:0] crc16_byte;
+        input [15:0] c;
+        input [7:0]  d;
+        integer j;
+        begin
+            crc16_byte = c;
+            for (j = 7; j >= 0; j = j - 1)
+                crc16_byte = {crc16_byte[14:0], 1'b0} ^
+                             ((crc16_byte[15] ^ d[j]) ? 16'h1021 : 16'h0000);
+        end
+    endfunction
+
+    // Command pulses seen since the last clear
+    integer valid_pulses, error_pulses;
+
+    always @(posedge clk) begin
+        if (cmd_valid) valid_pulses = valid_pulses + 1;
+        if (cmd_error) error_pulses = error_pulses + 1;
+    end
+
+    // Put a command into the MOSI bytes, with its CRC
+    task set_command;
+        input [7:0]  sync;
+        input [7:0]  flags;
+        input [15:0] m1, m2;
+        integer j;
+        reg [15:0] c;
+        begin
+            for (j = 0; j < FRAME_SIZE; j = j + 1)
+                tx_buf[j] = 8'h00;
+            tx_buf[0] = sync;
+            tx_buf[1] = flags;
+            tx_buf[2] = m1[15:8];
+            tx_buf[3] = m1[7:0];
+            tx_buf[4] = m2[15:8];
+            tx_buf[5] = m2[7:0];
+            c = 16'hFFFF;
+            for (j = 0; j < 6; j = j + 1)
+                c = crc16_byte(c, tx_buf[j]);
+            tx_buf[6] = c[15:8];
+            tx_buf[7] = c[7:0];
+            valid_pulses = 0;
+            error_pulses = 0;
+        end
+    endtask
+
+    function frame_ok;
+        input dummy;
+        integer j;
+        reg [15:0] c;
+        begin
+            c = 16'hFFFF;
+            for (j = 0; j < FRAME_SIZE - 2; j = j + 1)
+                c = crc16_byte(c, rx[j]);
+            frame_ok = (rx[0] == 8'hA5) && (rx[1] == 8'd17) &&
+                       (c == {rx[19], rx[20]});
+        end
+    endfunction
+
+    function payload_matches;
+        input [15:0] c0, c1, c2, c3;
+        input [31:0] cnt, ts;
+        begin
+            payload_matches =
+                {rx[5], rx[4], rx[3], rx[2]} == cnt &&
+                rx[6] == {pwm_status, adc_data_valid} &&
+                {rx[7], rx[8]} == c0 && {rx[9], rx[10]} == c1 &&
+                {rx[11], rx[12]} == c2 && {rx[13], rx[14]} == c3 &&
+                {rx[18], rx[17], rx[16], rx[15]} == ts;
+        end
+    endfunction
+
+    // Read one frame with the given error pattern, return whether the
+    // receiver rejects it
+    task read_corrupted;
+        input [FRAME_BITS-1:0] mask;
+        output rejected;
+        begin
+            err_mask = mask;
+            spi_burst(8'h40, FRAME_SIZE);
+            err_mask = 0;
+            rejected = !frame_ok(0);
+        end
+    endtask
+
+    //=========================================================================
+    // Test stimulus
+    //=========================================================================
+
+    integer i, j, missed, trials, seed;
+    reg [FRAME_BITS-1:0] mask;
+    reg rejected;
+    reg [15:0] c0, c3;
+    reg [31:0] cnt, ts;
+
+    initial begin
+        $dumpfile("stm32_spi_interface_tb.vcd");
+        $dumpvars(1, stm32_spi_interface_tb);
+
+        $display("\n========================================");
+        $display("SPI Frame CRC / Bit-Error Injection Testbench");
+        $display("========================================");
+
+        // Initialize
+        rst_n = 0;
+        spi_sck = 0;
+        spi_mosi = 0;
+        spi_cs_n = 1;
+        err_mask = 0;
+        change_mid_burst = 0;
+        pwm_status = 4'd0;
+        fault_hi = 4'd0;
+        fault_lo = 4'd0;
+        limit_hi = 64'hFFFF_FFFF_C2BA_C2BA;
+        limit_lo = 64'h0000_1234_0000_0000;
+        for (i = 0; i < FRAME_SIZE; i = i + 1)
+            tx_buf[i] = 8'h00;
+        valid_pulses = 0;
+        error_pulses = 0;
+        seed = 42;
+        adc_ch0 = 16'h1234;
+        adc_ch1 = 16'hABCD;
+        adc_ch2 = 16'h0F0F;
+        adc_ch3 = 16'h8001;
+        adc_data_valid = 4'hF;
+        adc_sample_cnt = 32'h0001_00FE;
+        adc_timestamp = 32'hDEAD_BEEF;
+
+        #(CLK_PERIOD * 10);
+        rst_n = 1;
+        #(CLK_PERIOD * 10);
+
+        // Clean frame
+        spi_burst(8'h40, FRAME_SIZE);
+        check(frame_ok(0), "clean frame: sync, length and CRC valid");
+        check(payload_matches(adc_ch0, adc_ch1, adc_ch2, adc_ch3,
+                              adc_sample_cnt, adc_timestamp),
+              "clean frame: payload matches the inputs");
+
+        // SEQ follows the sample counter
+        adc_sample_cnt = adc_sample_cnt + 1;
+        spi_burst(8'h40, FRAME_SIZE);
+        check(frame_ok(0) && {rx[5], rx[4], rx[3], rx[2]} == 32'h0001_00FF,
+              "SEQ advances with the sample counter");
+
+        // Snapshot: inputs change after the first data byte
+        c0 = adc_ch0; c3 = adc_ch3; cnt = adc_sample_cnt; ts = adc_timestamp;
+        change_mid_burst = 1;
+        spi_burst(8'h40, FRAME_SIZE);
+        change_mid_burst = 0;
+        check(frame_ok(0) && payload_matches(c0, adc_ch1, adc_ch2, c3, cnt, ts),
+              "frame is one snapshot despite mid-burst update");
+
+        // Plain register burst from the bank
+        spi_burst(8'h00, 17);
+        check(rx[0] == {pwm_status, adc_data_valid} &&
+              {rx[1], rx[2]} == adc_ch0 && {rx[7], rx[8]} == adc_ch3 &&
+              {rx[12], rx[11], rx[10], rx[9]} == adc_sample_cnt &&
+              {rx[16], rx[15], rx[14], rx[13]} == adc_timestamp,
+              "register burst 0x00-0x10 returns the bank");
+
+        // PWM command in the frame burst
+        set_command(8'h5A, 8'h01, 16'sd8192, -16'sd12000);
+        spi_burst(8'h40, FRAME_SIZE);
+        check(valid_pulses == 1 && error_pulses == 0 && cmd_type == 8'h5A &&
+              cmd_flags == 8'h01 && cmd_m1 == 16'sd8192 && cmd_m2 == -16'sd12000,
+              "command accepted with its fields");
+        check(frame_ok(0), "frame read intact alongside the command");
+
+        // Bad CRC: every single-bit error in the 8 command bytes
+        missed = 0;
+        for (i = 0; i < 64; i = i + 1) begin
+            set_command(8'h5A, 8'h00, 16'sd100, 16'sd200);
+            tx_buf[i / 8] = tx_buf[i / 8] ^ (8'h80 >> (i % 8));
+            spi_burst(8'h40, FRAME_SIZE);
+            // A hit sync byte makes it a read-only frame: no pulse at all
+            if (valid_pulses != 0 || (i >= 8 && error_pulses != 1))
+                missed = missed + 1;
+        end
+        check(missed == 0 && cmd_m1 == 16'sd8192,
+              "corrupted command rejected, previous one kept");
+
+        // Read-only frame (MOSI all zero)
+        set_command(8'h5A, 8'h01, 16'sd1, 16'sd2);
+        for (i = 0; i < FRAME_SIZE; i = i + 1)
+            tx_buf[i] = 8'h00;
+        spi_burst(8'h40, FRAME_SIZE);
+        check(valid_pulses == 0 && error_pulses == 0, "read-only frame carries no command");
+
+        // Command bytes in a burst from another address are ignored
+        set_command(8'h5A, 8'h01, 16'sd1, 16'sd2);
+        spi_burst(8'h00, 17);
+        check(valid_pulses == 0 && error_pulses == 0, "command outside a frame burst ignored");
+
+        // PWM status reported in STATUS[7:4]
+        pwm_status = 4'b0101;
+        for (i = 0; i < FRAME_SIZE; i = i + 1)
+            tx_buf[i] = 8'h00;
+        spi_burst(8'h40, FRAME_SIZE);
+        check(frame_ok(0) && rx[6] == {4'b0101, adc_data_valid},
+              "pwm_status in the frame STATUS byte");
+        pwm_status = 4'd0;
+
+        // Trip limit command
+        set_command(8'hC3, 8'h02, 16'hB000, 16'h5000);
+        spi_burst(8'h40, FRAME_SIZE);
+        check(valid_pulses == 1 && cmd_type == 8'hC3 && cmd_flags == 8'h02 &&
+              cmd_m1 == 16'hB000 && cmd_m2 == 16'h5000,
+              "limit command accepted with its type");
+
+        // Fault register and limits
+        fault_hi = 4'b0010;
+        fault_lo = 4'b1000;
+        for (i = 0; i < FRAME_SIZE; i = i + 1)
+            tx_buf[i] = 8'h00;
+        spi_burst(8'h11, 18);
+        check(rx[0] == 8'h02 && rx[1] == 8'h08 &&
+              {rx[2], rx[3]} == 16'hC2BA && {rx[4], rx[5]} == 16'h0000 &&
+              {rx[10], rx[11]} == 16'hFFFF && {rx[12], rx[13]} == 16'h1234 &&
+              {rx[16], rx[17]} == 16'h0000,
+              "fault register and limits read back");
+        fault_hi = 4'd0;
+        fault_lo = 4'd0;
+
+        // Error runs: ~1000 frames, no waveform
+        $dumpoff;
+
+        // Every single-bit error
+        missed = 0;
+        for (i = 0; i < FRAME_BITS; i = i + 1) begin
+            mask = 0;
+            mask[i] = 1'b1;
+            read_corrupted(mask, rejected);
+            if (!rejected) missed = missed + 1;
+        end
+        $display("  single-bit errors: %0d positions, %0d undetected", FRAME_BITS, missed);
+        check(missed == 0, "all single-bit errors detected");
+
+        // Random double and triple bit errors
+        missed = 0;
+        trials = 300;
+        for (i = 0; i < trials; i = i + 1) begin
+            mask = 0;
+            mask[{$random(seed)} % FRAME_BITS] = 1'b1;
+            j = {$random(seed)} % FRAME_BITS;
+            while (mask[j]) j = {$random(seed)} % FRAME_BITS;
+            mask[j] = 1'b1;
+            if (i % 2) begin
+                j = {$random(seed)} % FRAME_BITS;
+                while (mask[j]) j = {$random(seed)} % FRAME_BITS;
+                mask[j] = 1'b1;
+            end
+            read_corrupted(mask, rejected);
+            if (!rejected) missed = missed + 1;
+        end
+        $display("  2/3-bit errors: %0d trials, %0d undetected", trials, missed);
+        check(missed == 0, "all double/triple bit errors detected");
+
+        // Burst errors up to 16 bits (first and last bit of the burst set)
+        missed = 0;
+        trials = 300;
+        for (i = 0; i < trials; i = i + 1) begin
+            j = 2 + {$random(seed)} % 15;                   // Burst length 2..16
+            mask = {$random(seed)} & ((1 << j) - 1);
+            mask[0] = 1'b1;
+            mask[j - 1] = 1'b1;
+            mask = mask << ({$random(seed)} % (FRAME_BITS - j + 1));
+            read_corrupted(mask, rejected);
+            if (!rejected) missed = missed + 1;
+        end
+        $display("  burst errors <= 16 bits: %0d trials, %0d undetected", trials, missed);
+        check(missed == 0, "all burst errors up to 16 bits detected");
+
+        // Random heavy corruption (CRC-16 misses ~1 in 65536)
+        missed = 0;
+        trials = 300;
+        for (i = 0; i < trials; i = i + 1) begin
+            for (j = 0; j < FRAME_BITS; j = j + 1)
+                mask[j] = {$random(seed)} % 2;
+            if (mask == 0) mask[0] = 1'b1;
+            read_corrupted(mask, rejected);
+            if (!rejected) missed = missed + 1;
+        end
+        $display("  random patterns: %0d trials, %0d undetected", trials, missed);
+        check(missed == 0, "random multi-bit corruption detected");
+
+        // Link still clean afterwards
+        spi_burst(8'h40, FRAME_SIZE);
+        check(frame_ok(0), "clean frame after the error runs");
+
+        $display("\n========================================");
+        $display("Tests passed: %0d, failed: %0d", pass_count, fail_count);
+        if (fail_count == 0)
+            $display("*** ALL TESTS PASSED! ***");
+        else
+            $display("*** %0d TEST(S) FAILED ***", fail_count);
+        $display("========================================");
+        $finish;
+    end
+
+endmodule
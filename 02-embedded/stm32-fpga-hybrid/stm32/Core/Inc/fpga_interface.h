@@ -3,13 +3,16 @@
  * @brief FPGA Sensing Accelerator Interface Driver for STM32F401RE
  *
  * This driver provides high-level interface to read ADC data from the
- * FPGA sensing accelerator via SPI.
+ * FPGA sensing accelerator via SPI, and to command the FPGA PWM in the
+ * same transaction.
  *
  * Features:
- * - SPI communication with FPGA (up to 10 MHz)
+ * - SPI communication with FPGA (5.25 MHz)
  * - Register-based access to 4-channel ADC data
  * - Non-blocking and blocking read modes
  * - Data valid checking
+ * - PWM command (per-bridge modulation index) sent with each frame read
+ * - Hardware fast-trip limits and latched fault register
  *
  * Hardware Connections (STM32F401RE):
  * - SPI1 used for FPGA communication
@@ -33,7 +36,7 @@
 // FPGA Register Addresses
 //==========================================================================
 
-#define FPGA_REG_STATUS      0x00  // Status register [3:0]: Data valid flags
+#define FPGA_REG_STATUS      0x00  // [3:0]: Data valid flags, [7:4]: FPGA_PWM_* flags
 #define FPGA_REG_ADC_CH0_H   0x01  // Channel 0 high byte [15:8]
 #define FPGA_REG_ADC_CH0_L   0x02  // Channel 0 low byte [7:0]
 #define FPGA_REG_ADC_CH1_H   0x03  // Channel 1 high byte
@@ -42,7 +45,32 @@
 #define FPGA_REG_ADC_CH2_L   0x06  // Channel 2 low byte
 #define FPGA_REG_ADC_CH3_H   0x07  // Channel 3 high byte
 #define FPGA_REG_ADC_CH3_L   0x08  // Channel 3 low byte
-#define FPGA_REG_SAMPLE_CNT  0x09  // Sample counter (debug)
+#define FPGA_REG_SAMPLE_CNT  0x09  // Sample counter, 4 bytes LSB first (0x09-0x0C)
+#define FPGA_REG_TIMESTAMP   0x0D  // FPGA clk cycle of the sample, LSB first (0x0D-0x10)
+#define FPGA_REG_FAULT_HI    0x11  // [3:0]: channel tripped above its upper limit
+#define FPGA_REG_FAULT_LO    0x12  // [3:0]: channel tripped below its lower limit
+#define FPGA_REG_LIMITS      0x13  // Per channel HI_H, HI_L, LO_H, LO_L (0x13-0x22)
+
+#define FPGA_REG_FRAME       0x40  // CRC-protected frame (0x40-0x54)
+
+#define FPGA_FRAME_SIZE      21    // SYNC, LEN, SEQ, STATUS, CH0-3, TIMESTAMP, CRC
+#define FPGA_FRAME_SYNC      0xA5
+#define FPGA_FRAME_LEN       17    // Payload bytes (SEQ .. TIMESTAMP)
+#define FPGA_CLK_HZ          50000000
+
+// Command, sent on MOSI in the first bytes of the frame burst:
+// SYNC, ARG, word 1, word 2 (high byte first), CRC-16 over bytes 0-5
+#define FPGA_CMD_SIZE        8
+#define FPGA_CMD_PWM         0x5A  // ARG = FLAGS, words = M1, M2 (Q14)
+#define FPGA_CMD_LIMIT       0xC3  // ARG = channel, words = upper, lower limit
+#define FPGA_CMD_ENABLE      0x01  // FLAGS: gates switching
+#define FPGA_CMD_CLEAR_FAULT 0x02  // FLAGS: clear the fast-trip fault register
+
+// STATUS[7:4], as of the start of the transaction
+#define FPGA_PWM_RUNNING     0x10  // Gates switching
+#define FPGA_PWM_TIMEOUT     0x20  // Stopped: no valid command for CMD_TIMEOUT periods
+#define FPGA_PWM_REJECTED    0x40  // Last command failed its CRC
+#define FPGA_PWM_TRIPPED     0x80  // Fast trip latched, gates forced off
 
 //==========================================================================
 // Data Structures
@@ -67,8 +95,40 @@ typedef struct {
     uint16_t ch2;      // AC output voltage
     uint16_t ch3;      // AC output current
     uint8_t  valid;    // Data valid flags [3:0]
+    uint8_t  pwm_flags;     // FPGA_PWM_* flags (STATUS[7:4])
+    uint32_t sample_count;  // FPGA sample counter (changes with each new frame)
+    uint32_t timestamp;     // FPGA clk cycle the sample completed (50 MHz)
 } fpga_adc_data_t;
 
+/**
+ * @brief SPI link integrity counters
+ *
+ * A frame with a bad sync/length or CRC is dropped before its data reach
+ * the conversion and safety checks. SEQ is the FPGA sample counter: a
+ * repeat means no new sample since the last read, a jump of more than
+ * one means samples were missed.
+ */
+typedef struct {
+    uint32_t frames;        // Frames that passed the checks
+    uint32_t crc_errors;    // CRC mismatch
+    uint32_t sync_errors;   // Bad SYNC or LEN byte
+    uint32_t seq_repeats;   // Same sample as the previous frame
+    uint32_t seq_gaps;      // Samples skipped between frames
+    uint32_t cmd_rejects;   // Frames reporting the previous command rejected
+} fpga_link_stats_t;
+
+/**
+ * @brief PWM command for the FPGA
+ *
+ * The FPGA applies it at the next carrier peak. Leg A of each bridge
+ * switches on +m, leg B on -m, so the bridge averages m times its bus.
+ */
+typedef struct {
+    int16_t m_q14[2];       // Modulation index per H-bridge, Q14 (-1.0..+1.0)
+    bool    enable;         // false stops the gates at once
+    bool    clear_fault;    // Clear the fast-trip fault (re-trips if still out of range)
+} fpga_pwm_cmd_t;
+
 /**
  * @brief Physical sensor values (converted to real units)
  */
@@ -79,6 +139,20 @@ typedef struct {
     float ac_current_a; // AC output current (A)
 } fpga_sensor_values_t;
 
+/**
+ * @brief DC-link feed-forward, Q14 (16384 = 1.0)
+ *
+ * Per-bridge duty normalization from the raw bus codes: one integer
+ * division per bus and sample, the duty split only multiplies and shifts.
+ */
+typedef struct {
+    int32_t bus_q14[2];     // Measured / nominal bus per bridge
+    int32_t gain_q14[2];    // Nominal / measured bus (duty per level)
+} fpga_dc_feedforward_t;
+
+#define FPGA_DC_NOMINAL_V    50.0f  // Per-bridge bus the output level is scaled to
+#define FPGA_Q14_ONE         16384
+
 //==========================================================================
 // Public Functions
 //==========================================================================
@@ -99,12 +173,26 @@ HAL_StatusTypeDef fpga_init(SPI_HandleTypeDef *hspi);
  *
  * Performs SPI transaction to read one byte from specified register.
  *
- * @param addr Register address (0x00-0x09)
+ * @param addr Register address (0x00-0x10)
  * @param data Pointer to store read data
  * @return HAL_OK on success, HAL_ERROR on failure
  */
 HAL_StatusTypeDef fpga_read_register(uint8_t addr, uint8_t *data);
 
+/**
+ * @brief Read consecutive registers in one transaction
+ *
+ * The FPGA latches all registers into its snapshot bank when the
+ * address byte completes, so the bytes of one burst always belong to
+ * the same sample.
+ *
+ * @param addr First register address
+ * @param data Buffer for len bytes (addr, addr+1, ...)
+ * @param len Number of registers (1-FPGA_FRAME_SIZE)
+ * @return HAL_OK on success, HAL_ERROR on failure
+ */
+HAL_StatusTypeDef fpga_read_burst(uint8_t addr, uint8_t *data, uint16_t len);
+
 /**
  * @brief Read status register
  *
@@ -128,14 +216,76 @@ HAL_StatusTypeDef fpga_read_adc_channel(fpga_adc_channel_t channel, uint16_t *va
 /**
  * @brief Read all ADC channels at once
  *
- * Reads all 4 ADC channels in a single burst operation.
- * This is the recommended method for reading sensor data.
+ * Reads one CRC-protected frame (status, all 4 ADC channels, sample
+ * counter and timestamp) in a single burst, all from one snapshot
+ * (time-coherent). The frame is checked for sync, length and CRC-16
+ * before any field is used. This is the recommended method for reading
+ * sensor data.
  *
  * @param data Pointer to structure to store ADC data
- * @return HAL_OK on success, HAL_ERROR on failure
+ * @return HAL_OK on success, HAL_ERROR on SPI failure or a corrupted frame
+ *         (data left unchanged)
  */
 HAL_StatusTypeDef fpga_read_all_adc(fpga_adc_data_t *data);
 
+/**
+ * @brief Command the PWM and read all ADC channels in one transaction
+ *
+ * Full-duplex frame burst: the command goes out on MOSI while the frame
+ * of fpga_read_all_adc() comes back on MISO, so one SPI transaction per
+ * control period both samples and actuates. The returned data predate
+ * the command (snapshot at the address byte).
+ *
+ * @param cmd PWM command
+ * @param data Pointer to structure to store ADC data
+ * @return HAL_OK on success, HAL_ERROR on SPI failure or a corrupted frame
+ *         (data left unchanged; the command may still have been accepted)
+ */
+HAL_StatusTypeDef fpga_exchange_frame(const fpga_pwm_cmd_t *cmd, fpga_adc_data_t *data);
+
+/**
+ * @brief Set the fast-trip window of one channel
+ *
+ * The FPGA compares the channel's trip filter (sinc2 over 16 modulator
+ * bits, every 1 us, same code scale as the ADC data) against the window
+ * and forces all gates off one clock after a value outside it, latching
+ * the channel in its fault register. The filter resolves about 8 bits:
+ * keep ~1% of full scale between the window and normal operation. The limits are read back to
+ * confirm the command arrived. 0xFFFF / 0x0000 disable a side.
+ *
+ * @param channel ADC channel
+ * @param lo_code Lower limit, raw code (trip below)
+ * @param hi_code Upper limit, raw code (trip above)
+ * @return HAL_OK if the FPGA holds the new limits, HAL_ERROR otherwise
+ */
+HAL_StatusTypeDef fpga_set_trip_limits(fpga_adc_channel_t channel,
+                                       uint16_t lo_code, uint16_t hi_code);
+
+/**
+ * @brief Read the latched fast-trip fault register
+ *
+ * @param fault_hi Channels tripped above their upper limit [3:0]
+ * @param fault_lo Channels tripped below their lower limit [3:0]
+ * @return HAL_OK on success, HAL_ERROR on SPI failure
+ */
+HAL_StatusTypeDef fpga_read_fault(uint8_t *fault_hi, uint8_t *fault_lo);
+
+/**
+ * @brief CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), table-driven
+ *
+ * @param data Bytes to check
+ * @param len Number of bytes
+ * @return CRC of the bytes
+ */
+uint16_t fpga_crc16(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief SPI link integrity counters since fpga_init()
+ *
+ * @return Pointer to the counters
+ */
+const fpga_link_stats_t *fpga_get_link_stats(void);
+
 /**
  * @brief Convert raw ADC values to physical sensor values
  *
@@ -148,6 +298,46 @@ HAL_StatusTypeDef fpga_read_all_adc(fpga_adc_data_t *data);
 void fpga_convert_to_physical(const fpga_adc_data_t *raw_data,
                                fpga_sensor_values_t *sensor_values);
 
+/**
+ * @brief Convert a physical value to the raw ADC code of a channel
+ *
+ * Inverse of fpga_convert_to_physical(), clamped to the code range, for
+ * setting trip limits in volts and amps.
+ *
+ * @param channel ADC channel
+ * @param value Voltage (V) or current (A)
+ * @return Raw code, 0-65535
+ */
+uint16_t fpga_physical_to_code(fpga_adc_channel_t channel, float value);
+
+/**
+ * @brief Update the DC-link feed-forward from the raw bus channels
+ *
+ * A reading below half of nominal (sensor disconnected, precharge) is
+ * not trusted and counts as nominal (gain 1); above it a duty is at most
+ * doubled.
+ *
+ * @param ff Feed-forward state
+ * @param raw_data Raw ADC data (ch0 = bus 1, ch1 = bus 2)
+ */
+void fpga_dc_feedforward_update(fpga_dc_feedforward_t *ff,
+                                const fpga_adc_data_t *raw_data);
+
+/**
+ * @brief Split an output level into per-bridge modulation indices
+ *
+ * Phase-shifted split, matching the FPGA's carriers (both bridges compare
+ * against full-range carriers 90 deg apart): each bridge is asked for
+ * half the level, scaled by its gain; what one bus cannot supply of its
+ * half moves to the other. Without an update both buses are nominal.
+ *
+ * @param ff Feed-forward state
+ * @param level_q14 Output level in nominal bus voltages, Q14 (-2.0..+2.0)
+ * @param m_q14 Modulation index per bridge, Q14 (-1.0..+1.0)
+ */
+void fpga_dc_feedforward_split(const fpga_dc_feedforward_t *ff, int32_t level_q14,
+                               int16_t m_q14[2]);
+
 /**
  * @brief Check if new ADC data is available
  *
@@ -160,7 +350,7 @@ bool fpga_is_data_ready(void);
 /**
  * @brief Read sample counter (debug)
  *
- * Reads FPGA sample counter for debugging and verification.
+ * Reads the full 32-bit FPGA sample counter for debugging and verification.
  *
  * @return Sample count value
  */
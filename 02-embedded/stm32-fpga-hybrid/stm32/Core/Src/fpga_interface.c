@@ -7,12 +7,16 @@
  */
 
 #include "fpga_interface.h"
+#include <string.h>
 
 //==========================================================================
 // Private Variables
 //==========================================================================
 
 static SPI_HandleTypeDef *g_hspi = NULL;
+static fpga_link_stats_t g_link_stats;
+static uint32_t g_last_seq;
+static bool g_seq_valid = false;
 
 // Chip select pin configuration
 #define FPGA_CS_PORT    GPIOA
@@ -42,6 +46,49 @@ static SPI_HandleTypeDef *g_hspi = NULL;
 #define ACS724_SENSITIVITY      0.2f    // V/A
 #define ACS724_ZERO_CURRENT_V   2.5f    // V
 
+// DC bus code at FPGA_DC_NOMINAL_V (DC channels have no offset, so a code
+// ratio is a voltage ratio), and its reciprocal in Q30 for the bus ratio
+#define DC_NOMINAL_CODE  ((int32_t)(FPGA_DC_NOMINAL_V / VOLTAGE_DIVIDER_RATIO * AMC1301_GAIN \
+                                    / ADC_VREF * ADC_FULL_SCALE + 0.5f))
+#define DC_MIN_CODE      (DC_NOMINAL_CODE / 2)
+#define DC_BUS_SCALE_Q30 ((1 << 30) / DC_NOMINAL_CODE)
+
+// CRC-16/CCITT-FALSE, MSB first (as the FPGA shifts it out)
+static const uint16_t crc16_table[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
 //==========================================================================
 // Public Functions
 //==========================================================================
@@ -53,6 +100,8 @@ HAL_StatusTypeDef fpga_init(SPI_HandleTypeDef *hspi)
     }
 
     g_hspi = hspi;
+    memset(&g_link_stats, 0, sizeof(g_link_stats));
+    g_seq_valid = false;
 
     // Configure CS pin as output (push-pull)
     GPIO_InitTypeDef GPIO_InitStruct = {0};
@@ -77,15 +126,22 @@ void fpga_cs_control(bool state)
     }
 }
 
-HAL_StatusTypeDef fpga_read_register(uint8_t addr, uint8_t *data)
+// One transaction: address plus len data bytes. tx_data carries the
+// bytes sent during the data phase (NULL: zeros).
+static HAL_StatusTypeDef spi_transfer(uint8_t addr, const uint8_t *tx_data,
+                                      uint8_t *data, uint16_t len)
 {
-    if (g_hspi == NULL || data == NULL) {
+    if (g_hspi == NULL || data == NULL || len == 0 || len > FPGA_FRAME_SIZE) {
         return HAL_ERROR;
     }
 
     HAL_StatusTypeDef status;
-    uint8_t tx_data[2] = {addr, 0x00};  // Send address, dummy byte
-    uint8_t rx_data[2] = {0};
+    uint8_t tx_buf[FPGA_FRAME_SIZE + 1] = {addr};  // Address, then dummy bytes
+    uint8_t rx_data[FPGA_FRAME_SIZE + 1];
+
+    if (tx_data != NULL) {
+        memcpy(&tx_buf[1], tx_data, len);
+    }
 
     // CS low (select FPGA)
     fpga_cs_control(false);
@@ -93,24 +149,42 @@ HAL_StatusTypeDef fpga_read_register(uint8_t addr, uint8_t *data)
     // Small delay for CS setup time
     for (volatile int i = 0; i < 10; i++);
 
-    // Transmit address and receive data
-    status = HAL_SPI_TransmitReceive(g_hspi, tx_data, rx_data, 2, SPI_TIMEOUT_MS);
+    // Transmit address and receive len bytes from the snapshot
+    status = HAL_SPI_TransmitReceive(g_hspi, tx_buf, rx_data, len + 1, SPI_TIMEOUT_MS);
 
     // CS high (deselect FPGA)
     fpga_cs_control(true);
 
     if (status == HAL_OK) {
-        *data = rx_data[1];  // Second byte contains the data
+        for (uint16_t i = 0; i < len; i++) {
+            data[i] = rx_data[i + 1];  // Byte 0 was clocked in with the address
+        }
     }
 
     return status;
 }
 
+HAL_StatusTypeDef fpga_read_burst(uint8_t addr, uint8_t *data, uint16_t len)
+{
+    return spi_transfer(addr, NULL, data, len);
+}
+
+HAL_StatusTypeDef fpga_read_register(uint8_t addr, uint8_t *data)
+{
+    return fpga_read_burst(addr, data, 1);
+}
+
+static uint32_t le32(const uint8_t *b)
+{
+    return (uint32_t)b[0] | ((uint32_t)b[1] << 8) |
+           ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
 uint8_t fpga_read_status(void)
 {
     uint8_t status = 0;
     fpga_read_register(FPGA_REG_STATUS, &status);
-    return status & 0x0F;  // Only lower 4 bits are valid
+    return status & 0x0F;  // Data valid flags (upper nibble: PWM flags)
 }
 
 HAL_StatusTypeDef fpga_read_adc_channel(fpga_adc_channel_t channel, uint16_t *value)
@@ -119,49 +193,173 @@ HAL_StatusTypeDef fpga_read_adc_channel(fpga_adc_channel_t channel, uint16_t *va
         return HAL_ERROR;
     }
 
-    uint8_t addr_high = FPGA_REG_ADC_CH0_H + (channel * 2);
-    uint8_t addr_low = addr_high + 1;
-    uint8_t data_high, data_low;
+    uint8_t bytes[2];
 
-    // Read high byte
-    if (fpga_read_register(addr_high, &data_high) != HAL_OK) {
+    // High and low byte in one burst, so they cannot tear
+    if (fpga_read_burst(FPGA_REG_ADC_CH0_H + (channel * 2), bytes, 2) != HAL_OK) {
         return HAL_ERROR;
     }
 
-    // Read low byte
-    if (fpga_read_register(addr_low, &data_low) != HAL_OK) {
+    *value = ((uint16_t)bytes[0] << 8) | bytes[1];
+
+    return HAL_OK;
+}
+
+uint16_t fpga_crc16(const uint8_t *data, uint16_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (uint16_t i = 0; i < len; i++) {
+        crc = (uint16_t)(crc << 8) ^ crc16_table[(crc >> 8) ^ data[i]];
+    }
+
+    return crc;
+}
+
+const fpga_link_stats_t *fpga_get_link_stats(void)
+{
+    return &g_link_stats;
+}
+
+// Frame burst with an optional command on MOSI; checks and unpacks the
+// returned frame
+static HAL_StatusTypeDef frame_transfer(const uint8_t *cmd, fpga_adc_data_t *data)
+{
+    if (data == NULL) {
+        return HAL_ERROR;
+    }
+
+    uint8_t tx[FPGA_FRAME_SIZE] = {0};
+    uint8_t frame[FPGA_FRAME_SIZE];
+
+    if (cmd != NULL) {
+        memcpy(tx, cmd, FPGA_CMD_SIZE);
+    }
+
+    // One transaction: every field comes from the same snapshot
+    HAL_StatusTypeDef status = spi_transfer(FPGA_REG_FRAME, tx, frame, FPGA_FRAME_SIZE);
+    if (status != HAL_OK) return status;
+
+    if (frame[0] != FPGA_FRAME_SYNC || frame[1] != FPGA_FRAME_LEN) {
+        g_link_stats.sync_errors++;
+        return HAL_ERROR;
+    }
+
+    uint16_t crc = ((uint16_t)frame[19] << 8) | frame[20];
+    if (fpga_crc16(frame, FPGA_FRAME_SIZE - 2) != crc) {
+        g_link_stats.crc_errors++;
         return HAL_ERROR;
     }
 
-    // Combine bytes
-    *value = ((uint16_t)data_high << 8) | data_low;
+    uint32_t seq = le32(&frame[2]);
+    if (g_seq_valid) {
+        if (seq == g_last_seq) {
+            g_link_stats.seq_repeats++;
+        } else if (seq - g_last_seq > 1) {
+            g_link_stats.seq_gaps += seq - g_last_seq - 1;
+        }
+    }
+    g_last_seq = seq;
+    g_seq_valid = true;
+    g_link_stats.frames++;
+
+    data->sample_count = seq;
+    data->valid = frame[6] & 0x0F;
+    data->pwm_flags = frame[6] & 0xF0;
+    if (data->pwm_flags & FPGA_PWM_REJECTED) {
+        g_link_stats.cmd_rejects++;
+    }
+    data->ch0 = ((uint16_t)frame[7] << 8) | frame[8];
+    data->ch1 = ((uint16_t)frame[9] << 8) | frame[10];
+    data->ch2 = ((uint16_t)frame[11] << 8) | frame[12];
+    data->ch3 = ((uint16_t)frame[13] << 8) | frame[14];
+    data->timestamp = le32(&frame[15]);
 
     return HAL_OK;
 }
 
 HAL_StatusTypeDef fpga_read_all_adc(fpga_adc_data_t *data)
 {
-    if (data == NULL) {
+    return frame_transfer(NULL, data);
+}
+
+// SYNC, ARG, two words high byte first, CRC-16 over the six bytes
+static void build_command(uint8_t tx[FPGA_CMD_SIZE], uint8_t sync, uint8_t arg,
+                          uint16_t w1, uint16_t w2)
+{
+    tx[0] = sync;
+    tx[1] = arg;
+    tx[2] = (uint8_t)(w1 >> 8);
+    tx[3] = (uint8_t)w1;
+    tx[4] = (uint8_t)(w2 >> 8);
+    tx[5] = (uint8_t)w2;
+
+    uint16_t crc = fpga_crc16(tx, FPGA_CMD_SIZE - 2);
+    tx[6] = (uint8_t)(crc >> 8);
+    tx[7] = (uint8_t)crc;
+}
+
+HAL_StatusTypeDef fpga_exchange_frame(const fpga_pwm_cmd_t *cmd, fpga_adc_data_t *data)
+{
+    if (cmd == NULL) {
         return HAL_ERROR;
     }
 
-    HAL_StatusTypeDef status;
+    uint8_t tx[FPGA_CMD_SIZE];
+    uint16_t m1 = (uint16_t)cmd->m_q14[0];
+    uint16_t m2 = (uint16_t)cmd->m_q14[1];
 
-    // Read status
-    data->valid = fpga_read_status();
+    build_command(tx, FPGA_CMD_PWM,
+                  (cmd->enable ? FPGA_CMD_ENABLE : 0) |
+                  (cmd->clear_fault ? FPGA_CMD_CLEAR_FAULT : 0),
+                  m1, m2);
 
-    // Read all 4 channels
-    status = fpga_read_adc_channel(FPGA_ADC_CH0, &data->ch0);
-    if (status != HAL_OK) return status;
+    return frame_transfer(tx, data);
+}
 
-    status = fpga_read_adc_channel(FPGA_ADC_CH1, &data->ch1);
-    if (status != HAL_OK) return status;
+HAL_StatusTypeDef fpga_set_trip_limits(fpga_adc_channel_t channel,
+                                       uint16_t lo_code, uint16_t hi_code)
+{
+    if (channel > FPGA_ADC_CH3) {
+        return HAL_ERROR;
+    }
 
-    status = fpga_read_adc_channel(FPGA_ADC_CH2, &data->ch2);
-    if (status != HAL_OK) return status;
+    uint8_t tx[FPGA_CMD_SIZE];
+    uint8_t readback[4];
+    fpga_adc_data_t data;
 
-    status = fpga_read_adc_channel(FPGA_ADC_CH3, &data->ch3);
-    if (status != HAL_OK) return status;
+    build_command(tx, FPGA_CMD_LIMIT, (uint8_t)channel, hi_code, lo_code);
+
+    // The frame itself may be corrupt while the command got through;
+    // the readback decides
+    (void)frame_transfer(tx, &data);
+
+    if (fpga_read_burst(FPGA_REG_LIMITS + 4 * channel, readback, 4) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    if ((((uint16_t)readback[0] << 8) | readback[1]) != hi_code ||
+        (((uint16_t)readback[2] << 8) | readback[3]) != lo_code) {
+        return HAL_ERROR;
+    }
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef fpga_read_fault(uint8_t *fault_hi, uint8_t *fault_lo)
+{
+    if (fault_hi == NULL || fault_lo == NULL) {
+        return HAL_ERROR;
+    }
+
+    uint8_t fault[2];
+
+    if (fpga_read_burst(FPGA_REG_FAULT_HI, fault, 2) != HAL_OK) {
+        return HAL_ERROR;
+    }
+
+    *fault_hi = fault[0] & 0x0F;
+    *fault_lo = fault[1] & 0x0F;
 
     return HAL_OK;
 }
@@ -195,6 +393,72 @@ void fpga_convert_to_physical(const fpga_adc_data_t *raw_data,
     sensor_values->ac_current_a = (vout_adc_ch3 - ACS724_ZERO_CURRENT_V) / ACS724_SENSITIVITY;
 }
 
+uint16_t fpga_physical_to_code(fpga_adc_channel_t channel, float value)
+{
+    float vout;
+
+    if (channel == FPGA_ADC_CH3) {
+        // ACS724: 200mV/A, 2.5V @ 0A
+        vout = ACS724_ZERO_CURRENT_V + value * ACS724_SENSITIVITY;
+    } else {
+        // AMC1301 behind the divider
+        vout = value / VOLTAGE_DIVIDER_RATIO * AMC1301_GAIN;
+    }
+
+    float code = vout / ADC_VREF * ADC_FULL_SCALE + 0.5f;
+    if (code < 0.0f) return 0;
+    if (code > ADC_FULL_SCALE) return (uint16_t)ADC_FULL_SCALE;
+    return (uint16_t)code;
+}
+
+void fpga_dc_feedforward_update(fpga_dc_feedforward_t *ff,
+                                const fpga_adc_data_t *raw_data)
+{
+    if (ff == NULL || raw_data == NULL) {
+        return;
+    }
+
+    int32_t code[2] = { raw_data->ch0, raw_data->ch1 };
+
+    for (int i = 0; i < 2; i++) {
+        if (code[i] < DC_MIN_CODE) code[i] = DC_NOMINAL_CODE;   // Not a plausible bus
+
+        // Bus ratio by multiply, gain by the one division
+        ff->bus_q14[i] = (int32_t)(((int64_t)code[i] * DC_BUS_SCALE_Q30) >> 16);
+        ff->gain_q14[i] = (DC_NOMINAL_CODE << 14) / code[i];
+    }
+}
+
+static int16_t q14_index(int32_t level_q14, int32_t gain_q14)
+{
+    int32_t m = (int32_t)(((int64_t)level_q14 * gain_q14) >> 14);
+    if (m > FPGA_Q14_ONE) m = FPGA_Q14_ONE;
+    if (m < -FPGA_Q14_ONE) m = -FPGA_Q14_ONE;
+    return (int16_t)m;
+}
+
+void fpga_dc_feedforward_split(const fpga_dc_feedforward_t *ff, int32_t level_q14,
+                               int16_t m_q14[2])
+{
+    if (ff == NULL || m_q14 == NULL) {
+        return;
+    }
+
+    // Half the level per bridge; what one bus cannot supply of its half
+    // moves to the other
+    int32_t half = level_q14 / 2;
+    int32_t excess[2];
+
+    for (int i = 0; i < 2; i++) {
+        excess[i] = 0;
+        if (half > ff->bus_q14[i]) excess[i] = half - ff->bus_q14[i];
+        if (half < -ff->bus_q14[i]) excess[i] = half + ff->bus_q14[i];
+    }
+
+    m_q14[0] = q14_index(half - excess[0] + excess[1], ff->gain_q14[0]);
+    m_q14[1] = q14_index(half - excess[1] + excess[0], ff->gain_q14[1]);
+}
+
 bool fpga_is_data_ready(void)
 {
     uint8_t status = fpga_read_status();
@@ -203,7 +467,7 @@ bool fpga_is_data_ready(void)
 
 uint32_t fpga_read_sample_count(void)
 {
-    uint8_t count_low = 0;
-    fpga_read_register(FPGA_REG_SAMPLE_CNT, &count_low);
-    return (uint32_t)count_low;  // Only low byte available via SPI
+    uint8_t count[4] = {0};
+    fpga_read_burst(FPGA_REG_SAMPLE_CNT, count, 4);
+    return le32(count);
 }
@@ -3,14 +3,16 @@
  * @brief STM32F401RE + FPGA Hybrid System - Main Application
  *
  * This application demonstrates the STM32+FPGA hybrid architecture:
- * - STM32F401RE: Main control algorithm, PWM generation
- * - FPGA: High-speed sensing with Sigma-Delta ADC
+ * - STM32F401RE: Main control algorithm
+ * - FPGA: High-speed sensing with Sigma-Delta ADC, PWM generation
  *
  * System Overview:
  * 1. FPGA continuously samples analog sensors via Sigma-Delta ADC
- * 2. STM32 reads ADC data from FPGA via SPI (10 kHz rate)
+ * 2. STM32 exchanges one SPI frame per control period (10 kHz): ADC data
+ *    in, per-bridge modulation indices out
  * 3. STM32 runs control algorithm (PR + PI control)
- * 4. STM32 generates PWM outputs for H-bridge control
+ * 4. FPGA applies the indices at the next carrier peak and drives the
+ *    gates with dead time
  *
  * @author 5-Level Inverter Project
  * @date 2025-12-02
@@ -18,6 +20,7 @@
 
 #include "main.h"
 #include "fpga_interface.h"
+#include <math.h>
 #include <stdio.h>
 
 //==========================================================================
@@ -26,7 +29,18 @@
 
 SPI_HandleTypeDef hspi1;
 UART_HandleTypeDef huart2;
-TIM_HandleTypeDef htim1;
+
+// Gates switch only while set (off at power-up for safety)
+volatile bool g_pwm_run = false;
+
+// Protection limits (FPGA fast trip and software checks)
+#define DC_BUS_TRIP_V       60.0f
+#define AC_CURRENT_TRIP_A   15.0f
+
+// Open-loop output reference until the PR/PI loops are in
+#define CONTROL_FREQ_HZ     10000.0f
+#define OUTPUT_FREQ_HZ      50.0f
+#define OPEN_LOOP_MI        0.8f        // Peak output / (2 x nominal bus)
 
 //==========================================================================
 // Function Prototypes
@@ -36,7 +50,6 @@ void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
 static void MX_SPI1_Init(void);
 static void MX_USART2_UART_Init(void);
-static void MX_TIM1_Init(void);
 
 void control_loop(void);
 void debug_print_sensors(fpga_sensor_values_t *sensors);
@@ -57,7 +70,6 @@ int main(void)
     MX_GPIO_Init();
     MX_SPI1_Init();
     MX_USART2_UART_Init();
-    MX_TIM1_Init();
 
     // Initialize FPGA interface
     if (fpga_init(&hspi1) != HAL_OK) {
@@ -77,8 +89,21 @@ int main(void)
     uint8_t status = fpga_read_status();
     printf("FPGA Status: 0x%02X\r\n", status);
 
-    // Start PWM generation (disabled by default for safety)
-    // HAL_TIM_PWM_Start(&htim1, TIM_CHANNEL_1);
+    // Hardware fast trip: the FPGA kills the gates on these limits by
+    // itself, the checks in control_loop() stay as a second layer
+    uint16_t bus_ov = fpga_physical_to_code(FPGA_ADC_CH0, DC_BUS_TRIP_V);
+    if (fpga_set_trip_limits(FPGA_ADC_CH0, 0x0000, bus_ov) != HAL_OK ||
+        fpga_set_trip_limits(FPGA_ADC_CH1, 0x0000, bus_ov) != HAL_OK ||
+        fpga_set_trip_limits(FPGA_ADC_CH3,
+                             fpga_physical_to_code(FPGA_ADC_CH3, -AC_CURRENT_TRIP_A),
+                             fpga_physical_to_code(FPGA_ADC_CH3, AC_CURRENT_TRIP_A)) != HAL_OK) {
+        printf("FPGA trip limits not confirmed\r\n");
+        Error_Handler();
+    }
+
+    // PWM runs in the FPGA: gates start switching once g_pwm_run is set
+    // and control_loop() sends enabled commands. Without a command for a
+    // few carrier periods the FPGA stops them on its own.
 
     // Main control loop
     uint32_t loop_count = 0;
@@ -116,17 +141,38 @@ void control_loop(void)
 {
     static fpga_adc_data_t adc_data;
     static fpga_sensor_values_t sensor_values;
-
-    // Read sensor data from FPGA
-    if (fpga_read_all_adc(&adc_data) == HAL_OK) {
+    static fpga_dc_feedforward_t dc_ff = {
+        { FPGA_Q14_ONE, FPGA_Q14_ONE }, { FPGA_Q14_ONE, FPGA_Q14_ONE }
+    };
+    static int32_t level_ref_q14 = 0;   // Output level, set by the control algorithm
+    static float theta = 0.0f;          // Open-loop reference phase (rad)
+    static fpga_pwm_cmd_t pwm_cmd = { { 0, 0 }, false, false };
+    static uint32_t bad_frames = 0;     // Consecutive frames failing their checks
+
+    // Send last period's duties, read this period's sensor data
+    pwm_cmd.enable = pwm_cmd.enable && g_pwm_run;
+    if (fpga_exchange_frame(&pwm_cmd, &adc_data) == HAL_OK) {
         // Convert to physical values
         fpga_convert_to_physical(&adc_data, &sensor_values);
 
+        // DC-link feed-forward: per-bridge reciprocals from the raw bus
+        // codes, once per sample
+        fpga_dc_feedforward_update(&dc_ff, &adc_data);
+
         // TODO: Implement control algorithm
         // 1. PR (Proportional-Resonant) current control
         // 2. PI (Proportional-Integral) voltage control
-        // 3. PWM duty cycle calculation
-        // 4. Update PWM outputs
+        // Until then the output level is an open-loop sine
+        level_ref_q14 = (int32_t)(2.0f * OPEN_LOOP_MI * FPGA_Q14_ONE * sinf(theta));
+        theta += 2.0f * 3.14159265f * OUTPUT_FREQ_HZ / CONTROL_FREQ_HZ;
+        if (theta >= 2.0f * 3.14159265f) theta -= 2.0f * 3.14159265f;
+
+        // 3. PWM duty cycle calculation: level_ref_q14 in nominal bus
+        //    voltages, half per bridge (phase-shifted carriers in the
+        //    FPGA), scaled on the measured buses
+        fpga_dc_feedforward_split(&dc_ff, level_ref_q14, pwm_cmd.m_q14);
+        // 4. PWM update: pwm_cmd goes out with the next frame
+        pwm_cmd.enable = g_pwm_run;
 
         // Example: Read current and voltage
         float ac_current = sensor_values.ac_current_a;
@@ -140,16 +186,30 @@ void control_loop(void)
         (void)dc_bus1;
         (void)dc_bus2;
 
-        // Safety checks
-        if (dc_bus1 > 60.0f || dc_bus2 > 60.0f) {
+        // Safety checks: stop the gates now rather than next period.
+        // The FPGA fast trip has already forced them off if it fired.
+        bool fault = (adc_data.pwm_flags & FPGA_PWM_TRIPPED) != 0;
+
+        if (dc_bus1 > DC_BUS_TRIP_V || dc_bus2 > DC_BUS_TRIP_V) {
             // Overvoltage protection
-            // TODO: Disable PWM
+            fault = true;
         }
 
-        if (ac_current > 15.0f || ac_current < -15.0f) {
+        if (ac_current > AC_CURRENT_TRIP_A || ac_current < -AC_CURRENT_TRIP_A) {
             // Overcurrent protection
-            // TODO: Disable PWM
+            fault = true;
         }
+
+        if (fault) {
+            g_pwm_run = false;
+            pwm_cmd.enable = false;
+            fpga_exchange_frame(&pwm_cmd, &adc_data);
+        }
+
+        bad_frames = 0;
+    } else if (++bad_frames >= 3) {
+        // Blind to the plant: stop rather than repeat stale duties
+        pwm_cmd.enable = false;
     }
 }
 
@@ -218,7 +278,7 @@ static void MX_SPI1_Init(void)
     hspi1.Init.CLKPolarity = SPI_POLARITY_LOW;      // CPOL = 0
     hspi1.Init.CLKPhase = SPI_PHASE_1EDGE;          // CPHA = 0
     hspi1.Init.NSS = SPI_NSS_SOFT;
-    hspi1.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_8;  // 84MHz/8 = 10.5 MHz
+    hspi1.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_16; // 84MHz/16 = 5.25 MHz (FPGA slave limit, see ARCHITECTURE.md)
     hspi1.Init.FirstBit = SPI_FIRSTBIT_MSB;
     hspi1.Init.TIMode = SPI_TIMODE_DISABLE;
     hspi1.Init.CRCCalculation = SPI_CRCCALCULATION_DISABLE;
@@ -245,22 +305,6 @@ static void MX_USART2_UART_Init(void)
     }
 }
 
-static void MX_TIM1_Init(void)
-{
-    // TIM1 for PWM generation (to be implemented)
-    // This is a placeholder - full PWM configuration needed
-    htim1.Instance = TIM1;
-    htim1.Init.Prescaler = 0;
-    htim1.Init.CounterMode = TIM_COUNTERMODE_UP;
-    htim1.Init.Period = 8400 - 1;  // 10 kHz PWM @ 84 MHz
-    htim1.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
-    htim1.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
-
-    if (HAL_TIM_PWM_Init(&htim1) != HAL_OK) {
-        Error_Handler();
-    }
-}
-
 static void MX_GPIO_Init(void)
 {
     // Enable GPIO clocks
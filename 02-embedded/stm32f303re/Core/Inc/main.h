@@ -10,7 +10,7 @@
 extern "C" {
 #endif
 
-#include "stm32f3xx_hal.h"
+#include "board_config.h"
 
 void Error_Handler(void);
 
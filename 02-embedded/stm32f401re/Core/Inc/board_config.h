@@ -0,0 +1,38 @@
+/**
+ * @file board_config.h
+ * @brief Board configuration: NUCLEO-F401RE
+ *
+ * Everything the shared control library (02-embedded/common) needs to
+ * know about the board: HAL, clocks, ADC channel assignment and sensor
+ * scaling. Timing derived from it (PWM period, dead time, PR and sine
+ * tables) is computed at compile time in inverter_config.h.
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+#ifndef BOARD_CONFIG_H
+#define BOARD_CONFIG_H
+
+#include "stm32f4xx_hal.h"
+
+#define BOARD_NAME              "STM32F401RE"
+
+/* Clocks */
+#define SYSTEM_CLOCK_HZ         84000000  // HSI PLL, SystemClock_Config()
+#define PWM_TIMER_CLOCK_HZ      84000000  // TIM1/TIM8 on APB2 (/1)
+
+/* ADC: 12-bit, 3.3 V reference, 4-channel scan in this rank order */
+#define ADC_RESOLUTION          4096
+#define ADC_VREF                3.3f
+#define BOARD_ADC_CH_CURRENT    ADC_CHANNEL_0   // PA0, rank 1
+#define BOARD_ADC_CH_VOLTAGE    ADC_CHANNEL_1   // PA1, rank 2
+#define BOARD_ADC_CH_DC_BUS1    ADC_CHANNEL_4   // PA4, rank 3
+#define BOARD_ADC_CH_DC_BUS2    ADC_CHANNEL_5   // PA5, rank 4
+
+/* Sensor scaling (volts at the ADC pin to physical units) */
+#define CURRENT_SCALE           10.0f    // A/V (hall sensor: 0.1V/A → 10A/V)
+#define VOLTAGE_SCALE           50.0f    // V/V (voltage divider: 1:50)
+#define DC_BUS_SCALE            25.0f    // V/V (voltage divider: 1:25)
+
+#endif // BOARD_CONFIG_H
@@ -0,0 +1,102 @@
+/**
+ * @file plant_sim.c
+ * @brief Shared plant model for the host tests
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+#include "plant_sim.h"
+#include <math.h>
+#include <string.h>
+
+/*---------------------------------------------------------------------------
+ * Bridge timers
+ *-------------------------------------------------------------------------*/
+
+void plant_bridges_init(plant_bridges_t *b, uint32_t shift)
+{
+    memset(b, 0, sizeof(*b));
+    b->shift = shift;
+}
+
+/* TIM1 update event: H-bridge 1 compares take the preloaded duties */
+void plant_bridges_tim1_update(plant_bridges_t *b, const inverter_duty_t *pending)
+{
+    b->ccr[0] = pending->hbridge1.ch1;
+    b->ccr[1] = pending->hbridge1.ch2;
+}
+
+/* Step s of the TIM1 period; TIM8 updates when its own counter wraps */
+void plant_bridges_step(plant_bridges_t *b, int s, const inverter_duty_t *pending)
+{
+    uint32_t cnt1 = (uint32_t)s * STEP;
+    uint32_t cnt8 = (cnt1 + b->shift) % PERIOD_COUNTS;
+
+    if (cnt8 < STEP) {
+        b->ccr[2] = pending->hbridge2.ch1;
+        b->ccr[3] = pending->hbridge2.ch2;
+    }
+    b->cnt[0] = b->cnt[1] = cnt1;
+    b->cnt[2] = b->cnt[3] = cnt8;
+}
+
+/*---------------------------------------------------------------------------
+ * RL load
+ *-------------------------------------------------------------------------*/
+
+void plant_rl_init(plant_rl_t *rl, double r, double l, double dt)
+{
+    rl->a = exp(-r * dt / l);
+    rl->b = (1.0 - rl->a) / r;
+    rl->i = 0.0;
+}
+
+/*---------------------------------------------------------------------------
+ * Harmonic analysis
+ *-------------------------------------------------------------------------*/
+
+void plant_dft_init(plant_dft_t *d, double bin_hz, int kmax, double t_sample)
+{
+    memset(d, 0, sizeof(*d));
+    d->w = 2.0 * M_PI * bin_hz * t_sample;
+    d->kmax = (kmax > PLANT_DFT_MAX) ? PLANT_DFT_MAX : kmax;
+}
+
+void plant_dft_add(plant_dft_t *d, double i, double v)
+{
+    // Base phasor exact per sample, harmonics by rotation
+    double th = d->w * (double)d->n;
+    double c1 = cos(th), s1 = sin(th);
+    double c = 1.0, sn = 0.0;
+
+    for (int k = 1; k <= d->kmax; k++) {
+        double ck = c * c1 - sn * s1;
+        sn = sn * c1 + c * s1;
+        c = ck;
+        d->re[PLANT_DFT_I][k] += i * c;
+        d->im[PLANT_DFT_I][k] += i * sn;
+        d->re[PLANT_DFT_V][k] += v * c;
+        d->im[PLANT_DFT_V][k] += v * sn;
+    }
+    d->n++;
+}
+
+/* Peak amplitude of bin k over the accumulated window */
+double plant_dft_peak(const plant_dft_t *d, int ch, int k)
+{
+    double re = d->re[ch][k], im = d->im[ch][k];
+    return 2.0 * sqrt(re * re + im * im) / (double)d->n;
+}
+
+/*---------------------------------------------------------------------------
+ * Sensor noise
+ *-------------------------------------------------------------------------*/
+
+static unsigned long lcg = 12345;
+
+double plant_noise(void)
+{
+    lcg = lcg * 1103515245ul + 12345ul;
+    return (((lcg >> 16) & 0x7FFF) / 32767.0 - 0.5) * 0.04;
+}
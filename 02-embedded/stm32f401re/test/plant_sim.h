@@ -0,0 +1,100 @@
+/**
+ * @file plant_sim.h
+ * @brief Shared plant model for the host tests
+ *
+ * The pieces every plant-level test needs, in one place so they cannot
+ * drift apart:
+ * - Bridge timers at timer-count resolution: TIM1 and TIM8 compares are
+ *   preloaded and take the pending duties at their own update event,
+ *   TIM8 counting cnt8 = (cnt1 + shift) % PERIOD_COUNTS
+ * - Exact RL step for a voltage held over one step, a = exp(-R*T/L)
+ * - Rotating-phasor DFT accumulator (bins at multiples of a base
+ *   frequency, current and voltage)
+ * - Sensor noise (LCG, +-20 mA) and the common load and step constants
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+#ifndef PLANT_SIM_H
+#define PLANT_SIM_H
+
+#include "multilevel_modulation.h"
+#include <stdint.h>
+
+/* Common load and supply */
+#define VDC             50.0                    // Per H-bridge (V)
+#define F1              50.0                    // Output frequency (Hz)
+#define R_LOAD          20.0
+#define L_LOAD          0.010
+
+/* Plant time step */
+#define STEP            4                       // Plant step in timer counts
+#define PERIOD_COUNTS   (PWM_PERIOD + 1)
+#define STEPS           (PERIOD_COUNTS / STEP)
+#define T_STEP          ((double)STEP / SYSTEM_CLOCK_HZ)
+
+#define PLANT_DFT_MAX   200                     // Highest bin
+#define PLANT_DFT_I     0                       // Current channel
+#define PLANT_DFT_V     1                       // Voltage channel
+
+/**
+ * @brief TIM1 / TIM8 compares and counters, legs A1, B1, A2, B2
+ */
+typedef struct {
+    uint32_t shift;             // TIM8 counter offset (modulation_carrier_shift)
+    uint16_t ccr[4];            // Active compares
+    uint32_t cnt[4];            // Counter seen by each leg this step
+} plant_bridges_t;
+
+/**
+ * @brief Exact RL step for a constant voltage over dt
+ */
+typedef struct {
+    double a;                   // exp(-R*dt/L)
+    double b;                   // (1 - a) / R
+    double i;                   // Current (A)
+} plant_rl_t;
+
+/**
+ * @brief Rotating-phasor DFT, bins k * bin_hz for k = 1..kmax
+ */
+typedef struct {
+    double w;                   // Base bin phase per sample (rad)
+    int kmax;
+    long n;                     // Samples accumulated
+    double re[2][PLANT_DFT_MAX + 1];
+    double im[2][PLANT_DFT_MAX + 1];
+} plant_dft_t;
+
+/* Bridge timers */
+void plant_bridges_init(plant_bridges_t *b, uint32_t shift);
+void plant_bridges_tim1_update(plant_bridges_t *b, const inverter_duty_t *pending);
+void plant_bridges_step(plant_bridges_t *b, int s, const inverter_duty_t *pending);
+
+/**
+ * @brief OCxREF of leg k this step (1 = high side on)
+ */
+static inline int plant_bridges_gate(const plant_bridges_t *b, int k)
+{
+    return b->cnt[k] < b->ccr[k];
+}
+
+/* RL load */
+void plant_rl_init(plant_rl_t *rl, double r, double l, double dt);
+
+static inline double plant_rl_step(plant_rl_t *rl, double v)
+{
+    rl->i = rl->a * rl->i + rl->b * v;
+    return rl->i;
+}
+
+/* Harmonic analysis */
+void plant_dft_init(plant_dft_t *d, double bin_hz, int kmax, double t_sample);
+void plant_dft_add(plant_dft_t *d, double i, double v);
+double plant_dft_peak(const plant_dft_t *d, int ch, int k);
+
+/* Current sensor noise, +-20 mA */
+double plant_noise(void);
+
+#endif // PLANT_SIM_H
@@ -0,0 +1,69 @@
+/**
+ * @file stm32f4xx_hal.h
+ * @brief Minimal HAL stand-in for host unit tests
+ *
+ * Provides only the types and calls the tested modules use. The test
+ * program implements the functions (fake DMA, call recording).
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-20
+ */
+
+#ifndef STM32F4XX_HAL_STUB_H
+#define STM32F4XX_HAL_STUB_H
+
+#include <stdint.h>
+
+typedef enum {
+    HAL_OK       = 0x00U,
+    HAL_ERROR    = 0x01U,
+    HAL_BUSY     = 0x02U,
+    HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+typedef struct {
+    void *Instance;
+} DMA_HandleTypeDef;
+
+typedef struct {
+    void *Instance;
+    DMA_HandleTypeDef *DMA_Handle;
+} ADC_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length);
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc);
+
+/* SPI and GPIO (FPGA link driver of the hybrid board) */
+typedef struct {
+    void *Instance;
+} SPI_HandleTypeDef;
+
+typedef struct {
+    uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef struct {
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+} GPIO_InitTypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+extern GPIO_TypeDef *const GPIOA;
+
+#define GPIO_PIN_4              0x0010U
+#define GPIO_MODE_OUTPUT_PP     0x01U
+#define GPIO_NOPULL             0x00U
+#define GPIO_SPEED_FREQ_HIGH    0x02U
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData,
+                                          uint8_t *pRxData, uint16_t Size, uint32_t Timeout);
+
+#endif // STM32F4XX_HAL_STUB_H
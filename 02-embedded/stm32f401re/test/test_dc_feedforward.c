@@ -0,0 +1,307 @@
+/**
+ * @file test_dc_feedforward.c
+ * @brief Host tests and plant simulation for the DC-link feed-forward
+ *
+ * - Nominal buses leave the duties unchanged (bit-exact), readings below
+ *   MODULATION_VDC_MIN_RATIO and invalid ones count as nominal, NLC keeps
+ *   its full on/off steps
+ * - Duty-level check: bridge volts m * Vdc_i add up to the reference in
+ *   LS (inner band ends at the inner bridge's bus) and PS (equal share)
+ * - Plant: both H-bridges at timer-count resolution into an RL load
+ *   (R = 20 ohm, L = 10 mH) with the duties of the real modulator, LS
+ *   (band rotation on) and PS, at MI 0.8:
+ *     equal 2 x 50 V buses (reference)
+ *     50 V / 40 V, not normalized and normalized
+ *     50 V / 40 V with 10% 100 Hz ripple on the low bus, both ways
+ *   The analysis window is two output cycles (one rotation period) with
+ *   25 Hz bins, so the cycle-to-cycle asymmetry of the rotating LS bands
+ *   shows as 25/75 Hz subharmonics. Reported: fundamental, low-order
+ *   voltage and current THD (all bins up to 2 kHz but the fundamental).
+ *   PS spreads a static bus error evenly over the cycle (fundamental
+ *   only); LS and bus ripple turn it into distortion
+ *
+ * Plant model: plant_sim.c
+ *
+ * Build/run: make test
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+#include "multilevel_modulation.h"
+#include "plant_sim.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define VNOM            ((double)MODULATION_VDC_NOMINAL)
+#define MI              0.8f
+#define SETTLE_PERIODS  300                     // 3 output cycles
+#define MEAS_PERIODS    200                     // 2 output cycles, one rotation period
+#define BIN_HZ          25.0                    // Frequency resolution of the window
+#define K_FUND          2                       // Fundamental bin (50 Hz)
+#define K_MAX           80                      // Up to 2 kHz, below the carrier
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (cond) {                                         \
+            printf("[PASS] " __VA_ARGS__);                  \
+        } else {                                            \
+            printf("[FAIL] " __VA_ARGS__);                  \
+            failures++;                                     \
+        }                                                   \
+        printf("\n");                                       \
+    } while (0)
+
+/*---------------------------------------------------------------------------
+ * Plant simulation
+ *-------------------------------------------------------------------------*/
+
+typedef struct {
+    double v1, v2;          // Bus voltages (V)
+    double ripple;          // Bus 2 ripple amplitude at 2 * F1 (V peak)
+    int feedforward;        // Measured buses passed to the modulator
+} bus_case_t;
+
+typedef struct {
+    double v1;              // Fundamental output voltage, peak (V)
+    double v_thd;           // Voltage distortion, all bins <= K_MAX
+    double i_thd;           // Current distortion, all bins <= K_MAX
+    double v_sub;           // Largest subharmonic (25 / 75 Hz), relative
+} sim_result_t;
+
+static double bus2_at(const bus_case_t *bc, double t)
+{
+    return bc->v2 + bc->ripple * sin(2.0 * M_PI * 2.0 * F1 * t);
+}
+
+static sim_result_t simulate(modulation_mode_t mode, const bus_case_t *bc)
+{
+    modulation_t mod;
+    inverter_duty_t pending;
+    plant_bridges_t br;
+    plant_rl_t rl;
+    plant_dft_t dft;
+
+    modulation_init(&mod);
+    modulation_set_index(&mod, MI);
+    modulation_set_frequency(&mod, (float)F1);
+    modulation_set_mode(&mod, mode);
+    modulation_set_rotation(&mod, true);
+    mod.enabled = true;
+    memset(&pending, 0, sizeof(pending));
+
+    plant_bridges_init(&br, modulation_carrier_shift(&mod));
+    plant_rl_init(&rl, R_LOAD, L_LOAD, T_STEP);
+    plant_dft_init(&dft, BIN_HZ, K_MAX, T_STEP);
+
+    long step = 0;
+
+    for (int p = 0; p < SETTLE_PERIODS + MEAS_PERIODS; p++) {
+        // TIM1 update: preloaded duties take effect, ISR computes the next
+        // from the bus measured (averaged) over the period just ended
+        plant_bridges_tim1_update(&br, &pending);
+        if (bc->feedforward) {
+            double t_mid = (step - STEPS / 2) * T_STEP;
+            modulation_set_dc_bus(&mod, (float)bc->v1, (float)bus2_at(bc, t_mid));
+        }
+        modulation_calculate_duties(&mod, &pending);
+        modulation_update(&mod);
+
+        for (int s = 0; s < STEPS; s++, step++) {
+            plant_bridges_step(&br, s, &pending);
+
+            double t = step * T_STEP;
+            double v = bc->v1 * (plant_bridges_gate(&br, 0) - plant_bridges_gate(&br, 1)) +
+                       bus2_at(bc, t) * (plant_bridges_gate(&br, 2) - plant_bridges_gate(&br, 3));
+            double i = plant_rl_step(&rl, v);
+
+            if (p >= SETTLE_PERIODS) {
+                plant_dft_add(&dft, i, v);
+            }
+        }
+    }
+
+    sim_result_t r;
+    double vk[K_MAX + 1], isum = 0.0, vsum = 0.0;
+    for (int k = 1; k <= K_MAX; k++) {
+        vk[k] = plant_dft_peak(&dft, PLANT_DFT_V, k);
+        if (k != K_FUND) {
+            double ik = plant_dft_peak(&dft, PLANT_DFT_I, k);
+            isum += ik * ik;
+            vsum += vk[k] * vk[k];
+        }
+    }
+    r.v1 = vk[K_FUND];
+    r.v_thd = sqrt(vsum) / vk[K_FUND];
+    r.i_thd = sqrt(isum) / plant_dft_peak(&dft, PLANT_DFT_I, K_FUND);
+    r.v_sub = fmax(vk[1], vk[3]) / vk[K_FUND];
+    return r;
+}
+
+/*---------------------------------------------------------------------------
+ * Tests
+ *-------------------------------------------------------------------------*/
+
+static int same_duties(const inverter_duty_t *x, const inverter_duty_t *y)
+{
+    return memcmp(x, y, sizeof(inverter_duty_t)) == 0;
+}
+
+/**
+ * @brief Average output of one period's duties in volts
+ */
+static double duty_volts(const inverter_duty_t *d, double vdc1, double vdc2)
+{
+    double m1 = ((double)d->hbridge1.ch1 - (double)d->hbridge1.ch2) / PERIOD_COUNTS;
+    double m2 = ((double)d->hbridge2.ch1 - (double)d->hbridge2.ch2) / PERIOD_COUNTS;
+    return m1 * vdc1 + m2 * vdc2;
+}
+
+int main(void)
+{
+    modulation_t ref, mod;
+    inverter_duty_t dr, dm;
+
+    printf("\n========================================\n");
+    printf("DC-Link Feed-Forward Test (nominal %.0f V per bridge)\n", VNOM);
+    printf("========================================\n");
+
+    /* Nominal buses: unchanged duties */
+    int same = 1;
+    for (int m = 0; m < 2; m++) {
+        modulation_init(&ref);
+        modulation_init(&mod);
+        modulation_set_mode(&ref, m ? MODULATION_MODE_PS : MODULATION_MODE_LS);
+        modulation_set_mode(&mod, m ? MODULATION_MODE_PS : MODULATION_MODE_LS);
+        ref.enabled = mod.enabled = true;
+        for (int k = 0; k < 300; k++) {
+            modulation_set_dc_bus(&mod, MODULATION_VDC_NOMINAL, MODULATION_VDC_NOMINAL);
+            modulation_calculate_duties(&ref, &dr);
+            modulation_calculate_duties(&mod, &dm);
+            same &= same_duties(&dr, &dm);
+            modulation_calculate_duties_ref(&ref, 0.9f * sinf(0.05f * k), &dr);
+            modulation_calculate_duties_ref(&mod, 0.9f * sinf(0.05f * k), &dm);
+            same &= same_duties(&dr, &dm);
+            modulation_update(&ref);
+            modulation_update(&mod);
+        }
+    }
+    CHECK(same, "nominal buses: LS/PS duties bit-exact with and without feed-forward");
+
+    /* Reading limits */
+    modulation_init(&mod);
+    modulation_set_dc_bus(&mod, 0.0f, NAN);
+    CHECK(mod.gain[0] == 1.0f && mod.gain[1] == 1.0f && mod.bus[0] == 1.0f && mod.bus[1] == 1.0f,
+          "zero / NaN bus reading treated as nominal (gain %.2f)", mod.gain[0]);
+    modulation_set_dc_bus(&mod, 24.0f, 25.0f);
+    CHECK(mod.gain[0] == 1.0f && fabsf(mod.gain[1] - 1.0f / MODULATION_VDC_MIN_RATIO) < 1e-6f,
+          "24 V reading nominal, 25 V (minimum ratio) gain %.2f", mod.gain[1]);
+    modulation_set_dc_bus(&mod, 40.0f, 62.5f);
+    CHECK(fabsf(mod.gain[0] - 1.25f) < 1e-6f && fabsf(mod.bus[1] - 1.25f) < 1e-6f,
+          "40 V / 62.5 V: gains %.3f / %.3f", mod.gain[0], mod.gain[1]);
+
+    /* Volts per period add up to the reference */
+    const double vb1 = 50.0, vb2 = 40.0;
+    double worst[2] = {0.0, 0.0};
+    for (int m = 0; m < 2; m++) {
+        modulation_init(&mod);
+        modulation_set_mode(&mod, m ? MODULATION_MODE_PS : MODULATION_MODE_LS);
+        mod.enabled = true;
+        modulation_set_dc_bus(&mod, (float)vb1, (float)vb2);
+        for (int k = 0; k <= 200; k++) {
+            float r = -0.88f + 0.0088f * k;      // |v| up to 88 V of 90 V
+            mod.swapped = (k & 1);
+            modulation_calculate_duties_ref(&mod, r, &dm);
+            double err = fabs(duty_volts(&dm, vb1, vb2) - 2.0 * VNOM * r);
+            if (err > worst[m]) worst[m] = err;
+        }
+    }
+    CHECK(worst[0] < 0.01 && worst[1] < 0.01,
+          "50 V / 40 V: period volts on reference (max error LS %.4f V, PS %.4f V)",
+          worst[0], worst[1]);
+
+    modulation_init(&mod);
+    modulation_set_shape(&mod, MODULATION_SHAPE_NLC, 0.0f);
+    modulation_init(&ref);
+    modulation_set_shape(&ref, MODULATION_SHAPE_NLC, 0.0f);
+    ref.enabled = mod.enabled = true;
+    same = 1;
+    for (int k = 0; k < 100; k++) {
+        modulation_set_dc_bus(&mod, 50.0f, 40.0f);
+        modulation_calculate_duties(&ref, &dr);
+        modulation_calculate_duties(&mod, &dm);
+        same &= same_duties(&dr, &dm);
+        modulation_update(&ref);
+        modulation_update(&mod);
+    }
+    CHECK(same, "NLC: staircase levels not normalized");
+
+    /* Plant */
+    static const struct {
+        const char *name;
+        bus_case_t bc;
+    } cases[] = {
+        { "2 x 50 V",        { 50.0, 50.0, 0.0, 0 } },
+        { "50/40 V",         { 50.0, 40.0, 0.0, 0 } },
+        { "50/40 V FF",      { 50.0, 40.0, 0.0, 1 } },
+        { "50/40 V rip",     { 50.0, 40.0, 4.0, 0 } },
+        { "50/40 V rip FF",  { 50.0, 40.0, 4.0, 1 } },
+    };
+    static const modulation_mode_t modes[] = { MODULATION_MODE_LS, MODULATION_MODE_PS };
+    const int n_cases = sizeof(cases) / sizeof(cases[0]);
+    sim_result_t res[2][5];
+
+    printf("\nRL load %.0f ohm / %.0f mH, MI %.1f, %d Hz carrier, distortion up to %.0f Hz\n\n",
+           R_LOAD, L_LOAD * 1e3, MI, PWM_FREQUENCY_HZ, K_MAX * BIN_HZ);
+    printf("%-3s %-15s | %6s | %6s %6s | %6s\n", "", "Buses", "V1 (V)", "V THD", "I THD", "Sub");
+
+    for (int m = 0; m < 2; m++) {
+        for (int c = 0; c < n_cases; c++) {
+            sim_result_t *r = &res[m][c];
+            *r = simulate(modes[m], &cases[c].bc);
+            printf("%-3s %-15s | %6.1f | %5.2f%% %5.2f%% | %5.2f%%\n", m ? "PS" : "LS",
+                   cases[c].name, r->v1, r->v_thd * 100.0, r->i_thd * 100.0, r->v_sub * 100.0);
+        }
+        printf("\n");
+    }
+
+    const double v1_ideal = 2.0 * VNOM * MI;
+    for (int m = 0; m < 2; m++) {
+        const char *name = m ? "PS" : "LS";
+        const sim_result_t *base = &res[m][0];
+        const sim_result_t *raw = &res[m][1], *ff = &res[m][2];
+        const sim_result_t *raw_rip = &res[m][3], *ff_rip = &res[m][4];
+
+        CHECK(fabs(raw->v1 - v1_ideal) > 0.05 * v1_ideal && fabs(ff->v1 - v1_ideal) < 0.01 * v1_ideal,
+              "%s 50/40 V: fundamental %.1f V normalized vs %.1f V (%.1f V expected)",
+              name, ff->v1, raw->v1, v1_ideal);
+        CHECK(fabs(ff_rip->v1 - v1_ideal) < 0.01 * v1_ideal,
+              "%s 50/40 V + ripple: fundamental %.1f V normalized", name, ff_rip->v1);
+        CHECK(ff_rip->i_thd < 0.5 * raw_rip->i_thd,
+              "%s 50/40 V + ripple: current THD %.2f%% normalized vs %.2f%%",
+              name, ff_rip->i_thd * 100.0, raw_rip->i_thd * 100.0);
+        CHECK(ff->i_thd < base->i_thd + 0.005 && ff_rip->i_thd < base->i_thd + 0.005,
+              "%s: normalized current THD within 0.5%% of equal buses (%.2f%%)",
+              name, base->i_thd * 100.0);
+    }
+    // PS shares each bridge over the whole cycle, so a static bus error
+    // only scales the fundamental; LS bands turn it into distortion
+    CHECK(res[0][2].i_thd < 0.5 * res[0][1].i_thd,
+          "LS 50/40 V: current THD %.2f%% normalized vs %.2f%%",
+          res[0][2].i_thd * 100.0, res[0][1].i_thd * 100.0);
+    CHECK(res[0][1].v_sub > 0.02 && res[0][2].v_sub < 0.2 * res[0][1].v_sub,
+          "LS rotation: 25/75 Hz subharmonic %.2f%% normalized vs %.2f%%",
+          res[0][2].v_sub * 100.0, res[0][1].v_sub * 100.0);
+
+    printf("\n========================================\n");
+    if (failures == 0) {
+        printf("*** ALL TESTS PASSED! ***\n");
+    } else {
+        printf("*** %d TEST(S) FAILED ***\n", failures);
+    }
+    printf("========================================\n");
+    return failures == 0 ? 0 : 1;
+}
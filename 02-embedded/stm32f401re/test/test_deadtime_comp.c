@@ -0,0 +1,299 @@
+/**
+ * @file test_deadtime_comp.c
+ * @brief Host tests and plant simulation for dead-time compensation
+ *
+ * - Correction sign, size and fade-out through the zero-crossing band
+ * - Idle (compare 0) and clamped (compare above ARR) legs untouched
+ * - Per-bridge dead time, limits and disable
+ * - Plant: both H-bridges at timer-count resolution with Td inserted on
+ *   every rising gate edge and the freewheeling diode setting the leg
+ *   voltage in between, into an RL load (2 x 50 V). Duties come from the
+ *   real modulator with the timer preload delay; the compensator sees the
+ *   previous period's mean current (oversampled ADC) with +-20 mA noise.
+ *   Low-order current and voltage THD without dead time, and with dead
+ *   time uncompensated / compensated / compensated with a hard sign, at
+ *   several load points
+ *
+ * Plant model: plant_sim.c
+ *
+ * Build/run: make test
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-24
+ */
+
+#include "deadtime_comp.h"
+#include "multilevel_modulation.h"
+#include "plant_sim.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define DT_COUNTS       84                      // TIM DTG, 1 us at 84 MHz
+#define SETTLE_PERIODS  300                     // 3 output cycles
+#define MEAS_PERIODS    200                     // THD over 2 output cycles
+#define H_LOW           40                      // Low-order harmonics 2..40
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (cond) {                                         \
+            printf("[PASS] " __VA_ARGS__);                  \
+        } else {                                            \
+            printf("[FAIL] " __VA_ARGS__);                  \
+            failures++;                                     \
+        }                                                   \
+        printf("\n");                                       \
+    } while (0)
+
+/*---------------------------------------------------------------------------
+ * Plant simulation
+ *-------------------------------------------------------------------------*/
+
+/* One inverter leg: dead time and diode on top of the timer's OCxREF */
+typedef struct {
+    int ref;                // OCxREF
+    int since;              // Counts since the last OCxREF edge
+} leg_t;
+
+/* Leg voltage (0..1) for this step; i_leg > 0 leaves the leg */
+static double leg_step(leg_t *leg, int ref, double i_leg, int dt)
+{
+    if (ref != leg->ref) {
+        leg->ref = ref;
+        leg->since = 0;
+    }
+
+    double v;
+    if (leg->since >= dt) {
+        v = ref ? 1.0 : 0.0;                    // Gate on (high or low side)
+    } else {
+        v = (i_leg > 0.0) ? 0.0 : ((i_leg < 0.0) ? 1.0 : 0.5);  // Diode
+    }
+    leg->since += STEP;
+    return v;
+}
+
+typedef struct {
+    double i_thd;           // Current THD, harmonics 2..H_LOW
+    double v_thd;           // Output voltage THD, harmonics 2..H_LOW
+    double v1;              // Fundamental output voltage, peak (V)
+    double i1;              // Fundamental current, peak (A)
+} sim_result_t;
+
+typedef struct {
+    const char *name;
+    float mi;
+    double r;
+    modulation_mode_t mode;
+    double max_ratio;       // Required THD reduction, on/off
+} load_point_t;
+
+static sim_result_t simulate(const load_point_t *lp, int plant_dt, bool compensate, float band)
+{
+    modulation_t mod;
+    deadtime_comp_t dtc;
+    inverter_duty_t pending;
+    plant_bridges_t br;
+    plant_rl_t rl;
+    plant_dft_t dft;
+    leg_t legs[4];                              // A1, B1, A2, B2
+
+    modulation_init(&mod);
+    mod.enabled = true;
+    modulation_set_index(&mod, lp->mi);
+    modulation_set_frequency(&mod, (float)F1);
+    modulation_set_mode(&mod, lp->mode);
+
+    deadtime_comp_init(&dtc, DT_COUNTS, DT_COUNTS, band);
+    deadtime_comp_enable(&dtc, compensate);
+
+    memset(legs, 0, sizeof(legs));
+    for (int k = 0; k < 4; k++) legs[k].since = DT_COUNTS;
+    memset(&pending, 0, sizeof(pending));
+
+    plant_bridges_init(&br, modulation_carrier_shift(&mod));
+    plant_rl_init(&rl, lp->r, L_LOAD, T_STEP);
+    plant_dft_init(&dft, F1, H_LOW, T_STEP);
+
+    double i_sum = 0.0, i_avg = 0.0;
+
+    for (int p = 0; p < SETTLE_PERIODS + MEAS_PERIODS; p++) {
+        // TIM1 update: preloaded duties take effect, ISR computes the next
+        plant_bridges_tim1_update(&br, &pending);
+        modulation_calculate_duties(&mod, &pending);
+        deadtime_comp_apply(&dtc, &pending, (float)(i_avg + plant_noise()));
+        modulation_update(&mod);
+
+        i_sum = 0.0;
+        for (int s = 0; s < STEPS; s++) {
+            plant_bridges_step(&br, s, &pending);
+
+            double i = rl.i;
+            double v1 = VDC * (leg_step(&legs[0], plant_bridges_gate(&br, 0), i, plant_dt) -
+                               leg_step(&legs[1], plant_bridges_gate(&br, 1), -i, plant_dt));
+            double v2 = VDC * (leg_step(&legs[2], plant_bridges_gate(&br, 2), i, plant_dt) -
+                               leg_step(&legs[3], plant_bridges_gate(&br, 3), -i, plant_dt));
+            double v = v1 + v2;
+
+            i = plant_rl_step(&rl, v);
+            i_sum += i;
+
+            if (p >= SETTLE_PERIODS) {
+                plant_dft_add(&dft, i, v);
+            }
+        }
+        i_avg = i_sum / STEPS;
+    }
+
+    sim_result_t r;
+    double isum = 0.0, vsum = 0.0;
+    for (int h = 2; h <= H_LOW; h++) {
+        double ih = plant_dft_peak(&dft, PLANT_DFT_I, h);
+        double vh = plant_dft_peak(&dft, PLANT_DFT_V, h);
+        isum += ih * ih;
+        vsum += vh * vh;
+    }
+    r.i1 = plant_dft_peak(&dft, PLANT_DFT_I, 1);
+    r.v1 = plant_dft_peak(&dft, PLANT_DFT_V, 1);
+    r.i_thd = sqrt(isum) / r.i1;
+    r.v_thd = sqrt(vsum) / r.v1;
+    return r;
+}
+
+/*---------------------------------------------------------------------------
+ * Tests
+ *-------------------------------------------------------------------------*/
+
+static inverter_duty_t duty(uint16_t a1, uint16_t b1, uint16_t a2, uint16_t b2)
+{
+    inverter_duty_t d;
+    d.hbridge1.ch1 = a1;
+    d.hbridge1.ch2 = b1;
+    d.hbridge2.ch1 = a2;
+    d.hbridge2.ch2 = b2;
+    return d;
+}
+
+int main(void)
+{
+    deadtime_comp_t dtc;
+    inverter_duty_t d;
+
+    printf("\n========================================\n");
+    printf("Dead-Time Compensation Test (Td = %d counts)\n", DT_COUNTS);
+    printf("========================================\n");
+
+    CHECK(deadtime_comp_init(NULL, DT_COUNTS, DT_COUNTS, 0.2f) != 0, "NULL rejected");
+    CHECK(deadtime_comp_init(&dtc, DT_COUNTS, DT_COUNTS, -1.0f) != 0, "negative band rejected");
+    CHECK(deadtime_comp_init(&dtc, PWM_PERIOD, DT_COUNTS, 0.2f) != 0,
+          "dead time above half a period rejected");
+
+    deadtime_comp_init(&dtc, DT_COUNTS, 42, 0.2f);
+    deadtime_comp_set_lead(&dtc, 0.0f);         // Polarity from the sample itself
+
+    d = duty(6000, 10800, 7000, 9800);
+    deadtime_comp_apply(&dtc, &d, 3.0f);
+    CHECK(d.hbridge1.ch1 == 6084 && d.hbridge1.ch2 == 10716 &&
+          d.hbridge2.ch1 == 7042 && d.hbridge2.ch2 == 9758,
+          "positive current: leg A +Td, leg B -Td, per-bridge Td (%u/%u, %u/%u)",
+          d.hbridge1.ch1, d.hbridge1.ch2, d.hbridge2.ch1, d.hbridge2.ch2);
+
+    d = duty(6000, 10800, 7000, 9800);
+    deadtime_comp_apply(&dtc, &d, -3.0f);
+    CHECK(d.hbridge1.ch1 == 5916 && d.hbridge1.ch2 == 10884,
+          "negative current: leg A -Td, leg B +Td");
+
+    d = duty(6000, 10800, 7000, 9800);
+    deadtime_comp_apply(&dtc, &d, 0.1f);
+    CHECK(d.hbridge1.ch1 == 6042 && d.hbridge1.ch2 == 10758,
+          "half band: half correction (%u)", d.hbridge1.ch1);
+
+    d = duty(6000, 10800, 7000, 9800);
+    deadtime_comp_apply(&dtc, &d, 0.0f);
+    CHECK(d.hbridge1.ch1 == 6000 && d.hbridge2.ch2 == 9800, "zero current: no correction");
+
+    d = duty(0, 0, PWM_PERIOD + 1, 0);
+    deadtime_comp_apply(&dtc, &d, 3.0f);
+    CHECK(d.hbridge1.ch1 == 0 && d.hbridge1.ch2 == 0 &&
+          d.hbridge2.ch1 == PWM_PERIOD + 1 && d.hbridge2.ch2 == 0,
+          "idle and clamped legs untouched");
+
+    d = duty(PWM_PERIOD - 10, 20, 1, 1);
+    deadtime_comp_apply(&dtc, &d, 3.0f);
+    CHECK(d.hbridge1.ch1 == PWM_PERIOD + 1 && d.hbridge1.ch2 == 0,
+          "corrections saturate at 0 and ARR + 1");
+
+    deadtime_comp_enable(&dtc, false);
+    d = duty(6000, 10800, 7000, 9800);
+    deadtime_comp_apply(&dtc, &d, 3.0f);
+    CHECK(d.hbridge1.ch1 == 6000 && d.hbridge1.ch2 == 10800, "disabled: duties pass through");
+
+    /* Polarity prediction: falling current, correction flips before the
+     * sample crosses zero */
+    deadtime_comp_init(&dtc, DT_COUNTS, DT_COUNTS, 0.0f);
+    int flip_at = -1;
+    for (int k = 0; k < 30; k++) {
+        float i_meas = 2.0f - 0.1f * (float)k;  // Crosses zero at k = 20
+        d = duty(6000, 10800, 7000, 9800);
+        deadtime_comp_apply(&dtc, &d, i_meas);
+        if (flip_at < 0 && dtc.gain < 0.0f) flip_at = k;
+    }
+    CHECK(flip_at >= 17 && flip_at < 20,
+          "predicted polarity flips %d period(s) ahead of the sample", 20 - flip_at);
+
+    /* Plant simulation */
+    static const load_point_t points[] = {
+        { "LS, MI 0.8, 20 ohm",  0.8f,  20.0, MODULATION_MODE_LS, 0.5 },
+        { "LS, MI 0.8, 80 ohm",  0.8f,  80.0, MODULATION_MODE_LS, 0.5 },
+        { "LS, MI 0.3, 80 ohm",  0.3f,  80.0, MODULATION_MODE_LS, 0.5 },
+        // ~4% load: 0.15 A peak is within the noise and ripple
+        { "LS, MI 0.3, 200 ohm", 0.3f, 200.0, MODULATION_MODE_LS, 0.8 },
+        { "PS, MI 0.8, 80 ohm",  0.8f,  80.0, MODULATION_MODE_PS, 0.5 },
+    };
+    const int n_points = sizeof(points) / sizeof(points[0]);
+
+    printf("\nRL load, L = %.0f mH, 2 x %.0f V, %d Hz switching, THD over h2..h%d\n\n",
+           L_LOAD * 1e3, VDC, PWM_FREQUENCY_HZ, H_LOW);
+    printf("%-20s %6s | %-27s | %-13s | %s\n", "", "", "Current THD", "Voltage THD", "V1 loss (V)");
+    printf("%-20s %6s | %6s %6s %6s %6s | %6s %6s |\n", "Load point", "I1 (A)",
+           "Td=0", "off", "on", "hard", "off", "on");
+
+    sim_result_t off[8], on[8];
+
+    for (int k = 0; k < n_points; k++) {
+        const load_point_t *lp = &points[k];
+        sim_result_t ideal = simulate(lp, 0, false, DEADTIME_COMP_BAND_DEFAULT);
+        off[k] = simulate(lp, DT_COUNTS, false, DEADTIME_COMP_BAND_DEFAULT);
+        on[k] = simulate(lp, DT_COUNTS, true, DEADTIME_COMP_BAND_DEFAULT);
+        sim_result_t hard = simulate(lp, DT_COUNTS, true, 0.0f);
+        double v1_ideal = 2.0 * VDC * lp->mi;
+
+        printf("%-20s %6.3f | %5.2f%% %5.2f%% %5.2f%% %5.2f%% | %5.2f%% %5.2f%% | %4.2f -> %4.2f\n",
+               lp->name, on[k].i1, ideal.i_thd * 100.0, off[k].i_thd * 100.0,
+               on[k].i_thd * 100.0, hard.i_thd * 100.0, off[k].v_thd * 100.0,
+               on[k].v_thd * 100.0, v1_ideal - off[k].v1, v1_ideal - on[k].v1);
+    }
+    printf("\n");
+
+    for (int k = 0; k < n_points; k++) {
+        const load_point_t *lp = &points[k];
+        double v1_ideal = 2.0 * VDC * lp->mi;
+
+        CHECK(on[k].i_thd < lp->max_ratio * off[k].i_thd, "%s: current THD %.2f%% -> %.2f%%",
+              lp->name, off[k].i_thd * 100.0, on[k].i_thd * 100.0);
+        CHECK(fabs(v1_ideal - on[k].v1) < 0.5 * fabs(v1_ideal - off[k].v1),
+              "%s: fundamental voltage loss %.2f V -> %.2f V",
+              lp->name, v1_ideal - off[k].v1, v1_ideal - on[k].v1);
+    }
+
+    printf("\n========================================\n");
+    if (failures == 0) {
+        printf("*** ALL TESTS PASSED! ***\n");
+    } else {
+        printf("*** %d TEST(S) FAILED ***\n", failures);
+    }
+    printf("========================================\n");
+    return failures == 0 ? 0 : 1;
+}
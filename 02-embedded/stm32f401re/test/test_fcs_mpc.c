@@ -0,0 +1,312 @@
+/**
+ * @file test_fcs_mpc.c
+ * @brief Host benchmark and plant simulation for FCS-MPC
+ *
+ * - Gate tables: levels and redundancy of the 16 states
+ * - The branch-free inner loop picks the same state as a plain
+ *   if/else search over random operating points
+ * - Cost per update on the host
+ * - RL plant (R = 20 ohm, L = 10 mH, 2 x 50 V) driven with the gates,
+ *   integrated at 0.5 us with the one-period actuation delay of the
+ *   timer preload. Current THD and tracking error are compared against
+ *   the existing PR controller (pr_controller.c, 5 kHz) driving a 5-level
+ *   level-shifted PWM (4 carriers, 5 kHz)
+ *
+ * Plant model: plant_sim.c
+ *
+ * Build/run: make test
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-23
+ */
+
+#include "fcs_mpc.h"
+#include "pr_controller.h"
+#include "plant_sim.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define I_PEAK      4.0
+#define DT          0.5e-6
+#define T_SIM       0.2                 // 10 cycles
+#define T_MEAS      0.1                 // THD over the last 5 cycles
+#define FS_THD      100000.0            // Current sampling for THD
+#define H_THD       200                 // THD over bins 2..200
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (cond) {                                         \
+            printf("[PASS] " __VA_ARGS__);                  \
+        } else {                                            \
+            printf("[FAIL] " __VA_ARGS__);                  \
+            failures++;                                     \
+        }                                                   \
+        printf("\n");                                       \
+    } while (0)
+
+/*---------------------------------------------------------------------------
+ * Reference search (plain if/else)
+ *-------------------------------------------------------------------------*/
+
+static uint8_t reference_search(const fcs_mpc_t *mpc, uint8_t prev,
+                                float i_ref, float i_meas, float vdc1, float vdc2)
+{
+    int8_t b1, b2;
+    fcs_mpc_level(prev, &b1, &b2);
+    float i1 = mpc->a * i_meas + mpc->b * (b1 * vdc1 + b2 * vdc2);
+
+    float best_cost = INFINITY;
+    uint8_t best = prev;
+    for (uint8_t j = 0; j < FCS_MPC_STATES; j++) {
+        fcs_mpc_level(j, &b1, &b2);
+        float i2_free = mpc->a * i1;
+        float e = (i_ref - i2_free) - (b1 * (mpc->b * vdc1) + b2 * (mpc->b * vdc2));
+        int n = 0;
+        for (int bit = 0; bit < 4; bit++) {
+            if (((prev ^ j) >> bit) & 1) n++;
+        }
+        float cost = e * e + mpc->lambda * n;
+        if (cost < best_cost) {
+            best_cost = cost;
+            best = j;
+        }
+    }
+    return best;
+}
+
+/*---------------------------------------------------------------------------
+ * Plant simulation
+ *-------------------------------------------------------------------------*/
+
+typedef struct {
+    double thd;             // Current THD (bins 2..200)
+    double i1_rms;          // Fundamental RMS
+    double err_rms;         // RMS tracking error
+    double fsw;             // Average switching frequency per device (Hz)
+} sim_result_t;
+
+static double i_reference(double t)
+{
+    return I_PEAK * sin(2.0 * M_PI * F1 * t);
+}
+
+static sim_result_t analyze(const plant_dft_t *dft, double err_sq, int err_n,
+                            unsigned long transitions)
+{
+    sim_result_t r;
+    double sum = 0.0;
+
+    for (int k = 2; k <= H_THD; k++) {
+        double h = plant_dft_peak(dft, PLANT_DFT_I, k);
+        sum += h * h;
+    }
+    double h1 = plant_dft_peak(dft, PLANT_DFT_I, 1);
+    r.thd = sqrt(sum) / h1;
+    r.i1_rms = h1 / sqrt(2.0);
+    r.err_rms = sqrt(err_sq / err_n);
+    // 4 legs, 2 devices per leg each switching once per leg transition
+    r.fsw = transitions / (4.0 * T_MEAS) / 2.0;
+    return r;
+}
+
+/* FCS-MPC at 20 kHz, gates latched one period after the decision */
+static sim_result_t sim_mpc(float lambda)
+{
+    const double ts = 1.0 / FCS_MPC_SAMPLE_FREQ_HZ;
+    const int steps_per_ts = (int)lrint(ts / DT);
+    const int steps = (int)lrint(T_SIM / DT);
+    const int meas_start = (int)lrint((T_SIM - T_MEAS) / DT);
+    const int thd_div = (int)lrint(1.0 / (FS_THD * DT));
+    fcs_mpc_t mpc;
+    plant_rl_t rl;
+    plant_dft_t dft;
+    double err_sq = 0.0;
+    int err_n = 0;
+    unsigned long transitions = 0;
+    uint8_t applied = 0, latched = 0;
+
+    fcs_mpc_init(&mpc, (float)R_LOAD, (float)L_LOAD, FCS_MPC_SAMPLE_FREQ_HZ);
+    fcs_mpc_set_lambda(&mpc, lambda);
+
+    plant_rl_init(&rl, R_LOAD, L_LOAD, DT);
+    plant_dft_init(&dft, F1, H_THD, 1.0 / FS_THD);
+    for (int n = 0; n < steps; n++) {
+        double t = n * DT;
+
+        if (n % steps_per_ts == 0) {
+            // Update event: preloaded gates take effect, then sample/decide
+            if (n >= meas_start) {
+                uint8_t x = applied ^ latched;
+                transitions += (x & 1) + ((x >> 1) & 1) + ((x >> 2) & 1) + ((x >> 3) & 1);
+            }
+            applied = latched;
+            latched = fcs_mpc_update(&mpc, (float)i_reference(t + 2.0 * ts),
+                                     (float)(rl.i + plant_noise()), (float)VDC, (float)VDC);
+        }
+
+        double v = fcs_mpc_level(applied, NULL, NULL) * VDC;
+        double i = plant_rl_step(&rl, v);
+
+        if (n >= meas_start) {
+            double e = i - i_reference(t + DT);
+            err_sq += e * e;
+            err_n++;
+            if ((n - meas_start) % thd_div == 0) {
+                plant_dft_add(&dft, i, v);
+            }
+        }
+    }
+    return analyze(&dft, err_sq, err_n, transitions);
+}
+
+/* PR current loop at 5 kHz + 5-level level-shifted PWM (4 carriers, 5 kHz) */
+static sim_result_t sim_pr_pwm(void)
+{
+    const double ts = 1.0 / PR_SAMPLE_FREQ;
+    const int steps_per_ts = (int)lrint(ts / DT);
+    const int steps = (int)lrint(T_SIM / DT);
+    const int meas_start = (int)lrint((T_SIM - T_MEAS) / DT);
+    const int thd_div = (int)lrint(1.0 / (FS_THD * DT));
+    pr_controller_t pr;
+    plant_rl_t rl;
+    plant_dft_t dft;
+    double err_sq = 0.0, ref_pu = 0.0, next_pu = 0.0;
+    int err_n = 0, level = 0;
+    unsigned long transitions = 0;
+
+    // Voltage output in per-unit of 2*Vdc: Kp = 30 V/A, Kr = 1000 V/A at 50 Hz
+    pr_controller_init(&pr, 30.0f / (2.0f * VDC), 1000.0f / (2.0f * VDC), PR_WC_DEFAULT);
+    pr_controller_set_limits(&pr, -1.0f, 1.0f);
+
+    plant_rl_init(&rl, R_LOAD, L_LOAD, DT);
+    plant_dft_init(&dft, F1, H_THD, 1.0 / FS_THD);
+    for (int n = 0; n < steps; n++) {
+        double t = n * DT;
+
+        if (n % steps_per_ts == 0) {
+            // Duty computed from this sample applies from the next period
+            ref_pu = next_pu;
+            next_pu = pr_controller_update(&pr, (float)i_reference(t + ts), (float)(rl.i + plant_noise()));
+        }
+
+        // Four level-shifted triangle carriers (in phase), one per band
+        double phase = fmod(t / ts, 1.0);
+        double tri = (phase < 0.5) ? 2.0 * phase : 2.0 - 2.0 * phase;
+        int new_level = -2;
+        for (int c = 0; c < 4; c++) {
+            if (ref_pu > -1.0 + 0.5 * (c + tri)) {
+                new_level++;
+            }
+        }
+        if (n >= meas_start && new_level != level) {
+            // One bridge changes one leg per level step
+            transitions += (unsigned long)abs(new_level - level);
+        }
+        level = new_level;
+
+        double v = level * VDC;
+        double i = plant_rl_step(&rl, v);
+
+        if (n >= meas_start) {
+            double e = i - i_reference(t + DT);
+            err_sq += e * e;
+            err_n++;
+            if ((n - meas_start) % thd_div == 0) {
+                plant_dft_add(&dft, i, v);
+            }
+        }
+    }
+    return analyze(&dft, err_sq, err_n, transitions);
+}
+
+int main(void)
+{
+    fcs_mpc_t mpc;
+
+    printf("\n========================================\n");
+    printf("FCS-MPC Test (%d states, %d Hz)\n", FCS_MPC_STATES, FCS_MPC_SAMPLE_FREQ_HZ);
+    printf("========================================\n");
+
+    /* State table */
+    int count[5] = {0};
+    int table_ok = 1;
+    for (uint8_t g = 0; g < FCS_MPC_STATES; g++) {
+        int8_t b1, b2;
+        int8_t lvl = fcs_mpc_level(g, &b1, &b2);
+        int a1 = g & 1, bb1 = (g >> 1) & 1, a2 = (g >> 2) & 1, bb2 = (g >> 3) & 1;
+        table_ok &= (b1 == a1 - bb1) && (b2 == a2 - bb2);
+        count[lvl + 2]++;
+    }
+    CHECK(table_ok && count[0] == 1 && count[1] == 4 && count[2] == 6 &&
+          count[3] == 4 && count[4] == 1,
+          "16 states -> levels -2..+2 with %d/%d/%d/%d/%d redundancy",
+          count[0], count[1], count[2], count[3], count[4]);
+
+    CHECK(fcs_mpc_init(&mpc, 0.0f, 0.01f, 20000.0f) != 0, "invalid model rejected");
+
+    /* Branch-free search vs plain search */
+    fcs_mpc_init(&mpc, (float)R_LOAD, (float)L_LOAD, FCS_MPC_SAMPLE_FREQ_HZ);
+    int mismatches = 0;
+    for (int n = 0; n < 100000; n++) {
+        uint8_t prev = mpc.gates;
+        float i_ref = (float)(plant_noise() * 250.0);
+        float i_meas = (float)(plant_noise() * 250.0);
+        float vdc1 = (float)(VDC + plant_noise() * 100.0);
+        float vdc2 = (float)(VDC + plant_noise() * 100.0);
+        uint8_t want = reference_search(&mpc, prev, i_ref, i_meas, vdc1, vdc2);
+        if (fcs_mpc_update(&mpc, i_ref, i_meas, vdc1, vdc2) != want) {
+            mismatches++;
+        }
+    }
+    CHECK(mismatches == 0, "table-driven search matches if/else search (100000 points)");
+
+    /* Benchmark */
+    const int n_bench = 5000000;
+    volatile uint8_t sink = 0;
+    struct timespec a, b;
+    fcs_mpc_init(&mpc, (float)R_LOAD, (float)L_LOAD, FCS_MPC_SAMPLE_FREQ_HZ);
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    for (int n = 0; n < n_bench; n++) {
+        sink ^= fcs_mpc_update(&mpc, (float)(n & 7) - 3.5f, (float)(n & 3) - 1.5f, 50.0f, 49.0f);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    (void)sink;
+    double ns = ((b.tv_sec - a.tv_sec) * 1e9 + (b.tv_nsec - a.tv_nsec)) / n_bench;
+    printf("\nCost per update (host): %.1f ns (budget %.0f ns at %d Hz)\n\n",
+           ns, 1e9 / FCS_MPC_SAMPLE_FREQ_HZ, FCS_MPC_SAMPLE_FREQ_HZ);
+
+    /* Plant simulation */
+    sim_result_t pr = sim_pr_pwm();
+    sim_result_t m0 = sim_mpc(0.0f);
+    sim_result_t m1 = sim_mpc(FCS_MPC_LAMBDA_DEFAULT);
+
+    printf("%-26s %8s %10s %10s %12s\n", "Controller", "THD", "I1 (A)", "err (A)", "fsw/dev (Hz)");
+    printf("%-26s %7.2f%% %10.3f %10.3f %12.0f\n", "PR + LS-PWM (5 kHz)",
+           pr.thd * 100.0, pr.i1_rms, pr.err_rms, pr.fsw);
+    printf("%-26s %7.2f%% %10.3f %10.3f %12.0f\n", "FCS-MPC lambda=0",
+           m0.thd * 100.0, m0.i1_rms, m0.err_rms, m0.fsw);
+    printf("%-26s %7.2f%% %10.3f %10.3f %12.0f\n\n", "FCS-MPC lambda=default",
+           m1.thd * 100.0, m1.i1_rms, m1.err_rms, m1.fsw);
+
+    double i1_target = I_PEAK / sqrt(2.0);
+    CHECK(fabs(m1.i1_rms - i1_target) < 0.02 * i1_target,
+          "MPC tracks the fundamental (%.3f A rms, target %.3f)", m1.i1_rms, i1_target);
+    CHECK(m1.thd < 0.05, "MPC current THD %.2f%% < 5%%", m1.thd * 100.0);
+    CHECK(m1.fsw < m0.fsw, "switching penalty lowers device switching (%.0f -> %.0f Hz)",
+          m0.fsw, m1.fsw);
+    CHECK(m1.thd < pr.thd && m1.err_rms < pr.err_rms,
+          "MPC THD/error below PR + PWM (%.2f%% vs %.2f%%)", m1.thd * 100.0, pr.thd * 100.0);
+
+    printf("\n========================================\n");
+    if (failures == 0) {
+        printf("*** ALL TESTS PASSED! ***\n");
+    } else {
+        printf("*** %d TEST(S) FAILED ***\n", failures);
+    }
+    printf("========================================\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,309 @@
+/**
+ * @file test_fpga_link.c
+ * @brief Host test of the hybrid board's FPGA link and DC-link feed-forward
+ *
+ * Runs the STM32 side of the STM32+FPGA hybrid (stm32-fpga-hybrid/stm32,
+ * fpga_interface.c) against a model of the FPGA SPI slave: every frame
+ * burst returns a CRC-framed sample with the configured bus codes, and
+ * the PWM command clocked in on MOSI is checked and latched the way
+ * stm32_spi_interface.v does. The control sequence is the one of
+ * control_loop() in main.c: frame in, feed-forward update, split of the
+ * output level, command out with the next frame. The latched indices
+ * drive a clock-level model of the FPGA PWM (fpga_sensing_top.v: duty_ref
+ * to carrier counts, carrier_generator in phase-shifted mode, four
+ * pwm_comparator legs +M1/-M1, +M2/-M2; dead time left out, there is no
+ * load current to decide the leg voltage in it).
+ * - Round trip: a reference through the split, build_command, the
+ *   command decoder and the PWM model comes back as the period-average
+ *   output voltage, within the carrier-count resolution
+ * - Phase-shifted carriers: both bridges get the same share, the output
+ *   steps by one bus at a time at 4x the carrier frequency (8 steps per
+ *   period); the level-shifted split cancels in one bridge (4 steps)
+ * - 50 V / 40 V buses: the latched indices give m1 * Vdc1 + m2 * Vdc2 =
+ *   the output level over a whole 50 Hz cycle (not normalized: 8 V short)
+ * - Readings below half of nominal (disconnected sensor) count as
+ *   nominal: indices bit-exact with equal nominal buses
+ * - Just above half of nominal the gain is Vnom / Vdc (at most 2)
+ *
+ * Build/run: make test
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-29
+ */
+
+#include "fpga_interface.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CONTROL_FREQ_HZ 10000.0
+#define OUTPUT_FREQ_HZ  50.0
+#define OPEN_LOOP_MI    0.8
+#define CYCLE_SAMPLES   200
+#define PWM_FREQ_DIV    2500            // fpga_sensing_top: 50 MHz / (2 x 10 kHz)
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (cond) {                                         \
+            printf("[PASS] " __VA_ARGS__);                  \
+        } else {                                            \
+            printf("[FAIL] " __VA_ARGS__);                  \
+            failures++;                                     \
+        }                                                   \
+        printf("\n");                                       \
+    } while (0)
+
+/*---------------------------------------------------------------------------
+ * Fake HAL: FPGA SPI slave model
+ *-------------------------------------------------------------------------*/
+
+static GPIO_TypeDef gpioa;
+GPIO_TypeDef *const GPIOA = &gpioa;
+
+static struct {
+    uint16_t ch[4];         // ADC codes served in the frame
+    uint32_t seq;
+    int16_t  m[2];          // Latched command (Q14)
+    uint8_t  flags;
+    int      commands;      // Valid PWM commands received
+} fpga;
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    (void)GPIOx;
+    (void)GPIO_Init;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    (void)GPIOx;
+    (void)GPIO_Pin;
+    (void)PinState;
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData,
+                                          uint8_t *pRxData, uint16_t Size, uint32_t Timeout)
+{
+    (void)hspi;
+    (void)Timeout;
+
+    memset(pRxData, 0xFF, Size);
+    if (pTxData[0] != FPGA_REG_FRAME || Size != FPGA_FRAME_SIZE + 1) {
+        return HAL_OK;
+    }
+
+    // Frame out (byte 0 goes with the address)
+    uint8_t *f = &pRxData[1];
+    fpga.seq++;
+    f[0] = FPGA_FRAME_SYNC;
+    f[1] = FPGA_FRAME_LEN;
+    for (int i = 0; i < 4; i++) f[2 + i] = (uint8_t)(fpga.seq >> (8 * i));
+    f[6] = 0x0F | ((fpga.flags & FPGA_CMD_ENABLE) ? FPGA_PWM_RUNNING : 0);
+    for (int i = 0; i < 4; i++) {
+        f[7 + 2 * i] = (uint8_t)(fpga.ch[i] >> 8);
+        f[8 + 2 * i] = (uint8_t)fpga.ch[i];
+    }
+    memset(&f[15], 0, 4);
+    uint16_t crc = fpga_crc16(f, FPGA_FRAME_SIZE - 2);
+    f[19] = (uint8_t)(crc >> 8);
+    f[20] = (uint8_t)crc;
+
+    // Command in: SYNC, FLAGS, M1, M2, CRC
+    const uint8_t *c = &pTxData[1];
+    uint16_t ccrc = ((uint16_t)c[6] << 8) | c[7];
+    if (c[0] == FPGA_CMD_PWM && fpga_crc16(c, FPGA_CMD_SIZE - 2) == ccrc) {
+        fpga.flags = c[1];
+        fpga.m[0] = (int16_t)(((uint16_t)c[2] << 8) | c[3]);
+        fpga.m[1] = (int16_t)(((uint16_t)c[4] << 8) | c[5]);
+        fpga.commands++;
+    }
+    return HAL_OK;
+}
+
+/*---------------------------------------------------------------------------
+ * FPGA PWM model: one carrier period, peak to peak
+ *-------------------------------------------------------------------------*/
+
+typedef struct {
+    double v_avg;           // Period-average output (V)
+    int    steps;           // Output level changes in the period
+    double max_step;        // Largest single change (V)
+} pwm_period_t;
+
+static int32_t duty_ref(int16_t m)
+{
+    if (m >= 16384) return PWM_FREQ_DIV + 1;
+    if (m <= -16384) return -(PWM_FREQ_DIV + 1);
+    return (int32_t)(((int64_t)m * PWM_FREQ_DIV) >> 14);
+}
+
+static int32_t triangle(int32_t t)
+{
+    t %= 2 * PWM_FREQ_DIV;
+    return (t <= PWM_FREQ_DIV) ? PWM_FREQ_DIV - t : t - PWM_FREQ_DIV;
+}
+
+static pwm_period_t pwm_period(const int16_t m[2], double vdc1, double vdc2)
+{
+    int32_t ref[2] = { duty_ref(m[0]), duty_ref(m[1]) };
+    pwm_period_t r = { 0.0, 0, 0.0 };
+    double v_prev = 0.0, sum = 0.0;
+
+    for (int32_t t = 0; t <= 2 * PWM_FREQ_DIV; t++) {
+        // Carrier 1 from its peak, carrier 2 a quarter period ahead
+        int32_t c1 = 2 * triangle(t) - PWM_FREQ_DIV;
+        int32_t c2 = 2 * triangle(t + PWM_FREQ_DIV / 2) - PWM_FREQ_DIV;
+        int a1 = ref[0] > c1, b1 = -ref[0] > c1;
+        int a2 = ref[1] > c2, b2 = -ref[1] > c2;
+        double v = vdc1 * (a1 - b1) + vdc2 * (a2 - b2);
+
+        if (t > 0) {
+            if (v != v_prev) {
+                r.steps++;
+                if (fabs(v - v_prev) > r.max_step) r.max_step = fabs(v - v_prev);
+            }
+            sum += v;
+        }
+        v_prev = v;
+    }
+    r.v_avg = sum / (2 * PWM_FREQ_DIV);
+    return r;
+}
+
+/*---------------------------------------------------------------------------
+ * Control sequence of main.c control_loop()
+ *-------------------------------------------------------------------------*/
+
+static SPI_HandleTypeDef hspi;
+
+static int32_t level_at(int k)
+{
+    double theta = 2.0 * M_PI * OUTPUT_FREQ_HZ / CONTROL_FREQ_HZ * k;
+    return (int32_t)(2.0 * OPEN_LOOP_MI * FPGA_Q14_ONE * sin(theta));
+}
+
+/* One output cycle on the given bus codes; returns the worst error (V)
+ * of the latched command against the level it was computed for. m_log
+ * receives the latched indices per sample when not NULL. */
+static double run_cycle(double vdc1, double vdc2, int feedforward, int16_t m_log[][2])
+{
+    fpga_dc_feedforward_t ff = {
+        { FPGA_Q14_ONE, FPGA_Q14_ONE }, { FPGA_Q14_ONE, FPGA_Q14_ONE }
+    };
+    fpga_pwm_cmd_t cmd = { { 0, 0 }, true, false };
+    fpga_adc_data_t data;
+    int32_t sent_level = 0;
+    double worst = 0.0;
+
+    memset(&fpga, 0, sizeof(fpga));
+    fpga.ch[2] = fpga.ch[3] = 0x8000;
+    fpga_init(&hspi);
+
+    for (int k = 0; k <= CYCLE_SAMPLES; k++) {
+        if (fpga_exchange_frame(&cmd, &data) != HAL_OK) return 1e9;
+
+        // The command latched now was computed from sent_level
+        if (k > 0) {
+            double volts = fpga.m[0] / 16384.0 * vdc1 + fpga.m[1] / 16384.0 * vdc2;
+            double err = fabs(volts - sent_level / 16384.0 * FPGA_DC_NOMINAL_V);
+            if (err > worst) worst = err;
+            if (m_log) {
+                m_log[k - 1][0] = fpga.m[0];
+                m_log[k - 1][1] = fpga.m[1];
+            }
+        }
+
+        if (feedforward) fpga_dc_feedforward_update(&ff, &data);
+        sent_level = level_at(k);
+        fpga_dc_feedforward_split(&ff, sent_level, cmd.m_q14);
+
+        // Next sample: the buses as measured by the FPGA
+        fpga.ch[0] = fpga_physical_to_code(FPGA_ADC_CH0, (float)vdc1);
+        fpga.ch[1] = fpga_physical_to_code(FPGA_ADC_CH1, (float)vdc2);
+    }
+    return worst;
+}
+
+/*---------------------------------------------------------------------------
+ * Tests
+ *-------------------------------------------------------------------------*/
+
+int main(void)
+{
+    static int16_t m_nom[CYCLE_SAMPLES][2], m_bad[CYCLE_SAMPLES][2];
+
+    printf("\n========================================\n");
+    printf("Hybrid FPGA Link and DC-Link Feed-Forward Test\n");
+    printf("========================================\n");
+
+    /* Round trip through the command and the PWM model */
+    static int16_t m_log[CYCLE_SAMPLES][2];
+    double worst_rt = 0.0, worst_share = 0.0, worst_step = 0.0;
+    int min_steps = 1000;
+    (void)run_cycle(50.0, 50.0, 1, m_log);
+    for (int k = 0; k < CYCLE_SAMPLES; k++) {
+        pwm_period_t p = pwm_period(m_log[k], 50.0, 50.0);
+        double v_ref = level_at(k) / 16384.0 * FPGA_DC_NOMINAL_V;
+        if (fabs(p.v_avg - v_ref) > worst_rt) worst_rt = fabs(p.v_avg - v_ref);
+        if (abs(m_log[k][0] - m_log[k][1]) > worst_share) {
+            worst_share = abs(m_log[k][0] - m_log[k][1]);
+        }
+        if (p.max_step > worst_step) worst_step = p.max_step;
+        // Steps merge where a leg saturates or a share is near zero
+        if (abs(m_log[k][0]) > 400 && abs(m_log[k][0]) < 16000 && p.steps < min_steps) {
+            min_steps = p.steps;
+        }
+    }
+    printf("  2 x 50 V, MI %.1f round trip: worst period-average error %.3f V, "
+           "%d output steps per carrier period\n", OPEN_LOOP_MI, worst_rt, min_steps);
+    CHECK(worst_rt < 0.1, "reference -> build_command -> PWM model: output on reference (%.3f V)",
+          worst_rt);
+    CHECK(worst_share <= 1, "phase-shifted split: both bridges get the same index");
+    CHECK(min_steps == 8 && worst_step == 50.0,
+          "output steps one bus at a time, 8 per carrier period (4x carrier)");
+
+    // The level-shifted split the PS carriers cannot use: the outer
+    // bridge idles at m = 0, its two legs switch together
+    int16_t ls[2] = { (int16_t)(0.8 * FPGA_Q14_ONE), 0 };
+    int16_t ps[2] = { (int16_t)(0.4 * FPGA_Q14_ONE), (int16_t)(0.4 * FPGA_Q14_ONE) };
+    pwm_period_t p_ls = pwm_period(ls, 50.0, 50.0);
+    pwm_period_t p_ps = pwm_period(ps, 50.0, 50.0);
+    CHECK(p_ps.steps == 2 * p_ls.steps && fabs(p_ps.v_avg - p_ls.v_avg) < 0.05,
+          "level 0.8: PS split %d steps, LS split %d for the same %.1f V",
+          p_ps.steps, p_ls.steps, p_ps.v_avg);
+
+    double err_ff = run_cycle(50.0, 40.0, 1, NULL);
+    double err_raw = run_cycle(50.0, 40.0, 0, NULL);
+    printf("  50 V / 40 V, MI %.1f: worst error %.3f V with feed-forward, %.2f V without\n",
+           OPEN_LOOP_MI, err_ff, err_raw);
+    CHECK(fpga.commands == CYCLE_SAMPLES + 1, "every command accepted by the FPGA model (%d)",
+          fpga.commands);
+    CHECK(err_ff < 0.05, "feed-forward: bridge volts on the output level (%.3f V)", err_ff);
+    CHECK(err_raw > 5.0, "without it the low bus falls short (%.2f V)", err_raw);
+
+    // Disconnected bus sensor: no doubling, same indices as nominal buses
+    (void)run_cycle(50.0, 50.0, 1, m_nom);
+    (void)run_cycle(50.0, 0.0, 1, m_bad);
+    CHECK(memcmp(m_nom, m_bad, sizeof(m_nom)) == 0,
+          "bus 2 reading 0 V: treated as nominal, indices bit-exact with 2 x 50 V");
+
+    fpga_dc_feedforward_t ff;
+    fpga_adc_data_t data = { 0 };
+    data.ch0 = fpga_physical_to_code(FPGA_ADC_CH0, 24.0f);
+    data.ch1 = fpga_physical_to_code(FPGA_ADC_CH1, 26.0f);
+    fpga_dc_feedforward_update(&ff, &data);
+    CHECK(ff.gain_q14[0] == FPGA_Q14_ONE && abs(ff.gain_q14[1] - 31508) < 40,
+          "24 V reading nominal, 26 V gain %.3f", ff.gain_q14[1] / 16384.0);
+
+    printf("\n========================================\n");
+    if (failures == 0) {
+        printf("*** ALL TESTS PASSED! ***\n");
+    } else {
+        printf("*** %d TEST(S) FAILED ***\n", failures);
+    }
+    printf("========================================\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+/**
+ * @file test_power_metrics.c
+ * @brief Host test for the sliding-window power metrics
+ *
+ * Feeds synthetic inverter waveforms (fundamental plus odd harmonics,
+ * lagging current, DC bus with 100 Hz ripple) and compares against a
+ * double-precision reference computed directly over the same samples:
+ * - RMS, P, S and PF from the last window, including mid-cycle
+ * - Harmonic magnitudes 1-13 against a full DFT of the cycle
+ * - THD, DC bus mean and peak-to-peak ripple
+ * - No drift after many cycles
+ * - Stride selection for the 5 Hz test mode
+ *
+ * Build/run: make test
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-21
+ */
+
+#include "power_metrics.h"
+#include <math.h>
+#include <stdio.h>
+
+#define FS          5000.0
+#define F1          50.0
+#define N_CYCLE     100
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (cond) {                                         \
+            printf("[PASS] " __VA_ARGS__);                  \
+        } else {                                            \
+            printf("[FAIL] " __VA_ARGS__);                  \
+            failures++;                                     \
+        }                                                   \
+        printf("\n");                                       \
+    } while (0)
+
+/*---------------------------------------------------------------------------
+ * Test waveforms
+ *-------------------------------------------------------------------------*/
+
+/* Output voltage: 100 V rms with 3rd, 5th, 7th and 11th */
+static const double v_amp[PM_HARMONICS] = {
+    141.42, 0.0, 7.0, 0.0, 4.2, 0.0, 2.8, 0.0, 0.0, 0.0, 1.5, 0.0, 0.0
+};
+/* Output current: 10 A rms lagging 30 deg, 3rd and 5th */
+static const double i_amp[PM_HARMONICS] = {
+    14.142, 0.0, 0.9, 0.0, 0.5, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0
+};
+
+static double v_wave(double t)
+{
+    double x = 0.0;
+    for (int h = 0; h < PM_HARMONICS; h++) {
+        x += v_amp[h] * sin(2.0 * M_PI * (h + 1) * F1 * t + 0.1 * h);
+    }
+    return x;
+}
+
+static double i_wave(double t)
+{
+    double x = 0.0;
+    for (int h = 0; h < PM_HARMONICS; h++) {
+        x += i_amp[h] * sin(2.0 * M_PI * (h + 1) * F1 * t - M_PI / 6.0 * (h + 1));
+    }
+    return x;
+}
+
+static double dc_wave(double t, double mean, double ripple)
+{
+    return mean + 0.5 * ripple * sin(2.0 * M_PI * 2.0 * F1 * t);
+}
+
+/*---------------------------------------------------------------------------
+ * Reference: direct sums and DFT over the last n samples
+ *-------------------------------------------------------------------------*/
+
+static double hist_v[N_CYCLE * 60];
+static double hist_i[N_CYCLE * 60];
+static double hist_d1[N_CYCLE * 60];
+
+static double ref_rms(const double *x, int end, int n)
+{
+    double s = 0.0;
+    for (int k = end - n; k < end; k++) {
+        s += x[k] * x[k];
+    }
+    return sqrt(s / n);
+}
+
+static double ref_power(int end, int n)
+{
+    double s = 0.0;
+    for (int k = end - n; k < end; k++) {
+        s += hist_v[k] * hist_i[k];
+    }
+    return s / n;
+}
+
+/* RMS of DFT bin h of the cycle [start, start + n) */
+static double ref_bin(const double *x, int start, int n, int h)
+{
+    double re = 0.0, im = 0.0;
+    for (int k = 0; k < n; k++) {
+        double w = 2.0 * M_PI * h * k / n;
+        re += x[start + k] * cos(w);
+        im -= x[start + k] * sin(w);
+    }
+    return sqrt(re * re + im * im) * sqrt(2.0) / n;
+}
+
+static double ref_thd(const double *x, int start, int n)
+{
+    double sum = 0.0;
+    for (int h = 2; h <= PM_HARMONICS; h++) {
+        double b = ref_bin(x, start, n, h);
+        sum += b * b;
+    }
+    return sqrt(sum) / ref_bin(x, start, n, 1);
+}
+
+static int rel_close(double a, double b, double tol)
+{
+    return fabs(a - b) <= tol * (fabs(b) + 1e-3);
+}
+
+static power_metrics_t pm;
+
+int main(void)
+{
+    const int cycles = 50;
+    int n = 0;
+    int cycle_flags = 0;
+    int sliding_errors = 0;
+    double worst_rms = 0.0;
+
+    printf("\n========================================\n");
+    printf("Power Metrics Test (%d samples/cycle)\n", N_CYCLE);
+    printf("========================================\n");
+
+    CHECK(power_metrics_init(&pm, 0.0f, 50.0f) != 0, "bad sample rate rejected");
+    CHECK(power_metrics_init(&pm, (float)FS, (float)F1) == 0 &&
+          pm.window == N_CYCLE && pm.stride == 1,
+          "window %u, stride %u", pm.window, pm.stride);
+    CHECK(!power_metrics_get(&pm)->valid, "not valid before the first cycle");
+
+    for (int c = 0; c < cycles; c++) {
+        for (int k = 0; k < N_CYCLE; k++, n++) {
+            double t = n / FS;
+            hist_v[n] = v_wave(t);
+            hist_i[n] = i_wave(t);
+            hist_d1[n] = dc_wave(t, 200.0, 6.0);
+
+            if (power_metrics_update(&pm, (float)hist_v[n], (float)hist_i[n],
+                                     (float)hist_d1[n], (float)dc_wave(t, 195.0, 2.0))) {
+                cycle_flags++;
+            }
+
+            // Sliding values must match the last N_CYCLE samples at every step
+            if (c >= 1) {
+                const power_metrics_data_t *d = power_metrics_get(&pm);
+                double vr = ref_rms(hist_v, n + 1, N_CYCLE);
+                double ir = ref_rms(hist_i, n + 1, N_CYCLE);
+                double p = ref_power(n + 1, N_CYCLE);
+                double e = fabs(d->v_rms - vr) / vr;
+                if (e > worst_rms) {
+                    worst_rms = e;
+                }
+                if (!rel_close(d->v_rms, vr, 1e-4) || !rel_close(d->i_rms, ir, 1e-4) ||
+                    !rel_close(d->p_real, p, 1e-4) ||
+                    !rel_close(d->power_factor, p / (vr * ir), 1e-4)) {
+                    sliding_errors++;
+                }
+            }
+        }
+    }
+
+    const power_metrics_data_t *d = power_metrics_get(&pm);
+    int last = n - N_CYCLE;
+    double vr = ref_rms(hist_v, n, N_CYCLE);
+    double ir = ref_rms(hist_i, n, N_CYCLE);
+    double p = ref_power(n, N_CYCLE);
+
+    CHECK(cycle_flags == cycles && d->cycles == (uint32_t)cycles && d->valid,
+          "%d cycle completions", cycle_flags);
+    CHECK(sliding_errors == 0,
+          "sliding RMS/P/PF match the window every sample (worst %.2e)", worst_rms);
+    CHECK(rel_close(d->v_rms, vr, 1e-4) && rel_close(d->i_rms, ir, 1e-4),
+          "Vrms %.3f V (ref %.3f), Irms %.4f A (ref %.4f)", d->v_rms, vr, d->i_rms, ir);
+    CHECK(rel_close(d->p_real, p, 1e-4) && rel_close(d->s_apparent, vr * ir, 1e-4),
+          "P %.2f W (ref %.2f), S %.2f VA (ref %.2f)", d->p_real, p, d->s_apparent, vr * ir);
+    CHECK(rel_close(d->power_factor, p / (vr * ir), 1e-4) && d->power_factor < 0.87f,
+          "PF %.4f (ref %.4f, 30 deg lag)", d->power_factor, p / (vr * ir));
+
+    int bin_errors = 0;
+    for (int h = 1; h <= PM_HARMONICS; h++) {
+        double rv = ref_bin(hist_v, last, N_CYCLE, h);
+        double ri = ref_bin(hist_i, last, N_CYCLE, h);
+        if (fabs(d->v_harmonic[h - 1] - rv) > 1e-3 + 1e-4 * rv ||
+            fabs(d->i_harmonic[h - 1] - ri) > 1e-4 + 1e-4 * ri) {
+            printf("       h%d: V %.5f (ref %.5f) I %.5f (ref %.5f)\n",
+                   h, d->v_harmonic[h - 1], rv, d->i_harmonic[h - 1], ri);
+            bin_errors++;
+        }
+    }
+    CHECK(bin_errors == 0, "harmonics 1-13 match DFT (V1 %.3f, V3 %.3f, V11 %.3f V)",
+          d->v_harmonic[0], d->v_harmonic[2], d->v_harmonic[10]);
+
+    double v_thd = ref_thd(hist_v, last, N_CYCLE);
+    double i_thd = ref_thd(hist_i, last, N_CYCLE);
+    CHECK(fabs(d->v_thd - v_thd) < 1e-4 && fabs(d->i_thd - i_thd) < 1e-4,
+          "THD V %.3f%% (ref %.3f%%), I %.3f%% (ref %.3f%%)",
+          d->v_thd * 100.0f, v_thd * 100.0, d->i_thd * 100.0f, i_thd * 100.0);
+
+    double d1_min = 1e9, d1_max = -1e9, d1_sum = 0.0;
+    for (int k = last; k < n; k++) {
+        d1_sum += hist_d1[k];
+        d1_min = fmin(d1_min, hist_d1[k]);
+        d1_max = fmax(d1_max, hist_d1[k]);
+    }
+    CHECK(fabs(d->dc1_mean - d1_sum / N_CYCLE) < 1e-3 &&
+          fabs(d->dc1_ripple - (d1_max - d1_min)) < 1e-3,
+          "DC1 %.3f V, ripple %.3f Vpp (ref %.3f)", d->dc1_mean, d->dc1_ripple, d1_max - d1_min);
+    CHECK(fabs(d->dc2_mean - 195.0f) < 1e-2 && fabs(d->dc2_ripple - 2.0f) < 1e-2,
+          "DC2 %.3f V, ripple %.3f Vpp", d->dc2_mean, d->dc2_ripple);
+
+    /* Pure sine: THD close to zero */
+    power_metrics_init(&pm, (float)FS, (float)F1);
+    for (int k = 0; k < 3 * N_CYCLE; k++) {
+        float s = 100.0f * sinf(2.0f * (float)M_PI * k / N_CYCLE);
+        power_metrics_update(&pm, s, s * 0.1f, 200.0f, 200.0f);
+    }
+    d = power_metrics_get(&pm);
+    CHECK(d->v_thd < 1e-4f && fabsf(d->power_factor - 1.0f) < 1e-4f &&
+          d->dc1_ripple == 0.0f,
+          "pure sine: THD %.2e, PF %.5f", d->v_thd, d->power_factor);
+
+    /* 5 Hz test mode: 1000 samples/cycle -> stride 3, window 333 */
+    CHECK(power_metrics_init(&pm, (float)FS, 5.0f) == 0 &&
+          pm.stride == 3 && pm.window == 333,
+          "5 Hz: window %u, stride %u", pm.window, pm.stride);
+    int done = 0;
+    for (int k = 0; k < 3 * 1000; k++) {
+        float s = 100.0f * sinf(2.0f * (float)M_PI * 5.0f * k / (float)FS);
+        done += power_metrics_update(&pm, s, 0.0f, 0.0f, 0.0f);
+    }
+    d = power_metrics_get(&pm);
+    CHECK(done == 3 && fabsf(d->v_rms - 70.71f) < 0.3f && d->v_thd < 0.01f,
+          "5 Hz: %d windows, Vrms %.2f V, THD %.3f%%", done, d->v_rms, d->v_thd * 100.0f);
+
+    printf("\n========================================\n");
+    if (failures == 0) {
+        printf("*** ALL TESTS PASSED! ***\n");
+    } else {
+        printf("*** %d TEST(S) FAILED ***\n", failures);
+    }
+    printf("========================================\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,384 @@
+/**
+ * @file test_pwm_modes.c
+ * @brief Host model of LS vs PS carrier PWM: output spectrum and balance
+ *
+ * Feeds modulation_calculate_duties() period by period and rebuilds the
+ * gate waveforms the timers produce (edge-aligned up-counting, PWM mode 1:
+ * leg high while CNT < CCR; TIM8 offset by modulation_carrier_shift()).
+ * The Fourier series of the output is integrated exactly from the pulse
+ * edges over two output cycles (the rotation period), so no sampling
+ * error enters the spectrum.
+ *
+ * Reported per mode: fundamental, lowest harmonic above 1% of the
+ * fundamental, THD and WTHD up to 25 kHz, carrier-band content, power
+ * and switching share of each bridge.
+ *
+ * Reference shaping: fundamental at the MI limit of each shape (THI and
+ * min-max must stay linear up to 2/sqrt(3)), the injected third harmonic
+ * and NLC switching at the fundamental only.
+ *
+ * Build/run: make test
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-24
+ */
+
+#include "multilevel_modulation.h"
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define F_OUT           50.0
+#define COUNTS          (PWM_PERIOD + 1)                // Timer counts per period
+#define PERIODS         (2 * PWM_FREQUENCY_HZ / 50)     // Two output cycles
+#define WINDOW          ((double)PERIODS * COUNTS)      // Counts in the window
+#define H_FUND          2                               // 50 Hz in window bins
+#define H_MAX           1000                            // 25 kHz
+#define BIN_HZ          (F_OUT / H_FUND)
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (cond) {                                         \
+            printf("[PASS] " __VA_ARGS__);                  \
+        } else {                                            \
+            printf("[FAIL] " __VA_ARGS__);                  \
+            failures++;                                     \
+        }                                                   \
+        printf("\n");                                       \
+    } while (0)
+
+/*---------------------------------------------------------------------------
+ * Waveform model
+ *-------------------------------------------------------------------------*/
+
+typedef struct {
+    double complex c[2][H_MAX + 1];     // Per-bridge Fourier coefficients (Vdc units)
+    unsigned long edges[2];             // Gate transitions per bridge
+    int max_step;                       // Largest output jump at one instant
+} result_t;
+
+typedef struct {
+    double t;
+    int dv;
+} edge_t;
+
+static edge_t edge_list[PERIODS * 8 + 16];
+static int edge_count;
+
+static int edge_cmp(const void *a, const void *b)
+{
+    double d = ((const edge_t *)a)->t - ((const edge_t *)b)->t;
+    return (d > 0) - (d < 0);
+}
+
+/* Add the coefficients of a pulse of height sign on [a, b) (counts) */
+static void add_pulse(double complex *c, double a, double b, int sign)
+{
+    for (int h = 1; h <= H_MAX; h++) {
+        double w = 2.0 * M_PI * h / WINDOW;
+        c[h] += sign * (cexp(-I * w * b) - cexp(-I * w * a)) / (-I * w * WINDOW);
+    }
+}
+
+static void add_edge(double t, int dv)
+{
+    edge_list[edge_count].t = fmod(t, WINDOW);
+    edge_list[edge_count].dv = dv;
+    edge_count++;
+}
+
+/* One leg, high for ccr counts from the period start */
+static void leg(result_t *r, int bridge, double start, uint16_t ccr, int sign)
+{
+    if (ccr == 0) return;
+    double len = ccr >= COUNTS ? COUNTS : ccr;
+
+    add_pulse(r->c[bridge], start, start + len, sign);
+    if (len < COUNTS) {
+        add_edge(start, sign);
+        add_edge(start + len, -sign);
+        r->edges[bridge] += 2;
+    }
+}
+
+static void run(result_t *r, modulation_mode_t mode, bool rotation, float mi,
+                modulation_shape_t shape)
+{
+    modulation_t mod;
+    inverter_duty_t d;
+
+    modulation_init(&mod);
+    modulation_set_shape(&mod, shape, MODULATION_THI_K_DEFAULT);
+    modulation_set_mode(&mod, mode);
+    modulation_set_rotation(&mod, rotation);
+    modulation_set_frequency(&mod, (float)F_OUT);
+    modulation_set_index(&mod, mi);
+    mod.enabled = true;
+
+    double shift = modulation_carrier_shift(&mod);
+    *r = (result_t){0};
+    edge_count = 0;
+
+    for (int k = 0; k < PERIODS; k++) {
+        modulation_calculate_duties(&mod, &d);
+        double t1 = (double)k * COUNTS;
+        double t2 = t1 + shift;     // Wraps into the window start (periodic)
+        leg(r, 0, t1, d.hbridge1.ch1, +1);
+        leg(r, 0, t1, d.hbridge1.ch2, -1);
+        leg(r, 1, t2, d.hbridge2.ch1, +1);
+        leg(r, 1, t2, d.hbridge2.ch2, -1);
+        modulation_update(&mod);
+    }
+
+    // Level jump at any instant: sum of simultaneous edges
+    qsort(edge_list, edge_count, sizeof(edge_t), edge_cmp);
+    r->max_step = 0;
+    for (int i = 0; i < edge_count;) {
+        int j = i, dv = 0;
+        while (j < edge_count && edge_list[j].t == edge_list[i].t) {
+            dv += edge_list[j++].dv;
+        }
+        if (abs(dv) > r->max_step) r->max_step = abs(dv);
+        i = j;
+    }
+}
+
+/* Peak amplitude of harmonic h of the total output (Vdc units) */
+static double amp(const result_t *r, int h)
+{
+    return 2.0 * cabs(r->c[0][h] + r->c[1][h]);
+}
+
+typedef struct {
+    double fund;        // Fundamental peak
+    double first_hz;    // Lowest harmonic above 1% of the fundamental
+    double thd;         // % up to H_MAX
+    double wthd;        // % weighted by 1/h
+    double band1;       // RMS of 1 x fsw +- 1 kHz, % of fundamental
+    double band2;       // RMS of 2 x fsw +- 1 kHz, % of fundamental
+    double p_share;     // Bridge 1 share of the real power (resistive load)
+    double sw_share;    // Bridge 1 share of the gate transitions
+} summary_t;
+
+static summary_t summarize(const result_t *r)
+{
+    summary_t s = {0};
+    double sum = 0.0, wsum = 0.0, b1 = 0.0, b2 = 0.0;
+    const int fsw = PWM_FREQUENCY_HZ / BIN_HZ;
+    const int span = 1000 / BIN_HZ;
+
+    s.fund = amp(r, H_FUND);
+    s.first_hz = -1.0;
+    for (int h = 1; h <= H_MAX; h++) {
+        if (h == H_FUND) continue;
+        double a = amp(r, h);
+        sum += a * a;
+        wsum += (a * H_FUND / h) * (a * H_FUND / h);
+        if (abs(h - fsw) <= span) b1 += a * a;
+        if (abs(h - 2 * fsw) <= span) b2 += a * a;
+        if (s.first_hz < 0.0 && h > H_FUND && a > 0.01 * s.fund) s.first_hz = h * BIN_HZ;
+    }
+    s.thd = 100.0 * sqrt(sum) / s.fund;
+    s.wthd = 100.0 * sqrt(wsum) / s.fund;
+    s.band1 = 100.0 * sqrt(b1) / s.fund;
+    s.band2 = 100.0 * sqrt(b2) / s.fund;
+
+    // Resistive load: current in phase with the total fundamental, so each
+    // bridge's power is its fundamental projected on the total
+    double complex tot = r->c[0][H_FUND] + r->c[1][H_FUND];
+    double p1 = creal(r->c[0][H_FUND] * conj(tot));
+    double p2 = creal(r->c[1][H_FUND] * conj(tot));
+    s.p_share = p1 / (p1 + p2);
+    s.sw_share = (double)r->edges[0] / (double)(r->edges[0] + r->edges[1]);
+    return s;
+}
+
+static summary_t report(const char *name, modulation_mode_t mode, bool rotation,
+                        float mi, result_t *r)
+{
+    run(r, mode, rotation, mi, MODULATION_SHAPE_SINE);
+    summary_t s = summarize(r);
+    double rate = (r->edges[0] + r->edges[1]) / (2.0 / F_OUT) / 8.0;
+    printf("  %-14s MI %.1f: fund %.3f Vdc, first %5.0f Hz, THD %5.1f%%, WTHD %.2f%%, "
+           "fsw band %5.1f%%, 2fsw band %5.1f%%\n"
+           "  %-14s bridge 1: %2.0f%% power %2.0f%% switching, mean device switching %.0f Hz\n",
+           name, mi, s.fund, s.first_hz, s.thd, s.wthd, s.band1, s.band2,
+           "", 100.0 * s.p_share, 100.0 * s.sw_share, rate);
+    return s;
+}
+
+int main(void)
+{
+    static result_t r;
+    modulation_t mod;
+    inverter_duty_t d;
+
+    printf("\n========================================\n");
+    printf("LS vs PS Carrier PWM (fsw = %d Hz, %.0f Hz output)\n", PWM_FREQUENCY_HZ, F_OUT);
+    printf("========================================\n");
+
+    /* Bridge duty mapping: zero reference is zero average, 50% legs */
+    modulation_init(&mod);
+    mod.enabled = true;
+    modulation_set_index(&mod, 0.0f);
+    modulation_calculate_duties(&mod, &d);
+    CHECK(d.hbridge1.ch1 == 0 && d.hbridge1.ch2 == 0 &&
+          d.hbridge2.ch1 == 0 && d.hbridge2.ch2 == 0,
+          "zero reference: idle bridge held low, no switching");
+    modulation_set_index(&mod, 1.0f);
+    mod.phase = 0x40000000u;    // Positive peak
+    modulation_calculate_duties(&mod, &d);
+    CHECK(d.hbridge1.ch1 == COUNTS && d.hbridge1.ch2 == 0 &&
+          d.hbridge2.ch1 == COUNTS && d.hbridge2.ch2 == 0,
+          "full positive level: leg A fully on (compare %u above ARR), leg B off",
+          d.hbridge1.ch1);
+
+    /* Carrier shift per mode */
+    CHECK(modulation_carrier_shift(&mod) == 0, "LS: TIM8 in phase with TIM1");
+    modulation_set_mode(&mod, MODULATION_MODE_PS);
+    CHECK(modulation_carrier_shift(&mod) == COUNTS / 2,
+          "PS: TIM8 offset %u counts (180 deg)", modulation_carrier_shift(&mod));
+
+    /* Rotation flips the bands once per output cycle */
+    modulation_init(&mod);
+    modulation_set_frequency(&mod, (float)F_OUT);
+    int flips = 0;
+    bool last = mod.swapped;
+    for (int k = 0; k < 4 * PWM_FREQUENCY_HZ / 50 + 10; k++) {
+        modulation_update(&mod);
+        flips += (mod.swapped != last);
+        last = mod.swapped;
+    }
+    CHECK(flips == 4, "rotation: %d band swaps over 4 cycles", flips);
+
+    for (int m = 0; m < 2; m++) {
+        float mi = m == 0 ? 0.9f : 0.4f;
+        printf("\n--- MI %.1f ---\n", mi);
+
+        summary_t ls = report("LS fixed", MODULATION_MODE_LS, false, mi, &r);
+        CHECK(r.max_step == 1 && fabs(ls.fund - 2.0 * mi) < 0.02,
+              "LS: single-level steps, fundamental %.3f Vdc", ls.fund);
+        CHECK(ls.p_share > 0.6 && fabs(ls.sw_share - 0.5) > 0.1,
+              "LS without rotation: bridge 1 takes %.0f%% of power, %.0f%% of switching",
+              100.0 * ls.p_share, 100.0 * ls.sw_share);
+
+        summary_t lr = report("LS rotated", MODULATION_MODE_LS, true, mi, &r);
+        CHECK(fabs(lr.p_share - 0.5) < 0.01 && fabs(lr.sw_share - 0.5) < 0.01,
+              "LS rotated: power %.1f%% / switching %.1f%% on bridge 1 over 2 cycles",
+              100.0 * lr.p_share, 100.0 * lr.sw_share);
+        CHECK(fabs(lr.wthd - ls.wthd) < 0.05 * ls.wthd,
+              "LS rotated: spectrum unchanged (WTHD %.2f%% vs %.2f%%)", lr.wthd, ls.wthd);
+
+        summary_t ps = report("PS", MODULATION_MODE_PS, false, mi, &r);
+        CHECK(r.max_step == 1 && fabs(ps.fund - 2.0 * mi) < 0.02,
+              "PS: single-level steps, fundamental %.3f Vdc", ps.fund);
+        CHECK(fabs(ps.p_share - 0.5) < 0.01 && fabs(ps.sw_share - 0.5) < 0.01,
+              "PS: balanced by construction (%.1f%% / %.1f%%)",
+              100.0 * ps.p_share, 100.0 * ps.sw_share);
+        CHECK(ps.band1 < 0.1 * ls.band1 && ps.first_hz > 1.5 * PWM_FREQUENCY_HZ,
+              "PS: fsw band cancelled (%.2f%% vs LS %.2f%%), first harmonic %.0f Hz",
+              ps.band1, ls.band1, ps.first_hz);
+    }
+
+    /* Reference shaping */
+    printf("\n--- Reference shaping (LS, rotated) ---\n");
+
+    modulation_init(&mod);
+    modulation_set_index(&mod, 1.3f);
+    CHECK(mod.modulation_index == 1.0f, "sine: MI clamped to 1.0");
+    CHECK(modulation_set_shape(&mod, MODULATION_SHAPE_THI, 0.6f) != 0,
+          "THI: k above 0.5 rejected");
+    modulation_set_shape(&mod, MODULATION_SHAPE_THI, MODULATION_THI_K_DEFAULT);
+    modulation_set_index(&mod, 1.3f);
+    CHECK(fabsf(modulation_get_max_index(&mod) - 1.1547f) < 0.001f &&
+          mod.modulation_index == modulation_get_max_index(&mod),
+          "THI k = 1/6: MI limit %.4f (2/sqrt(3))", modulation_get_max_index(&mod));
+    modulation_set_shape(&mod, MODULATION_SHAPE_SINE, 0.0f);
+    CHECK(mod.modulation_index == 1.0f, "back to sine: MI clamped to 1.0 again");
+
+    static const struct {
+        const char *name;
+        modulation_shape_t shape;
+    } shapes[] = {
+        { "sine",   MODULATION_SHAPE_SINE },
+        { "THI",    MODULATION_SHAPE_THI },
+        { "min-max", MODULATION_SHAPE_MINMAX },
+        { "NLC",    MODULATION_SHAPE_NLC },
+    };
+    double fund_sine = 0.0;
+
+    for (int k = 0; k < 4; k++) {
+        modulation_init(&mod);
+        modulation_set_shape(&mod, shapes[k].shape, MODULATION_THI_K_DEFAULT);
+        float mi = modulation_get_max_index(&mod);
+
+        run(&r, MODULATION_MODE_LS, true, mi, shapes[k].shape);
+        summary_t s = summarize(&r);
+        double h3 = amp(&r, 3 * H_FUND);
+        printf("  %-8s MI %.3f: fund %.3f Vdc (%+.1f%%), 3rd %.3f Vdc, THD %5.1f%%\n",
+               shapes[k].name, mi, s.fund,
+               fund_sine > 0.0 ? 100.0 * (s.fund / fund_sine - 1.0) : 0.0, h3, s.thd);
+
+        switch (shapes[k].shape) {
+        case MODULATION_SHAPE_SINE:
+            fund_sine = s.fund;
+            break;
+        case MODULATION_SHAPE_THI:
+            CHECK(fabs(s.fund - 2.0 * mi) < 0.01 && s.fund > 1.15 * fund_sine,
+                  "THI: linear up to MI %.3f, fundamental +%.1f%% over sine",
+                  mi, 100.0 * (s.fund / fund_sine - 1.0));
+            CHECK(fabs(h3 - 2.0 * mi * MODULATION_THI_K_DEFAULT) < 0.01,
+                  "THI: injected third harmonic %.3f Vdc (k * fundamental)", h3);
+            break;
+        case MODULATION_SHAPE_MINMAX:
+            CHECK(fabs(s.fund - 2.0 * mi) < 0.01 && s.fund > 1.15 * fund_sine,
+                  "min-max: linear up to MI %.3f, fundamental +%.1f%% over sine",
+                  mi, 100.0 * (s.fund / fund_sine - 1.0));
+            break;
+        case MODULATION_SHAPE_NLC:
+            CHECK(s.fund > 1.15 * fund_sine,
+                  "NLC: staircase fundamental +%.1f%% over sine", 100.0 * (s.fund / fund_sine - 1.0));
+            break;
+        default:  // SHE: test_she
+            break;
+        }
+    }
+
+    /* NLC gates: whole periods on or off, changing at the level steps only */
+    modulation_init(&mod);
+    modulation_set_shape(&mod, MODULATION_SHAPE_NLC, 0.0f);
+    modulation_set_frequency(&mod, (float)F_OUT);
+    modulation_set_index(&mod, MODULATION_MI_MAX_NLC);
+    mod.enabled = true;
+    int partial = 0, toggles = 0, max_jump = 0, prev_level = 0;
+    uint16_t prev_ccr[4] = {0};
+    for (int k = 0; k < PERIODS; k++) {
+        modulation_calculate_duties(&mod, &d);
+        uint16_t ccr[4] = { d.hbridge1.ch1, d.hbridge1.ch2, d.hbridge2.ch1, d.hbridge2.ch2 };
+        for (int j = 0; j < 4; j++) {
+            partial += (ccr[j] != 0 && ccr[j] != COUNTS);
+            toggles += (k > 0 && ccr[j] != prev_ccr[j]);
+            prev_ccr[j] = ccr[j];
+        }
+        int level = (ccr[0] - ccr[1] + ccr[2] - ccr[3]) / COUNTS;
+        if (k > 0 && abs(level - prev_level) > max_jump) max_jump = abs(level - prev_level);
+        prev_level = level;
+        modulation_update(&mod);
+    }
+    CHECK(partial == 0 && max_jump == 1,
+          "NLC: legs fully on or off, single-level steps");
+    CHECK(toggles <= 8 * 2, "NLC: %d leg transitions over 2 cycles (fundamental switching)",
+          toggles);
+
+    printf("\n========================================\n");
+    if (failures == 0) {
+        printf("*** ALL TESTS PASSED! ***\n");
+    } else {
+        printf("*** %d TEST(S) FAILED ***\n", failures);
+    }
+    printf("========================================\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,277 @@
+/**
+ * @file test_she.c
+ * @brief Host tests and plant comparison for the SHE / NLC staircase modes
+ *
+ * - Generated table (she_angles.h): every entry gives its grid MI and
+ *   zero 5th/7th harmonics, angles ascending inside the quarter wave,
+ *   THD (odd 3..49) within SHE_THD_MAX, one branch from end to end
+ * - SHE MI limit, no output below the table range
+ * - Plant: both H-bridges at timer-count resolution into an RL load
+ *   (R = 20 ohm, L = 10 mH, 2 x 50 V) with the duties of the real
+ *   modulator, comparing LS / PS carrier PWM with the NLC and SHE
+ *   staircases at two high-power operating points: output voltage and
+ *   current THD, 3rd/5th/7th, device switching rate and switching loss
+ *   (0.5 * Vdc * |i| * (tr + tf) per leg transition). The staircases
+ *   trade low-order THD (single phase: the 3rd is not eliminated) for
+ *   an order of magnitude less switching
+ *
+ * Plant model: plant_sim.c
+ *
+ * Build/run: make test
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-25
+ */
+
+#include "multilevel_modulation.h"
+#include "she_angles.h"
+#include "plant_sim.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define T_SWITCH        200e-9                  // tr + tf per transition
+#define SETTLE_PERIODS  300                     // 3 output cycles
+#define MEAS_PERIODS    200                     // 2 output cycles
+#define H_MAX           49
+#define BRANCH_STEP_RAD 0.05                    // Max angle change per grid step
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (cond) {                                         \
+            printf("[PASS] " __VA_ARGS__);                  \
+        } else {                                            \
+            printf("[FAIL] " __VA_ARGS__);                  \
+            failures++;                                     \
+        }                                                   \
+        printf("\n");                                       \
+    } while (0)
+
+/*---------------------------------------------------------------------------
+ * Plant simulation
+ *-------------------------------------------------------------------------*/
+
+typedef struct {
+    const char *name;
+    modulation_mode_t mode;
+    modulation_shape_t shape;
+} run_mode_t;
+
+typedef struct {
+    double v1;              // Fundamental output voltage, peak (V)
+    double v_thd;           // Voltage THD, h2..H_MAX
+    double i_thd;           // Current THD, h2..H_MAX
+    double v3, v5, v7;      // 3rd / 5th / 7th relative to the fundamental
+    double f_sw;            // Transitions per leg per second
+    double p_sw;            // Switching loss, all legs (W)
+} sim_result_t;
+
+static sim_result_t simulate(const run_mode_t *rm, float mi)
+{
+    modulation_t mod;
+    inverter_duty_t pending;
+    plant_bridges_t br;
+    plant_rl_t rl;
+    plant_dft_t dft;
+    int gate[4] = {0};
+
+    modulation_init(&mod);
+    modulation_set_shape(&mod, rm->shape, MODULATION_THI_K_DEFAULT);
+    modulation_set_index(&mod, mi);
+    modulation_set_frequency(&mod, (float)F1);
+    modulation_set_mode(&mod, rm->mode);
+    modulation_set_rotation(&mod, true);
+    mod.enabled = true;
+    memset(&pending, 0, sizeof(pending));
+
+    plant_bridges_init(&br, modulation_carrier_shift(&mod));
+    plant_rl_init(&rl, R_LOAD, L_LOAD, T_STEP);
+    plant_dft_init(&dft, F1, H_MAX, T_STEP);
+
+    double e_sw = 0.0;
+    long transitions = 0;
+
+    for (int p = 0; p < SETTLE_PERIODS + MEAS_PERIODS; p++) {
+        // TIM1 update: preloaded duties take effect, ISR computes the next
+        plant_bridges_tim1_update(&br, &pending);
+        modulation_calculate_duties(&mod, &pending);
+        modulation_update(&mod);
+
+        for (int s = 0; s < STEPS; s++) {
+            plant_bridges_step(&br, s, &pending);
+
+            int g[4];
+            for (int k = 0; k < 4; k++) {
+                g[k] = plant_bridges_gate(&br, k);
+                if (g[k] != gate[k] && p >= SETTLE_PERIODS) {
+                    transitions++;
+                    e_sw += 0.5 * VDC * fabs(rl.i) * T_SWITCH;
+                }
+                gate[k] = g[k];
+            }
+
+            double v = VDC * (g[0] - g[1] + g[2] - g[3]);
+            double i = plant_rl_step(&rl, v);
+
+            if (p >= SETTLE_PERIODS) {
+                plant_dft_add(&dft, i, v);
+            }
+        }
+    }
+
+    sim_result_t r;
+    double vh[H_MAX + 1], isum = 0.0, vsum = 0.0;
+    for (int h = 1; h <= H_MAX; h++) {
+        vh[h] = plant_dft_peak(&dft, PLANT_DFT_V, h);
+        if (h > 1) {
+            double ih = plant_dft_peak(&dft, PLANT_DFT_I, h);
+            isum += ih * ih;
+            vsum += vh[h] * vh[h];
+        }
+    }
+    double t_meas = MEAS_PERIODS / (double)PWM_FREQUENCY_HZ;
+    r.v1 = vh[1];
+    r.v_thd = sqrt(vsum) / vh[1];
+    r.i_thd = sqrt(isum) / plant_dft_peak(&dft, PLANT_DFT_I, 1);
+    r.v3 = vh[3] / vh[1];
+    r.v5 = vh[5] / vh[1];
+    r.v7 = vh[7] / vh[1];
+    r.f_sw = transitions / 4.0 / t_meas;
+    r.p_sw = e_sw / t_meas;
+    return r;
+}
+
+/*---------------------------------------------------------------------------
+ * Tests
+ *-------------------------------------------------------------------------*/
+
+int main(void)
+{
+    modulation_t mod;
+    inverter_duty_t d;
+
+    printf("\n========================================\n");
+    printf("SHE / NLC Staircase Test (%d entries, MI %.3f..%.3f)\n",
+           SHE_TABLE_SIZE, SHE_MI_MIN, SHE_MI_MAX);
+    printf("========================================\n");
+
+    /* Generated table */
+    double worst_mi = 0.0, worst_h = 0.0, worst_thd = 0.0, worst_step = 0.0;
+    int ordered = 1, one_pattern = 1;
+    for (int k = 0; k < SHE_TABLE_SIZE; k++) {
+        const she_entry_t *e = &she_table[k];
+        double f1 = 0.0, f5 = 0.0, f7 = 0.0;
+        for (int j = 0; j < SHE_ANGLES; j++) {
+            f1 += e->sign[j] * cos(e->alpha[j]);
+            f5 += e->sign[j] * cos(SHE_HARMONIC_A * e->alpha[j]);
+            f7 += e->sign[j] * cos(SHE_HARMONIC_B * e->alpha[j]);
+            if (e->alpha[j] <= 0.0f || e->alpha[j] >= (float)(M_PI / 2.0) ||
+                (j > 0 && e->alpha[j] <= e->alpha[j - 1])) {
+                ordered = 0;
+            }
+            if (k > 0) {
+                const she_entry_t *p = &she_table[k - 1];
+                if (e->sign[j] != p->sign[j]) one_pattern = 0;
+                if (fabs(e->alpha[j] - p->alpha[j]) > worst_step) {
+                    worst_step = fabs(e->alpha[j] - p->alpha[j]);
+                }
+            }
+        }
+        double hsum = 0.0;
+        for (int n = 3; n <= H_MAX; n += 2) {
+            double bn = 0.0;
+            for (int j = 0; j < SHE_ANGLES; j++) bn += e->sign[j] * cos(n * e->alpha[j]);
+            hsum += (bn / n) * (bn / n);
+        }
+        if (100.0 * sqrt(hsum) / fabs(f1) > worst_thd) worst_thd = 100.0 * sqrt(hsum) / fabs(f1);
+        double mi = SHE_MI_MIN + k * SHE_MI_STEP;
+        if (fabs(2.0 / M_PI * f1 - mi) > worst_mi) worst_mi = fabs(2.0 / M_PI * f1 - mi);
+        if (fabs(f5) > worst_h) worst_h = fabs(f5);
+        if (fabs(f7) > worst_h) worst_h = fabs(f7);
+    }
+    CHECK(ordered, "table: angles ascending within (0, pi/2)");
+    CHECK(worst_mi < 1e-5, "table: fundamental matches the MI grid (max error %.1e)", worst_mi);
+    CHECK(worst_h < 1e-5, "table: h%d and h%d eliminated (max residual %.1e)",
+          SHE_HARMONIC_A, SHE_HARMONIC_B, worst_h);
+    CHECK(worst_thd <= SHE_THD_MAX, "table: THD %.1f%% at worst (limit %.0f%%)",
+          worst_thd, SHE_THD_MAX);
+    CHECK(one_pattern && worst_step < BRANCH_STEP_RAD,
+          "table: one continuous branch (max step %.3f rad per grid point)", worst_step);
+
+    /* Limits */
+    modulation_init(&mod);
+    CHECK(modulation_set_shape(&mod, MODULATION_SHAPE_SHE, 0.0f) == 0 &&
+          fabsf(modulation_get_max_index(&mod) - SHE_MI_MAX) < 1e-6f,
+          "SHE: MI limit from the table (%.3f)", modulation_get_max_index(&mod));
+    modulation_set_index(&mod, 1.2f);
+    CHECK(fabsf(mod.modulation_index - SHE_MI_MAX) < 1e-6f, "SHE: MI clamped to the table");
+    CHECK(modulation_set_shape(&mod, (modulation_shape_t)(MODULATION_SHAPE_SHE + 1), 0.0f) != 0,
+          "unknown shape rejected");
+
+    mod.enabled = true;
+    modulation_set_index(&mod, 0.5f * SHE_MI_MIN);
+    int quiet = 1;
+    for (int k = 0; k < 100; k++) {
+        modulation_calculate_duties(&mod, &d);
+        quiet &= (d.hbridge1.ch1 == 0 && d.hbridge1.ch2 == 0 &&
+                  d.hbridge2.ch1 == 0 && d.hbridge2.ch2 == 0);
+        modulation_update(&mod);
+    }
+    CHECK(quiet, "SHE: no output below SHE_MI_MIN");
+
+    /* Plant comparison */
+    static const run_mode_t modes[] = {
+        { "LS PWM", MODULATION_MODE_LS, MODULATION_SHAPE_SINE },
+        { "PS PWM", MODULATION_MODE_PS, MODULATION_SHAPE_SINE },
+        { "NLC",    MODULATION_MODE_LS, MODULATION_SHAPE_NLC },
+        { "SHE",    MODULATION_MODE_LS, MODULATION_SHAPE_SHE },
+    };
+    static const float points[] = { 0.9f, 0.7f };
+    const int n_modes = sizeof(modes) / sizeof(modes[0]);
+    const int n_points = sizeof(points) / sizeof(points[0]);
+    sim_result_t res[2][4];
+
+    printf("\nRL load %.0f ohm / %.0f mH, 2 x %.0f V, %d Hz carrier, THD over h2..h%d\n",
+           R_LOAD, L_LOAD * 1e3, VDC, PWM_FREQUENCY_HZ, H_MAX);
+    printf("Switching loss at %.0f ns per transition\n\n", T_SWITCH * 1e9);
+    printf("%-4s %-7s | %6s | %6s %6s | %5s %5s %5s | %8s | %7s\n", "MI", "Mode", "V1 (V)",
+           "V THD", "I THD", "V3", "V5", "V7", "f_sw/leg", "P_sw");
+
+    for (int m = 0; m < n_points; m++) {
+        for (int k = 0; k < n_modes; k++) {
+            sim_result_t *r = &res[m][k];
+            *r = simulate(&modes[k], points[m]);
+            printf("%-4.2f %-7s | %6.1f | %5.1f%% %5.2f%% | %4.1f%% %4.1f%% %4.1f%% | %5.0f Hz | %5.2f W\n",
+                   points[m], modes[k].name, r->v1, r->v_thd * 100.0, r->i_thd * 100.0,
+                   r->v3 * 100.0, r->v5 * 100.0, r->v7 * 100.0, r->f_sw, r->p_sw);
+        }
+        printf("\n");
+    }
+
+    for (int m = 0; m < n_points; m++) {
+        const sim_result_t *ls = &res[m][0];
+        const sim_result_t *she = &res[m][3];
+        double v1_ideal = 2.0 * VDC * points[m];
+
+        CHECK(fabs(she->v1 - v1_ideal) < 0.02 * v1_ideal,
+              "MI %.2f SHE: fundamental %.1f V (%.1f V expected)", points[m], she->v1, v1_ideal);
+        CHECK(she->v5 < 0.01 && she->v7 < 0.01,
+              "MI %.2f SHE: h5 %.2f%%, h7 %.2f%% of the fundamental",
+              points[m], she->v5 * 100.0, she->v7 * 100.0);
+        CHECK(she->v5 < 0.2 * res[m][2].v5 || she->v7 < 0.2 * res[m][2].v7,
+              "MI %.2f SHE: lower 5th/7th than NLC", points[m]);
+        CHECK(she->p_sw < 0.1 * ls->p_sw,
+              "MI %.2f SHE: switching loss %.2f W vs %.2f W LS PWM", points[m], she->p_sw, ls->p_sw);
+    }
+
+    printf("\n========================================\n");
+    if (failures == 0) {
+        printf("*** ALL TESTS PASSED! ***\n");
+    } else {
+        printf("*** %d TEST(S) FAILED ***\n", failures);
+    }
+    printf("========================================\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+/**
+ * @file test_sogi_pll.c
+ * @brief Host harness for the SOGI-PLL (float and fixed point)
+ *
+ * Runs both variants at 5 kHz against a synthetic 230 V grid:
+ * - Startup:   lock from an unknown phase
+ * - Freq step: 50 -> 51.5 Hz
+ * - Phase jump: +40 deg
+ * - Distorted: 5% 3rd, 4% 5th, 3% 7th, 2% 11th, 1% DC offset
+ * Reports lock time (phase error below 2 deg for good), lock flag time,
+ * steady-state phase error and frequency ripple, and the per-sample cost
+ * on the host.
+ *
+ * Build/run: make test
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-22
+ */
+
+#include "sogi_pll.h"
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define FS          5000.0
+#define V_PEAK      325.0
+#define DEG         (M_PI / 180.0)
+#define SETTLED     (2.0 * DEG)
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (cond) {                                         \
+            printf("[PASS] " __VA_ARGS__);                  \
+        } else {                                            \
+            printf("[FAIL] " __VA_ARGS__);                  \
+            failures++;                                     \
+        }                                                   \
+        printf("\n");                                       \
+    } while (0)
+
+/*---------------------------------------------------------------------------
+ * Variant wrapper
+ *-------------------------------------------------------------------------*/
+
+typedef struct {
+    int fixed;
+    sogi_pll_t f;
+    sogi_pll_q_t q;
+} pll_under_test_t;
+
+static void put_init(pll_under_test_t *p, int fixed)
+{
+    p->fixed = fixed;
+    if (fixed) {
+        sogi_pll_q_init(&p->q, (float)FS, 50.0f);
+    } else {
+        sogi_pll_init(&p->f, (float)FS, 50.0f, (float)V_PEAK);
+    }
+}
+
+/* Returns the phase for the next sample in rad */
+static double put_update(pll_under_test_t *p, double v)
+{
+    if (p->fixed) {
+        double pu = v / V_PEAK * 16384.0;
+        int16_t q = (int16_t)(pu > 32767.0 ? 32767 : (pu < -32768.0 ? -32768 : lrint(pu)));
+        return sogi_pll_q_update(&p->q, q) * (2.0 * M_PI / 4294967296.0);
+    }
+    return sogi_pll_update(&p->f, (float)v);
+}
+
+static double put_freq(const pll_under_test_t *p)
+{
+    return p->fixed ? sogi_pll_q_get_frequency(&p->q) : sogi_pll_get_frequency(&p->f);
+}
+
+static int put_locked(const pll_under_test_t *p)
+{
+    return p->fixed ? sogi_pll_q_is_locked(&p->q) : sogi_pll_is_locked(&p->f);
+}
+
+/*---------------------------------------------------------------------------
+ * Scenarios
+ *-------------------------------------------------------------------------*/
+
+typedef struct {
+    const char *name;
+    double t_event;         // Disturbance time (s)
+    double f0, f1;          // Frequency before/after
+    double jump;            // Phase jump at t_event (rad)
+    double phase0;          // Initial grid phase (rad)
+    int distorted;
+    double max_lock_ms;     // Required settling after the event
+    double max_ss_deg;      // Required steady-state phase error
+    double max_ss_hz;       // Allowed instantaneous frequency ripple
+} scenario_t;
+
+typedef struct {
+    double lock_ms;         // Last time |phase error| >= SETTLED, after the event
+    double flag_ms;         // Lock flag set (after the event, 0 = never lost)
+    double ss_deg;          // Max |phase error| over the last 0.2 s
+    double ss_hz;           // Max |frequency error| over the last 0.2 s
+} result_t;
+
+static double wrap(double x)
+{
+    while (x > M_PI) x -= 2.0 * M_PI;
+    while (x < -M_PI) x += 2.0 * M_PI;
+    return x;
+}
+
+static double grid(const scenario_t *sc, double theta)
+{
+    double v = sin(theta);
+    if (sc->distorted) {
+        v += 0.05 * sin(3.0 * theta + 0.3) + 0.04 * sin(5.0 * theta - 0.5) +
+             0.03 * sin(7.0 * theta) + 0.02 * sin(11.0 * theta + 1.0) + 0.01;
+    }
+    return V_PEAK * v;
+}
+
+static result_t run(const scenario_t *sc, int fixed)
+{
+    const double t_end = sc->t_event + 0.6;
+    const int n_end = (int)(t_end * FS);
+    pll_under_test_t p;
+    result_t r = {0.0, -1.0, 0.0, 0.0};
+    double theta = sc->phase0;
+    int last_bad = (int)(sc->t_event * FS);
+
+    put_init(&p, fixed);
+
+    for (int n = 0; n < n_end; n++) {
+        double t = n / FS;
+        double f = (t < sc->t_event) ? sc->f0 : sc->f1;
+
+        if (n == (int)(sc->t_event * FS)) {
+            theta += sc->jump;
+        }
+
+        double next = put_update(&p, grid(sc, theta));
+        theta += 2.0 * M_PI * f / FS;
+
+        // PLL phase for sample n+1 against the grid phase of sample n+1
+        double err = fabs(wrap(next - theta));
+        if (t >= sc->t_event) {
+            if (err >= SETTLED) {
+                last_bad = n;
+            }
+            if (put_locked(&p) && r.flag_ms < 0.0) {
+                r.flag_ms = (t - sc->t_event) * 1e3;
+            } else if (!put_locked(&p)) {
+                r.flag_ms = -1.0;
+            }
+        }
+        if (t >= t_end - 0.2) {
+            r.ss_deg = fmax(r.ss_deg, err / DEG);
+            r.ss_hz = fmax(r.ss_hz, fabs(put_freq(&p) - f));
+        }
+    }
+
+    r.lock_ms = (last_bad + 1) / FS * 1e3 - sc->t_event * 1e3;
+    return r;
+}
+
+/*---------------------------------------------------------------------------
+ * Cost
+ *-------------------------------------------------------------------------*/
+
+static double ns_per_sample(int fixed)
+{
+    const int n = 2000000;
+    pll_under_test_t p;
+    volatile double sink = 0.0;
+    struct timespec a, b;
+
+    put_init(&p, fixed);
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    for (int k = 0; k < n; k++) {
+        double v = (k & 1) ? V_PEAK * 0.5 : -V_PEAK * 0.25;
+        if (fixed) {
+            sink += sogi_pll_q_update(&p.q, (int16_t)(v / V_PEAK * 16384.0));
+        } else {
+            sink += sogi_pll_update(&p.f, (float)v);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    (void)sink;
+    return ((b.tv_sec - a.tv_sec) * 1e9 + (b.tv_nsec - a.tv_nsec)) / n;
+}
+
+int main(void)
+{
+    static const scenario_t scenarios[] = {
+        {"startup",    0.0, 50.0, 50.0, 0.0,        2.0,  0, 150.0, 0.2, 0.02},
+        {"freq step",  0.5, 50.0, 51.5, 0.0,        0.0,  0, 150.0, 0.2, 0.02},
+        {"phase jump", 0.5, 50.0, 50.0, 40.0 * DEG, 0.0,  0, 120.0, 0.2, 0.02},
+        {"distorted",  0.0, 50.0, 50.0, 0.0,        1.0,  1, 200.0, 1.5, 1.5},
+    };
+    const int n_sc = sizeof(scenarios) / sizeof(scenarios[0]);
+    sogi_pll_t bad;
+
+    printf("\n========================================\n");
+    printf("SOGI-PLL Test (fs = %.0f Hz)\n", FS);
+    printf("========================================\n");
+
+    CHECK(sogi_pll_init(&bad, 5000.0f, 2000.0f, 325.0f) != 0 &&
+          sogi_pll_init(&bad, 5000.0f, 50.0f, 0.0f) != 0,
+          "invalid configuration rejected");
+
+    for (int fixed = 0; fixed <= 1; fixed++) {
+        printf("\n--- %s ---\n", fixed ? "Fixed point (Q24/32-bit phase)" : "Float");
+        for (int s = 0; s < n_sc; s++) {
+            const scenario_t *sc = &scenarios[s];
+            result_t r = run(sc, fixed);
+            CHECK(r.lock_ms <= sc->max_lock_ms && r.ss_deg <= sc->max_ss_deg &&
+                  r.ss_hz <= sc->max_ss_hz && r.flag_ms >= 0.0,
+                  "%-10s lock %6.1f ms (flag %6.1f ms), ss phase %.3f deg, ss freq %.4f Hz",
+                  sc->name, r.lock_ms, r.flag_ms, r.ss_deg, r.ss_hz);
+        }
+    }
+
+    /* Loss of input drops the lock flag */
+    pll_under_test_t p;
+    put_init(&p, 0);
+    for (int n = 0; n < (int)(0.5 * FS); n++) {
+        put_update(&p, V_PEAK * sin(2.0 * M_PI * 50.0 * n / FS));
+    }
+    int was_locked = put_locked(&p);
+    for (int n = 0; n < (int)(0.2 * FS); n++) {
+        put_update(&p, 0.0);
+    }
+    CHECK(was_locked && !put_locked(&p), "lock flag drops when the input disappears");
+
+    /* Fixed-point sine table accuracy */
+    double worst = 0.0;
+    for (uint32_t k = 0; k < 65536; k++) {
+        uint32_t ph = k * 65536u + 12345u;
+        double ref = 32767.0 * sin(ph * (2.0 * M_PI / 4294967296.0));
+        worst = fmax(worst, fabs(sogi_pll_q_sin(ph) - ref));
+    }
+    CHECK(worst < 4.0, "Q15 interpolated sine error %.2f LSB", worst);
+
+    double ns_f = ns_per_sample(0);
+    double ns_q = ns_per_sample(1);
+    printf("\nPer-sample cost (host): float %.1f ns, fixed %.1f ns "
+           "(%.1f%% / %.1f%% of a %.0f us period)\n",
+           ns_f, ns_q, ns_f / 2000.0, ns_q / 2000.0, 1e6 / FS);
+
+    printf("\n========================================\n");
+    if (failures == 0) {
+        printf("*** ALL TESTS PASSED! ***\n");
+    } else {
+        printf("*** %d TEST(S) FAILED ***\n", failures);
+    }
+    printf("========================================\n");
+    return failures == 0 ? 0 : 1;
+}
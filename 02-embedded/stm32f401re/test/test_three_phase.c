@@ -0,0 +1,235 @@
+/**
+ * @file test_three_phase.c
+ * @brief Host tests for the three-phase duty computation
+ *
+ * - Phase a of modulation_calculate_duties_3ph() is bit-exact with
+ *   modulation_calculate_duties() (sine, NLC, SHE; LS with band rotation
+ *   and PS) over three output cycles
+ * - Phases b and c are bit-exact with a single-phase modulator started
+ *   at -120 / +120 deg, including the LS band rotation at their own zero
+ *   crossings
+ * - THI and min-max just below their MI limit: the zero sequence is the same in
+ *   all three phases, so the line-to-line voltage is free of triplens
+ *   while each phase carries it; peak within the five levels and the
+ *   line-to-line fundamental sqrt(3) x the phase fundamental
+ * - Disabled output and invalid arguments
+ *
+ * Build/run: make test
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+#include "multilevel_modulation.h"
+#include "sine_lut.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define F1              50.0f
+#define PERIODS         (3 * PWM_FREQUENCY_HZ / 50)     // Three output cycles
+#define CYCLE           (PWM_FREQUENCY_HZ / 50)         // Periods per output cycle
+#define H_MAX           9
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (cond) {                                         \
+            printf("[PASS] " __VA_ARGS__);                  \
+        } else {                                            \
+            printf("[FAIL] " __VA_ARGS__);                  \
+            failures++;                                     \
+        }                                                   \
+        printf("\n");                                       \
+    } while (0)
+
+/* Phase of phases b and c relative to phase a */
+static const uint32_t offset[MODULATION_PHASES] = { 0u, 0xAAAAAAABu, 0x55555555u };
+
+/* The modulator's fundamental table */
+static const float sine_lut[SINE_TABLE_SIZE] = SINE_LUT_200;
+
+static float table_sine(uint32_t phase)
+{
+    return sine_lut[(uint32_t)(((uint64_t)phase * SINE_TABLE_SIZE) >> 32)];
+}
+
+static void setup(modulation_t *mod, modulation_mode_t mode, modulation_shape_t shape, float mi)
+{
+    modulation_init(mod);
+    modulation_set_shape(mod, shape, MODULATION_THI_K_DEFAULT);
+    modulation_set_index(mod, mi);
+    modulation_set_frequency(mod, F1);
+    modulation_set_mode(mod, mode);
+    modulation_set_rotation(mod, true);
+    mod->enabled = true;
+}
+
+static int duty_equal(const inverter_duty_t *a, const inverter_duty_t *b)
+{
+    return a->hbridge1.ch1 == b->hbridge1.ch1 && a->hbridge1.ch2 == b->hbridge1.ch2 &&
+           a->hbridge2.ch1 == b->hbridge2.ch1 && a->hbridge2.ch2 == b->hbridge2.ch2;
+}
+
+/* Average output of one phase over the period (nominal Vdc units, -2..+2) */
+static double phase_volts(const inverter_duty_t *d)
+{
+    return ((double)d->hbridge1.ch1 - d->hbridge1.ch2 +
+            (double)d->hbridge2.ch1 - d->hbridge2.ch2) / PWM_COUNTS;
+}
+
+/*---------------------------------------------------------------------------
+ * Single-phase equivalence
+ *-------------------------------------------------------------------------*/
+
+typedef struct {
+    const char *name;
+    modulation_mode_t mode;
+    modulation_shape_t shape;
+    float mi;
+} run_t;
+
+static const run_t runs[] = {
+    { "LS sine",  MODULATION_MODE_LS, MODULATION_SHAPE_SINE, 0.9f },
+    { "PS sine",  MODULATION_MODE_PS, MODULATION_SHAPE_SINE, 0.9f },
+    { "LS NLC",   MODULATION_MODE_LS, MODULATION_SHAPE_NLC,  1.2f },
+    { "LS SHE",   MODULATION_MODE_LS, MODULATION_SHAPE_SHE,  1.0f },
+};
+
+static void test_equivalence(const run_t *r)
+{
+    modulation_t mod, ref[MODULATION_PHASES];
+    inverter_duty_3ph_t d3;
+    inverter_duty_t d1;
+    int mismatch[MODULATION_PHASES] = {0};
+
+    setup(&mod, r->mode, r->shape, r->mi);
+    for (int k = 0; k < MODULATION_PHASES; k++) {
+        setup(&ref[k], r->mode, r->shape, r->mi);
+        modulation_sync(&ref[k], offset[k], F1);
+    }
+
+    for (int p = 0; p < PERIODS; p++) {
+        modulation_calculate_duties_3ph(&mod, &d3);
+        modulation_update(&mod);
+        for (int k = 0; k < MODULATION_PHASES; k++) {
+            modulation_calculate_duties(&ref[k], &d1);
+            modulation_update(&ref[k]);
+            if (!duty_equal(&d1, &d3.phase[k])) mismatch[k]++;
+        }
+    }
+
+    CHECK(mismatch[0] == 0, "%s: phase a bit-exact with the single-phase modulator", r->name);
+    CHECK(mismatch[1] == 0 && mismatch[2] == 0,
+          "%s: phases b, c bit-exact at -120 / +120 deg (%d, %d periods differ)",
+          r->name, mismatch[1], mismatch[2]);
+}
+
+/*---------------------------------------------------------------------------
+ * Zero-sequence injection
+ *-------------------------------------------------------------------------*/
+
+/* Amplitude of harmonic h of one output cycle of per-period samples */
+static double harmonic(const double *v, int h)
+{
+    double re = 0.0, im = 0.0;
+    for (int n = 0; n < CYCLE; n++) {
+        double th = 2.0 * M_PI * h * n / CYCLE;
+        re += v[n] * cos(th);
+        im += v[n] * sin(th);
+    }
+    return 2.0 * sqrt(re * re + im * im) / CYCLE;
+}
+
+static void test_zero_sequence(const char *name, modulation_shape_t shape)
+{
+    modulation_t mod;
+    inverter_duty_3ph_t d3;
+    double va[CYCLE], vab[CYCLE];
+    double peak = 0.0, zs_spread = 0.0;
+
+    // Just below the limit: the 200-point table samples phases b and c
+    // up to one step late against the common sin(3x), which lifts their
+    // THI peak by up to 1%
+    setup(&mod, MODULATION_MODE_LS, shape, 2.0f);
+    float mi_max = mod.modulation_index;
+    float mi = 0.98f * mi_max;
+    modulation_set_index(&mod, mi);
+    mod.phase_step = (uint32_t)(4294967296.0 / CYCLE);     // Whole cycle in CYCLE periods
+
+    for (int n = 0; n < CYCLE; n++) {
+        uint32_t phase = mod.phase;
+        modulation_calculate_duties_3ph(&mod, &d3);
+        modulation_update(&mod);
+
+        double v[MODULATION_PHASES];
+        for (int k = 0; k < MODULATION_PHASES; k++) {
+            v[k] = phase_volts(&d3.phase[k]);
+            if (fabs(v[k]) > peak) peak = fabs(v[k]);
+        }
+        va[n] = v[0];
+        vab[n] = v[0] - v[1];
+
+        // Phase voltage minus its own (tabulated) fundamental is the zero
+        // sequence: the same in all three phases, up to the duty rounding
+        double s[MODULATION_PHASES];
+        for (int k = 0; k < MODULATION_PHASES; k++) {
+            s[k] = v[k] - 2.0 * mi * table_sine(phase + offset[k]);
+        }
+        double spread = fmax(fabs(s[0] - s[1]), fmax(fabs(s[1] - s[2]), fabs(s[0] - s[2])));
+        if (spread > zs_spread) zs_spread = spread;
+    }
+
+    double a1 = harmonic(va, 1), ab1 = harmonic(vab, 1);
+    double a3 = harmonic(va, 3), ab3 = 0.0;
+    for (int h = 3; h <= H_MAX; h += 3) ab3 = fmax(ab3, harmonic(vab, h));
+
+    printf("  %s, MI %.3f: phase 1st %.3f 3rd %.3f, line 1st %.3f triplens %.5f, "
+           "peak %.3f, zs spread %.4f\n", name, mi, a1, a3, ab1, ab3, peak, zs_spread);
+
+    CHECK(mi_max > 1.15f, "%s: MI limit above 1.15", name);
+    CHECK(peak > 1.9 && peak <= 2.0, "%s: phase peak within the five levels near the MI limit", name);
+    CHECK(fabs(a1 - 2.0 * mi) < 0.01 * 2.0 * mi, "%s: phase fundamental 2 x MI", name);
+    CHECK(zs_spread < 4.0 / PWM_COUNTS, "%s: same zero sequence in all three phases", name);
+    CHECK(a3 > 0.1 * a1 && ab3 < 1e-3 * ab1, "%s: triplens in the phase, not line-to-line", name);
+    CHECK(fabs(ab1 - sqrt(3.0) * a1) < 0.01 * ab1, "%s: line fundamental sqrt(3) x phase", name);
+}
+
+/*---------------------------------------------------------------------------
+ * Main
+ *-------------------------------------------------------------------------*/
+
+int main(void)
+{
+    printf("\n=== Three-phase modulator ===\n");
+
+    for (size_t i = 0; i < sizeof(runs) / sizeof(runs[0]); i++) {
+        test_equivalence(&runs[i]);
+    }
+
+    test_zero_sequence("THI", MODULATION_SHAPE_THI);
+    test_zero_sequence("min-max", MODULATION_SHAPE_MINMAX);
+
+    modulation_t mod;
+    inverter_duty_3ph_t d3;
+    modulation_init(&mod);
+    memset(&d3, 0, sizeof(d3));
+    modulation_calculate_duties_3ph(&mod, &d3);
+    int idle = 1;
+    for (int k = 0; k < MODULATION_PHASES; k++) {
+        idle &= d3.phase[k].hbridge1.ch1 == PWM_PERIOD / 2 && d3.phase[k].hbridge2.ch2 == PWM_PERIOD / 2;
+    }
+    CHECK(idle, "disabled: all six bridges at zero output");
+    CHECK(modulation_calculate_duties_3ph(NULL, &d3) != 0 &&
+          modulation_calculate_duties_3ph(&mod, NULL) != 0, "NULL arguments rejected");
+
+    printf("\n========================================\n");
+    if (failures == 0) {
+        printf("*** ALL TESTS PASSED! ***\n");
+    } else {
+        printf("*** %d TEST(S) FAILED ***\n", failures);
+    }
+    printf("========================================\n");
+    return failures == 0 ? 0 : 1;
+}
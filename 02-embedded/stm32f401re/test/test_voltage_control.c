@@ -0,0 +1,319 @@
+/**
+ * @file test_voltage_control.c
+ * @brief Host tests and load-step simulation for the cascaded voltage loop
+ *
+ * - PR back-calculation: the resonant output stays at the limit under a
+ *   sustained error instead of winding up
+ * - PR preset continues the loaded sinusoid
+ * - Gain changes do not step either loop's output
+ * - Plant: both H-bridges at timer-count resolution (real modulator via
+ *   modulation_calculate_duties_ref, one period actuation delay) into the
+ *   output filter (500 uH + 10 uF, 10 ohm + 1 uF damping) with a
+ *   resistive load, 2 x 50 V. The controller sees the period average of
+ *   v and i, as from the oversampled ADC.
+ *   Open loop at MI 0.7, bumpless engage of the cascade, then load steps
+ *   50 -> 25 -> 50 ohm, a gain change, and an unreachable reference
+ *   (100 V RMS) that saturates both loops, with and without anti-windup
+ *
+ * Build/run: make test
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-26
+ */
+
+#include "voltage_control.h"
+#include "multilevel_modulation.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define VDC             50.0
+#define F1              50.0
+#define L_FILTER        500e-6
+#define R_FILTER        0.1                     // Inductor + switch resistance
+#define C_FILTER        10e-6
+#define R_DAMP          10.0                    // RC damping branch across C
+#define C_DAMP          1e-6
+#define R_LOAD_LIGHT    50.0
+#define R_LOAD_HEAVY    25.0
+#define V_RMS_REF       50.0f
+#define STEP            4                       // Plant step in timer counts
+#define PERIOD_COUNTS   (PWM_PERIOD + 1)
+#define STEPS           (PERIOD_COUNTS / STEP)
+#define T_STEP          ((double)STEP / SYSTEM_CLOCK_HZ)
+#define PERIODS_PER_CYCLE (PWM_FREQUENCY_HZ / 50)
+#define CYCLES          80
+
+/* Scenario, in output cycles */
+#define ENGAGE_PERIOD   (5 * PERIODS_PER_CYCLE + 37)  // Mid-cycle
+#define LOAD_ON_CYCLE   20
+#define LOAD_OFF_CYCLE  35
+#define GAIN_CYCLE      50
+#define REF_HIGH_CYCLE  60
+#define REF_BACK_CYCLE  70
+#define V_RMS_HIGH      100.0f                  // Square wave of 2 x 50 V, unreachable
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                    \
+    do {                                                    \
+        if (cond) {                                         \
+            printf("[PASS] " __VA_ARGS__);                  \
+        } else {                                            \
+            printf("[FAIL] " __VA_ARGS__);                  \
+            failures++;                                     \
+        }                                                   \
+        printf("\n");                                       \
+    } while (0)
+
+/*---------------------------------------------------------------------------
+ * Plant simulation
+ *-------------------------------------------------------------------------*/
+
+typedef struct {
+    double v_rms[CYCLES];   // Output voltage per cycle (V RMS)
+    double engage_step;     // Largest reference step around the hand-over (pu)
+    double normal_step;     // Largest reference step in the cycle before (pu)
+    double gain_step;       // Reference step at the gain change (pu)
+    double i_peak;          // Largest inductor current (A)
+} sim_result_t;
+
+static unsigned long lcg = 12345;
+
+/* Small sensor noise, +-20 mA / +-0.2 V */
+static double noise(void)
+{
+    lcg = lcg * 1103515245ul + 12345ul;
+    return (((lcg >> 16) & 0x7FFF) / 32767.0 - 0.5) * 0.04;
+}
+
+static sim_result_t simulate(bool antiwindup)
+{
+    modulation_t mod;
+    voltage_control_t vc;
+    inverter_duty_t pending;
+    uint16_t ccr[4] = {0};
+    sim_result_t r;
+
+    memset(&r, 0, sizeof(r));
+    modulation_init(&mod);
+    modulation_set_index(&mod, 0.7f);
+    modulation_set_frequency(&mod, (float)F1);
+    modulation_set_rotation(&mod, true);
+    mod.enabled = true;
+    memset(&pending, 0, sizeof(pending));
+
+    voltage_control_init(&vc, (float)(2.0 * VDC), V_RMS_REF);
+    voltage_control_set_antiwindup(&vc, antiwindup);
+
+    double i = 0.0, v = 0.0, vd = 0.0, r_load = R_LOAD_LIGHT;
+    double v_avg = 0.0, i_avg = 0.0;
+    double sum_v2 = 0.0, last_ref = 0.0;
+    int n_cycle = 0;
+
+    for (int p = 0; p < CYCLES * PERIODS_PER_CYCLE; p++) {
+        int cycle = p / PERIODS_PER_CYCLE;
+
+        if (p % PERIODS_PER_CYCLE == 0) {
+            if (p > 0) {
+                r.v_rms[cycle - 1] = sqrt(sum_v2 / n_cycle);
+            }
+            sum_v2 = 0.0;
+            n_cycle = 0;
+
+            if (cycle == LOAD_ON_CYCLE) r_load = R_LOAD_HEAVY;
+            if (cycle == LOAD_OFF_CYCLE) r_load = R_LOAD_LIGHT;
+            if (cycle == REF_HIGH_CYCLE) voltage_control_set_reference(&vc, V_RMS_HIGH);
+            if (cycle == REF_BACK_CYCLE) voltage_control_set_reference(&vc, V_RMS_REF);
+        }
+
+        // TIM1 update: preloaded duties take effect, ISR computes the next
+        ccr[0] = pending.hbridge1.ch1;
+        ccr[1] = pending.hbridge1.ch2;
+        ccr[2] = pending.hbridge2.ch1;
+        ccr[3] = pending.hbridge2.ch2;
+
+        if (p == ENGAGE_PERIOD) {
+            voltage_control_engage(&vc, mod.modulation_index, mod.phase);
+        }
+        if (p == GAIN_CYCLE * PERIODS_PER_CYCLE + 50) {
+            voltage_control_set_gains(&vc, 2.0f * VC_KP_V_DEFAULT, 2.0f * VC_KI_V_DEFAULT,
+                                      1.5f * VC_KP_I_DEFAULT, 2.0f * VC_KR_I_DEFAULT);
+        }
+
+        float v_ref = voltage_control_update(&vc, (float)(v_avg + 10.0 * noise()),
+                                             (float)(i_avg + noise()), mod.phase);
+        if (!vc.active) {
+            // Open loop, same reference path
+            v_ref = mod.modulation_index * sinf((float)mod.phase * (2.0f * (float)M_PI / 4294967296.0f));
+        }
+        modulation_calculate_duties_ref(&mod, v_ref, &pending);
+        modulation_update(&mod);
+
+        double step = fabs(v_ref - last_ref);
+        last_ref = v_ref;
+        if (p > ENGAGE_PERIOD - PERIODS_PER_CYCLE && p < ENGAGE_PERIOD - 5 && step > r.normal_step) {
+            r.normal_step = step;
+        }
+        if (p >= ENGAGE_PERIOD && p < ENGAGE_PERIOD + 5 && step > r.engage_step) {
+            r.engage_step = step;
+        }
+        if (p == GAIN_CYCLE * PERIODS_PER_CYCLE + 50) {
+            r.gain_step = step;
+        }
+
+        v_avg = 0.0;
+        i_avg = 0.0;
+        for (int s = 0; s < STEPS; s++) {
+            uint32_t cnt = (uint32_t)s * STEP;
+            double vi = VDC * ((cnt < ccr[0]) - (cnt < ccr[1]) + (cnt < ccr[2]) - (cnt < ccr[3]));
+
+            // Semi-implicit Euler, stable for the lightly damped LC
+            i += T_STEP / L_FILTER * (vi - v - R_FILTER * i);
+            double id = (v - vd) / R_DAMP;
+            v += T_STEP / C_FILTER * (i - v / r_load - id);
+            vd += T_STEP / C_DAMP * id;
+
+            v_avg += v / STEPS;
+            i_avg += i / STEPS;
+
+            sum_v2 += v * v;
+            n_cycle++;
+            if (fabs(i) > r.i_peak) r.i_peak = fabs(i);
+        }
+    }
+    r.v_rms[CYCLES - 1] = sqrt(sum_v2 / n_cycle);
+    return r;
+}
+
+/* First cycle from `from` after which the RMS stays within tol of target */
+static int settle_cycles(const double *v_rms, int from, int to, double target, double tol)
+{
+    int last_out = from - 1;
+    for (int k = from; k < to; k++) {
+        if (fabs(v_rms[k] - target) > tol * target) last_out = k;
+    }
+    return last_out + 1 - from;
+}
+
+static double extreme(const double *v_rms, int from, int to, double target, bool high)
+{
+    double e = target;
+    for (int k = from; k < to; k++) {
+        if (high ? v_rms[k] > e : v_rms[k] < e) e = v_rms[k];
+    }
+    return e;
+}
+
+/*---------------------------------------------------------------------------
+ * Tests
+ *-------------------------------------------------------------------------*/
+
+int main(void)
+{
+    printf("\n========================================\n");
+    printf("Cascaded Voltage Control Test (RMS PI + PR)\n");
+    printf("========================================\n");
+
+    /* PR anti-windup under a sustained error */
+    pr_controller_t pr;
+    double peak_plain = 0.0, peak_aw = 0.0;
+    for (int aw = 0; aw < 2; aw++) {
+        pr_controller_init(&pr, 0.01f, 1.0f, PR_WC_DEFAULT);
+        pr_controller_set_limits(&pr, -0.5f, 0.5f);
+        if (aw) pr_controller_set_antiwindup(&pr, 100.0f);
+        for (int n = 0; n < 5000; n++) {
+            float ref = 100.0f * sinf(2.0f * (float)M_PI * 50.0f * n / PR_SAMPLE_FREQ);
+            pr_controller_update(&pr, ref, 0.0f);
+        }
+        double peak = fabs(pr.y1) > fabs(pr.y2) ? fabs(pr.y1) : fabs(pr.y2);
+        for (int n = 0; n < 100; n++) {
+            float ref = 100.0f * sinf(2.0f * (float)M_PI * 50.0f * n / PR_SAMPLE_FREQ);
+            pr_controller_update(&pr, ref, 0.0f);
+            if (fabs(pr.y1) > peak) peak = fabs(pr.y1);
+        }
+        if (aw) peak_aw = peak; else peak_plain = peak;
+    }
+    CHECK(peak_aw < 1.5 && peak_plain > 10.0 * peak_aw,
+          "PR back-calculation holds the resonant state at the limit (%.2f vs %.1f without)",
+          peak_aw, peak_plain);
+
+    /* Preset: with zero error the PR continues the loaded sinusoid */
+    pr_controller_init(&pr, 0.01f, 1.0f, PR_WC_DEFAULT);
+    pr_controller_set_limits(&pr, -1.0f, 1.0f);
+    pr_controller_preset(&pr, 0.7f, 1.0f);
+    double preset_err = 0.0;
+    for (int n = 0; n < 25; n++) {
+        float want = 0.7f * sinf(1.0f + 2.0f * (float)M_PI * 50.0f * n / PR_SAMPLE_FREQ);
+        double e = fabs(pr_controller_update(&pr, 0.0f, 0.0f) - want);
+        if (e > preset_err) preset_err = e;
+    }
+    CHECK(preset_err < 0.005, "PR preset continues the sinusoid (max error %.4f)", preset_err);
+
+    /* Bumpless gain change in the outer PI */
+    voltage_control_t vc;
+    CHECK(voltage_control_init(&vc, 0.0f, 50.0f) != 0, "invalid base voltage rejected");
+    voltage_control_init(&vc, 100.0f, 50.0f);
+    vc.pi.integral = 2.0f;
+    vc.pi.error = 3.0f;
+    float before = vc.pi.kp * vc.pi.error + vc.pi.integral;
+    voltage_control_set_gains(&vc, 0.1f, 5.0f, VC_KP_I_DEFAULT, VC_KR_I_DEFAULT);
+    float after = vc.pi.kp * vc.pi.error + vc.pi.integral;
+    CHECK(fabsf(after - before) < 1e-5f, "PI gain change is bumpless (%.4f -> %.4f A)", before, after);
+
+    /* Plant */
+    sim_result_t a = simulate(true);
+    sim_result_t b = simulate(false);
+
+    printf("\nVrms per cycle (ref %.0f V, %.0f V from cycle %d to %d):\n",
+           V_RMS_REF, V_RMS_HIGH, REF_HIGH_CYCLE, REF_BACK_CYCLE);
+    for (int k = 0; k < CYCLES; k += 10) {
+        printf("  %2d-%2d AW  :", k, k + 9);
+        for (int j = k; j < k + 10; j++) printf(" %5.1f", a.v_rms[j]);
+        printf("\n  %2d-%2d none:", k, k + 9);
+        for (int j = k; j < k + 10; j++) printf(" %5.1f", b.v_rms[j]);
+        printf("\n");
+    }
+    printf("\n");
+
+    double ref = V_RMS_REF;
+    double steady = a.v_rms[LOAD_ON_CYCLE - 1];
+    double dip = extreme(a.v_rms, LOAD_ON_CYCLE, LOAD_OFF_CYCLE, ref, false);
+    int t_on = settle_cycles(a.v_rms, LOAD_ON_CYCLE, LOAD_OFF_CYCLE, ref, 0.02);
+    double rise = extreme(a.v_rms, LOAD_OFF_CYCLE, GAIN_CYCLE, ref, true);
+    int t_off = settle_cycles(a.v_rms, LOAD_OFF_CYCLE, GAIN_CYCLE, ref, 0.02);
+    // The cycle the reference drops in is still at the limit
+    double over_aw = extreme(a.v_rms, REF_BACK_CYCLE + 1, CYCLES, ref, true);
+    double over_no = extreme(b.v_rms, REF_BACK_CYCLE + 1, CYCLES, ref, true);
+    int t_aw = settle_cycles(a.v_rms, REF_BACK_CYCLE, CYCLES, ref, 0.02);
+    int t_no = settle_cycles(b.v_rms, REF_BACK_CYCLE, CYCLES, ref, 0.02);
+
+    CHECK(fabs(a.v_rms[LOAD_ON_CYCLE - 1] - ref) < 0.01 * ref &&
+          fabs(a.v_rms[ENGAGE_PERIOD / PERIODS_PER_CYCLE + 5] - ref) < 0.02 * ref,
+          "regulates %.1f V RMS at %.0f ohm", steady, R_LOAD_LIGHT);
+    CHECK(a.engage_step < 1.5 * a.normal_step,
+          "bumpless engage (reference step %.3f pu, %.3f in open loop)", a.engage_step, a.normal_step);
+    CHECK(a.gain_step < 1.5 * a.normal_step,
+          "bumpless gain change (reference step %.3f pu)", a.gain_step);
+    // A current-controlled output follows the impedance for the first cycle
+    CHECK(dip > 0.5 * ref && t_on <= 5,
+          "load step %.0f -> %.0f ohm: dip to %.1f V, within 2%% after %d cycles",
+          R_LOAD_LIGHT, R_LOAD_HEAVY, dip, t_on);
+    CHECK(rise < 1.6 * ref && t_off <= 6,
+          "load step %.0f -> %.0f ohm: rise to %.1f V, within 2%% after %d cycles",
+          R_LOAD_HEAVY, R_LOAD_LIGHT, rise, t_off);
+    CHECK(over_aw < 1.05 * ref && t_aw <= 5 && t_aw < t_no,
+          "after saturation: overshoot %.1f V / %d cycles with anti-windup, %.1f V / %d without",
+          over_aw, t_aw, over_no, t_no);
+    CHECK(a.i_peak < VC_I_AMP_MAX_DEFAULT + 3.0,
+          "inductor current peak %.1f A (limit %.0f A + ripple)", a.i_peak, VC_I_AMP_MAX_DEFAULT);
+
+    printf("\n========================================\n");
+    if (failures == 0) {
+        printf("*** ALL TESTS PASSED! ***\n");
+    } else {
+        printf("*** %d TEST(S) FAILED ***\n", failures);
+    }
+    printf("========================================\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -1,27 +1,39 @@
 /**
  * @file carrier_generator.v
- * @brief Level-shifted triangular carrier wave generator for 5-level inverter
+ * @brief Level-shifted / phase-shifted triangular carrier generator for 5-level inverter
  *
- * Generates two level-shifted carrier waves:
- * - Carrier 1: -1.0 to 0.0 (for H-bridge 1)
- * - Carrier 2:  0.0 to +1.0 (for H-bridge 2)
+ * mode = 0, level-shifted (LS): two in-phase carriers, vertically offset
+ * - Carrier 1: -1.0 to 0.0 (lower band)
+ * - Carrier 2:  0.0 to +1.0 (upper band)
  *
- * The carriers are used for level-shifted PWM modulation to synthesize
- * 5 voltage levels: +100V, +50V, 0V, -50V, -100V
+ * mode = 1, phase-shifted (PS): two full-range carriers, 90 deg apart
+ * - Carrier 1: -1.0 to +1.0
+ * - Carrier 2: -1.0 to +1.0, a quarter carrier period ahead
+ * Each H-bridge compares +ref and -ref (180 deg) against its own carrier,
+ * so the four legs switch at 0/90/180/270 deg and the output ripple sits
+ * at 4x the carrier frequency.
+ *
+ * The carriers are used to synthesize 5 voltage levels:
+ * +100V, +50V, 0V, -50V, -100V
+ *
+ * Carrier amplitude is in clock cycles: full scale (1.0) = freq_div, so the
+ * triangle steps by exactly one per clock. The modulation reference must be
+ * scaled by freq_div / 32768 before comparison (done in the top level).
  *
  * @param clk           System clock
  * @param rst_n         Active-low reset
  * @param enable        Enable carrier generation
+ * @param mode          0 = level-shifted, 1 = phase-shifted
  * @param freq_div      Frequency divider for carrier frequency
- * @param carrier1      Output: Carrier 1 (-32768 to 0, signed 16-bit)
- * @param carrier2      Output: Carrier 2 (0 to +32767, signed 16-bit)
+ * @param carrier1      Output: Carrier 1 (LS: -freq_div..0,  PS: -freq_div..+freq_div)
+ * @param carrier2      Output: Carrier 2 (LS: 0..+freq_div,  PS: carrier 1 shifted 90 deg)
  * @param sync_pulse    Output: Synchronization pulse at carrier peak
  *
  * Configuration:
  * - System clock: 100 MHz
  * - Carrier frequency: 5 kHz (PWM switching frequency)
- * - Resolution: 16-bit signed (-32768 to +32767)
- * - Update rate: Carrier updated every clock cycle
+ * - Resolution: one clock cycle (freq_div steps per half period)
+ * - CARRIER_WIDTH must be at least COUNTER_WIDTH + 2
  *
  * Carrier frequency calculation:
  *   f_carrier = f_clk / (2 * freq_div)
@@ -32,87 +44,86 @@
  */
 
 module carrier_generator #(
-    parameter CARRIER_WIDTH = 16,           // Carrier bit width
+    parameter CARRIER_WIDTH = 18,           // Carrier bit width (signed)
     parameter COUNTER_WIDTH = 16            // Counter bit width
 )(
     input  wire                         clk,
     input  wire                         rst_n,
     input  wire                         enable,
+    input  wire                         mode,          // 0 = LS, 1 = PS
     input  wire [COUNTER_WIDTH-1:0]     freq_div,      // Frequency divider
-    output reg  signed [CARRIER_WIDTH-1:0]  carrier1,      // Carrier 1: -32768 to 0
-    output reg  signed [CARRIER_WIDTH-1:0]  carrier2,      // Carrier 2: 0 to +32767
+    output reg  signed [CARRIER_WIDTH-1:0]  carrier1,
+    output reg  signed [CARRIER_WIDTH-1:0]  carrier2,
     output reg                          sync_pulse     // Sync pulse at peak
 );
 
-    // Carrier generation constants
-    localparam signed CARRIER_MAX = (1 << (CARRIER_WIDTH-1)) - 1;  // +32767
-    localparam signed CARRIER_MIN = -(1 << (CARRIER_WIDTH-1));     // -32768
-    localparam signed CARRIER_MID = 0;
-
-    // Internal signals
+    // Triangle position: 0 -> freq_div -> 0 over 2 * freq_div clocks
     reg [COUNTER_WIDTH-1:0] counter;
     reg counter_dir;                        // 0 = counting up, 1 = counting down
-    reg prev_dir;                           // Previous direction for sync detection
 
-    // Carrier values (unsigned internally, converted to signed for output)
-    reg [CARRIER_WIDTH-1:0] carrier_unsigned;
+    // Same triangle a quarter period (freq_div / 2 clocks) ahead, derived
+    // from the position so the 90 deg shift holds for any freq_div
+    wire [COUNTER_WIDTH+1:0] pos     = counter;
+    wire [COUNTER_WIDTH+1:0] div     = freq_div;
+    wire [COUNTER_WIDTH+1:0] quarter = freq_div >> 1;
+    wire [COUNTER_WIDTH+1:0] counter_q =
+        (counter_dir == 0) ? ((pos + quarter <= div) ? pos + quarter
+                                                     : (div << 1) - pos - quarter)
+                           : ((pos > quarter)        ? pos - quarter
+                                                     : quarter - pos);
+
+    // Signed views for the carrier arithmetic
+    wire signed [CARRIER_WIDTH-1:0] tri_s  = $signed({1'b0, counter});
+    wire signed [CARRIER_WIDTH-1:0] triq_s = $signed({1'b0, counter_q});
+    wire signed [CARRIER_WIDTH-1:0] div_s  = $signed({1'b0, freq_div});
 
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
             counter <= 0;
             counter_dir <= 0;
-            prev_dir <= 0;
-            carrier_unsigned <= 0;
-            carrier1 <= CARRIER_MIN;
-            carrier2 <= CARRIER_MID;
+            carrier1 <= 0;
+            carrier2 <= 0;
             sync_pulse <= 0;
         end else begin
-            if (enable) begin
+            if (enable && freq_div != 0) begin
                 // Generate triangular carrier by counting up and down
-                if (counter >= freq_div - 1) begin
-                    counter <= 0;
-
-                    // Toggle direction at each period
-                    if (counter_dir == 0) begin
+                if (counter_dir == 0) begin
+                    if (counter + 1 >= freq_div) begin
                         // Reached peak, start counting down
+                        counter <= freq_div;
                         counter_dir <= 1;
-                        carrier_unsigned <= (1 << (CARRIER_WIDTH-1)) - 1;  // Max value
                     end else begin
-                        // Reached valley, start counting up
-                        counter_dir <= 0;
-                        carrier_unsigned <= 0;  // Min value
+                        counter <= counter + 1;
                     end
                 end else begin
-                    counter <= counter + 1;
-
-                    // Update carrier value
-                    if (counter_dir == 0) begin
-                        // Counting up
-                        carrier_unsigned <= carrier_unsigned + 1;
+                    if (counter <= 1) begin
+                        // Reached valley, start counting up
+                        counter <= 0;
+                        counter_dir <= 0;
                     end else begin
-                        // Counting down
-                        carrier_unsigned <= carrier_unsigned - 1;
+                        counter <= counter - 1;
                     end
                 end
 
-                // Generate level-shifted carriers
-                // Carrier 1: Map 0 to 32767 → -32768 to 0
-                carrier1 <= $signed(carrier_unsigned) + CARRIER_MIN;
-
-                // Carrier 2: Map 0 to 32767 → 0 to +32767
-                carrier2 <= $signed(carrier_unsigned);
+                if (mode == 0) begin
+                    // Level-shifted: 0..freq_div -> -freq_div..0 and 0..+freq_div
+                    carrier1 <= tri_s - div_s;
+                    carrier2 <= tri_s;
+                end else begin
+                    // Phase-shifted: full range, carrier 2 leads by 90 deg
+                    carrier1 <= (tri_s <<< 1) - div_s;
+                    carrier2 <= (triq_s <<< 1) - div_s;
+                end
 
-                // Generate sync pulse at carrier peak (direction change from up to down)
-                prev_dir <= counter_dir;
-                sync_pulse <= (prev_dir == 0) && (counter_dir == 1);
+                // Sync pulse at carrier peak (last up-count step)
+                sync_pulse <= (counter_dir == 0) && (counter + 1 >= freq_div);
 
             end else begin
                 // Disabled - reset to initial state
                 counter <= 0;
                 counter_dir <= 0;
-                carrier_unsigned <= 0;
-                carrier1 <= CARRIER_MIN;
-                carrier2 <= CARRIER_MID;
+                carrier1 <= 0;
+                carrier2 <= 0;
                 sync_pulse <= 0;
             end
         end
@@ -0,0 +1,169 @@
+/**
+ * @file inverter_5level_3ph_top.v
+ * @brief Multi-phase top: N_PHASES 5-level cascaded H-bridge phases
+ *
+ * N_PHASES copies of the single-phase modulator (phase_modulator, 2
+ * H-bridges and 8 switches each) on one shared carrier_generator:
+ * - One carrier pair and one sync_pulse for all phases, delayed to the
+ *   reference as in inverter_5level_top, so every phase switches against
+ *   the same carriers (LS or PS, pwm_mode)
+ * - Per-phase sine_generator / she_generator started 360 / N_PHASES deg
+ *   apart: phase k lags phase 0 by k * 360 / N_PHASES deg (a, b, c for
+ *   N_PHASES = 3, b lagging a by 120 deg). The accumulators share the
+ *   increment and reset together, so the phases stay locked
+ * - LS band rotation per phase, at that phase's own zero crossing
+ *
+ * Zero-sequence injection (three-phase only): ref_shape 2 (min-max) adds
+ * -(max + min) / 2 of the three phase references, the carrier equivalent
+ * of SVPWM, and ref_shape 1 (THI) adds k * sin(3x). sine_generator takes
+ * both from the angle of phase 0 in every phase, so all phases inject
+ * the identical value and it cancels line-to-line exactly; MI then runs
+ * to 1.155 (37837) before the phase references saturate, 15.5% more
+ * line voltage from the same DC buses. For N_PHASES other than 3 use
+ * ref_shape 0, 3 or 4.
+ *
+ * Latency is that of inverter_5level_top (REF_LATENCY clocks from the
+ * phase accumulators to the leg comparators, carriers delayed to match).
+ *
+ * Gate mapping: pwm_gates[8*k +: 8] are S1..S8 of phase k, in the order
+ * of inverter_5level_top (bit 0 = pwm1_ch1_high, bit 7 = pwm2_ch2_low).
+ *
+ * @param clk               System clock (100 MHz)
+ * @param rst_n             Active-low reset
+ * @param enable            Enable inverter operation
+ * @param freq_50hz         Frequency increment for 50Hz output
+ * @param modulation_index  Modulation index (32768 = 100%), all phases
+ * @param ref_shape         0 = sine, 1 = THI, 2 = min-max (SVPWM), 3 = NLC, 4 = SHE
+ * @param thi_k             Third-harmonic fraction for THI (Q15)
+ * @param deadtime_cycles   Dead-time in clock cycles
+ * @param carrier_freq_div  Carrier frequency divider
+ * @param pwm_mode          0 = level-shifted, 1 = phase-shifted carriers
+ * @param level_rotation    Swap LS bands between bridges every output cycle
+ * @param pwm_gates         Gate outputs, 8 per phase
+ * @param sync_pulse        Synchronization pulse output
+ * @param fault             Fault output (reserved for future use)
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+module inverter_5level_3ph_top #(
+    parameter N_PHASES = 3,
+    parameter DATA_WIDTH = 16,
+    parameter PHASE_WIDTH = 32,
+    parameter DEADTIME_WIDTH = 8,
+    parameter CARRIER_DIV_WIDTH = 16
+)(
+    // System signals
+    input  wire                         clk,
+    input  wire                         rst_n,
+    input  wire                         enable,
+
+    // Configuration (shared by all phases)
+    input  wire [PHASE_WIDTH-1:0]       freq_50hz,          // Phase increment for 50Hz
+    input  wire [DATA_WIDTH-1:0]        modulation_index,   // MI: 32768 = 100%
+    input  wire [2:0]                   ref_shape,          // Reference shaping
+    input  wire [DATA_WIDTH-1:0]        thi_k,              // THI fraction (Q15)
+    input  wire [DEADTIME_WIDTH-1:0]    deadtime_cycles,    // Dead-time
+    input  wire [CARRIER_DIV_WIDTH-1:0] carrier_freq_div,   // Carrier frequency divider
+    input  wire                         pwm_mode,           // 0 = LS, 1 = PS
+    input  wire                         level_rotation,     // LS band rotation
+
+    // Gate outputs, S1..S8 per phase
+    output wire [8*N_PHASES-1:0]        pwm_gates,
+
+    // Status outputs
+    output wire                         sync_pulse,
+    output wire                         fault
+);
+
+    // Comparison width: carriers span +-carrier_freq_div, LS references
+    // reach -3 x carrier_freq_div
+    localparam CMP_WIDTH = CARRIER_DIV_WIDTH + 3;
+
+    // Phase accumulator to leg references (phase_modulator REF_LATENCY)
+    localparam REF_LATENCY = 10;
+
+    // One output cycle in phase accumulator units
+    localparam [63:0] TURN = 64'd1 << PHASE_WIDTH;
+
+    // Internal signals
+    wire signed [CMP_WIDTH-1:0]  carrier1_gen;
+    wire signed [CMP_WIDTH-1:0]  carrier2_gen;
+    wire                         sync_gen;
+
+    // Shared level-shifted / phase-shifted carrier generator
+    carrier_generator #(
+        .CARRIER_WIDTH  (CMP_WIDTH),
+        .COUNTER_WIDTH  (CARRIER_DIV_WIDTH)
+    ) carrier_gen (
+        .clk            (clk),
+        .rst_n          (rst_n),
+        .enable         (enable),
+        .mode           (pwm_mode),
+        .freq_div       (carrier_freq_div),
+        .carrier1       (carrier1_gen),
+        .carrier2       (carrier2_gen),
+        .sync_pulse     (sync_gen)
+    );
+
+    // Carrier latency compensation: REF_LATENCY - 1 clocks here, the last
+    // one in the leg carrier registers of each phase
+    reg [CMP_WIDTH*(REF_LATENCY-1)-1:0] carrier1_line;
+    reg [CMP_WIDTH*(REF_LATENCY-1)-1:0] carrier2_line;
+    reg [REF_LATENCY-1:0]               sync_line;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            carrier1_line <= 0;
+            carrier2_line <= 0;
+            sync_line <= 0;
+        end else begin
+            carrier1_line <= {carrier1_line, carrier1_gen};
+            carrier2_line <= {carrier2_line, carrier2_gen};
+            sync_line <= {sync_line, sync_gen};
+        end
+    end
+
+    wire signed [CMP_WIDTH-1:0] carrier1 = carrier1_line[CMP_WIDTH*(REF_LATENCY-1)-1 -: CMP_WIDTH];
+    wire signed [CMP_WIDTH-1:0] carrier2 = carrier2_line[CMP_WIDTH*(REF_LATENCY-1)-1 -: CMP_WIDTH];
+    assign sync_pulse = sync_line[REF_LATENCY-1];
+
+    // One modulator per phase, phase k at -k * 360 / N_PHASES deg
+    // (start phase (N_PHASES - k) / N_PHASES of a cycle, rounded)
+    genvar k;
+    generate
+        for (k = 0; k < N_PHASES; k = k + 1) begin : phase
+            localparam [PHASE_WIDTH-1:0] OFFSET =
+                (TURN * (N_PHASES - k) + N_PHASES / 2) / N_PHASES;
+
+            phase_modulator #(
+                .DATA_WIDTH         (DATA_WIDTH),
+                .PHASE_WIDTH        (PHASE_WIDTH),
+                .DEADTIME_WIDTH     (DEADTIME_WIDTH),
+                .CARRIER_DIV_WIDTH  (CARRIER_DIV_WIDTH),
+                .PHASE_OFFSET       (OFFSET)
+            ) phase_mod (
+                .clk                (clk),
+                .rst_n              (rst_n),
+                .enable             (enable),
+                .freq_increment     (freq_50hz),
+                .modulation_index   (modulation_index),
+                .ref_shape          (ref_shape),
+                .thi_k              (thi_k),
+                .deadtime_cycles    (deadtime_cycles),
+                .carrier_freq_div   (carrier_freq_div),
+                .pwm_mode           (pwm_mode),
+                .level_rotation     (level_rotation),
+                .carrier1           (carrier1),
+                .carrier2           (carrier2),
+                .gate               (pwm_gates[8*k +: 8]),
+                .phase              ()
+            );
+        end
+    endgenerate
+
+    // Fault output (not implemented yet, reserved for future use)
+    assign fault = 1'b0;
+
+endmodule
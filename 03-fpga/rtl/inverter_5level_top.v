@@ -3,10 +3,38 @@
  * @brief Top-level module for 5-level cascaded H-bridge inverter
  *
  * Integrates all PWM generation components:
- * - Sine wave reference generator
- * - Dual level-shifted carrier generators
- * - PWM comparators with dead-time insertion
+ * - Dual level-shifted / phase-shifted carrier generator
+ * - phase_modulator: sine / SHE reference, band split, PWM comparators
+ *   with dead-time insertion
  * - Gate driver outputs for 2 H-bridges (8 switches total)
+ * inverter_5level_3ph_top runs three such phases on shared carriers.
+ *
+ * Carrier modes (pwm_mode):
+ * 0 = Level-shifted (phase disposition). The reference is doubled and split
+ *     in four bands; leg A of a bridge compares against the upper carrier,
+ *     leg B (negated) against the lower one. The inner bridge covers
+ *     |v| < 50V, the outer bridge only switches beyond that. With
+ *     level_rotation set the two bridges swap bands at every positive zero
+ *     crossing of the reference, so both carry the same power and switching
+ *     loss over two cycles.
+ * 1 = Phase-shifted. Both bridges compare +ref (leg A) and -ref (leg B)
+ *     against full-range carriers 90 deg apart: equal duty and loss in both
+ *     bridges, output ripple at 4x the carrier frequency.
+ *
+ * Reference shapes (ref_shape, see sine_generator): sine, third-harmonic
+ * injection and min-max zero sequence go through the selected carrier
+ * mode unchanged. The staircases NLC (nearest level) and SHE (she_generator,
+ * precomputed angles eliminating the 5th and 7th) ignore the carriers and
+ * pwm_mode: the level is split into inner / outer bridge like the LS bands
+ * and each leg is held fully on or off, so the switches only toggle at
+ * the level steps.
+ *
+ * Pipeline: the reference reaches the leg comparators REF_LATENCY clocks
+ * after the phase accumulator (sine_generator, carrier scaling, leg
+ * reference select), and the carriers and sync_pulse are delayed by the
+ * same amount, so the modulator is the zero-latency one shifted by
+ * REF_LATENCY clocks. Every multiplier and adder sits between registers
+ * for timing closure at 100+ MHz.
  *
  * Output voltage levels:
  * +100V: Both bridges positive
@@ -32,8 +60,13 @@
  * @param rst_n             Active-low reset
  * @param enable            Enable inverter operation
  * @param freq_50hz         Frequency increment for 50Hz output
- * @param modulation_index  Modulation index (0-32767)
+ * @param modulation_index  Modulation index (32768 = 100%, up to 45875 for NLC)
+ * @param ref_shape         0 = sine, 1 = THI, 2 = min-max, 3 = NLC, 4 = SHE
+ * @param thi_k             Third-harmonic fraction for THI (Q15)
  * @param deadtime_cycles   Dead-time in clock cycles
+ * @param carrier_freq_div  Carrier frequency divider
+ * @param pwm_mode          0 = level-shifted, 1 = phase-shifted carriers
+ * @param level_rotation    Swap LS bands between bridges every output cycle
  * @param pwm1_*            H-Bridge 1 PWM outputs
  * @param pwm2_*            H-Bridge 2 PWM outputs
  * @param sync_pulse        Synchronization pulse output
@@ -56,9 +89,13 @@ module inverter_5level_top #(
 
     // Configuration
     input  wire [PHASE_WIDTH-1:0]       freq_50hz,          // Phase increment for 50Hz
-    input  wire [DATA_WIDTH-1:0]        modulation_index,   // MI: 0-32767
+    input  wire [DATA_WIDTH-1:0]        modulation_index,   // MI: 32768 = 100%
+    input  wire [2:0]                   ref_shape,          // Reference shaping
+    input  wire [DATA_WIDTH-1:0]        thi_k,              // THI fraction (Q15)
     input  wire [DEADTIME_WIDTH-1:0]    deadtime_cycles,    // Dead-time
     input  wire [CARRIER_DIV_WIDTH-1:0] carrier_freq_div,   // Carrier frequency divider
+    input  wire                         pwm_mode,           // 0 = LS, 1 = PS
+    input  wire                         level_rotation,     // LS band rotation
 
     // H-Bridge 1 outputs (S1-S4)
     output wire                         pwm1_ch1_high,      // S1
@@ -77,99 +114,79 @@ module inverter_5level_top #(
     output wire                         fault
 );
 
-    // Internal signals
-    wire signed [DATA_WIDTH-1:0] sine_ref;
-    wire signed [DATA_WIDTH-1:0] carrier1;
-    wire signed [DATA_WIDTH-1:0] carrier2;
+    // Comparison width: carriers span +-carrier_freq_div, LS references
+    // reach -3 x carrier_freq_div
+    localparam CMP_WIDTH = CARRIER_DIV_WIDTH + 3;
 
-    // Sine wave reference generator
-    sine_generator #(
-        .DATA_WIDTH     (DATA_WIDTH),
-        .PHASE_WIDTH    (PHASE_WIDTH)
-    ) sine_gen (
-        .clk                (clk),
-        .rst_n              (rst_n),
-        .enable             (enable),
-        .freq_increment     (freq_50hz),
-        .modulation_index   (modulation_index),
-        .sine_out           (sine_ref),
-        .phase              ()                  // Not used
-    );
+    // Phase accumulator to leg references (phase_modulator REF_LATENCY)
+    localparam REF_LATENCY = 10;
+
+    // Internal signals
+    wire [7:0]                   sine_phase;
+    wire signed [CMP_WIDTH-1:0]  carrier1_gen;
+    wire signed [CMP_WIDTH-1:0]  carrier2_gen;
+    wire                         sync_gen;
 
-    // Level-shifted carrier generator
+    // Level-shifted / phase-shifted carrier generator
     carrier_generator #(
-        .CARRIER_WIDTH  (DATA_WIDTH),
+        .CARRIER_WIDTH  (CMP_WIDTH),
         .COUNTER_WIDTH  (CARRIER_DIV_WIDTH)
     ) carrier_gen (
         .clk            (clk),
         .rst_n          (rst_n),
         .enable         (enable),
+        .mode           (pwm_mode),
         .freq_div       (carrier_freq_div),
-        .carrier1       (carrier1),
-        .carrier2       (carrier2),
-        .sync_pulse     (sync_pulse)
+        .carrier1       (carrier1_gen),
+        .carrier2       (carrier2_gen),
+        .sync_pulse     (sync_gen)
     );
 
-    // PWM comparators for H-Bridge 1 (uses carrier1: -32768 to 0)
-    // Channel 1 (S1/S2)
-    pwm_comparator #(
-        .DATA_WIDTH         (DATA_WIDTH),
-        .DEADTIME_WIDTH     (DEADTIME_WIDTH)
-    ) pwm1_ch1 (
-        .clk        (clk),
-        .rst_n      (rst_n),
-        .enable     (enable),
-        .reference  (sine_ref),
-        .carrier    (carrier1),
-        .deadtime   (deadtime_cycles),
-        .pwm_high   (pwm1_ch1_high),
-        .pwm_low    (pwm1_ch1_low)
-    );
+    // Carrier latency compensation: REF_LATENCY - 1 clocks here, the last
+    // one in the leg carrier registers
+    reg [CMP_WIDTH*(REF_LATENCY-1)-1:0] carrier1_line;
+    reg [CMP_WIDTH*(REF_LATENCY-1)-1:0] carrier2_line;
+    reg [REF_LATENCY-1:0]               sync_line;
 
-    // Channel 2 (S3/S4) - same reference and carrier
-    pwm_comparator #(
-        .DATA_WIDTH         (DATA_WIDTH),
-        .DEADTIME_WIDTH     (DEADTIME_WIDTH)
-    ) pwm1_ch2 (
-        .clk        (clk),
-        .rst_n      (rst_n),
-        .enable     (enable),
-        .reference  (sine_ref),
-        .carrier    (carrier1),
-        .deadtime   (deadtime_cycles),
-        .pwm_high   (pwm1_ch2_high),
-        .pwm_low    (pwm1_ch2_low)
-    );
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            carrier1_line <= 0;
+            carrier2_line <= 0;
+            sync_line <= 0;
+        end else begin
+            carrier1_line <= {carrier1_line, carrier1_gen};
+            carrier2_line <= {carrier2_line, carrier2_gen};
+            sync_line <= {sync_line, sync_gen};
+        end
+    end
 
-    // PWM comparators for H-Bridge 2 (uses carrier2: 0 to +32767)
-    // Channel 1 (S5/S6)
-    pwm_comparator #(
-        .DATA_WIDTH         (DATA_WIDTH),
-        .DEADTIME_WIDTH     (DEADTIME_WIDTH)
-    ) pwm2_ch1 (
-        .clk        (clk),
-        .rst_n      (rst_n),
-        .enable     (enable),
-        .reference  (sine_ref),
-        .carrier    (carrier2),
-        .deadtime   (deadtime_cycles),
-        .pwm_high   (pwm2_ch1_high),
-        .pwm_low    (pwm2_ch1_low)
-    );
+    wire signed [CMP_WIDTH-1:0] carrier1 = carrier1_line[CMP_WIDTH*(REF_LATENCY-1)-1 -: CMP_WIDTH];
+    wire signed [CMP_WIDTH-1:0] carrier2 = carrier2_line[CMP_WIDTH*(REF_LATENCY-1)-1 -: CMP_WIDTH];
+    assign sync_pulse = sync_line[REF_LATENCY-1];
 
-    // Channel 2 (S7/S8) - same reference and carrier
-    pwm_comparator #(
+    // Reference, band split and the four legs of the two H-bridges
+    phase_modulator #(
         .DATA_WIDTH         (DATA_WIDTH),
-        .DEADTIME_WIDTH     (DEADTIME_WIDTH)
-    ) pwm2_ch2 (
-        .clk        (clk),
-        .rst_n      (rst_n),
-        .enable     (enable),
-        .reference  (sine_ref),
-        .carrier    (carrier2),
-        .deadtime   (deadtime_cycles),
-        .pwm_high   (pwm2_ch2_high),
-        .pwm_low    (pwm2_ch2_low)
+        .PHASE_WIDTH        (PHASE_WIDTH),
+        .DEADTIME_WIDTH     (DEADTIME_WIDTH),
+        .CARRIER_DIV_WIDTH  (CARRIER_DIV_WIDTH)
+    ) phase_mod (
+        .clk                (clk),
+        .rst_n              (rst_n),
+        .enable             (enable),
+        .freq_increment     (freq_50hz),
+        .modulation_index   (modulation_index),
+        .ref_shape          (ref_shape),
+        .thi_k              (thi_k),
+        .deadtime_cycles    (deadtime_cycles),
+        .carrier_freq_div   (carrier_freq_div),
+        .pwm_mode           (pwm_mode),
+        .level_rotation     (level_rotation),
+        .carrier1           (carrier1),
+        .carrier2           (carrier2),
+        .gate               ({pwm2_ch2_low, pwm2_ch2_high, pwm2_ch1_low, pwm2_ch1_high,
+                              pwm1_ch2_low, pwm1_ch2_high, pwm1_ch1_low, pwm1_ch1_high}),
+        .phase              (sine_phase)
     );
 
     // Fault output (not implemented yet, reserved for future use)
@@ -0,0 +1,287 @@
+/**
+ * @file phase_modulator.v
+ * @brief Modulator of one output phase: reference, band split, 4 legs
+ *
+ * Everything of inverter_5level_top that belongs to one phase (2 cascaded
+ * H-bridges, 8 switches), around carriers supplied from outside so that
+ * several phases can share one carrier_generator (inverter_5level_3ph_top):
+ * - sine_generator and she_generator, started at PHASE_OFFSET
+ * - reference scaling to carrier units
+ * - LS band split with level rotation at the phase's own zero crossing,
+ *   PS references, NLC / SHE staircase legs
+ * - registered leg references and carriers, 4 pwm_comparator legs
+ *
+ * The carriers must arrive REF_LATENCY - 1 clocks after the carrier
+ * generator (the last register is the leg carrier register here); the
+ * modulator is then the zero-latency one shifted by REF_LATENCY clocks.
+ * See inverter_5level_top for the carrier modes and reference shapes.
+ *
+ * @param clk               System clock (100 MHz)
+ * @param rst_n             Active-low reset
+ * @param enable            Enable modulation
+ * @param freq_increment    Phase increment per clock
+ * @param modulation_index  Modulation index (32768 = 100%, up to 45875 for NLC)
+ * @param ref_shape         0 = sine, 1 = THI, 2 = min-max, 3 = NLC, 4 = SHE
+ * @param thi_k             Third-harmonic fraction for THI (Q15)
+ * @param deadtime_cycles   Dead-time in clock cycles
+ * @param carrier_freq_div  Carrier frequency divider (carrier peak)
+ * @param pwm_mode          0 = level-shifted, 1 = phase-shifted carriers
+ * @param level_rotation    Swap LS bands between bridges every output cycle
+ * @param carrier1          Carrier 1, delayed REF_LATENCY - 1 clocks
+ * @param carrier2          Carrier 2, delayed REF_LATENCY - 1 clocks
+ * @param gate              Gate signals S8..S1 (gate[0] = S1 = pwm1_ch1_high)
+ * @param phase             Phase of the sine reference (0 to 255)
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+module phase_modulator #(
+    parameter DATA_WIDTH = 16,
+    parameter PHASE_WIDTH = 32,
+    parameter DEADTIME_WIDTH = 8,
+    parameter CARRIER_DIV_WIDTH = 16,
+    parameter [PHASE_WIDTH-1:0] PHASE_OFFSET = 0    // Phase of this output (2^PHASE_WIDTH = 360 deg)
+)(
+    input  wire                                 clk,
+    input  wire                                 rst_n,
+    input  wire                                 enable,
+    input  wire [PHASE_WIDTH-1:0]               freq_increment,
+    input  wire [DATA_WIDTH-1:0]                modulation_index,
+    input  wire [2:0]                           ref_shape,
+    input  wire [DATA_WIDTH-1:0]                thi_k,
+    input  wire [DEADTIME_WIDTH-1:0]            deadtime_cycles,
+    input  wire [CARRIER_DIV_WIDTH-1:0]         carrier_freq_div,
+    input  wire                                 pwm_mode,
+    input  wire                                 level_rotation,
+    input  wire signed [CARRIER_DIV_WIDTH+2:0]  carrier1,
+    input  wire signed [CARRIER_DIV_WIDTH+2:0]  carrier2,
+    output wire [7:0]                           gate,
+    output wire [7:0]                           phase
+);
+
+    // Comparison width: carriers span +-carrier_freq_div, LS references
+    // reach -3 x carrier_freq_div
+    localparam CMP_WIDTH = CARRIER_DIV_WIDTH + 3;
+
+    // Phase accumulator to leg references: sine_generator, then the carrier
+    // scaling product, ref_s and the registered leg references
+    localparam SINE_LATENCY = 7;            // sine_generator LATENCY
+    localparam SHE_LATENCY  = 1;            // she_generator level register
+    localparam REF_LATENCY  = SINE_LATENCY + 3;
+
+    // Internal signals
+    wire signed [DATA_WIDTH-1:0] sine_ref;
+    wire [7:0]                   sine_phase;
+
+    assign phase = sine_phase;
+
+    // Sine wave reference generator
+    sine_generator #(
+        .DATA_WIDTH     (DATA_WIDTH),
+        .PHASE_WIDTH    (PHASE_WIDTH),
+        .PHASE_OFFSET   (PHASE_OFFSET)
+    ) sine_gen (
+        .clk                (clk),
+        .rst_n              (rst_n),
+        .enable             (enable),
+        .freq_increment     (freq_increment),
+        .modulation_index   (modulation_index),
+        .shape              (ref_shape[1:0]),
+        .thi_k              (thi_k),
+        .sine_out           (sine_ref),
+        .phase              (sine_phase)
+    );
+
+    // SHE staircase (ref_shape = 4)
+    wire signed [2:0] she_level;
+
+    she_generator #(
+        .DATA_WIDTH     (DATA_WIDTH),
+        .PHASE_WIDTH    (PHASE_WIDTH),
+        .PHASE_OFFSET   (PHASE_OFFSET)
+    ) she_gen (
+        .clk                (clk),
+        .rst_n              (rst_n),
+        .enable             (enable),
+        .freq_increment     (freq_increment),
+        .modulation_index   (modulation_index),
+        .level              (she_level)
+    );
+
+    // Reference in carrier units: sine_ref * carrier_freq_div / 32768,
+    // product registered (DSP output register, no reset), then ref_s
+    wire signed [CMP_WIDTH-1:0] div_s = $signed({1'b0, carrier_freq_div});
+    reg  signed [DATA_WIDTH+CARRIER_DIV_WIDTH:0] ref_product;
+    reg  signed [CMP_WIDTH-1:0] ref_s;
+
+    always @(posedge clk)
+        ref_product <= sine_ref * $signed({1'b0, carrier_freq_div});
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            ref_s <= 0;
+        end else begin
+            ref_s <= ref_product >>> (DATA_WIDTH - 1);
+        end
+    end
+
+    // Level rotation: toggle at each sine phase wrap (positive zero
+    // crossing), in step with ref_s
+    reg rotate;
+    reg phase_msb_d, phase_msb_dd;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            rotate <= 0;
+            phase_msb_d <= 0;
+            phase_msb_dd <= 0;
+        end else begin
+            phase_msb_d <= sine_phase[7];
+            phase_msb_dd <= phase_msb_d;
+            if (!enable || !level_rotation) begin
+                rotate <= 0;
+            end else if (phase_msb_dd && !phase_msb_d) begin
+                rotate <= ~rotate;
+            end
+        end
+    end
+
+    // LS bands: output level 2*ref split as inner = clamp(2*ref, +-1),
+    // outer = rest. "x > upper carrier" drives leg A, "-x > -lower carrier"
+    // drives leg B, so every comparison is reference > carrier.
+    wire signed [CMP_WIDTH-1:0] ref2    = ref_s <<< 1;
+    wire signed [CMP_WIDTH-1:0] inner_a = ref2;
+    wire signed [CMP_WIDTH-1:0] inner_b = -ref2;
+    wire signed [CMP_WIDTH-1:0] outer_a = ref2 - div_s;
+    wire signed [CMP_WIDTH-1:0] outer_b = -ref2 - div_s;
+    wire signed [CMP_WIDTH-1:0] ls_car_a = carrier2;
+    wire signed [CMP_WIDTH-1:0] ls_car_b = -carrier1;
+
+    // Staircase modes: NLC level from the quantized reference (multiples
+    // of 16384), SHE level from the angle table (delayed to the sine
+    // reference). Registered twice to stay in step with ref_s. Inner
+    // bridge takes +-1, outer the rest, swapped with the LS bands by rotate.
+    wire        stair     = (ref_shape == 3'd3) || (ref_shape == 3'd4);
+    wire signed [DATA_WIDTH:0] nlc_round = (sine_ref + 8192) >>> 14;
+
+    reg  [3*(SINE_LATENCY-SHE_LATENCY)-1:0] she_line;
+    wire signed [2:0] she_aligned = she_line[3*(SINE_LATENCY-SHE_LATENCY)-1 -: 3];
+    reg  signed [2:0] stair_level_d, stair_level;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            she_line <= 0;
+            stair_level_d <= 0;
+            stair_level <= 0;
+        end else begin
+            she_line <= {she_line, she_level};
+            stair_level_d <= (ref_shape == 3'd4) ? she_aligned : nlc_round[2:0];
+            stair_level <= stair_level_d;
+        end
+    end
+
+    wire signed [2:0] stair_inner = (stair_level > 1) ? 3'sd1 :
+                                    (stair_level < -1) ? -3'sd1 : stair_level;
+    wire signed [2:0] stair_outer = stair_level - stair_inner;
+    wire signed [2:0] stair_b1 = rotate ? stair_outer : stair_inner;
+    wire signed [2:0] stair_b2 = rotate ? stair_inner : stair_outer;
+
+    // Held leg references: above / below the whole carrier range
+    wire signed [CMP_WIDTH-1:0] hold_on  = div_s + 1;
+    wire signed [CMP_WIDTH-1:0] hold_off = -div_s - 1;
+
+    // Per-leg reference and carrier, registered: the comparators see two
+    // registers and one compare
+    reg signed [CMP_WIDTH-1:0] b1a_ref, b1b_ref, b2a_ref, b2b_ref;
+    reg signed [CMP_WIDTH-1:0] b1a_car, b1b_car, b2a_car, b2b_car;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            b1a_ref <= 0;
+            b1b_ref <= 0;
+            b2a_ref <= 0;
+            b2b_ref <= 0;
+            b1a_car <= 0;
+            b1b_car <= 0;
+            b2a_car <= 0;
+            b2b_car <= 0;
+        end else begin
+            b1a_ref <= stair ? ((stair_b1 > 0) ? hold_on : hold_off) :
+                       pwm_mode ? ref_s  : (rotate ? outer_a : inner_a);
+            b1b_ref <= stair ? ((stair_b1 < 0) ? hold_on : hold_off) :
+                       pwm_mode ? -ref_s : (rotate ? outer_b : inner_b);
+            b2a_ref <= stair ? ((stair_b2 > 0) ? hold_on : hold_off) :
+                       pwm_mode ? ref_s  : (rotate ? inner_a : outer_a);
+            b2b_ref <= stair ? ((stair_b2 < 0) ? hold_on : hold_off) :
+                       pwm_mode ? -ref_s : (rotate ? inner_b : outer_b);
+            b1a_car <= pwm_mode ? carrier1 : ls_car_a;
+            b1b_car <= pwm_mode ? carrier1 : ls_car_b;
+            b2a_car <= pwm_mode ? carrier2 : ls_car_a;
+            b2b_car <= pwm_mode ? carrier2 : ls_car_b;
+        end
+    end
+
+    // PWM comparators for H-Bridge 1
+    // Channel 1 (S1/S2) - leg A
+    pwm_comparator #(
+        .DATA_WIDTH         (CMP_WIDTH),
+        .DEADTIME_WIDTH     (DEADTIME_WIDTH)
+    ) pwm1_ch1 (
+        .clk        (clk),
+        .rst_n      (rst_n),
+        .enable     (enable),
+        .reference  (b1a_ref),
+        .carrier    (b1a_car),
+        .deadtime   (deadtime_cycles),
+        .pwm_high   (gate[0]),
+        .pwm_low    (gate[1])
+    );
+
+    // Channel 2 (S3/S4) - leg B
+    pwm_comparator #(
+        .DATA_WIDTH         (CMP_WIDTH),
+        .DEADTIME_WIDTH     (DEADTIME_WIDTH)
+    ) pwm1_ch2 (
+        .clk        (clk),
+        .rst_n      (rst_n),
+        .enable     (enable),
+        .reference  (b1b_ref),
+        .carrier    (b1b_car),
+        .deadtime   (deadtime_cycles),
+        .pwm_high   (gate[2]),
+        .pwm_low    (gate[3])
+    );
+
+    // PWM comparators for H-Bridge 2
+    // Channel 1 (S5/S6) - leg A
+    pwm_comparator #(
+        .DATA_WIDTH         (CMP_WIDTH),
+        .DEADTIME_WIDTH     (DEADTIME_WIDTH)
+    ) pwm2_ch1 (
+        .clk        (clk),
+        .rst_n      (rst_n),
+        .enable     (enable),
+        .reference  (b2a_ref),
+        .carrier    (b2a_car),
+        .deadtime   (deadtime_cycles),
+        .pwm_high   (gate[4]),
+        .pwm_low    (gate[5])
+    );
+
+    // Channel 2 (S7/S8) - leg B
+    pwm_comparator #(
+        .DATA_WIDTH         (CMP_WIDTH),
+        .DEADTIME_WIDTH     (DEADTIME_WIDTH)
+    ) pwm2_ch2 (
+        .clk        (clk),
+        .rst_n      (rst_n),
+        .enable     (enable),
+        .reference  (b2b_ref),
+        .carrier    (b2b_car),
+        .deadtime   (deadtime_cycles),
+        .pwm_high   (gate[6]),
+        .pwm_low    (gate[7])
+    );
+
+endmodule
@@ -0,0 +1,58 @@
+// she_angles.vh - SHE staircase switching angles
+//
+// GENERATED by 06-tools/she/she_solver.cpp - do not edit.
+//
+// Eliminates the 5th and 7th harmonics. Entry i is MI = (SHE_MI_MIN + i) / 128.
+// she_entry = {down[2:0], a1, a2, a3}: down[k] set for a -1 level step,
+// angles in 2^16 phase units per output cycle (quarter wave < 16384).
+
+localparam SHE_TABLE_SIZE = 38;
+localparam SHE_MI_MIN     = 83; // MI x 128
+localparam SHE_MI_MAX     = 120; // MI x 128
+
+function [50:0] she_entry;
+    input [7:0] idx;
+    begin
+        case (idx)
+        8'd0: she_entry = {3'b001, 16'd2993, 16'd11861, 16'd12534};
+        8'd1: she_entry = {3'b001, 16'd3055, 16'd12125, 16'd12946};
+        8'd2: she_entry = {3'b001, 16'd3106, 16'd12250, 16'd13218};
+        8'd3: she_entry = {3'b001, 16'd3151, 16'd12312, 16'd13425};
+        8'd4: she_entry = {3'b001, 16'd3194, 16'd12338, 16'd13597};
+        8'd5: she_entry = {3'b001, 16'd3234, 16'd12341, 16'd13745};
+        8'd6: she_entry = {3'b001, 16'd3274, 16'd12329, 16'd13877};
+        8'd7: she_entry = {3'b001, 16'd3312, 16'd12305, 16'd13998};
+        8'd8: she_entry = {3'b001, 16'd3349, 16'd12272, 16'd14111};
+        8'd9: she_entry = {3'b001, 16'd3385, 16'd12233, 16'd14216};
+        8'd10: she_entry = {3'b001, 16'd3419, 16'd12189, 16'd14317};
+        8'd11: she_entry = {3'b001, 16'd3453, 16'd12141, 16'd14414};
+        8'd12: she_entry = {3'b001, 16'd3486, 16'd12090, 16'd14507};
+        8'd13: she_entry = {3'b001, 16'd3518, 16'd12036, 16'd14597};
+        8'd14: she_entry = {3'b001, 16'd3548, 16'd11979, 16'd14685};
+        8'd15: she_entry = {3'b001, 16'd3578, 16'd11920, 16'd14770};
+        8'd16: she_entry = {3'b001, 16'd3606, 16'd11860, 16'd14854};
+        8'd17: she_entry = {3'b001, 16'd3632, 16'd11798, 16'd14935};
+        8'd18: she_entry = {3'b001, 16'd3657, 16'd11735, 16'd15016};
+        8'd19: she_entry = {3'b001, 16'd3681, 16'd11671, 16'd15094};
+        8'd20: she_entry = {3'b001, 16'd3703, 16'd11605, 16'd15172};
+        8'd21: she_entry = {3'b001, 16'd3723, 16'd11539, 16'd15248};
+        8'd22: she_entry = {3'b001, 16'd3742, 16'd11472, 16'd15323};
+        8'd23: she_entry = {3'b001, 16'd3759, 16'd11404, 16'd15397};
+        8'd24: she_entry = {3'b001, 16'd3774, 16'd11335, 16'd15470};
+        8'd25: she_entry = {3'b001, 16'd3787, 16'd11266, 16'd15541};
+        8'd26: she_entry = {3'b001, 16'd3797, 16'd11196, 16'd15612};
+        8'd27: she_entry = {3'b001, 16'd3806, 16'd11125, 16'd15681};
+        8'd28: she_entry = {3'b001, 16'd3813, 16'd11054, 16'd15749};
+        8'd29: she_entry = {3'b001, 16'd3817, 16'd10983, 16'd15817};
+        8'd30: she_entry = {3'b001, 16'd3819, 16'd10910, 16'd15883};
+        8'd31: she_entry = {3'b001, 16'd3819, 16'd10838, 16'd15948};
+        8'd32: she_entry = {3'b001, 16'd3816, 16'd10764, 16'd16012};
+        8'd33: she_entry = {3'b001, 16'd3811, 16'd10691, 16'd16075};
+        8'd34: she_entry = {3'b001, 16'd3803, 16'd10616, 16'd16137};
+        8'd35: she_entry = {3'b001, 16'd3793, 16'd10541, 16'd16198};
+        8'd36: she_entry = {3'b001, 16'd3781, 16'd10466, 16'd16258};
+        8'd37: she_entry = {3'b001, 16'd3766, 16'd10389, 16'd16316};
+        default: she_entry = 51'd0;
+        endcase
+    end
+endfunction
@@ -0,0 +1,102 @@
+/**
+ * @file she_generator.v
+ * @brief Selective harmonic elimination (SHE) staircase level generator
+ *
+ * Plays back the precomputed switching angles of a quarter-wave symmetric
+ * 5-level staircase that eliminates the 5th and 7th harmonics. The angle
+ * table (she_angles.vh) is generated by 06-tools/she/she_solver.cpp
+ * together with the STM32 header, so both implementations switch at the
+ * same angles.
+ *
+ * The phase accumulator matches sine_generator (same increment, same
+ * reset value PHASE_OFFSET), so the staircase stays aligned with the sine
+ * reference phase.
+ * The top 16 phase bits are folded into the first quarter wave and
+ * compared with the three angles of the selected entry:
+ *
+ *   level = sum_k sign_k * (x >= a_k),  x = folded phase,
+ *   negated in the second half cycle
+ *
+ * Angle resolution is 1/65536 of a cycle (0.3 us at 50 Hz).
+ *
+ * @param clk               System clock (100 MHz)
+ * @param rst_n             Active-low reset
+ * @param enable            Enable generation
+ * @param freq_increment    Phase increment per clock (as sine_generator)
+ * @param modulation_index  Modulation index (32768 = 100%), rounded to the
+ *                          table grid of 1/128; level 0 below the table
+ * @param level             Staircase level, -2..+2 bridge voltages
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-25
+ */
+
+module she_generator #(
+    parameter DATA_WIDTH = 16,
+    parameter PHASE_WIDTH = 32,
+    parameter [PHASE_WIDTH-1:0] PHASE_OFFSET = 0    // Start phase, as sine_generator
+)(
+    input  wire                         clk,
+    input  wire                         rst_n,
+    input  wire                         enable,
+    input  wire [PHASE_WIDTH-1:0]       freq_increment,
+    input  wire [DATA_WIDTH-1:0]        modulation_index,
+    output reg  signed [2:0]            level
+);
+
+    `include "she_angles.vh"
+
+    // Phase accumulator (same as sine_generator)
+    reg [PHASE_WIDTH-1:0] phase_acc;
+    wire [15:0] p = phase_acc[PHASE_WIDTH-1:PHASE_WIDTH-16];
+
+    // Nearest table entry: grid step 1/128 = 256 in Q15
+    wire [DATA_WIDTH:0] mi_grid = ({1'b0, modulation_index} + 128) >> 8;
+    wire                in_table = (mi_grid >= SHE_MI_MIN);
+    wire [7:0]          idx = (mi_grid > SHE_MI_MAX) ? SHE_MI_MAX - SHE_MI_MIN :
+                              in_table ? mi_grid - SHE_MI_MIN : 8'd0;
+
+    // Selected entry, registered (table ROM)
+    reg [50:0] entry;
+    reg        entry_valid;
+    wire [2:0]  down = entry[50:48];
+    wire [15:0] a1   = entry[47:32];
+    wire [15:0] a2   = entry[31:16];
+    wire [15:0] a3   = entry[15:0];
+
+    // Fold the phase into the first quarter wave
+    wire [14:0] h = p[14:0];
+    wire [15:0] x = h[14] ? 16'd32768 - h : {1'b0, h};
+
+    wire signed [2:0] s1 = (x >= a1) ? (down[2] ? -3'sd1 : 3'sd1) : 3'sd0;
+    wire signed [2:0] s2 = (x >= a2) ? (down[1] ? -3'sd1 : 3'sd1) : 3'sd0;
+    wire signed [2:0] s3 = (x >= a3) ? (down[0] ? -3'sd1 : 3'sd1) : 3'sd0;
+    wire signed [2:0] quarter_level = s1 + s2 + s3;
+
+    always @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            phase_acc <= PHASE_OFFSET;
+            entry <= 0;
+            entry_valid <= 0;
+            level <= 0;
+        end else begin
+            entry <= she_entry(idx);
+            entry_valid <= in_table;
+
+            if (enable) begin
+                phase_acc <= phase_acc + freq_increment;
+
+                if (!entry_valid)
+                    level <= 0;
+                else if (p[15])
+                    level <= -quarter_level;
+                else
+                    level <= quarter_level;
+            end else begin
+                phase_acc <= PHASE_OFFSET;
+                level <= 0;
+            end
+        end
+    end
+
+endmodule
@@ -3,21 +3,52 @@
  * @brief Sine wave reference generator using lookup table (LUT)
  *
  * Generates sinusoidal modulation reference for 5-level inverter.
- * Uses 256-entry LUT for one complete sine wave period.
+ * The sine comes from a quarter-wave table with linear interpolation
+ * (sine_quarter_lut below), so the phase is no longer truncated to the
+ * table address.
  *
  * Features:
  * - Programmable frequency (via phase accumulator)
+ * - Quarter-wave sine table, interpolated on INTERP_BITS phase bits
  * - Programmable modulation index (amplitude scaling)
- * - 16-bit signed output (-32768 to +32767)
+ * - Optional reference shaping (third harmonic, min-max, nearest level)
+ * - 16-bit signed output (-32768 to +32767), saturated
  * - Phase accumulator for smooth frequency control
  *
  * @param clk               System clock (100 MHz)
  * @param rst_n             Active-low reset
  * @param enable            Enable sine generation
  * @param freq_increment    Phase increment per clock cycle
- * @param modulation_index  Modulation index (0 to 32767, where 32767 = 100% MI)
+ * @param modulation_index  Modulation index (unsigned, 32768 = 100% MI)
+ * @param shape             Reference shape (0 = sine, 1 = THI, 2 = min-max, 3 = NLC)
+ * @param thi_k             Third-harmonic fraction for THI (Q15, 5461 = 1/6)
  * @param sine_out          Sine wave output (-32768 to +32767)
- * @param phase             Current phase (0 to 255)
+ * @param phase             Phase of the sample on sine_out (0 to 255)
+ *
+ * Sine table:
+ *   QUARTER_ADDR_WIDTH = 8   256 entries, the memory of the old full-wave
+ *                            table; four times its angular resolution
+ *   QUARTER_ADDR_WIDTH = 10  1024 entries, one 18 Kb block RAM used as a
+ *                            dual-port ROM
+ *   The old 256-entry full-wave table truncated the phase to 8 bits:
+ *   48 dB SFDR. The interpolated quarter table reaches 103 dB at MI 1.0
+ *   (256 or 1024 entries), within 1.5 LSB of MI * sin(x); see
+ *   06-tools/sine/sine_model.cpp and tb/sine_generator_tb.v.
+ *
+ * Pipeline: table read, interpolation, shaping and the two products are
+ * each registered (LATENCY = 7 clocks), so the block RAM and the DSP
+ * slices use their internal registers and no path holds more than one
+ * multiplier or one carry chain; it closes well above 100 MHz. Users
+ * delay their carriers by the same amount (inverter_5level_top).
+ * The MI scaling rounds to nearest.
+ *
+ * Phase offset: PHASE_OFFSET is the accumulator value after reset and
+ * while disabled, so the instances of a multi-phase set (k * 360 / N deg
+ * apart) start together and stay locked (inverter_5level_3ph_top). The
+ * triplens of THI and min-max are taken from phase_acc - PHASE_OFFSET,
+ * the angle of the reference phase, so every phase of a three-phase set
+ * injects the identical zero sequence and it cancels line-to-line
+ * exactly; PHASE_OFFSET must then be a multiple of 120 deg.
  *
  * Frequency calculation:
  *   f_out = (freq_increment * f_clk) / (2^32)
@@ -27,6 +58,22 @@
  *   0      = 0% MI (no output)
  *   16384  = 50% MI
  *   32767  = 100% MI (full amplitude)
+ *   37837  = 115.5% MI (THI k = 1/6 / min-max linear limit)
+ *   45875  = 140% MI (NLC)
+ * Above the shape's limit the output saturates (overmodulation).
+ *
+ * Reference shaping (same shapes as the STM32 modulator):
+ *   0 = sine     sin(x)
+ *   1 = THI      sin(x) + k * sin(3x); k = 1/6 lowers the peak to 0.866
+ *   2 = min-max  sin(x) - (max + min) / 2 of the three-phase set, a
+ *                triangular zero sequence with the same 0.866 peak
+ *   3 = NLC      MI * sin(x) rounded to the nearest of the five levels
+ *                (multiples of 16384); the top level drives the legs fully
+ *                on or off, so the output is a fundamental-frequency staircase
+ * THI and min-max reach MI 1.155 before the output saturates, 15.5% more
+ * fundamental from the same DC bus. On a single-phase load the injected
+ * triplens stay in the output voltage; they only cancel line-to-line in a
+ * three-phase system.
  *
  * @author 5-Level Inverter Project
  * @date 2025-11-15
@@ -35,62 +82,260 @@
 module sine_generator #(
     parameter DATA_WIDTH = 16,
     parameter PHASE_WIDTH = 32,
-    parameter LUT_ADDR_WIDTH = 8            // 256-entry LUT
+    parameter LUT_ADDR_WIDTH = 8,           // phase output, zero-sequence table
+    parameter QUARTER_ADDR_WIDTH = 8,       // 256-entry quarter-wave sine table
+    parameter INTERP_BITS = 8,              // Phase bits interpolated between entries
+    parameter [PHASE_WIDTH-1:0] PHASE_OFFSET = 0    // Start phase (2^PHASE_WIDTH = 360 deg)
 )(
     input  wire                         clk,
     input  wire                         rst_n,
     input  wire                         enable,
     input  wire [PHASE_WIDTH-1:0]       freq_increment,
     input  wire [DATA_WIDTH-1:0]        modulation_index,
+    input  wire [1:0]                   shape,
+    input  wire [DATA_WIDTH-1:0]        thi_k,
     output reg  signed [DATA_WIDTH-1:0] sine_out,
     output wire [LUT_ADDR_WIDTH-1:0]    phase
 );
 
+    // Pipeline, one register per step (LATENCY clocks from the phase
+    // accumulator to sine_out; the phase output is delayed to match):
+    //   1-3  sine_quarter_lut: table read, interpolation product, sum
+    //   4    THI product
+    //   5    shaping
+    //   6    MI product, rounding constant added in the multiplier
+    //   7    NLC quantization, saturation
+    // The product registers have no reset so they pack into the DSP slices.
+    localparam LATENCY = 7;
+
     // Phase accumulator
     reg [PHASE_WIDTH-1:0] phase_acc;
 
-    // Use upper bits of phase accumulator as LUT address
-    assign phase = phase_acc[PHASE_WIDTH-1:PHASE_WIDTH-LUT_ADDR_WIDTH];
+    // Upper bits of the phase accumulator, delayed to the sample on sine_out
+    reg [LUT_ADDR_WIDTH*LATENCY-1:0] phase_line;
+
+    assign phase = phase_line[LUT_ADDR_WIDTH*LATENCY-1 -: LUT_ADDR_WIDTH];
+
+    // Stages 1-3: interpolated sine of the phase, and of 3 x phase for THI
+    localparam TABLE_PHASE_WIDTH = QUARTER_ADDR_WIDTH + INTERP_BITS + 2;
+
+    // Zero sequence angle: the reference phase of a multi-phase set
+    wire [PHASE_WIDTH-1:0]       phase_zs = phase_acc - PHASE_OFFSET;
+    wire [PHASE_WIDTH-1:0]       phase_acc3 = phase_zs + (phase_zs << 1);
+    wire signed [DATA_WIDTH-1:0] sine_1x;
+    wire signed [DATA_WIDTH-1:0] sine_3x;
 
-    // Sine LUT (256 entries, 16-bit signed values)
-    // Values represent sine from 0 to 2π
-    reg signed [DATA_WIDTH-1:0] sine_lut [0:(1<<LUT_ADDR_WIDTH)-1];
+    sine_quarter_lut #(
+        .DATA_WIDTH     (DATA_WIDTH),
+        .ADDR_WIDTH     (QUARTER_ADDR_WIDTH),
+        .FRAC_WIDTH     (INTERP_BITS)
+    ) lut_1x (
+        .clk            (clk),
+        .phase          (phase_acc[PHASE_WIDTH-1 -: TABLE_PHASE_WIDTH]),
+        .sine_out       (sine_1x)
+    );
 
-    // Scaled sine value
-    wire signed [2*DATA_WIDTH-1:0] sine_scaled;
+    sine_quarter_lut #(
+        .DATA_WIDTH     (DATA_WIDTH),
+        .ADDR_WIDTH     (QUARTER_ADDR_WIDTH),
+        .FRAC_WIDTH     (INTERP_BITS)
+    ) lut_3x (
+        .clk            (clk),
+        .phase          (phase_acc3[PHASE_WIDTH-1 -: TABLE_PHASE_WIDTH]),
+        .sine_out       (sine_3x)
+    );
+
+    // Min-max zero sequence: -(max + min) / 2 of the three phases, which
+    // is half the middle phase: +-sin(d) / 2 with d the distance to the
+    // nearest multiple of 60 deg, the sign alternating every 60 deg
+    localparam ZS_ENTRIES = 1 << LUT_ADDR_WIDTH;
+    localparam real PI = 3.14159265359;
+
+    reg signed [DATA_WIDTH-1:0] zs_lut [0:ZS_ENTRIES-1];
 
-    // Initialize LUT with sine values
     integer i;
-    real pi = 3.14159265359;
-    real angle;
     initial begin
-        for (i = 0; i < (1<<LUT_ADDR_WIDTH); i = i + 1) begin
-            angle = (2.0 * pi * i) / (1 << LUT_ADDR_WIDTH);
-            sine_lut[i] = $rtoi(32767.0 * $sin(angle));
-        end
+        for (i = 0; i < ZS_ENTRIES; i = i + 1)
+            zs_lut[i] = $rtoi((((6 * i) / ZS_ENTRIES) % 2 ? -16383.5 : 16383.5) *
+                              $sin(PI / (3.0 * ZS_ENTRIES) *
+                                   (((6 * i) % ZS_ENTRIES < ZS_ENTRIES - (6 * i) % ZS_ENTRIES) ?
+                                    (6 * i) % ZS_ENTRIES : ZS_ENTRIES - (6 * i) % ZS_ENTRIES)));
     end
 
-    // Scale sine by modulation index
-    // sine_scaled = (sine_lut[phase] * modulation_index) / 32768
-    assign sine_scaled = sine_lut[phase] * $signed(modulation_index);
+    // Registered read (stage 1), delayed to line up with the sine (stage 4)
+    reg signed [DATA_WIDTH-1:0] zs_read;
+    reg signed [3*DATA_WIDTH-1:0] zs_line;
+    wire signed [DATA_WIDTH-1:0] zs_value = zs_line[3*DATA_WIDTH-1 -: DATA_WIDTH];
+
+    always @(posedge clk) begin
+        zs_read <= zs_lut[phase_zs[PHASE_WIDTH-1 -: LUT_ADDR_WIDTH]];
+        zs_line <= {zs_line[2*DATA_WIDTH-1:0], zs_read};
+    end
+
+    localparam SHAPE_SINE   = 2'd0;
+    localparam SHAPE_THI    = 2'd1;
+    localparam SHAPE_MINMAX = 2'd2;
+    localparam SHAPE_NLC    = 2'd3;
+
+    // Stage 4: THI product, sine delayed alongside
+    reg signed [2*DATA_WIDTH:0]  thi_prod;
+    reg signed [DATA_WIDTH-1:0]  sine_d;
+
+    always @(posedge clk) begin
+        thi_prod <= sine_3x * $signed({1'b0, thi_k});
+        sine_d   <= sine_1x;
+    end
+
+    // Stage 5: shaped unit reference (|shaped| < 1.5 x 32767)
+    reg  signed [DATA_WIDTH+1:0] shaped;
+
+    // Stage 6: scale by MI, + 1/2 LSB of the result for rounding
+    localparam signed [2*DATA_WIDTH+2:0] ROUND = 1 << (DATA_WIDTH - 2);
+    reg  signed [2*DATA_WIDTH+2:0] scaled_prod;
+
+    always @(posedge clk)
+        scaled_prod <= shaped * $signed({1'b0, modulation_index}) + ROUND;
+
+    // Stage 7: quantize (NLC) and saturate
+    wire signed [DATA_WIDTH+2:0]   scaled = scaled_prod >>> (DATA_WIDTH - 1);
+    wire signed [DATA_WIDTH+2:0]   nlc_level = (scaled + 8192) >>> 14;
+    wire signed [DATA_WIDTH+2:0]   staircase =
+        (nlc_level > 2)  ? 32768 :
+        (nlc_level < -2) ? -32768 : (nlc_level <<< 14);
+    wire signed [DATA_WIDTH+2:0]   shaped_out = (shape == SHAPE_NLC) ? staircase : scaled;
+
+    localparam signed [DATA_WIDTH+2:0] OUT_MAX = (1 << (DATA_WIDTH - 1)) - 1;
 
     always @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
-            phase_acc <= 0;
+            phase_acc <= PHASE_OFFSET;
+            phase_line <= 0;
+            shaped <= 0;
             sine_out <= 0;
         end else begin
+            phase_line <= {phase_line, phase_acc[PHASE_WIDTH-1 -: LUT_ADDR_WIDTH]};
+
             if (enable) begin
                 // Increment phase accumulator
                 phase_acc <= phase_acc + freq_increment;
 
-                // Output scaled sine (divide by 32768 = right shift by 15)
-                sine_out <= sine_scaled >>> (DATA_WIDTH - 1);
+                case (shape)
+                    SHAPE_THI:    shaped <= sine_d + (thi_prod >>> (DATA_WIDTH - 1));
+                    SHAPE_MINMAX: shaped <= sine_d + zs_value;
+                    default:      shaped <= sine_d;
+                endcase
+
+                if (shaped_out > OUT_MAX)
+                    sine_out <= OUT_MAX;
+                else if (shaped_out < -OUT_MAX)
+                    sine_out <= -OUT_MAX;
+                else
+                    sine_out <= shaped_out[DATA_WIDTH-1:0];
 
             end else begin
-                phase_acc <= 0;
+                phase_acc <= PHASE_OFFSET;
+                shaped <= 0;
                 sine_out <= 0;
             end
         end
     end
 
 endmodule
+
+
+/**
+ * Quarter-wave sine table with linear interpolation
+ *
+ * Stores sin(x) for the first quarter cycle only, 2^ADDR_WIDTH entries
+ * T[i] = round(32767 * sin(pi/2 * i / 2^ADDR_WIDTH)). The phase input is
+ * split as
+ *
+ *   [quadrant (2) | address (ADDR_WIDTH) | fraction (FRAC_WIDTH)]
+ *
+ * Odd quadrants run the table backwards (u -> 2^(ADDR+FRAC) - u, exact, so
+ * the peak lands on x = pi/2), quadrants 2 and 3 negate. Between two
+ * entries the output is T[a] + ((T[a+1] - T[a]) * frac + 1/2) / 2^FRAC,
+ * and the missing entry T[2^ADDR_WIDTH] (the peak) is the constant 32767.
+ *
+ * Three clocks from phase to sine_out: the two table reads, registered
+ * without reset so they map onto a dual-port block RAM (or registered
+ * distributed ROM for small tables), the slope x frac product with the
+ * rounding constant (one DSP, pre-adder for the slope), then the sum.
+ * 06-tools/sine/sine_model.cpp is the bit-exact model.
+ *
+ * @param clk       Clock
+ * @param phase     Top ADDR_WIDTH + FRAC_WIDTH + 2 bits of the phase
+ * @param sine_out  Interpolated sine (-32767 to +32767)
+ */
+
+module sine_quarter_lut #(
+    parameter DATA_WIDTH = 16,
+    parameter ADDR_WIDTH = 8,               // 2^ADDR_WIDTH entries per quarter
+    parameter FRAC_WIDTH = 8                // Interpolated phase bits
+)(
+    input  wire                                 clk,
+    input  wire [ADDR_WIDTH+FRAC_WIDTH+1:0]     phase,
+    output reg  signed [DATA_WIDTH-1:0]         sine_out
+);
+
+    localparam ENTRIES = 1 << ADDR_WIDTH;
+    localparam U_WIDTH = ADDR_WIDTH + FRAC_WIDTH;     // Phase within a quadrant
+    localparam signed [DATA_WIDTH-1:0] PEAK = (1 << (DATA_WIDTH - 1)) - 1;
+
+    reg signed [DATA_WIDTH-1:0] lut [0:ENTRIES-1];
+
+    localparam real PI = 3.14159265359;
+
+    integer i;
+    initial begin
+        for (i = 0; i < ENTRIES; i = i + 1)
+            lut[i] = $rtoi(32767.0 * $sin(PI / 2.0 * i / ENTRIES) + 0.5);
+    end
+
+    // Fold the phase into the first quadrant: 0 <= u <= 2^U_WIDTH
+    wire [1:0]          quadrant = phase[U_WIDTH+1:U_WIDTH];
+    wire [U_WIDTH-1:0]  u_in = phase[U_WIDTH-1:0];
+    wire [U_WIDTH:0]    u = quadrant[0] ? ((1 << U_WIDTH) - u_in) : u_in;
+    wire [ADDR_WIDTH:0] index = u[U_WIDTH:FRAC_WIDTH];
+
+    // Index ENTRIES (and ENTRIES-1 + 1) is the peak, not in the table
+    wire [ADDR_WIDTH-1:0] addr0 = index[ADDR_WIDTH-1:0];
+    wire [ADDR_WIDTH-1:0] addr1 = addr0 + 1'b1;
+
+    // Stage 1: table reads
+    reg signed [DATA_WIDTH-1:0] y0, y1;
+    reg                         peak0, peak1;
+    reg [FRAC_WIDTH-1:0]        frac;
+    reg                         negate;
+
+    always @(posedge clk) begin
+        y0     <= lut[addr0];
+        y1     <= lut[addr1];
+        peak0  <= index[ADDR_WIDTH];
+        peak1  <= (index >= ENTRIES - 1);
+        frac   <= u[FRAC_WIDTH-1:0];
+        negate <= quadrant[1];
+    end
+
+    // Stage 2: (T[a+1] - T[a]) * frac + 1/2
+    localparam signed [DATA_WIDTH+FRAC_WIDTH+1:0] HALF = 1 << (FRAC_WIDTH - 1);
+
+    wire signed [DATA_WIDTH-1:0]            v0 = peak0 ? PEAK : y0;
+    wire signed [DATA_WIDTH-1:0]            v1 = peak1 ? PEAK : y1;
+    reg  signed [DATA_WIDTH+FRAC_WIDTH+1:0] step;
+    reg  signed [DATA_WIDTH-1:0]            base;
+    reg                                     negate_d;
+
+    always @(posedge clk) begin
+        step     <= (v1 - v0) * $signed({1'b0, frac}) + HALF;
+        base     <= v0;
+        negate_d <= negate;
+    end
+
+    // Stage 3: sum, then restore the sign
+    wire signed [DATA_WIDTH:0] interp = base + (step >>> FRAC_WIDTH);
+
+    always @(posedge clk)
+        sine_out <= negate_d ? -interp : interp;
+
+endmodule
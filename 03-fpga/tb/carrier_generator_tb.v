@@ -4,7 +4,8 @@
  *
  * Tests:
  * - Carrier generation at 5kHz
- * - Level-shifted outputs (carrier1: -32768 to 0, carrier2: 0 to +32767)
+ * - Level-shifted outputs (carrier1: -freq_div to 0, carrier2: 0 to +freq_div)
+ * - Phase-shifted outputs (both -freq_div to +freq_div, 90 deg apart)
  * - Synchronization pulse generation
  * - Enable/disable functionality
  *
@@ -18,13 +19,14 @@ module carrier_generator_tb;
 
     // Parameters
     parameter CLK_PERIOD = 10;              // 100 MHz clock
-    parameter CARRIER_WIDTH = 16;
+    parameter CARRIER_WIDTH = 18;
     parameter COUNTER_WIDTH = 16;
 
     // Testbench signals
     reg                         clk;
     reg                         rst_n;
     reg                         enable;
+    reg                         mode;
     reg [COUNTER_WIDTH-1:0]     freq_div;
     wire signed [CARRIER_WIDTH-1:0] carrier1;
     wire signed [CARRIER_WIDTH-1:0] carrier2;
@@ -38,6 +40,7 @@ module carrier_generator_tb;
         .clk            (clk),
         .rst_n          (rst_n),
         .enable         (enable),
+        .mode           (mode),
         .freq_div       (freq_div),
         .carrier1       (carrier1),
         .carrier2       (carrier2),
@@ -61,6 +64,7 @@ module carrier_generator_tb;
         // Initialize
         rst_n = 0;
         enable = 0;
+        mode = 0;                           // Level-shifted
         freq_div = 100;                     // Fast frequency for simulation
 
         // Reset
@@ -86,6 +90,16 @@ module carrier_generator_tb;
         freq_div = 200;
         #(CLK_PERIOD * freq_div * 2);
 
+        // Phase-shifted mode
+        $display("Time=%0t: Switching to phase-shifted carriers", $time);
+        enable = 0;
+        mode = 1;
+        #(CLK_PERIOD * 10);
+        enable = 1;
+        #(CLK_PERIOD * freq_div * 6);
+        freq_div = 201;                     // Odd divider: shift rounds down
+        #(CLK_PERIOD * freq_div * 6);
+
         // Finish
         #(CLK_PERIOD * 100);
         $display("Test completed successfully!");
@@ -99,20 +113,43 @@ module carrier_generator_tb;
     end
 
     // Check carrier ranges
+    wire signed [CARRIER_WIDTH-1:0] full = $signed({1'b0, freq_div});
+
     always @(posedge clk) begin
-        if (enable) begin
-            // Check carrier1 range: -32768 to 0
-            if (carrier1 > 0 || carrier1 < -32768) begin
+        if (enable && mode == 0) begin
+            // Check carrier1 range: -freq_div to 0
+            if (carrier1 > 0 || carrier1 < -full) begin
                 $display("ERROR: carrier1 out of range: %d", carrier1);
                 $stop;
             end
 
-            // Check carrier2 range: 0 to +32767
-            if (carrier2 < 0 || carrier2 > 32767) begin
+            // Check carrier2 range: 0 to +freq_div
+            if (carrier2 < 0 || carrier2 > full) begin
                 $display("ERROR: carrier2 out of range: %d", carrier2);
                 $stop;
             end
         end
+
+        if (enable && mode == 1) begin
+            // Both carriers full range: -freq_div to +freq_div
+            if (carrier1 > full || carrier1 < -full ||
+                carrier2 > full || carrier2 < -full) begin
+                $display("ERROR: PS carrier out of range: %d %d", carrier1, carrier2);
+                $stop;
+            end
+        end
+    end
+
+    // PS: carrier 2 is a quarter period ahead, so it crosses zero (falling)
+    // when carrier 1 peaks
+    always @(posedge clk) begin
+        if (enable && mode == 1 && carrier1 == full) begin
+            if (carrier2 > 2 || carrier2 < -2) begin
+                $display("ERROR: PS carriers not 90 deg apart: carrier1=%d carrier2=%d",
+                         carrier1, carrier2);
+                $stop;
+            end
+        end
     end
 
 endmodule
@@ -0,0 +1,330 @@
+/**
+ * @file inverter_5level_3ph_top_tb.v
+ * @brief Three-phase top: phase spacing, shared carriers, zero sequence
+ *
+ * Runs inverter_5level_3ph_top (N_PHASES = 3) with the timing of
+ * pwm_modes_tb (output period 65536 clocks, carrier period 512 clocks),
+ * so one output cycle is an exact DFT window. Each phase's output level
+ * (H-bridge 1 + H-bridge 2 from the high-side gates, in Vdc units) and
+ * its sine reference are accumulated into Fourier coefficients clock by
+ * clock.
+ *
+ * Checks:
+ * - All 24 gates low while disabled
+ * - LS (rotation on) and PS, sine at MI 0.8: every phase has a 2 x MI
+ *   fundamental, b lags a and c leads a by 120 deg (within 0.5 deg)
+ * - No leg ever drives high and low side together (dead time 4 clocks)
+ * - Min-max (SVPWM-equivalent) just below MI 1.155: phase references do
+ *   not saturate and carry a 3rd harmonic, the line-to-line reference
+ *   a - b has no triplens and a fundamental of sqrt(3) x the phase
+ * - Min-max gates: line-to-line fundamental sqrt(3) x 2 x MI, more than
+ *   12% above the sine limit
+ *
+ * Run (from 03-fpga/):
+ *   make sim_3ph
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+`timescale 1ns / 1ps
+
+module inverter_5level_3ph_top_tb;
+
+    // Parameters
+    parameter CLK_PERIOD = 10;              // 100 MHz clock
+    parameter N_PHASES = 3;
+    parameter DATA_WIDTH = 16;
+    parameter PHASE_WIDTH = 32;
+    parameter DEADTIME_WIDTH = 8;
+    parameter CARRIER_DIV_WIDTH = 16;
+
+    localparam FREQ_DIV  = 256;             // Carrier period 512 clocks
+    localparam FREQ_INC  = 65536;           // Output period 65536 clocks
+    localparam CYCLE     = 65536;
+    localparam MI        = 26214;           // 0.8
+    localparam MI_SVPWM  = 37500;           // 1.144, just below the 1.155 limit
+    localparam THI_K     = 5461;            // 1/6
+
+    real PI = 3.14159265358979;
+
+    // Testbench signals
+    reg                         clk;
+    reg                         rst_n;
+    reg                         enable;
+    reg                         pwm_mode;
+    reg [DATA_WIDTH-1:0]        mi;
+    reg [2:0]                   ref_shape;
+
+    wire [8*N_PHASES-1:0]       pwm_gates;
+    wire                        sync_pulse;
+    wire                        fault;
+
+    // DUT instantiation
+    inverter_5level_3ph_top #(
+        .N_PHASES           (N_PHASES),
+        .DATA_WIDTH         (DATA_WIDTH),
+        .PHASE_WIDTH        (PHASE_WIDTH),
+        .DEADTIME_WIDTH     (DEADTIME_WIDTH),
+        .CARRIER_DIV_WIDTH  (CARRIER_DIV_WIDTH)
+    ) dut (
+        .clk                (clk),
+        .rst_n              (rst_n),
+        .enable             (enable),
+        .freq_50hz          (FREQ_INC),
+        .modulation_index   (mi),
+        .ref_shape          (ref_shape),
+        .thi_k              (THI_K[DATA_WIDTH-1:0]),
+        .deadtime_cycles    (8'd4),
+        .carrier_freq_div   (FREQ_DIV),
+        .pwm_mode           (pwm_mode),
+        .level_rotation     (1'b1),
+        .pwm_gates          (pwm_gates),
+        .sync_pulse         (sync_pulse),
+        .fault              (fault)
+    );
+
+    // Clock generation
+    initial begin
+        clk = 0;
+        forever #(CLK_PERIOD/2) clk = ~clk;
+    end
+
+    // Test counters
+    integer pass_count = 0;
+    integer fail_count = 0;
+
+    task check;
+        input cond;
+        input [8*64:1] msg;
+        begin
+            if (cond) begin
+                $display("[PASS] %0s", msg);
+                pass_count = pass_count + 1;
+            end else begin
+                $display("[FAIL] %0s", msg);
+                fail_count = fail_count + 1;
+            end
+        end
+    endtask
+
+    //=========================================================================
+    // Per-phase output level and reference
+    //=========================================================================
+
+    // Output level of phase k: (S1 - S3) + (S5 - S7), high-side gates
+    function integer level;
+        input integer k;
+        begin
+            level = pwm_gates[8*k] - pwm_gates[8*k+2] + pwm_gates[8*k+4] - pwm_gates[8*k+6];
+        end
+    endfunction
+
+    wire signed [DATA_WIDTH-1:0] ref_a = dut.phase[0].phase_mod.sine_ref;
+    wire signed [DATA_WIDTH-1:0] ref_b = dut.phase[1].phase_mod.sine_ref;
+    wire signed [DATA_WIDTH-1:0] ref_c = dut.phase[2].phase_mod.sine_ref;
+
+    // Shoot-through monitor: high and low side of one leg on together
+    integer overlap = 0;
+    integer j;
+
+    always @(posedge clk) begin
+        for (j = 0; j < 4 * N_PHASES; j = j + 1)
+            if (pwm_gates[2*j] && pwm_gates[2*j+1]) overlap = overlap + 1;
+    end
+
+    //=========================================================================
+    // One output cycle of Fourier coefficients
+    //=========================================================================
+
+    // Gate levels of a, b, c and line a - b: fundamental re/im
+    real g_re [0:3];
+    real g_im [0:3];
+    // References a, b and line a - b: fundamental and 3rd harmonic
+    real r1_re [0:2];
+    real r1_im [0:2];
+    real r3_re [0:2];
+    real r3_im [0:2];
+    real x [0:2];
+    real triplen_ab;
+    integer ref_peak;
+
+    task measure;
+        integer n, i, v;
+        real th, c1, s1, c3, s3;
+        begin
+            for (i = 0; i < 4; i = i + 1) begin
+                g_re[i] = 0.0;
+                g_im[i] = 0.0;
+            end
+            for (i = 0; i < 3; i = i + 1) begin
+                r1_re[i] = 0.0;
+                r1_im[i] = 0.0;
+                r3_re[i] = 0.0;
+                r3_im[i] = 0.0;
+            end
+            triplen_ab = 0.0;
+            ref_peak = 0;
+
+            for (n = 0; n < CYCLE; n = n + 1) begin
+                @(negedge clk);
+                th = 2.0 * PI * n / CYCLE;
+                c1 = $cos(th);
+                s1 = $sin(th);
+                c3 = $cos(3.0 * th);
+                s3 = $sin(3.0 * th);
+
+                for (i = 0; i < 3; i = i + 1) begin
+                    v = level(i);
+                    g_re[i] = g_re[i] + v * c1;
+                    g_im[i] = g_im[i] - v * s1;
+                end
+                v = level(0) - level(1);
+                g_re[3] = g_re[3] + v * c1;
+                g_im[3] = g_im[3] - v * s1;
+
+                x[0] = ref_a;
+                x[1] = ref_b;
+                x[2] = x[0] - x[1];
+                for (i = 0; i < 3; i = i + 1) begin
+                    r1_re[i] = r1_re[i] + x[i] * c1;
+                    r1_im[i] = r1_im[i] - x[i] * s1;
+                    r3_re[i] = r3_re[i] + x[i] * c3;
+                    r3_im[i] = r3_im[i] - x[i] * s3;
+                end
+
+                if (ref_a > ref_peak) ref_peak = ref_a;
+                if (-ref_a > ref_peak) ref_peak = -ref_a;
+                if (ref_b > ref_peak) ref_peak = ref_b;
+                if (-ref_b > ref_peak) ref_peak = -ref_b;
+                if (ref_c > ref_peak) ref_peak = ref_c;
+                if (-ref_c > ref_peak) ref_peak = -ref_c;
+            end
+        end
+    endtask
+
+    // Amplitude (2/N |X|) and angle (deg) of accumulated coefficients
+    function real amplitude;
+        input real re;
+        input real im;
+        begin
+            amplitude = 2.0 * $sqrt(re * re + im * im) / CYCLE;
+        end
+    endfunction
+
+    function real angle;
+        input real re;
+        input real im;
+        begin
+            angle = $atan2(im, re) * 180.0 / PI;
+        end
+    endfunction
+
+    // Phase difference a - other, wrapped to (-180, 180]
+    function real lag;
+        input real a;
+        input real other;
+        real d;
+        begin
+            d = a - other;
+            if (d > 180.0) d = d - 360.0;
+            if (d <= -180.0) d = d + 360.0;
+            lag = d;
+        end
+    endfunction
+
+    // Configure, settle two cycles, measure one
+    task run;
+        input mode;
+        input [2:0] shape;
+        input [DATA_WIDTH-1:0] index;
+        begin
+            @(negedge clk);
+            enable = 0;
+            pwm_mode = mode;
+            ref_shape = shape;
+            mi = index;
+            repeat (10) @(negedge clk);
+            enable = 1;
+            repeat (2 * CYCLE) @(negedge clk);
+            measure;
+        end
+    endtask
+
+    //=========================================================================
+    // Test sequence
+    //=========================================================================
+
+    real fa, fb, fc, lag_b, lag_c, expected, line, ratio;
+    integer i;
+
+    initial begin
+        $display("\n========================================");
+        $display("Three-Phase Inverter Top Testbench");
+        $display("========================================");
+
+        rst_n = 0;
+        enable = 0;
+        pwm_mode = 0;
+        mi = MI;
+        ref_shape = 3'd0;
+        #(CLK_PERIOD * 10);
+        rst_n = 1;
+        #(CLK_PERIOD * 10);
+
+        check(pwm_gates == 0, "all gates low while disabled");
+
+        expected = 2.0 * MI / 32768.0;
+
+        // Sine, LS with rotation, then PS
+        for (i = 0; i < 2; i = i + 1) begin
+            run(i[0], 3'd0, MI);
+            fa = amplitude(g_re[0], g_im[0]);
+            fb = amplitude(g_re[1], g_im[1]);
+            fc = amplitude(g_re[2], g_im[2]);
+            lag_b = lag(angle(g_re[0], g_im[0]), angle(g_re[1], g_im[1]));
+            lag_c = lag(angle(g_re[0], g_im[0]), angle(g_re[2], g_im[2]));
+            $display("  %0s: fundamentals %.3f %.3f %.3f Vdc, b %.2f deg, c %.2f deg behind a",
+                     i ? "PS" : "LS", fa, fb, fc, lag_b, lag_c);
+            check(fa > 0.98 * expected && fa < 1.02 * expected &&
+                  fb > 0.98 * expected && fb < 1.02 * expected &&
+                  fc > 0.98 * expected && fc < 1.02 * expected,
+                  i ? "PS: every phase fundamental = 2 x MI" : "LS: every phase fundamental = 2 x MI");
+            check(lag_b > 119.5 && lag_b < 120.5 && lag_c > -120.5 && lag_c < -119.5,
+                  i ? "PS: b lags a by 120 deg, c leads by 120 deg" :
+                      "LS: b lags a by 120 deg, c leads by 120 deg");
+        end
+
+        // Min-max (SVPWM-equivalent) zero sequence near the MI limit
+        run(1'b0, 3'd2, MI_SVPWM);
+        fa = amplitude(r1_re[0], r1_im[0]);
+        line = amplitude(r1_re[2], r1_im[2]);
+        triplen_ab = amplitude(r3_re[2], r3_im[2]);
+        ratio = amplitude(r3_re[0], r3_im[0]) / fa;
+        $display("  min-max refs: peak %0d, phase 1st %.0f (3rd %.1f%%), line 1st %.0f, line 3rd %.2f LSB",
+                 ref_peak, fa, 100.0 * ratio, line, triplen_ab);
+        check(ref_peak < 32767, "min-max: phase references not saturated at MI 1.144");
+        check(ratio > 0.1, "min-max: zero sequence (3rd) in each phase reference");
+        check(triplen_ab < 2.0, "min-max: no triplens line-to-line (same zero sequence)");
+        check(line > 1.72 * fa && line < 1.745 * fa, "min-max: line reference sqrt(3) x phase");
+
+        line = amplitude(g_re[3], g_im[3]);
+        expected = 1.7320508 * 2.0 * MI_SVPWM / 32768.0;
+        $display("  min-max gates: line fundamental %.3f Vdc (%.3f expected)", line, expected);
+        check(line > 0.98 * expected && line < 1.02 * expected,
+              "min-max: line fundamental sqrt(3) x 2 x MI");
+        check(line > 1.12 * 1.7320508 * 2.0, "min-max: 12% more line voltage than sine at MI 1.0");
+
+        check(overlap == 0, "no shoot-through on any of the 24 gates");
+
+        $display("\n========================================");
+        $display("Tests passed: %0d, failed: %0d", pass_count, fail_count);
+        if (fail_count == 0)
+            $display("*** ALL TESTS PASSED! ***");
+        else
+            $display("*** %0d TEST(S) FAILED ***", fail_count);
+        $display("========================================");
+        $finish;
+    end
+
+endmodule
@@ -0,0 +1,382 @@
+/**
+ * @file inverter_5level_top_tb.cpp
+ * @brief Verilator regression harness for inverter_5level_top
+ *
+ * Runs the top at full speed for many output cycles per scenario (LS, LS
+ * with band rotation, PS; sine reference) and checks the 8 gates every
+ * clock, no waveform needed:
+ * - No shoot-through: high and low of a leg never on together
+ * - Dead time on every edge: a gate only turns on after its complement
+ *   has been off for at least deadtime_cycles clocks
+ * - Level sequence: the output stays within -2..+2, visits every level
+ *   the MI reaches (all five above MI 0.5), and in LS only ever steps to
+ *   an adjacent level (PS bridges switch independently and may coincide)
+ * - Fundamental amplitude 2 x MI within 1%
+ * - Low-order THD (harmonics 2 .. mf / 2) below 1%, and total THD within
+ *   2 points of ideal adjacent-level PWM at the same MI
+ *
+ * The output level is rebuilt from the gates: each leg is at its high
+ * gate's state, and holds its last state while both gates are off (the
+ * dead time only delays the edges), so v = (S1 - S3) + (S5 - S7) in
+ * units of one bridge's DC bus. The record is a whole number of output
+ * cycles (2^p clocks each, freq_50hz = 2^(32-p)), so the harmonics are
+ * exact DFT bins without a window; total THD follows from Parseval.
+ * Any PWM that switches between the two levels around the reference
+ * r = 2 MI sin(x) (LS and PS both do) has the mean square
+ * floor(r)^2 (1 - d) + ceil(r)^2 d, d = r - floor(r), whatever the
+ * carrier, which gives the reference THD.
+ *
+ * pwm_comparator drops pulses shorter than the dead time, so near full MI
+ * (leg duty within deadtime_cycles of the carrier period) the low-order
+ * THD check fails by design; the defaults stay clear of that.
+ *
+ * Build/run (from 03-fpga/): make sim_verilator
+ *            sim/obj_dir/Vinverter_5level_top [-s ls|lsr|ps] [-n 16]
+ *                [-m 26214] [-d 10] [-c 256] [-p 16]
+ *
+ * Exits nonzero if any check fails.
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+#include "Vinverter_5level_top.h"
+#include <verilated.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr int kMiFull = 32768;
+constexpr int kSettleCycles = 2;            // Start-up and first rotation skipped
+constexpr double kFundTol = 0.01;           // Fundamental, relative
+constexpr double kLowThdMax = 1.0;          // Harmonics 2 .. mf / 2, percent
+constexpr double kThdTol = 2.0;             // All harmonics vs ideal, points
+
+struct Scenario {
+    const char *name;
+    bool ps;
+    bool rotation;
+};
+
+const Scenario kScenarios[] = {
+    { "ls",  false, false },
+    { "lsr", false, true  },
+    { "ps",  true,  false },
+};
+
+struct Config {
+    int cycles = 16;                        // Measured output cycles
+    int mi = 26214;                         // modulation_index, 0.8
+    int deadtime = 10;                      // deadtime_cycles
+    int carrier_div = 256;                  // carrier_freq_div, 512-clock carrier
+    int period_bits = 16;                   // 2^p clocks per output cycle
+};
+
+int failures = 0;
+
+void check(bool ok, const char *name, const char *what)
+{
+    printf("[%s] %s: %s\n", ok ? "PASS" : "FAIL", name, what);
+    if (!ok) failures++;
+}
+
+class Dut {
+public:
+    explicit Dut(const Config &cfg, const Scenario &s)
+        : ctx_(new VerilatedContext), top_(new Vinverter_5level_top(ctx_.get()))
+    {
+        top_->clk = 0;
+        top_->rst_n = 0;
+        top_->enable = 0;
+        top_->freq_50hz = 1u << (32 - cfg.period_bits);
+        top_->modulation_index = cfg.mi;
+        top_->ref_shape = 0;
+        top_->thi_k = 0;
+        top_->deadtime_cycles = cfg.deadtime;
+        top_->carrier_freq_div = cfg.carrier_div;
+        top_->pwm_mode = s.ps;
+        top_->level_rotation = s.rotation;
+        for (int i = 0; i < 4; i++) tick();
+        top_->rst_n = 1;
+        tick();
+        top_->enable = 1;
+    }
+
+    ~Dut() { top_->final(); }
+
+    void tick()
+    {
+        top_->clk = 1;
+        top_->eval();
+        ctx_->timeInc(5);
+        top_->clk = 0;
+        top_->eval();
+        ctx_->timeInc(5);
+    }
+
+    // S1..S8 in the order of phase_modulator's gate bus
+    unsigned gates() const
+    {
+        return top_->pwm1_ch1_high | top_->pwm1_ch1_low << 1 |
+               top_->pwm1_ch2_high << 2 | top_->pwm1_ch2_low << 3 |
+               top_->pwm2_ch1_high << 4 | top_->pwm2_ch1_low << 5 |
+               top_->pwm2_ch2_high << 6 | top_->pwm2_ch2_low << 7;
+    }
+
+    uint64_t time_ns() const { return ctx_->time(); }
+
+private:
+    std::unique_ptr<VerilatedContext> ctx_;
+    std::unique_ptr<Vinverter_5level_top> top_;
+};
+
+// Per-leg gate checks and the level rebuilt from the leg states
+class GateMonitor {
+public:
+    explicit GateMonitor(int deadtime) : deadtime_(deadtime) {}
+
+    int step(unsigned g, int64_t clock)
+    {
+        for (int leg = 0; leg < 4; leg++) {
+            const bool hi = g >> (2 * leg) & 1;
+            const bool lo = g >> (2 * leg + 1) & 1;
+            Leg &l = legs_[leg];
+
+            if (hi && lo) shoot_through++;
+            if (hi && !l.hi) turn_on(clock, l.lo_off);
+            if (lo && !l.lo) turn_on(clock, l.hi_off);
+            if (!hi && l.hi) l.hi_off = clock;
+            if (!lo && l.lo) l.lo_off = clock;
+            if (hi != lo) l.state = hi;         // Both off: hold
+            l.hi = hi;
+            l.lo = lo;
+        }
+        return legs_[0].state - legs_[1].state + legs_[2].state - legs_[3].state;
+    }
+
+    int64_t shoot_through = 0;
+    int64_t edges = 0;
+    int64_t short_gaps = 0;
+    int64_t min_gap = INT64_MAX;
+
+private:
+    struct Leg {
+        bool hi = false, lo = false;
+        int state = 0;
+        int64_t hi_off = -1, lo_off = -1;   // Clock the gate last turned off
+    };
+
+    // Complement must have been off since the clock it dropped
+    void turn_on(int64_t clock, int64_t other_off)
+    {
+        if (other_off < 0) return;          // Never on since enable
+        const int64_t gap = clock - other_off;
+        edges++;
+        if (gap < min_gap) min_gap = gap;
+        if (gap < deadtime_) short_gaps++;
+    }
+
+    int deadtime_;
+    Leg legs_[4];
+};
+
+struct Spectrum {
+    double fundamental = 0.0;
+    double low_thd = 0.0;                   // Percent
+    double thd = 0.0;                       // Percent
+};
+
+// Harmonics of a record of whole output cycles, 2^p clocks each
+Spectrum analyze(const std::vector<int8_t> &v, int period_bits, int h_max)
+{
+    const size_t period = size_t{1} << period_bits;
+    std::vector<double> cos_t(period), sin_t(period);
+    for (size_t i = 0; i < period; i++) {
+        cos_t[i] = std::cos(2.0 * M_PI * i / period);
+        sin_t[i] = std::sin(2.0 * M_PI * i / period);
+    }
+
+    const double n = static_cast<double>(v.size());
+    double sum = 0.0, sum_sq = 0.0;
+    for (int8_t x : v) {
+        sum += x;
+        sum_sq += x * x;
+    }
+
+    auto amplitude = [&](int h) {
+        double re = 0.0, im = 0.0;
+        for (size_t i = 0; i < v.size(); i++) {
+            const size_t k = (i * h) & (period - 1);
+            re += v[i] * cos_t[k];
+            im += v[i] * sin_t[k];
+        }
+        return 2.0 * std::sqrt(re * re + im * im) / n;
+    };
+
+    Spectrum s;
+    s.fundamental = amplitude(1);
+    double low_sq = 0.0;
+    for (int h = 2; h <= h_max; h++) {
+        const double a = amplitude(h);
+        low_sq += a * a;
+    }
+    const double dc = sum / n;
+    const double ac_sq = sum_sq / n - dc * dc;      // Mean square, Parseval
+    const double fund_sq = s.fundamental * s.fundamental / 2.0;
+    s.low_thd = 100.0 * std::sqrt(low_sq / 2.0 / fund_sq);
+    s.thd = 100.0 * std::sqrt(std::fmax(ac_sq - fund_sq, 0.0) / fund_sq);
+    return s;
+}
+
+// THD of ideal adjacent-level PWM of 2 x mi / kMiFull, percent
+double ideal_thd(int mi)
+{
+    constexpr int kSteps = 1 << 16;
+    const double amplitude = 2.0 * mi / kMiFull;
+    double sum_sq = 0.0;
+    for (int i = 0; i < kSteps; i++) {
+        const double r = amplitude * std::sin(2.0 * M_PI * (i + 0.5) / kSteps);
+        const double lo = std::floor(r);
+        const double d = r - lo;
+        sum_sq += lo * lo * (1.0 - d) + (lo + 1.0) * (lo + 1.0) * d;
+    }
+    const double fund_sq = amplitude * amplitude / 2.0;
+    return 100.0 * std::sqrt(sum_sq / kSteps / fund_sq - 1.0);
+}
+
+void run(const Config &cfg, const Scenario &s)
+{
+    const int64_t period = int64_t{1} << cfg.period_bits;
+    const int64_t settle = kSettleCycles * period;
+    const int mf = static_cast<int>(period / (2 * cfg.carrier_div));
+    const bool five_levels = 2 * cfg.mi > kMiFull;
+
+    Dut dut(cfg, s);
+    GateMonitor mon(cfg.deadtime);
+    std::vector<int8_t> v;
+    v.reserve(static_cast<size_t>(cfg.cycles * period));
+    int64_t level_hist[5] = {0};
+    int64_t wide_steps = 0;
+    int prev = 0;
+
+    for (int64_t clock = 0; clock < settle + cfg.cycles * period; clock++) {
+        dut.tick();
+        const int level = mon.step(dut.gates(), clock);
+        if (clock < settle) {
+            prev = level;
+            continue;
+        }
+        if (std::abs(level - prev) > 1) wide_steps++;
+        level_hist[level + 2]++;
+        v.push_back(static_cast<int8_t>(level));
+        prev = level;
+    }
+
+    const Spectrum sp = analyze(v, cfg.period_bits, mf / 2);
+    const double expected = 2.0 * cfg.mi / kMiFull;
+    const double thd_ideal = ideal_thd(cfg.mi);
+
+    printf("\n=== %s: MI %d, dead time %d, mf %d, %d cycles (%.3f ms simulated) ===\n",
+           s.name, cfg.mi, cfg.deadtime, mf, cfg.cycles, dut.time_ns() * 1e-6);
+    printf("  levels -2..+2: %lld %lld %lld %lld %lld clocks\n",
+           (long long)level_hist[0], (long long)level_hist[1], (long long)level_hist[2],
+           (long long)level_hist[3], (long long)level_hist[4]);
+    printf("  gate edges %lld, shortest dead time %lld clocks, steps > 1 level %lld\n",
+           (long long)mon.edges, (long long)(mon.edges ? mon.min_gap : 0), (long long)wide_steps);
+    printf("  fundamental %.4f (expected %.4f), THD %.2f%% (ideal %.2f%%, h <= %d: %.3f%%)\n",
+           sp.fundamental, expected, sp.thd, thd_ideal, mf / 2, sp.low_thd);
+
+    bool levels_ok = true;
+    for (int l = -2; l <= 2; l++) {
+        const bool reached = std::abs(l) <= (five_levels ? 2 : 1);
+        levels_ok &= (level_hist[l + 2] > 0) == reached;
+    }
+
+    check(mon.shoot_through == 0, s.name, "no shoot-through on any leg");
+    check(mon.edges > 0 && mon.short_gaps == 0, s.name, "dead time on every gate edge");
+    check(levels_ok, s.name, five_levels ? "all five levels used" : "three inner levels used");
+    if (!s.ps) check(wide_steps == 0, s.name, "LS output only steps to adjacent levels");
+    check(std::fabs(sp.fundamental - expected) < kFundTol * expected, s.name,
+          "fundamental 2 x MI");
+    check(sp.low_thd < kLowThdMax, s.name, "low-order THD below 1%");
+    check(std::fabs(sp.thd - thd_ideal) < kThdTol, s.name, "THD of adjacent-level PWM");
+}
+
+bool parse_int(const char *s, long lo, long hi, long *out)
+{
+    char *end;
+    long v = strtol(s, &end, 0);
+    if (*end || v < lo || v > hi) return false;
+    *out = v;
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    Config cfg;
+    const Scenario *only = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        long v = 0;
+        bool ok = i + 1 < argc;
+        if (ok && !std::strcmp(argv[i], "-s")) {
+            ok = false;
+            for (const Scenario &s : kScenarios) {
+                if (!std::strcmp(argv[i + 1], s.name)) {
+                    only = &s;
+                    ok = true;
+                }
+            }
+            i++;
+        } else if (ok && !std::strcmp(argv[i], "-n")) {
+            ok = parse_int(argv[++i], 1, 1024, &v);
+            cfg.cycles = static_cast<int>(v);
+        } else if (ok && !std::strcmp(argv[i], "-m")) {
+            ok = parse_int(argv[++i], 1, 32767, &v);
+            cfg.mi = static_cast<int>(v);
+        } else if (ok && !std::strcmp(argv[i], "-d")) {
+            ok = parse_int(argv[++i], 0, 255, &v);
+            cfg.deadtime = static_cast<int>(v);
+        } else if (ok && !std::strcmp(argv[i], "-c")) {
+            ok = parse_int(argv[++i], 16, 65535, &v);
+            cfg.carrier_div = static_cast<int>(v);
+        } else if (ok && !std::strcmp(argv[i], "-p")) {
+            ok = parse_int(argv[++i], 10, 24, &v);
+            cfg.period_bits = static_cast<int>(v);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            fprintf(stderr, "Usage: %s [-s ls|lsr|ps] [-n 16] [-m 26214] [-d 10] [-c 256] "
+                            "[-p 16]\n", argv[0]);
+            return 1;
+        }
+    }
+    if ((int64_t{1} << cfg.period_bits) < 8 * cfg.carrier_div) {
+        fprintf(stderr, "Carrier must be at least 4x the output frequency\n");
+        return 1;
+    }
+
+    printf("5-level inverter Verilator regression\n");
+    for (const Scenario &s : kScenarios) {
+        if (!only || only == &s) run(cfg, s);
+    }
+
+    printf("\n========================================\n");
+    if (failures == 0) {
+        printf("*** ALL TESTS PASSED! ***\n");
+    } else {
+        printf("*** %d TEST(S) FAILED ***\n", failures);
+    }
+    printf("========================================\n");
+    return failures == 0 ? 0 : 1;
+}
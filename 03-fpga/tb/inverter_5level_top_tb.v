@@ -32,6 +32,8 @@ module inverter_5level_top_tb;
     reg [DATA_WIDTH-1:0]        modulation_index;
     reg [DEADTIME_WIDTH-1:0]    deadtime_cycles;
     reg [CARRIER_DIV_WIDTH-1:0] carrier_freq_div;
+    reg                         pwm_mode;
+    reg                         level_rotation;
 
     // H-Bridge 1 outputs
     wire pwm1_ch1_high, pwm1_ch1_low;
@@ -57,8 +59,12 @@ module inverter_5level_top_tb;
         .enable             (enable),
         .freq_50hz          (freq_50hz),
         .modulation_index   (modulation_index),
+        .ref_shape          (3'd0),             // Plain sine
+        .thi_k              (16'd0),
         .deadtime_cycles    (deadtime_cycles),
         .carrier_freq_div   (carrier_freq_div),
+        .pwm_mode           (pwm_mode),
+        .level_rotation     (level_rotation),
         .pwm1_ch1_high      (pwm1_ch1_high),
         .pwm1_ch1_low       (pwm1_ch1_low),
         .pwm1_ch2_high      (pwm1_ch2_high),
@@ -102,6 +108,8 @@ module inverter_5level_top_tb;
         carrier_freq_div = 100;             // ~500kHz carrier (for fast sim)
 
         modulation_index = 16384;           // 50% MI (0.5 * 32768)
+        pwm_mode = 0;                       // Level-shifted carriers
+        level_rotation = 1;                 // Swap LS bands every cycle
         deadtime_cycles = 100;              // 1μs dead-time @ 100MHz
 
         // Reset
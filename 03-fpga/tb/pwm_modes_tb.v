@@ -0,0 +1,382 @@
+/**
+ * @file pwm_modes_tb.v
+ * @brief Output spectrum of level-shifted vs phase-shifted carrier PWM
+ *
+ * Runs inverter_5level_top three times at MI = 0.8:
+ * - LS, no rotation
+ * - LS with level rotation
+ * - PS (full-range carriers 90 deg apart)
+ * and then each reference shape at its modulation limit (LS), and the
+ * SHE staircase at MI 0.9.
+ *
+ * The output level (H-bridge 1 + H-bridge 2, in Vdc units, from the
+ * high-side gates) is recorded as a list of level changes over exactly two
+ * output cycles, and its Fourier series is integrated exactly from those
+ * edges. Timing is chosen so everything is periodic in the window:
+ *   output period = 65536 clocks (freq_increment = 65536, ~1526 Hz)
+ *   carrier period = 512 clocks (freq_div = 256, ~195 kHz, mf = 128)
+ *
+ * Checks:
+ * - Fundamental = 2 x MI in both modes, all five levels used
+ * - PS cancels the 1x/2x carrier sidebands (first cluster at 4 x fc)
+ * - LS alone loads the inner bridge; rotation and PS share power and
+ *   switching equally between the bridges
+ * - THI and min-max stay linear up to MI 1.155 (+15% fundamental over
+ *   sine at MI 1.0); NLC reaches +16% at MI 1.4 switching each gate only
+ *   at the level steps
+ * - SHE: fundamental 2 x MI (table grid 1/128), 5th and 7th eliminated,
+ *   three steps per quarter cycle
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-24
+ */
+
+`timescale 1ns / 1ps
+
+module pwm_modes_tb;
+
+    // Parameters
+    parameter CLK_PERIOD = 10;              // 100 MHz clock
+    parameter DATA_WIDTH = 16;
+    parameter PHASE_WIDTH = 32;
+    parameter DEADTIME_WIDTH = 8;
+    parameter CARRIER_DIV_WIDTH = 16;
+
+    localparam FREQ_DIV  = 256;             // Carrier period 512 clocks
+    localparam FREQ_INC  = 65536;           // Output period 65536 clocks
+    localparam CYCLE     = 65536;
+    localparam WINDOW    = 2 * CYCLE;       // Rotation period
+    localparam H_FUND    = 2;               // Fundamental in window bins
+    localparam H_FC      = WINDOW / 512;    // Carrier frequency in window bins
+    localparam H_MAX     = 4 * H_FC + 60;
+    localparam BAND      = 40;              // Sideband half width (bins)
+    localparam MAX_EDGES = 16384;
+    localparam MI        = 26214;           // 0.8
+    localparam MI_FULL   = 32767;           // 1.0
+    localparam MI_THI    = 37837;           // 1.155, THI / min-max limit
+    localparam MI_NLC    = 45875;           // 1.4
+    localparam MI_SHE    = 29491;           // 0.9
+    localparam THI_K     = 5461;            // 1/6
+
+    real PI = 3.14159265358979;
+
+    // Testbench signals
+    reg                         clk;
+    reg                         rst_n;
+    reg                         enable;
+    reg                         pwm_mode;
+    reg                         level_rotation;
+    reg [DATA_WIDTH-1:0]        mi;
+    reg [2:0]                   ref_shape;
+
+    wire pwm1_ch1_high, pwm1_ch1_low;
+    wire pwm1_ch2_high, pwm1_ch2_low;
+    wire pwm2_ch1_high, pwm2_ch1_low;
+    wire pwm2_ch2_high, pwm2_ch2_low;
+    wire sync_pulse;
+    wire fault;
+
+    // DUT instantiation
+    inverter_5level_top #(
+        .DATA_WIDTH         (DATA_WIDTH),
+        .PHASE_WIDTH        (PHASE_WIDTH),
+        .DEADTIME_WIDTH     (DEADTIME_WIDTH),
+        .CARRIER_DIV_WIDTH  (CARRIER_DIV_WIDTH)
+    ) dut (
+        .clk                (clk),
+        .rst_n              (rst_n),
+        .enable             (enable),
+        .freq_50hz          (FREQ_INC),
+        .modulation_index   (mi),
+        .ref_shape          (ref_shape),
+        .thi_k              (THI_K[DATA_WIDTH-1:0]),
+        .deadtime_cycles    (8'd0),
+        .carrier_freq_div   (FREQ_DIV),
+        .pwm_mode           (pwm_mode),
+        .level_rotation     (level_rotation),
+        .pwm1_ch1_high      (pwm1_ch1_high),
+        .pwm1_ch1_low       (pwm1_ch1_low),
+        .pwm1_ch2_high      (pwm1_ch2_high),
+        .pwm1_ch2_low       (pwm1_ch2_low),
+        .pwm2_ch1_high      (pwm2_ch1_high),
+        .pwm2_ch1_low       (pwm2_ch1_low),
+        .pwm2_ch2_high      (pwm2_ch2_high),
+        .pwm2_ch2_low       (pwm2_ch2_low),
+        .sync_pulse         (sync_pulse),
+        .fault              (fault)
+    );
+
+    // Clock generation
+    initial begin
+        clk = 0;
+        forever #(CLK_PERIOD/2) clk = ~clk;
+    end
+
+    // Test counters
+    integer pass_count = 0;
+    integer fail_count = 0;
+
+    task check;
+        input cond;
+        input [8*64:1] msg;
+        begin
+            if (cond) begin
+                $display("[PASS] %0s", msg);
+                pass_count = pass_count + 1;
+            end else begin
+                $display("[FAIL] %0s", msg);
+                fail_count = fail_count + 1;
+            end
+        end
+    endtask
+
+    //=========================================================================
+    // Edge recorder
+    //=========================================================================
+
+    // Bridge levels from the high-side gates (leg A - leg B)
+    wire signed [2:0] v1 = $signed({2'b00, pwm1_ch1_high}) - $signed({2'b00, pwm1_ch2_high});
+    wire signed [2:0] v2 = $signed({2'b00, pwm2_ch1_high}) - $signed({2'b00, pwm2_ch2_high});
+
+    reg     measuring = 0;
+    integer t_clk;
+    integer n_edges;
+    integer e_t  [0:MAX_EDGES-1];
+    integer e_v1 [0:MAX_EDGES-1];
+    integer e_v2 [0:MAX_EDGES-1];
+    integer sw1, sw2;                       // High-side transitions per bridge
+    reg [4:0] levels_seen;
+    reg [3:0] gates_d;
+
+    always @(posedge clk) begin
+        if (measuring) begin
+            if (t_clk == 0 || v1 != e_v1[n_edges-1] || v2 != e_v2[n_edges-1]) begin
+                if (n_edges < MAX_EDGES) begin
+                    e_t[n_edges]  = t_clk;
+                    e_v1[n_edges] = v1;
+                    e_v2[n_edges] = v2;
+                    n_edges = n_edges + 1;
+                end
+            end
+            if (t_clk > 0) begin
+                sw1 = sw1 + (pwm1_ch1_high != gates_d[0]) + (pwm1_ch2_high != gates_d[1]);
+                sw2 = sw2 + (pwm2_ch1_high != gates_d[2]) + (pwm2_ch2_high != gates_d[3]);
+            end
+            levels_seen[v1 + v2 + 2] = 1'b1;
+            t_clk = t_clk + 1;
+        end
+        gates_d <= {pwm2_ch2_high, pwm2_ch1_high, pwm1_ch2_high, pwm1_ch1_high};
+    end
+
+    //=========================================================================
+    // Spectrum of the recorded window
+    //=========================================================================
+
+    real fund, thd, band1, band2, band4, first_hz, p_share, sw_share, h5, h7;
+    real f_out_hz;
+
+    // Fourier coefficient of bin h for the selected signal (0 = total,
+    // 1 = bridge 1, 2 = bridge 2)
+    task coeff;
+        input integer h;
+        input integer which;
+        output real re;
+        output real im;
+        integer i, v, tb;
+        real k, th, sa, ca, sb, cb;
+        begin
+            re = 0.0;
+            im = 0.0;
+            k = 2.0 * PI * h;
+            sa = 0.0;                       // First edge is at t = 0
+            ca = 1.0;
+            for (i = 0; i < n_edges; i = i + 1) begin
+                v = (which == 1) ? e_v1[i] : (which == 2) ? e_v2[i] : e_v1[i] + e_v2[i];
+                tb = (i + 1 < n_edges) ? e_t[i + 1] : WINDOW;
+                th = k * tb / WINDOW;
+                sb = $sin(th);
+                cb = $cos(th);
+                // (1/W) * integral of v * exp(-j*w*t) over the segment
+                re = re + v * (sb - sa) / k;
+                im = im + v * (cb - ca) / k;
+                sa = sb;
+                ca = cb;
+            end
+        end
+    endtask
+
+    task analyze;
+        integer h;
+        real re, im, a, sum, b1, b2, b4;
+        real re1, im1, re2, im2, p1, p2;
+        begin
+            coeff(H_FUND, 0, re, im);
+            fund = 2.0 * $sqrt(re * re + im * im);
+            coeff(5 * H_FUND, 0, re1, im1);
+            h5 = 2.0 * $sqrt(re1 * re1 + im1 * im1) / fund;
+            coeff(7 * H_FUND, 0, re1, im1);
+            h7 = 2.0 * $sqrt(re1 * re1 + im1 * im1) / fund;
+
+            // Bridge powers into a resistive load (current in phase with
+            // the total fundamental)
+            coeff(H_FUND, 1, re1, im1);
+            coeff(H_FUND, 2, re2, im2);
+            p1 = re1 * re + im1 * im;
+            p2 = re2 * re + im2 * im;
+            p_share = p1 / (p1 + p2);
+            sw_share = sw1 * 1.0 / (sw1 + sw2);
+
+            sum = 0.0;
+            b1 = 0.0;
+            b2 = 0.0;
+            b4 = 0.0;
+            first_hz = -1.0;
+            for (h = 1; h <= H_MAX; h = h + 1) begin
+                if (h != H_FUND) begin
+                    coeff(h, 0, re, im);
+                    a = 2.0 * $sqrt(re * re + im * im);
+                    sum = sum + a * a;
+                    if (h >= H_FC - BAND && h <= H_FC + BAND) b1 = b1 + a * a;
+                    if (h >= 2 * H_FC - BAND && h <= 2 * H_FC + BAND) b2 = b2 + a * a;
+                    if (h >= 4 * H_FC - BAND && h <= 4 * H_FC + BAND) b4 = b4 + a * a;
+                    if (first_hz < 0.0 && h > H_FUND && a > 0.01 * fund)
+                        first_hz = h * f_out_hz / H_FUND;
+                end
+            end
+            thd = 100.0 * $sqrt(sum) / fund;
+            band1 = 100.0 * $sqrt(b1) / fund;
+            band2 = 100.0 * $sqrt(b2) / fund;
+            band4 = 100.0 * $sqrt(b4) / fund;
+        end
+    endtask
+
+    // Configure, settle one cycle, record two cycles from a phase wrap
+    task run_mode;
+        input mode;
+        input rotation;
+        input [8*12:1] name;
+        begin
+            @(negedge clk);
+            enable = 0;
+            pwm_mode = mode;
+            level_rotation = rotation;
+            repeat (10) @(negedge clk);
+            enable = 1;
+            repeat (CYCLE) @(negedge clk);
+            @(negedge dut.sine_phase[7]);
+            @(negedge clk);
+            t_clk = 0;
+            n_edges = 0;
+            sw1 = 0;
+            sw2 = 0;
+            levels_seen = 0;
+            measuring = 1;
+            repeat (WINDOW) @(negedge clk);
+            measuring = 0;
+            analyze;
+            $display("  %0s: fund %.3f Vdc, first %.0f kHz, THD %.1f%%, bands fc %.1f%% 2fc %.1f%% 4fc %.1f%%",
+                     name, fund, first_hz / 1000.0, thd, band1, band2, band4);
+            $display("  %0s  bridge 1: %.1f%% power, %.1f%% switching, levels %b, %0d edges",
+                     "            ", 100.0 * p_share, 100.0 * sw_share, levels_seen, n_edges);
+        end
+    endtask
+
+    //=========================================================================
+    // Test sequence
+    //=========================================================================
+
+    real ls_fund, ls_band1, ls_p, ls_sw, sine_fund;
+    real lr_p, lr_sw, lr_thd, ls_thd;
+
+    initial begin
+        $display("\n========================================");
+        $display("LS vs PS Carrier PWM Spectrum Testbench");
+        $display("========================================");
+
+        f_out_hz = 100.0e6 * FREQ_INC / 4294967296.0;
+        rst_n = 0;
+        enable = 0;
+        pwm_mode = 0;
+        level_rotation = 0;
+        mi = MI;
+        ref_shape = 3'd0;
+        gates_d = 0;
+        #(CLK_PERIOD * 10);
+        rst_n = 1;
+
+        // Level-shifted, fixed bands
+        run_mode(1'b0, 1'b0, "LS fixed");
+        ls_fund = fund;
+        ls_band1 = band1;
+        ls_thd = thd;
+        ls_p = p_share;
+        ls_sw = sw_share;
+        check(fund > 1.55 && fund < 1.65, "LS fundamental = 2 x MI");
+        check(levels_seen == 5'b11111, "LS uses all five levels");
+        check(ls_p > 0.6, "LS without rotation loads the inner bridge");
+
+        // Level-shifted with rotation
+        run_mode(1'b0, 1'b1, "LS rotated");
+        lr_p = p_share;
+        lr_sw = sw_share;
+        lr_thd = thd;
+        check(lr_p > 0.48 && lr_p < 0.52, "LS rotation balances bridge power");
+        check(lr_sw > 0.47 && lr_sw < 0.53, "LS rotation balances bridge switching");
+        check(lr_thd > 0.95 * ls_thd && lr_thd < 1.05 * ls_thd, "LS rotation leaves the spectrum unchanged");
+
+        // Phase-shifted
+        run_mode(1'b1, 1'b0, "PS");
+        check(fund > 1.55 && fund < 1.65, "PS fundamental = 2 x MI");
+        check(levels_seen == 5'b11111, "PS uses all five levels");
+        check(band1 < 0.1 * ls_band1, "PS cancels the carrier-frequency sidebands");
+        check(first_hz > 3.5 * 100.0e6 / (2.0 * FREQ_DIV), "PS first harmonic cluster at 4 x fc");
+        check(p_share > 0.48 && p_share < 0.52 && sw_share > 0.47 && sw_share < 0.53,
+              "PS shares power and switching equally");
+
+        // Reference shaping at each shape's modulation limit
+        $display("\nReference shaping (LS):");
+        mi = MI_FULL;
+        run_mode(1'b0, 1'b0, "sine 1.0");
+        sine_fund = fund;
+        check(fund > 1.95 && fund < 2.05, "sine: fundamental = 2 x MI at MI 1.0");
+
+        ref_shape = 3'd1;
+        mi = MI_THI;
+        run_mode(1'b0, 1'b0, "THI 1.155");
+        check(fund > 1.14 * sine_fund && fund < 1.17 * sine_fund,
+              "THI: linear to MI 1.155, +15% fundamental");
+
+        ref_shape = 3'd2;
+        run_mode(1'b0, 1'b0, "minmax 1.155");
+        check(fund > 1.14 * sine_fund && fund < 1.17 * sine_fund,
+              "min-max: linear to MI 1.155, +15% fundamental");
+
+        ref_shape = 3'd3;
+        mi = MI_NLC;
+        run_mode(1'b0, 1'b0, "NLC 1.4");
+        check(fund > 1.15 * sine_fund, "NLC: staircase fundamental +15% over sine");
+        check(levels_seen == 5'b11111 && sw1 + sw2 <= 16,
+              "NLC: five levels, switching only at the level steps");
+
+        // SHE staircase, nearest table entry (MI 115/128)
+        ref_shape = 3'd4;
+        mi = MI_SHE;
+        run_mode(1'b0, 1'b0, "SHE 0.9");
+        $display("  %0s  h5 %.3f%%, h7 %.3f%% of the fundamental", "            ",
+                 100.0 * h5, 100.0 * h7);
+        check(fund > 0.99 * 2.0 * 115.0 / 128.0 && fund < 1.01 * 2.0 * 115.0 / 128.0,
+              "SHE: fundamental = 2 x MI (table grid)");
+        check(h5 < 0.002 && h7 < 0.002, "SHE: 5th and 7th eliminated");
+        check(sw1 + sw2 == 24, "SHE: three steps per quarter cycle");
+
+        $display("\n========================================");
+        $display("Tests passed: %0d, failed: %0d", pass_count, fail_count);
+        if (fail_count == 0)
+            $display("*** ALL TESTS PASSED! ***");
+        else
+            $display("*** %0d TEST(S) FAILED ***", fail_count);
+        $display("========================================");
+        $finish;
+    end
+
+endmodule
@@ -0,0 +1,204 @@
+/**
+ * @file sine_generator_tb.v
+ * @brief Sine reference accuracy and sample dump for the SFDR calculation
+ *
+ * Runs sine_generator (shape 0, MI = 1.0) over one coherent record of
+ * 2^RECORD_BITS samples: freq_increment = K * 2^(32 - RECORD_BITS) with K
+ * odd gives exactly K cycles and visits every phase step once. The
+ * samples of the default 256-entry quarter table are written to
+ * sine_samples.txt for 06-tools/sine/sine_model (bit-exact check and
+ * SFDR); a second instance runs the 1024-entry block RAM table.
+ *
+ * Checks:
+ * - Output is 0 while disabled
+ * - Every sample within MAX_ERROR LSB of MI * sin(2 pi K n / 2^RECORD_BITS),
+ *   with sample 0 LATENCY clocks after enable (a one-clock slip is
+ *   thousands of LSB)
+ * - Full-scale peaks reached
+ * - phase output is the phase of the sample on sine_out
+ * - Half-wave symmetry: sample n + 2^(RECORD_BITS-1) is -sample n
+ *   (within 1 LSB, the MI scaling rounds half up)
+ * - Same accuracy with QUARTER_ADDR_WIDTH = 10
+ *
+ * Run (from 03-fpga/):
+ *   make sim_sine
+ *   (or iverilog -o sine_generator_tb.vvp rtl/sine_generator.v
+ *       tb/sine_generator_tb.v && vvp sine_generator_tb.vvp
+ *    then sine_model -c sine_samples.txt)
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+`timescale 1ns / 1ps
+
+module sine_generator_tb;
+
+    // Parameters
+    parameter CLK_PERIOD = 10;              // 100 MHz clock
+    parameter DATA_WIDTH = 16;
+    parameter PHASE_WIDTH = 32;
+
+    localparam RECORD_BITS = 18;
+    localparam RECORD      = 1 << RECORD_BITS;
+    localparam K           = 4099;          // Cycles per record, odd
+    localparam FREQ_INC    = K << (32 - RECORD_BITS);
+    localparam MI          = 32767;         // 1.0
+    localparam LATENCY     = 7;             // Clocks from accumulator to sine_out
+    localparam MAX_ERROR   = 3.0;           // LSB: table rounding, interpolation, MI rounding
+
+    real PI = 3.14159265359;
+
+    // Testbench signals
+    reg                         clk;
+    reg                         rst_n;
+    reg                         enable;
+    wire signed [DATA_WIDTH-1:0] sine_out;
+    wire signed [DATA_WIDTH-1:0] sine_out_bram;
+    wire [7:0]                  phase;
+
+    // DUT instantiation: 256-entry quarter table (default)
+    sine_generator #(
+        .DATA_WIDTH         (DATA_WIDTH),
+        .PHASE_WIDTH        (PHASE_WIDTH)
+    ) dut (
+        .clk                (clk),
+        .rst_n              (rst_n),
+        .enable             (enable),
+        .freq_increment     (FREQ_INC[PHASE_WIDTH-1:0]),
+        .modulation_index   (MI[DATA_WIDTH-1:0]),
+        .shape              (2'd0),
+        .thi_k              ({DATA_WIDTH{1'b0}}),
+        .sine_out           (sine_out),
+        .phase              (phase)
+    );
+
+    // 1024-entry quarter table (block RAM)
+    sine_generator #(
+        .DATA_WIDTH         (DATA_WIDTH),
+        .PHASE_WIDTH        (PHASE_WIDTH),
+        .QUARTER_ADDR_WIDTH (10)
+    ) dut_bram (
+        .clk                (clk),
+        .rst_n              (rst_n),
+        .enable             (enable),
+        .freq_increment     (FREQ_INC[PHASE_WIDTH-1:0]),
+        .modulation_index   (MI[DATA_WIDTH-1:0]),
+        .shape              (2'd0),
+        .thi_k              ({DATA_WIDTH{1'b0}}),
+        .sine_out           (sine_out_bram),
+        .phase              ()
+    );
+
+    // Clock generation
+    initial begin
+        clk = 0;
+        forever #(CLK_PERIOD/2) clk = ~clk;
+    end
+
+    // Test counters
+    integer pass_count = 0;
+    integer fail_count = 0;
+
+    task check;
+        input cond;
+        input [8*64:1] msg;
+        begin
+            if (cond) begin
+                $display("[PASS] %0s", msg);
+                pass_count = pass_count + 1;
+            end else begin
+                $display("[FAIL] %0s", msg);
+                fail_count = fail_count + 1;
+            end
+        end
+    endtask
+
+    //=========================================================================
+    // Test stimulus
+    //=========================================================================
+
+    reg signed [DATA_WIDTH-1:0] rec [0:RECORD-1];
+    integer n, fd, vmax, vmin, asym, phase_err;
+    reg [31:0] acc;
+    real ideal, err, worst, worst_bram;
+
+    initial begin
+        $display("\n========================================");
+        $display("Sine Generator Accuracy Testbench");
+        $display("========================================");
+
+        // Initialize
+        rst_n = 0;
+        enable = 0;
+
+        #(CLK_PERIOD * 10);
+        rst_n = 1;
+        #(CLK_PERIOD * 10);
+
+        check(sine_out == 0 && sine_out_bram == 0, "output 0 while disabled");
+
+        // Accumulator starts at 0 on the first enabled clock
+        @(negedge clk);
+        enable = 1;
+        repeat (LATENCY) @(posedge clk);
+
+        fd = $fopen("sine_samples.txt", "w");
+        worst = 0.0;
+        worst_bram = 0.0;
+        vmax = 0;
+        vmin = 0;
+        acc = 0;
+        phase_err = 0;
+        for (n = 0; n < RECORD; n = n + 1) begin
+            @(negedge clk);
+            rec[n] = sine_out;
+            $fwrite(fd, "%0d\n", sine_out);
+
+            ideal = 32767.0 * MI / 32768.0 * $sin(2.0 * PI * K * n / RECORD);
+            err = sine_out - ideal;
+            if (err < 0) err = -err;
+            if (err > worst) worst = err;
+            err = sine_out_bram - ideal;
+            if (err < 0) err = -err;
+            if (err > worst_bram) worst_bram = err;
+
+            if (sine_out > vmax) vmax = sine_out;
+            if (sine_out < vmin) vmin = sine_out;
+
+            if (phase != acc[31:24]) phase_err = phase_err + 1;
+            acc = acc + FREQ_INC;
+        end
+        $fclose(fd);
+
+        $display("  %0d samples, K = %0d, written to sine_samples.txt", RECORD, K);
+        $display("  max error: %0.2f LSB (256 entries), %0.2f LSB (1024 entries)",
+                 worst, worst_bram);
+        $display("  peaks: %0d / %0d", vmax, vmin);
+
+        check(worst <= MAX_ERROR, "256-entry quarter table within 3 LSB of MI * sin");
+        check(vmax >= 32765 && vmin <= -32765, "full-scale peaks reached");
+        check(phase_err == 0, "phase output aligned with sine_out");
+
+        asym = 0;
+        for (n = 0; n < RECORD / 2; n = n + 1) begin
+            if (rec[n] + rec[n + RECORD / 2] > 1 || rec[n] + rec[n + RECORD / 2] < -1)
+                asym = asym + 1;
+        end
+        check(asym == 0, "half-wave symmetric within 1 LSB");
+
+        check(worst_bram <= MAX_ERROR, "1024-entry quarter table within 3 LSB of MI * sin");
+
+        $display("  SFDR: sine_model -c sine_samples.txt (06-tools/sine)");
+
+        $display("\n========================================");
+        $display("Tests passed: %0d, failed: %0d", pass_count, fail_count);
+        if (fail_count == 0)
+            $display("*** ALL TESTS PASSED! ***");
+        else
+            $display("*** %0d TEST(S) FAILED ***", fail_count);
+        $display("========================================");
+        $finish;
+    end
+
+endmodule
@@ -0,0 +1,591 @@
+#!/usr/bin/env python3
+"""
+Icarus Verilog Regression Driver for all testbenches
+
+Discovers the testbenches of every RTL suite in the repository, builds each
+one once and runs them in parallel with a per-test timeout, then prints a
+pass/fail and simulated-time summary.
+
+Suites (paths relative to the repository root):
+    fpga       03-fpga/tb/*_tb.v
+    hybrid     02-embedded/stm32-fpga-hybrid/fpga/tb/*_tb.v
+    riscv      02-embedded/riscv/sim/testbench/tb_*.v, sim/test_*.v
+    riscv-soc  02-embedded/riscv-soc/tb/*_tb.v
+
+The RTL of a testbench is found from its module instantiations (closure
+over the suite's rtl/ tree, plus `include files), not from a file list, so
+a testbench depends only on the modules it actually elaborates. The build
+is keyed by a SHA-256 over those sources, the compiler flags and the
+iverilog version, and cached in .sim_cache/build. The result of a run is
+keyed by the build plus the data files it reads, and cached in
+.sim_cache/results: after a one-line RTL change only the testbenches that
+elaborate the changed module are rebuilt and rerun.
+
+Data files: the file of every $readmemh/$readmemb is resolved through
+string parameters, their instance overrides (.MEM_FILE("...")) and
+`defines, and must exist - a test whose data file is missing fails as
+DATA instead of reading X. Any other string in the sources that names a
+file under the suite's run directory (task arguments, $fopen) is hashed
+as well. Data generated from a model (IIR and sigma-delta vectors) is
+rebuilt first by the suite's pre-steps when missing or older than the
+model source.
+
+Every simulation runs in its own scratch directory,
+.sim_cache/run/<suite>/<test>, with the data files linked in at their
+paths relative to the suite's run directory; whatever the testbench
+writes ($dumpfile, $fopen) stays there.
+
+A test passes if vvp exits 0 within the timeout and prints no failure
+marker ([FAIL], FAIL:, ERROR:, "TEST(S) FAILED", "TESTS FAILED").
+Simulated time comes from the "$finish called at" message.
+
+Waveforms: every run is made with vvp -none, so the testbenches'
+$dumpfile / $dumpvars write nothing; dumping the whole design otherwise
+dominates run time and disk. A test that fails is run once more with
+dumping on (the simulation is deterministic, so it fails the same way)
+and the waveform files in that test's scratch directory are listed in
+the summary. Cut them down with 06-tools/vcd/vcd_reduce. --waves all
+dumps in every run, as before.
+
+Usage:
+    python sim_regress.py                       # All suites, all cores
+    python sim_regress.py -s fpga -j 4          # One suite, 4 jobs
+    python sim_regress.py tb_alu 'pwm_*'        # Tests matching the patterns
+    python sim_regress.py --list                # Show tests and their RTL
+    python sim_regress.py --rerun -t 600        # Ignore cached results
+    python sim_regress.py --waves none          # No waveform even on failure
+
+Exit status is 1 if any selected test fails.
+
+Author: 5-Level Inverter Project
+Date: 2025-12-27
+"""
+
+import argparse
+import fnmatch
+import hashlib
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor, as_completed
+from pathlib import Path
+
+REPO_ROOT = Path(__file__).resolve().parents[2]
+CACHE_DIR = REPO_ROOT / ".sim_cache"
+
+IVERILOG = os.environ.get("IVERILOG", "iverilog")
+VVP = os.environ.get("VVP", "vvp")
+
+DEFAULT_TIMEOUT = 300.0     # Seconds per test
+
+
+class Suite:
+    """One RTL tree and its testbenches"""
+
+    def __init__(self, name, root, tests, rtl=("rtl",), include=(), flags=(), cwd=".",
+                 prepare=(), test_flags=None):
+        """
+        Args:
+            name: Suite name (-s)
+            root: Suite directory, relative to the repository root
+            tests: Testbench globs, relative to root
+            rtl: Directories searched recursively for modules
+            include: `include search path (-I), relative to root
+            flags: Extra iverilog flags
+            cwd: Directory data file paths are relative to ($readmemh)
+            prepare: PreStep list generating data files in cwd
+            test_flags: Testbench name -> extra iverilog flags for that test
+        """
+        self.name = name
+        self.root = REPO_ROOT / root
+        self.tests = tests
+        self.rtl = [(self.root / d).resolve() for d in rtl]
+        self.include = [self.root / d for d in include]
+        self.flags = list(flags)
+        self.cwd = self.root / cwd
+        self.prepare = list(prepare)
+        self.test_flags = dict(test_flags or {})
+
+    def prestep_for(self, path):
+        """PreStep that writes path, or None"""
+        for step in self.prepare:
+            if path in step.outputs:
+                return step
+        return None
+
+
+class PreStep:
+    """Commands that generate data files from a model (run in the suite cwd)"""
+
+    def __init__(self, cwd, outputs, inputs, commands):
+        """
+        Args:
+            cwd: Suite run directory, relative to the repository root
+            outputs: Files written, relative to cwd
+            inputs: Files the outputs depend on, relative to cwd
+            commands: Argument lists run in order
+        """
+        self.cwd = REPO_ROOT / cwd
+        self.outputs = [(self.cwd / p).resolve() for p in outputs]
+        self.inputs = [(self.cwd / p).resolve() for p in inputs]
+        self.commands = commands
+        self.error = None           # Output of a failed run
+
+    def stale(self):
+        """Outputs missing or older than an input"""
+        if not all(p.is_file() for p in self.outputs):
+            return True
+        oldest = min(p.stat().st_mtime for p in self.outputs)
+        return any(p.stat().st_mtime > oldest for p in self.inputs if p.is_file())
+
+    def run(self):
+        """Run the commands; False (and self.error) on failure"""
+        log = []
+        for cmd in self.commands:
+            log.append("$ " + " ".join(cmd))
+            try:
+                out = subprocess.run(cmd, cwd=self.cwd, capture_output=True, text=True)
+            except OSError as e:
+                log.append(str(e))
+                self.error = "\n".join(log)
+                return False
+            log.append(out.stdout + out.stderr)
+            if out.returncode != 0:
+                self.error = "\n".join(log)
+                return False
+        return True
+
+
+SUITES = [
+    Suite("fpga", "03-fpga", ["tb/*_tb.v"], include=["rtl"]),
+    # The top instantiates carrier_generator / pwm_comparator from 03-fpga
+    Suite("hybrid", "02-embedded/stm32-fpga-hybrid/fpga", ["tb/*_tb.v"],
+          rtl=["rtl", "../../../03-fpga/rtl"]),
+    Suite("riscv", "02-embedded/riscv", ["sim/testbench/tb_*.v", "sim/test_*.v"],
+          include=["rtl/core"], flags=["-g2012", "-DSIMULATION", "-grelative-include"],
+          cwd="sim", prepare=[
+              # As run_iir_accelerator_test.sh / run_sigma_delta_test.sh
+              PreStep("02-embedded/riscv/sim", ["iir_vectors.hex"], ["models/iir_model.c"],
+                      [["gcc", "-O2", "-Wall", "-o", "iir_model", "models/iir_model.c", "-lm"],
+                       ["./iir_model", "iir_vectors.hex"]]),
+              PreStep("02-embedded/riscv/sim", ["sd_vectors.hex"],
+                      ["models/sigma_delta_model.cpp"],
+                      [["g++", "-std=c++17", "-O2", "-Wall", "-o", "sigma_delta_model",
+                        "models/sigma_delta_model.cpp"],
+                       ["./sigma_delta_model", "sd_vectors.hex"]]),
+          ],
+          # Runs pr_controller_run, built with ZPEC like soc_top (Makefile.soc_top)
+          test_flags={"tb_tcm": ["-DZPEC_ENABLED"]}),
+    # soc_top loads the ROM as rom_32kb #(.MEM_FILE("firmware.mem"))
+    Suite("riscv-soc", "02-embedded/riscv-soc", ["tb/*_tb.v"], include=["rtl"],
+          flags=["-g2012"], cwd="firmware"),
+]
+
+COMMENT_RE = re.compile(r"//[^\n]*|/\*.*?\*/", re.S)
+MODULE_RE = re.compile(r"^\s*module\s+(\w+)", re.M)
+INCLUDE_RE = re.compile(r'`include\s+"([^"]+)"')
+# $readmem file argument: literal, identifier or `define
+READMEM_RE = re.compile(r'\$readmem[hb]\s*\(\s*(?:"([^"]+)"|`?(\w+))')
+STRING_ASSIGN_RE = re.compile(r'\b(\w+)\s*=\s*"([^"]*)"')          # parameter / reg
+PARAM_OVERRIDE_RE = re.compile(r'\.(\w+)\s*\(\s*"([^"]*)"\s*\)')  # #(.NAME("..."))
+DEFINE_RE = re.compile(r'`define\s+(\w+)\s+"([^"]*)"')
+STRING_RE = re.compile(r'"([^"\s%\\]+)"')
+WAVE_EXT = (".vcd", ".fst", ".lxt", ".lxt2")
+# Module instance: name [#(...)] instance_name (
+INSTANCE_RE = re.compile(r"\b(\w+)\s*(?:#|\w+\s*(?:\[[^\]]*\]\s*)?\()")
+FAIL_RE = re.compile(r"^\s*(?:\[FAIL\]|FAIL:|\[ERROR\]|ERROR:)|TESTS? FAILED|TEST\(S\) FAILED",
+                     re.M)
+FINISH_RE = re.compile(r"\$finish called at (\d+) \((\d+)(s|ms|us|ns|ps|fs)\)")
+UNIT_S = {"s": 1.0, "ms": 1e-3, "us": 1e-6, "ns": 1e-9, "ps": 1e-12, "fs": 1e-15}
+
+
+def sha256_file(path):
+    """Content hash of one file"""
+    return hashlib.sha256(path.read_bytes()).hexdigest()
+
+
+def read_source(path):
+    """Verilog source with comments removed"""
+    return COMMENT_RE.sub(" ", path.read_text(errors="ignore"))
+
+
+def tool_version():
+    """iverilog version string, part of every build key"""
+    try:
+        out = subprocess.run([IVERILOG, "-V"], capture_output=True, text=True)
+        return out.stdout.splitlines()[0] if out.stdout else ""
+    except OSError:
+        return ""
+
+
+class Test:
+    """One testbench: its sources, cache keys, build and run"""
+
+    def __init__(self, suite, tb, modules):
+        """
+        Args:
+            suite: Owning Suite
+            tb: Testbench file
+            modules: Module name -> defining file, for the suite's RTL
+        """
+        self.suite = suite
+        self.tb = tb
+        self.name = tb.stem
+        self.sources = []           # Files passed to iverilog, tb last
+        self.includes = []          # `include files (hashed, not passed)
+        self.required = []          # Resolved $readmem files
+        self.data = []              # Other existing files the sources name
+        self._resolve(modules)
+
+    @property
+    def flags(self):
+        """iverilog flags: the suite's, then the test's own"""
+        return self.suite.flags + self.suite.test_flags.get(self.name, [])
+
+    @property
+    def id(self):
+        return f"{self.suite.name}/{self.name}"
+
+    def _find_include(self, name, from_file):
+        for d in [from_file.parent] + self.suite.include + [self.suite.cwd]:
+            p = (d / name).resolve()
+            if p.is_file():
+                return p
+        return None
+
+    def _resolve(self, modules):
+        """Closure of instantiated modules and included files from the tb"""
+        rtl, seen, stack = [], {self.tb}, [self.tb]
+        texts = []
+        while stack:
+            f = stack.pop()
+            text = read_source(f)
+            texts.append(text)
+            own = set(MODULE_RE.findall(text))
+            for inc in INCLUDE_RE.findall(text):
+                p = self._find_include(inc, f)
+                if p and p not in seen:
+                    seen.add(p)
+                    self.includes.append(p)
+                    stack.append(p)
+            for name in INSTANCE_RE.findall(text):
+                p = modules.get(name)
+                if p and name not in own and p not in seen:
+                    seen.add(p)
+                    rtl.append(p)
+                    stack.append(p)
+        self.sources = sorted(rtl) + [self.tb]
+        self._resolve_data(texts)
+
+    def _resolve_data(self, texts):
+        """
+        $readmem files (required) and other files named in the sources
+
+        A $readmem argument that is an identifier takes the value of its
+        instance overrides if there are any, else its default; a `define
+        its macro value. Arguments that resolve to nothing (task inputs)
+        are covered by the scan of all strings.
+        """
+        defaults, overrides, defines = {}, {}, {}
+        for text in texts:
+            for name, value in STRING_ASSIGN_RE.findall(text):
+                defaults.setdefault(name, set()).add(value)
+            for name, value in PARAM_OVERRIDE_RE.findall(text):
+                overrides.setdefault(name, set()).add(value)
+            for name, value in DEFINE_RE.findall(text):
+                defines.setdefault(name, set()).add(value)
+
+        names = set()
+        for text in texts:
+            for literal, ident in READMEM_RE.findall(text):
+                if literal:
+                    names.add(literal)
+                else:
+                    names |= (overrides.get(ident) or defaults.get(ident)
+                              or defines.get(ident) or set())
+        self.required = sorted({(self.suite.cwd / n).resolve() for n in names})
+
+        named = {(self.suite.cwd / s).resolve() for text in texts for s in STRING_RE.findall(text)}
+        self.data = sorted(p for p in named - set(self.required)
+                           if p.suffix not in WAVE_EXT and p.is_file())
+
+    def missing(self):
+        """Required data files that do not exist"""
+        return [p for p in self.required if not p.is_file()]
+    def build_key(self, version):
+        h = hashlib.sha256()
+        h.update(version.encode())
+        h.update(" ".join(self.flags).encode())
+        for p in self.sources + sorted(self.includes):
+            h.update(str(p.relative_to(REPO_ROOT)).encode())
+            h.update(sha256_file(p).encode())
+        return h.hexdigest()
+
+    def result_key(self, build_key):
+        h = hashlib.sha256(build_key.encode())
+        for p in self.required + self.data:
+            h.update(str(p.relative_to(REPO_ROOT)).encode())
+            h.update(sha256_file(p).encode())
+        return h.hexdigest()
+
+    @property
+    def rundir(self):
+        """Scratch directory the simulation runs in"""
+        return CACHE_DIR / "run" / self.suite.name / self.name
+
+    def _make_rundir(self):
+        """Empty scratch directory with the data files linked in"""
+        shutil.rmtree(self.rundir, ignore_errors=True)
+        self.rundir.mkdir(parents=True)
+        for p in self.required + self.data:
+            try:
+                rel = p.relative_to(self.suite.cwd.resolve())
+            except ValueError:
+                continue            # Outside the run directory
+            dst = self.rundir / rel
+            dst.parent.mkdir(parents=True, exist_ok=True)
+            try:
+                dst.symlink_to(p)
+            except OSError:
+                shutil.copy2(p, dst)
+
+    def _simulate(self, vvp, timeout, dump):
+        """
+        One vvp run in a fresh scratch directory; $dumpvars is a no-op
+        unless dump is set (vvp -none)
+
+        Returns:
+            (status, output): PASS, FAIL or TIMEOUT and the simulator output
+        """
+        cmd = [VVP, "-n", str(vvp)] + ([] if dump else ["-none"])
+        self._make_rundir()
+        try:
+            out = subprocess.run(cmd, cwd=self.rundir, capture_output=True, text=True,
+                                 timeout=timeout)
+        except subprocess.TimeoutExpired as e:
+            text = e.stdout or ""
+            if isinstance(text, bytes):
+                text = text.decode(errors="ignore")
+            return "TIMEOUT", text
+        text = out.stdout + out.stderr
+        ok = out.returncode == 0 and not FAIL_RE.search(text)
+        return ("PASS" if ok else "FAIL"), text
+
+    def run(self, version, timeout, rerun, waves):
+        """
+        Build (unless cached) and simulate (unless a result is cached)
+
+        Args:
+            version: iverilog version string
+            timeout: Seconds per simulation
+            rerun: Ignore a cached result
+            waves: "fail" (dump only on a rerun of a failing test), "all", "none"
+
+        Returns:
+            Result dictionary: status, built, cached, sim_time, wall, log, waves
+        """
+        start = time.monotonic()
+        log = CACHE_DIR / "logs" / self.suite.name / f"{self.name}.log"
+        log.parent.mkdir(parents=True, exist_ok=True)
+        res = {"test": self.id, "status": "FAIL", "built": False, "cached": False,
+               "sim_time": None, "wall": 0.0, "log": str(log), "waves": []}
+
+        # Missing vectors would load as X; never run (or cache) that
+        missing = self.missing()
+        if missing:
+            text = ""
+            for p in missing:
+                step = self.suite.prestep_for(p)
+                text += f"Missing data file {p}\n"
+                if step and step.error:
+                    text += f"Pre-step failed:\n{step.error}\n"
+            log.write_text(text)
+            res.update(status="DATA", wall=time.monotonic() - start)
+            return res
+
+        bkey = self.build_key(version)
+        rkey = self.result_key(bkey)
+        vvp = CACHE_DIR / "build" / f"{bkey}.vvp"
+        result_file = CACHE_DIR / "results" / f"{rkey}.json"
+
+        if not rerun and result_file.is_file():
+            res.update(json.loads(result_file.read_text()))
+            res.update(cached=True, wall=time.monotonic() - start, log=str(log))
+            return res
+
+        if not vvp.is_file():
+            cmd = [IVERILOG] + self.flags
+            cmd += [f"-I{d}" for d in self.suite.include]
+            cmd += ["-o", str(vvp) + ".tmp"] + [str(p) for p in self.sources]
+            vvp.parent.mkdir(parents=True, exist_ok=True)
+            out = subprocess.run(cmd, capture_output=True, text=True)
+            if out.returncode != 0:
+                log.write_text(" ".join(cmd) + "\n" + out.stdout + out.stderr)
+                res.update(status="BUILD", wall=time.monotonic() - start)
+                return res
+            os.replace(str(vvp) + ".tmp", vvp)
+            res["built"] = True
+
+        res["status"], text = self._simulate(vvp, timeout, dump=waves == "all")
+        log.write_text(text)
+
+        # Deterministic: the rerun with dumping reproduces the failure
+        if res["status"] == "FAIL" and waves == "fail":
+            self._simulate(vvp, timeout, dump=True)
+        if res["status"] == "FAIL" and waves != "none":
+            res["waves"] = [str(p) for p in wave_files(self.rundir)]
+
+        m = FINISH_RE.search(text)
+        if m:
+            res["sim_time"] = int(m.group(1)) * int(m.group(2)) * UNIT_S[m.group(3)]
+        res["wall"] = time.monotonic() - start
+
+        # Timeouts depend on the machine, not only on the inputs
+        if res["status"] != "TIMEOUT":
+            result_file.parent.mkdir(parents=True, exist_ok=True)
+            result_file.write_text(json.dumps({"status": res["status"],
+                                               "sim_time": res["sim_time"]}))
+        return res
+
+
+def wave_files(rundir):
+    """Waveforms a run wrote into its scratch directory"""
+    return sorted(p for p in rundir.rglob("*") if p.suffix in WAVE_EXT and not p.is_symlink())
+
+
+def prepare(tests):
+    """Run the pre-steps whose outputs the selected tests load, if stale"""
+    steps = []
+    for t in tests:
+        for p in t.required:
+            step = t.suite.prestep_for(p)
+            if step and step not in steps:
+                steps.append(step)
+    for step in steps:
+        if step.stale():
+            names = ", ".join(p.name for p in step.outputs)
+            print(f"  Preparing {names}")
+            if not step.run():
+                print(f"  ✗ Pre-step for {names} failed")
+
+
+def index_modules(suite):
+    """Module name -> file over the suite's RTL directories"""
+    modules = {}
+    for d in suite.rtl:
+        for p in sorted(d.rglob("*.v")):
+            for name in MODULE_RE.findall(read_source(p)):
+                # Prefer the file named after the module on duplicates
+                if name not in modules or p.stem == name:
+                    modules[name] = p
+    return modules
+
+
+def discover(suites, patterns):
+    """Testbenches of the given suites matching any of the patterns"""
+    tests = []
+    for suite in suites:
+        modules = index_modules(suite)
+        tbs = sorted({p for g in suite.tests for p in suite.root.glob(g)})
+        for tb in tbs:
+            if patterns and not any(fnmatch.fnmatch(tb.stem, pat) or pat in tb.stem
+                                    for pat in patterns):
+                continue
+            tests.append(Test(suite, tb, modules))
+    return tests
+
+
+def format_time(seconds):
+    """Simulated time with an engineering unit"""
+    if seconds is None:
+        return "-"
+    for unit, scale in (("s", 1.0), ("ms", 1e-3), ("us", 1e-6), ("ns", 1e-9)):
+        if seconds >= scale:
+            return f"{seconds / scale:.3f} {unit}"
+    return f"{seconds / 1e-12:.0f} ps"
+
+
+def print_summary(results, wall):
+    """Per-test table and totals"""
+    print(f"\n{'Test':<36} {'Result':<8} {'Build':<7} {'Run':<7} {'Sim time':>12} {'Wall':>8}")
+    print("-" * 82)
+    for r in sorted(results, key=lambda r: r["test"]):
+        build = "built" if r["built"] else "cached"
+        run = "cached" if r["cached"] else ("-" if r["status"] in ("BUILD", "DATA") else "ran")
+        print(f"{r['test']:<36} {r['status']:<8} {build:<7} {run:<7} "
+              f"{format_time(r['sim_time']):>12} {r['wall']:>7.1f}s")
+
+    failed = [r for r in results if r["status"] != "PASS"]
+    built = sum(r["built"] for r in results)
+    ran = sum(not r["cached"] and r["status"] not in ("BUILD", "DATA") for r in results)
+    cached = sum(r["cached"] for r in results)
+    print("-" * 82)
+    print(f"{len(results) - len(failed)} passed, {len(failed)} failed "
+          f"({built} built, {ran} run, {cached} cached) in {wall:.1f}s")
+    for r in failed:
+        print(f"  {r['status']}: {r['test']}  (log: {r['log']})")
+        for w in r.get("waves", []):
+            print(f"      waveform: {w}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Icarus Verilog regression driver")
+    parser.add_argument("patterns", nargs="*", help="Test name globs or substrings")
+    parser.add_argument("-s", "--suite", action="append",
+                        choices=[s.name for s in SUITES], help="Suite(s) to run (default: all)")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1,
+                        help="Parallel jobs (default: all cores)")
+    parser.add_argument("-t", "--timeout", type=float, default=DEFAULT_TIMEOUT,
+                        help=f"Per-test timeout in seconds (default: {DEFAULT_TIMEOUT:.0f})")
+    parser.add_argument("--rerun", action="store_true",
+                        help="Ignore cached results (builds stay cached)")
+    parser.add_argument("--waves", choices=["fail", "all", "none"], default="fail",
+                        help="Dump waveforms only on a rerun of failing tests (default), "
+                             "in every run, or never")
+    parser.add_argument("--list", action="store_true",
+                        help="List the tests and the RTL each one elaborates")
+    args = parser.parse_args()
+
+    suites = [s for s in SUITES if not args.suite or s.name in args.suite]
+    tests = discover(suites, args.patterns)
+    if not tests:
+        print("No testbenches match")
+        return 1
+
+    if args.list:
+        for t in tests:
+            deps = [os.path.relpath(p, t.suite.root) for p in t.sources[:-1] + t.includes]
+            print(f"{t.id}: {' '.join(deps)}")
+            for p in t.required:
+                state = "" if p.is_file() else (" (generated)" if t.suite.prestep_for(p)
+                                                else " (MISSING)")
+                print(f"    data: {os.path.relpath(p, t.suite.root)}{state}")
+        return 0
+
+    version = tool_version()
+    if not version:
+        print(f"✗ {IVERILOG} not found (set IVERILOG / VVP)")
+        return 1
+
+    print(f"Running {len(tests)} testbenches on {args.jobs} jobs ({version})")
+    start = time.monotonic()
+    prepare(tests)
+    results = []
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        jobs = {pool.submit(t.run, version, args.timeout, args.rerun, args.waves): t for t in tests}
+        for job in as_completed(jobs):
+            r = job.result()
+            mark = "✓" if r["status"] == "PASS" else "✗"
+            print(f"  {mark} {r['test']:<36} {r['status']}{' (cached)' if r['cached'] else ''}")
+            results.append(r)
+
+    print_summary(results, time.monotonic() - start)
+    return 0 if all(r["status"] == "PASS" for r in results) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,419 @@
+/**
+ * @file she_solver.cpp
+ * @brief Selective harmonic elimination (SHE) angle solver for the 5-level staircase
+ *
+ * Solves the switching angles of a quarter-wave symmetric staircase with
+ * three transitions per quarter cycle, 0 < a1 < a2 < a3 < pi/2, each
+ * stepping the output level up (+1) or down (-1) by one bridge voltage:
+ *
+ *   v(wt) = sum_n b_n sin(n wt),  b_n = 4/(n pi) * sum_k s_k cos(n a_k)
+ *
+ * Three angles fix the fundamental and zero two harmonics (5th and 7th by
+ * default). Two step patterns are needed to cover the MI range:
+ *
+ *   notch (+1 +1 -1): 0 -> 1 -> 2 -> 1, a notch in the top step, MI ~0.5-0.97
+ *   pulse (+1 -1 +1): 0 -> 1 -> 0 -> 1, level 1 only,            MI ~0.05-0.6
+ *
+ * MI is in the modulator's units (fundamental = 2 * MI * Vdc, MI = 1 is
+ * the full-scale sine), MI = (2/pi) * sum_k s_k cos(a_k).
+ *
+ * Each grid point is solved by damped Newton-Raphson, continuing from the
+ * neighbouring solution of the same pattern and falling back to a seeded
+ * multi-start search. Where both patterns have a solution the one with
+ * the lower residual THD (odd harmonics to 49) is kept. A grid point whose
+ * best solution exceeds the THD limit counts as unsolved: the low-THD
+ * notch branch ends where a3 reaches pi/2 (MI ~0.94), and below MI ~0.65
+ * only branches of 50-300% THD remain. The longest run of solved grid
+ * points becomes the table.
+ *
+ * Outputs:
+ *   -o she_angles.h   C header for the STM32 modulator (angles in rad)
+ *   -v she_angles.vh  Verilog include for the FPGA top (angles in 2^16
+ *                     phase units per cycle)
+ *
+ * Build/run: g++ -O2 -o she_solver she_solver.cpp
+ *            ./she_solver -o she_angles.h -v she_angles.vh [-e 5,7] [-t 40]
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-25
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr int kAngles = 3;
+constexpr int kPatterns = 2;
+constexpr int kGridPerUnit = 128;           // MI grid step 1/128 (Q15 step 256)
+constexpr int kGridMax = 162;               // MI up to 4/pi
+constexpr int kMaxHarmonic = 49;            // THD evaluation
+constexpr int kMaxIter = 100;
+constexpr int kMultiStart = 400;
+constexpr double kTol = 1e-10;
+constexpr double kMinGap = 1e-3;            // rad between angles / from 0, pi/2
+constexpr double kMaxThdDefault = 40.0;     // % of fundamental, table entries
+
+constexpr int kSign[kPatterns][kAngles] = {
+    {+1, +1, -1},                           // notch
+    {+1, -1, +1},                           // pulse
+};
+const char *const kPatternName[kPatterns] = {"notch", "pulse"};
+
+struct Solution {
+    bool valid = false;
+    int pattern = 0;
+    double a[kAngles] = {0.0, 0.0, 0.0};
+    double thd = 0.0;                       // % of fundamental, odd 3..49
+};
+
+class Solver {
+public:
+    Solver(int h1, int h2) : h_{h1, h2} {}
+
+    // Damped Newton-Raphson from the guess, true if converged in range
+    bool solve(int pattern, double mi, double a[kAngles]) const
+    {
+        const int *s = kSign[pattern];
+
+        for (int it = 0; it < kMaxIter; it++) {
+            double f[kAngles], j[kAngles][kAngles];
+
+            f[0] = -mi;
+            for (int k = 0; k < kAngles; k++) {
+                f[0] += (2.0 / M_PI) * s[k] * std::cos(a[k]);
+                j[0][k] = -(2.0 / M_PI) * s[k] * std::sin(a[k]);
+            }
+            for (int e = 0; e < 2; e++) {
+                f[e + 1] = 0.0;
+                for (int k = 0; k < kAngles; k++) {
+                    f[e + 1] += s[k] * std::cos(h_[e] * a[k]);
+                    j[e + 1][k] = -h_[e] * s[k] * std::sin(h_[e] * a[k]);
+                }
+            }
+
+            double d[kAngles];
+            if (!solve3(j, f, d)) return false;
+
+            // Limit the step so an iteration cannot jump across branches
+            double step = 0.0;
+            for (int k = 0; k < kAngles; k++) step = std::fmax(step, std::fabs(d[k]));
+            double damp = (step > 0.2) ? 0.2 / step : 1.0;
+            for (int k = 0; k < kAngles; k++) a[k] -= damp * d[k];
+
+            if (step < kTol) return in_range(a);
+        }
+        return false;
+    }
+
+    // Lowest-THD solution over both patterns, from the neighbouring
+    // solutions and a multi-start search (several branches can exist)
+    Solution best_at(double mi, const Solution prev[kPatterns], uint32_t *seed) const
+    {
+        Solution best;
+
+        for (int p = 0; p < kPatterns; p++) {
+            for (int t = -1; t < kMultiStart; t++) {
+                Solution s;
+                s.pattern = p;
+                if (t < 0) {
+                    if (!prev[p].valid) continue;
+                    std::memcpy(s.a, prev[p].a, sizeof(s.a));
+                } else {
+                    for (int k = 0; k < kAngles; k++) s.a[k] = uniform(seed) * M_PI / 2.0;
+                    sort3(s.a);
+                }
+                if (!solve(p, mi, s.a)) continue;
+
+                s.valid = true;
+                s.thd = thd(s);
+                if (!best.valid || s.thd < best.thd - 1e-6) best = s;
+            }
+        }
+        return best;
+    }
+
+    // Harmonic amplitude in units of one bridge voltage
+    static double harmonic(const Solution &s, int n)
+    {
+        double b = 0.0;
+        for (int k = 0; k < kAngles; k++) b += kSign[s.pattern][k] * std::cos(n * s.a[k]);
+        return 4.0 / (n * M_PI) * b;
+    }
+
+    static double thd(const Solution &s)
+    {
+        double sum = 0.0;
+        for (int n = 3; n <= kMaxHarmonic; n += 2) {
+            double b = harmonic(s, n);
+            sum += b * b;
+        }
+        return 100.0 * std::sqrt(sum) / std::fabs(harmonic(s, 1));
+    }
+
+    int harmonic_eliminated(int e) const { return h_[e]; }
+
+private:
+    int h_[2];
+
+    static bool in_range(const double a[kAngles])
+    {
+        if (a[0] < kMinGap || a[kAngles - 1] > M_PI / 2.0 - kMinGap) return false;
+        for (int k = 1; k < kAngles; k++) {
+            if (a[k] - a[k - 1] < kMinGap) return false;
+        }
+        return true;
+    }
+
+    // Gaussian elimination with partial pivoting, j * d = f
+    static bool solve3(double j[kAngles][kAngles], const double f[kAngles], double d[kAngles])
+    {
+        double m[kAngles][kAngles + 1];
+        for (int r = 0; r < kAngles; r++) {
+            for (int c = 0; c < kAngles; c++) m[r][c] = j[r][c];
+            m[r][kAngles] = f[r];
+        }
+        for (int c = 0; c < kAngles; c++) {
+            int piv = c;
+            for (int r = c + 1; r < kAngles; r++) {
+                if (std::fabs(m[r][c]) > std::fabs(m[piv][c])) piv = r;
+            }
+            if (std::fabs(m[piv][c]) < 1e-12) return false;
+            for (int k = 0; k <= kAngles; k++) std::swap(m[c][k], m[piv][k]);
+            for (int r = 0; r < kAngles; r++) {
+                if (r == c) continue;
+                double g = m[r][c] / m[c][c];
+                for (int k = c; k <= kAngles; k++) m[r][k] -= g * m[c][k];
+            }
+        }
+        for (int r = 0; r < kAngles; r++) d[r] = m[r][kAngles] / m[r][r];
+        return true;
+    }
+
+    static void sort3(double a[kAngles])
+    {
+        for (int i = 0; i < kAngles; i++) {
+            for (int k = i + 1; k < kAngles; k++) {
+                if (a[k] < a[i]) std::swap(a[i], a[k]);
+            }
+        }
+    }
+
+    // Deterministic LCG so the generated tables are reproducible
+    static double uniform(uint32_t *seed)
+    {
+        *seed = *seed * 1664525u + 1013904223u;
+        return (*seed >> 8) / 16777216.0;
+    }
+};
+
+void write_header(FILE *out, const Solver &solver, const std::vector<Solution> &table, int k0,
+                  double max_thd)
+{
+    int n = static_cast<int>(table.size());
+
+    fprintf(out,
+            "/**\n"
+            " * @file she_angles.h\n"
+            " * @brief SHE staircase switching angles, MI -> (pattern, a1..a3)\n"
+            " *\n"
+            " * GENERATED by 06-tools/she/she_solver.cpp - do not edit.\n"
+            " *\n"
+            " * Quarter-wave angles (rad) of the 5-level staircase eliminating the\n"
+            " * %dth and %dth harmonics, on an MI grid of 1/%d from SHE_MI_MIN.\n"
+            " * sign[k] is the level step at a[k] (+1 up, -1 down).\n"
+            " *\n"
+            " * @author 5-Level Inverter Project\n"
+            " */\n\n"
+            "#ifndef SHE_ANGLES_H\n"
+            "#define SHE_ANGLES_H\n\n"
+            "#include <stdint.h>\n\n",
+            solver.harmonic_eliminated(0), solver.harmonic_eliminated(1), kGridPerUnit);
+
+    fprintf(out, "#define SHE_ANGLES          %d\n", kAngles);
+    fprintf(out, "#define SHE_TABLE_SIZE      %d\n", n);
+    fprintf(out, "#define SHE_MI_STEP         (1.0f / %d.0f)\n", kGridPerUnit);
+    fprintf(out, "#define SHE_MI_MIN          (%d.0f / %d.0f)\n", k0, kGridPerUnit);
+    fprintf(out, "#define SHE_MI_MAX          (%d.0f / %d.0f)\n", k0 + n - 1, kGridPerUnit);
+    fprintf(out, "#define SHE_HARMONIC_A      %d\n", solver.harmonic_eliminated(0));
+    fprintf(out, "#define SHE_HARMONIC_B      %d\n", solver.harmonic_eliminated(1));
+    fprintf(out, "#define SHE_THD_MAX         %.1ff      // %% of fundamental, odd 3..%d\n\n",
+            max_thd, kMaxHarmonic);
+
+    fprintf(out,
+            "typedef struct {\n"
+            "    int8_t sign[SHE_ANGLES];    // Level step at each angle\n"
+            "    float alpha[SHE_ANGLES];    // Quarter-wave angles (rad), ascending\n"
+            "} she_entry_t;\n\n"
+            "static const she_entry_t she_table[SHE_TABLE_SIZE] = {\n");
+
+    for (int i = 0; i < n; i++) {
+        const Solution &s = table[i];
+        const int *sg = kSign[s.pattern];
+        fprintf(out, "    {{%+d, %+d, %+d}, {%.7ff, %.7ff, %.7ff}},   // MI %.4f %s, THD %.1f%%\n",
+                sg[0], sg[1], sg[2], s.a[0], s.a[1], s.a[2],
+                static_cast<double>(k0 + i) / kGridPerUnit, kPatternName[s.pattern], s.thd);
+    }
+
+    fprintf(out, "};\n\n#endif // SHE_ANGLES_H\n");
+}
+
+void write_verilog(FILE *out, const Solver &solver, const std::vector<Solution> &table, int k0)
+{
+    int n = static_cast<int>(table.size());
+
+    fprintf(out,
+            "// she_angles.vh - SHE staircase switching angles\n"
+            "//\n"
+            "// GENERATED by 06-tools/she/she_solver.cpp - do not edit.\n"
+            "//\n"
+            "// Eliminates the %dth and %dth harmonics. Entry i is MI = (SHE_MI_MIN + i) / %d.\n"
+            "// she_entry = {down[2:0], a1, a2, a3}: down[k] set for a -1 level step,\n"
+            "// angles in 2^16 phase units per output cycle (quarter wave < 16384).\n\n",
+            solver.harmonic_eliminated(0), solver.harmonic_eliminated(1), kGridPerUnit);
+
+    fprintf(out, "localparam SHE_TABLE_SIZE = %d;\n", n);
+    fprintf(out, "localparam SHE_MI_MIN     = %d; // MI x %d\n", k0, kGridPerUnit);
+    fprintf(out, "localparam SHE_MI_MAX     = %d; // MI x %d\n\n", k0 + n - 1, kGridPerUnit);
+
+    fprintf(out,
+            "function [50:0] she_entry;\n"
+            "    input [7:0] idx;\n"
+            "    begin\n"
+            "        case (idx)\n");
+
+    for (int i = 0; i < n; i++) {
+        const Solution &s = table[i];
+        unsigned down = 0;
+        unsigned q[kAngles];
+        for (int k = 0; k < kAngles; k++) {
+            if (kSign[s.pattern][k] < 0) down |= 4u >> k;
+            q[k] = static_cast<unsigned>(std::lround(s.a[k] / (2.0 * M_PI) * 65536.0));
+        }
+        fprintf(out, "        8'd%d: she_entry = {3'b%u%u%u, 16'd%u, 16'd%u, 16'd%u};\n", i,
+                (down >> 2) & 1u, (down >> 1) & 1u, down & 1u, q[0], q[1], q[2]);
+    }
+
+    fprintf(out,
+            "        default: she_entry = 51'd0;\n"
+            "        endcase\n"
+            "    end\n"
+            "endfunction\n");
+}
+
+bool parse_harmonics(const char *arg, int *h1, int *h2)
+{
+    if (std::sscanf(arg, "%d,%d", h1, h2) != 2) return false;
+    return *h1 > 1 && *h2 > 1 && *h1 != *h2 && (*h1 % 2) && (*h2 % 2);
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    const char *header_path = nullptr;
+    const char *verilog_path = nullptr;
+    int h1 = 5, h2 = 7;
+    double max_thd = kMaxThdDefault;
+
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "-o") && i + 1 < argc) {
+            header_path = argv[++i];
+        } else if (!std::strcmp(argv[i], "-v") && i + 1 < argc) {
+            verilog_path = argv[++i];
+        } else if (!std::strcmp(argv[i], "-e") && i + 1 < argc) {
+            if (!parse_harmonics(argv[++i], &h1, &h2)) {
+                fprintf(stderr, "-e expects two distinct odd harmonics, e.g. 5,7\n");
+                return 1;
+            }
+        } else if (!std::strcmp(argv[i], "-t") && i + 1 < argc) {
+            max_thd = std::atof(argv[++i]);
+            if (max_thd <= 0.0) {
+                fprintf(stderr, "-t expects the THD limit in %%, e.g. 40\n");
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Usage: %s [-o she_angles.h] [-v she_angles.vh] [-e 5,7] [-t 40]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    Solver solver(h1, h2);
+    std::vector<Solution> grid(kGridMax + 1);
+    Solution prev[kPatterns];
+    uint32_t seed = 1;
+
+    for (int k = 1; k <= kGridMax; k++) {
+        double mi = static_cast<double>(k) / kGridPerUnit;
+        grid[k] = solver.best_at(mi, prev, &seed);
+
+        // Keep per-pattern continuation even where the other pattern won
+        for (int p = 0; p < kPatterns; p++) {
+            Solution s;
+            s.pattern = p;
+            if (prev[p].valid) {
+                std::memcpy(s.a, prev[p].a, sizeof(s.a));
+                s.valid = solver.solve(p, mi, s.a);
+            }
+            if (grid[k].valid && grid[k].pattern == p) s = grid[k];
+            prev[p] = s;
+        }
+    }
+
+    // Longest contiguous run of solved grid points within the THD limit
+    // (continuation above still follows every branch)
+    auto usable = [&](int k) { return grid[k].valid && grid[k].thd <= max_thd; };
+    int best_k0 = 0, best_n = 0;
+    for (int k = 1; k <= kGridMax; k++) {
+        int n = 0;
+        while (k + n <= kGridMax && usable(k + n)) n++;
+        if (n > best_n) {
+            best_n = n;
+            best_k0 = k;
+        }
+    }
+    if (best_n == 0) {
+        fprintf(stderr, "No solution for harmonics %d, %d within %.1f%% THD\n", h1, h2, max_thd);
+        return 1;
+    }
+
+    std::vector<Solution> table(grid.begin() + best_k0, grid.begin() + best_k0 + best_n);
+
+    printf("SHE 5-level staircase, eliminating %d and %d, THD limit %.1f%%\n", h1, h2, max_thd);
+    printf("  MI %.4f .. %.4f, %d entries\n",
+           static_cast<double>(best_k0) / kGridPerUnit,
+           static_cast<double>(best_k0 + best_n - 1) / kGridPerUnit, best_n);
+    for (int i = 0; i < best_n; i += 8) {
+        const Solution &s = table[i];
+        printf("  MI %.4f %-5s a = %6.2f %6.2f %6.2f deg  h%d %.1e h%d %.1e  THD %.1f%%\n",
+               static_cast<double>(best_k0 + i) / kGridPerUnit, kPatternName[s.pattern],
+               s.a[0] * 180.0 / M_PI, s.a[1] * 180.0 / M_PI, s.a[2] * 180.0 / M_PI,
+               h1, std::fabs(Solver::harmonic(s, h1)), h2, std::fabs(Solver::harmonic(s, h2)), s.thd);
+    }
+
+    if (header_path) {
+        FILE *out = std::fopen(header_path, "w");
+        if (!out) {
+            perror(header_path);
+            return 1;
+        }
+        write_header(out, solver, table, best_k0, max_thd);
+        std::fclose(out);
+    }
+    if (verilog_path) {
+        FILE *out = std::fopen(verilog_path, "w");
+        if (!out) {
+            perror(verilog_path);
+            return 1;
+        }
+        write_verilog(out, solver, table, best_k0);
+        std::fclose(out);
+    }
+
+    return 0;
+}
@@ -0,0 +1,292 @@
+/**
+ * @file sine_model.cpp
+ * @brief Bit-exact model of the FPGA sine reference and its SFDR
+ *
+ * Models two sine tables of 03-fpga/rtl/sine_generator.v at shape 0
+ * (plain sine), including the MI scaling and saturation that follow:
+ *
+ *   legacy       256-entry full-wave table, T[i] = trunc(32767 sin(2 pi i/256)),
+ *                phase truncated to the top 8 bits
+ *   interpolated quarter-wave table (sine_quarter_lut), 2^Q entries,
+ *                T[i] = round(32767 sin(pi/2 i/2^Q)), odd quadrants
+ *                mirrored, linear interpolation on F phase bits:
+ *                y = T[a] + ((T[a+1] - T[a]) * frac + 2^(F-1)) >> F
+ *
+ *   sine_out = sat((y * MI + 2^14) >> 15),  |sine_out| <= 32767
+ *
+ * A record of 2^R samples with freq_increment = k * 2^(32-R), k odd, is
+ * coherent (exactly k cycles, every phase step visited once), so the
+ * spectrum needs no window. SFDR is the fundamental over the largest
+ * other bin (DC excluded), in dB.
+ *
+ * With -c the model checks a sample dump from tb/sine_generator_tb.v
+ * (one decimal sample per line, same Q, F, k, MI, R) bit for bit.
+ *
+ * Build/run: g++ -O2 -o sine_model sine_model.cpp
+ *            ./sine_model [-q 8] [-f 8] [-k 4099] [-m 32767] [-r 18]
+ *                         [-c sine_samples.txt]
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr double kPi = 3.14159265359;       // Same constant as the RTL
+constexpr int kPeak = 32767;
+constexpr int kLegacyAddrBits = 8;
+constexpr int kMinRecordBits = 10;
+constexpr int kMaxRecordBits = 22;
+
+struct Config {
+    int quarter_bits = 8;                   // QUARTER_ADDR_WIDTH
+    int frac_bits = 8;                      // INTERP_BITS
+    uint32_t cycles = 4099;                 // k, odd
+    int mi = 32767;                         // modulation_index
+    int record_bits = 18;                   // R
+};
+
+class LegacyTable {
+public:
+    LegacyTable() : lut_(1 << kLegacyAddrBits)
+    {
+        // $rtoi truncates toward zero
+        for (size_t i = 0; i < lut_.size(); i++)
+            lut_[i] = static_cast<int>(32767.0 * std::sin(2.0 * kPi * i / lut_.size()));
+    }
+
+    int operator()(uint32_t phase) const { return lut_[phase >> (32 - kLegacyAddrBits)]; }
+
+private:
+    std::vector<int> lut_;
+};
+
+class QuarterTable {
+public:
+    QuarterTable(int addr_bits, int frac_bits)
+        : addr_bits_(addr_bits), frac_bits_(frac_bits), lut_(1u << addr_bits)
+    {
+        for (size_t i = 0; i < lut_.size(); i++)
+            lut_[i] = static_cast<int>(32767.0 * std::sin(kPi / 2.0 * i / lut_.size()) + 0.5);
+    }
+
+    int operator()(uint32_t phase) const
+    {
+        const int u_bits = addr_bits_ + frac_bits_;
+        const uint32_t p = phase >> (32 - u_bits - 2);
+        const uint32_t quadrant = p >> u_bits;
+        const uint32_t u_in = p & ((1u << u_bits) - 1);
+        const uint32_t u = (quadrant & 1) ? (1u << u_bits) - u_in : u_in;
+        const uint32_t index = u >> frac_bits_;
+        const int frac = static_cast<int>(u & ((1u << frac_bits_) - 1));
+
+        const int v0 = entry(index);
+        const int v1 = entry(index + 1);
+        const int y = v0 + (((v1 - v0) * frac + (1 << (frac_bits_ - 1))) >> frac_bits_);
+        return (quadrant & 2) ? -y : y;
+    }
+
+    size_t entries() const { return lut_.size(); }
+
+private:
+    int entry(uint32_t index) const { return index < lut_.size() ? lut_[index] : kPeak; }
+
+    int addr_bits_;
+    int frac_bits_;
+    std::vector<int> lut_;
+};
+
+// Modulation index scaling (rounded) and saturation of sine_generator
+int scale(int y, int mi)
+{
+    int64_t s = (static_cast<int64_t>(y) * mi + (1 << 14)) >> 15;   // Arithmetic, as >>>
+    if (s > kPeak) s = kPeak;
+    if (s < -kPeak) s = -kPeak;
+    return static_cast<int>(s);
+}
+
+template <typename Table>
+std::vector<int> record(const Table &table, const Config &cfg)
+{
+    const size_t n = size_t{1} << cfg.record_bits;
+    const uint32_t increment = cfg.cycles << (32 - cfg.record_bits);
+    std::vector<int> out(n);
+    uint32_t phase = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        out[i] = scale(table(phase), cfg.mi);
+        phase += increment;
+    }
+    return out;
+}
+
+// In-place radix-2 FFT
+void fft(std::vector<std::complex<double>> &x)
+{
+    const size_t n = x.size();
+
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(x[i], x[j]);
+    }
+    for (size_t len = 2; len <= n; len <<= 1) {
+        const std::complex<double> w = std::polar(1.0, -2.0 * M_PI / len);
+        for (size_t i = 0; i < n; i += len) {
+            std::complex<double> wk = 1.0;
+            for (size_t k = 0; k < len / 2; k++) {
+                const std::complex<double> a = x[i + k];
+                const std::complex<double> b = x[i + k + len / 2] * wk;
+                x[i + k] = a + b;
+                x[i + k + len / 2] = a - b;
+                wk *= w;
+            }
+        }
+    }
+}
+
+struct Spectrum {
+    double sfdr_db = 0.0;
+    size_t spur_bin = 0;
+    double max_error = 0.0;                 // LSB, against MI * sin
+};
+
+Spectrum analyze(const std::vector<int> &samples, const Config &cfg)
+{
+    const size_t n = samples.size();
+    const double amplitude = 32767.0 * cfg.mi / 32768.0;
+    std::vector<std::complex<double>> x(n);
+    Spectrum s;
+
+    for (size_t i = 0; i < n; i++) {
+        x[i] = samples[i];
+        const double ideal = amplitude * std::sin(2.0 * M_PI * cfg.cycles * i / n);
+        s.max_error = std::fmax(s.max_error, std::fabs(samples[i] - ideal));
+    }
+    fft(x);
+
+    double spur = 0.0;
+    for (size_t b = 1; b <= n / 2; b++) {
+        if (b == cfg.cycles) continue;
+        if (std::norm(x[b]) > spur) {
+            spur = std::norm(x[b]);
+            s.spur_bin = b;
+        }
+    }
+    s.sfdr_db = 10.0 * std::log10(std::norm(x[cfg.cycles]) / std::fmax(spur, 1e-30));
+    return s;
+}
+
+void print_row(const char *name, size_t entries, const Spectrum &s)
+{
+    printf("  %-14s %5zu entries   SFDR %6.1f dB (spur bin %zu)   max error %7.2f LSB\n",
+           name, entries, s.sfdr_db, s.spur_bin, s.max_error);
+}
+
+bool load(const char *path, std::vector<int> *samples)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) return false;
+    int v;
+    while (fscanf(f, "%d", &v) == 1) samples->push_back(v);
+    fclose(f);
+    return true;
+}
+
+bool parse_int(const char *s, long lo, long hi, long *out)
+{
+    char *end;
+    long v = strtol(s, &end, 0);
+    if (*end || v < lo || v > hi) return false;
+    *out = v;
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    Config cfg;
+    const char *check_path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        long v = 0;
+        bool ok = i + 1 < argc;
+        if (ok && !std::strcmp(argv[i], "-q")) {
+            ok = parse_int(argv[++i], 2, 12, &v);
+            cfg.quarter_bits = static_cast<int>(v);
+        } else if (ok && !std::strcmp(argv[i], "-f")) {
+            ok = parse_int(argv[++i], 1, 12, &v);
+            cfg.frac_bits = static_cast<int>(v);
+        } else if (ok && !std::strcmp(argv[i], "-k")) {
+            ok = parse_int(argv[++i], 1, 1L << 20, &v) && (v & 1);
+            cfg.cycles = static_cast<uint32_t>(v);
+        } else if (ok && !std::strcmp(argv[i], "-m")) {
+            ok = parse_int(argv[++i], 0, 65535, &v);
+            cfg.mi = static_cast<int>(v);
+        } else if (ok && !std::strcmp(argv[i], "-r")) {
+            ok = parse_int(argv[++i], kMinRecordBits, kMaxRecordBits, &v);
+            cfg.record_bits = static_cast<int>(v);
+        } else if (ok && !std::strcmp(argv[i], "-c")) {
+            check_path = argv[++i];
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            fprintf(stderr, "Usage: %s [-q 8] [-f 8] [-k 4099 (odd)] [-m 32767] [-r 18] "
+                            "[-c sine_samples.txt]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (cfg.quarter_bits + cfg.frac_bits + 2 > 32 ||
+        cfg.cycles >= (1u << (cfg.record_bits - 1))) {
+        fprintf(stderr, "Phase split or k out of range\n");
+        return 1;
+    }
+
+    const QuarterTable quarter(cfg.quarter_bits, cfg.frac_bits);
+    const std::vector<int> model = record(quarter, cfg);
+
+    printf("Sine reference SFDR: %zu samples, k = %u cycles, MI = %d\n",
+           model.size(), cfg.cycles, cfg.mi);
+    const Spectrum legacy_s = analyze(record(LegacyTable(), cfg), cfg);
+    const Spectrum quarter_s = analyze(model, cfg);
+    print_row("legacy", size_t{1} << kLegacyAddrBits, legacy_s);
+    print_row("quarter+interp", quarter.entries(), quarter_s);
+    printf("  improvement    %.1f dB\n", quarter_s.sfdr_db - legacy_s.sfdr_db);
+
+    if (!check_path) return 0;
+
+    std::vector<int> dump;
+    if (!load(check_path, &dump)) {
+        fprintf(stderr, "Cannot read %s\n", check_path);
+        return 1;
+    }
+    if (dump.size() != model.size()) {
+        fprintf(stderr, "%s: %zu samples, expected %zu\n", check_path, dump.size(), model.size());
+        return 1;
+    }
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < dump.size(); i++) {
+        if (dump[i] != model[i] && mismatches++ < 10)
+            fprintf(stderr, "  sample %zu: RTL %d, model %d\n", i, dump[i], model[i]);
+    }
+    print_row("RTL dump", quarter.entries(), analyze(dump, cfg));
+    if (mismatches) {
+        printf("%s: %zu of %zu samples differ from the model\n",
+               check_path, mismatches, dump.size());
+        return 1;
+    }
+    printf("%s: bit-exact with the model\n", check_path);
+    return 0;
+}
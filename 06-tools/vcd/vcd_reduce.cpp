@@ -0,0 +1,601 @@
+/**
+ * @file vcd_reduce.cpp
+ * @brief Streaming VCD reduction to selected signals and a time window
+ *
+ * Copies a VCD with only the signals whose hierarchical name matches one
+ * of the -s globs (all signals without -s) and only the changes between
+ * -b and -e. The output opens with a $dumpvars at the window start holding
+ * every kept signal's value at that time, so it views like the original
+ * from there on; empty scopes and timestamps without kept changes are
+ * dropped. The input is read once, line by line, in constant memory (one
+ * value per signal), so multi-GB dumps reduce at disk speed.
+ *
+ * Seeking: -x writes <file>.idx, a checkpoint every -k MB of body with the
+ * byte offset of a timestamp and the value of every signal just before it.
+ * A later run finds the index (checked against the file size) and starts
+ * at the last checkpoint before -b instead of at the top of the file.
+ *
+ * FST: no FST reader here (that needs GTKWave's fstapi); convert with
+ * fst2vcd and reduce from a pipe, without seeking:
+ *   fst2vcd dump.fst | vcd_reduce -s 'tb.dut.*' -b 2ms -e 3ms -
+ *
+ * Times (-b, -e) are in timescale ticks, or with a unit (s, ms, us, ns,
+ * ps, fs) converted through the file's $timescale.
+ *
+ * Build/run: g++ -O2 -o vcd_reduce vcd_reduce.cpp
+ *            ./vcd_reduce [-s glob]... [-b 0] [-e end] [-o out.vcd] file.vcd
+ *            ./vcd_reduce -l file.vcd          (list signals)
+ *            ./vcd_reduce -x [-k 64] file.vcd  (build file.vcd.idx)
+ *
+ * @author 5-Level Inverter Project
+ * @date 2025-12-27
+ */
+
+#include <fnmatch.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t kTimeMax = UINT64_MAX;
+constexpr long kDefaultCheckpointMb = 64;
+constexpr size_t kIoBuffer = size_t{1} << 20;
+constexpr const char *kIndexMagic = "vcd_index 1";
+
+struct Config {
+    std::vector<std::string> globs;         // -s, empty = all signals
+    std::string begin = "0";                // -b
+    std::string end;                        // -e, empty = end of file
+    const char *out_path = nullptr;         // -o, stdout without
+    const char *in_path = nullptr;          // "-" = stdin
+    bool list = false;                      // -l
+    bool build_index = false;               // -x
+    long checkpoint_mb = kDefaultCheckpointMb;
+};
+
+// One value-change identifier; several $var may alias it
+struct Signal {
+    std::string id;
+    std::string value;                      // Last value, VCD body syntax
+    bool vector = false;
+    bool keep = false;
+};
+
+// $scope / $var / $upscope in declaration order
+struct HeaderItem {
+    enum Kind { kScope, kVar, kUpscope } kind;
+    std::string text;                       // Declaration as written
+    int signal = -1;                        // kVar
+    bool keep = false;                      // kVar selected
+};
+
+struct Vcd {
+    std::string date, version, timescale;
+    double tick_s = 1e-12;
+    std::vector<HeaderItem> items;
+    std::vector<Signal> signals;
+    std::unordered_map<std::string, int> by_id;
+    uint64_t body_offset = 0;               // First byte after $enddefinitions
+};
+
+class LineReader {
+public:
+    explicit LineReader(FILE *f) : f_(f) {}
+    ~LineReader() { free(buf_); }
+
+    // Next line without the newline; false at end of file
+    bool next(const char **line, size_t *len)
+    {
+        const ssize_t n = getline(&buf_, &cap_, f_);
+        if (n < 0) return false;
+        offset_ += static_cast<uint64_t>(n);
+        size_t l = static_cast<size_t>(n);
+        while (l && (buf_[l - 1] == '\n' || buf_[l - 1] == '\r')) l--;
+        *line = buf_;
+        *len = l;
+        return true;
+    }
+
+    uint64_t offset() const { return offset_; }
+    void seek(uint64_t offset) { offset_ = offset; }
+
+private:
+    FILE *f_;
+    char *buf_ = nullptr;
+    size_t cap_ = 0;
+    uint64_t offset_ = 0;
+};
+
+std::vector<std::string> split(const char *s, size_t len)
+{
+    std::vector<std::string> tokens;
+    size_t i = 0;
+    while (i < len) {
+        while (i < len && (s[i] == ' ' || s[i] == '\t')) i++;
+        const size_t start = i;
+        while (i < len && s[i] != ' ' && s[i] != '\t') i++;
+        if (i > start) tokens.emplace_back(s + start, i - start);
+    }
+    return tokens;
+}
+
+std::string join(const std::vector<std::string> &t, size_t from, size_t to)
+{
+    std::string s;
+    for (size_t i = from; i < to && i < t.size(); i++) {
+        if (!s.empty()) s += ' ';
+        s += t[i];
+    }
+    return s;
+}
+
+double unit_seconds(const std::string &u)
+{
+    if (u == "s") return 1.0;
+    if (u == "ms") return 1e-3;
+    if (u == "us") return 1e-6;
+    if (u == "ns") return 1e-9;
+    if (u == "ps") return 1e-12;
+    if (u == "fs") return 1e-15;
+    return 0.0;
+}
+
+// "1ps", "10 ns" -> seconds per tick
+double parse_timescale(const std::string &s)
+{
+    char *end;
+    const double mag = strtod(s.c_str(), &end);
+    std::string unit;
+    for (; *end; end++) {
+        if (*end != ' ' && *end != '\t') unit += *end;
+    }
+    const double u = unit_seconds(unit);
+    return mag > 0.0 && u > 0.0 ? mag * u : 0.0;
+}
+
+// Header up to $enddefinitions; false on a malformed file
+bool read_header(LineReader *in, Vcd *vcd)
+{
+    std::vector<std::string> cmd;           // Tokens of the open $command
+    std::vector<std::string> scope;         // Current hierarchy
+    const char *line;
+    size_t len;
+
+    while (in->next(&line, &len)) {
+        for (const std::string &tok : split(line, len)) {
+            if (tok != "$end") {
+                cmd.push_back(tok);
+                continue;
+            }
+            if (cmd.empty()) continue;
+            const std::string &kw = cmd[0];
+            if (kw == "$date") {
+                vcd->date = join(cmd, 1, cmd.size());
+            } else if (kw == "$version") {
+                vcd->version = join(cmd, 1, cmd.size());
+            } else if (kw == "$timescale") {
+                vcd->timescale = join(cmd, 1, cmd.size());
+                vcd->tick_s = parse_timescale(vcd->timescale);
+            } else if (kw == "$scope" && cmd.size() >= 3) {
+                scope.push_back(cmd[2]);
+                vcd->items.push_back({HeaderItem::kScope, join(cmd, 0, cmd.size()) + " $end"});
+            } else if (kw == "$upscope") {
+                if (!scope.empty()) scope.pop_back();
+                vcd->items.push_back({HeaderItem::kUpscope, "$upscope $end"});
+            } else if (kw == "$var" && cmd.size() >= 5) {
+                // $var type size id ref [range] $end
+                std::string path;
+                for (const std::string &s : scope) path += s + ".";
+                path += join(cmd, 4, cmd.size());
+                path.erase(std::remove(path.begin(), path.end(), ' '), path.end());
+
+                auto it = vcd->by_id.find(cmd[3]);
+                int index;
+                if (it == vcd->by_id.end()) {
+                    index = static_cast<int>(vcd->signals.size());
+                    Signal s;
+                    s.id = cmd[3];
+                    s.vector = cmd[1] == "real" || atoi(cmd[2].c_str()) > 1;
+                    s.value = cmd[1] == "real" ? "r0" : (s.vector ? "bx" : "x");
+                    vcd->signals.push_back(s);
+                    vcd->by_id.emplace(cmd[3], index);
+                } else {
+                    index = it->second;
+                }
+                HeaderItem item{HeaderItem::kVar, join(cmd, 0, cmd.size()) + " $end", index};
+                item.text += "\t" + path;       // Full name, stripped on output
+                vcd->items.push_back(item);
+            } else if (kw == "$enddefinitions") {
+                vcd->body_offset = in->offset();
+                return true;
+            }
+            cmd.clear();
+        }
+    }
+    return false;
+}
+
+std::string var_path(const HeaderItem &item)
+{
+    return item.text.substr(item.text.rfind('\t') + 1);
+}
+
+std::string var_decl(const HeaderItem &item)
+{
+    return item.text.substr(0, item.text.rfind('\t'));
+}
+
+void select_signals(Vcd *vcd, const std::vector<std::string> &globs)
+{
+    for (HeaderItem &item : vcd->items) {
+        if (item.kind != HeaderItem::kVar) continue;
+        const std::string path = var_path(item);
+        item.keep = globs.empty();
+        for (const std::string &g : globs) {
+            if (fnmatch(g.c_str(), path.c_str(), 0) == 0) item.keep = true;
+        }
+        if (item.keep) vcd->signals[item.signal].keep = true;
+    }
+}
+
+// Header of the reduced file: kept vars inside the scopes that hold them
+void write_header(FILE *out, const Vcd &vcd, const Config &cfg)
+{
+    if (!vcd.date.empty()) fprintf(out, "$date\n\t%s\n$end\n", vcd.date.c_str());
+    if (!vcd.version.empty()) fprintf(out, "$version\n\t%s\n$end\n", vcd.version.c_str());
+    fprintf(out, "$comment\n\tvcd_reduce window %s .. %s\n$end\n", cfg.begin.c_str(),
+            cfg.end.empty() ? "end" : cfg.end.c_str());
+    if (!vcd.timescale.empty()) fprintf(out, "$timescale\n\t%s\n$end\n", vcd.timescale.c_str());
+
+    std::vector<std::pair<const std::string *, bool>> open;    // Scope, written
+    for (const HeaderItem &item : vcd.items) {
+        if (item.kind == HeaderItem::kScope) {
+            open.emplace_back(&item.text, false);
+        } else if (item.kind == HeaderItem::kUpscope) {
+            if (!open.empty() && open.back().second) fprintf(out, "$upscope $end\n");
+            if (!open.empty()) open.pop_back();
+        } else if (item.keep) {
+            for (auto &s : open) {
+                if (!s.second) fprintf(out, "%s\n", s.first->c_str());
+                s.second = true;
+            }
+            fprintf(out, "%s\n", var_decl(item).c_str());
+        }
+    }
+    fprintf(out, "$enddefinitions $end\n");
+}
+
+// Tick count from "1234", "2ms", "1.5 us"; false if the unit is unknown
+bool parse_time(const std::string &s, double tick_s, uint64_t *ticks)
+{
+    char *end;
+    const double v = strtod(s.c_str(), &end);
+    if (end == s.c_str() || v < 0.0) return false;
+    while (*end == ' ') end++;
+    if (!*end) {
+        *ticks = static_cast<uint64_t>(v);
+        return true;
+    }
+    const double u = unit_seconds(end);
+    if (u <= 0.0 || tick_s <= 0.0) return false;
+    *ticks = static_cast<uint64_t>(std::llround(v * u / tick_s));
+    return true;
+}
+
+void write_value(FILE *out, const Signal &s)
+{
+    if (s.vector) {
+        fprintf(out, "%s %s\n", s.value.c_str(), s.id.c_str());
+    } else {
+        fprintf(out, "%s%s\n", s.value.c_str(), s.id.c_str());
+    }
+}
+
+// Value changes on one body line: "1!", "b1010 #", "r0.5 $", ...
+template <typename Fn>
+void parse_changes(const char *line, size_t len, Vcd *vcd, Fn &&changed)
+{
+    const std::vector<std::string> tokens = split(line, len);
+    for (size_t i = 0; i < tokens.size(); i++) {
+        const std::string &t = tokens[i];
+        const char c = t[0];
+        std::string value, id;
+        if (c == '$') continue;             // $dumpvars, $end, ...
+        if (c == 'b' || c == 'B' || c == 'r' || c == 'R' || c == 's' || c == 'S') {
+            if (i + 1 >= tokens.size()) break;
+            value = t;
+            id = tokens[++i];
+        } else if (t.size() >= 2 && strchr("01xXzZ", c)) {
+            value.assign(1, c);
+            id = t.substr(1);
+        } else {
+            continue;
+        }
+        auto it = vcd->by_id.find(id);
+        if (it == vcd->by_id.end()) continue;
+        Signal &s = vcd->signals[it->second];
+        s.value = value;
+        changed(s);
+    }
+}
+
+struct Checkpoint {
+    uint64_t time = 0;
+    uint64_t offset = 0;
+    std::vector<std::string> values;
+};
+
+uint64_t file_size(const char *path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+}
+
+// Whole body once: a checkpoint every interval bytes at a timestamp
+bool build_index(LineReader *in, Vcd *vcd, const Config &cfg)
+{
+    const std::string path = std::string(cfg.in_path) + ".idx";
+    FILE *idx = fopen(path.c_str(), "w");
+    if (!idx) {
+        fprintf(stderr, "Cannot write %s\n", path.c_str());
+        return false;
+    }
+    fprintf(idx, "%s %" PRIu64 " %zu\n", kIndexMagic, file_size(cfg.in_path),
+            vcd->signals.size());
+
+    const uint64_t interval = static_cast<uint64_t>(cfg.checkpoint_mb) << 20;
+    uint64_t last = vcd->body_offset, count = 0;
+    const char *line;
+    size_t len;
+    bool in_comment = false;
+
+    for (;;) {
+        const uint64_t offset = in->offset();
+        if (!in->next(&line, &len)) break;
+        if (in_comment || !strncmp(line, "$comment", 8)) {
+            in_comment = !strstr(line, "$end");
+            continue;
+        }
+        if (len && line[0] == '#') {
+            if (offset - last >= interval) {
+                fprintf(idx, "checkpoint %" PRIu64 " %" PRIu64 "\n",
+                        static_cast<uint64_t>(strtoull(line + 1, nullptr, 10)), offset);
+                for (const Signal &s : vcd->signals) fprintf(idx, "%s\n", s.value.c_str());
+                last = offset;
+                count++;
+            }
+            continue;
+        }
+        parse_changes(line, len, vcd, [](Signal &) {});
+    }
+    fclose(idx);
+    fprintf(stderr, "%s: %" PRIu64 " checkpoints, one per %ld MB\n", path.c_str(), count,
+            cfg.checkpoint_mb);
+    return true;
+}
+
+// Last checkpoint at or before begin from <file>.idx, if it matches the file
+bool find_checkpoint(const Config &cfg, const Vcd &vcd, uint64_t begin, Checkpoint *best)
+{
+    const std::string path = std::string(cfg.in_path) + ".idx";
+    FILE *idx = fopen(path.c_str(), "r");
+    if (!idx) return false;
+
+    LineReader in(idx);
+    const char *line;
+    size_t len;
+    uint64_t size = 0;
+    size_t n = 0;
+    bool found = false;
+    if (!in.next(&line, &len) || strncmp(line, kIndexMagic, strlen(kIndexMagic)) ||
+        sscanf(line + strlen(kIndexMagic), "%" SCNu64 " %zu", &size, &n) != 2 ||
+        size != file_size(cfg.in_path) || n != vcd.signals.size()) {
+        fprintf(stderr, "%s does not match the VCD, ignored (rebuild with -x)\n", path.c_str());
+        fclose(idx);
+        return false;
+    }
+
+    Checkpoint cp;
+    while (in.next(&line, &len) &&
+           sscanf(line, "checkpoint %" SCNu64 " %" SCNu64, &cp.time, &cp.offset) == 2 &&
+           cp.time <= begin) {
+        cp.values.assign(n, std::string());
+        size_t i = 0;
+        for (; i < n && in.next(&line, &len); i++) cp.values[i].assign(line, len);
+        if (i < n) break;
+        *best = cp;
+        found = true;
+    }
+    fclose(idx);
+    return found;
+}
+
+struct Stats {
+    uint64_t changes = 0;
+    uint64_t kept = 0;
+    uint64_t start_offset = 0;
+};
+
+// Body from the reader's position to the end of the window
+Stats reduce(LineReader *in, Vcd *vcd, FILE *out, uint64_t begin, uint64_t end)
+{
+    Stats st;
+    st.start_offset = in->offset();
+    uint64_t now = 0, written = kTimeMax;
+    bool started = false, in_comment = false;
+    const char *line;
+    size_t len;
+
+    auto start = [&]() {
+        fprintf(out, "#%" PRIu64 "\n$dumpvars\n", begin);
+        for (const Signal &s : vcd->signals) {
+            if (s.keep) write_value(out, s);
+        }
+        fprintf(out, "$end\n");
+        written = begin;
+        started = true;
+    };
+
+    while (in->next(&line, &len)) {
+        if (!len) continue;
+        if (in_comment || !strncmp(line, "$comment", 8)) {
+            in_comment = !strstr(line, "$end");
+            continue;
+        }
+        if (line[0] == '#') {
+            now = strtoull(line + 1, nullptr, 10);
+            if (now > end) break;
+            if (!started && now >= begin) start();
+            continue;
+        }
+        parse_changes(line, len, vcd, [&](Signal &s) {
+            st.changes++;
+            if (!started || !s.keep) return;
+            if (written != now) {
+                fprintf(out, "#%" PRIu64 "\n", now);
+                written = now;
+            }
+            write_value(out, s);
+            st.kept++;
+        });
+    }
+    if (!started && begin <= now) start();
+    if (started && end != kTimeMax && written < end) fprintf(out, "#%" PRIu64 "\n", end);
+    return st;
+}
+
+void list_signals(const Vcd &vcd)
+{
+    printf("$timescale %s, %zu signals (%zu ids)\n", vcd.timescale.c_str(),
+           std::count_if(vcd.items.begin(), vcd.items.end(),
+                         [](const HeaderItem &i) { return i.kind == HeaderItem::kVar; }),
+           vcd.signals.size());
+    for (const HeaderItem &item : vcd.items) {
+        if (item.kind != HeaderItem::kVar) continue;
+        const std::vector<std::string> t = split(item.text.c_str(), item.text.find('\t'));
+        printf("  %-8s %5s  %s\n", t[1].c_str(), t[2].c_str(), var_path(item).c_str());
+    }
+}
+
+bool parse_int(const char *s, long lo, long hi, long *out)
+{
+    char *end;
+    long v = strtol(s, &end, 0);
+    if (*end || v < lo || v > hi) return false;
+    *out = v;
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+    Config cfg;
+
+    for (int i = 1; i < argc; i++) {
+        long v = 0;
+        bool ok = true;
+        const bool arg = i + 1 < argc;
+        if (arg && !std::strcmp(argv[i], "-s")) {
+            cfg.globs.emplace_back(argv[++i]);
+        } else if (arg && !std::strcmp(argv[i], "-b")) {
+            cfg.begin = argv[++i];
+        } else if (arg && !std::strcmp(argv[i], "-e")) {
+            cfg.end = argv[++i];
+        } else if (arg && !std::strcmp(argv[i], "-o")) {
+            cfg.out_path = argv[++i];
+        } else if (arg && !std::strcmp(argv[i], "-k")) {
+            ok = parse_int(argv[++i], 1, 1 << 16, &v);
+            cfg.checkpoint_mb = v;
+        } else if (!std::strcmp(argv[i], "-l")) {
+            cfg.list = true;
+        } else if (!std::strcmp(argv[i], "-x")) {
+            cfg.build_index = true;
+        } else if (!cfg.in_path && (argv[i][0] != '-' || !std::strcmp(argv[i], "-"))) {
+            cfg.in_path = argv[i];
+        } else {
+            ok = false;
+        }
+        if (!ok) cfg.in_path = nullptr;
+        if (!ok) break;
+    }
+    if (!cfg.in_path) {
+        fprintf(stderr, "Usage: %s [-s glob]... [-b 0] [-e end] [-o out.vcd] file.vcd|-\n"
+                        "       %s -l file.vcd\n"
+                        "       %s -x [-k %ld] file.vcd\n",
+                argv[0], argv[0], argv[0], kDefaultCheckpointMb);
+        return 1;
+    }
+
+    const bool from_stdin = !std::strcmp(cfg.in_path, "-");
+    FILE *in = from_stdin ? stdin : fopen(cfg.in_path, "r");
+    if (!in) {
+        fprintf(stderr, "Cannot read %s\n", cfg.in_path);
+        return 1;
+    }
+    setvbuf(in, nullptr, _IOFBF, kIoBuffer);
+
+    LineReader reader(in);
+    Vcd vcd;
+    if (!read_header(&reader, &vcd)) {
+        fprintf(stderr, "%s: no $enddefinitions, not a VCD\n", cfg.in_path);
+        return 1;
+    }
+    if (cfg.list) {
+        list_signals(vcd);
+        return 0;
+    }
+    if (cfg.build_index) {
+        if (from_stdin) {
+            fprintf(stderr, "-x needs a file, not stdin\n");
+            return 1;
+        }
+        return build_index(&reader, &vcd, cfg) ? 0 : 1;
+    }
+
+    uint64_t begin = 0, end = kTimeMax;
+    if (!parse_time(cfg.begin, vcd.tick_s, &begin) ||
+        (!cfg.end.empty() && !parse_time(cfg.end, vcd.tick_s, &end)) || end < begin) {
+        fprintf(stderr, "Bad time window %s .. %s ($timescale %s)\n", cfg.begin.c_str(),
+                cfg.end.c_str(), vcd.timescale.c_str());
+        return 1;
+    }
+    select_signals(&vcd, cfg.globs);
+
+    Checkpoint cp;
+    if (!from_stdin && begin > 0 && find_checkpoint(cfg, vcd, begin, &cp)) {
+        if (fseeko(in, static_cast<off_t>(cp.offset), SEEK_SET) == 0) {
+            reader.seek(cp.offset);
+            for (size_t i = 0; i < vcd.signals.size(); i++) vcd.signals[i].value = cp.values[i];
+        }
+    }
+
+    FILE *out = cfg.out_path ? fopen(cfg.out_path, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Cannot write %s\n", cfg.out_path);
+        return 1;
+    }
+    setvbuf(out, nullptr, _IOFBF, kIoBuffer);
+
+    write_header(out, vcd, cfg);
+    const Stats st = reduce(&reader, &vcd, out, begin, end);
+    size_t kept = 0;
+    for (const Signal &s : vcd.signals) kept += s.keep;
+
+    fprintf(stderr, "%zu of %zu signals, %" PRIu64 " of %" PRIu64 " changes kept "
+                    "(read from byte %" PRIu64 ")\n",
+            kept, vcd.signals.size(), st.kept, st.changes, st.start_offset);
+    if (cfg.out_path) fclose(out);
+    if (!from_stdin) fclose(in);
+    return 0;
+}